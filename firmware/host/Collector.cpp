@@ -0,0 +1,242 @@
+/**
+ * @file Collector.cpp
+ * @brief 多设备遥测采集实现（Linux epoll）
+ */
+
+#include "Collector.h"
+#include <errno.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+#include <chrono>
+
+int64_t Collector::nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Collector::Device::Device(const std::string& p, const std::string& n, const CollectorOptions& o)
+    : path(p), name(n), ring(o.ringBytes), series(o.historySamples), stats{}, everConnected(false),
+      retryAtUs(0), lastTelemetryUs(0), requestedUs(0), txSeq(1), seqSeen(false), lastSeq(0), hasLast(false),
+      last{}, csv(nullptr), log(nullptr), archiveFailed(false) {
+    if (o.outputDir.empty()) {
+        return;
+    }
+    const std::string stem = o.outputDir + "/" + name;
+    csv = fopen((stem + ".csv").c_str(), "a");
+    log = fopen((stem + ".log").c_str(), "a");
+    if (csv != nullptr && ftell(csv) == 0) {
+        telemetryCsvHeader(csv);
+    }
+}
+
+Collector::Device::~Device() {
+    if (csv != nullptr) {
+        fclose(csv);
+    }
+    if (log != nullptr) {
+        fclose(log);
+    }
+}
+
+Collector::Collector(const CollectorOptions& options)
+    : opts(options), epfd(epoll_create1(EPOLL_CLOEXEC)), flushedUs(nowUs()),
+      wallOffsetUs(std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::system_clock::now().time_since_epoch()).count() - nowUs()) {
+}
+
+Collector::~Collector() {
+    flush();
+    devices.clear();
+    if (epfd >= 0) {
+        close(epfd);
+    }
+}
+
+size_t Collector::add(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    for (const auto& d : devices) {
+        if (d->name == name) {
+            name += "_" + std::to_string(devices.size());
+            break;
+        }
+    }
+    devices.emplace_back(new Device(path, name, opts));
+    connect(devices.size() - 1, nowUs());
+    return devices.size() - 1;
+}
+
+void Collector::connect(size_t i, int64_t now) {
+    Device& d = *devices[i];
+    if (!d.port.open(d.path)) {
+        d.retryAtUs = now + COLLECTOR_RETRY_MS * 1000LL;
+        return;
+    }
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = i;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, d.port.handle(), &ev) != 0) {
+        d.port.close();
+        d.retryAtUs = now + COLLECTOR_RETRY_MS * 1000LL;
+        return;
+    }
+    if (d.everConnected) {
+        d.stats.reconnects++;
+    }
+    d.everConnected = true;
+    d.ring.reset();
+    d.seqSeen = false;
+    d.lastTelemetryUs = now;
+    requestTelemetry(d, now);
+}
+
+void Collector::disconnect(Device& d, int64_t now) {
+    d.port.close();         // 关闭即从 epoll 中移除
+    d.retryAtUs = now + COLLECTOR_RETRY_MS * 1000LL;
+}
+
+void Collector::requestTelemetry(Device& d, int64_t now) {
+    d.requestedUs = now;
+    if (opts.telemetryMs <= 0) {
+        return;
+    }
+    uint8_t req[6];
+    req[0] = RPC_OP_SET;
+    req[1] = PARAM_TELEMETRY_PERIOD;
+    linkPutFloat(req + 2, (float)opts.telemetryMs);
+    uint8_t wire[LINK_MAX_WIRE];
+    size_t n = linkEncodeFrame(LINK_FRAME_REQUEST, d.txSeq++, req, sizeof(req), wire);
+    // 应答照常按帧收下，不等待：丢了由 COLLECTOR_STALE_MS 重发
+    if (::write(d.port.handle(), wire, n) == (ssize_t)n) {
+        d.stats.requests++;
+    }
+}
+
+void Collector::poll(int timeoutMs) {
+    int64_t now = nowUs();
+    for (size_t i = 0; i < devices.size(); i++) {
+        Device& d = *devices[i];
+        if (!d.connected()) {
+            if (now >= d.retryAtUs) {
+                connect(i, now);
+            }
+        } else if (opts.telemetryMs > 0 && now - d.lastTelemetryUs > COLLECTOR_STALE_MS * 1000LL
+                   && now - d.requestedUs > COLLECTOR_STALE_MS * 1000LL) {
+            requestTelemetry(d, now);
+        }
+    }
+
+    epoll_event events[64];
+    int n = epoll_wait(epfd, events, 64, timeoutMs);
+    for (int k = 0; k < n; k++) {
+        size_t i = (size_t)events[k].data.u64;
+        if (i < devices.size() && devices[i]->connected()) {
+            receive(i);
+        }
+    }
+
+    now = nowUs();
+    if (now - flushedUs > COLLECTOR_FLUSH_MS * 1000LL) {
+        flush();
+        flushedUs = now;
+    }
+}
+
+void Collector::receive(size_t i) {
+    Device& d = *devices[i];
+    for (int r = 0; r < COLLECTOR_READS_PER_WAKE; r++) {
+        ssize_t got = d.ring.fill(d.port.handle());
+        // 出错，或就绪（含挂断）后第一次就读不到数据：对端已关闭。
+        // 扫描后缓冲区里最多剩一个未完成的帧，不会因为满而读不到
+        if (got < 0 || (got == 0 && r == 0)) {
+            disconnect(d, nowUs());
+            return;
+        }
+        if (got == 0) {
+            return;
+        }
+        const int64_t now = nowUs();
+        d.ring.scan([&](const LinkFrameView& f) { frame(i, f, now); },
+                    [&](const uint8_t* text, size_t len) {
+                        if (d.log != nullptr) {
+                            fwrite(text, 1, len, d.log);
+                        }
+                    });
+    }
+}
+
+void Collector::frame(size_t i, const LinkFrameView& f, int64_t now) {
+    Device& d = *devices[i];
+    if (f.type == LINK_FRAME_RESPONSE) {
+        d.stats.responses++;
+        return;
+    }
+    if (f.type != LINK_FRAME_TELEMETRY) {
+        return;
+    }
+    TelemetryRecord rec;
+    if (!telemetryDecode(f.payload, f.len, rec)) {
+        d.stats.decodeErrors++;
+        return;
+    }
+    if (d.seqSeen) {
+        d.stats.lost += (uint8_t)(f.seq - d.lastSeq - 1);
+    }
+    d.seqSeen = true;
+    d.lastSeq = f.seq;
+    d.stats.telemetry++;
+    d.lastTelemetryUs = now;
+    d.last = rec;
+    d.hasLast = true;
+    d.series.push(now, rec);
+
+    const int64_t unixMs = (now + wallOffsetUs) / 1000;
+    if (d.csv != nullptr) {
+        telemetryCsvRow(d.csv, unixMs, f.seq, rec);
+    }
+    if (!opts.archiveDir.empty()) {
+        archiveSample(d, unixMs, f.seq, rec);
+    }
+    if (telemetryCb) {
+        telemetryCb(i, f.seq, rec, now);
+    }
+}
+
+void Collector::archiveSample(Device& d, int64_t unixMs, uint8_t seq, const TelemetryRecord& rec) {
+    if (d.archiveFailed) {
+        return;
+    }
+    if (!d.archive) {
+        time_t t = (time_t)(unixMs / 1000);
+        struct tm tm;
+        localtime_r(&t, &tm);
+        char stamp[32];
+        strftime(stamp, sizeof(stamp), "-%Y%m%d-%H%M%S", &tm);
+        std::string error;
+        d.archive.reset(new SessionArchiveWriter());
+        if (!d.archive->create(opts.archiveDir + "/" + d.name + stamp, rec.channelCount, &error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            d.archive.reset();
+            d.archiveFailed = true;
+            return;
+        }
+    }
+    if (!d.archive->append(unixMs, seq, rec)) {
+        fprintf(stderr, "%s: 档案写入失败，不再写入\n", d.name.c_str());
+        d.archive.reset();
+        d.archiveFailed = true;
+    }
+}
+
+void Collector::flush() {
+    for (const auto& d : devices) {
+        if (d->csv != nullptr) {
+            fflush(d->csv);
+        }
+        if (d->log != nullptr) {
+            fflush(d->log);
+        }
+    }
+}
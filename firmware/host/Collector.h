@@ -0,0 +1,137 @@
+/**
+ * @file Collector.h
+ * @brief 多设备遥测采集：一个线程用 epoll 同时接收几十个串口/伪终端
+ *
+ * 每台设备一个 FrameRing（零拷贝收帧）和一个 TelemetrySeries（固定容量），
+ * 内存与运行时间无关：设备数 × (接收缓冲 + 历史样本数 × TELEMETRY_SERIES_SAMPLE_BYTES)。
+ * 连接后设置遥测周期；设备重启（遥测默认关闭）或设置请求丢失时，
+ * COLLECTOR_STALE_MS 内没有遥测就重发设置。断开（拔出、仿真退出）后每 COLLECTOR_RETRY_MS 重新打开。
+ * 指定输出目录时每台设备写 <名称>.csv（遥测）和 <名称>.log（文本日志），stdio 缓冲，每秒刷新一次。
+ * 指定档案目录时每台设备收到第一帧遥测后新建 <名称>-<日期>-<时间> 档案（SessionArchive），每满一块写盘。
+ */
+
+#ifndef HOST_COLLECTOR_H
+#define HOST_COLLECTOR_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "FrameRing.h"
+#include "LinkProtocol.h"
+#include "SerialPort.h"
+#include "SessionArchive.h"
+#include "TelemetryCsv.h"
+#include "TelemetrySeries.h"
+
+#define COLLECTOR_STALE_MS      2000    // 多久没有遥测就重发遥测周期设置
+#define COLLECTOR_RETRY_MS      1000    // 断开后重新打开的间隔
+#define COLLECTOR_FLUSH_MS      1000    // 输出文件刷新间隔
+#define COLLECTOR_READS_PER_WAKE 4      // 每次就绪最多读几次，避免一台设备占住循环
+
+struct CollectorOptions {
+    int telemetryMs = 100;              // 连接后设置的遥测周期，0 = 不设置（只接收）
+    size_t historySamples = 3000;       // 每台设备在内存中保留的样本数
+    size_t ringBytes = 16384;           // 每台设备的接收缓冲
+    std::string outputDir;              // 空 = 不写文件
+    std::string archiveDir;             // 空 = 不写档案
+};
+
+class Collector {
+public:
+    struct DeviceStats {
+        uint64_t telemetry;             // 遥测帧
+        uint64_t lost;                  // 按序号统计的遥测丢帧
+        uint64_t responses;             // 应答帧（遥测周期设置）
+        uint32_t decodeErrors;          // 遥测载荷版本或长度不对
+        uint32_t reconnects;
+        uint32_t requests;              // 发出的遥测周期设置
+    };
+
+    struct Device {
+        std::string path;
+        std::string name;               // 路径的文件名部分（重名时加序号），也是输出文件名
+        SerialPort port;
+        FrameRing ring;
+        TelemetrySeries series;
+        DeviceStats stats;
+        bool everConnected;
+        int64_t retryAtUs;              // 断开时下次打开的时间
+        int64_t lastTelemetryUs;
+        int64_t requestedUs;
+        uint8_t txSeq;
+        bool seqSeen;
+        uint8_t lastSeq;
+        bool hasLast;
+        TelemetryRecord last;
+        FILE* csv;
+        FILE* log;
+        std::unique_ptr<SessionArchiveWriter> archive;
+        bool archiveFailed;
+
+        Device(const std::string& path, const std::string& name, const CollectorOptions& o);
+        ~Device();
+        bool connected() const { return port.isOpen(); }
+    };
+
+    explicit Collector(const CollectorOptions& options);
+    ~Collector();
+
+    Collector(const Collector&) = delete;
+    Collector& operator=(const Collector&) = delete;
+
+    /**
+     * @brief epoll 是否创建成功
+     */
+    bool valid() const { return epfd >= 0; }
+
+    /**
+     * @brief 添加设备（立即尝试打开，失败则稍后重试）
+     * @return 设备序号
+     */
+    size_t add(const std::string& path);
+
+    /**
+     * @brief 一轮：重新打开断开的设备、重发遥测设置、等待最多 timeoutMs 并处理所有就绪的设备
+     */
+    void poll(int timeoutMs);
+
+    /**
+     * @brief 刷新输出文件
+     */
+    void flush();
+
+    size_t deviceCount() const { return devices.size(); }
+    const Device& device(size_t i) const { return *devices[i]; }
+
+    /**
+     * @brief 每帧遥测的回调（基准测试统计延迟），rxUs 为读入该批数据的时间（steady_clock）
+     */
+    void onTelemetry(std::function<void(size_t dev, uint8_t seq, const TelemetryRecord& rec, int64_t rxUs)> cb) {
+        telemetryCb = cb;
+    }
+
+    /**
+     * @brief steady_clock 微秒（与 onTelemetry 的 rxUs 同一时钟）
+     */
+    static int64_t nowUs();
+
+private:
+    CollectorOptions opts;
+    int epfd;
+    std::vector<std::unique_ptr<Device>> devices;
+    int64_t flushedUs;
+    int64_t wallOffsetUs;               // system_clock - steady_clock，CSV 写墙钟时间
+    std::function<void(size_t, uint8_t, const TelemetryRecord&, int64_t)> telemetryCb;
+
+    void connect(size_t i, int64_t now);
+    void disconnect(Device& d, int64_t now);
+    void requestTelemetry(Device& d, int64_t now);
+    void receive(size_t i);
+    void frame(size_t i, const LinkFrameView& f, int64_t now);
+    void archiveSample(Device& d, int64_t unixMs, uint8_t seq, const TelemetryRecord& rec);
+};
+
+#endif // HOST_COLLECTOR_H
@@ -0,0 +1,191 @@
+/**
+ * @file DeltaEncoder.cpp
+ * @brief 固件差分生成
+ */
+
+#include "DeltaEncoder.h"
+#include "LinkFrame.h"
+#include "LinkProtocol.h"
+#include <string.h>
+#include <algorithm>
+
+namespace {
+
+const int HASH_BITS = 20;
+
+inline uint32_t hashAt(const uint8_t* p) {
+    uint64_t a, b;
+    memcpy(&a, p, 8);
+    memcpy(&b, p + 8, 8);
+    return (uint32_t)(((a * 0x9E3779B97F4A7C15ull) ^ (b * 0xC2B2AE3D27D4EB4Full)) >> (64 - HASH_BITS));
+}
+
+inline size_t matchLength(const uint8_t* a, const uint8_t* b, size_t max) {
+    size_t n = 0;
+    while (n < max && a[n] == b[n]) {
+        n++;
+    }
+    return n;
+}
+
+class Emitter {
+public:
+    Emitter(std::vector<uint8_t>& out, DeltaEncodeStats& stats) : out(out), stats(stats), copyEnd(0) {}
+
+    void literal(const uint8_t* data, size_t len) {
+        if (len == 0) {
+            return;
+        }
+        out.push_back(DELTA_OP_LITERAL);
+        varint((uint32_t)len);
+        out.insert(out.end(), data, data + len);
+        stats.literals++;
+        stats.literalBytes += len;
+    }
+
+    void copy(uint32_t src, uint32_t len) {
+        out.push_back(DELTA_OP_COPY);
+        varint(deltaZigzag((int32_t)(src - copyEnd)));
+        varint(len);
+        copyEnd = src + len;
+        stats.copies++;
+        stats.copyBytes += len;
+    }
+
+    uint32_t lastCopyEnd() const { return copyEnd; }
+
+private:
+    std::vector<uint8_t>& out;
+    DeltaEncodeStats& stats;
+    uint32_t copyEnd;
+
+    void varint(uint32_t v) {
+        uint8_t buf[5];
+        out.insert(out.end(), buf, buf + deltaPutVarint(buf, v));
+    }
+};
+
+} // namespace
+
+std::vector<uint8_t> deltaEncode(const std::vector<uint8_t>& source, const std::vector<uint8_t>& target,
+                                 DeltaEncodeStats* statsOut) {
+    DeltaEncodeStats stats = {};
+    std::vector<uint8_t> out(DELTA_HEADER_LEN);
+    Emitter emit(out, stats);
+
+    const uint8_t* src = source.data();
+    const uint8_t* dst = target.data();
+    const size_t srcLen = source.size();
+    const size_t dstLen = target.size();
+
+    // 哈希链：head[h] 最近一个位置 + 1（0 = 空），prev[i] 同一哈希的前一个位置 + 1
+    std::vector<uint32_t> head;
+    std::vector<uint32_t> prev;
+    if (srcLen >= DELTA_MIN_MATCH) {
+        head.assign(1u << HASH_BITS, 0);
+        prev.assign(srcLen, 0);
+        for (size_t i = 0; i + DELTA_MIN_MATCH <= srcLen; i++) {
+            uint32_t h = hashAt(src + i);
+            prev[i] = head[h];
+            head[h] = (uint32_t)i + 1;
+        }
+    }
+
+    size_t litStart = 0;
+    size_t i = 0;
+    while (!head.empty() && i + DELTA_MIN_MATCH <= dstLen) {
+        size_t bestLen = 0;
+        size_t bestSrc = 0;
+
+        // 接着上一个 COPY（平移后的同一段代码）
+        size_t expect = emit.lastCopyEnd() + (i - litStart);
+        if (expect < srcLen) {
+            size_t n = matchLength(src + expect, dst + i, std::min(srcLen - expect, dstLen - i));
+            if (n >= DELTA_MIN_MATCH) {
+                bestLen = n;
+                bestSrc = expect;
+            }
+        }
+        if (bestLen < 256) {
+            uint32_t cand = head[hashAt(dst + i)];
+            for (int chain = 0; cand != 0 && chain < DELTA_MAX_CHAIN; chain++, cand = prev[cand - 1]) {
+                size_t j = cand - 1;
+                size_t n = matchLength(src + j, dst + i, std::min(srcLen - j, dstLen - i));
+                if (n > bestLen) {
+                    bestLen = n;
+                    bestSrc = j;
+                }
+            }
+        }
+        if (bestLen < DELTA_MIN_MATCH) {
+            i++;
+            continue;
+        }
+
+        // 向前延伸到字面量里
+        while (i > litStart && bestSrc > 0 && src[bestSrc - 1] == dst[i - 1]) {
+            i--;
+            bestSrc--;
+            bestLen++;
+        }
+        emit.literal(dst + litStart, i - litStart);
+        emit.copy((uint32_t)bestSrc, (uint32_t)bestLen);
+        i += bestLen;
+        litStart = i;
+    }
+    emit.literal(dst + litStart, dstLen - litStart);
+
+    DeltaHeader h = {};
+    h.sourceSize = (uint32_t)srcLen;
+    if (srcLen > 0) {
+        Sha256::hash(src, srcLen, h.sourceSha);
+    }
+    h.targetSize = (uint32_t)dstLen;
+    Sha256::hash(dst, dstLen, h.targetSha);
+    h.deltaSize = (uint32_t)(out.size() - DELTA_HEADER_LEN);
+    deltaHeaderEncode(h, out.data());
+
+    if (statsOut) {
+        *statsOut = stats;
+    }
+    return out;
+}
+
+static bool readVector(void* ctx, uint32_t offset, uint8_t* buf, size_t len) {
+    const std::vector<uint8_t>* v = (const std::vector<uint8_t>*)ctx;
+    if (offset > v->size() || len > v->size() - offset) {
+        return false;
+    }
+    memcpy(buf, v->data() + offset, len);
+    return true;
+}
+
+bool deltaVerify(const std::vector<uint8_t>& source, const std::vector<uint8_t>& target,
+                 const std::vector<uint8_t>& delta) {
+    DeltaHeader h;
+    if (delta.size() < DELTA_HEADER_LEN || !deltaHeaderDecode(delta.data(), DELTA_HEADER_LEN, h)
+            || h.deltaSize != delta.size() - DELTA_HEADER_LEN) {
+        return false;
+    }
+    DeltaApplier applier;
+    applier.begin(h);
+    std::vector<uint8_t> out;
+    uint8_t sector[4096];       // UPDATE_SECTOR_SIZE
+    const uint8_t* in = delta.data() + DELTA_HEADER_LEN;
+    size_t left = h.deltaSize;
+    // 按设备的方式分段：每次一帧数据，输出缓冲一个扇区
+    for (;;) {
+        size_t chunk = std::min(left, (size_t)UPDATE_CHUNK_MAX);
+        size_t consumed, produced;
+        if (!applier.step(in, chunk, consumed, sector, sizeof(sector), produced, readVector, (void*)&source)) {
+            return false;
+        }
+        out.insert(out.end(), sector, sector + produced);
+        in += consumed;
+        left -= consumed;
+        if (left == 0 && produced == 0) {
+            break;
+        }
+    }
+    return applier.done() && out == target;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file DeltaEncoder.h
+ * @brief 生成固件差分（格式见 include/DeltaPatch.h）
+ *
+ * 对旧镜像每个位置的 16 字节做哈希建链，新镜像逐位置查找最长匹配（贪心），
+ * 匹配不少于 DELTA_MIN_MATCH 字节输出 COPY，其余攒成 LITERAL。
+ * 先试"接着上一个 COPY"的位置：代码插入/删除后后面整体平移，这样几乎都是 1 字节偏移差。
+ */
+
+#ifndef HOST_DELTA_ENCODER_H
+#define HOST_DELTA_ENCODER_H
+
+#include <stdint.h>
+#include <vector>
+#include "DeltaPatch.h"
+
+#define DELTA_MIN_MATCH     16
+#define DELTA_MAX_CHAIN     64      // 每个位置最多比较的候选数
+
+struct DeltaEncodeStats {
+    uint32_t copies;
+    uint32_t literals;
+    uint64_t copyBytes;
+    uint64_t literalBytes;
+};
+
+/**
+ * @brief 生成差分
+ * @param source 旧镜像（设备正在运行的），为空时生成完整镜像（只有 LITERAL）
+ * @return 头 + 操作流
+ */
+std::vector<uint8_t> deltaEncode(const std::vector<uint8_t>& source, const std::vector<uint8_t>& target,
+                                 DeltaEncodeStats* stats = nullptr);
+
+/**
+ * @brief 在内存中应用差分（用 DeltaApplier，与设备相同的路径），检查生成结果
+ * @return false 差分格式错误或结果与 target 不符
+ */
+bool deltaVerify(const std::vector<uint8_t>& source, const std::vector<uint8_t>& target,
+                 const std::vector<uint8_t>& delta);
+
+#endif // HOST_DELTA_ENCODER_H
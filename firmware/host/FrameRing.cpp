@@ -0,0 +1,77 @@
+/**
+ * @file FrameRing.cpp
+ * @brief 零拷贝收帧实现（Linux：memfd + 两次 MAP_FIXED 映射）
+ */
+
+#include "FrameRing.h"
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+FrameRing::FrameRing(size_t capacity)
+    : base(nullptr), cap(0), mask(0), head(0), tail(0), scanPos(0), frameStart(0), inFrame(false), stats{} {
+    size_t size = (size_t)sysconf(_SC_PAGESIZE);
+    while (size < capacity || size <= LINK_MAX_ENCODED) {
+        size <<= 1;
+    }
+    int fd = memfd_create("frame_ring", MFD_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    // 先保留两倍大小的地址空间，再把同一段内存映射到前后两半
+    void* area = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0) {
+        area = mmap(nullptr, size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (area != MAP_FAILED) {
+        uint8_t* a = (uint8_t*)area;
+        if (mmap(a, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+                || mmap(a + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+            munmap(area, size * 2);
+        } else {
+            base = a;
+            cap = size;
+            mask = size - 1;
+        }
+    }
+    close(fd);
+}
+
+FrameRing::~FrameRing() {
+    if (base != nullptr) {
+        munmap(base, cap * 2);
+    }
+}
+
+ssize_t FrameRing::fill(int fd) {
+    const size_t space = cap - used();
+    if (space == 0) {
+        return 0;
+    }
+    ssize_t n = ::read(fd, at(tail), space);
+    if (n > 0) {
+        tail += (uint64_t)n;
+        stats.bytes += (uint64_t)n;
+        return n;
+    }
+    if (n == 0 || errno == EAGAIN || errno == EINTR) {
+        // 终端在 VMIN=0 时没有数据也返回0，是否断开由调用者按 poll 结果判断
+        return 0;
+    }
+    return -1;      // 伪终端主端关闭后从端读返回 EIO
+}
+
+size_t FrameRing::append(const uint8_t* data, size_t len) {
+    if (len > cap - used()) {
+        len = cap - used();
+    }
+    memcpy(at(tail), data, len);
+    tail += len;
+    stats.bytes += len;
+    return len;
+}
+
+void FrameRing::reset() {
+    head = tail = scanPos = frameStart = 0;
+    inFrame = false;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file FrameRing.h
+ * @brief 零拷贝收帧：双重映射的接收环形缓冲 + 原地 COBS 解码
+ *
+ * 缓冲区在虚拟地址上连续映射两次（memfd），从任何位置开始、不超过容量的区间都是连续内存：
+ * read() 直接写入空闲区，memchr 找分隔符，帧在缓冲区内原地解码（COBS 解码结果不长于输入），
+ * LinkFrameView 的载荷和文本片段都直接指向缓冲区，不逐字节搬运。
+ * 分帧、坏帧后重新对齐、超长处理与 LinkDecoder 完全相同（collect_bench 用随机数据流对照检查）。
+ */
+
+#ifndef HOST_FRAME_RING_H
+#define HOST_FRAME_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+#include "LinkFrame.h"
+
+class FrameRing {
+public:
+    struct Stats {
+        uint64_t bytes;         // 收到的字节
+        uint64_t textBytes;
+        uint32_t frames;
+        uint32_t crcErrors;     // COBS 非法或 CRC 不符
+        uint32_t overruns;      // 超过 LINK_MAX_ENCODED 仍未结束
+    };
+
+    /**
+     * @param capacity 字节数，向上取整到页大小的2的幂（至少要能放下一个最长的帧）
+     */
+    explicit FrameRing(size_t capacity = 16384);
+    ~FrameRing();
+
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    /**
+     * @brief 映射是否成功
+     */
+    bool valid() const { return base != nullptr; }
+
+    /**
+     * @brief 从非阻塞文件描述符读入空闲区（一次 read）
+     * @return 读到的字节数；0 没有数据、对端关闭（read 返回0）或缓冲区满；-1 出错
+     */
+    ssize_t fill(int fd);
+
+    /**
+     * @brief 写入数据（测试用），返回写入的字节数
+     */
+    size_t append(const uint8_t* data, size_t len);
+
+    /**
+     * @brief 处理已收到的数据：每个完整的帧调用 onFrame(const LinkFrameView&)，
+     *        帧外文本调用 onText(const uint8_t*, size_t)（一段文本可能分几次给出）。
+     *        回调中的指针在下一次 fill()/append() 之前有效
+     */
+    template <typename FrameFn, typename TextFn>
+    void scan(FrameFn&& onFrame, TextFn&& onText);
+
+    /**
+     * @brief 丢弃所有数据和未完成的帧（重新连接时）
+     */
+    void reset();
+
+    size_t capacity() const { return cap; }
+    size_t used() const { return (size_t)(tail - head); }
+    const Stats& counters() const { return stats; }
+
+private:
+    uint8_t* base;
+    size_t cap;
+    size_t mask;
+    // 单调递增的位置，取模后是缓冲区偏移
+    uint64_t head;          // 之前的数据已处理完，可以覆盖
+    uint64_t tail;          // 已写入
+    uint64_t scanPos;       // 已查找过分隔符
+    uint64_t frameStart;    // inFrame 时帧内容（帧头分隔符之后）的位置
+    bool inFrame;
+    Stats stats;
+
+    uint8_t* at(uint64_t pos) const { return base + (pos & mask); }
+};
+
+template <typename FrameFn, typename TextFn>
+void FrameRing::scan(FrameFn&& onFrame, TextFn&& onText) {
+    while (scanPos < tail) {
+        uint8_t* p = at(scanPos);
+        const size_t avail = (size_t)(tail - scanPos);
+        const uint8_t* z = (const uint8_t*)memchr(p, 0, avail);
+
+        if (!inFrame) {
+            size_t n = z ? (size_t)(z - p) : avail;
+            if (n > 0) {
+                stats.textBytes += n;
+                onText(p, n);
+            }
+            if (z == nullptr) {
+                scanPos = head = tail;
+                return;
+            }
+            scanPos += n + 1;
+            head = frameStart = scanPos;
+            inFrame = true;
+            continue;
+        }
+
+        const uint64_t end = z ? scanPos + (uint64_t)(z - p) : tail;
+        if (end - frameStart > LINK_MAX_ENCODED) {
+            // 两个分隔符之间过长：实际是文本。与 LinkDecoder 一样丢弃到超长的那个字节，其后按文本处理
+            stats.overruns++;
+            inFrame = false;
+            scanPos = head = frameStart + LINK_MAX_ENCODED + 1;
+            continue;
+        }
+        if (z == nullptr) {
+            scanPos = tail;     // 帧未结束，等更多数据（head 保持在帧头）
+            return;
+        }
+
+        const size_t len = (size_t)(end - frameStart);
+        uint8_t* f = at(frameStart);
+        scanPos = head = frameStart = end + 1;
+        if (len == 0) {
+            continue;           // 连续分隔符：上一帧的帧尾紧接下一帧的帧头
+        }
+        size_t n = cobsDecode(f, len, f);
+        if (n < LINK_HEADER_LEN + LINK_CRC_LEN
+                || linkCrc16(f, n - LINK_CRC_LEN) != linkGet16(f + n - LINK_CRC_LEN)) {
+            stats.crcErrors++;  // 这个分隔符当作下一帧的帧头，留在帧内
+            continue;
+        }
+        inFrame = false;
+        stats.frames++;
+        LinkFrameView view;
+        view.type = f[0];
+        view.seq = f[1];
+        view.payload = f + LINK_HEADER_LEN;
+        view.len = n - LINK_HEADER_LEN - LINK_CRC_LEN;
+        onFrame(view);
+    }
+}
+
+#endif // HOST_FRAME_RING_H
@@ -0,0 +1,333 @@
+/**
+ * @file LinkClient.cpp
+ * @brief 主机端 RPC 客户端实现
+ */
+
+#include "LinkClient.h"
+#include <algorithm>
+#include <chrono>
+
+static int64_t nowMs() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+LinkClient::LinkClient(SerialPort& port)
+    : port(port), timeoutMs(200), retries(3), nextSeq(1), lastStatus(RPC_OK), stats{},
+      telemetrySeen(false), telemetrySeq(0), waitingSeq(-1), waitingOp(0), gotResponse(false), postedOp(), postedTotal(0) {
+}
+
+void LinkClient::setTimeout(int ms, int n) {
+    timeoutMs = ms;
+    retries = n;
+}
+
+LinkClient::Result LinkClient::call(const uint8_t* request, size_t len, std::vector<uint8_t>& response) {
+    uint8_t wire[LINK_MAX_WIRE];
+    const uint8_t seq = nextSeq++;
+    size_t n = linkEncodeFrame(LINK_FRAME_REQUEST, seq, request, len, wire);
+    if (n == 0 || len == 0) {
+        return LINK_MALFORMED;
+    }
+    stats.requests++;
+    waitingSeq = seq;
+    waitingOp = request[0];
+    gotResponse = false;
+
+    for (int attempt = 0; attempt <= retries; attempt++) {
+        if (attempt > 0) {
+            stats.retries++;
+        }
+        if (!port.write(wire, n)) {
+            waitingSeq = -1;
+            return LINK_DISCONNECTED;
+        }
+        const int64_t deadline = nowMs() + timeoutMs;
+        while (!gotResponse) {
+            int64_t left = deadline - nowMs();
+            if (left <= 0) {
+                break;
+            }
+            if (!receive((int)left)) {
+                waitingSeq = -1;
+                return LINK_DISCONNECTED;
+            }
+        }
+        if (gotResponse) {
+            break;
+        }
+    }
+    waitingSeq = -1;
+    if (!gotResponse) {
+        stats.timeouts++;
+        return LINK_TIMEOUT;
+    }
+    if (responseBuf.size() < 2 || responseBuf[0] != request[0]) {
+        return LINK_MALFORMED;
+    }
+    lastStatus = (RpcStatus)responseBuf[1];
+    response.assign(responseBuf.begin() + 2, responseBuf.end());
+    return lastStatus == RPC_OK ? LINK_OK : LINK_STATUS;
+}
+
+bool LinkClient::post(const uint8_t* request, size_t len, uint8_t& seq) {
+    uint8_t wire[LINK_MAX_WIRE];
+    seq = nextSeq++;
+    size_t n = linkEncodeFrame(LINK_FRAME_REQUEST, seq, request, len, wire);
+    if (n == 0 || len == 0) {
+        return false;
+    }
+    stats.requests++;
+    if (postedOp[seq] == 0) {
+        postedTotal++;
+    }
+    postedOp[seq] = request[0];
+    return port.write(wire, n);
+}
+
+LinkClient::Result LinkClient::collect(uint8_t& seq, std::vector<uint8_t>& response, RpcStatus& status,
+                                       int timeoutMs) {
+    const int64_t deadline = nowMs() + timeoutMs;
+    while (arrived.empty()) {
+        int64_t left = deadline - nowMs();
+        if (left <= 0) {
+            return LINK_TIMEOUT;
+        }
+        if (!receive((int)left)) {
+            return LINK_DISCONNECTED;
+        }
+    }
+    std::pair<uint8_t, std::vector<uint8_t>> r = std::move(arrived.front());
+    arrived.pop_front();
+    seq = r.first;
+    if (r.second.size() < 2) {
+        return LINK_MALFORMED;
+    }
+    status = (RpcStatus)r.second[1];
+    lastStatus = status;
+    response.assign(r.second.begin() + 2, r.second.end());
+    return LINK_OK;
+}
+
+void LinkClient::cancelPosted() {
+    std::fill(postedOp, postedOp + 256, 0);
+    postedTotal = 0;
+    arrived.clear();
+}
+
+bool LinkClient::poll(int ms) {
+    return receive(ms);
+}
+
+bool LinkClient::receive(int ms) {
+    uint8_t buf[512];
+    ssize_t n = port.read(buf, sizeof(buf), ms);
+    if (n < 0) {
+        return false;
+    }
+    for (ssize_t i = 0; i < n; i++) {
+        switch (decoder.push(buf[i])) {
+            case LinkDecoder::LINK_PUSH_TEXT:
+                text(buf[i]);
+                break;
+            case LinkDecoder::LINK_PUSH_FRAME:
+                dispatch(decoder.frame());
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+void LinkClient::dispatch(const LinkFrameView& f) {
+    if (f.type == LINK_FRAME_RESPONSE) {
+        if (waitingSeq >= 0 && f.seq == (uint8_t)waitingSeq && !gotResponse && f.len >= 1
+                && f.payload[0] == waitingOp) {
+            responseBuf.assign(f.payload, f.payload + f.len);
+            gotResponse = true;
+        } else if (postedOp[f.seq] != 0 && f.len >= 1 && f.payload[0] == postedOp[f.seq]) {
+            postedOp[f.seq] = 0;
+            postedTotal--;
+            arrived.emplace_back(f.seq, std::vector<uint8_t>(f.payload, f.payload + f.len));
+        } else {
+            stats.staleResponses++;
+        }
+    } else if (f.type == LINK_FRAME_TELEMETRY) {
+        stats.telemetryFrames++;
+        if (telemetrySeen) {
+            stats.telemetryLost += (uint8_t)(f.seq - telemetrySeq - 1);
+        }
+        telemetrySeen = true;
+        telemetrySeq = f.seq;
+        TelemetryRecord rec;
+        if (telemetryCb && telemetryDecode(f.payload, f.len, rec)) {
+            telemetryCb(f.seq, rec);
+        }
+    }
+}
+
+void LinkClient::text(uint8_t b) {
+    stats.textBytes++;
+    if (b == '\r') {
+        return;
+    }
+    if (b == '\n') {
+        if (textCb) {
+            textCb(textLine);
+        }
+        textLine.clear();
+        return;
+    }
+    if (textLine.size() < 1024) {
+        textLine.push_back((char)b);
+    }
+}
+
+// ---- 各操作的请求组织与应答解析 ----
+
+LinkClient::Result LinkClient::ping(const uint8_t* data, size_t len, std::vector<uint8_t>& echo) {
+    std::vector<uint8_t> req(1 + len);
+    req[0] = RPC_OP_PING;
+    std::copy(data, data + len, req.begin() + 1);
+    return call(req.data(), req.size(), echo);
+}
+
+LinkClient::Result LinkClient::info(LinkDeviceInfo& out) {
+    const uint8_t req[] = {RPC_OP_INFO};
+    std::vector<uint8_t> resp;
+    Result r = call(req, sizeof(req), resp);
+    if (r != LINK_OK) {
+        return r;
+    }
+    if (resp.size() != 8) {
+        return LINK_MALFORMED;
+    }
+    out.protocolVersion = resp[0];
+    out.channels = resp[1];
+    out.paramCount = resp[2];
+    out.maxPayload = resp[3];
+    out.uptimeMs = linkGet32(&resp[4]);
+    return LINK_OK;
+}
+
+LinkClient::Result LinkClient::list(std::vector<LinkParamInfo>& out) {
+    out.clear();
+    // 一帧放不下时从下一个序号继续
+    for (;;) {
+        const uint8_t req[] = {RPC_OP_LIST, (uint8_t)out.size()};
+        std::vector<uint8_t> resp;
+        Result r = call(req, sizeof(req), resp);
+        if (r != LINK_OK) {
+            return r;
+        }
+        if (resp.empty()) {
+            return LINK_MALFORMED;
+        }
+        size_t count = resp[0];
+        size_t pos = 1;
+        for (size_t i = 0; i < count; i++) {
+            if (pos + 11 > resp.size() || pos + 11 + resp[pos + 10] > resp.size()) {
+                return LINK_MALFORMED;
+            }
+            LinkParamInfo p;
+            p.id = resp[pos];
+            p.writable = (resp[pos + 1] & RPC_PARAM_WRITABLE) != 0;
+            p.minValue = linkGetFloat(&resp[pos + 2]);
+            p.maxValue = linkGetFloat(&resp[pos + 6]);
+            size_t nameLen = resp[pos + 10];
+            p.name.assign((const char*)&resp[pos + 11], nameLen);
+            pos += 11 + nameLen;
+            out.push_back(p);
+        }
+        if (count == 0) {
+            return LINK_OK;
+        }
+    }
+}
+
+LinkClient::Result LinkClient::get(const std::vector<uint8_t>& ids, std::vector<float>& values,
+                                   std::vector<RpcStatus>* statuses) {
+    std::vector<uint8_t> req(1 + ids.size());
+    req[0] = RPC_OP_GET;
+    std::copy(ids.begin(), ids.end(), req.begin() + 1);
+    std::vector<uint8_t> resp;
+    Result r = call(req.data(), req.size(), resp);
+    if (r != LINK_OK) {
+        return r;
+    }
+    if (resp.size() != ids.size() * 6) {
+        return LINK_MALFORMED;
+    }
+    values.clear();
+    if (statuses) {
+        statuses->clear();
+    }
+    for (size_t i = 0; i < ids.size(); i++) {
+        values.push_back(linkGetFloat(&resp[i * 6 + 2]));
+        if (statuses) {
+            statuses->push_back((RpcStatus)resp[i * 6 + 1]);
+        }
+    }
+    return LINK_OK;
+}
+
+LinkClient::Result LinkClient::set(const std::vector<std::pair<uint8_t, float>>& values,
+                                   std::vector<RpcStatus>& statuses) {
+    std::vector<uint8_t> req(1 + values.size() * 5);
+    req[0] = RPC_OP_SET;
+    for (size_t i = 0; i < values.size(); i++) {
+        req[1 + i * 5] = values[i].first;
+        linkPutFloat(&req[2 + i * 5], values[i].second);
+    }
+    std::vector<uint8_t> resp;
+    Result r = call(req.data(), req.size(), resp);
+    if (r != LINK_OK) {
+        return r;
+    }
+    if (resp.size() != values.size() * 2) {
+        return LINK_MALFORMED;
+    }
+    statuses.clear();
+    for (size_t i = 0; i < values.size(); i++) {
+        statuses.push_back((RpcStatus)resp[i * 2 + 1]);
+    }
+    return LINK_OK;
+}
+
+LinkClient::Result LinkClient::command(RpcCommand cmd) {
+    const uint8_t req[] = {RPC_OP_COMMAND, (uint8_t)cmd};
+    std::vector<uint8_t> resp;
+    return call(req, sizeof(req), resp);
+}
+
+const char* LinkClient::resultName(Result r) {
+    switch (r) {
+        case LINK_OK:           return "成功";
+        case LINK_STATUS:       return "设备拒绝";
+        case LINK_TIMEOUT:      return "超时";
+        case LINK_DISCONNECTED: return "设备已断开";
+        case LINK_MALFORMED:    return "应答格式错误";
+    }
+    return "?";
+}
+
+const char* LinkClient::statusName(RpcStatus st) {
+    switch (st) {
+        case RPC_OK:                    return "OK";
+        case RPC_ERR_UNKNOWN_OP:        return "不支持的操作";
+        case RPC_ERR_BAD_LENGTH:        return "请求长度不对";
+        case RPC_ERR_UNKNOWN_PARAM:     return "参数不存在";
+        case RPC_ERR_READ_ONLY:         return "参数只读";
+        case RPC_ERR_OUT_OF_RANGE:      return "超出范围";
+        case RPC_ERR_UNKNOWN_COMMAND:   return "命令不存在";
+        case RPC_ERR_REJECTED:          return "当前模式不允许";
+        case RPC_ERR_TOO_LARGE:         return "超过大小上限";
+        case RPC_ERR_BUSY:              return "正在校验，稍后重发";
+        case RPC_ERR_BAD_OFFSET:        return "偏移不是期望值";
+        case RPC_ERR_MISMATCH:          return "镜像或差分不符";
+        case RPC_ERR_FLASH:             return "闪存擦写失败";
+        case RPC_ERR_NO_SESSION:        return "没有进行中的升级";
+    }
+    return "?";
+}
@@ -0,0 +1,173 @@
+/**
+ * @file LinkClient.h
+ * @brief 主机端 RPC 客户端：请求/应答、超时重发、遥测与文本分离（协议见 LinkProtocol.h）
+ *
+ * call()：一个请求在途，发送后等待同序号的应答，期间收到的遥测帧和文本行交给回调。
+ * 超时后沿用原序号重发，设备对重发的请求返回缓存的应答，命令不会执行两次。
+ * post()/collect()：流水线，连续发送多个请求再按到达顺序取应答，只用于幂等的请求
+ * （固件升级的数据，按偏移去重），丢失的请求由调用者重发。
+ * 单线程使用。
+ */
+
+#ifndef HOST_LINK_CLIENT_H
+#define HOST_LINK_CLIENT_H
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+#include "LinkFrame.h"
+#include "LinkProtocol.h"
+#include "SerialPort.h"
+
+/**
+ * @brief LIST 应答中的一个参数
+ */
+struct LinkParamInfo {
+    uint8_t id;
+    bool writable;
+    float minValue;
+    float maxValue;
+    std::string name;
+};
+
+/**
+ * @brief INFO 应答
+ */
+struct LinkDeviceInfo {
+    uint8_t protocolVersion;
+    uint8_t channels;
+    uint8_t paramCount;
+    uint8_t maxPayload;
+    uint32_t uptimeMs;
+};
+
+class LinkClient {
+public:
+    /**
+     * @brief 调用结果：RPC 状态，或链路错误（超时、断开、应答格式不对）
+     */
+    enum Result {
+        LINK_OK = 0,
+        LINK_STATUS,            // 设备返回非 RPC_OK，见 status()
+        LINK_TIMEOUT,           // 重发 retries 次仍无应答
+        LINK_DISCONNECTED,
+        LINK_MALFORMED          // 应答操作码或长度不对
+    };
+
+    struct Stats {
+        uint32_t requests;
+        uint32_t retries;
+        uint32_t timeouts;
+        uint32_t staleResponses;    // 序号不符（上一请求超时后才到的应答）
+        uint32_t telemetryFrames;
+        uint32_t telemetryLost;     // 按遥测序号间隔统计
+        uint32_t textBytes;
+    };
+
+    explicit LinkClient(SerialPort& port);
+
+    /**
+     * @param timeoutMs 单次等待应答的时间
+     * @param retries 超时后重发次数
+     */
+    void setTimeout(int timeoutMs, int retries);
+
+    void onTelemetry(std::function<void(uint8_t seq, const TelemetryRecord& rec)> cb) { telemetryCb = cb; }
+    void onText(std::function<void(const std::string& line)> cb) { textCb = cb; }
+
+    /**
+     * @brief 发送请求并等待应答
+     * @param response 应答数据（不含操作码和状态）
+     */
+    Result call(const uint8_t* request, size_t len, std::vector<uint8_t>& response);
+
+    Result ping(const uint8_t* data, size_t len, std::vector<uint8_t>& echo);
+    Result info(LinkDeviceInfo& out);
+    Result list(std::vector<LinkParamInfo>& out);
+    /**
+     * @param statuses 逐个参数的状态（可为 nullptr）
+     */
+    Result get(const std::vector<uint8_t>& ids, std::vector<float>& values, std::vector<RpcStatus>* statuses = nullptr);
+    Result set(const std::vector<std::pair<uint8_t, float>>& values, std::vector<RpcStatus>& statuses);
+    Result command(RpcCommand cmd);
+
+    /**
+     * @brief 流水线发送（不等待应答，序号由本类分配）
+     * @param seq 本请求的序号
+     * @return false 设备断开
+     */
+    bool post(const uint8_t* request, size_t len, uint8_t& seq);
+
+    /**
+     * @brief 取一个 post() 请求的应答（按到达顺序）
+     * @param seq 应答的序号
+     * @param response 应答数据（不含操作码和状态）
+     * @return LINK_OK 收到应答（设备状态见 status）；LINK_TIMEOUT timeoutMs 内没有应答
+     */
+    Result collect(uint8_t& seq, std::vector<uint8_t>& response, RpcStatus& status, int timeoutMs);
+
+    /**
+     * @brief 放弃所有还没收到应答的 post() 请求（之后到达的应答计为过期）
+     */
+    void cancelPosted();
+
+    size_t postedCount() const { return postedTotal; }
+
+    /**
+     * @brief 不发请求，只处理接收（监视遥测）
+     * @return false 设备断开
+     */
+    bool poll(int timeoutMs);
+
+    /**
+     * @brief 最近一次 call() 的设备状态
+     */
+    RpcStatus status() const { return lastStatus; }
+
+    /**
+     * @brief 下一个请求的序号（回环测试用来构造重发）
+     */
+    uint8_t nextSequence() const { return nextSeq; }
+    void setNextSequence(uint8_t seq) { nextSeq = seq; }
+
+    const Stats& counters() const { return stats; }
+    const LinkDecoder::Stats& decoderCounters() const { return decoder.counters(); }
+
+    static const char* resultName(Result r);
+    static const char* statusName(RpcStatus st);
+
+private:
+    SerialPort& port;
+    LinkDecoder decoder;
+    int timeoutMs;
+    int retries;
+    uint8_t nextSeq;
+    RpcStatus lastStatus;
+    Stats stats;
+
+    bool telemetrySeen;
+    uint8_t telemetrySeq;
+    std::string textLine;
+
+    std::function<void(uint8_t, const TelemetryRecord&)> telemetryCb;
+    std::function<void(const std::string&)> textCb;
+
+    // 正在等待的应答（waitingSeq < 0 表示没有）；操作也要相同，
+    // 上一个进程没读走的旧应答可能正好是同一个序号
+    int waitingSeq;
+    uint8_t waitingOp;
+    bool gotResponse;
+    std::vector<uint8_t> responseBuf;
+
+    // 流水线：在途请求的操作码（0 = 不在途）和已到达的应答
+    uint8_t postedOp[256];
+    size_t postedTotal;
+    std::deque<std::pair<uint8_t, std::vector<uint8_t>>> arrived;
+
+    bool receive(int timeoutMs);
+    void dispatch(const LinkFrameView& f);
+    void text(uint8_t b);
+};
+
+#endif // HOST_LINK_CLIENT_H
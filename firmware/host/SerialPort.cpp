@@ -0,0 +1,114 @@
+/**
+ * @file SerialPort.cpp
+ * @brief 主机串口实现（POSIX termios）
+ */
+
+#include "SerialPort.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+SerialPort::SerialPort() : fd(-1) {
+}
+
+SerialPort::~SerialPort() {
+    close();
+}
+
+bool SerialPort::open(const std::string& path) {
+    close();
+    int f = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (f < 0) {
+        lastError = path + ": " + strerror(errno);
+        return false;
+    }
+    return adopt(f);
+}
+
+bool SerialPort::adopt(int f) {
+    termios tio;
+    if (tcgetattr(f, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B115200);
+        cfsetospeed(&tio, B115200);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cc[VMIN] = 0;
+        tio.c_cc[VTIME] = 0;
+        if (tcsetattr(f, TCSANOW, &tio) != 0) {
+            lastError = std::string("tcsetattr: ") + strerror(errno);
+            ::close(f);
+            return false;
+        }
+    }
+    // 不是终端（管道等）时跳过 termios，照常读写
+    int flags = fcntl(f, F_GETFL);
+    fcntl(f, F_SETFL, flags | O_NONBLOCK);
+    fd = f;
+    return true;
+}
+
+void SerialPort::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+ssize_t SerialPort::read(uint8_t* buf, size_t cap, int timeoutMs) {
+    if (fd < 0) {
+        return -1;
+    }
+    pollfd p = {fd, POLLIN, 0};
+    int r = poll(&p, 1, timeoutMs);
+    if (r < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        lastError = std::string("poll: ") + strerror(errno);
+        return -1;
+    }
+    if (r == 0) {
+        return 0;
+    }
+    ssize_t n = ::read(fd, buf, cap);
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EINTR) {
+            return 0;
+        }
+        lastError = std::string("read: ") + strerror(errno);
+        return -1;
+    }
+    if (n == 0 || (p.revents & (POLLHUP | POLLERR))) {
+        // 对端关闭（设备拔出、仿真退出）
+        lastError = "设备已断开";
+        return n > 0 ? n : -1;
+    }
+    return n;
+}
+
+bool SerialPort::write(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::write(fd, data, len);
+        if (n < 0) {
+            if (errno == EAGAIN) {
+                pollfd p = {fd, POLLOUT, 0};
+                if (poll(&p, 1, 1000) <= 0) {
+                    lastError = "写超时";
+                    return false;
+                }
+                continue;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            lastError = std::string("write: ") + strerror(errno);
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
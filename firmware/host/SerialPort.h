@@ -0,0 +1,54 @@
+/**
+ * @file SerialPort.h
+ * @brief 主机串口：打开 /dev/ttyACM*、/dev/ttyUSB* 或伪终端，原始模式，非阻塞读写
+ */
+
+#ifndef HOST_SERIAL_PORT_H
+#define HOST_SERIAL_PORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+class SerialPort {
+public:
+    SerialPort();
+    ~SerialPort();
+
+    SerialPort(const SerialPort&) = delete;
+    SerialPort& operator=(const SerialPort&) = delete;
+
+    /**
+     * @brief 打开串口并设为原始模式（USB CDC 忽略波特率；真实 UART 为 115200）
+     * @return false 打开失败，见 error()
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief 接管已打开的文件描述符（伪终端回环测试）
+     */
+    bool adopt(int fd);
+
+    void close();
+    bool isOpen() const { return fd >= 0; }
+    int handle() const { return fd; }
+
+    /**
+     * @brief 读取已到达的数据，最多等待 timeoutMs
+     * @return 读到的字节数，超时为0，出错（设备拔出）为 -1
+     */
+    ssize_t read(uint8_t* buf, size_t cap, int timeoutMs);
+
+    /**
+     * @brief 写出全部数据（发送缓冲满时等待）
+     */
+    bool write(const uint8_t* data, size_t len);
+
+    const std::string& error() const { return lastError; }
+
+private:
+    int fd;
+    std::string lastError;
+};
+
+#endif // HOST_SERIAL_PORT_H
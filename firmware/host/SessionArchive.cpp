@@ -0,0 +1,605 @@
+/**
+ * @file SessionArchive.cpp
+ * @brief 疗程遥测档案的写入与查询
+ */
+
+#include "SessionArchive.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+
+static_assert(sizeof(SessionColumnInfo) == 32, "index layout");
+static_assert(sizeof(SessionBlockSummary) == 32, "index layout");
+static_assert(sizeof(SessionBlockIndex) == 16, "index layout");
+static_assert(sizeof(SessionArchiveHeader) == 64, "index layout");
+
+namespace {
+
+// 列的顺序固定：9 个公共列，然后每通道 5 列，由列号就能知道取记录的哪个字段
+enum Field : uint8_t {
+    FIELD_TIME, FIELD_UPTIME, FIELD_SEQ, FIELD_MODE, FIELD_GEAR, FIELD_FLAGS, FIELD_BOARD, FIELD_HEATER_LIMIT,
+    FIELD_PUMP_LIMIT, FIELD_TEMP, FIELD_PRESSURE, FIELD_HEATER, FIELD_PUMP, FIELD_CH_FLAGS
+};
+
+const size_t COMMON_COLUMNS = 9;
+const size_t CHANNEL_COLUMNS = 5;
+
+Field columnField(size_t c, uint8_t& channel) {
+    if (c < COMMON_COLUMNS) {
+        channel = 0;
+        return (Field)c;
+    }
+    channel = (uint8_t)((c - COMMON_COLUMNS) / CHANNEL_COLUMNS);
+    return (Field)(FIELD_TEMP + (c - COMMON_COLUMNS) % CHANNEL_COLUMNS);
+}
+
+SessionColumnInfo makeColumn(const char* name, SessionColumnType type, float scale) {
+    static const uint8_t kWidths[] = {8, 4, 2, 1};
+    SessionColumnInfo c = {};
+    snprintf(c.name, sizeof(c.name), "%s", name);
+    c.type = type;
+    c.width = kWidths[type];
+    c.scale = scale;
+    return c;
+}
+
+std::vector<SessionColumnInfo> makeColumns(uint8_t channels) {
+    std::vector<SessionColumnInfo> cols = {
+        makeColumn("unix_ms", SESSION_I64, 1.0f),
+        makeColumn("uptime_ms", SESSION_U32, 1.0f),
+        makeColumn("seq", SESSION_U8, 1.0f),
+        makeColumn("mode", SESSION_U8, 1.0f),
+        makeColumn("gear", SESSION_U8, 1.0f),
+        makeColumn("flags", SESSION_U8, 1.0f),
+        makeColumn("board_c", SESSION_I16, 0.01f),
+        makeColumn("heater_limit", SESSION_U8, 1.0f),
+        makeColumn("pump_limit", SESSION_U8, 1.0f),
+    };
+    char name[SESSION_COLUMN_NAME_LEN];
+    for (unsigned ch = 0; ch < channels; ch++) {
+        snprintf(name, sizeof(name), "temp%u_c", ch);
+        cols.push_back(makeColumn(name, SESSION_I16, 0.01f));
+        snprintf(name, sizeof(name), "pressure%u_mmhg", ch);
+        cols.push_back(makeColumn(name, SESSION_I16, 0.01f));
+        snprintf(name, sizeof(name), "heater%u", ch);
+        cols.push_back(makeColumn(name, SESSION_U8, 1.0f));
+        snprintf(name, sizeof(name), "pump%u", ch);
+        cols.push_back(makeColumn(name, SESSION_U8, 1.0f));
+        snprintf(name, sizeof(name), "flags%u", ch);
+        cols.push_back(makeColumn(name, SESSION_U8, 1.0f));
+    }
+    return cols;
+}
+
+int64_t getField(size_t c, int64_t unixMs, uint8_t seq, const TelemetryRecord& rec) {
+    uint8_t ch;
+    switch (columnField(c, ch)) {
+        case FIELD_TIME: return unixMs;
+        case FIELD_UPTIME: return rec.uptimeMs;
+        case FIELD_SEQ: return seq;
+        case FIELD_MODE: return rec.mode;
+        case FIELD_GEAR: return rec.gear;
+        case FIELD_FLAGS: return rec.flags;
+        case FIELD_BOARD: return rec.boardTempCenti;
+        case FIELD_HEATER_LIMIT: return rec.heaterLimit;
+        case FIELD_PUMP_LIMIT: return rec.pumpLimit;
+        case FIELD_TEMP: return rec.channels[ch].padTempCenti;
+        case FIELD_PRESSURE: return rec.channels[ch].pressureCenti;
+        case FIELD_HEATER: return rec.channels[ch].heaterDuty;
+        case FIELD_PUMP: return rec.channels[ch].pumpPercent;
+        case FIELD_CH_FLAGS: return rec.channels[ch].flags;
+    }
+    return 0;
+}
+
+void setField(size_t c, int64_t v, int64_t& unixMs, uint8_t& seq, TelemetryRecord& rec) {
+    uint8_t ch;
+    switch (columnField(c, ch)) {
+        case FIELD_TIME: unixMs = v; break;
+        case FIELD_UPTIME: rec.uptimeMs = (uint32_t)v; break;
+        case FIELD_SEQ: seq = (uint8_t)v; break;
+        case FIELD_MODE: rec.mode = (uint8_t)v; break;
+        case FIELD_GEAR: rec.gear = (uint8_t)v; break;
+        case FIELD_FLAGS: rec.flags = (uint8_t)v; break;
+        case FIELD_BOARD: rec.boardTempCenti = (int16_t)v; break;
+        case FIELD_HEATER_LIMIT: rec.heaterLimit = (uint8_t)v; break;
+        case FIELD_PUMP_LIMIT: rec.pumpLimit = (uint8_t)v; break;
+        case FIELD_TEMP: rec.channels[ch].padTempCenti = (int16_t)v; break;
+        case FIELD_PRESSURE: rec.channels[ch].pressureCenti = (int16_t)v; break;
+        case FIELD_HEATER: rec.channels[ch].heaterDuty = (uint8_t)v; break;
+        case FIELD_PUMP: rec.channels[ch].pumpPercent = (uint8_t)v; break;
+        case FIELD_CH_FLAGS: rec.channels[ch].flags = (uint8_t)v; break;
+    }
+}
+
+bool isValid(uint8_t type, int64_t v) {
+    return type != SESSION_I16 || v != TELEMETRY_INVALID;
+}
+
+void resetSummary(SessionBlockSummary& s) {
+    s = {};
+    s.min = INT64_MAX;
+    s.max = INT64_MIN;
+}
+
+struct Accumulator {
+    int64_t min = INT64_MAX;
+    int64_t max = INT64_MIN;
+    int64_t sum = 0;
+    uint64_t count = 0;
+};
+
+template <typename T>
+void accumulate(const T* v, uint64_t s, uint64_t e, bool checkInvalid, Accumulator& acc) {
+    int64_t lo = acc.min, hi = acc.max, sum = 0;
+    uint64_t n = 0;
+    for (uint64_t i = s; i < e; i++) {
+        int64_t x = v[i];
+        if (checkInvalid && x == TELEMETRY_INVALID) {
+            continue;
+        }
+        lo = x < lo ? x : lo;
+        hi = x > hi ? x : hi;
+        sum += x;
+        n++;
+    }
+    acc.min = lo;
+    acc.max = hi;
+    acc.sum += sum;
+    acc.count += n;
+}
+
+struct RunState {
+    bool inRun = false;
+    uint64_t start = 0;
+    uint64_t count = 0;
+};
+
+template <typename T>
+void scanRuns(const T* v, uint64_t s, uint64_t e, int64_t lo, int64_t hi, RunState& st,
+              const std::function<void(uint64_t, uint64_t)>& onRun) {
+    for (uint64_t i = s; i < e; i++) {
+        int64_t x = v[i];
+        if (x >= lo && x <= hi) {
+            if (!st.inRun) {
+                st.inRun = true;
+                st.start = i;
+            }
+            st.count++;
+        } else if (st.inRun) {
+            st.inRun = false;
+            onRun(st.start, i - 1);
+        }
+    }
+}
+
+bool setError(std::string* error, const std::string& message) {
+    if (error != nullptr) {
+        *error = message;
+    }
+    return false;
+}
+
+} // namespace
+
+// ============ 写入 ============
+
+SessionArchiveWriter::SessionArchiveWriter()
+    : header{}, index(nullptr), pending(0), lastMs(INT64_MIN), clamped(0), failed(false) {
+}
+
+SessionArchiveWriter::~SessionArchiveWriter() {
+    close();
+}
+
+bool SessionArchiveWriter::create(const std::string& path, uint8_t channelCount, std::string* error) {
+    if (channelCount == 0 || channelCount > TELEMETRY_MAX_CHANNELS) {
+        return setError(error, "通道数无效");
+    }
+    if (mkdir(path.c_str(), 0755) != 0) {
+        return setError(error, path + ": " + strerror(errno));
+    }
+    dir = path;
+    columns = makeColumns(channelCount);
+    header = {};
+    header.magic = SESSION_ARCHIVE_MAGIC;
+    header.version = SESSION_ARCHIVE_VERSION;
+    header.blockSamples = SESSION_BLOCK_SAMPLES;
+    header.columnCount = (uint32_t)columns.size();
+    header.channelCount = channelCount;
+
+    index = fopen((dir + "/index").c_str(), "w+b");
+    if (index == nullptr) {
+        return setError(error, dir + "/index: " + strerror(errno));
+    }
+    for (const SessionColumnInfo& c : columns) {
+        FILE* f = fopen((dir + "/" + c.name + ".col").c_str(), "wb");
+        if (f == nullptr) {
+            setError(error, dir + "/" + c.name + ".col: " + strerror(errno));
+            close();
+            return false;
+        }
+        files.push_back(f);
+        buffers.emplace_back((size_t)header.blockSamples * c.width);
+    }
+    summaries.resize(columns.size());
+    for (SessionBlockSummary& s : summaries) {
+        resetSummary(s);
+    }
+    pending = 0;
+    lastMs = INT64_MIN;
+    clamped = 0;
+    failed = fwrite(&header, sizeof(header), 1, index) != 1
+             || fwrite(columns.data(), sizeof(SessionColumnInfo), columns.size(), index) != columns.size()
+             || fflush(index) != 0;
+    if (failed) {
+        setError(error, dir + "/index: 写入失败");
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool SessionArchiveWriter::append(int64_t unixMs, uint8_t seq, const TelemetryRecord& rec) {
+    if (index == nullptr || failed) {
+        return false;
+    }
+    if (unixMs < lastMs) {
+        unixMs = lastMs;
+        clamped++;
+    }
+    lastMs = unixMs;
+
+    TelemetryRecord r = rec;
+    for (uint8_t ch = r.channelCount; ch < header.channelCount; ch++) {
+        r.channels[ch] = TelemetryChannel{TELEMETRY_INVALID, TELEMETRY_INVALID, 0, 0, 0};
+    }
+    for (size_t c = 0; c < columns.size(); c++) {
+        const SessionColumnInfo& info = columns[c];
+        int64_t v = getField(c, unixMs, seq, r);
+        uint8_t* slot = buffers[c].data() + (size_t)pending * info.width;
+        switch (info.type) {
+            case SESSION_I64: memcpy(slot, &v, 8); break;
+            case SESSION_U32: { uint32_t x = (uint32_t)v; memcpy(slot, &x, 4); break; }
+            case SESSION_I16: { int16_t x = (int16_t)v; memcpy(slot, &x, 2); break; }
+            default: *slot = (uint8_t)v; break;
+        }
+        if (isValid(info.type, v)) {
+            SessionBlockSummary& s = summaries[c];
+            s.min = std::min(s.min, v);
+            s.max = std::max(s.max, v);
+            s.sum += v;
+            s.count++;
+        }
+    }
+    if (++pending == header.blockSamples) {
+        return flushBlock();
+    }
+    return true;
+}
+
+bool SessionArchiveWriter::flushBlock() {
+    if (pending == 0) {
+        return true;
+    }
+    // 先写列数据，再写索引和头：异常退出时索引不会指向不存在的数据
+    for (size_t c = 0; c < columns.size(); c++) {
+        if (fwrite(buffers[c].data(), columns[c].width, pending, files[c]) != pending || fflush(files[c]) != 0) {
+            failed = true;
+        }
+    }
+    SessionBlockIndex entry;
+    memcpy(&entry.firstMs, buffers[0].data(), 8);
+    memcpy(&entry.lastMs, buffers[0].data() + (size_t)(pending - 1) * 8, 8);
+    if (header.blockCount == 0) {
+        header.firstMs = entry.firstMs;
+    }
+    header.lastMs = entry.lastMs;
+    header.sampleCount += pending;
+    header.blockCount++;
+    failed = failed || fseek(index, 0, SEEK_END) != 0 || fwrite(&entry, sizeof(entry), 1, index) != 1
+             || fwrite(summaries.data(), sizeof(SessionBlockSummary), summaries.size(), index) != summaries.size()
+             || fseek(index, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, index) != 1
+             || fflush(index) != 0;
+    pending = 0;
+    for (SessionBlockSummary& s : summaries) {
+        resetSummary(s);
+    }
+    return !failed;
+}
+
+bool SessionArchiveWriter::close() {
+    if (index == nullptr) {
+        for (FILE* f : files) {
+            fclose(f);
+        }
+        files.clear();
+        return false;
+    }
+    bool ok = !failed && flushBlock();
+    for (FILE* f : files) {
+        ok = fclose(f) == 0 && ok;
+    }
+    ok = fclose(index) == 0 && ok;
+    files.clear();
+    buffers.clear();
+    index = nullptr;
+    return ok;
+}
+
+// ============ 查询 ============
+
+SessionArchive::SessionArchive() : header{}, indexBase(nullptr), indexLength(0) {
+}
+
+SessionArchive::~SessionArchive() {
+    close();
+}
+
+static const uint8_t* mapFile(const std::string& path, size_t& length, std::string* error) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        setError(error, path + ": " + strerror(errno));
+        return nullptr;
+    }
+    struct stat st;
+    void* p = MAP_FAILED;
+    length = 0;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        length = (size_t)st.st_size;
+        p = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        setError(error, path + ": 无法映射");
+        length = 0;
+        return nullptr;
+    }
+    return (const uint8_t*)p;
+}
+
+bool SessionArchive::open(const std::string& dir, std::string* error) {
+    close();
+    indexBase = mapFile(dir + "/index", indexLength, error);
+    if (indexBase == nullptr) {
+        return false;
+    }
+    if (indexLength < sizeof(header)) {
+        close();
+        return setError(error, dir + ": 不是档案");
+    }
+    memcpy(&header, indexBase, sizeof(header));
+    const size_t cols = header.columnCount;
+    if (header.magic != SESSION_ARCHIVE_MAGIC || header.version != SESSION_ARCHIVE_VERSION
+            || cols == 0 || cols > SESSION_MAX_COLUMNS || header.blockSamples == 0) {
+        close();
+        return setError(error, dir + ": 不是档案或版本不符");
+    }
+    // 写入方先写块再更新头：头里的块数以内的索引一定完整
+    const size_t need = sizeof(header) + cols * sizeof(SessionColumnInfo)
+                        + header.blockCount * (sizeof(SessionBlockIndex) + cols * sizeof(SessionBlockSummary));
+    if (indexLength < need) {
+        close();
+        return setError(error, dir + "/index: 不完整");
+    }
+    columns.resize(cols);
+    memcpy(columns.data(), indexBase + sizeof(header), cols * sizeof(SessionColumnInfo));
+    if (columns[0].type != SESSION_I64) {
+        close();
+        return setError(error, dir + ": 第一列不是时间");
+    }
+    for (const SessionColumnInfo& c : columns) {
+        size_t length = 0;
+        const uint8_t* p = nullptr;
+        if (header.sampleCount > 0) {
+            std::string name(c.name, strnlen(c.name, SESSION_COLUMN_NAME_LEN));
+            p = mapFile(dir + "/" + name + ".col", length, error);
+            if (p == nullptr || length < header.sampleCount * c.width) {
+                if (p != nullptr) {
+                    munmap((void*)p, length);
+                }
+                close();
+                return setError(error, dir + "/" + name + ".col: 数据不完整");
+            }
+        }
+        data.push_back(p);
+        lengths.push_back(length);
+    }
+    return true;
+}
+
+void SessionArchive::close() {
+    for (size_t c = 0; c < data.size(); c++) {
+        if (data[c] != nullptr) {
+            munmap((void*)data[c], lengths[c]);
+        }
+    }
+    data.clear();
+    lengths.clear();
+    columns.clear();
+    if (indexBase != nullptr) {
+        munmap((void*)indexBase, indexLength);
+    }
+    indexBase = nullptr;
+    indexLength = 0;
+    header = {};
+}
+
+int SessionArchive::columnIndex(const std::string& name) const {
+    for (size_t c = 0; c < columns.size(); c++) {
+        if (strncmp(columns[c].name, name.c_str(), SESSION_COLUMN_NAME_LEN) == 0) {
+            return (int)c;
+        }
+    }
+    return -1;
+}
+
+uint64_t SessionArchive::bytes() const {
+    uint64_t sum = indexLength;
+    for (size_t len : lengths) {
+        sum += len;
+    }
+    return sum;
+}
+
+const SessionBlockIndex* SessionArchive::block(uint64_t b) const {
+    const size_t stride = sizeof(SessionBlockIndex) + columns.size() * sizeof(SessionBlockSummary);
+    return (const SessionBlockIndex*)(indexBase + sizeof(header) + columns.size() * sizeof(SessionColumnInfo)
+                                      + b * stride);
+}
+
+const SessionBlockSummary& SessionArchive::summary(uint64_t b, size_t col) const {
+    return ((const SessionBlockSummary*)(block(b) + 1))[col];
+}
+
+int64_t SessionArchive::raw(size_t col, uint64_t i) const {
+    const uint8_t* p = data[col];
+    switch (columns[col].type) {
+        case SESSION_I64: return ((const int64_t*)p)[i];
+        case SESSION_U32: return ((const uint32_t*)p)[i];
+        case SESSION_I16: return ((const int16_t*)p)[i];
+        default: return p[i];
+    }
+}
+
+double SessionArchive::value(size_t col, uint64_t i) const {
+    int64_t v = raw(col, i);
+    return isValid(columns[col].type, v) ? v * (double)columns[col].scale : NAN;
+}
+
+void SessionArchive::record(uint64_t i, int64_t& unixMs, uint8_t& seq, TelemetryRecord& rec) const {
+    rec = {};
+    rec.channelCount = header.channelCount;
+    for (size_t c = 0; c < columns.size(); c++) {
+        setField(c, raw(c, i), unixMs, seq, rec);
+    }
+}
+
+uint64_t SessionArchive::lowerBound(int64_t unixMs) const {
+    // 块索引：第一个 lastMs >= unixMs 的块；块内：时间列二分
+    uint64_t lo = 0, hi = header.blockCount;
+    while (lo < hi) {
+        uint64_t mid = (lo + hi) / 2;
+        if (block(mid)->lastMs < unixMs) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == header.blockCount) {
+        return header.sampleCount;
+    }
+    const int64_t* t = (const int64_t*)data[0];
+    uint64_t start = lo * header.blockSamples;
+    uint64_t end = std::min<uint64_t>(start + header.blockSamples, header.sampleCount);
+    return (uint64_t)(std::lower_bound(t + start, t + end, unixMs) - t);
+}
+
+SessionArchive::Range SessionArchive::aggregate(size_t col, int64_t fromMs, int64_t toMs, QueryStats* stats) const {
+    QueryStats qs = {};
+    Accumulator acc;
+    const uint64_t first = lowerBound(fromMs);
+    const uint64_t last = toMs > fromMs ? lowerBound(toMs) : first;
+    const uint64_t bs = header.blockSamples;
+    const uint8_t type = columns[col].type;
+    for (uint64_t b = first / bs; first < last && b <= (last - 1) / bs; b++) {
+        const uint64_t bStart = b * bs;
+        const uint64_t bEnd = std::min(bStart + bs, header.sampleCount);
+        const uint64_t s = std::max(first, bStart);
+        const uint64_t e = std::min(last, bEnd);
+        if (s == bStart && e == bEnd) {
+            const SessionBlockSummary& sum = summary(b, col);
+            if (sum.count > 0) {
+                acc.min = std::min(acc.min, sum.min);
+                acc.max = std::max(acc.max, sum.max);
+                acc.sum += sum.sum;
+                acc.count += sum.count;
+            }
+            qs.summarized++;
+            continue;
+        }
+        qs.scanned++;
+        switch (type) {
+            case SESSION_I64: accumulate((const int64_t*)data[col], s, e, false, acc); break;
+            case SESSION_U32: accumulate((const uint32_t*)data[col], s, e, false, acc); break;
+            case SESSION_I16: accumulate((const int16_t*)data[col], s, e, true, acc); break;
+            default: accumulate(data[col], s, e, false, acc); break;
+        }
+    }
+    if (stats != nullptr) {
+        *stats = qs;
+    }
+    Range r;
+    r.count = acc.count;
+    if (acc.count == 0) {
+        r.min = r.max = r.mean = NAN;
+        return r;
+    }
+    const double scale = columns[col].scale;
+    r.min = acc.min * scale;
+    r.max = acc.max * scale;
+    r.mean = (double)acc.sum / acc.count * scale;
+    return r;
+}
+
+uint64_t SessionArchive::findRuns(size_t col, double lo, double hi, int64_t fromMs, int64_t toMs,
+                                  const std::function<void(uint64_t, uint64_t)>& onRun, QueryStats* stats) const {
+    QueryStats qs = {};
+    RunState st;
+    const SessionColumnInfo& info = columns[col];
+    // 条件换成原始整数：[ceil(lo/scale), floor(hi/scale)]，scale 是 float，留 0.001 的余量；无效值不满足任何条件
+    const double l = lo / info.scale, h = hi / info.scale;
+    int64_t loRaw = l <= -9.2e18 ? INT64_MIN : (int64_t)ceil(l - 1e-3);
+    int64_t hiRaw = h >= 9.2e18 ? INT64_MAX : (int64_t)floor(h + 1e-3);
+    if (info.type == SESSION_I16 && loRaw <= TELEMETRY_INVALID) {
+        loRaw = TELEMETRY_INVALID + 1;
+    }
+
+    const uint64_t first = lowerBound(fromMs);
+    const uint64_t last = toMs > fromMs ? lowerBound(toMs) : first;
+    const uint64_t bs = header.blockSamples;
+    for (uint64_t b = first / bs; loRaw <= hiRaw && first < last && b <= (last - 1) / bs; b++) {
+        const uint64_t bStart = b * bs;
+        const uint64_t bEnd = std::min(bStart + bs, header.sampleCount);
+        const uint64_t s = std::max(first, bStart);
+        const uint64_t e = std::min(last, bEnd);
+        // 摘要对整块成立，对块的一部分也成立
+        const SessionBlockSummary& sum = summary(b, col);
+        if (sum.count == 0 || sum.max < loRaw || sum.min > hiRaw) {
+            if (st.inRun) {
+                st.inRun = false;
+                onRun(st.start, s - 1);
+            }
+            qs.skipped++;
+            continue;
+        }
+        if (sum.min >= loRaw && sum.max <= hiRaw && sum.count == bEnd - bStart) {
+            if (!st.inRun) {
+                st.inRun = true;
+                st.start = s;
+            }
+            st.count += e - s;
+            qs.summarized++;
+            continue;
+        }
+        qs.scanned++;
+        switch (info.type) {
+            case SESSION_I64: scanRuns((const int64_t*)data[col], s, e, loRaw, hiRaw, st, onRun); break;
+            case SESSION_U32: scanRuns((const uint32_t*)data[col], s, e, loRaw, hiRaw, st, onRun); break;
+            case SESSION_I16: scanRuns((const int16_t*)data[col], s, e, loRaw, hiRaw, st, onRun); break;
+            default: scanRuns(data[col], s, e, loRaw, hiRaw, st, onRun); break;
+        }
+    }
+    if (st.inRun) {
+        onRun(st.start, last - 1);
+    }
+    if (stats != nullptr) {
+        *stats = qs;
+    }
+    return st.count;
+}
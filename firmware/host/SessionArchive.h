@@ -0,0 +1,234 @@
+/**
+ * @file SessionArchive.h
+ * @brief 疗程遥测档案：按列存放、可直接 mmap，带稀疏时间索引和每块最小/最大值摘要
+ *
+ * 一个档案是一个目录：
+ *   index          头、列表、块索引（每块的起止时间，每列的最小/最大/和/有效样本数）
+ *   <列名>.col     每列一个文件，定长整数的数组，单位与遥测相同（温度、负压为 0.01）
+ * 样本按主机时间排序，每 SESSION_BLOCK_SAMPLES 个一块（最后一块可以不满）。
+ * 按时间定位：块索引二分找到块，再在这一块的时间列中二分。区间统计对完全落在区间内的块只读摘要，
+ * 只扫描两端的块；按值查找跳过摘要范围与条件不相交的块，整块满足条件的也不扫描。
+ * 写入时每满一块追加到列文件，然后追加块索引、更新头，异常退出最多丢失未满的最后一块。
+ * 文件按宿主字节序（小端）存放，不在不同字节序的机器间复制。
+ */
+
+#ifndef HOST_SESSION_ARCHIVE_H
+#define HOST_SESSION_ARCHIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include "LinkProtocol.h"
+
+#define SESSION_ARCHIVE_MAGIC       0x52415347u     // "GSAR"
+#define SESSION_ARCHIVE_VERSION     1
+#define SESSION_BLOCK_SAMPLES       1024            // 100ms 遥测约 100 秒一块
+#define SESSION_COLUMN_NAME_LEN     24
+#define SESSION_MAX_COLUMNS         (9 + 5 * TELEMETRY_MAX_CHANNELS)
+
+enum SessionColumnType : uint8_t {
+    SESSION_I64 = 0,
+    SESSION_U32,
+    SESSION_I16,            // 温度/负压，TELEMETRY_INVALID 不计入统计、不满足任何条件
+    SESSION_U8
+};
+
+/**
+ * @brief 列描述（index 中的列表，32 字节）
+ */
+struct SessionColumnInfo {
+    char name[SESSION_COLUMN_NAME_LEN];     // 与 collect CSV 的列名相同
+    uint8_t type;                           // SessionColumnType
+    uint8_t width;                          // 字节
+    uint8_t reserved[2];
+    float scale;                            // 物理量 = 原始值 × scale
+};
+
+/**
+ * @brief 一块中一列的摘要（32 字节）
+ */
+struct SessionBlockSummary {
+    int64_t min;
+    int64_t max;
+    int64_t sum;
+    uint32_t count;         // 有效样本数
+    uint32_t reserved;
+};
+
+/**
+ * @brief 块索引项，后面紧跟 columnCount 个 SessionBlockSummary
+ */
+struct SessionBlockIndex {
+    int64_t firstMs;
+    int64_t lastMs;
+};
+
+/**
+ * @brief index 文件头（64 字节）
+ */
+struct SessionArchiveHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t blockSamples;
+    uint32_t columnCount;
+    uint64_t sampleCount;   // 已写入块索引的样本
+    uint64_t blockCount;
+    int64_t firstMs;
+    int64_t lastMs;
+    uint8_t channelCount;
+    uint8_t reserved[15];
+};
+
+/**
+ * @brief 写入档案（collect -a、archive import）
+ */
+class SessionArchiveWriter {
+public:
+    SessionArchiveWriter();
+    ~SessionArchiveWriter();
+
+    SessionArchiveWriter(const SessionArchiveWriter&) = delete;
+    SessionArchiveWriter& operator=(const SessionArchiveWriter&) = delete;
+
+    /**
+     * @brief 新建档案目录（已存在则失败，不覆盖）
+     * @param channelCount 通道数，决定列数
+     */
+    bool create(const std::string& dir, uint8_t channelCount, std::string* error = nullptr);
+
+    /**
+     * @brief 追加一个样本。时间早于上一个样本时按上一个样本的时间记（主机时钟回拨），计入 clampedTimes()；
+     *        通道数多于创建时的部分不记录
+     */
+    bool append(int64_t unixMs, uint8_t seq, const TelemetryRecord& rec);
+
+    /**
+     * @brief 写出未满的最后一块并关闭（析构时自动调用）
+     */
+    bool close();
+
+    bool isOpen() const { return index != nullptr; }
+    uint64_t size() const { return header.sampleCount + pending; }
+    uint32_t clampedTimes() const { return clamped; }
+
+private:
+    std::string dir;
+    SessionArchiveHeader header;
+    std::vector<SessionColumnInfo> columns;
+    std::vector<FILE*> files;
+    FILE* index;
+    std::vector<std::vector<uint8_t>> buffers;  // 当前块，每列一个
+    std::vector<SessionBlockSummary> summaries;
+    uint32_t pending;
+    int64_t lastMs;
+    uint32_t clamped;
+    bool failed;
+
+    bool flushBlock();
+};
+
+/**
+ * @brief 只读打开档案（mmap）
+ */
+class SessionArchive {
+public:
+    /**
+     * @brief 区间统计（物理量），没有有效样本时 count = 0，其余为 NAN
+     */
+    struct Range {
+        double min;
+        double max;
+        double mean;
+        uint64_t count;
+    };
+
+    /**
+     * @brief 一次查询读了多少块：只用摘要的、扫描数据的、跳过的
+     */
+    struct QueryStats {
+        uint32_t summarized;
+        uint32_t scanned;
+        uint32_t skipped;
+    };
+
+    SessionArchive();
+    ~SessionArchive();
+
+    SessionArchive(const SessionArchive&) = delete;
+    SessionArchive& operator=(const SessionArchive&) = delete;
+
+    bool open(const std::string& dir, std::string* error = nullptr);
+    void close();
+
+    uint64_t size() const { return header.sampleCount; }
+    uint64_t blockCount() const { return header.blockCount; }
+    uint32_t blockSamples() const { return header.blockSamples; }
+    uint8_t channelCount() const { return header.channelCount; }
+    int64_t firstMs() const { return header.firstMs; }
+    int64_t lastMs() const { return header.lastMs; }
+    size_t columnCount() const { return columns.size(); }
+    const SessionColumnInfo& column(size_t c) const { return columns[c]; }
+
+    /**
+     * @brief 按列名查找（与 CSV 表头相同，如 temp0_c、pressure1_mmhg、mode），没有返回 -1
+     */
+    int columnIndex(const std::string& name) const;
+
+    /**
+     * @brief 磁盘占用（列文件 + 索引）
+     */
+    uint64_t bytes() const;
+
+    int64_t timeAt(uint64_t i) const { return ((const int64_t*)data[0])[i]; }
+
+    /**
+     * @brief 一列的原始数组（size() 个 column(col).width 字节的整数），批量计算直接读取
+     */
+    const void* columnData(size_t col) const { return data[col]; }
+
+    int64_t raw(size_t col, uint64_t i) const;
+
+    /**
+     * @brief 物理量，无效值为 NAN
+     */
+    double value(size_t col, uint64_t i) const;
+
+    /**
+     * @brief 还原第 i 个样本（archive export）
+     */
+    void record(uint64_t i, int64_t& unixMs, uint8_t& seq, TelemetryRecord& rec) const;
+
+    /**
+     * @brief 第一个时间不早于 unixMs 的样本序号（都早于时返回 size()）
+     */
+    uint64_t lowerBound(int64_t unixMs) const;
+
+    /**
+     * @brief [fromMs, toMs) 内一列的最小/最大/平均
+     */
+    Range aggregate(size_t col, int64_t fromMs, int64_t toMs, QueryStats* stats = nullptr) const;
+
+    /**
+     * @brief [fromMs, toMs) 内数值在 [lo, hi] 的样本，按连续段回调 onRun(第一个, 最后一个)
+     * @return 满足条件的样本数
+     */
+    uint64_t findRuns(size_t col, double lo, double hi, int64_t fromMs, int64_t toMs,
+                      const std::function<void(uint64_t first, uint64_t last)>& onRun,
+                      QueryStats* stats = nullptr) const;
+
+private:
+    SessionArchiveHeader header;
+    std::vector<SessionColumnInfo> columns;
+    std::vector<const uint8_t*> data;
+    std::vector<size_t> lengths;
+    const uint8_t* indexBase;
+    size_t indexLength;
+
+    const SessionBlockIndex* block(uint64_t b) const;
+    const SessionBlockSummary& summary(uint64_t b, size_t col) const;
+};
+
+#endif // HOST_SESSION_ARCHIVE_H
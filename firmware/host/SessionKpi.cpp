@@ -0,0 +1,218 @@
+/**
+ * @file SessionKpi.cpp
+ * @brief 疗程质量指标计算
+ */
+
+#include "SessionKpi.h"
+#include <math.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <algorithm>
+#include "SignalKernels.h"
+
+namespace {
+
+struct ChannelColumns {
+    const int16_t* temp;
+    const int16_t* pressure;
+    const uint8_t* pump;
+    const uint8_t* flags;
+};
+
+struct ChannelAcc {
+    int64_t tempSum = 0;
+    uint64_t tempCount = 0;
+    uint64_t tempInBand = 0;
+    int16_t tempMax = INT16_MIN;
+    uint64_t pressureCount = 0;
+    uint64_t pressureInBand = 0;
+    int32_t pressureOver = INT32_MIN;   // 超出档位目标的最大量 (0.01 mmHg)
+    uint64_t pumpSum = 0;
+    double sxx = 0;                     // 泵速趋势：各段去均值后的 Σw·x²、Σw·x·y
+    double sxy = 0;
+};
+
+double threadCpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int16_t centi(double v) {
+    return telemetryCenti((float)v);
+}
+
+/**
+ * @brief 一个 RUN、档位不变的段 [s, e)
+ */
+void segment(const int64_t* t, const ChannelColumns& c, size_t s, size_t e, uint8_t gear, const KpiOptions& o,
+             ChannelAcc& acc) {
+    const size_t n = e - s;
+    const double target = (double)KPI_PRESSURE_FULL_GEAR * gear / KPI_NUM_GEARS;
+    const int16_t targetCenti = centi(target);
+
+    I16BandStats ts = i16BandStats(c.temp + s, n, centi(o.tempTarget - o.tempBand), centi(o.tempTarget + o.tempBand));
+    acc.tempSum += ts.sum;
+    acc.tempCount += ts.count;
+    acc.tempInBand += ts.inBand;
+    acc.tempMax = std::max(acc.tempMax, ts.max);
+
+    I16BandStats ps = i16BandStats(c.pressure + s, n, centi(target - o.pressureBand), centi(target + o.pressureBand));
+    acc.pressureCount += ps.count;
+    acc.pressureInBand += ps.inBand;
+    if (ps.count > 0) {
+        acc.pressureOver = std::max(acc.pressureOver, (int32_t)ps.max - targetCenti);
+    }
+
+    // 泵速：按块求平均，块的时间取中间样本（小时，相对段起点）
+    double sw = 0, swx = 0, swy = 0, swxx = 0, swxy = 0;
+    for (size_t b = s; b < e; b += KPI_TREND_CHUNK) {
+        const size_t len = std::min<size_t>(KPI_TREND_CHUNK, e - b);
+        const uint64_t sum = u8Sum(c.pump + b, len);
+        acc.pumpSum += sum;
+        const double w = (double)len;
+        const double x = (t[b + len / 2] - t[s]) / 3.6e6;
+        const double y = (double)sum / len;
+        sw += w;
+        swx += w * x;
+        swy += w * y;
+        swxx += w * x * x;
+        swxy += w * x * y;
+    }
+    if (n > KPI_TREND_CHUNK) {
+        acc.sxx += swxx - swx * swx / sw;
+        acc.sxy += swxy - swx * swy / sw;
+    }
+}
+
+} // namespace
+
+bool sessionKpi(const SessionArchive& a, const KpiOptions& o, SessionKpi& k, std::string* error) {
+    k = SessionKpi{};
+    k.samples = a.size();
+    k.channels = a.channelCount();
+    k.tempInBand = k.tempMean = k.tempOvershoot = NAN;
+    k.pressureInBand = k.pressureOvershoot = k.pumpMean = k.leakTrend = NAN;
+
+    const int modeCol = a.columnIndex("mode");
+    const int gearCol = a.columnIndex("gear");
+    const int flagsCol = a.columnIndex("flags");
+    std::vector<ChannelColumns> channels;
+    for (unsigned ch = 0; ch < a.channelCount(); ch++) {
+        const std::string n = std::to_string(ch);
+        const int cols[] = {a.columnIndex("temp" + n + "_c"), a.columnIndex("pressure" + n + "_mmhg"),
+                            a.columnIndex("pump" + n), a.columnIndex("flags" + n)};
+        if (*std::min_element(cols, cols + 4) < 0) {
+            if (error != nullptr) {
+                *error = "缺少通道" + n + "的列";
+            }
+            return false;
+        }
+        channels.push_back({(const int16_t*)a.columnData(cols[0]), (const int16_t*)a.columnData(cols[1]),
+                            (const uint8_t*)a.columnData(cols[2]), (const uint8_t*)a.columnData(cols[3])});
+    }
+    if (modeCol < 0 || gearCol < 0 || flagsCol < 0) {
+        if (error != nullptr) {
+            *error = "缺少 mode/gear/flags 列";
+        }
+        return false;
+    }
+    const size_t n = a.size();
+    if (n == 0) {
+        return true;
+    }
+    k.hours = (a.lastMs() - a.firstMs()) / 3.6e6;
+
+    const int64_t* t = (const int64_t*)a.columnData(0);
+    const uint8_t* mode = (const uint8_t*)a.columnData(modeCol);
+    const uint8_t* gear = (const uint8_t*)a.columnData(gearCol);
+    const uint8_t* flags = (const uint8_t*)a.columnData(flagsCol);
+
+    std::vector<ChannelAcc> acc(channels.size());
+    int64_t runMs = 0;
+    uint64_t runSamples = 0;
+    for (size_t i = 0; i < n;) {
+        const uint8_t* p = (const uint8_t*)memchr(mode + i, KPI_MODE_RUN, n - i);
+        if (p == nullptr) {
+            break;
+        }
+        const size_t s = p - mode;
+        const size_t e = s + u8FindNot(mode + s, n - s, KPI_MODE_RUN);
+        runMs += (e < n ? t[e] : t[n - 1]) - t[s];
+        runSamples += e - s;
+        for (size_t j = s; j < e;) {
+            const uint8_t g = gear[j];
+            const size_t je = j + u8FindNot(gear + j, e - j, g);
+            for (size_t ch = 0; ch < channels.size(); ch++) {
+                segment(t, channels[ch], j, je, g, o, acc[ch]);
+            }
+            j = je;
+        }
+        i = e;
+    }
+
+    k.faults = (uint32_t)u8Entries(mode, n, 0xFF, KPI_MODE_FAULT, 0);
+    k.estops = (uint32_t)u8Entries(mode, n, 0xFF, KPI_MODE_ESTOP, 0);
+    k.derating = (uint32_t)u8Entries(flags, n, TELEMETRY_FLAG_DERATING, TELEMETRY_FLAG_DERATING, 0);
+    for (const ChannelColumns& c : channels) {
+        k.overTemp += (uint32_t)u8Entries(c.flags, n, TELEMETRY_CH_OVER_TEMP, TELEMETRY_CH_OVER_TEMP, 0);
+    }
+
+    k.runHours = runMs / 3.6e6;
+    if (runSamples == 0 || channels.empty()) {
+        return true;
+    }
+    ChannelAcc all;
+    int16_t tempMax = INT16_MIN;
+    for (const ChannelAcc& c : acc) {
+        all.tempSum += c.tempSum;
+        all.tempCount += c.tempCount;
+        all.tempInBand += c.tempInBand;
+        tempMax = std::max(tempMax, c.tempMax);
+        all.pressureCount += c.pressureCount;
+        all.pressureInBand += c.pressureInBand;
+        all.pressureOver = std::max(all.pressureOver, c.pressureOver);
+        all.pumpSum += c.pumpSum;
+        all.sxx += c.sxx;
+        all.sxy += c.sxy;
+    }
+    if (all.tempCount > 0) {
+        k.tempInBand = (double)all.tempInBand / all.tempCount;
+        k.tempMean = all.tempSum * 0.01 / all.tempCount;
+        k.tempOvershoot = std::max(0.0, tempMax * 0.01 - o.tempTarget);
+    }
+    if (all.pressureCount > 0) {
+        k.pressureInBand = (double)all.pressureInBand / all.pressureCount;
+        k.pressureOvershoot = std::max(0.0, all.pressureOver * 0.01);
+    }
+    k.pumpMean = (double)all.pumpSum / (runSamples * channels.size());
+    if (all.sxx > 0) {
+        k.leakTrend = all.sxy / all.sxx;
+    }
+    return true;
+}
+
+void sessionKpiBatch(const std::vector<std::string>& dirs, const KpiOptions& o, WorkPool& pool,
+                     std::vector<SessionKpiResult>& results) {
+    results.assign(dirs.size(), SessionKpiResult{});
+    std::vector<uint64_t> costs(dirs.size(), 0);
+    for (size_t i = 0; i < dirs.size(); i++) {
+        struct stat st;
+        if (stat((dirs[i] + "/unix_ms.col").c_str(), &st) == 0) {
+            costs[i] = (uint64_t)st.st_size;
+        }
+    }
+    pool.run(dirs.size(),
+             [&](size_t i, unsigned) {
+                 const double cpu0 = threadCpuSeconds();
+                 SessionKpiResult& r = results[i];
+                 r.dir = dirs[i];
+                 SessionArchive a;
+                 r.ok = a.open(dirs[i], &r.error) && sessionKpi(a, o, r.kpi, &r.error);
+                 r.bytes = r.ok ? a.bytes() : 0;
+                 a.close();
+                 r.seconds = threadCpuSeconds() - cpu0;
+             },
+             costs);
+}
@@ -0,0 +1,81 @@
+/**
+ * @file SessionKpi.h
+ * @brief 单个疗程档案的质量指标：温度/负压在带内的时间、超调、漏气趋势、报警次数
+ *
+ * 只统计 RUN 模式的样本（预热、暂停、泄压不计），RUN 按档位分段：每段的负压目标由档位决定，
+ * 每段内的温度、负压、泵速用 SignalKernels 的向量化归约整段计算。
+ * 漏气趋势：维持同一负压所需的泵速随时间上升说明漏气在加重。泵速按 KPI_TREND_CHUNK 个样本
+ * 求平均，在每个档位段内对时间做线性拟合（各段分别去掉均值再合并，档位变化不算趋势），单位 %/h。
+ * 报警在整个疗程上统计（进入 FAULT、ESTOP，过温、降额标志置位）。
+ */
+
+#ifndef HOST_SESSION_KPI_H
+#define HOST_SESSION_KPI_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "SessionArchive.h"
+#include "WorkPool.h"
+
+// 与 SystemMode 相同（SystemStateMachine.h 依赖 Arduino，主机不包含）
+#define KPI_MODE_RUN            3
+#define KPI_MODE_FAULT          6
+#define KPI_MODE_ESTOP          7
+
+// 与 config.h 相同：目标温度 TEMP_TARGET_DEFAULT；档位 g 的目标负压 PRESSURE_TARGET_DEFAULT × g / PRESSURE_NUM_GEARS
+#define KPI_TEMP_TARGET         40.0f
+#define KPI_PRESSURE_FULL_GEAR  15.0f
+#define KPI_NUM_GEARS           10
+
+#define KPI_TREND_CHUNK         600     // 100ms 遥测为 1 分钟
+
+struct KpiOptions {
+    float tempTarget = KPI_TEMP_TARGET;
+    float tempBand = 1.0f;              // 目标 ± 带宽 (°C)
+    float pressureBand = 1.0f;          // 档位目标 ± 带宽 (mmHg)
+};
+
+/**
+ * @brief 一个疗程的指标，比例为 0-1；没有 RUN 样本时比例、均值、超调、趋势为 NAN
+ */
+struct SessionKpi {
+    uint64_t samples;
+    uint8_t channels;
+    double hours;                       // 首尾样本的时间差
+    double runHours;
+    double tempInBand;
+    double tempMean;
+    double tempOvershoot;               // 最高温度超出目标的量 (°C)，不超过为 0
+    double pressureInBand;
+    double pressureOvershoot;           // 负压超出档位目标的最大量 (mmHg)，不超过为 0
+    double pumpMean;                    // %
+    double leakTrend;                   // %/h，样本不足一个趋势块时为 NAN
+    uint32_t faults;
+    uint32_t estops;
+    uint32_t overTemp;                  // 各通道合计
+    uint32_t derating;
+};
+
+/**
+ * @return false 档案缺少需要的列
+ */
+bool sessionKpi(const SessionArchive& a, const KpiOptions& o, SessionKpi& k, std::string* error = nullptr);
+
+struct SessionKpiResult {
+    std::string dir;
+    bool ok;
+    std::string error;                  // 打不开或缺少列
+    uint64_t bytes;                     // 档案大小
+    double seconds;                     // 打开并计算用的线程 CPU 时间
+    SessionKpi kpi;
+};
+
+/**
+ * @brief 在线程池中计算一批档案（每个档案一个任务，在工作线程中 mmap），结果与 dirs 顺序相同；
+ *        任务开销按时间列文件的大小估计
+ */
+void sessionKpiBatch(const std::vector<std::string>& dirs, const KpiOptions& o, WorkPool& pool,
+                     std::vector<SessionKpiResult>& results);
+
+#endif // HOST_SESSION_KPI_H
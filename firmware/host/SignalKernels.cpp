@@ -0,0 +1,301 @@
+/**
+ * @file SignalKernels.cpp
+ * @brief 向量化归约：一个模板按向量宽度实例化，256 位版本放在 target("avx2") 函数中展开
+ */
+
+#include "SignalKernels.h"
+#include <string.h>
+#include <atomic>
+#include "LinkProtocol.h"
+
+#define INLINE inline __attribute__((always_inline))
+#define SCALAR __attribute__((optimize("no-tree-vectorize")))
+
+namespace {
+
+// ---- 标量版本（对照基准，禁止编译器自动向量化） ----
+
+SCALAR I16BandStats i16Scalar(const int16_t* v, size_t n, int16_t lo, int16_t hi) {
+    I16BandStats r = {0, 0, 0, INT16_MAX, INT16_MIN};
+    for (size_t i = 0; i < n; i++) {
+        int16_t x = v[i];
+        if (x == TELEMETRY_INVALID) {
+            continue;
+        }
+        r.sum += x;
+        r.count++;
+        r.inBand += x >= lo && x <= hi;
+        r.min = x < r.min ? x : r.min;
+        r.max = x > r.max ? x : r.max;
+    }
+    return r;
+}
+
+SCALAR uint64_t u8SumScalar(const uint8_t* v, size_t n) {
+    uint64_t s = 0;
+    for (size_t i = 0; i < n; i++) {
+        s += v[i];
+    }
+    return s;
+}
+
+SCALAR uint64_t u8EntriesScalar(const uint8_t* v, size_t n, uint8_t mask, uint8_t value, uint8_t prev) {
+    uint64_t c = 0;
+    bool was = (prev & mask) == value;
+    for (size_t i = 0; i < n; i++) {
+        bool is = (v[i] & mask) == value;
+        c += is && !was;
+        was = is;
+    }
+    return c;
+}
+
+SCALAR size_t u8FindNotScalar(const uint8_t* v, size_t n, uint8_t value) {
+    for (size_t i = 0; i < n; i++) {
+        if (v[i] != value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+// ---- 向量版本，W = 向量字节数 ----
+
+// vector_size 不能依赖模板参数，按宽度列出。都与寄存器同宽：加宽用同一寄存器内的移位完成，
+// 更宽的类型（如 8 个 int16 转成 8 个 int32）GCC 会放在栈上
+typedef int16_t I16x8 __attribute__((vector_size(16)));
+typedef int32_t I32x4 __attribute__((vector_size(16)));
+typedef uint16_t U16x8 __attribute__((vector_size(16)));
+typedef int8_t S8x16 __attribute__((vector_size(16)));
+typedef int16_t I16x16 __attribute__((vector_size(32)));
+typedef int32_t I32x8 __attribute__((vector_size(32)));
+typedef uint16_t U16x16 __attribute__((vector_size(32)));
+typedef int8_t S8x32 __attribute__((vector_size(32)));
+
+template <int W> struct Vec;
+template <> struct Vec<16> {
+    typedef I16x8 I16;
+    typedef I32x4 I32;
+    typedef U16x8 U16;
+    typedef S8x16 S8;
+};
+template <> struct Vec<32> {
+    typedef I16x16 I16;
+    typedef I32x8 I32;
+    typedef U16x16 U16;
+    typedef S8x32 S8;
+};
+
+template <int W>
+INLINE I16BandStats i16Vector(const int16_t* v, size_t n, int16_t lo, int16_t hi) {
+    typedef typename Vec<W>::I16 I16;
+    typedef typename Vec<W>::I32 I32;
+    const size_t L = W / 2;
+    const I16 invalid = I16{} + (int16_t)TELEMETRY_INVALID;
+    const I16 vlo = I16{} + lo;
+    const I16 vhi = I16{} + hi;
+    const I16 top = I16{} + (int16_t)INT16_MAX;
+    I16 vmin = top;
+    I16 vmax = invalid;
+    I16BandStats r = {0, 0, 0, INT16_MAX, INT16_MIN};
+    size_t i = 0;
+    while (i + L <= n) {
+        // 计数放在 16 位通道中，每 32767 次迭代汇总一次；相邻两个样本的和放在 32 位通道中，
+        // 每次最多加 2 × 32767，32767 次不会溢出
+        I16 count = {}, inBand = {};
+        I32 sum = {};
+        for (int k = 0; k < 32767 && i + L <= n; k++, i += L) {
+            I16 x;
+            memcpy(&x, v + i, W);
+            I16 valid = x != invalid;
+            count -= valid;
+            inBand -= (x >= vlo) & (x <= vhi) & valid;
+            I32 pair = (I32)(x & valid);
+            sum += ((pair << 16) >> 16) + (pair >> 16);
+            vmin = valid ? (x < vmin ? x : vmin) : vmin;
+            vmax = x > vmax ? x : vmax;         // 无效值就是 INT16_MIN，不影响最大值
+        }
+        for (size_t l = 0; l < L; l++) {
+            r.count += (uint16_t)count[l];
+            r.inBand += (uint16_t)inBand[l];
+        }
+        for (size_t l = 0; l < L / 2; l++) {
+            r.sum += sum[l];
+        }
+    }
+    for (size_t l = 0; l < L; l++) {
+        r.min = vmin[l] < r.min ? vmin[l] : r.min;
+        r.max = vmax[l] > r.max ? vmax[l] : r.max;
+    }
+    I16BandStats t = i16Scalar(v + i, n - i, lo, hi);
+    r.sum += t.sum;
+    r.count += t.count;
+    r.inBand += t.inBand;
+    r.min = t.min < r.min ? t.min : r.min;
+    r.max = t.max > r.max ? t.max : r.max;
+    if (r.count == 0) {
+        r.max = INT16_MIN;                      // 全部无效时 vmax 中是 INVALID
+    }
+    return r;
+}
+
+template <int W>
+INLINE uint64_t u8SumVector(const uint8_t* v, size_t n) {
+    typedef typename Vec<W>::U16 U16;
+    const U16 low = U16{} + (uint16_t)0x00FF;
+    uint64_t s = 0;
+    size_t i = 0;
+    while (i + W <= n) {
+        U16 acc = {};                           // 相邻两字节之和，每次最多 510，128 次不会溢出
+        for (int k = 0; k < 128 && i + W <= n; k++, i += W) {
+            U16 x;
+            memcpy(&x, v + i, W);
+            acc += (x & low) + (x >> 8);
+        }
+        for (int l = 0; l < W / 2; l++) {
+            s += acc[l];
+        }
+    }
+    return s + u8SumScalar(v + i, n - i);
+}
+
+template <int W>
+INLINE uint64_t u8EntriesVector(const uint8_t* v, size_t n, uint8_t mask, uint8_t value, uint8_t prev) {
+    typedef typename Vec<W>::S8 S8;
+    if (n == 0) {
+        return 0;
+    }
+    uint64_t c = u8EntriesScalar(v, 1, mask, value, prev);
+    const S8 vm = S8{} + (int8_t)mask;
+    const S8 vv = S8{} + (int8_t)value;
+    size_t i = 1;
+    while (i + W <= n) {
+        S8 acc = {};                            // 每通道最多 127
+        for (int k = 0; k < 127 && i + W <= n; k++, i += W) {
+            S8 x, p;
+            memcpy(&x, v + i, W);
+            memcpy(&p, v + i - 1, W);
+            acc -= ((x & vm) == vv) & ((p & vm) != vv);
+        }
+        for (int l = 0; l < W; l++) {
+            c += (uint8_t)acc[l];
+        }
+    }
+    return c + u8EntriesScalar(v + i, n - i, mask, value, v[i - 1]);
+}
+
+template <int W>
+INLINE size_t u8FindNotVector(const uint8_t* v, size_t n, uint8_t value) {
+    typedef typename Vec<W>::S8 S8;
+    const S8 vv = S8{} + (int8_t)value;
+    size_t i = 0;
+    for (; i + W <= n; i += W) {
+        S8 x;
+        memcpy(&x, v + i, W);
+        S8 eq = x == vv;
+        uint64_t words[W / 8];
+        memcpy(words, &eq, W);
+        for (int k = 0; k < W / 8; k++) {
+            if (words[k] != ~0ull) {
+                return i + k * 8 + __builtin_ctzll(~words[k]) / 8;
+            }
+        }
+    }
+    return i + u8FindNotScalar(v + i, n - i, value);
+}
+
+I16BandStats i16V128(const int16_t* v, size_t n, int16_t lo, int16_t hi) { return i16Vector<16>(v, n, lo, hi); }
+uint64_t u8SumV128(const uint8_t* v, size_t n) { return u8SumVector<16>(v, n); }
+uint64_t u8EntriesV128(const uint8_t* v, size_t n, uint8_t mask, uint8_t value, uint8_t prev) {
+    return u8EntriesVector<16>(v, n, mask, value, prev);
+}
+size_t u8FindNotV128(const uint8_t* v, size_t n, uint8_t value) { return u8FindNotVector<16>(v, n, value); }
+
+#if defined(__x86_64__)
+#define HAVE_V256 1
+#define AVX2 __attribute__((target("avx2")))
+AVX2 I16BandStats i16V256(const int16_t* v, size_t n, int16_t lo, int16_t hi) { return i16Vector<32>(v, n, lo, hi); }
+AVX2 uint64_t u8SumV256(const uint8_t* v, size_t n) { return u8SumVector<32>(v, n); }
+AVX2 uint64_t u8EntriesV256(const uint8_t* v, size_t n, uint8_t mask, uint8_t value, uint8_t prev) {
+    return u8EntriesVector<32>(v, n, mask, value, prev);
+}
+AVX2 size_t u8FindNotV256(const uint8_t* v, size_t n, uint8_t value) { return u8FindNotVector<32>(v, n, value); }
+#else
+#define HAVE_V256 0
+#endif
+
+struct Kernels {
+    SignalIsa isa;
+    I16BandStats (*i16BandStats)(const int16_t*, size_t, int16_t, int16_t);
+    uint64_t (*u8Sum)(const uint8_t*, size_t);
+    uint64_t (*u8Entries)(const uint8_t*, size_t, uint8_t, uint8_t, uint8_t);
+    size_t (*u8FindNot)(const uint8_t*, size_t, uint8_t);
+};
+
+const Kernels kKernels[] = {
+    {SIGNAL_ISA_SCALAR, i16Scalar, u8SumScalar, u8EntriesScalar, u8FindNotScalar},
+    {SIGNAL_ISA_V128, i16V128, u8SumV128, u8EntriesV128, u8FindNotV128},
+#if HAVE_V256
+    {SIGNAL_ISA_V256, i16V256, u8SumV256, u8EntriesV256, u8FindNotV256},
+#endif
+};
+
+SignalIsa bestIsa() {
+#if HAVE_V256
+    if (__builtin_cpu_supports("avx2")) {
+        return SIGNAL_ISA_V256;
+    }
+#endif
+    return SIGNAL_ISA_V128;
+}
+
+std::atomic<const Kernels*> gKernels{nullptr};
+
+const Kernels& kernels() {
+    const Kernels* k = gKernels.load(std::memory_order_acquire);
+    if (k == nullptr) {
+        k = &kKernels[bestIsa()];
+        gKernels.store(k, std::memory_order_release);
+    }
+    return *k;
+}
+
+} // namespace
+
+SignalIsa signalKernelsForce(SignalIsa isa) {
+    const SignalIsa best = bestIsa();
+    if (isa > best) {
+        isa = best;                             // 包括 SIGNAL_ISA_AUTO
+    }
+    gKernels.store(&kKernels[isa], std::memory_order_release);
+    return isa;
+}
+
+SignalIsa signalKernelsIsa() {
+    return kernels().isa;
+}
+
+const char* signalIsaName(SignalIsa isa) {
+    switch (isa) {
+        case SIGNAL_ISA_SCALAR: return "标量";
+        case SIGNAL_ISA_V128: return "128 位";
+        case SIGNAL_ISA_V256: return "256 位";
+        default: return "自动";
+    }
+}
+
+I16BandStats i16BandStats(const int16_t* v, size_t n, int16_t lo, int16_t hi) {
+    return kernels().i16BandStats(v, n, lo, hi);
+}
+
+uint64_t u8Sum(const uint8_t* v, size_t n) {
+    return kernels().u8Sum(v, n);
+}
+
+uint64_t u8Entries(const uint8_t* v, size_t n, uint8_t mask, uint8_t value, uint8_t prev) {
+    return kernels().u8Entries(v, n, mask, value, prev);
+}
+
+size_t u8FindNot(const uint8_t* v, size_t n, uint8_t value) {
+    return kernels().u8FindNot(v, n, value);
+}
@@ -0,0 +1,65 @@
+/**
+ * @file SignalKernels.h
+ * @brief 档案列上的向量化归约（SessionKpi 使用）
+ *
+ * 同一份代码用 GCC 向量扩展写成，编译成标量、128 位（x86-64 的 SSE2 基线，ARM 的 NEON）
+ * 和 256 位（x86-64 的 AVX2）三个版本，首次调用时按 CPU 选择；
+ * signalKernelsForce() 可以指定版本，用于对照检查和基准。
+ * 所有版本的结果完全相同（整数运算，与累加顺序无关）。
+ */
+
+#ifndef HOST_SIGNAL_KERNELS_H
+#define HOST_SIGNAL_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum SignalIsa : uint8_t {
+    SIGNAL_ISA_SCALAR = 0,
+    SIGNAL_ISA_V128,
+    SIGNAL_ISA_V256,
+    SIGNAL_ISA_AUTO
+};
+
+/**
+ * @brief int16 列（温度/负压）的统计，TELEMETRY_INVALID 不计入
+ */
+struct I16BandStats {
+    int64_t sum;
+    uint64_t count;         // 有效样本
+    uint64_t inBand;        // lo <= v <= hi 的样本
+    int16_t min;            // 没有有效样本时为 INT16_MAX
+    int16_t max;            // 没有有效样本时为 INT16_MIN
+};
+
+/**
+ * @brief 选择实现（SIGNAL_ISA_AUTO = 按 CPU 选最快的），CPU 不支持时退回可用的最高版本
+ * @return 实际使用的版本
+ */
+SignalIsa signalKernelsForce(SignalIsa isa);
+
+SignalIsa signalKernelsIsa();
+const char* signalIsaName(SignalIsa isa);
+
+/**
+ * @brief int16 列的有效样本数、和、最小/最大，以及落在 [lo, hi] 的样本数
+ */
+I16BandStats i16BandStats(const int16_t* v, size_t n, int16_t lo, int16_t hi);
+
+/**
+ * @brief uint8 列的和
+ */
+uint64_t u8Sum(const uint8_t* v, size_t n);
+
+/**
+ * @brief (v[i] & mask) == value 且前一个样本不满足的次数（进入某模式、标志置位），
+ *        v[0] 与 prev 比较
+ */
+uint64_t u8Entries(const uint8_t* v, size_t n, uint8_t mask, uint8_t value, uint8_t prev);
+
+/**
+ * @brief 第一个不等于 value 的位置，全部相等返回 n
+ */
+size_t u8FindNot(const uint8_t* v, size_t n, uint8_t value);
+
+#endif // HOST_SIGNAL_KERNELS_H
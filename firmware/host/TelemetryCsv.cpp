@@ -0,0 +1,116 @@
+/**
+ * @file TelemetryCsv.cpp
+ * @brief 遥测 CSV 读写
+ */
+
+#include "TelemetryCsv.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char* kModeNames[] = {"BOOT", "IDLE", "WARMUP", "RUN", "HOLD", "VENTING", "FAULT", "ESTOP"};
+
+const char* telemetryModeName(uint8_t mode) {
+    return mode < sizeof(kModeNames) / sizeof(kModeNames[0]) ? kModeNames[mode] : "?";
+}
+
+void telemetryCsvHeader(FILE* f) {
+    fprintf(f, "unix_ms,uptime_ms,seq,mode,gear,flags,board_c,heater_limit,pump_limit");
+    for (int ch = 0; ch < TELEMETRY_MAX_CHANNELS; ch++) {
+        fprintf(f, ",temp%d_c,pressure%d_mmhg,heater%d,pump%d,flags%d", ch, ch, ch, ch, ch);
+    }
+    fputc('\n', f);
+}
+
+void telemetryCsvRow(FILE* f, int64_t unixMs, uint8_t seq, const TelemetryRecord& rec) {
+    fprintf(f, "%lld,%u,%u,%u,%u,%u,%.2f,%u,%u", (long long)unixMs, rec.uptimeMs, seq, rec.mode, rec.gear, rec.flags,
+            telemetryFromCenti(rec.boardTempCenti), rec.heaterLimit, rec.pumpLimit);
+    for (uint8_t ch = 0; ch < TELEMETRY_MAX_CHANNELS; ch++) {
+        if (ch < rec.channelCount) {
+            const TelemetryChannel& c = rec.channels[ch];
+            fprintf(f, ",%.2f,%.2f,%u,%u,%u", telemetryFromCenti(c.padTempCenti), telemetryFromCenti(c.pressureCenti),
+                    c.heaterDuty, c.pumpPercent, c.flags);
+        } else {
+            fputs(",,,,,", f);
+        }
+    }
+    fputc('\n', f);
+}
+
+namespace {
+
+// 逐列解析：每次取到下一个逗号（或行尾）为止
+struct Fields {
+    const char* p;
+    bool ok = true;
+
+    bool empty() const { return *p == ',' || *p == '\0' || *p == '\n' || *p == '\r'; }
+
+    void skip() {
+        if (*p == ',') {
+            p++;
+        } else if (*p != '\0' && *p != '\n' && *p != '\r') {
+            ok = false;
+        }
+    }
+
+    long long integer(long long lo, long long hi) {
+        char* end;
+        long long v = strtoll(p, &end, 10);
+        if (end == p || v < lo || v > hi) {
+            ok = false;
+        }
+        p = end;
+        skip();
+        return v;
+    }
+
+    int16_t centi() {
+        char* end;
+        double v = strtod(p, &end);
+        if (end == p) {
+            ok = false;
+        }
+        p = end;
+        skip();
+        return telemetryCenti((float)v);
+    }
+};
+
+} // namespace
+
+bool telemetryCsvParse(const char* line, int64_t& unixMs, uint8_t& seq, TelemetryRecord& rec) {
+    Fields f{line};
+    unixMs = f.integer(INT64_MIN, INT64_MAX);
+    rec.uptimeMs = (uint32_t)f.integer(0, UINT32_MAX);
+    seq = (uint8_t)f.integer(0, 255);
+    rec.mode = (uint8_t)f.integer(0, 255);
+    rec.gear = (uint8_t)f.integer(0, 255);
+    rec.flags = (uint8_t)f.integer(0, 255);
+    rec.boardTempCenti = f.centi();
+    rec.heaterLimit = (uint8_t)f.integer(0, 255);
+    rec.pumpLimit = (uint8_t)f.integer(0, 255);
+    rec.channelCount = 0;
+    for (uint8_t ch = 0; ch < TELEMETRY_MAX_CHANNELS && f.ok; ch++) {
+        if (f.empty()) {
+            // 没有这个通道：五列都为空，之后的通道也不会有
+            for (int i = 0; i < 5; i++) {
+                if (!f.empty()) {
+                    return false;
+                }
+                f.skip();
+            }
+            continue;
+        }
+        if (ch != rec.channelCount) {
+            return false;
+        }
+        TelemetryChannel& c = rec.channels[ch];
+        c.padTempCenti = f.centi();
+        c.pressureCenti = f.centi();
+        c.heaterDuty = (uint8_t)f.integer(0, 255);
+        c.pumpPercent = (uint8_t)f.integer(0, 255);
+        c.flags = (uint8_t)f.integer(0, 255);
+        rec.channelCount++;
+    }
+    return f.ok && rec.channelCount > 0;
+}
@@ -0,0 +1,32 @@
+/**
+ * @file TelemetryCsv.h
+ * @brief 遥测 CSV：collect 写入、archive 导入导出共用的格式
+ *
+ * 每行一帧：主机墙钟毫秒、设备运行时间、帧序号、模式、档位、标志、板温、降额上限，
+ * 然后固定 TELEMETRY_MAX_CHANNELS 组通道列（温度、负压、加热、泵、通道标志），没有的通道留空。
+ * 温度/负压按 0.01 精度写出，与遥测的定点单位一致，读回后不损失精度；无效值写作 nan。
+ */
+
+#ifndef HOST_TELEMETRY_CSV_H
+#define HOST_TELEMETRY_CSV_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "LinkProtocol.h"
+
+/**
+ * @brief 模式名（SystemMode，与 SystemStateMachine::modeName 一致的简称），未知为 "?"
+ */
+const char* telemetryModeName(uint8_t mode);
+
+void telemetryCsvHeader(FILE* f);
+
+void telemetryCsvRow(FILE* f, int64_t unixMs, uint8_t seq, const TelemetryRecord& rec);
+
+/**
+ * @brief 解析一行（不含表头）
+ * @return false 列数不对或数值无效
+ */
+bool telemetryCsvParse(const char* line, int64_t& unixMs, uint8_t& seq, TelemetryRecord& rec);
+
+#endif // HOST_TELEMETRY_CSV_H
@@ -0,0 +1,65 @@
+/**
+ * @file TelemetrySeries.cpp
+ * @brief 遥测时间序列实现
+ */
+
+#include "TelemetrySeries.h"
+#include <math.h>
+
+TelemetrySeries::TelemetrySeries(size_t capacity)
+    : cap(capacity > 0 ? capacity : 1), count(0), next(0), pushed(0),
+      hostTime(cap), uptime(cap), modes(cap), boardTemp(cap) {
+    for (int ch = 0; ch < TELEMETRY_MAX_CHANNELS; ch++) {
+        temp[ch].assign(cap, TELEMETRY_INVALID);
+        press[ch].assign(cap, TELEMETRY_INVALID);
+        heater[ch].assign(cap, 0);
+        pump[ch].assign(cap, 0);
+    }
+}
+
+void TelemetrySeries::push(int64_t hostUs, const TelemetryRecord& rec) {
+    const size_t i = next;
+    hostTime[i] = hostUs;
+    uptime[i] = rec.uptimeMs;
+    modes[i] = rec.mode;
+    boardTemp[i] = rec.boardTempCenti;
+    for (uint8_t ch = 0; ch < TELEMETRY_MAX_CHANNELS; ch++) {
+        const bool present = ch < rec.channelCount;
+        temp[ch][i] = present ? rec.channels[ch].padTempCenti : TELEMETRY_INVALID;
+        press[ch][i] = present ? rec.channels[ch].pressureCenti : TELEMETRY_INVALID;
+        heater[ch][i] = present ? rec.channels[ch].heaterDuty : 0;
+        pump[ch][i] = present ? rec.channels[ch].pumpPercent : 0;
+    }
+    next = (next + 1) % cap;
+    if (count < cap) {
+        count++;
+    }
+    pushed++;
+}
+
+TelemetrySeries::Range TelemetrySeries::range(const std::vector<int16_t>& column, int64_t sinceUs) const {
+    Range r = {NAN, NAN, NAN, 0};
+    int32_t lo = INT16_MAX, hi = INT16_MIN;
+    int64_t sum = 0;
+    // 从最新往回，时间早于窗口即停
+    for (size_t k = count; k-- > 0;) {
+        size_t i = index(k);
+        if (hostTime[i] < sinceUs) {
+            break;
+        }
+        int16_t v = column[i];
+        if (v == TELEMETRY_INVALID) {
+            continue;
+        }
+        lo = v < lo ? v : lo;
+        hi = v > hi ? v : hi;
+        sum += v;
+        r.count++;
+    }
+    if (r.count > 0) {
+        r.min = lo / 100.0f;
+        r.max = hi / 100.0f;
+        r.mean = (float)(sum / 100.0 / r.count);
+    }
+    return r;
+}
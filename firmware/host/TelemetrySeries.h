@@ -0,0 +1,76 @@
+/**
+ * @file TelemetrySeries.h
+ * @brief 单台设备的遥测时间序列：固定容量的按列环形缓冲（内存有上限，满了覆盖最旧的）
+ *
+ * 每个量一列（主机时间、设备运行时间、模式、板温、各通道温度/负压/加热/泵），
+ * 统计一个量时只扫它那一列。每个样本 TELEMETRY_SERIES_SAMPLE_BYTES 字节。
+ */
+
+#ifndef HOST_TELEMETRY_SERIES_H
+#define HOST_TELEMETRY_SERIES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "LinkProtocol.h"
+
+#define TELEMETRY_SERIES_SAMPLE_BYTES   (8 + 4 + 1 + 2 + TELEMETRY_MAX_CHANNELS * (2 + 2 + 1 + 1))
+
+class TelemetrySeries {
+public:
+    /**
+     * @brief 窗口统计（TELEMETRY_INVALID 的样本不计）
+     */
+    struct Range {
+        float min;
+        float max;
+        float mean;
+        uint32_t count;
+    };
+
+    explicit TelemetrySeries(size_t capacity);
+
+    void push(int64_t hostUs, const TelemetryRecord& rec);
+
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+    uint64_t total() const { return pushed; }
+    size_t memoryBytes() const { return cap * TELEMETRY_SERIES_SAMPLE_BYTES; }
+
+    // i = 0 为最旧的样本
+    int64_t hostUs(size_t i) const { return hostTime[index(i)]; }
+    uint32_t uptimeMs(size_t i) const { return uptime[index(i)]; }
+    uint8_t mode(size_t i) const { return modes[index(i)]; }
+    float padTemp(uint8_t ch, size_t i) const { return telemetryFromCenti(temp[ch][index(i)]); }
+    float pressure(uint8_t ch, size_t i) const { return telemetryFromCenti(press[ch][index(i)]); }
+    uint8_t heaterDuty(uint8_t ch, size_t i) const { return heater[ch][index(i)]; }
+    uint8_t pumpPercent(uint8_t ch, size_t i) const { return pump[ch][index(i)]; }
+
+    /**
+     * @brief 主机时间不早于 sinceUs 的样本中，通道 ch 的温度/负压统计
+     */
+    Range padTempRange(uint8_t ch, int64_t sinceUs) const { return range(temp[ch], sinceUs); }
+    Range pressureRange(uint8_t ch, int64_t sinceUs) const { return range(press[ch], sinceUs); }
+
+    void clear() { count = 0; next = 0; }
+
+private:
+    size_t cap;
+    size_t count;
+    size_t next;            // 下一个写入位置
+    uint64_t pushed;
+
+    std::vector<int64_t> hostTime;
+    std::vector<uint32_t> uptime;
+    std::vector<uint8_t> modes;
+    std::vector<int16_t> boardTemp;
+    std::vector<int16_t> temp[TELEMETRY_MAX_CHANNELS];
+    std::vector<int16_t> press[TELEMETRY_MAX_CHANNELS];
+    std::vector<uint8_t> heater[TELEMETRY_MAX_CHANNELS];
+    std::vector<uint8_t> pump[TELEMETRY_MAX_CHANNELS];
+
+    size_t index(size_t i) const { return (next + cap - count + i) % cap; }
+    Range range(const std::vector<int16_t>& column, int64_t sinceUs) const;
+};
+
+#endif // HOST_TELEMETRY_SERIES_H
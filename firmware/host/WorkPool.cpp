@@ -0,0 +1,121 @@
+/**
+ * @file WorkPool.cpp
+ * @brief 任务窃取线程池实现
+ */
+
+#include "WorkPool.h"
+#include <algorithm>
+#include <numeric>
+
+WorkPool::WorkPool(unsigned threads, bool steal)
+    : stealing(steal), generation(0), running(0), quit(false), job(nullptr) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threads; i++) {
+        queues.emplace_back(new Queue());
+    }
+    last.steals = 0;
+    last.tasks.assign(threads, 0);
+    for (unsigned i = 1; i < threads; i++) {
+        workers.emplace_back(&WorkPool::loop, this, i);
+    }
+}
+
+WorkPool::~WorkPool() {
+    {
+        std::lock_guard<std::mutex> g(lock);
+        quit = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+void WorkPool::run(size_t count, const std::function<void(size_t, unsigned)>& fn, const std::vector<uint64_t>& costs) {
+    // 开销从大到小轮流分配，每个队列的头部是它最大的任务
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    if (costs.size() == count) {
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return costs[a] > costs[b]; });
+    }
+    const unsigned n = threads();
+    for (size_t i = 0; i < count; i++) {
+        queues[i % n]->tasks.push_back(order[i]);
+    }
+    last.steals = 0;
+    std::fill(last.tasks.begin(), last.tasks.end(), 0);
+    {
+        std::lock_guard<std::mutex> g(lock);
+        job = &fn;
+        running = n;
+        generation++;
+    }
+    wake.notify_all();
+    work(0);
+    std::unique_lock<std::mutex> g(lock);
+    idle.wait(g, [this]() { return running == 0; });
+    job = nullptr;
+}
+
+void WorkPool::loop(unsigned worker) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> g(lock);
+            wake.wait(g, [&]() { return quit || generation != seen; });
+            if (quit) {
+                return;
+            }
+            seen = generation;
+        }
+        work(worker);
+    }
+}
+
+void WorkPool::work(unsigned worker) {
+    uint32_t done = 0;
+    uint64_t steals = 0;
+    size_t task;
+    bool stolen;
+    while (take(worker, task, stolen)) {
+        (*job)(task, worker);
+        done++;
+        steals += stolen;
+    }
+    std::lock_guard<std::mutex> g(lock);
+    last.tasks[worker] = done;
+    last.steals += steals;
+    if (--running == 0) {
+        idle.notify_all();
+    }
+}
+
+bool WorkPool::take(unsigned worker, size_t& task, bool& stolen) {
+    {
+        Queue& q = *queues[worker];
+        std::lock_guard<std::mutex> g(q.lock);
+        if (!q.tasks.empty()) {
+            task = q.tasks.front();
+            q.tasks.pop_front();
+            stolen = false;
+            return true;
+        }
+    }
+    if (!stealing) {
+        return false;
+    }
+    const unsigned n = threads();
+    for (unsigned k = 1; k < n; k++) {
+        Queue& q = *queues[(worker + k) % n];
+        std::lock_guard<std::mutex> g(q.lock);
+        if (!q.tasks.empty()) {
+            task = q.tasks.back();
+            q.tasks.pop_back();
+            stolen = true;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file WorkPool.h
+ * @brief 固定线程数的任务池，每个线程一个任务队列，自己的做完后从别的队列窃取
+ *
+ * 一批任务按预估开销从大到小轮流分到各队列（开销大的先做），线程从自己队列的头部取，
+ * 空闲时从其他队列的尾部窃取（剩下的小任务），批内任务数与开销差别很大时也能均衡。
+ * 任务不再产生新任务，所有队列都空即结束。调用 run() 的线程作为 0 号线程参与。
+ * 队列用互斥锁保护：任务粒度是整个档案（毫秒级），锁的开销可以忽略。
+ */
+
+#ifndef HOST_WORK_POOL_H
+#define HOST_WORK_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkPool {
+public:
+    /**
+     * @brief 一批任务的统计
+     */
+    struct Stats {
+        uint64_t steals;
+        std::vector<uint32_t> tasks;        // 每个线程完成的任务数
+    };
+
+    /**
+     * @param threads 线程数，0 = CPU 核数
+     * @param stealing false = 只做分到自己队列的任务（基准对照用）
+     */
+    explicit WorkPool(unsigned threads = 0, bool stealing = true);
+    ~WorkPool();
+
+    WorkPool(const WorkPool&) = delete;
+    WorkPool& operator=(const WorkPool&) = delete;
+
+    unsigned threads() const { return (unsigned)queues.size(); }
+
+    /**
+     * @brief 执行 fn(任务序号, 线程序号)，全部完成后返回（不能在任务中再调用 run）
+     * @param costs 每个任务的预估开销，空 = 都相同
+     */
+    void run(size_t count, const std::function<void(size_t task, unsigned worker)>& fn,
+             const std::vector<uint64_t>& costs = {});
+
+    const Stats& stats() const { return last; }
+
+private:
+    struct Queue {
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    bool stealing;
+
+    std::mutex lock;
+    std::condition_variable wake;           // 新一批任务或退出
+    std::condition_variable idle;           // 一个线程做完了这一批
+    uint64_t generation;
+    unsigned running;
+    bool quit;
+    const std::function<void(size_t, unsigned)>* job;
+    Stats last;
+
+    void loop(unsigned worker);
+    void work(unsigned worker);
+    bool take(unsigned worker, size_t& task, bool& stolen);
+};
+
+#endif // HOST_WORK_POOL_H
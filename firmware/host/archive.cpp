@@ -0,0 +1,297 @@
+/**
+ * @file archive.cpp
+ * @brief 疗程档案工具：从 collect 的 CSV 导入、查看、区间统计、按值查找、导出（格式见 SessionArchive.h）
+ *
+ *   archive import logs/ttyACM0.csv sessions/a0            # CSV -> 档案
+ *   archive info sessions/a0
+ *   archive stats sessions/a0 temp0_c "2026-10-18 09:00" +3600
+ *   archive find sessions/a0 pressure0_mmhg 45 1000         # 负压超过 45 mmHg 的时间段
+ *   archive find sessions/a0 mode 6 6                       # FAULT 模式
+ *   archive export sessions/a0 +600 +1200 > part.csv
+ *
+ * 时间参数：unix 毫秒、本地时间 "YYYY-MM-DD HH:MM[:SS]"，或 +秒（起点相对档案开头，终点相对起点）。
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+#include "SessionArchive.h"
+#include "TelemetryCsv.h"
+
+namespace {
+
+const size_t MAX_PRINTED_RUNS = 100;
+
+void usage() {
+    fprintf(stderr,
+            "用法: archive 命令 ...\n"
+            "  import CSV 档案目录                   从 collect 的 CSV 导入（档案目录不能已存在）\n"
+            "  info 档案目录                         样本数、时间范围、各列的范围\n"
+            "  stats 档案目录 列 [起点 [终点]]       区间内的最小/最大/平均\n"
+            "  find 档案目录 列 下限 上限 [起点 [终点]]  数值在 [下限, 上限] 的时间段\n"
+            "  export 档案目录 [起点 [终点]]         导出 CSV 到标准输出\n"
+            "时间: unix 毫秒 | \"YYYY-MM-DD HH:MM[:SS]\"（本地时间）| +秒\n"
+            "列名与 CSV 表头相同：unix_ms uptime_ms seq mode gear flags board_c heater_limit pump_limit\n"
+            "                     temp<通道>_c pressure<通道>_mmhg heater<通道> pump<通道> flags<通道>\n");
+}
+
+double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+std::string formatTime(int64_t unixMs) {
+    time_t t = (time_t)(unixMs / 1000);
+    struct tm tm;
+    localtime_r(&t, &tm);
+    char buf[40];
+    size_t n = strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+    snprintf(buf + n, sizeof(buf) - n, ".%03d", (int)(unixMs % 1000));
+    return buf;
+}
+
+bool parseTime(const char* arg, int64_t base, int64_t& out) {
+    char* end;
+    if (arg[0] == '+') {
+        double s = strtod(arg + 1, &end);
+        out = base + (int64_t)llround(s * 1000.0);
+        return *end == '\0';
+    }
+    struct tm tm = {};
+    const char* rest = strptime(arg, "%Y-%m-%d %H:%M:%S", &tm);
+    if (rest == nullptr) {
+        tm = {};
+        rest = strptime(arg, "%Y-%m-%d %H:%M", &tm);
+    }
+    if (rest != nullptr && *rest == '\0') {
+        tm.tm_isdst = -1;
+        out = (int64_t)mktime(&tm) * 1000;
+        return true;
+    }
+    out = strtoll(arg, &end, 10);
+    return end != arg && *end == '\0';
+}
+
+/**
+ * @brief argv[i]、argv[i+1] 为可选的起点、终点，默认整个档案
+ */
+bool parseWindow(const SessionArchive& a, int argc, char** argv, int i, int64_t& from, int64_t& to) {
+    from = a.firstMs();
+    to = a.lastMs() + 1;
+    if (i < argc && !parseTime(argv[i], a.firstMs(), from)) {
+        fprintf(stderr, "无效的起点: %s\n", argv[i]);
+        return false;
+    }
+    if (i + 1 < argc && !parseTime(argv[i + 1], from, to)) {
+        fprintf(stderr, "无效的终点: %s\n", argv[i + 1]);
+        return false;
+    }
+    return true;
+}
+
+bool openArchive(SessionArchive& a, const char* dir) {
+    std::string error;
+    if (!a.open(dir, &error)) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return false;
+    }
+    return true;
+}
+
+int findColumn(const SessionArchive& a, const char* name) {
+    int c = a.columnIndex(name);
+    if (c < 0) {
+        fprintf(stderr, "没有列 %s\n", name);
+    }
+    return c;
+}
+
+int cmdImport(const char* csvPath, const char* dir) {
+    FILE* f = fopen(csvPath, "r");
+    if (f == nullptr) {
+        perror(csvPath);
+        return 1;
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    SessionArchiveWriter w;
+    char* line = nullptr;
+    size_t cap = 0;
+    ssize_t len;
+    uint64_t lineNo = 0, bad = 0, csvBytes = 0;
+    while ((len = getline(&line, &cap, f)) > 0) {
+        lineNo++;
+        csvBytes += (uint64_t)len;
+        int64_t unixMs;
+        uint8_t seq;
+        TelemetryRecord rec;
+        if (!telemetryCsvParse(line, unixMs, seq, rec)) {
+            bad += lineNo > 1;      // 第一行是表头
+            continue;
+        }
+        std::string error;
+        if (!w.isOpen() && !w.create(dir, rec.channelCount, &error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            free(line);
+            fclose(f);
+            return 1;
+        }
+        if (!w.append(unixMs, seq, rec)) {
+            fprintf(stderr, "%s: 写入失败\n", dir);
+            free(line);
+            fclose(f);
+            return 1;
+        }
+    }
+    free(line);
+    fclose(f);
+    if (!w.isOpen()) {
+        fprintf(stderr, "%s: 没有遥测行\n", csvPath);
+        return 1;
+    }
+    const uint64_t samples = w.size();
+    const uint32_t clamped = w.clampedTimes();
+    if (!w.close()) {
+        fprintf(stderr, "%s: 写入失败\n", dir);
+        return 1;
+    }
+    SessionArchive a;
+    if (!openArchive(a, dir)) {
+        return 1;
+    }
+    printf("导入 %llu 个样本（%llu 块），%.2f 秒；无法解析 %llu 行，时间回退 %u 次\n", (unsigned long long)samples,
+           (unsigned long long)a.blockCount(), secondsSince(t0), (unsigned long long)bad, clamped);
+    printf("CSV %.1f MB -> 档案 %.1f MB（%.1f 字节/样本）\n", csvBytes / 1048576.0, a.bytes() / 1048576.0,
+           samples > 0 ? (double)a.bytes() / samples : 0.0);
+    return 0;
+}
+
+int cmdInfo(const char* dir) {
+    SessionArchive a;
+    if (!openArchive(a, dir)) {
+        return 1;
+    }
+    printf("样本 %llu，块 %llu（每块 %u），通道 %u，%.1f MB\n", (unsigned long long)a.size(),
+           (unsigned long long)a.blockCount(), a.blockSamples(), a.channelCount(), a.bytes() / 1048576.0);
+    if (a.size() == 0) {
+        return 0;
+    }
+    printf("时间 %s 至 %s（%.1f 小时）\n", formatTime(a.firstMs()).c_str(), formatTime(a.lastMs()).c_str(),
+           (a.lastMs() - a.firstMs()) / 3600000.0);
+    printf("%-16s %12s %12s %12s %12s\n", "列", "最小", "最大", "平均", "有效样本");
+    for (size_t c = 1; c < a.columnCount(); c++) {
+        SessionArchive::Range r = a.aggregate(c, a.firstMs(), a.lastMs() + 1);
+        printf("%-16s %12.2f %12.2f %12.2f %12llu\n", a.column(c).name, r.min, r.max, r.mean,
+               (unsigned long long)r.count);
+    }
+    return 0;
+}
+
+int cmdStats(int argc, char** argv) {
+    SessionArchive a;
+    int64_t from, to;
+    if (!openArchive(a, argv[0])) {
+        return 1;
+    }
+    int c = findColumn(a, argv[1]);
+    if (c < 0 || !parseWindow(a, argc, argv, 2, from, to)) {
+        return 1;
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    SessionArchive::QueryStats qs;
+    SessionArchive::Range r = a.aggregate((size_t)c, from, to, &qs);
+    double us = secondsSince(t0) * 1e6;
+    printf("%s  %s 至 %s\n", a.column(c).name, formatTime(from).c_str(), formatTime(to).c_str());
+    printf("最小 %.2f  最大 %.2f  平均 %.3f  有效样本 %llu\n", r.min, r.max, r.mean, (unsigned long long)r.count);
+    printf("用摘要 %u 块，扫描 %u 块，%.0f us\n", qs.summarized, qs.scanned, us);
+    return 0;
+}
+
+int cmdFind(int argc, char** argv) {
+    SessionArchive a;
+    int64_t from, to;
+    if (!openArchive(a, argv[0])) {
+        return 1;
+    }
+    int c = findColumn(a, argv[1]);
+    char* end1;
+    char* end2;
+    double lo = strtod(argv[2], &end1);
+    double hi = strtod(argv[3], &end2);
+    if (*end1 != '\0' || *end2 != '\0') {
+        fprintf(stderr, "无效的范围: %s %s\n", argv[2], argv[3]);
+        return 1;
+    }
+    if (c < 0 || !parseWindow(a, argc, argv, 4, from, to)) {
+        return 1;
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    SessionArchive::QueryStats qs;
+    size_t runs = 0;
+    uint64_t n = a.findRuns((size_t)c, lo, hi, from, to,
+                            [&](uint64_t first, uint64_t last) {
+                                if (runs++ < MAX_PRINTED_RUNS) {
+                                    printf("%s  %8.1f s  %8llu 个样本\n", formatTime(a.timeAt(first)).c_str(),
+                                           (a.timeAt(last) - a.timeAt(first)) / 1000.0,
+                                           (unsigned long long)(last - first + 1));
+                                }
+                            },
+                            &qs);
+    double us = secondsSince(t0) * 1e6;
+    if (runs > MAX_PRINTED_RUNS) {
+        printf("...（只列出前 %zu 段）\n", MAX_PRINTED_RUNS);
+    }
+    printf("%s 在 [%g, %g]：%zu 段，%llu 个样本；用摘要 %u 块，扫描 %u 块，跳过 %u 块，%.0f us\n",
+           a.column(c).name, lo, hi, runs, (unsigned long long)n, qs.summarized, qs.scanned, qs.skipped, us);
+    return 0;
+}
+
+int cmdExport(int argc, char** argv) {
+    SessionArchive a;
+    int64_t from, to;
+    if (!openArchive(a, argv[0]) || !parseWindow(a, argc, argv, 1, from, to)) {
+        return 1;
+    }
+    telemetryCsvHeader(stdout);
+    const uint64_t last = a.lowerBound(to);
+    for (uint64_t i = a.lowerBound(from); i < last; i++) {
+        int64_t unixMs;
+        uint8_t seq;
+        TelemetryRecord rec;
+        a.record(i, unixMs, seq, rec);
+        telemetryCsvRow(stdout, unixMs, seq, rec);
+    }
+    return fflush(stdout) == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        usage();
+        return 2;
+    }
+    const std::string cmd = argv[1];
+    const int n = argc - 2;
+    char** args = argv + 2;
+    if (cmd == "import" && n == 2) {
+        return cmdImport(args[0], args[1]);
+    }
+    if (cmd == "info" && n == 1) {
+        return cmdInfo(args[0]);
+    }
+    if (cmd == "stats" && n >= 2 && n <= 4) {
+        return cmdStats(n, args);
+    }
+    if (cmd == "find" && n >= 4 && n <= 6) {
+        return cmdFind(n, args);
+    }
+    if (cmd == "export" && n >= 1 && n <= 3) {
+        return cmdExport(n, args);
+    }
+    usage();
+    return 2;
+}
@@ -0,0 +1,496 @@
+/**
+ * @file archive_bench.cpp
+ * @brief 疗程档案的检查与基准：同一段合成疗程分别写成档案和带时间戳的文本日志，对比查询
+ *
+ *   archive_bench [-n 样本数] [-c 通道数] [-d 目录] [-s 种子] [-k]
+ *
+ * 合成数据按 100ms 遥测周期：IDLE/WARMUP/RUN 循环，温度、负压随机游走（0.1 精度，与日志的 %.1f 一致），
+ * 偶尔出现负压尖峰和少量 FAULT。文本日志与固件串口输出相同（[温度]、[压力]、[状态] 行），
+ * 每行前加主机 unix 毫秒。三个查询：
+ *   1. 通道0 负压 >= 45 mmHg 的连续段（整个疗程）
+ *   2. 中间 1 小时内通道0 温度的最小/最大/平均
+ *   3. 进入 FAULT 的时间点（少见）
+ * 每个查询分别用档案、LC_ALL=C grep | awk、进程内逐行解析日志完成，结果必须与逐样本计算的参考值相同，
+ * 不同则退出码为 1。档案查询同时打印读了多少块。
+ */
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "SessionArchive.h"
+#include "TelemetryCsv.h"
+
+static int gFailures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %s %s\n", ok ? "✓" : "✗", what);
+    if (!ok) {
+        gFailures++;
+    }
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static void usage() {
+    fprintf(stderr,
+            "用法: archive_bench [-n 样本数] [-c 通道数] [-d 目录] [-s 种子] [-k]\n"
+            "  -n  样本数（默认 1000000，100ms 周期约 28 小时）\n"
+            "  -c  通道数（默认 2）\n"
+            "  -d  工作目录（默认 /tmp/archive_bench，已有的档案和日志会被删除）\n"
+            "  -s  随机种子（默认 1）\n"
+            "  -k  结束后保留档案和日志\n");
+}
+
+static const int64_t START_MS = 1792281600000LL;   // 2026-10-18 00:00 UTC
+static const double PRESSURE_LIMIT = 45.0;
+static const int WINDOW_MS = 3600 * 1000;
+
+/**
+ * @brief 合成疗程：每次 next() 产生下一个 100ms 样本，模式变化时 modeChanged() 为真
+ */
+class Session {
+public:
+    Session(uint8_t channels, uint32_t seed) : rng(seed), channels(channels) {
+        rec = {};
+        rec.mode = 1;
+        rec.flags = TELEMETRY_FLAG_SELF_TEST_OK;
+        rec.heaterLimit = 255;
+        rec.pumpLimit = 100;
+        rec.channelCount = channels;
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            temp[ch] = 300;
+            pressure[ch] = 0;
+        }
+    }
+
+    int64_t next() {
+        unixMs += 100 + (int)(rng() % 7) - 3;
+        uptimeMs += 100;
+        prevMode = rec.mode;
+        step();
+        rec.uptimeMs = uptimeMs;
+        rec.boardTempCenti = (int16_t)((280 + (int)(rng() % 40)) * 10);
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            TelemetryChannel& c = rec.channels[ch];
+            c.padTempCenti = (int16_t)(temp[ch] * 10);
+            c.pressureCenti = (int16_t)(pressure[ch] * 10);
+            c.heaterDuty = rec.mode == 2 || rec.mode == 3 ? (uint8_t)(rng() % 256) : 0;
+            c.pumpPercent = rec.mode == 3 ? (uint8_t)(20 + rng() % 60) : 0;
+            c.flags = TELEMETRY_CH_TEMP_OK | TELEMETRY_CH_PRESSURE_OK;
+        }
+        return unixMs;
+    }
+
+    bool modeChanged() const { return rec.mode != prevMode; }
+    uint8_t previousMode() const { return prevMode; }
+    float targetTemp() const { return rec.mode == 2 || rec.mode == 3 ? 40.0f : 0.0f; }
+    float targetPressure() const { return rec.mode == 3 ? rec.gear * 4.0f : 0.0f; }
+
+    TelemetryRecord rec;
+
+private:
+    std::mt19937 rng;
+    uint8_t channels;
+    int64_t unixMs = START_MS;
+    uint32_t uptimeMs = 0;
+    uint8_t prevMode = 1;
+    uint32_t modeLeft = 1200;
+    int temp[TELEMETRY_MAX_CHANNELS];       // 0.1°C
+    int pressure[TELEMETRY_MAX_CHANNELS];   // 0.1 mmHg
+    uint32_t spikeLeft = 0;
+
+    // 向目标靠近 1/16，再加 -1..+1 的抖动
+    int walk(int v, int target) {
+        v += (target - v) / 16;
+        return v + (int)(rng() % 3) - 1;
+    }
+
+    void step() {
+        if (rec.mode != 6 && rec.mode != 5 && rng() % 400000 == 0) {
+            rec.mode = 6;                   // FAULT，20~60 秒
+            modeLeft = 200 + rng() % 400;
+        } else if (--modeLeft == 0) {
+            switch (rec.mode) {
+                case 1: rec.mode = 2; modeLeft = 1800; break;                   // WARMUP 3 分钟
+                case 2: rec.mode = 3; modeLeft = 15000; rec.gear = (uint8_t)(7 + rng() % 4); break;  // RUN 25 分钟
+                case 3: rec.mode = 5; modeLeft = 50; break;                     // VENTING 5 秒
+                default: rec.mode = 1; modeLeft = 1200; break;                  // IDLE 2 分钟
+            }
+        }
+        if (rec.mode == 3 && spikeLeft == 0 && rng() % 3000 == 0) {
+            spikeLeft = 20 + rng() % 80;
+        }
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            temp[ch] = walk(temp[ch], rec.mode == 2 || rec.mode == 3 ? 400 : 300);
+            int target = rec.mode == 3 ? rec.gear * 40 : 0;
+            if (spikeLeft > 0 && ch == 0) {
+                target += 120;
+            }
+            pressure[ch] = std::max(0, walk(pressure[ch], target));
+        }
+        if (spikeLeft > 0) {
+            spikeLeft--;
+        }
+    }
+};
+
+struct Runs {
+    uint64_t runs = 0;
+    uint64_t samples = 0;
+    bool operator==(const Runs& o) const { return runs == o.runs && samples == o.samples; }
+};
+
+struct Agg {
+    double min = INFINITY;
+    double max = -INFINITY;
+    double sum = 0;
+    uint64_t count = 0;
+    void add(double v) {
+        min = std::min(min, v);
+        max = std::max(max, v);
+        sum += v;
+        count++;
+    }
+    bool same(double mn, double mx, double mean, uint64_t n) const {
+        return n == count && fabs(mn - min) < 1e-3 && fabs(mx - max) < 1e-3 &&
+               (count == 0 || fabs(mean - sum / count) < 1e-6);
+    }
+};
+
+// 查询 1、2、3 的结果（参考值、档案、grep|awk、进程内解析各一份）
+struct Answers {
+    Runs spikes;
+    Agg window;
+    std::vector<int64_t> faults;
+};
+
+static bool sameAnswers(const Answers& a, const Answers& b) {
+    return a.spikes == b.spikes && b.window.same(a.window.min, a.window.max, a.window.sum / a.window.count,
+                                                 a.window.count) && a.faults == b.faults;
+}
+
+static bool sameRecord(const TelemetryRecord& a, const TelemetryRecord& b) {
+    if (a.uptimeMs != b.uptimeMs || a.mode != b.mode || a.gear != b.gear || a.flags != b.flags ||
+        a.boardTempCenti != b.boardTempCenti || a.heaterLimit != b.heaterLimit || a.pumpLimit != b.pumpLimit ||
+        a.channelCount != b.channelCount) {
+        return false;
+    }
+    for (uint8_t ch = 0; ch < a.channelCount; ch++) {
+        const TelemetryChannel& x = a.channels[ch];
+        const TelemetryChannel& y = b.channels[ch];
+        if (x.padTempCenti != y.padTempCenti || x.pressureCenti != y.pressureCenti || x.heaterDuty != y.heaterDuty ||
+            x.pumpPercent != y.pumpPercent || x.flags != y.flags) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::string runCommand(const std::string& cmd) {
+    std::string out;
+    FILE* p = popen(cmd.c_str(), "r");
+    if (p == nullptr) {
+        return out;
+    }
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), p)) > 0) {
+        out.append(buf, n);
+    }
+    pclose(p);
+    return out;
+}
+
+static uint64_t fileBytes(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? (uint64_t)st.st_size : 0;
+}
+
+int main(int argc, char** argv) {
+    uint64_t samples = 1000000;
+    int channels = 2;
+    std::string dir = "/tmp/archive_bench";
+    uint32_t seed = 1;
+    bool keep = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:c:d:s:kh")) != -1) {
+        switch (opt) {
+            case 'n': samples = strtoull(optarg, nullptr, 10); break;
+            case 'c': channels = std::min(std::max(atoi(optarg), 1), TELEMETRY_MAX_CHANNELS); break;
+            case 'd': dir = optarg; break;
+            case 's': seed = (uint32_t)strtoul(optarg, nullptr, 10); break;
+            case 'k': keep = true; break;
+            default: usage(); return 2;
+        }
+    }
+    if (samples < 2 * WINDOW_MS / 100) {
+        fprintf(stderr, "样本数至少 %d（查询 2 需要 1 小时窗口）\n", 2 * WINDOW_MS / 100);
+        return 2;
+    }
+    const std::string archiveDir = dir + "/session";
+    const std::string logPath = dir + "/session.log";
+    mkdir(dir.c_str(), 0755);
+    runCommand("rm -rf '" + archiveDir + "' '" + logPath + "'");
+
+    // 查询参数：窗口放在疗程中间
+    const int64_t windowFrom = START_MS + (int64_t)(samples / 2) * 100;
+    const int64_t windowTo = windowFrom + WINDOW_MS;
+
+    printf("生成 %llu 个样本、%d 通道，写档案和文本日志...\n", (unsigned long long)samples, channels);
+    Answers ref;
+    double archiveWriteS = 0, logWriteS = 0;
+    {
+        SessionArchiveWriter w;
+        std::string error;
+        if (!w.create(archiveDir, (uint8_t)channels, &error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        FILE* log = fopen(logPath.c_str(), "w");
+        if (log == nullptr) {
+            perror(logPath.c_str());
+            return 1;
+        }
+        Session s((uint8_t)channels, seed);
+        bool inSpike = false;
+        for (uint64_t i = 0; i < samples; i++) {
+            int64_t t = s.next();
+            const TelemetryRecord& rec = s.rec;
+
+            // 参考值直接由样本计算
+            double p0 = telemetryFromCenti(rec.channels[0].pressureCenti);
+            if (p0 >= PRESSURE_LIMIT) {
+                ref.spikes.samples++;
+                ref.spikes.runs += !inSpike;
+            }
+            inSpike = p0 >= PRESSURE_LIMIT;
+            if (t >= windowFrom && t < windowTo) {
+                ref.window.add(telemetryFromCenti(rec.channels[0].padTempCenti));
+            }
+            if (s.modeChanged() && rec.mode == 6) {
+                ref.faults.push_back(t);
+            }
+
+            auto t0 = std::chrono::steady_clock::now();
+            w.append(t, (uint8_t)i, rec);
+            archiveWriteS += secondsSince(t0);
+
+            t0 = std::chrono::steady_clock::now();
+            if (s.modeChanged()) {
+                fprintf(log, "%lld [状态] %s -> %s (%s) @%lu ms\n", (long long)t, telemetryModeName(s.previousMode()),
+                        telemetryModeName(rec.mode), rec.mode == 6 ? "FAULT_DETECTED" : "TIMER",
+                        (unsigned long)rec.uptimeMs);
+            }
+            for (uint8_t ch = 0; ch < rec.channelCount; ch++) {
+                const TelemetryChannel& c = rec.channels[ch];
+                fprintf(log, "%lld [温度] 通道%u 当前: %.1f°C, 目标: %.1f°C, 功率: %.0f%%\n", (long long)t, ch,
+                        telemetryFromCenti(c.padTempCenti), s.targetTemp(), c.heaterDuty * 100.0 / 255.0);
+                fprintf(log, "%lld [压力] 通道%u 当前: %.1f mmHg, 目标: %.1f mmHg, 档位: %d\n", (long long)t, ch,
+                        telemetryFromCenti(c.pressureCenti), s.targetPressure(), rec.gear);
+            }
+            logWriteS += secondsSince(t0);
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        bool ok = w.close() && fclose(log) == 0;
+        archiveWriteS += secondsSince(t0);
+        if (!ok) {
+            fprintf(stderr, "写入失败\n");
+            return 1;
+        }
+    }
+
+    SessionArchive a;
+    std::string error;
+    if (!a.open(archiveDir, &error)) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    const uint64_t logBytes = fileBytes(logPath);
+    printf("档案 %.1f MB（%llu 块，写入 %.2f s），文本日志 %.1f MB（写入 %.2f s），%.1f 倍\n", a.bytes() / 1048576.0,
+           (unsigned long long)a.blockCount(), archiveWriteS, logBytes / 1048576.0, logWriteS,
+           (double)logBytes / a.bytes());
+    printf("参考：负压 >= %.0f mmHg %llu 段 %llu 样本；1 小时窗口温度 %.1f/%.1f/%.3f（%llu 样本）；FAULT %zu 次\n\n",
+           PRESSURE_LIMIT, (unsigned long long)ref.spikes.runs, (unsigned long long)ref.spikes.samples,
+           ref.window.min, ref.window.max, ref.window.sum / ref.window.count, (unsigned long long)ref.window.count,
+           ref.faults.size());
+
+    const int pressure0 = a.columnIndex("pressure0_mmhg");
+    const int temp0 = a.columnIndex("temp0_c");
+    const int mode = a.columnIndex("mode");
+    check(pressure0 >= 0 && temp0 >= 0 && mode >= 0, "档案列名");
+    if (gFailures > 0) {
+        return 1;
+    }
+
+    // 档案
+    Answers arch;
+    double archS[3];
+    SessionArchive::QueryStats qs[3] = {};
+    auto t0 = std::chrono::steady_clock::now();
+    arch.spikes.samples = a.findRuns((size_t)pressure0, PRESSURE_LIMIT, 1e9, a.firstMs(), a.lastMs() + 1,
+                                     [&](uint64_t, uint64_t) { arch.spikes.runs++; }, &qs[0]);
+    archS[0] = secondsSince(t0);
+    t0 = std::chrono::steady_clock::now();
+    SessionArchive::Range r = a.aggregate((size_t)temp0, windowFrom, windowTo, &qs[1]);
+    archS[1] = secondsSince(t0);
+    arch.window.min = r.min;
+    arch.window.max = r.max;
+    arch.window.sum = r.mean * r.count;
+    arch.window.count = r.count;
+    t0 = std::chrono::steady_clock::now();
+    a.findRuns((size_t)mode, 6, 6, a.firstMs(), a.lastMs() + 1,
+               [&](uint64_t first, uint64_t) { arch.faults.push_back(a.timeAt(first)); }, &qs[2]);
+    archS[2] = secondsSince(t0);
+
+    // grep | awk：先用 grep 按标签过滤，awk 解析数值
+    Answers text;
+    double grepS[3];
+    char cmd[1024];
+    t0 = std::chrono::steady_clock::now();
+    snprintf(cmd, sizeof(cmd),
+             "LC_ALL=C grep -F '[压力] 通道0 ' '%s' | LC_ALL=C awk '{v=$5+0; if (v>=%g) {n++; if (!r) runs++; r=1} "
+             "else r=0} END {printf \"%%d %%d\\n\", runs, n}'",
+             logPath.c_str(), PRESSURE_LIMIT);
+    std::string out = runCommand(cmd);
+    grepS[0] = secondsSince(t0);
+    unsigned long long runsOut = 0, samplesOut = 0;
+    sscanf(out.c_str(), "%llu %llu", &runsOut, &samplesOut);
+    text.spikes.runs = runsOut;
+    text.spikes.samples = samplesOut;
+
+    t0 = std::chrono::steady_clock::now();
+    snprintf(cmd, sizeof(cmd),
+             "LC_ALL=C grep -F '[温度] 通道0 ' '%s' | LC_ALL=C awk '$1>=%lld && $1<%lld {v=$5+0; if (!n || v<mn) mn=v; "
+             "if (!n || v>mx) mx=v; s+=v; n++} END {printf \"%%.2f %%.2f %%.9f %%d\\n\", mn, mx, s, n}'",
+             logPath.c_str(), (long long)windowFrom, (long long)windowTo);
+    out = runCommand(cmd);
+    grepS[1] = secondsSince(t0);
+    unsigned long long countOut = 0;
+    sscanf(out.c_str(), "%lf %lf %lf %llu", &text.window.min, &text.window.max, &text.window.sum, &countOut);
+    text.window.count = countOut;
+
+    t0 = std::chrono::steady_clock::now();
+    snprintf(cmd, sizeof(cmd), "LC_ALL=C grep -F '[状态]' '%s' | LC_ALL=C awk '$5==\"FAULT\" {print $1}'",
+             logPath.c_str());
+    out = runCommand(cmd);
+    grepS[2] = secondsSince(t0);
+    for (const char* p = out.c_str(); *p != '\0';) {
+        char* end;
+        long long v = strtoll(p, &end, 10);
+        if (end == p) {
+            break;
+        }
+        text.faults.push_back(v);
+        p = end + (*end == '\n');
+    }
+
+    // 进程内逐行解析（mmap 整个日志），每个查询扫一遍
+    Answers scan;
+    double scanS[3];
+    int fd = open(logPath.c_str(), O_RDONLY);
+    const char* base = (const char*)mmap(nullptr, logBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror(logPath.c_str());
+        return 1;
+    }
+    const char* const limit = base + logBytes;
+    auto forEachLine = [&](const char* tag, size_t tagLen, const std::function<void(int64_t, const char*)>& fn) {
+        for (const char* p = base; p < limit;) {
+            const char* eol = (const char*)memchr(p, '\n', limit - p);
+            if (eol == nullptr) {
+                eol = limit;
+            }
+            char* rest;
+            int64_t t = strtoll(p, &rest, 10);
+            if (rest + 1 + tagLen <= eol && memcmp(rest + 1, tag, tagLen) == 0) {
+                fn(t, rest + 1 + tagLen);
+            }
+            p = eol + 1;
+        }
+    };
+    static const char kPressure[] = "[压力] 通道0 当前: ";
+    static const char kTemp[] = "[温度] 通道0 当前: ";
+    static const char kState[] = "[状态] ";
+    t0 = std::chrono::steady_clock::now();
+    bool inRun = false;
+    forEachLine(kPressure, sizeof(kPressure) - 1, [&](int64_t, const char* v) {
+        bool hit = strtod(v, nullptr) >= PRESSURE_LIMIT;
+        scan.spikes.samples += hit;
+        scan.spikes.runs += hit && !inRun;
+        inRun = hit;
+    });
+    scanS[0] = secondsSince(t0);
+    t0 = std::chrono::steady_clock::now();
+    forEachLine(kTemp, sizeof(kTemp) - 1, [&](int64_t t, const char* v) {
+        if (t >= windowFrom && t < windowTo) {
+            scan.window.add(strtod(v, nullptr));
+        }
+    });
+    scanS[1] = secondsSince(t0);
+    t0 = std::chrono::steady_clock::now();
+    forEachLine(kState, sizeof(kState) - 1, [&](int64_t t, const char* v) {
+        const char* arrow = strstr(v, " -> ");
+        if (arrow != nullptr && strncmp(arrow + 4, "FAULT ", 6) == 0) {
+            scan.faults.push_back(t);
+        }
+    });
+    scanS[2] = secondsSince(t0);
+    munmap((void*)base, logBytes);
+
+    static const char* kQueries[] = {"负压 >= 45 mmHg 的连续段", "1 小时窗口温度统计", "FAULT 时间点"};
+    printf("%-28s %12s %12s %12s %8s   %s\n", "查询", "档案 ms", "grep|awk ms", "逐行解析 ms", "倍数",
+           "档案读取（摘要/扫描/跳过 块）");
+    for (int q = 0; q < 3; q++) {
+        printf("%-28s %12.3f %12.1f %12.1f %8.0f   %u/%u/%u\n", kQueries[q], archS[q] * 1e3, grepS[q] * 1e3,
+               scanS[q] * 1e3, std::min(grepS[q], scanS[q]) / std::max(archS[q], 1e-9), qs[q].summarized,
+               qs[q].scanned, qs[q].skipped);
+    }
+    printf("\n");
+    check(sameAnswers(ref, arch), "档案查询结果与参考值相同");
+    check(sameAnswers(ref, text), "grep|awk 结果与参考值相同");
+    check(sameAnswers(ref, scan), "逐行解析结果与参考值相同");
+
+    // 导出的 CSV 逐行解析回来应与写入的样本相同（抽查开头、窗口起点和结尾）
+    bool roundTrip = true;
+    Session s((uint8_t)channels, seed);
+    const uint64_t probe[] = {0, a.lowerBound(windowFrom), a.size() - 1};
+    uint64_t i = 0;
+    for (uint64_t p : probe) {
+        int64_t t = 0;
+        while (i <= p) {
+            t = s.next();
+            i++;
+        }
+        int64_t unixMs;
+        uint8_t seq;
+        TelemetryRecord rec;
+        a.record(p, unixMs, seq, rec);
+        char line[512];
+        FILE* m = fmemopen(line, sizeof(line), "w");
+        telemetryCsvRow(m, unixMs, seq, rec);
+        fclose(m);
+        TelemetryRecord back;
+        roundTrip = roundTrip && telemetryCsvParse(line, unixMs, seq, back) && unixMs == t &&
+                    seq == (uint8_t)p && sameRecord(back, s.rec) && sameRecord(rec, s.rec);
+    }
+    check(roundTrip, "档案样本经 CSV 往返后与写入的相同");
+
+    if (!keep) {
+        a.close();
+        runCommand("rm -rf '" + archiveDir + "' '" + logPath + "'");
+    }
+    return gFailures > 0 ? 1 : 0;
+}
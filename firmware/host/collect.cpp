@@ -0,0 +1,131 @@
+/**
+ * @file collect.cpp
+ * @brief 多设备遥测采集：同时接收多台设备，定期打印汇总，可按设备写 CSV 和文本日志
+ *
+ *   collect /dev/ttyACM0 /dev/ttyACM1 ...
+ *   collect -p 50 -o logs /dev/ttyACM0 /dev/ttyACM1 /dev/ttyACM2
+ *   collect -a sessions /dev/ttyACM0          # 同时写可查询的档案，见 archive.cpp
+ *
+ * 设备拔出或重启后自动重新连接并重新打开遥测，Ctrl+C 结束时刷新输出文件。
+ */
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+#include "Collector.h"
+
+static volatile sig_atomic_t gStop = 0;
+
+static void onSignal(int) {
+    gStop = 1;
+}
+
+static void usage() {
+    fprintf(stderr,
+            "用法: collect [选项] 串口...\n"
+            "  -p 毫秒   连接后设置的遥测周期（默认 100，0 = 不设置）\n"
+            "  -o 目录   每台设备写 名称.csv（遥测）和 名称.log（文本日志）\n"
+            "  -a 目录   每台设备写档案 名称-日期-时间/（用 archive 查询）\n"
+            "  -n 样本   每台设备在内存中保留的样本数（默认 3000）\n"
+            "  -i 秒     汇总打印间隔（默认 2，0 = 不打印）\n"
+            "  -t 秒     运行时长（默认直到 Ctrl+C）\n");
+}
+
+static void printSummary(const Collector& c, int64_t sinceUs, double seconds, std::vector<uint64_t>& lastCounts) {
+    printf("%-16s %-7s %-7s %16s %16s %7s %6s %5s %4s\n", "设备", "连接", "模式", "温度°C 均/高",
+           "负压mmHg 均/高", "帧/s", "丢帧", "CRC", "重连");
+    for (size_t i = 0; i < c.deviceCount(); i++) {
+        const Collector::Device& d = c.device(i);
+        const Collector::DeviceStats& s = d.stats;
+        TelemetrySeries::Range t = d.series.padTempRange(0, sinceUs);
+        TelemetrySeries::Range p = d.series.pressureRange(0, sinceUs);
+        const char* mode = d.hasLast ? telemetryModeName(d.last.mode) : "-";
+        printf("%-16s %-7s %-7s %7.1f/%7.1f %7.1f/%7.1f %7.1f %6llu %5u %4u\n", d.name.c_str(),
+               d.connected() ? "是" : "否", mode, t.mean, t.max, p.mean, p.max,
+               (s.telemetry - lastCounts[i]) / seconds, (unsigned long long)s.lost, d.ring.counters().crcErrors,
+               s.reconnects);
+        lastCounts[i] = s.telemetry;
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    CollectorOptions o;
+    int intervalS = 2;
+    int durationS = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "p:o:a:n:i:t:h")) != -1) {
+        switch (opt) {
+            case 'p': o.telemetryMs = atoi(optarg); break;
+            case 'o': o.outputDir = optarg; break;
+            case 'a': o.archiveDir = optarg; break;
+            case 'n': o.historySamples = (size_t)std::max(1, atoi(optarg)); break;
+            case 'i': intervalS = atoi(optarg); break;
+            case 't': durationS = atoi(optarg); break;
+            default: usage(); return 2;
+        }
+    }
+    if (optind >= argc) {
+        usage();
+        return 2;
+    }
+    for (const std::string& dir : {o.outputDir, o.archiveDir}) {
+        if (!dir.empty() && mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+            perror(dir.c_str());
+            return 1;
+        }
+    }
+
+    Collector c(o);
+    if (!c.valid()) {
+        perror("epoll_create1");
+        return 1;
+    }
+    for (int i = optind; i < argc; i++) {
+        c.add(argv[i]);
+        if (!c.device(c.deviceCount() - 1).ring.valid()) {
+            fprintf(stderr, "接收缓冲映射失败\n");
+            return 1;
+        }
+    }
+    size_t ringBytes = c.device(0).ring.capacity();
+    printf("%zu 台设备，每台内存 %zu KB（接收缓冲 %zu KB + %zu 个样本）\n", c.deviceCount(),
+           (ringBytes + c.device(0).series.memoryBytes()) / 1024, ringBytes / 1024, o.historySamples);
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    const int64_t start = Collector::nowUs();
+    int64_t lastPrint = start;
+    std::vector<uint64_t> lastCounts(c.deviceCount(), 0);
+    while (!gStop) {
+        c.poll(100);
+        int64_t now = Collector::nowUs();
+        if (intervalS > 0 && now - lastPrint >= intervalS * 1000000LL) {
+            printSummary(c, lastPrint, (now - lastPrint) / 1e6, lastCounts);
+            lastPrint = now;
+        }
+        if (durationS > 0 && now - start >= durationS * 1000000LL) {
+            break;
+        }
+    }
+    c.flush();
+
+    uint64_t frames = 0, lost = 0, bytes = 0;
+    unsigned reconnects = 0;
+    for (size_t i = 0; i < c.deviceCount(); i++) {
+        frames += c.device(i).stats.telemetry;
+        lost += c.device(i).stats.lost;
+        bytes += c.device(i).ring.counters().bytes;
+        reconnects += c.device(i).stats.reconnects;
+    }
+    double s = (Collector::nowUs() - start) / 1e6;
+    printf("共 %llu 帧遥测（%.0f 帧/s），丢帧 %llu，重连 %u 次，%.1f KB/s\n", (unsigned long long)frames, frames / s,
+           (unsigned long long)lost, reconnects, bytes / 1024.0 / s);
+    return 0;
+}
@@ -0,0 +1,440 @@
+/**
+ * @file fwupdate.cpp
+ * @brief 固件升级工具：生成差分、经串口发送（断点续传）、查询结果（协议见 FirmwareUpdate.h）
+ *
+ *   fwupdate diff old.bin new.bin -o update.gdlt      # 差分大小与压缩比
+ *   fwupdate -b old.bin send /dev/ttyACM0 new.bin      # 差分升级（old.bin 须是设备正在运行的镜像）
+ *   fwupdate send /dev/ttyACM0 new.bin                 # 完整镜像
+ *   fwupdate status /dev/ttyACM0
+ *   fwupdate abort /dev/ttyACM0                        # 放弃进行中的升级并删除断点
+ *
+ * 发送时流水线：最多 -w 个 UPDATE_DATA 在途，设备按偏移去重，应答偏移小于已发送位置
+ * （设备写完一个扇区、没用完本帧，或前面有请求丢失）时从应答的偏移重发。
+ * 中断后再次运行 send，设备从最近的断点继续。完成后等设备重启，重新打开串口查询试运行结果。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DeltaEncoder.h"
+#include "LinkClient.h"
+
+namespace {
+
+struct Options {
+    const char* base = nullptr;         // -b 旧镜像
+    const char* output = nullptr;       // -o 差分输出
+    int window = 4;                     // -w 在途请求数
+    uint32_t stopAfter = 0;             // -s 发送这么多字节后停止（演示续传）
+    bool showText = false;              // -x
+};
+
+struct DeviceStatus {
+    UpdateState state;
+    UpdateResult result;
+    uint8_t slot;
+    uint8_t trialBoots;
+    uint32_t inputPos;
+    uint32_t deltaSize;
+    uint32_t outputPos;
+    uint32_t targetSize;
+};
+
+const char* kStateNames[] = {"IDLE", "VERIFYING_SOURCE", "RECEIVING", "REBOOTING", "TRIAL"};
+const char* kResultNames[] = {"NONE", "COMMITTED", "ROLLBACK_SELF_TEST", "ROLLBACK_BOOTS", "BOOT_FAILED",
+                              "VERIFY_FAILED"};
+
+const char* stateName(uint8_t s) { return s < 5 ? kStateNames[s] : "?"; }
+const char* resultName(uint8_t r) { return r < 6 ? kResultNames[r] : "?"; }
+
+double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void usage() {
+    fprintf(stderr,
+            "用法: fwupdate [选项] 命令 ...\n"
+            "  diff 旧镜像 新镜像           生成差分并在内存中验证（-o 保存）\n"
+            "  send 串口 新镜像             升级（-b 旧镜像 发差分，否则发完整镜像）\n"
+            "  status 串口                  升级状态与上次结果\n"
+            "  abort 串口                   放弃进行中的升级（删除断点）\n"
+            "  -b 文件   旧镜像（设备正在运行的）\n"
+            "  -o 文件   差分输出\n"
+            "  -w 数量   在途请求数（默认 4）\n"
+            "  -s 字节   发送这么多差分字节后停止，再次 send 从断点继续\n"
+            "  -x        打印设备的文本日志\n");
+}
+
+bool readFile(const char* path, std::vector<uint8_t>& out) {
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) {
+        perror(path);
+        return false;
+    }
+    out.clear();
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        out.insert(out.end(), buf, buf + n);
+    }
+    fclose(f);
+    return true;
+}
+
+bool makeDelta(const Options& o, const std::vector<uint8_t>& target, std::vector<uint8_t>& delta) {
+    std::vector<uint8_t> source;
+    if (o.base != nullptr && !readFile(o.base, source)) {
+        return false;
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    DeltaEncodeStats st;
+    delta = deltaEncode(source, target, &st);
+    double encodeS = secondsSince(t0);
+    bool ok = deltaVerify(source, target, delta);
+    printf("%s: %zu -> %zu 字节 (%.1f%%)，COPY %u 个 %llu 字节，LITERAL %u 个 %llu 字节，生成 %.2f s，验证%s\n",
+           o.base ? "差分" : "完整镜像", target.size(), delta.size(), 100.0 * delta.size() / std::max<size_t>(1, target.size()),
+           st.copies, (unsigned long long)st.copyBytes, st.literals, (unsigned long long)st.literalBytes,
+           encodeS, ok ? "通过" : "失败");
+    return ok;
+}
+
+int fail(LinkClient& client, LinkClient::Result r, const char* what) {
+    if (r == LinkClient::LINK_STATUS) {
+        fprintf(stderr, "%s: %s\n", what, LinkClient::statusName(client.status()));
+    } else {
+        fprintf(stderr, "%s: %s\n", what, LinkClient::resultName(r));
+    }
+    return 1;
+}
+
+LinkClient::Result queryStatus(LinkClient& client, DeviceStatus& s) {
+    const uint8_t req[] = {RPC_OP_UPDATE_STATUS};
+    std::vector<uint8_t> resp;
+    LinkClient::Result r = client.call(req, sizeof(req), resp);
+    if (r != LinkClient::LINK_OK) {
+        return r;
+    }
+    if (resp.size() != 20) {
+        return LinkClient::LINK_MALFORMED;
+    }
+    s.state = (UpdateState)resp[0];
+    s.result = (UpdateResult)resp[1];
+    s.slot = resp[2];
+    s.trialBoots = resp[3];
+    s.inputPos = linkGet32(&resp[4]);
+    s.deltaSize = linkGet32(&resp[8]);
+    s.outputPos = linkGet32(&resp[12]);
+    s.targetSize = linkGet32(&resp[16]);
+    return LinkClient::LINK_OK;
+}
+
+void printStatus(const DeviceStatus& s) {
+    printf("状态 %s，上次结果 %s，运行 app%u", stateName(s.state), resultName(s.result), s.slot);
+    if (s.state == UPDATE_STATE_RECEIVING) {
+        printf("，差分 %u/%u，输出 %u/%u", s.inputPos, s.deltaSize, s.outputPos, s.targetSize);
+    } else if (s.state == UPDATE_STATE_VERIFYING_SOURCE) {
+        printf("，已校验 %u 字节", s.inputPos);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief UPDATE_BEGIN：设备校验运行中的镜像期间（BUSY）重发
+ * @param start 设备期望的差分偏移（续传时大于0）
+ */
+LinkClient::Result beginSession(LinkClient& client, const std::vector<uint8_t>& delta, uint32_t& start) {
+    std::vector<uint8_t> req(1 + DELTA_HEADER_LEN);
+    req[0] = RPC_OP_UPDATE_BEGIN;
+    memcpy(&req[1], delta.data(), DELTA_HEADER_LEN);
+    bool hashing = false;
+    for (;;) {
+        std::vector<uint8_t> resp;
+        LinkClient::Result r = client.call(req.data(), req.size(), resp);
+        if (r == LinkClient::LINK_STATUS && client.status() == RPC_ERR_BUSY && resp.size() == 4) {
+            printf("\r校验设备上的旧镜像: %u 字节", linkGet32(resp.data()));
+            fflush(stdout);
+            hashing = true;
+            continue;
+        }
+        if (hashing) {
+            printf("\n");
+        }
+        if (r == LinkClient::LINK_OK && resp.size() != 4) {
+            return LinkClient::LINK_MALFORMED;
+        }
+        if (r == LinkClient::LINK_OK) {
+            start = linkGet32(resp.data());
+        }
+        return r;
+    }
+}
+
+int sendUpdate(const std::string& path, const std::vector<uint8_t>& delta, const Options& o) {
+    DeltaHeader h;
+    deltaHeaderDecode(delta.data(), DELTA_HEADER_LEN, h);
+    const uint8_t* ops = delta.data() + DELTA_HEADER_LEN;
+
+    SerialPort port;
+    if (!port.open(path)) {
+        fprintf(stderr, "%s\n", port.error().c_str());
+        return 1;
+    }
+    LinkClient client(port);
+    client.setTimeout(500, 5);
+    if (o.showText) {
+        client.onText([](const std::string& line) { printf("[设备] %s\n", line.c_str()); });
+    }
+
+    DeviceStatus before;
+    LinkClient::Result r = queryStatus(client, before);
+    if (r != LinkClient::LINK_OK) {
+        return fail(client, r, "查询升级状态");
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    uint32_t start = 0;
+    if ((r = beginSession(client, delta, start)) != LinkClient::LINK_OK) {
+        if (r == LinkClient::LINK_STATUS && client.status() == RPC_ERR_REJECTED) {
+            fprintf(stderr, "设备不在待机状态，先结束疗程（linkctl %s cmd stop）\n", path.c_str());
+            return 1;
+        }
+        return fail(client, r, "开始升级");
+    }
+    printf("开始升级（%.1f s）：运行 app%u，差分 %u 字节%s\n", secondsSince(t0), before.slot, h.deltaSize,
+           start > 0 ? "，从断点继续" : "");
+    if (start > 0) {
+        printf("断点: %u 字节\n", start);
+    }
+
+    // 流水线发送
+    struct Posted {
+        uint32_t offset;
+        uint32_t len;
+        uint32_t gen;       // 回退（从设备的偏移重发）一次加1，之前发出的请求的应答不再触发回退
+    };
+    Posted posted[256] = {};
+    uint32_t gen = 0;
+    uint32_t next = start;          // 下一个要发送的偏移
+    uint32_t acked = start;         // 设备已处理到的偏移
+    uint32_t outputPos = 0;
+    uint32_t resent = 0, rewinds = 0, resumes = 0;
+    int timeouts = 0;
+    unsigned lastPercent = 101;
+    const auto tData = std::chrono::steady_clock::now();
+
+    while (acked < h.deltaSize || outputPos < h.targetSize) {
+        if (o.stopAfter > 0 && acked >= o.stopAfter) {
+            printf("\n已发送 %u 字节，按 -s 停止（再次 send 从断点继续）\n", acked);
+            return 0;
+        }
+        while (client.postedCount() < (size_t)o.window) {
+            uint32_t n = std::min<uint32_t>(UPDATE_CHUNK_MAX, h.deltaSize - next);
+            // 差分已发完而输出未满（末尾的长 COPY）：没有在途请求时发空数据推进
+            if (n == 0 && client.postedCount() > 0) {
+                break;
+            }
+            uint8_t req[1 + 4 + UPDATE_CHUNK_MAX];
+            req[0] = RPC_OP_UPDATE_DATA;
+            linkPut32(req + 1, next);
+            memcpy(req + 5, ops + next, n);
+            uint8_t seq;
+            if (!client.post(req, 5 + n, seq)) {
+                fprintf(stderr, "\n设备已断开\n");
+                return 1;
+            }
+            posted[seq] = {next, n, gen};
+            next += n;
+            if (n == 0) {
+                break;
+            }
+        }
+
+        uint8_t seq;
+        RpcStatus st;
+        std::vector<uint8_t> resp;
+        r = client.collect(seq, resp, st, 1000);
+        if (r == LinkClient::LINK_TIMEOUT) {
+            if (++timeouts > 5) {
+                return fail(client, r, "\n发送升级数据");
+            }
+            client.cancelPosted();
+            gen++;
+            next = acked;
+            continue;
+        }
+        if (r != LinkClient::LINK_OK) {
+            return fail(client, r, "\n发送升级数据");
+        }
+        timeouts = 0;
+
+        if (st == RPC_ERR_FLASH || st == RPC_ERR_NO_SESSION) {
+            // 闪存写入失败（设备放弃了会话）或设备重启过：重新 BEGIN，从断点继续
+            if (++resumes > 3) {
+                fprintf(stderr, "\n%s\n", LinkClient::statusName(st));
+                return 1;
+            }
+            client.cancelPosted();
+            gen++;
+            if ((r = beginSession(client, delta, start)) != LinkClient::LINK_OK) {
+                return fail(client, r, "\n继续升级");
+            }
+            printf("\n%s，从断点 %u 继续\n", LinkClient::statusName(st), start);
+            next = acked = start;
+            continue;
+        }
+        if ((st != RPC_OK && st != RPC_ERR_BAD_OFFSET) || resp.size() != 8) {
+            fprintf(stderr, "\n发送升级数据: %s\n", LinkClient::statusName(st));
+            return 1;
+        }
+        const Posted& p = posted[seq];
+        acked = linkGet32(&resp[0]);
+        outputPos = linkGet32(&resp[4]);
+        if (p.gen == gen && acked < p.offset + p.len) {
+            // 设备本帧写了一个扇区没用完输入（OK），或前面的请求丢了（BAD_OFFSET）
+            gen++;
+            rewinds++;
+            resent += next - acked;
+            next = acked;
+        }
+
+        unsigned percent = (unsigned)(100.0 * outputPos / h.targetSize);
+        if (percent / 5 != lastPercent / 5) {
+            lastPercent = percent;
+            double s = secondsSince(tData);
+            printf("\r%3u%%  差分 %u/%u  输出 %u/%u  %.1f KB/s", percent, acked, h.deltaSize, outputPos,
+                   h.targetSize, s > 0 ? outputPos / 1024.0 / s : 0.0);
+            fflush(stdout);
+        }
+    }
+    double dataS = secondsSince(tData);
+
+    const uint8_t finishReq[] = {RPC_OP_UPDATE_FINISH};
+    std::vector<uint8_t> resp;
+    if ((r = client.call(finishReq, sizeof(finishReq), resp)) != LinkClient::LINK_OK) {
+        if (r == LinkClient::LINK_STATUS && client.status() == RPC_ERR_MISMATCH) {
+            fprintf(stderr, "\n新镜像校验不符（设备上的旧镜像与 -b 不同？）\n");
+            return 1;
+        }
+        return fail(client, r, "\n完成升级");
+    }
+    printf("\n发送完成: 差分 %u 字节 %.2f s（%.1f KB/s，新镜像 %.1f KB/s），重发 %u 字节，回退 %u 次，续传 %u 次\n",
+           h.deltaSize - start, dataS, (h.deltaSize - start) / 1024.0 / dataS, h.targetSize / 1024.0 / dataS,
+           resent, rewinds, resumes);
+    printf("校验通过，设备重启到新固件...\n");
+
+    // 等设备断开（重启），再重新打开串口查询试运行结果
+    auto tReboot = std::chrono::steady_clock::now();
+    while (secondsSince(tReboot) < 5.0 && client.poll(100)) {
+    }
+    port.close();
+    DeviceStatus after;
+    bool connected = false;
+    while (secondsSince(tReboot) < 60.0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        if (!port.open(path)) {
+            continue;
+        }
+        LinkClient probe(port);
+        probe.setTimeout(500, 2);
+        if (o.showText) {
+            probe.onText([](const std::string& line) { printf("[设备] %s\n", line.c_str()); });
+        }
+        r = queryStatus(probe, after);
+        if (r == LinkClient::LINK_OK && after.state != UPDATE_STATE_REBOOTING && after.state != UPDATE_STATE_TRIAL) {
+            connected = true;
+            break;
+        }
+        port.close();       // 设备还在启动（自检）或又重启了（回滚）
+    }
+    if (!connected) {
+        fprintf(stderr, "设备重启后 60 s 内没有应答\n");
+        return 1;
+    }
+    printf("重启后 %.1f s 应答: ", secondsSince(tReboot));
+    printStatus(after);
+    bool committed = after.result == UPDATE_RESULT_COMMITTED && after.slot != before.slot;
+    printf("%s\n", committed ? "✓ 升级完成" : "✗ 升级没有生效");
+    return committed ? 0 : 1;
+}
+
+int withDevice(const std::string& path, const Options& o, const std::string& cmd) {
+    SerialPort port;
+    if (!port.open(path)) {
+        fprintf(stderr, "%s\n", port.error().c_str());
+        return 1;
+    }
+    LinkClient client(port);
+    if (o.showText) {
+        client.onText([](const std::string& line) { printf("[设备] %s\n", line.c_str()); });
+    }
+    LinkClient::Result r;
+    if (cmd == "abort") {
+        const uint8_t req[] = {RPC_OP_UPDATE_ABORT};
+        std::vector<uint8_t> resp;
+        if ((r = client.call(req, sizeof(req), resp)) != LinkClient::LINK_OK) {
+            return fail(client, r, "放弃升级");
+        }
+    }
+    DeviceStatus s;
+    if ((r = queryStatus(client, s)) != LinkClient::LINK_OK) {
+        return fail(client, r, "查询升级状态");
+    }
+    printStatus(s);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options o;
+    int opt;
+    while ((opt = getopt(argc, argv, "b:o:w:s:xh")) != -1) {
+        switch (opt) {
+            case 'b': o.base = optarg; break;
+            case 'o': o.output = optarg; break;
+            case 'w': o.window = std::max(1, std::min(64, atoi(optarg))); break;
+            case 's': o.stopAfter = (uint32_t)strtoul(optarg, nullptr, 0); break;
+            case 'x': o.showText = true; break;
+            default: usage(); return 2;
+        }
+    }
+    if (argc - optind < 2) {
+        usage();
+        return 2;
+    }
+    const std::string cmd = argv[optind];
+
+    if (cmd == "diff" && argc - optind == 3) {
+        o.base = argv[optind + 1];
+        std::vector<uint8_t> target, delta;
+        if (!readFile(argv[optind + 2], target) || !makeDelta(o, target, delta)) {
+            return 1;
+        }
+        if (o.output != nullptr) {
+            FILE* f = fopen(o.output, "wb");
+            if (f == nullptr || fwrite(delta.data(), 1, delta.size(), f) != delta.size()) {
+                perror(o.output);
+                return 1;
+            }
+            fclose(f);
+        }
+        return 0;
+    }
+    if (cmd == "send" && argc - optind == 3) {
+        std::vector<uint8_t> target, delta;
+        if (!readFile(argv[optind + 2], target) || !makeDelta(o, target, delta)) {
+            return 1;
+        }
+        return sendUpdate(argv[optind + 1], delta, o);
+    }
+    if ((cmd == "status" || cmd == "abort") && argc - optind == 2) {
+        return withDevice(argv[optind + 1], o, cmd);
+    }
+    usage();
+    return 2;
+}
@@ -0,0 +1,255 @@
+/**
+ * @file kpi.cpp
+ * @brief 批量计算疗程档案的质量指标，打印汇总表，可写出每个疗程一行的 CSV
+ *
+ *   kpi sessions/                          # 目录下的所有档案，线程数 = CPU 核数
+ *   kpi -j 8 -o kpi.csv sessions/ old/a0   # 档案目录和包含档案的目录可以混用
+ *   kpi -v -T 42 -b 0.5 sessions/          # 目标 42°C、带宽 ±0.5°C，列出每个疗程
+ *
+ * 指标的定义见 SessionKpi.h。
+ */
+
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "SessionKpi.h"
+#include "SignalKernels.h"
+
+namespace {
+
+const size_t WORST_SESSIONS = 5;
+
+void usage() {
+    fprintf(stderr,
+            "用法: kpi [选项] 档案或目录...\n"
+            "  -j 线程   线程数（默认 CPU 核数）\n"
+            "  -T 度     目标温度（默认 %.0f）\n"
+            "  -b 度     温度带宽 ±（默认 1.0）\n"
+            "  -B mmHg   负压带宽 ±（默认 1.0）\n"
+            "  -o 文件   每个疗程一行写 CSV\n"
+            "  -v        打印每个疗程\n"
+            "  -s        只用标量实现（对照）\n"
+            "目录中有 index 文件即为档案，否则取其下一级中的所有档案。\n",
+            KPI_TEMP_TARGET);
+}
+
+bool isArchive(const std::string& dir) {
+    struct stat st;
+    return stat((dir + "/index").c_str(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+bool collect(const std::string& path, std::vector<std::string>& dirs) {
+    if (isArchive(path)) {
+        dirs.push_back(path);
+        return true;
+    }
+    DIR* d = opendir(path.c_str());
+    if (d == nullptr) {
+        perror(path.c_str());
+        return false;
+    }
+    std::vector<std::string> found;
+    while (dirent* e = readdir(d)) {
+        if (e->d_name[0] != '.' && isArchive(path + "/" + e->d_name)) {
+            found.push_back(path + "/" + e->d_name);
+        }
+    }
+    closedir(d);
+    std::sort(found.begin(), found.end());
+    dirs.insert(dirs.end(), found.begin(), found.end());
+    return true;
+}
+
+std::string baseName(const std::string& dir) {
+    size_t end = dir.find_last_not_of('/');
+    size_t slash = dir.find_last_of('/', end);
+    return dir.substr(slash == std::string::npos ? 0 : slash + 1, end - (slash == std::string::npos ? 0 : slash + 1) + 1);
+}
+
+/**
+ * @brief 一列指标在各疗程上的分布（跳过 NAN）
+ */
+struct Distribution {
+    std::vector<double> v;
+
+    void add(double x) {
+        if (!isnan(x)) {
+            v.push_back(x);
+        }
+    }
+
+    double percentile(double p) {
+        if (v.empty()) {
+            return NAN;
+        }
+        std::sort(v.begin(), v.end());
+        return v[(size_t)llround(p * (v.size() - 1))];
+    }
+
+    double mean() const {
+        double s = 0;
+        for (double x : v) {
+            s += x;
+        }
+        return v.empty() ? NAN : s / v.size();
+    }
+};
+
+void printRow(const char* name, Distribution& d, double scale, const char* unit) {
+    printf("%-20s %6zu %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f  %s\n", name, d.v.size(), d.mean() * scale,
+           d.percentile(0) * scale, d.percentile(0.1) * scale, d.percentile(0.5) * scale, d.percentile(0.9) * scale,
+           d.percentile(1) * scale, unit);
+}
+
+void writeCsv(FILE* f, const std::vector<SessionKpiResult>& results) {
+    fprintf(f, "session,samples,channels,hours,run_hours,temp_in_band,temp_mean_c,temp_overshoot_c,"
+               "pressure_in_band,pressure_overshoot_mmhg,pump_mean,leak_trend_per_h,faults,estops,over_temp,"
+               "derating,error\n");
+    for (const SessionKpiResult& r : results) {
+        const SessionKpi& k = r.kpi;
+        fprintf(f, "%s,%llu,%u,%.4f,%.4f,%.4f,%.3f,%.2f,%.4f,%.2f,%.2f,%.3f,%u,%u,%u,%u,%s\n", baseName(r.dir).c_str(),
+                (unsigned long long)k.samples, k.channels, k.hours, k.runHours, k.tempInBand, k.tempMean,
+                k.tempOvershoot, k.pressureInBand, k.pressureOvershoot, k.pumpMean, k.leakTrend, k.faults, k.estops,
+                k.overTemp, k.derating, r.ok ? "" : r.error.c_str());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    KpiOptions o;
+    unsigned threads = 0;
+    const char* csvPath = nullptr;
+    bool verbose = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "j:T:b:B:o:vsh")) != -1) {
+        switch (opt) {
+            case 'j': threads = (unsigned)std::max(1, atoi(optarg)); break;
+            case 'T': o.tempTarget = strtof(optarg, nullptr); break;
+            case 'b': o.tempBand = strtof(optarg, nullptr); break;
+            case 'B': o.pressureBand = strtof(optarg, nullptr); break;
+            case 'o': csvPath = optarg; break;
+            case 'v': verbose = true; break;
+            case 's': signalKernelsForce(SIGNAL_ISA_SCALAR); break;
+            default: usage(); return 2;
+        }
+    }
+    if (optind >= argc) {
+        usage();
+        return 2;
+    }
+    std::vector<std::string> dirs;
+    for (int i = optind; i < argc; i++) {
+        if (!collect(argv[i], dirs)) {
+            return 1;
+        }
+    }
+    if (dirs.empty()) {
+        fprintf(stderr, "没有找到档案\n");
+        return 1;
+    }
+
+    WorkPool pool(threads);
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<SessionKpiResult> results;
+    sessionKpiBatch(dirs, o, pool, results);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    Distribution tempInBand, tempOvershoot, pressureInBand, pressureOvershoot, pumpMean, leakTrend;
+    uint64_t samples = 0, bytes = 0;
+    double hours = 0, runHours = 0;
+    unsigned failed = 0, faultSessions = 0;
+    uint64_t faults = 0, estops = 0, overTemp = 0, derating = 0;
+    for (const SessionKpiResult& r : results) {
+        if (!r.ok) {
+            fprintf(stderr, "%s: %s\n", r.dir.c_str(), r.error.c_str());
+            failed++;
+            continue;
+        }
+        const SessionKpi& k = r.kpi;
+        samples += k.samples;
+        bytes += r.bytes;
+        hours += k.hours;
+        runHours += k.runHours;
+        tempInBand.add(k.tempInBand);
+        tempOvershoot.add(k.tempOvershoot);
+        pressureInBand.add(k.pressureInBand);
+        pressureOvershoot.add(k.pressureOvershoot);
+        pumpMean.add(k.pumpMean);
+        leakTrend.add(k.leakTrend);
+        faults += k.faults;
+        estops += k.estops;
+        overTemp += k.overTemp;
+        derating += k.derating;
+        faultSessions += k.faults + k.estops > 0;
+    }
+
+    if (verbose) {
+        printf("%-32s %8s %7s %7s %7s %7s %7s %7s %7s %4s %4s %4s\n", "疗程", "RUN h", "温度带内", "超调°C", "负压带内",
+               "超调mmHg", "泵%", "趋势%/h", "故障", "急停", "过温", "降额");
+        for (const SessionKpiResult& r : results) {
+            if (!r.ok) {
+                continue;
+            }
+            const SessionKpi& k = r.kpi;
+            printf("%-32s %8.2f %6.1f%% %7.2f %6.1f%% %7.2f %7.1f %7.2f %7u %4u %4u %4u\n", baseName(r.dir).c_str(),
+                   k.runHours, k.tempInBand * 100, k.tempOvershoot, k.pressureInBand * 100, k.pressureOvershoot,
+                   k.pumpMean, k.leakTrend, k.faults, k.estops, k.overTemp, k.derating);
+        }
+        printf("\n");
+    }
+
+    printf("%zu 个疗程（%u 个无法读取），共 %.1f 小时，RUN %.1f 小时，%llu 个样本\n", results.size() - failed, failed,
+           hours, runHours, (unsigned long long)samples);
+    printf("目标 %.1f°C ± %.1f，负压为档位目标 ± %.1f mmHg\n\n", o.tempTarget, o.tempBand, o.pressureBand);
+    printf("%-20s %6s %9s %9s %9s %9s %9s %9s\n", "指标", "疗程", "平均", "最小", "P10", "P50", "P90", "最大");
+    printRow("温度在带内", tempInBand, 100, "%");
+    printRow("温度超调", tempOvershoot, 1, "°C");
+    printRow("负压在带内", pressureInBand, 100, "%");
+    printRow("负压超调", pressureOvershoot, 1, "mmHg");
+    printRow("平均泵速", pumpMean, 1, "%");
+    printRow("泵速趋势（漏气）", leakTrend, 1, "%/h");
+    printf("\n报警：FAULT %llu 次、急停 %llu 次（%u 个疗程），过温 %llu 次，降额 %llu 次\n", (unsigned long long)faults,
+           (unsigned long long)estops, faultSessions, (unsigned long long)overTemp, (unsigned long long)derating);
+
+    std::vector<const SessionKpiResult*> worst;
+    for (const SessionKpiResult& r : results) {
+        if (r.ok && !isnan(r.kpi.tempInBand)) {
+            worst.push_back(&r);
+        }
+    }
+    std::sort(worst.begin(), worst.end(), [](const SessionKpiResult* a, const SessionKpiResult* b) {
+        return a->kpi.tempInBand < b->kpi.tempInBand;
+    });
+    if (!worst.empty()) {
+        printf("温度带内时间最少的疗程：");
+        for (size_t i = 0; i < worst.size() && i < WORST_SESSIONS; i++) {
+            printf("%s %s（%.1f%%）", i > 0 ? "，" : "", baseName(worst[i]->dir).c_str(), worst[i]->kpi.tempInBand * 100);
+        }
+        printf("\n");
+    }
+    printf("\n%u 线程（%s），%.2f 秒，%.1f M样本/s，%.0f MB/s，窃取 %llu 次\n", pool.threads(),
+           signalIsaName(signalKernelsIsa()), seconds, samples / seconds / 1e6, bytes / seconds / 1048576.0,
+           (unsigned long long)pool.stats().steals);
+
+    if (csvPath != nullptr) {
+        FILE* f = fopen(csvPath, "w");
+        if (f == nullptr) {
+            perror(csvPath);
+            return 1;
+        }
+        writeCsv(f, results);
+        if (fclose(f) != 0) {
+            perror(csvPath);
+            return 1;
+        }
+    }
+    return failed > 0 ? 1 : 0;
+}
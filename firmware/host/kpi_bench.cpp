@@ -0,0 +1,486 @@
+/**
+ * @file kpi_bench.cpp
+ * @brief 批量指标计算的检查与基准：向量化归约对照、合成疗程上的指标核对、线程数扩展
+ *
+ *   kpi_bench [-n 疗程数] [-m 最多样本] [-c 通道数] [-j 最多线程] [-d 目录] [-s 种子] [-k]
+ *
+ * 1. 归约对照：随机数据（含无效值、各种长度和偏移）上标量、128 位、256 位三种实现结果必须相同，
+ *    并测各自的吞吐
+ * 2. 生成 -n 个合成疗程档案，长度在 2000 到 -m 个样本之间按对数均匀分布（大小相差 50 倍）。
+ *    生成时逐样本记下参考值：带内样本数、报警次数必须与 SessionKpi 完全相同，
+ *    RUN 超过 1 小时的疗程泵速趋势与设定的漏气速率相差不超过 0.5 %/h
+ * 3. 扩展：1、2、4 ... -j 个线程，分别在任务窃取和固定分配（只做自己队列的任务）下计算全部疗程，
+ *    结果必须与单线程相同。核数少于线程数时墙钟时间不会下降，所以另外用单线程测得的每个任务用时
+ *    模拟同样的分配和窃取，给出每个线程独占一个核时的完成时间
+ * 任一检查失败退出码为 1。
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SessionKpi.h"
+#include "SignalKernels.h"
+
+static int gFailures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %s %s\n", ok ? "✓" : "✗", what);
+    if (!ok) {
+        gFailures++;
+    }
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static void usage() {
+    fprintf(stderr,
+            "用法: kpi_bench [-n 疗程数] [-m 最多样本] [-c 通道数] [-j 最多线程] [-d 目录] [-s 种子] [-k]\n"
+            "  -n  疗程数（默认 400）\n"
+            "  -m  每个疗程最多样本数（默认 100000，100ms 周期约 2.8 小时）\n"
+            "  -c  通道数（默认 2）\n"
+            "  -j  最多线程数（默认 CPU 核数与 8 中较大的）\n"
+            "  -d  工作目录（默认 /tmp/kpi_bench，其中的档案会被删除）\n"
+            "  -s  随机种子（默认 1）\n"
+            "  -k  结束后保留档案\n");
+}
+
+static const int64_t START_MS = 1792281600000LL;   // 2026-10-18 00:00 UTC
+static const uint32_t MIN_SAMPLES = 2000;
+
+// ---- 1. 归约对照与吞吐 ----
+
+static bool sameStats(const I16BandStats& a, const I16BandStats& b) {
+    return a.sum == b.sum && a.count == b.count && a.inBand == b.inBand && a.min == b.min && a.max == b.max;
+}
+
+static void kernelTests(std::mt19937& rng) {
+    printf("向量化归约（当前 CPU 最高 %s）\n", signalIsaName(signalKernelsForce(SIGNAL_ISA_AUTO)));
+    const SignalIsa best = signalKernelsIsa();
+    bool same = true;
+    for (int it = 0; it < 2000 && same; it++) {
+        size_t n = it % 50 == 0 ? 70000 + rng() % 70000 : rng() % 3000;
+        std::vector<int16_t> a(n + 1);
+        std::vector<uint8_t> b(n + 1);
+        const bool wide = it % 2 != 0;
+        for (size_t i = 0; i <= n; i++) {
+            a[i] = rng() % 10 == 0 ? TELEMETRY_INVALID : (int16_t)(wide ? rng() % 65536 - 32768 : rng() % 200 - 100);
+            b[i] = it % 3 != 0 ? (uint8_t)(rng() % 4) : (uint8_t)rng();
+        }
+        if (it % 7 == 0) {
+            std::fill(a.begin(), a.end(), TELEMETRY_INVALID);
+        }
+        if (it % 5 == 0) {
+            std::fill(b.begin(), b.end() - 1, 3);
+        }
+        const size_t off = rng() % 2;           // 不对齐
+        const size_t len = n - std::min(n, off);
+        const int16_t lo = (int16_t)(rng() % 200 - 100), hi = (int16_t)(lo + rng() % 100);
+        const uint8_t mask = it % 2 ? 0xFF : 0x02, prev = (uint8_t)(rng() % 4);
+        signalKernelsForce(SIGNAL_ISA_SCALAR);
+        I16BandStats s0 = i16BandStats(a.data() + off, len, lo, hi);
+        uint64_t sum0 = u8Sum(b.data() + off, len);
+        uint64_t e0 = u8Entries(b.data() + off, len, mask, 2, prev);
+        size_t f0 = u8FindNot(b.data() + off, len, 3);
+        for (int isa = SIGNAL_ISA_V128; isa <= best; isa++) {
+            signalKernelsForce((SignalIsa)isa);
+            same = same && sameStats(s0, i16BandStats(a.data() + off, len, lo, hi)) &&
+                   sum0 == u8Sum(b.data() + off, len) && e0 == u8Entries(b.data() + off, len, mask, 2, prev) &&
+                   f0 == u8FindNot(b.data() + off, len, 3);
+        }
+    }
+    check(same, "各实现结果相同（2000 组随机数据，含无效值、不对齐、各种长度）");
+
+    // 吞吐：1 MB 的列反复计算（在缓存中，反映计算本身）
+    std::vector<int16_t> a(512 * 1024);
+    std::vector<uint8_t> b(1024 * 1024);
+    for (size_t i = 0; i < a.size(); i++) {
+        a[i] = (int16_t)(3900 + rng() % 200);
+        b[i] = (uint8_t)(rng() % 100);
+        b[a.size() + i] = (uint8_t)(rng() % 100);
+    }
+    printf("  %-8s %14s %14s %14s\n", "实现", "int16 统计", "uint8 求和", "进入次数");
+    for (int isa = SIGNAL_ISA_SCALAR; isa <= best; isa++) {
+        signalKernelsForce((SignalIsa)isa);
+        const int reps = 200;
+        volatile uint64_t sink = 0;
+        double gbs[3];
+        for (int k = 0; k < 3; k++) {
+            auto t0 = std::chrono::steady_clock::now();
+            for (int r = 0; r < reps; r++) {
+                switch (k) {
+                    case 0: sink = sink + i16BandStats(a.data(), a.size(), 3950, 4050).inBand; break;
+                    case 1: sink = sink + u8Sum(b.data(), b.size()); break;
+                    default: sink = sink + u8Entries(b.data(), b.size(), 0xFF, 7, 0); break;
+                }
+            }
+            gbs[k] = reps * 1.0 / 1024 / secondsSince(t0);
+        }
+        printf("  %-8s %10.1f GB/s %10.1f GB/s %10.1f GB/s\n", signalIsaName((SignalIsa)isa), gbs[0], gbs[1], gbs[2]);
+    }
+    signalKernelsForce(SIGNAL_ISA_AUTO);
+    printf("\n");
+}
+
+// ---- 2. 合成疗程 ----
+
+/**
+ * @brief 生成时逐样本记下的参考值
+ */
+struct Reference {
+    uint64_t tempCount = 0;
+    uint64_t tempInBand = 0;
+    uint64_t pressureCount = 0;
+    uint64_t pressureInBand = 0;
+    uint32_t faults = 0;
+    uint32_t estops = 0;
+    uint32_t overTemp = 0;
+    uint32_t derating = 0;
+    double leakSlope = 0;               // 设定的泵速上升速率 (%/h)
+};
+
+/**
+ * @brief 一个疗程：待机 -> 预热 -> 运行（换档、暂停、偶尔故障/急停后重新开始）-> 泄压
+ */
+static bool generateSession(const std::string& dir, uint32_t samples, uint8_t channels, uint32_t seed,
+                            const KpiOptions& o, Reference& ref) {
+    SessionArchiveWriter w;
+    std::string error;
+    if (!w.create(dir, channels, &error)) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return false;
+    }
+    std::mt19937 rng(seed);
+    auto uniform = [&](double lo, double hi) { return lo + (hi - lo) * (rng() / 4294967296.0); };
+    ref.leakSlope = uniform(-1.0, 6.0);
+    const double basePump = uniform(15, 30);
+
+    TelemetryRecord rec = {};
+    rec.mode = 1;
+    rec.gear = 5;
+    rec.flags = TELEMETRY_FLAG_SELF_TEST_OK;
+    rec.heaterLimit = 255;
+    rec.pumpLimit = 100;
+    rec.channelCount = channels;
+    int64_t unixMs = START_MS + (int64_t)seed * 1000;
+    uint32_t modeLeft = 300, gearLeft = 0, spikeLeft = 0, deratingLeft = 0;
+    double temp[TELEMETRY_MAX_CHANNELS], pressure[TELEMETRY_MAX_CHANNELS];
+    uint8_t prevMode = rec.mode, prevFlags = rec.flags, prevChFlags[TELEMETRY_MAX_CHANNELS] = {};
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        temp[ch] = 25;
+        pressure[ch] = 0;
+    }
+    const int16_t tLo = telemetryCenti(o.tempTarget - o.tempBand), tHi = telemetryCenti(o.tempTarget + o.tempBand);
+
+    for (uint32_t i = 0; i < samples; i++) {
+        unixMs += 100 + (int)(rng() % 7) - 3;
+        rec.uptimeMs += 100;
+        // 模式
+        if (samples - i == 100 && rec.mode != 1) {
+            rec.mode = 5;                       // 最后泄压、待机
+            modeLeft = 50;
+        } else if ((rec.mode == 3 || rec.mode == 4) && rng() % 150000 == 0) {
+            rec.mode = rng() % 8 == 0 ? 7 : 6;  // 急停或故障，之后回到待机重新开始
+            modeLeft = 200 + rng() % 400;
+        } else if (rec.mode == 3 && rng() % 20000 == 0) {
+            rec.mode = 4;                       // 暂停 30 秒
+            modeLeft = 300;
+        } else if (--modeLeft == 0) {
+            switch (rec.mode) {
+                case 1: rec.mode = 2; modeLeft = 1200; break;
+                case 2: case 4: rec.mode = 3; modeLeft = UINT32_MAX; break;
+                default: rec.mode = 1; modeLeft = samples - i > 200 ? 300 : UINT32_MAX; break;
+            }
+        }
+        if (rec.mode == 3 && (gearLeft == 0 || --gearLeft == 0)) {
+            rec.gear = (uint8_t)(1 + rng() % KPI_NUM_GEARS);
+            gearLeft = 3000 + rng() % 20000;
+        }
+        if (spikeLeft == 0 && rng() % 50000 == 0) {
+            spikeLeft = 100 + rng() % 200;      // 温度冲高（过温标志）
+        }
+        if (deratingLeft == 0 && rng() % 100000 == 0) {
+            deratingLeft = 1000 + rng() % 3000;
+        }
+        rec.flags = (uint8_t)(TELEMETRY_FLAG_SELF_TEST_OK | (deratingLeft > 0 ? TELEMETRY_FLAG_DERATING : 0));
+        rec.boardTempCenti = (int16_t)(3000 + rng() % 300);
+        const bool heating = rec.mode >= 2 && rec.mode <= 4;
+        const double hours = (unixMs - START_MS - (int64_t)seed * 1000) / 3.6e6;
+        const double pressureTarget = rec.mode == 3 ? (double)KPI_PRESSURE_FULL_GEAR * rec.gear / KPI_NUM_GEARS : 0;
+
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            TelemetryChannel& c = rec.channels[ch];
+            double tt = heating ? o.tempTarget + (spikeLeft > 0 ? 6.0 : 0.0) : 25.0;
+            temp[ch] += (tt - temp[ch]) * 0.02 + uniform(-0.4, 0.4);
+            pressure[ch] += (pressureTarget - pressure[ch]) * 0.05 + uniform(-0.5, 0.5);
+            pressure[ch] = std::max(0.0, pressure[ch]);
+            const bool tempLost = rng() % 20000 == 0;
+            c.padTempCenti = tempLost ? TELEMETRY_INVALID : telemetryCenti((float)temp[ch]);
+            c.pressureCenti = telemetryCenti((float)pressure[ch]);
+            c.heaterDuty = heating ? (uint8_t)(rng() % 256) : 0;
+            double pump = rec.mode == 3 ? basePump + 4.0 * rec.gear + ref.leakSlope * hours + uniform(-3, 3) : 0;
+            c.pumpPercent = (uint8_t)std::min(100.0, std::max(0.0, round(pump)));
+            c.flags = (uint8_t)((tempLost ? 0 : TELEMETRY_CH_TEMP_OK) | TELEMETRY_CH_PRESSURE_OK |
+                                (temp[ch] > 45.0 ? TELEMETRY_CH_OVER_TEMP : 0));
+
+            if (rec.mode == 3) {
+                if (c.padTempCenti != TELEMETRY_INVALID) {
+                    ref.tempCount++;
+                    ref.tempInBand += c.padTempCenti >= tLo && c.padTempCenti <= tHi;
+                }
+                ref.pressureCount++;
+                const int16_t pLo = telemetryCenti((float)(pressureTarget - o.pressureBand));
+                const int16_t pHi = telemetryCenti((float)(pressureTarget + o.pressureBand));
+                ref.pressureInBand += c.pressureCenti >= pLo && c.pressureCenti <= pHi;
+            }
+            ref.overTemp += (c.flags & TELEMETRY_CH_OVER_TEMP) && !(prevChFlags[ch] & TELEMETRY_CH_OVER_TEMP);
+            prevChFlags[ch] = c.flags;
+        }
+        ref.faults += rec.mode == 6 && prevMode != 6;
+        ref.estops += rec.mode == 7 && prevMode != 7;
+        ref.derating += (rec.flags & TELEMETRY_FLAG_DERATING) && !(prevFlags & TELEMETRY_FLAG_DERATING);
+        prevMode = rec.mode;
+        prevFlags = rec.flags;
+        spikeLeft -= spikeLeft > 0;
+        deratingLeft -= deratingLeft > 0;
+        if (!w.append(unixMs, (uint8_t)i, rec)) {
+            fprintf(stderr, "%s: 写入失败\n", dir.c_str());
+            return false;
+        }
+    }
+    return w.close();
+}
+
+static uint64_t fileBytes(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? (uint64_t)st.st_size : 0;
+}
+
+/**
+ * @brief 按每个任务的用时模拟 WorkPool 在 threads 个独占核上的调度（分配和窃取顺序与 WorkPool::run 相同），
+ *        不计内存带宽和共享缓存的竞争
+ * @return 全部完成的时间
+ */
+static double simulate(const std::vector<double>& seconds, const std::vector<uint64_t>& costs, unsigned threads,
+                       bool stealing) {
+    std::vector<size_t> order(seconds.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return costs[a] > costs[b]; });
+    std::vector<std::deque<size_t>> queues(threads);
+    for (size_t i = 0; i < order.size(); i++) {
+        queues[i % threads].push_back(order[i]);
+    }
+    std::vector<double> clock(threads, 0.0);
+    std::vector<bool> done(threads, false);
+    for (;;) {
+        // 最先空闲的线程取下一个任务
+        int w = -1;
+        for (unsigned k = 0; k < threads; k++) {
+            if (!done[k] && (w < 0 || clock[k] < clock[w])) {
+                w = (int)k;
+            }
+        }
+        if (w < 0) {
+            break;
+        }
+        std::deque<size_t>* q = &queues[w];
+        bool fromBack = false;
+        for (unsigned k = 1; q->empty() && stealing && k < threads; k++) {
+            q = &queues[(w + k) % threads];
+            fromBack = true;
+        }
+        if (q->empty()) {
+            done[w] = true;
+            continue;
+        }
+        size_t task = fromBack ? q->back() : q->front();
+        fromBack ? q->pop_back() : q->pop_front();
+        clock[w] += seconds[task];
+    }
+    return *std::max_element(clock.begin(), clock.end());
+}
+
+static bool sameKpi(const SessionKpi& a, const SessionKpi& b) {
+    auto eq = [](double x, double y) { return x == y || (isnan(x) && isnan(y)); };
+    return a.samples == b.samples && eq(a.hours, b.hours) && eq(a.runHours, b.runHours) &&
+           eq(a.tempInBand, b.tempInBand) && eq(a.tempMean, b.tempMean) && eq(a.tempOvershoot, b.tempOvershoot) &&
+           eq(a.pressureInBand, b.pressureInBand) && eq(a.pressureOvershoot, b.pressureOvershoot) &&
+           eq(a.pumpMean, b.pumpMean) && eq(a.leakTrend, b.leakTrend) && a.faults == b.faults &&
+           a.estops == b.estops && a.overTemp == b.overTemp && a.derating == b.derating;
+}
+
+static bool sameResults(const std::vector<SessionKpiResult>& a, const std::vector<SessionKpiResult>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].ok != b[i].ok || !sameKpi(a[i].kpi, b[i].kpi)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    unsigned sessions = 400;
+    uint32_t maxSamples = 100000;
+    int channels = 2;
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    unsigned maxThreads = std::max(cores, 8u);
+    std::string dir = "/tmp/kpi_bench";
+    uint32_t seed = 1;
+    bool keep = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:m:c:j:d:s:kh")) != -1) {
+        switch (opt) {
+            case 'n': sessions = (unsigned)std::max(1, atoi(optarg)); break;
+            case 'm': maxSamples = std::max<uint32_t>(MIN_SAMPLES, (uint32_t)strtoul(optarg, nullptr, 10)); break;
+            case 'c': channels = std::min(std::max(atoi(optarg), 1), TELEMETRY_MAX_CHANNELS); break;
+            case 'j': maxThreads = (unsigned)std::max(1, atoi(optarg)); break;
+            case 'd': dir = optarg; break;
+            case 's': seed = (uint32_t)strtoul(optarg, nullptr, 10); break;
+            case 'k': keep = true; break;
+            default: usage(); return 2;
+        }
+    }
+    std::mt19937 rng(seed);
+    kernelTests(rng);
+
+    // 生成
+    mkdir(dir.c_str(), 0755);
+    if (system(("rm -rf '" + dir + "'/s[0-9]*").c_str()) != 0) {
+        fprintf(stderr, "无法清理 %s\n", dir.c_str());
+        return 1;
+    }
+    const KpiOptions o;
+    std::vector<std::string> dirs(sessions);
+    std::vector<Reference> refs(sessions);
+    uint64_t totalSamples = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < sessions; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "/s%05u", i);
+        dirs[i] = dir + name;
+        const uint32_t n = (uint32_t)llround(MIN_SAMPLES * pow((double)maxSamples / MIN_SAMPLES, rng() / 4294967296.0));
+        if (!generateSession(dirs[i], n, (uint8_t)channels, seed * 100003u + i, o, refs[i])) {
+            return 1;
+        }
+        totalSamples += n;
+    }
+    printf("生成 %u 个疗程（%d 通道），%llu 个样本（%.0f 小时），%.1f 秒\n", sessions, channels,
+           (unsigned long long)totalSamples, totalSamples / 36000.0, secondsSince(t0));
+
+    // 指标核对
+    std::vector<SessionKpiResult> base;
+    {
+        WorkPool pool(1);
+        sessionKpiBatch(dirs, o, pool, base);
+    }
+    bool allOk = true, matched = true, trend = true;
+    unsigned trendSessions = 0;
+    double worstTrendError = 0;
+    uint64_t bytes = 0;
+    for (unsigned i = 0; i < sessions; i++) {
+        const SessionKpiResult& r = base[i];
+        const Reference& ref = refs[i];
+        allOk = allOk && r.ok;
+        bytes += r.bytes;
+        const SessionKpi& k = r.kpi;
+        bool inBand = ref.tempCount == 0 ? isnan(k.tempInBand)
+                                         : k.tempInBand == (double)ref.tempInBand / ref.tempCount &&
+                                           k.pressureInBand == (double)ref.pressureInBand / ref.pressureCount;
+        matched = matched && inBand && k.faults == ref.faults && k.estops == ref.estops &&
+                 k.overTemp == ref.overTemp && k.derating == ref.derating;
+        if (k.runHours > 1.0) {
+            trendSessions++;
+            const double err = fabs(k.leakTrend - ref.leakSlope);
+            worstTrendError = std::max(worstTrendError, err);
+            trend = trend && err <= 0.5;
+        }
+    }
+    check(allOk, "所有档案可读、列齐全");
+    check(matched, "带内比例、FAULT/急停/过温/降额次数与生成时的参考值相同");
+    char what[128];
+    snprintf(what, sizeof(what), "泵速趋势与设定的漏气速率相符（%u 个 RUN 超过 1 小时的疗程，最大误差 %.2f %%/h）",
+             trendSessions, worstTrendError);
+    check(trend, what);
+    printf("\n");
+
+    // 标量对照（单线程）
+    std::vector<SessionKpiResult> results;
+    double scalarS, vectorS;
+    {
+        WorkPool pool(1);
+        signalKernelsForce(SIGNAL_ISA_SCALAR);
+        t0 = std::chrono::steady_clock::now();
+        sessionKpiBatch(dirs, o, pool, results);
+        scalarS = secondsSince(t0);
+        signalKernelsForce(SIGNAL_ISA_AUTO);
+        t0 = std::chrono::steady_clock::now();
+        sessionKpiBatch(dirs, o, pool, base);
+        vectorS = secondsSince(t0);
+    }
+    printf("单线程：标量 %.3f s，%s %.3f s（%.1f 倍），%.0f M样本/s\n", scalarS, signalIsaName(signalKernelsIsa()),
+           vectorS, scalarS / vectorS, totalSamples / vectorS / 1e6);
+    check(sameResults(base, results), "标量与向量实现的指标相同");
+    printf("\n");
+
+    // 扩展：实测墙钟，另按单线程测得的每个任务用时模拟独占核时的完成时间
+    std::vector<double> taskSeconds(sessions);
+    std::vector<uint64_t> costs(sessions);
+    double total = 0;
+    for (unsigned i = 0; i < sessions; i++) {
+        taskSeconds[i] = base[i].seconds;
+        total += base[i].seconds;
+        costs[i] = fileBytes(dirs[i] + "/unix_ms.col");
+    }
+    printf("%u 个核，%.0f MB 档案（页缓存已热），任务用时 %.2f-%.2f ms\n", cores, bytes / 1048576.0,
+           *std::min_element(taskSeconds.begin(), taskSeconds.end()) * 1e3,
+           *std::max_element(taskSeconds.begin(), taskSeconds.end()) * 1e3);
+    printf("%-6s %-6s %10s %8s %12s %8s %8s %14s\n", "线程", "分配", "墙钟 s", "加速", "模拟完成 s", "模拟加速",
+           "窃取", "任务数 最少/最多");
+    std::vector<unsigned> counts = {1};
+    while (counts.back() < maxThreads) {
+        counts.push_back(std::min(counts.back() * 2, maxThreads));
+    }
+    bool consistent = true;
+    for (unsigned j : counts) {
+        for (int steal = 1; steal >= 0; steal--) {
+            if (j == 1 && !steal) {
+                continue;
+            }
+            WorkPool pool(j, steal != 0);
+            t0 = std::chrono::steady_clock::now();
+            sessionKpiBatch(dirs, o, pool, results);
+            const double s = secondsSince(t0);
+            consistent = consistent && sameResults(base, results);
+            const WorkPool::Stats& st = pool.stats();
+            const double makespan = simulate(taskSeconds, costs, j, steal != 0);
+            printf("%-6u %-6s %10.3f %8.2f %12.3f %8.2f %8llu %7u/%u\n", j, steal ? "窃取" : "固定", s, vectorS / s,
+                   makespan, total / makespan, (unsigned long long)st.steals,
+                   *std::min_element(st.tasks.begin(), st.tasks.end()),
+                   *std::max_element(st.tasks.begin(), st.tasks.end()));
+        }
+    }
+    check(consistent, "各线程数、分配方式的指标与单线程相同");
+
+    if (!keep) {
+        if (system(("rm -rf '" + dir + "'/s[0-9]*").c_str()) != 0) {
+            fprintf(stderr, "无法清理 %s\n", dir.c_str());
+        }
+    }
+    return gFailures > 0 ? 1 : 0;
+}
@@ -0,0 +1,451 @@
+/**
+ * @file link_bench.cpp
+ * @brief 主机链路协议检查与性能测试
+ *
+ *   link_bench --loopback [-n 次数]      进程内伪终端回环：服务端线程运行固件的 RpcServer（测试参数表）
+ *   link_bench /dev/ttyACM0 [-n 次数]    对真实设备或仿真（glasses_sim -u 打印的伪终端）
+ *
+ * 先做协议检查（回显、错误码、分页、损坏帧后重新对齐；回环模式另外检查丢应答后重发不重复执行命令、
+ * 帧间文本分离），再测往返时间 p50/p99/最大值、请求速率和载荷吞吐，最后在遥测开启时重复往返测试，
+ * 统计遥测丢帧。对设备只读参数、只写遥测周期，不发命令。
+ * 任一检查失败时退出码为 1。
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LinkClient.h"
+#include "RpcServer.h"
+
+using Clock = std::chrono::steady_clock;
+
+static int64_t elapsedUs(Clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since).count();
+}
+
+// ---- 回环服务端：测试参数表 ----
+
+static std::atomic<int> gLoopGear(1);
+static std::atomic<int> gLoopTelemetryMs(0);
+static std::atomic<int> gLoopStarts(0);
+static float gLoopSpare[8];
+
+static float loopGetGear() { return (float)gLoopGear.load(); }
+static RpcStatus loopSetGear(float v) { gLoopGear = (int)v; return RPC_OK; }
+static float loopGetTelemetry() { return (float)gLoopTelemetryMs.load(); }
+static RpcStatus loopSetTelemetry(float v) {
+    if (v != 0 && v < 1) {
+        return RPC_ERR_OUT_OF_RANGE;
+    }
+    gLoopTelemetryMs = (int)v;
+    return RPC_OK;
+}
+static float loopGetMode() { return 1.0f; }
+template <int I> static float loopGetSpare() { return gLoopSpare[I]; }
+template <int I> static RpcStatus loopSetSpare(float v) { gLoopSpare[I] = v; return RPC_OK; }
+
+// 参数名较长、个数较多，LIST 需要分页
+static const RpcParam kLoopParams[] = {
+    { PARAM_PRESSURE_GEAR, "gear", 1, 5, loopGetGear, loopSetGear },
+    { PARAM_MODE, "mode", 0, 0, loopGetMode, nullptr },
+    { PARAM_TELEMETRY_PERIOD, "telemetry_ms", 0, 10000, loopGetTelemetry, loopSetTelemetry },
+    { 100, "loopback_spare_parameter_0", -1, 1, loopGetSpare<0>, loopSetSpare<0> },
+    { 101, "loopback_spare_parameter_1", -1, 1, loopGetSpare<1>, loopSetSpare<1> },
+    { 102, "loopback_spare_parameter_2", -1, 1, loopGetSpare<2>, loopSetSpare<2> },
+    { 103, "loopback_spare_parameter_3", -1, 1, loopGetSpare<3>, loopSetSpare<3> },
+    { 104, "loopback_spare_parameter_4", -1, 1, loopGetSpare<4>, loopSetSpare<4> },
+    { 105, "loopback_spare_parameter_5", -1, 1, loopGetSpare<5>, loopSetSpare<5> },
+    { 106, "loopback_spare_parameter_6", -1, 1, loopGetSpare<6>, loopSetSpare<6> },
+    { 107, "loopback_spare_parameter_7", -1, 1, loopGetSpare<7>, loopSetSpare<7> },
+};
+
+static RpcStatus loopCommand(uint8_t command) {
+    if (command == CMD_START) {
+        gLoopStarts++;
+        return RPC_OK;
+    }
+    return RPC_ERR_REJECTED;
+}
+
+static uint32_t loopUptime() {
+    static const Clock::time_point start = Clock::now();
+    return (uint32_t)(elapsedUs(start) / 1000);
+}
+
+/**
+ * @brief 伪终端主端上的设备模拟：解码请求、调用 RpcServer、写应答；按 telemetry_ms 发遥测
+ */
+class LoopbackDevice {
+public:
+    std::atomic<bool> running;
+    std::atomic<int> dropResponses;     // 执行请求但丢弃接下来 N 个应答（模拟应答在链路上丢失）
+    std::atomic<bool> emitText;         // 每个应答前写一行文本日志
+
+    explicit LoopbackDevice(int masterFd)
+        : running(true), dropResponses(0), emitText(false), fd(masterFd),
+          server(kLoopParams, sizeof(kLoopParams) / sizeof(kLoopParams[0]), loopCommand, 2, loopUptime) {}
+
+    void run() {
+        LinkDecoder decoder;
+        uint8_t telemetrySeq = 0;
+        Clock::time_point nextTelemetry = Clock::now();
+        while (running) {
+            int period = gLoopTelemetryMs;
+            int waitMs = 10;
+            if (period > 0) {
+                auto now = Clock::now();
+                if (now >= nextTelemetry) {
+                    sendTelemetry(telemetrySeq++);
+                    nextTelemetry = now + std::chrono::milliseconds(period);
+                }
+                waitMs = (int)std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                       nextTelemetry - Clock::now()).count());
+            }
+            pollfd p = {fd, POLLIN, 0};
+            if (poll(&p, 1, waitMs) <= 0) {
+                continue;
+            }
+            uint8_t buf[512];
+            ssize_t n = read(fd, buf, sizeof(buf));
+            for (ssize_t i = 0; i < n; i++) {
+                if (decoder.push(buf[i]) != LinkDecoder::LINK_PUSH_FRAME) {
+                    continue;
+                }
+                const LinkFrameView& f = decoder.frame();
+                if (f.type != LINK_FRAME_REQUEST) {
+                    continue;
+                }
+                uint8_t response[LINK_MAX_PAYLOAD];
+                size_t len = server.handle(f.seq, f.payload, f.len, response);
+                if (dropResponses > 0) {
+                    dropResponses--;
+                    continue;
+                }
+                if (emitText) {
+                    static const char line[] = "[界面] 回环设备的文本日志\r\n";
+                    writeAll((const uint8_t*)line, sizeof(line) - 1);
+                }
+                send(LINK_FRAME_RESPONSE, f.seq, response, len);
+            }
+        }
+    }
+
+    const RpcServer::Stats& counters() const { return server.counters(); }
+
+private:
+    int fd;
+    RpcServer server;
+
+    void sendTelemetry(uint8_t seq) {
+        TelemetryRecord rec = {};
+        rec.uptimeMs = loopUptime();
+        rec.mode = 3;
+        rec.gear = (uint8_t)gLoopGear.load();
+        rec.flags = TELEMETRY_FLAG_SELF_TEST_OK;
+        rec.boardTempCenti = telemetryCenti(31.5f);
+        rec.heaterLimit = 255;
+        rec.pumpLimit = 100;
+        rec.channelCount = 2;
+        for (uint8_t i = 0; i < 2; i++) {
+            rec.channels[i] = {telemetryCenti(40.0f + i), telemetryCenti(-20.0f), 120, 35,
+                               TELEMETRY_CH_TEMP_OK | TELEMETRY_CH_PRESSURE_OK};
+        }
+        uint8_t payload[TELEMETRY_HEADER_LEN + TELEMETRY_MAX_CHANNELS * TELEMETRY_CHANNEL_LEN];
+        send(LINK_FRAME_TELEMETRY, seq, payload, telemetryEncode(rec, payload));
+    }
+
+    void send(uint8_t type, uint8_t seq, const uint8_t* payload, size_t len) {
+        uint8_t wire[LINK_MAX_WIRE];
+        writeAll(wire, linkEncodeFrame(type, seq, payload, len, wire));
+    }
+
+    void writeAll(const uint8_t* data, size_t len) {
+        while (len > 0 && running) {
+            ssize_t n = write(fd, data, len);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EINTR) {
+                    pollfd p = {fd, POLLOUT, 0};
+                    poll(&p, 1, 10);
+                    continue;
+                }
+                return;
+            }
+            data += n;
+            len -= (size_t)n;
+        }
+    }
+};
+
+// ---- 检查 ----
+
+static int gFailures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %s  %s\n", ok ? "通过" : "失败", what);
+    if (!ok) {
+        gFailures++;
+    }
+}
+
+static void checkProtocol(LinkClient& client, SerialPort& port) {
+    printf("协议检查\n");
+    std::vector<uint8_t> echo;
+
+    bool echoOk = true;
+    for (size_t len : {(size_t)0, (size_t)1, (size_t)7, (size_t)64, (size_t)LINK_MAX_PAYLOAD - 2}) {
+        std::vector<uint8_t> data(len);
+        for (size_t i = 0; i < len; i++) {
+            data[i] = (uint8_t)(i * 37);     // 含 0x00，检验 COBS
+        }
+        echoOk &= client.ping(data.data(), len, echo) == LinkClient::LINK_OK && echo == data;
+    }
+    check(echoOk, "PING 回显 0-118 字节");
+
+    std::vector<uint8_t> big(LINK_MAX_PAYLOAD - 1);
+    check(client.ping(big.data(), big.size(), echo) == LinkClient::LINK_STATUS &&
+          client.status() == RPC_ERR_TOO_LARGE, "PING 119 字节返回 TOO_LARGE");
+
+    LinkDeviceInfo info;
+    check(client.info(info) == LinkClient::LINK_OK && info.protocolVersion == LINK_PROTOCOL_VERSION &&
+          info.maxPayload == LINK_MAX_PAYLOAD, "INFO 协议版本与载荷上限");
+
+    std::vector<LinkParamInfo> params;
+    uint32_t before = client.counters().requests;
+    bool listed = client.list(params) == LinkClient::LINK_OK && params.size() == info.paramCount;
+    char what[96];
+    snprintf(what, sizeof(what), "LIST 分页取回 %zu 个参数（%u 个请求）", params.size(),
+             client.counters().requests - before);
+    check(listed, what);
+
+    std::vector<uint8_t> ids;
+    for (const LinkParamInfo& p : params) {
+        ids.push_back(p.id);
+    }
+    ids.push_back(250);
+    std::vector<float> values;
+    std::vector<RpcStatus> statuses;
+    check(client.get(ids, values, &statuses) == LinkClient::LINK_OK &&
+          statuses.back() == RPC_ERR_UNKNOWN_PARAM &&
+          std::count(statuses.begin(), statuses.end(), RPC_OK) == (long)params.size(),
+          "GET 全部参数，未知编号逐项报错");
+
+    check(client.set({{PARAM_MODE, 1}, {PARAM_TELEMETRY_PERIOD, 1e6f}, {250, 0}}, statuses) == LinkClient::LINK_OK &&
+          statuses[0] == RPC_ERR_READ_ONLY && statuses[1] == RPC_ERR_OUT_OF_RANGE &&
+          statuses[2] == RPC_ERR_UNKNOWN_PARAM, "SET 只读 / 超出范围 / 未知参数");
+
+    const uint8_t badOp[] = {0x7F};
+    check(client.call(badOp, 1, echo) == LinkClient::LINK_STATUS && client.status() == RPC_ERR_UNKNOWN_OP,
+          "未知操作");
+
+    // 损坏的帧（CRC 错）后紧跟正常请求：解码器在下一个分隔符处重新对齐
+    uint8_t wire[LINK_MAX_WIRE];
+    const uint8_t ping[] = {RPC_OP_PING, 1, 2, 3};
+    size_t n = linkEncodeFrame(LINK_FRAME_REQUEST, 0xEE, ping, sizeof(ping), wire);
+    wire[3] ^= 0x55;
+    port.write(wire, n);
+    const uint8_t junk[] = {0x00, 0x42, 0x13};     // 半帧
+    port.write(junk, sizeof(junk));
+    const uint8_t data[] = {9, 8, 7};
+    check(client.ping(data, sizeof(data), echo) == LinkClient::LINK_OK && echo.size() == 3 && echo[0] == 9,
+          "损坏帧与半帧之后的请求正常应答");
+}
+
+static void checkLoopbackOnly(LinkClient& client, LoopbackDevice& dev) {
+    std::vector<uint8_t> echo;
+
+    // 命令执行了但应答丢失：客户端超时后同序号重发，服务端返回缓存的应答，不再执行
+    int starts = gLoopStarts;
+    uint32_t dups = dev.counters().duplicates;
+    dev.dropResponses = 1;
+    uint32_t retries = client.counters().retries;
+    check(client.command(CMD_START) == LinkClient::LINK_OK && gLoopStarts == starts + 1 &&
+          client.counters().retries == retries + 1 && dev.counters().duplicates == dups + 1,
+          "应答丢失后重发，命令只执行一次");
+
+    check(client.command(CMD_STOP) == LinkClient::LINK_STATUS && client.status() == RPC_ERR_REJECTED,
+          "命令被拒绝时返回 REJECTED");
+
+    // 序号相同但内容不同：不是重发，照常执行
+    uint8_t seq = client.nextSequence();
+    std::vector<RpcStatus> statuses;
+    client.set({{PARAM_PRESSURE_GEAR, 2}}, statuses);
+    client.setNextSequence(seq);
+    client.set({{PARAM_PRESSURE_GEAR, 4}}, statuses);
+    check(gLoopGear == 4, "同序号不同内容的请求照常执行");
+
+    // 帧间文本
+    int lines = 0;
+    client.onText([&lines](const std::string& line) {
+        lines += line.find("回环设备") != std::string::npos;
+    });
+    dev.emitText = true;
+    const uint8_t data[] = {1, 2, 3};
+    bool ok = true;
+    for (int i = 0; i < 10; i++) {
+        ok &= client.ping(data, sizeof(data), echo) == LinkClient::LINK_OK;
+    }
+    dev.emitText = false;
+    client.onText(nullptr);
+    check(ok && lines == 10, "帧与文本日志交错时分离正确");
+}
+
+// ---- 性能 ----
+
+struct Latency {
+    double p50, p99, max;
+};
+
+static Latency measure(LinkClient& client, size_t payload, int count, int& errors, double& seconds) {
+    std::vector<uint8_t> data(payload, 0xA5), echo;
+    std::vector<int64_t> us;
+    us.reserve(count);
+    errors = 0;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < count; i++) {
+        Clock::time_point t0 = Clock::now();
+        if (client.ping(data.data(), data.size(), echo) != LinkClient::LINK_OK || echo.size() != payload) {
+            errors++;
+            continue;
+        }
+        us.push_back(elapsedUs(t0));
+    }
+    seconds = elapsedUs(start) / 1e6;
+    if (us.empty()) {
+        return {NAN, NAN, NAN};
+    }
+    std::sort(us.begin(), us.end());
+    auto pct = [&us](double p) { return us[std::min(us.size() - 1, (size_t)(p * us.size()))] / 1000.0; };
+    return {pct(0.50), pct(0.99), us.back() / 1000.0};
+}
+
+static void bench(LinkClient& client, int count) {
+    printf("往返时间（PING，一个请求在途）\n");
+    printf("  %8s %9s %9s %9s %10s %12s %6s\n", "载荷", "p50 ms", "p99 ms", "最大 ms", "请求/s", "载荷 字节/s", "错误");
+    for (size_t payload : {(size_t)8, (size_t)64, (size_t)LINK_MAX_PAYLOAD - 2}) {
+        int errors;
+        double seconds;
+        Latency l = measure(client, payload, count, errors, seconds);
+        double rate = (count - errors) / seconds;
+        // 载荷往返各一次
+        printf("  %8zu %9.3f %9.3f %9.3f %10.0f %12.0f %6d\n", payload, l.p50, l.p99, l.max, rate,
+               rate * payload * 2, errors);
+    }
+}
+
+static void benchWithTelemetry(LinkClient& client, int count, int periodMs) {
+    std::vector<RpcStatus> statuses;
+    if (client.set({{PARAM_TELEMETRY_PERIOD, (float)periodMs}}, statuses) != LinkClient::LINK_OK ||
+        statuses[0] != RPC_OK) {
+        printf("遥测周期 %d ms 设置失败，跳过\n", periodMs);
+        return;
+    }
+    // 等第一帧遥测，之后的序号间隔才有意义
+    uint32_t frames0 = client.counters().telemetryFrames;
+    for (int i = 0; i < 50 && client.counters().telemetryFrames == frames0; i++) {
+        client.poll(20);
+    }
+    const LinkClient::Stats s0 = client.counters();
+    int errors;
+    double seconds;
+    Latency l = measure(client, 8, count, errors, seconds);
+    const LinkClient::Stats s1 = client.counters();
+    client.set({{PARAM_TELEMETRY_PERIOD, 0}}, statuses);
+
+    uint32_t frames = s1.telemetryFrames - s0.telemetryFrames;
+    uint32_t lost = s1.telemetryLost - s0.telemetryLost;
+    printf("遥测 %d ms 同时往返（8 字节）: p50 %.3f ms, p99 %.3f ms, 最大 %.3f ms, 错误 %d\n",
+           periodMs, l.p50, l.p99, l.max, errors);
+    printf("  遥测 %u 帧 / %.2f s（%.0f 帧/s），按序号丢失 %u 帧，过期应答 %u\n",
+           frames, seconds, frames / seconds, lost, s1.staleResponses - s0.staleResponses);
+    check(errors == 0 && lost == 0, "遥测与 RPC 同时进行，无丢帧、无超时");
+}
+
+static void usage() {
+    fprintf(stderr,
+            "用法: link_bench --loopback | 串口  [-n 次数] [-t 超时ms] [-p 遥测周期ms]\n"
+            "  --loopback  进程内伪终端回环（默认 2000 次，遥测 1ms）\n"
+            "  串口        真实设备或 glasses_sim -u 的伪终端（默认 200 次，遥测 20ms）\n");
+}
+
+int main(int argc, char** argv) {
+    bool loopback = false;
+    std::string path;
+    int count = 0;
+    int timeoutMs = 0;
+    int telemetryMs = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--loopback") {
+            loopback = true;
+        } else if ((a == "-n" || a == "-t" || a == "-p") && i + 1 < argc) {
+            int v = atoi(argv[++i]);
+            (a == "-n" ? count : a == "-t" ? timeoutMs : telemetryMs) = v;
+        } else if (a[0] != '-' && path.empty()) {
+            path = a;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (loopback == !path.empty()) {
+        usage();
+        return 2;
+    }
+
+    SerialPort port;
+    int master = -1;
+    if (loopback) {
+        master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+            perror("posix_openpt");
+            return 1;
+        }
+        if (!port.open(ptsname(master))) {
+            fprintf(stderr, "%s\n", port.error().c_str());
+            return 1;
+        }
+    } else if (!port.open(path)) {
+        fprintf(stderr, "%s\n", port.error().c_str());
+        return 1;
+    }
+
+    LinkClient client(port);
+    // 设备的界面任务每 LINK_RPC_INTERVAL_MS 处理一批请求，超时要留余量
+    client.setTimeout(timeoutMs > 0 ? timeoutMs : (loopback ? 50 : 300), 3);
+
+    if (loopback) {
+        LoopbackDevice dev(master);
+        std::thread server([&dev]() { dev.run(); });
+        checkProtocol(client, port);
+        checkLoopbackOnly(client, dev);
+        bench(client, count > 0 ? count : 2000);
+        benchWithTelemetry(client, count > 0 ? count : 2000, telemetryMs > 0 ? telemetryMs : 1);
+        const RpcServer::Stats& s = dev.counters();
+        printf("服务端: 请求 %u, 重发 %u, 错误应答 %u\n", s.requests, s.duplicates, s.errors);
+        dev.running = false;
+        server.join();
+        close(master);
+    } else {
+        checkProtocol(client, port);
+        bench(client, count > 0 ? count : 200);
+        benchWithTelemetry(client, count > 0 ? count : 200, telemetryMs > 0 ? telemetryMs : 20);
+    }
+
+    const LinkClient::Stats& c = client.counters();
+    const LinkDecoder::Stats& d = client.decoderCounters();
+    printf("客户端: 请求 %u, 重发 %u, 超时 %u, CRC 错误 %u, 文本 %u 字节\n",
+           c.requests, c.retries, c.timeouts, d.crcErrors, c.textBytes);
+    printf("%s\n", gFailures == 0 ? "全部检查通过" : "有检查失败");
+    return gFailures == 0 ? 0 : 1;
+}
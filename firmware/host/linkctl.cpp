@@ -0,0 +1,278 @@
+/**
+ * @file linkctl.cpp
+ * @brief 主机链路命令行工具：读写参数、发命令、监视遥测
+ *
+ *   linkctl /dev/ttyACM0 info
+ *   linkctl /dev/ttyACM0 list
+ *   linkctl /dev/ttyACM0 get gear mode pump_limit
+ *   linkctl /dev/ttyACM0 set gear=3
+ *   linkctl /dev/ttyACM0 cmd start
+ *   linkctl /dev/ttyACM0 monitor 100 30       # 遥测周期 100ms，监视 30 秒（结束时关闭遥测）
+ *
+ * 参数名取自设备的 LIST 应答，也可以直接写编号。
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "LinkClient.h"
+#include "TelemetryCsv.h"
+
+static const char* kCommandNames[CMD_COUNT] = {"start", "pause", "resume", "stop", "estop"};
+
+static void usage() {
+    fprintf(stderr,
+            "用法: linkctl [-t 超时ms] [-r 重发次数] [-x] 串口 命令 [参数...]\n"
+            "  ping [字节数]              往返测试\n"
+            "  info                       协议版本、通道数、运行时间\n"
+            "  list                       参数表\n"
+            "  get 名称|编号...           读参数\n"
+            "  set 名称=值...             写参数\n"
+            "  cmd start|pause|resume|stop|estop\n"
+            "  monitor [周期ms] [秒]      打开遥测并打印（默认 100ms，直到 Ctrl+C）\n"
+            "  -x  同时打印设备的文本日志\n");
+}
+
+static bool resolveParam(const std::vector<LinkParamInfo>& params, const std::string& key, uint8_t& id) {
+    for (const LinkParamInfo& p : params) {
+        if (p.name == key) {
+            id = p.id;
+            return true;
+        }
+    }
+    char* end;
+    long v = strtol(key.c_str(), &end, 0);
+    if (*end == '\0' && v >= 0 && v <= 255) {
+        id = (uint8_t)v;
+        return true;
+    }
+    return false;
+}
+
+static const char* paramName(const std::vector<LinkParamInfo>& params, uint8_t id) {
+    for (const LinkParamInfo& p : params) {
+        if (p.id == id) {
+            return p.name.c_str();
+        }
+    }
+    return "?";
+}
+
+static int fail(LinkClient& client, LinkClient::Result r) {
+    if (r == LinkClient::LINK_STATUS) {
+        fprintf(stderr, "设备拒绝: %s\n", LinkClient::statusName(client.status()));
+    } else {
+        fprintf(stderr, "错误: %s\n", LinkClient::resultName(r));
+    }
+    return 1;
+}
+
+static void printTelemetry(uint8_t seq, const TelemetryRecord& rec) {
+    const char* mode = telemetryModeName(rec.mode);
+    printf("%9.3f #%03u %-7s 档%u 板温%5.1f 限%3u/%3u%%%s",
+           rec.uptimeMs / 1000.0, seq, mode, rec.gear, telemetryFromCenti(rec.boardTempCenti),
+           rec.heaterLimit, rec.pumpLimit, (rec.flags & TELEMETRY_FLAG_DERATING) ? " 降额" : "");
+    for (uint8_t i = 0; i < rec.channelCount; i++) {
+        const TelemetryChannel& ch = rec.channels[i];
+        printf(" | 通道%u %5.1f°C %6.1fmmHg 加热%3u 泵%3u%%%s", i,
+               telemetryFromCenti(ch.padTempCenti), telemetryFromCenti(ch.pressureCenti),
+               ch.heaterDuty, ch.pumpPercent, (ch.flags & TELEMETRY_CH_OVER_TEMP) ? " 过温" : "");
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    int timeoutMs = 200;
+    int retries = 3;
+    bool showText = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:r:xh")) != -1) {
+        switch (opt) {
+            case 't': timeoutMs = atoi(optarg); break;
+            case 'r': retries = atoi(optarg); break;
+            case 'x': showText = true; break;
+            default: usage(); return 2;
+        }
+    }
+    if (argc - optind < 2) {
+        usage();
+        return 2;
+    }
+    const std::string path = argv[optind];
+    const std::string cmd = argv[optind + 1];
+    std::vector<std::string> args(argv + optind + 2, argv + argc);
+
+    SerialPort port;
+    if (!port.open(path)) {
+        fprintf(stderr, "%s\n", port.error().c_str());
+        return 1;
+    }
+    LinkClient client(port);
+    client.setTimeout(timeoutMs, retries);
+    if (showText) {
+        client.onText([](const std::string& line) { printf("[设备] %s\n", line.c_str()); });
+    }
+
+    LinkClient::Result r;
+    if (cmd == "ping") {
+        size_t len = args.empty() ? 16 : (size_t)atoi(args[0].c_str());
+        std::vector<uint8_t> data(len), echo;
+        for (size_t i = 0; i < len; i++) {
+            data[i] = (uint8_t)i;
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        r = client.ping(data.data(), data.size(), echo);
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+        if (r != LinkClient::LINK_OK) {
+            return fail(client, r);
+        }
+        printf("%zu 字节 往返 %.2f ms%s\n", len, us / 1000.0, echo == data ? "" : "（回显内容不符）");
+        return echo == data ? 0 : 1;
+    }
+
+    if (cmd == "info") {
+        LinkDeviceInfo info;
+        if ((r = client.info(info)) != LinkClient::LINK_OK) {
+            return fail(client, r);
+        }
+        printf("协议版本 %u, %u 通道, %u 个参数, 载荷上限 %u 字节, 运行 %.1f s\n",
+               info.protocolVersion, info.channels, info.paramCount, info.maxPayload, info.uptimeMs / 1000.0);
+        if (info.protocolVersion != LINK_PROTOCOL_VERSION) {
+            printf("注意: 本工具的协议版本为 %d\n", LINK_PROTOCOL_VERSION);
+        }
+        return 0;
+    }
+
+    // 其余命令需要参数名
+    std::vector<LinkParamInfo> params;
+    if (cmd == "list" || cmd == "get" || cmd == "set") {
+        if ((r = client.list(params)) != LinkClient::LINK_OK) {
+            return fail(client, r);
+        }
+    }
+
+    if (cmd == "list") {
+        for (const LinkParamInfo& p : params) {
+            if (p.writable) {
+                printf("%3u  %-16s 读写  [%g, %g]\n", p.id, p.name.c_str(), p.minValue, p.maxValue);
+            } else {
+                printf("%3u  %-16s 只读\n", p.id, p.name.c_str());
+            }
+        }
+        return 0;
+    }
+
+    if (cmd == "get") {
+        std::vector<uint8_t> ids;
+        if (args.empty()) {
+            for (const LinkParamInfo& p : params) {
+                ids.push_back(p.id);
+            }
+        }
+        for (const std::string& a : args) {
+            uint8_t id;
+            if (!resolveParam(params, a, id)) {
+                fprintf(stderr, "未知参数: %s\n", a.c_str());
+                return 2;
+            }
+            ids.push_back(id);
+        }
+        std::vector<float> values;
+        std::vector<RpcStatus> statuses;
+        if ((r = client.get(ids, values, &statuses)) != LinkClient::LINK_OK) {
+            return fail(client, r);
+        }
+        int rc = 0;
+        for (size_t i = 0; i < ids.size(); i++) {
+            if (statuses[i] == RPC_OK) {
+                printf("%-16s %g\n", paramName(params, ids[i]), values[i]);
+            } else {
+                printf("%-16s （%s）\n", paramName(params, ids[i]), LinkClient::statusName(statuses[i]));
+                rc = 1;
+            }
+        }
+        return rc;
+    }
+
+    if (cmd == "set") {
+        std::vector<std::pair<uint8_t, float>> values;
+        for (const std::string& a : args) {
+            size_t eq = a.find('=');
+            uint8_t id;
+            if (eq == std::string::npos || !resolveParam(params, a.substr(0, eq), id)) {
+                fprintf(stderr, "参数格式: 名称=值 (%s)\n", a.c_str());
+                return 2;
+            }
+            values.push_back({id, strtof(a.c_str() + eq + 1, nullptr)});
+        }
+        if (values.empty()) {
+            usage();
+            return 2;
+        }
+        std::vector<RpcStatus> statuses;
+        if ((r = client.set(values, statuses)) != LinkClient::LINK_OK) {
+            return fail(client, r);
+        }
+        int rc = 0;
+        for (size_t i = 0; i < values.size(); i++) {
+            printf("%-16s %s\n", paramName(params, values[i].first), LinkClient::statusName(statuses[i]));
+            rc |= statuses[i] != RPC_OK;
+        }
+        return rc;
+    }
+
+    if (cmd == "cmd") {
+        if (args.size() != 1) {
+            usage();
+            return 2;
+        }
+        int c = 0;
+        while (c < CMD_COUNT && args[0] != kCommandNames[c]) {
+            c++;
+        }
+        if (c == CMD_COUNT) {
+            fprintf(stderr, "未知命令: %s\n", args[0].c_str());
+            return 2;
+        }
+        if ((r = client.command((RpcCommand)c)) != LinkClient::LINK_OK) {
+            return fail(client, r);
+        }
+        printf("%s: OK\n", kCommandNames[c]);
+        return 0;
+    }
+
+    if (cmd == "monitor") {
+        float period = args.size() > 0 ? strtof(args[0].c_str(), nullptr) : 100;
+        int seconds = args.size() > 1 ? atoi(args[1].c_str()) : 0;
+        std::vector<RpcStatus> statuses;
+        r = client.set({{PARAM_TELEMETRY_PERIOD, period}}, statuses);
+        if (r != LinkClient::LINK_OK || statuses[0] != RPC_OK) {
+            if (r == LinkClient::LINK_OK) {
+                fprintf(stderr, "遥测周期 %g ms: %s\n", period, LinkClient::statusName(statuses[0]));
+                return 1;
+            }
+            return fail(client, r);
+        }
+        client.onTelemetry(printTelemetry);
+        auto end = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+        while (seconds == 0 || std::chrono::steady_clock::now() < end) {
+            if (!client.poll(100)) {
+                fprintf(stderr, "%s\n", port.error().c_str());
+                return 1;
+            }
+        }
+        client.set({{PARAM_TELEMETRY_PERIOD, 0}}, statuses);
+        const LinkClient::Stats& s = client.counters();
+        const LinkDecoder::Stats& d = client.decoderCounters();
+        fprintf(stderr, "遥测 %u 帧，按序号丢失 %u 帧，CRC 错误 %u\n", s.telemetryFrames, s.telemetryLost, d.crcErrors);
+        return 0;
+    }
+
+    usage();
+    return 2;
+}
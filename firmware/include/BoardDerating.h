@@ -0,0 +1,73 @@
+/**
+ * @file BoardDerating.h
+ * @brief 板温降额（芯片内部温度 + 热电偶冷端温度 -> 加热/泵占空比上限）
+ *
+ * 加热片和泵与 ESP32-C3 装在狭小的眼镜壳体内，长时间满功率加热会把电路板烤热。
+ * 安全监控任务每个周期读取芯片内部温度传感器（temperatureRead()）和各通道的冷端温度
+ * （MAX31855 芯片温度即板温，取 SampleHub 中 TOPIC_BOARD_TEMP 的最大值），一阶低通后按折线求降额：
+ * 温度低于 START 不降额，START..FULL 之间加热/泵的占空比上限线性降到 DERATE_HEATER_MIN / DERATE_PUMP_MIN，
+ * 两个温度取降额较多的一个。
+ *
+ * 上限存成单字节，控制任务每个周期直接取用（加热PWM上限 0-255、泵速上限 0-100%），
+ * 控制回路中只多一次比较，不读传感器。
+ *
+ * 任一温度达到硬限值（*_LIMIT）时上限为0并报警，系统转入故障模式；
+ * 两个温度都降到硬限值以下 DERATE_RECOVER_MARGIN 后解除。
+ * 某个温度读不到（MAX6675 没有冷端温度、芯片不支持）时只按另一个判断，都读不到时不降额。
+ */
+
+#ifndef BOARD_DERATING_H
+#define BOARD_DERATING_H
+
+#include <Arduino.h>
+#include "config.h"
+
+class BoardDerating {
+public:
+    BoardDerating();
+
+    /**
+     * @brief 更新降额（安全监控任务每周期调用）
+     * @param mcu_temp 芯片内部温度 (°C)，读不到为NAN
+     * @param board_temp 板温 (°C)，读不到为NAN
+     * @return true 硬限值报警状态发生变化（置位或解除）
+     */
+    bool update(float mcu_temp, float board_temp);
+
+    /**
+     * @brief 加热PWM占空比上限（0-255，控制任务每周期读取）
+     */
+    uint8_t heaterLimit() const { return heaterMax; }
+
+    /**
+     * @brief 泵速上限（0-100%，控制任务每周期读取）
+     */
+    uint8_t pumpLimit() const { return pumpMax; }
+
+    /**
+     * @brief 降额程度（0 = 不降额，1 = 降到最低上限）
+     */
+    float level() const { return derateLevel; }
+
+    bool isDerating() const { return derateLevel > 0.0f || overLimit; }
+    bool isOverLimit() const { return overLimit; }
+
+    /**
+     * @brief 滤波后的温度（读不到为NAN）
+     */
+    float mcuTemperature() const { return mcuFiltered; }
+    float boardTemperature() const { return boardFiltered; }
+
+private:
+    static void filter(float& state, float sample);
+    static float ramp(float temp, float start, float full);
+
+    float mcuFiltered;
+    float boardFiltered;
+    float derateLevel;
+    bool overLimit;
+    volatile uint8_t heaterMax;     // 安全监控任务写、控制任务读（单字节）
+    volatile uint8_t pumpMax;
+};
+
+#endif // BOARD_DERATING_H
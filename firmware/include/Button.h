@@ -27,6 +27,23 @@ public:
      */
     void update();
     
+    /**
+     * @brief 电平变化时调用 isr（双边沿），用于空闲时不轮询、由中断唤醒扫描任务
+     *
+     * ESP32 上不用 attachInterrupt()：Arduino-ESP32 默认（CONFIG_ARDUINO_ISR_IRAM=0）不带 ESP_INTR_FLAG_IRAM
+     * 安装GPIO中断服务，分发函数也在闪存中，写闪存期间中断推迟到写完。这里由第一次调用以 ESP_INTR_FLAG_IRAM
+     * 安装服务，isr 经 gpio_isr_handler_add() 登记，写闪存期间照常执行，所以 isr 及其调用的函数都必须在IRAM中。
+     * 服务已被别处安装（中断标志未知）时返回 false。
+     * @param isr 中断处理函数（IRAM_ATTR）
+     * @return false 登记失败
+     */
+    bool attachEdgeInterrupt(void (*isr)());
+    
+    /**
+     * @brief 是否空闲（未按下且不在消抖中），空闲时无需调用 update()
+     */
+    bool isIdle() const;
+    
     /**
      * @brief 是否按下（单次触发）
      * @return true 按键被按下
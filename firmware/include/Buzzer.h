@@ -1,12 +1,18 @@
 /**
  * @file Buzzer.h
  * @brief 蜂鸣器控制
+ *
+ * 音型（提示音、警告音、错误音）由 FreeRTOS 单次软件定时器逐个音符播放，调用立即返回：
+ * 安全监控任务报警时不会在 delay() 中停留一秒，错过自己的检查周期（见 ResponseTime.h）。
+ * 新的音型打断正在播放的音型。
  */
 
 #ifndef BUZZER_H
 #define BUZZER_H
 
 #include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/timers.h>
 
 class Buzzer {
 public:
@@ -18,12 +24,12 @@ public:
     Buzzer(uint8_t pin, uint8_t pwm_channel);
     
     /**
-     * @brief 初始化
+     * @brief 初始化（创建音型定时器）
      */
     void begin();
     
     /**
-     * @brief 播放音调
+     * @brief 播放音调（不阻塞）
      * @param frequency 频率（Hz）
      * @param duration 持续时间（ms），0表示持续播放
      */
@@ -50,8 +56,31 @@ public:
     void error();
     
 private:
+    /**
+     * @brief 音符（频率为0表示静音）
+     */
+    struct Note {
+        uint16_t frequency;
+        uint16_t durationMs;
+    };
+    
+    static const Note BEEP_NOTES[];
+    static const Note WARNING_NOTES[];
+    static const Note ERROR_NOTES[];
+    
+    void play(const Note* notes, uint8_t count);
+    void startNote();                   // 调用方负责挂起调度器
+    static void onTimer(TimerHandle_t timer);
+    void step();
+    
     uint8_t buzzerPin;
     uint8_t pwmChannel;
+    TimerHandle_t timer;
+    Note single;                        // tone() 的单音符音型
+    const Note* pattern;
+    uint8_t patternLength;
+    uint8_t noteIndex;
+    uint32_t noteStart;                 // 当前音符开始时刻 (ms)
 };
 
 #endif // BUZZER_H
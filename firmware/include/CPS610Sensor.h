@@ -0,0 +1,63 @@
+/**
+ * @file CPS610Sensor.h
+ * @brief CPS610DSD003DH01压力传感器驱动（-3kPa ~ +3kPa）
+ * 
+ * 通信协议:
+ * - I2C地址: 0x7F
+ * - 命令寄存器: 0x30
+ * - 数据寄存器: 0x06-0x08 (24位)
+ * - 转换公式: P(kPa) = 7.5 * Code - 3.75
+ *   其中 Code = P_raw / 8388608.0
+ */
+
+#ifndef CPS610_SENSOR_H
+#define CPS610_SENSOR_H
+
+#include <Arduino.h>
+#include "PressureSensorBase.h"
+
+class CPS610Sensor : public PressureSensorBase<CPS610Sensor> {
+public:
+    static const uint8_t DEFAULT_ADDR = 0x7F;
+
+    /**
+     * @brief 构造函数
+     * @param sda_pin I2C SDA引脚
+     * @param scl_pin I2C SCL引脚
+     * @param i2c_addr I2C地址（0表示默认0x7F）
+     */
+    CPS610Sensor(uint8_t sda_pin, uint8_t scl_pin, uint8_t i2c_addr = 0);
+    
+    const char* modelName() const { return "CPS610DSD003DH01"; }
+    
+    /**
+     * @brief 读取原始24位数据（调试用）
+     * @return 原始压力值（有符号24位整数），出错返回0x7FFFFFFF
+     */
+    int32_t readRaw24bit();
+    
+private:
+    friend class PressureSensorBase<CPS610Sensor>;
+    
+    // CPS610DSD003DH01 命令
+    static const uint8_t CMD_START = 0x0A;    // 启动采集
+    static const uint8_t CONVERSION_TIME_MS = 8;  // 采集时间 5-10ms
+    
+    // CPS610DSD003DH01 计算参数
+    static constexpr float COEF_A = 7.5f;      // 传递函数系数A
+    static constexpr float COEF_B = -3.75f;    // 传递函数系数B
+    static constexpr float DIVISOR = 8388608.0f; // 2^23
+    
+    bool configure() { return true; }  // 无需配置
+    uint8_t measurementCommand() const { return CMD_START; }
+    uint32_t conversionTimeMs() const { return CONVERSION_TIME_MS; }
+    
+    /**
+     * @brief 将24位原始数据转换为压力值
+     * @param raw24 原始24位数据
+     * @return 压力值（kPa，不含零点偏移）
+     */
+    float convertToPressure(int32_t raw24) const;
+};
+
+#endif // CPS610_SENSOR_H
@@ -0,0 +1,391 @@
+/**
+ * @file ControlChannel.h
+ * @brief 多通道控制引擎（左右眼独立腔体）
+ *
+ * 每个通道绑定自己的压力传感器、热电偶、加热片和负压泵，
+ * 安全状态按通道独立维护：一路过温只关闭该路的执行器，另一路继续工作。
+ *
+ * 通道数在编译期确定（NUM_CHANNELS），通道对象存放在静态数组中，
+ * 无堆分配、无虚函数调用。传感器类型作为模板参数传入，
+ * 不同通道可以使用不同型号的传感器。
+ *
+ * 采样错峰：周期为 T、共 N 个通道时，采样任务每 T/N 只服务一个通道，
+ * 共享的 I2C/SPI 总线上同一时刻只有一个通道的事务，每个通道仍保持周期 T，
+ * 增加一个通道只增加该通道自身的计算量。
+ *
+ * 样本发布：每次采集后把加热片温度、变化率、冷端温度（板温）、负压连同
+ * 采集时刻和质量发布到本通道的 SampleHub（见 SampleHub.h），其他任务无锁读取。
+ * 压力任务据板温扣除压力传感器的零点温漂（见 PressureDriftCompensator.h），
+ * 据加热片温度及其变化率做气体定律前馈（见 PressureController.h）；
+ * 样本过期或采集失败时两者都暂停（按NAN处理），不沿用旧值。
+ *
+ * 预热：系统处于预热模式时加热从关闭变为开启，先全功率加热，
+ * 到学习的切换点后交给PID（见 WarmUpController.h）。PID始终带维持功率前馈，
+ * 按热模型和冷端温度（环境温度）计算（见 ThermalIdentifier.h）。
+ *
+ * 压力采集可恢复：触发转换后 servicePressure() 立即返回，压力任务在转换期间处理总线事件，
+ * 不在 delay() 中停留（见 Resumable.h）。热电偶一次SPI读取即得结果，没有转换等待，温度采集保持同步。
+ *
+ * 输出租约：加热片和泵的输出只在本类每次服务时续约，采集失败提前返回时不续约，
+ * 连续漏掉两次采样后由租约监视定时器清零（见 OutputLease.h）。
+ *
+ * 磨损趋势：压力任务每次采样后交给 WearTracker 提取本次疗程的泵/密封指纹，
+ * 疗程结束时由压力任务写入 WearHistory 并计算趋势（见 WearHistory.h）。
+ */
+
+#ifndef CONTROL_CHANNEL_H
+#define CONTROL_CHANNEL_H
+
+#include <Arduino.h>
+#include <utility>
+#include "config.h"
+#include "HeatingController.h"
+#include "PumpController.h"
+#include "PressureController.h"
+#include "PressureDriftCompensator.h"
+#include "RateEstimator.h"
+#include "WarmUpController.h"
+#include "WearTracker.h"
+#include "WearHistory.h"
+#include "SampleHub.h"
+
+/**
+ * @brief 单个通道的硬件绑定
+ */
+struct ChannelPins {
+    uint8_t heatingPin;         // 加热片PWM引脚
+    uint8_t heatingPwmChannel;  // 加热片LEDC通道
+    uint8_t pumpPin;            // 负压泵PWM引脚
+    uint8_t pumpPwmChannel;     // 负压泵LEDC通道
+    uint8_t thermoClkPin;       // 热电偶SCK（可与其他通道共用）
+    uint8_t thermoCsPin;        // 热电偶CS（每通道独立）
+    uint8_t thermoMisoPin;      // 热电偶MISO（可与其他通道共用）
+    uint8_t pressureSdaPin;     // I2C SDA（共用总线）
+    uint8_t pressureSclPin;     // I2C SCL（共用总线）
+    uint8_t pressureAddr;       // 压力传感器I2C地址（每通道不同）
+};
+
+/**
+ * @brief 单个通道的运行状态
+ */
+struct ChannelStatus {
+    float currentTemp;          // 当前温度 (°C)
+    float currentPressure;      // 当前负压 (mmHg，正值表示低于大气压)，已做温漂补偿
+    bool tempValid;             // 最近一次温度读取有效
+    bool pressureValid;         // 最近一次压力读取有效
+    bool overTemp;              // 本通道过温（锁存，重启前不恢复）
+};
+
+/**
+ * @brief 通道服务结果（由调用方负责打印/报警）
+ */
+enum ChannelEvent {
+    CHANNEL_EVENT_NONE = 0,
+    CHANNEL_EVENT_OVER_TEMP,        // 本次检测到过温，通道已关断
+    CHANNEL_EVENT_TEMP_ERROR,       // 温度读取失败
+    CHANNEL_EVENT_PRESSURE_ERROR,   // 压力读取失败
+    CHANNEL_EVENT_WARMUP_DONE,      // 预热观察结束，可通过 warmUp().takeReport() 取得报告
+    CHANNEL_EVENT_PRESSURE_PENDING  // 压力转换中，到 pressureWakeAt() 以相同参数再调用 servicePressure()
+};
+
+template <class PressureSensorT, class TemperatureSensorT>
+class ControlChannel {
+public:
+    /**
+     * @brief 构造函数
+     * @param index 通道编号（0起）
+     * @param pins 通道硬件绑定
+     */
+    ControlChannel(uint8_t index, const ChannelPins& pins)
+        : channelIndex(index),
+          pressureSensor(pins.pressureSdaPin, pins.pressureSclPin, pins.pressureAddr),
+          tempSensor(pins.thermoClkPin, pins.thermoCsPin, pins.thermoMisoPin),
+          heater(pins.heatingPin, pins.heatingPwmChannel),
+          pump(pins.pumpPin, pins.pumpPwmChannel),
+          status{0.0f, 0.0f, false, false, false},
+          ventedSince(0) {
+    }
+
+    /**
+     * @brief 初始化本通道的传感器和执行器
+     * @return true 两个传感器都就绪
+     */
+    bool begin() {
+        status.tempValid = tempSensor.begin();
+        status.pressureValid = pressureSensor.begin();
+        primeSamples();
+
+        heater.begin();
+        heater.setTargetTemperature(TEMP_TARGET_DEFAULT);
+        pump.begin();
+        drift.begin(channelIndex);
+        warmup.begin(channelIndex);
+        wearLog.begin(channelIndex);
+
+        return status.tempValid && status.pressureValid;
+    }
+
+    /**
+     * @brief 以传感器最近一次的读数发布首个样本，状态机处理启动事件时就有数据
+     *
+     * begin() 中调用；上电自检之后再调用一次（自检期间不发布，初始化时的样本已过期）。
+     */
+    void primeSamples() {
+        uint32_t now = millis();
+        hub.publish(TOPIC_PAD_TEMP, status.tempValid ? tempSensor.getLastTemperature() : NAN, now);
+        hub.publish(TOPIC_PRESSURE, status.pressureValid ? -pressureSensor.getLastPressure() * KPA_TO_MMHG : NAN, now);
+    }
+
+    /**
+     * @brief 温度采样 + PID + 本通道过温保护
+     * @param allowHeating 系统是否允许加热（未急停且运行中）
+     * @param warmUp 系统处于预热模式（加热开启时先全功率）
+     */
+    ChannelEvent serviceTemperature(bool allowHeating, bool warmUp = false) {
+        float temp = tempSensor.readTemperature();
+        uint32_t now = millis();
+        if (isnan(temp)) {
+            status.tempValid = false;
+            tempRate.reset();
+            // 采集失败也要发布：读取方据此区分"传感器故障"和"任务卡住"
+            hub.publishFault(TOPIC_PAD_TEMP, now);
+            hub.publishFault(TOPIC_PAD_TEMP_RATE, now);
+            return CHANNEL_EVENT_TEMP_ERROR;
+        }
+        if (!tempSensor.isFresh()) {
+            // 单次读取出错，驱动沿用上次读数：不发布、不跑PID，加热输出不续约，
+            // 连续出错时在 HEATER_LEASE_MS 后由租约清零（见 OutputLease.h）；停止加热不依赖读数
+            if (!allowHeating && heater.isEnabled()) {
+                warmup.cancel();
+                heater.disable();
+            }
+            return CHANNEL_EVENT_NONE;
+        }
+
+        status.currentTemp = temp;
+        status.tempValid = true;
+        
+        // 发布温度及变化率（压力前馈用，窗口未满时变化率为NAN）
+        tempRate.add(now, temp);
+        hub.publish(TOPIC_PAD_TEMP, temp, now);
+        hub.publish(TOPIC_PAD_TEMP_RATE, tempRate.slope(), now);
+
+        // 发布板温（与本次热端读数同一帧，不会触发额外的SPI读取；MAX6675 始终为NAN）
+        hub.publish(TOPIC_BOARD_TEMP, tempSensor.readInternalTemperature(), now);
+
+        // 过温只关断本通道
+        if (temp >= TEMP_EMERGENCY_STOP) {
+            if (!status.overTemp) {
+                status.overTemp = true;
+                shutdown();
+                return CHANNEL_EVENT_OVER_TEMP;
+            }
+            return CHANNEL_EVENT_NONE;
+        }
+
+        if (allowHeating && !status.overTemp) {
+            if (!heater.isEnabled()) {
+                heater.enable();
+                if (warmUp) {
+                    warmup.start(temp, millis());
+                }
+            }
+            // 环境温度取冷端温度；维持功率在全功率阶段结束时按辨识结果更新，
+            // 所以在 warmup.update() 之后计算
+            float board = hub.readValue(TOPIC_BOARD_TEMP, now, SampleHub::maxAge(TOPIC_BOARD_TEMP));
+            float ambient = isnan(board) ? THERMAL_AMBIENT_FALLBACK : board;
+            float target = heater.getTargetTemperature();
+            WarmUpAction action = warmup.update(temp, tempRate.slope(), target, ambient,
+                                                heater.getOutput(), now);
+            float hold = warmup.getHoldingOutput(target, ambient);
+            heater.setFeedForward(hold);
+            if (action == WARMUP_FULL_POWER) {
+                heater.driveOpenLoop(temp, 255);
+            } else if (action == WARMUP_COAST) {
+                heater.driveOpenLoop(temp, (uint8_t)(hold + 0.5f));
+            } else {
+                heater.update(temp);
+            }
+        } else {
+            warmup.cancel();
+            if (heater.isEnabled()) {
+                heater.disable();
+            }
+        }
+
+        return warmup.hasReport() ? CHANNEL_EVENT_WARMUP_DONE : CHANNEL_EVENT_NONE;
+    }
+
+    /**
+     * @brief 压力采样 + 泵控制（可恢复）
+     *
+     * 第一次调用触发转换并返回 CHANNEL_EVENT_PRESSURE_PENDING，调用方在转换期间处理别的事情，
+     * 到 pressureWakeAt() 再调用一次完成读取和泵控制。转换时间为0的配置（XGZP6897D 周期模式）一次完成。
+     * @param allowPump 系统是否允许抽气
+     * @param targetPressure 目标负压 (mmHg)
+     * @param vented 泄压完成后回到待机、此后未离开待机（腔体确认通大气，可学习零点）
+     */
+    ChannelEvent servicePressure(bool allowPump, float targetPressure, bool vented = false) {
+        if (pressureSensor.resumeSample(millis()) == RESUME_PENDING) {
+            return CHANNEL_EVENT_PRESSURE_PENDING;
+        }
+        float rawKPa = pressureSensor.sampleResult();
+        uint32_t now = millis();
+        if (isnan(rawKPa)) {
+            status.pressureValid = false;
+            hub.publishFault(TOPIC_PRESSURE, now);
+            return CHANNEL_EVENT_PRESSURE_ERROR;
+        }
+        if (!pressureSensor.isFresh()) {
+            // 同温度：沿用的读数不发布、不学习零点、不刷新泵速，连续出错时泵输出在 PUMP_LEASE_MS 后清零
+            if ((!allowPump || status.overTemp) && pump.isRunning()) {
+                pump.stop();
+            }
+            return CHANNEL_EVENT_NONE;
+        }
+
+        // 零点温漂：泄压完成回到待机 PRESSURE_DRIFT_SETTLE_MS 后腔体已通大气，平稳读数的平均值即零点偏移；
+        // 保持中或未泄压的密封腔体不采样。板温过期（温度任务卡住或冷端读取失败）时不学习、不补偿
+        float board = hub.readValue(TOPIC_BOARD_TEMP, now, SampleHub::maxAge(TOPIC_BOARD_TEMP));
+        if (!vented || pump.isRunning()) {
+            ventedSince = 0;
+            drift.discardWindow();
+        } else if (ventedSince == 0) {
+            ventedSince = now;
+        } else if ((now - ventedSince) >= PRESSURE_DRIFT_SETTLE_MS) {
+            drift.observe(rawKPa, board);
+        }
+        drift.saveIfDirty(now);
+        float pressureKPa = drift.compensate(rawKPa, board);
+
+        // 传感器输出为表压(kPa)，负压时为负值；换算成负压幅值(mmHg)
+        float pressure = -pressureKPa * KPA_TO_MMHG;
+        status.currentPressure = pressure;
+        status.pressureValid = true;
+        hub.publish(TOPIC_PRESSURE, pressure, now);
+
+        float padTemp = hub.readValue(TOPIC_PAD_TEMP, now, SampleHub::maxAge(TOPIC_PAD_TEMP));
+        if (allowPump && !status.overTemp) {
+            if (!pump.isRunning()) {
+                pressureCtrl.reset();
+                pump.start();
+            }
+
+            // PI + 温度耦合前馈（加热片样本过期时前馈暂停）
+            // 泵速不变也要写：每次写入为输出续约（见 PumpController.h）
+            float padTempRate = hub.readValue(TOPIC_PAD_TEMP_RATE, now, SampleHub::maxAge(TOPIC_PAD_TEMP_RATE));
+            pump.setSpeed(pressureCtrl.update(targetPressure, pressure, padTemp, padTempRate));
+        } else if (pump.isRunning()) {
+            pump.stop();
+        }
+
+        wear.observe(now, pump.isRunning(), pump.getSpeed(), targetPressure, pressure, padTemp);
+
+        return CHANNEL_EVENT_NONE;
+    }
+
+    /**
+     * @brief 挂起中的压力采样下次恢复的时刻 (ms)
+     */
+    uint32_t pressureWakeAt() const { return pressureSensor.sampleWakeAt(); }
+
+    /**
+     * @brief 立即关闭本通道的加热和泵
+     */
+    void shutdown() {
+        heater.emergencyStop();
+        pump.stop();
+    }
+
+    uint8_t index() const { return channelIndex; }
+    const ChannelStatus& getStatus() const { return status; }
+    HeatingController& heating() { return heater; }
+    PumpController& pumpController() { return pump; }
+    PressureController& pressureControl() { return pressureCtrl; }
+    PressureSensorT& pressure() { return pressureSensor; }
+    TemperatureSensorT& temperature() { return tempSensor; }
+    PressureDriftCompensator& driftCompensator() { return drift; }
+    WarmUpController& warmUp() { return warmup; }
+    WearTracker& wearTracker() { return wear; }
+    WearHistory& wearHistory() { return wearLog; }
+    const SampleHub& samples() const { return hub; }
+
+private:
+    uint8_t channelIndex;
+    PressureSensorT pressureSensor;
+    TemperatureSensorT tempSensor;
+    HeatingController heater;
+    PumpController pump;
+    PressureController pressureCtrl;
+    ChannelStatus status;
+    PressureDriftCompensator drift;
+    WarmUpController warmup;
+    WearTracker wear;           // 本次疗程的泵/密封指纹（压力任务）
+    WearHistory wearLog;        // 历次疗程指纹与趋势（压力任务）
+    SampleHub hub;              // 温度任务发布温度/变化率/板温，压力任务发布负压
+    RateEstimator<TEMP_RATE_WINDOW> tempRate;
+    uint32_t ventedSince;       // 本次泄压完成回到待机后的第一次采样时间，0 = 未确认通大气
+};
+
+/**
+ * @brief 通道组（静态数组 + 错峰调度）
+ * @tparam N 通道数
+ * @tparam ChannelT 通道类型（ControlChannel<...>）
+ */
+template <size_t N, class ChannelT>
+class ChannelBank {
+public:
+    static_assert(N > 0, "at least one channel required");
+
+    explicit ChannelBank(const ChannelPins (&pins)[N])
+        : ChannelBank(pins, std::make_index_sequence<N>()) {
+    }
+
+    static constexpr size_t size() { return N; }
+
+    /**
+     * @brief 错峰后的服务间隔：每个间隔只服务一个通道
+     * @param periodMs 单通道采样周期 (ms)
+     */
+    static constexpr uint32_t slotPeriodMs(uint32_t periodMs) {
+        return (periodMs / N) > 0 ? (periodMs / N) : 1;
+    }
+
+    ChannelT& operator[](size_t i) { return channels[i]; }
+    const ChannelT& operator[](size_t i) const { return channels[i]; }
+
+    /**
+     * @brief 初始化所有通道
+     * @return true 所有通道传感器就绪
+     */
+    bool beginAll() {
+        bool ok = true;
+        for (size_t i = 0; i < N; i++) {
+            ok = channels[i].begin() && ok;
+        }
+        return ok;
+    }
+
+    void shutdownAll() {
+        for (size_t i = 0; i < N; i++) {
+            channels[i].shutdown();
+        }
+    }
+
+    bool anyOverTemp() const {
+        for (size_t i = 0; i < N; i++) {
+            if (channels[i].getStatus().overTemp) return true;
+        }
+        return false;
+    }
+
+private:
+    template <size_t... I>
+    ChannelBank(const ChannelPins (&pins)[N], std::index_sequence<I...>)
+        : channels{ ChannelT(I, pins[I])... } {
+    }
+
+    ChannelT channels[N];
+};
+
+#endif // CONTROL_CHANNEL_H
@@ -0,0 +1,138 @@
+/**
+ * @file DeltaPatch.h
+ * @brief 固件差分格式与流式应用（固件升级用，主机工具共用）
+ *
+ * 差分 = 头 (DELTA_HEADER_LEN 字节) + 操作流。新镜像由操作依次拼出：
+ * - COPY    [0x01][源偏移差 zigzag varint][长度 varint]  从正在运行的镜像复制
+ *           源偏移差相对上一个 COPY 的结束位置，顺序复制时只占 1 字节
+ * - LITERAL [0x02][长度 varint][数据]                     新数据
+ * 完整镜像就是只有 LITERAL 的差分（源大小为0）。多字节字段小端，varint 为 LEB128。
+ *
+ * 应用是逐段进行的：step() 处理到输入用完或输出缓冲满为止，状态是普通结构体，
+ * 可以在任意字节处保存到 NVS、重启后从该处继续（断点续传）。不依赖 Arduino，无堆分配。
+ */
+
+#ifndef DELTA_PATCH_H
+#define DELTA_PATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Sha256.h"
+
+#define DELTA_MAGIC         0x544C4447u     // "GDLT"
+#define DELTA_VERSION       1
+#define DELTA_HEADER_LEN    84
+
+enum DeltaOp : uint8_t {
+    DELTA_OP_COPY = 0x01,
+    DELTA_OP_LITERAL = 0x02
+};
+
+/**
+ * @brief 差分头（也是升级开始请求的参数）
+ */
+struct DeltaHeader {
+    uint32_t sourceSize;                    // 源镜像（正在运行的镜像）字节数，0 = 完整镜像
+    uint8_t sourceSha[SHA256_DIGEST_LEN];
+    uint32_t targetSize;                    // 新镜像字节数
+    uint8_t targetSha[SHA256_DIGEST_LEN];
+    uint32_t deltaSize;                     // 操作流字节数（不含头）
+};
+
+/**
+ * @return 写入的字节数（DELTA_HEADER_LEN）
+ */
+size_t deltaHeaderEncode(const DeltaHeader& h, uint8_t* out);
+
+/**
+ * @return false 魔数、版本或长度不对
+ */
+bool deltaHeaderDecode(const uint8_t* in, size_t len, DeltaHeader& h);
+
+/**
+ * @brief varint 编码（out 至少 5 字节）
+ * @return 字节数
+ */
+size_t deltaPutVarint(uint8_t* out, uint32_t value);
+
+inline uint32_t deltaZigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+inline int32_t deltaUnzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+/**
+ * @brief 从源镜像读取（返回 false 表示读失败）
+ */
+typedef bool (*DeltaSourceReader)(void* ctx, uint32_t offset, uint8_t* buf, size_t len);
+
+enum DeltaError : uint8_t {
+    DELTA_OK = 0,
+    DELTA_ERR_BAD_OP,           // 未知操作码
+    DELTA_ERR_VARINT,           // varint 超过 5 字节
+    DELTA_ERR_SOURCE_RANGE,     // COPY 超出源镜像
+    DELTA_ERR_TARGET_OVERFLOW,  // 输出超过新镜像大小
+    DELTA_ERR_INPUT_OVERFLOW,   // 输入超过操作流大小
+    DELTA_ERR_SOURCE_READ       // 读源镜像失败
+};
+
+/**
+ * @brief 应用进度（可整块保存，重启后 restore() 继续）
+ */
+struct DeltaApplierState {
+    uint32_t inputPos;          // 已处理的操作流字节
+    uint32_t outputPos;         // 已输出的新镜像字节
+    uint32_t copyEnd;           // 上一个 COPY 的源结束位置
+    uint32_t remaining;         // 当前 COPY/LITERAL 还剩的字节
+    uint32_t srcPos;            // 当前 COPY 的源位置
+    uint32_t arg;               // 正在读取的 varint
+    uint32_t args[2];
+    uint8_t stage;
+    uint8_t op;
+    uint8_t shift;
+    uint8_t argIndex;
+};
+
+class DeltaApplier {
+public:
+    DeltaApplier();
+
+    /**
+     * @brief 开始应用（源/新镜像大小和操作流长度取自头）
+     */
+    void begin(const DeltaHeader& header);
+
+    /**
+     * @brief 从检查点继续（头须与保存时相同）
+     */
+    void restore(const DeltaHeader& header, const DeltaApplierState& saved);
+
+    /**
+     * @brief 处理输入并输出，直到输入用完或输出缓冲满
+     * @param consumed 本次消耗的输入字节
+     * @param produced 本次写入 out 的字节
+     * @return false 差分错误，见 error()
+     */
+    bool step(const uint8_t* in, size_t len, size_t& consumed,
+              uint8_t* out, size_t outCap, size_t& produced,
+              DeltaSourceReader read, void* ctx);
+
+    /**
+     * @brief 操作流已全部处理且输出了完整的新镜像
+     */
+    bool done() const;
+
+    const DeltaApplierState& state() const { return st; }
+    DeltaError error() const { return err; }
+
+    static const char* errorName(DeltaError e);
+
+private:
+    uint32_t sourceSize;
+    uint32_t targetSize;
+    uint32_t deltaSize;
+    DeltaApplierState st;
+    DeltaError err;
+
+    bool fail(DeltaError e) { err = e; return false; }
+    bool startOp();
+};
+
+#endif // DELTA_PATCH_H
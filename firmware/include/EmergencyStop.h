@@ -0,0 +1,76 @@
+/**
+ * @file EmergencyStop.h
+ * @brief 急停快速路径（STOP中断直接关断执行器输出引脚）
+ *
+ * STOP按下时，中断处理函数不等任务调度，直接把加热片和泵的输出引脚从LEDC断开并拉低，
+ * 然后通知状态机任务锁存急停；状态机任务再按正常流程关断各控制器。
+ * 离开锁存（UP+DOWN复位）时由状态机任务调用 rearm() 把引脚交还给LEDC。
+ *
+ * 中断路径只用IRAM和ROM中的代码：GPIO寄存器操作是内联的，GPIO矩阵函数在ROM中。
+ * 中断经 Button::attachEdgeInterrupt() 登记，GPIO中断服务以 ESP_INTR_FLAG_IRAM 安装，
+ * 写闪存期间也立即执行（Arduino 的 attachInterrupt() 在 CONFIG_ARDUINO_ISR_IRAM=0 时会推迟到写完）。
+ * 中断标志由审计构建检查（scripts/iram_audit.py）。
+ *
+ * 不消抖：任何一次STOP下降沿都锁存急停，误触发只需复位，不会漏掉真正的急停。
+ * 界面任务的消抖扫描仍然重发 EVT_ESTOP，作为中断路径之外的第二条路径。
+ */
+
+#ifndef EMERGENCY_STOP_H
+#define EMERGENCY_STOP_H
+
+#include <Arduino.h>
+#include "config.h"
+
+class EmergencyStop {
+public:
+    static const uint8_t MAX_OUTPUTS = 2 * NUM_CHANNELS;   // 每通道加热片 + 泵
+
+    /**
+     * @param stop_pin STOP按键引脚（低电平有效）
+     */
+    explicit EmergencyStop(uint8_t stop_pin);
+
+    /**
+     * @brief 登记一个由急停关断的输出（在挂中断之前调用）
+     * @return false 超过 MAX_OUTPUTS
+     */
+    bool addOutput(uint8_t pin, uint8_t pwm_channel);
+
+    /**
+     * @brief 中断中调用：STOP为低电平时关断全部输出
+     * @return true 已关断（需要通知状态机任务）
+     */
+    bool trip();
+
+    /**
+     * @brief 取出并清除"中断已触发"标志（状态机任务调用）
+     */
+    bool takePending();
+
+    /**
+     * @brief 把输出引脚交还给LEDC（离开急停锁存时调用，占空比由各控制器重新写入）
+     */
+    void rearm();
+
+    /**
+     * @brief 输出引脚当前是否被急停接管
+     */
+    bool isCut() const { return cut; }
+
+    uint32_t getTripCount() const { return tripCount; }
+
+private:
+    struct Output {
+        uint8_t pin;
+        uint8_t pwmChannel;
+    };
+
+    uint8_t stopPin;
+    Output outputs[MAX_OUTPUTS];
+    uint8_t outputCount;
+    volatile bool pending;      // 中断置位、状态机任务清除（单字节读写，不需要原子读-改-写）
+    volatile bool cut;
+    volatile uint32_t tripCount;
+};
+
+#endif // EMERGENCY_STOP_H
@@ -0,0 +1,225 @@
+/**
+ * @file EventBus.h
+ * @brief 静态事件总线（固定事件池 + 编译期订阅表 + 任务通知投递）
+ *
+ * 子系统之间的离散事件（状态机输入、模式转移、档位变化、报警）经总线发布：
+ * - 事件池：BUS_POOL_SIZE 个静态槽位，发布时复制一次到池中，
+ *   所有订阅者拿到同一个槽位的指针（零拷贝），最后一个订阅者释放后回收
+ * - 订阅表：每个主题的订阅者在编译期确定（BUS_ROUTES），运行时不注册、不分配
+ * - 投递：槽位编号放入订阅者的邮箱（定长环形缓冲），再以任务通知唤醒订阅者，
+ *   订阅者阻塞在 xTaskNotifyWait 上，不轮询
+ * - 延迟：发布时记录 micros()，订阅者取出事件时统计延迟（按主题记录次数、最大值、
+ *   超出 BUS_LATENCY_BUDGET_US 的次数）
+ *
+ * 池和邮箱只在任务上下文中访问，用 vTaskSuspendAll() 保护（几十条指令，不关中断）。
+ * 中断只能通过 notifyFromISR() 给订阅者发通知位（如按键边沿、急停），不直接发布事件。
+ *
+ * 延迟上界：订阅者被通知后立即就绪，延迟只取决于比它优先级高的任务的执行时间。
+ * 周期任务用 serviceUntil() 代替 vTaskDelayUntil()，在周期内随到随处理。
+ */
+
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "config.h"
+#include "SystemStateMachine.h"
+
+/**
+ * @brief 事件主题
+ */
+enum BusTopic : uint8_t {
+    BUS_SYSTEM_EVENT = 0,   // 状态机输入（任意任务发布）
+    BUS_MODE_CHANGED,       // 模式转移（状态机任务发布）
+    BUS_GEAR_CHANGED,       // 负压档位变化（界面任务发布）
+    BUS_ALARM,              // 报警（控制任务发布）
+    BUS_TOPIC_COUNT
+};
+
+/**
+ * @brief 订阅者（每个订阅者是一个任务）
+ */
+enum BusSubscriber : uint8_t {
+    SUB_SUPERVISOR = 0,     // 状态机任务
+    SUB_PRESSURE,           // 压力控制任务
+    SUB_UI,                 // 用户界面任务（只接收按键中断通知）
+    SUB_SAFETY,             // 安全监控任务（报警和提示音）
+    BUS_SUBSCRIBER_COUNT
+};
+
+/**
+ * @brief 报警类型
+ */
+enum BusAlarm : uint8_t {
+    ALARM_OVER_TEMP = 0,    // 通道过温，已关断
+    ALARM_TEMP_SENSOR,      // 温度读取失败
+    ALARM_PRESSURE_SENSOR,  // 压力读取失败
+    ALARM_MAINTENANCE,      // 泵/密封磨损超限，需要维护（疗程结束时）
+    ALARM_BOARD_TEMP        // 板温/芯片温度超过硬限值，输出已关断（安全监控任务发布）
+};
+
+#define BUS_SUB(s)  (1u << (s))
+
+/**
+ * @brief 编译期订阅表：主题 -> 订阅者位图
+ */
+constexpr uint8_t BUS_ROUTES[BUS_TOPIC_COUNT] = {
+    BUS_SUB(SUB_SUPERVISOR),                        // BUS_SYSTEM_EVENT
+    BUS_SUB(SUB_PRESSURE) | BUS_SUB(SUB_SAFETY),    // BUS_MODE_CHANGED：零点学习、提示音
+    BUS_SUB(SUB_PRESSURE) | BUS_SUB(SUB_SAFETY),    // BUS_GEAR_CHANGED：目标负压、提示音
+    BUS_SUB(SUB_SAFETY),                            // BUS_ALARM：蜂鸣器
+};
+
+// 任务通知位
+#define BUS_NOTIFY_EVENT    (1u << 0)   // 邮箱中有事件
+#define BUS_NOTIFY_INPUT    (1u << 1)   // 按键边沿（中断发出）
+#define BUS_NOTIFY_ESTOP    (1u << 2)   // 急停中断已关断输出（见 EmergencyStop.h）
+#define BUS_NOTIFY_LINK     (1u << 3)   // 串口收到主机数据（见 HostLink.h）
+
+/**
+ * @brief 事件（发布时复制进事件池，订阅者只读）
+ */
+struct BusEvent {
+    BusTopic topic;
+    uint32_t postedUs;      // 发布时刻 (micros)，由 publish() 填写
+    union {
+        SystemEvent system;                                             // BUS_SYSTEM_EVENT
+        struct { SystemMode from; SystemMode to; SystemEvent cause; } mode; // BUS_MODE_CHANGED
+        struct { uint8_t level; bool atLimit; } gear;                   // BUS_GEAR_CHANGED
+        struct { BusAlarm kind; uint8_t channel; float value; } alarm;  // BUS_ALARM
+    };
+
+    static BusEvent systemEvent(SystemEvent e) {
+        BusEvent ev{};
+        ev.topic = BUS_SYSTEM_EVENT;
+        ev.system = e;
+        return ev;
+    }
+
+    static BusEvent modeChanged(SystemMode from, SystemMode to, SystemEvent cause) {
+        BusEvent ev{};
+        ev.topic = BUS_MODE_CHANGED;
+        ev.mode.from = from;
+        ev.mode.to = to;
+        ev.mode.cause = cause;
+        return ev;
+    }
+
+    /**
+     * @param atLimit 已在最高/最低档，本次按键未改变档位
+     */
+    static BusEvent gearChanged(uint8_t level, bool atLimit) {
+        BusEvent ev{};
+        ev.topic = BUS_GEAR_CHANGED;
+        ev.gear.level = level;
+        ev.gear.atLimit = atLimit;
+        return ev;
+    }
+
+    static BusEvent alarmRaised(BusAlarm kind, uint8_t channel, float value) {
+        BusEvent ev{};
+        ev.topic = BUS_ALARM;
+        ev.alarm.kind = kind;
+        ev.alarm.channel = channel;
+        ev.alarm.value = value;
+        return ev;
+    }
+};
+
+/**
+ * @brief 单个主题的投递统计
+ */
+struct BusTopicStats {
+    uint32_t delivered;     // 订阅者取出的次数
+    uint32_t dropped;       // 事件池或邮箱满而未投递的次数
+    uint32_t overBudget;    // 延迟超过 BUS_LATENCY_BUDGET_US 的次数
+    uint32_t maxLatencyUs;
+    uint64_t totalLatencyUs;
+};
+
+class EventBus {
+public:
+    EventBus();
+
+    /**
+     * @brief 登记订阅者任务（在该任务开始时调用；登记前的事件留在邮箱中）
+     */
+    void attach(BusSubscriber sub, TaskHandle_t task);
+
+    /**
+     * @brief 发布事件（任务上下文）
+     * @param urgent 插到各订阅者邮箱队首（急停）
+     * @return true 至少投递给一个订阅者
+     */
+    bool publish(const BusEvent& event, bool urgent = false);
+
+    /**
+     * @brief 等待事件或通知
+     * @param timeout 超时 (ticks)
+     * @return 收到的通知位（BUS_NOTIFY_*），超时返回0；邮箱非空时立即返回
+     */
+    uint32_t wait(BusSubscriber sub, TickType_t timeout);
+
+    /**
+     * @brief 取出一个事件（不阻塞），处理完必须调用 release()
+     * @return 事件指针，邮箱为空时返回NULL
+     */
+    const BusEvent* take(BusSubscriber sub);
+
+    void release(const BusEvent* event);
+
+    /**
+     * @brief 任务上下文中给订阅者发通知位
+     */
+    void notify(BusSubscriber sub, uint32_t bits);
+
+    /**
+     * @brief 中断中给订阅者发通知位
+     */
+    void notifyFromISR(BusSubscriber sub, uint32_t bits);
+
+    /**
+     * @brief 周期任务的等待：处理事件直到 lastWake + period，语义同 vTaskDelayUntil
+     * @param handler 事件处理函数 void(const BusEvent&)
+     * @return 期间收到的非事件通知位
+     */
+    template <class Handler>
+    uint32_t serviceUntil(BusSubscriber sub, TickType_t& lastWake, TickType_t period, Handler&& handler) {
+        TickType_t deadline = lastWake + period;
+        uint32_t otherBits = 0;
+        TickType_t now;
+        while ((int32_t)(deadline - (now = xTaskGetTickCount())) > 0) {
+            otherBits |= wait(sub, deadline - now) & ~BUS_NOTIFY_EVENT;
+            while (const BusEvent* ev = take(sub)) {
+                handler(*ev);
+                release(ev);
+            }
+        }
+        lastWake = deadline;
+        return otherBits;
+    }
+
+    const BusTopicStats& stats(BusTopic topic) const { return topicStats[topic]; }
+
+    static const char* topicName(BusTopic topic);
+
+private:
+    struct Mailbox {
+        uint8_t slots[BUS_MAILBOX_LEN];
+        uint8_t head;
+        uint8_t count;
+    };
+
+    int8_t allocate();
+    bool enqueue(Mailbox& box, uint8_t slot, bool urgent);
+
+    BusEvent pool[BUS_POOL_SIZE];
+    uint8_t refs[BUS_POOL_SIZE];        // 未释放的订阅者数，0 = 空闲
+    Mailbox mailboxes[BUS_SUBSCRIBER_COUNT];
+    TaskHandle_t tasks[BUS_SUBSCRIBER_COUNT];
+    BusTopicStats topicStats[BUS_TOPIC_COUNT];
+};
+
+#endif // EVENT_BUS_H
@@ -0,0 +1,109 @@
+/**
+ * @file FaultLog.h
+ * @brief 故障日志（NVS环形缓冲，重启后保留）
+ *
+ * 每条记录：启动序号、上电后时间、故障码、通道、相关测量值。
+ * 没有实时时钟，用启动序号区分不同次上电；启动序号在 begin() 时加1并保存。
+ * 整个环形缓冲作为一个NVS数据块保存（FAULT_LOG_LEN 条 x 16 字节），
+ * 每次记录写一次闪存，只用于低频事件（自检失败、故障锁存），不要在控制周期中调用。
+ * 多个任务可同时记录（内部互斥锁）。
+ */
+
+#ifndef FAULT_LOG_H
+#define FAULT_LOG_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "config.h"
+
+/**
+ * @brief 故障码（保存在NVS中，只能在末尾追加）
+ */
+enum FaultCode : uint8_t {
+    FAULT_NONE = 0,
+    FAULT_POST_TEMP_SENSOR,         // 自检：温度读取失败
+    FAULT_POST_TEMP_RANGE,          // 自检：温度超出合理范围或波动过大
+    FAULT_POST_COLD_JUNCTION,       // 自检：加热片与冷端（板温）温差过大
+    FAULT_POST_PRESSURE_SENSOR,     // 自检：压力读取失败
+    FAULT_POST_PRESSURE_RANGE,      // 自检：负压超出合理范围或波动过大
+    FAULT_POST_HEATER_STUCK_ON,     // 自检：未加热时温度上升（加热开关管短路）
+    FAULT_POST_HEATER_NO_RISE,      // 自检：加热脉冲无温升（加热片开路或热电偶未贴合）
+    FAULT_POST_PUMP_NO_VACUUM,      // 自检：抽气脉冲无负压（泵、气路或未佩戴）
+    FAULT_POST_ABORTED,             // 自检：被急停中断
+    FAULT_MAINT_PUMP,               // 维护：泵效率下降或抽气变慢（见 WearHistory.h）
+    FAULT_MAINT_SEAL,               // 维护：腔体泄漏率上升
+    FAULT_BOARD_OVER_TEMP,          // 运行：板温/芯片温度超过硬限值（见 BoardDerating.h）
+    FAULT_UPDATE_ROLLBACK,          // 升级：新固件试运行失败，已回到旧固件（值为 UpdateResult，见 FirmwareUpdate.h）
+    FAULT_CODE_COUNT
+};
+
+/**
+ * @brief 故障记录
+ */
+struct FaultRecord {
+    uint32_t boot;          // 启动序号
+    uint32_t uptimeMs;      // 上电后时间 (ms)
+    FaultCode code;
+    uint8_t channel;        // 通道编号，与通道无关时为 0xFF
+    float value;            // 相关测量值（温升、负压等），无则为NAN
+};
+
+class FaultLog {
+public:
+    FaultLog();
+
+    /**
+     * @brief 从NVS加载日志，启动序号加1
+     */
+    void begin();
+
+    /**
+     * @brief 追加一条记录并保存（覆盖最旧的记录）
+     */
+    void record(FaultCode code, uint8_t channel, float value);
+
+    /**
+     * @brief 记录条数
+     */
+    uint8_t count() const { return used; }
+
+    /**
+     * @brief 按新旧顺序取记录
+     * @param age 0 = 最新
+     */
+    const FaultRecord& get(uint8_t age) const;
+
+    /**
+     * @brief 本次启动的序号
+     */
+    uint32_t bootNumber() const { return boot; }
+
+    /**
+     * @brief 本次启动后记录的条数
+     */
+    uint8_t countThisBoot() const;
+
+    /**
+     * @brief 清空日志（启动序号保留）
+     */
+    void clear();
+
+    /**
+     * @brief 严重故障：需要重启才能恢复运行（维护提示不是严重故障）
+     */
+    static bool isCritical(FaultCode code);
+
+    static const char* codeName(FaultCode code);
+
+private:
+    void save();
+
+    FaultRecord records[FAULT_LOG_LEN];
+    uint8_t head;           // 下一条写入位置
+    uint8_t used;
+    uint32_t boot;
+    SemaphoreHandle_t mutex;
+};
+
+#endif // FAULT_LOG_H
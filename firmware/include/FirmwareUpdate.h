@@ -0,0 +1,126 @@
+/**
+ * @file FirmwareUpdate.h
+ * @brief 经 USB 串口的差分固件升级：断点续传、A/B 分区、试运行与回滚
+ *
+ * 主机发送差分（DeltaPatch.h），设备边接收边应用，把新镜像写入非活动的 OTA 分区：
+ * 1. UPDATE_BEGIN 带差分头。先确认正在运行的镜像就是差分的源镜像（上次升级保存的哈希，
+ *    或分段计算，期间返回 BUSY），再查 NVS 中的断点：头相同则从断点继续，应答续传偏移
+ * 2. UPDATE_DATA 按差分偏移发送。输出攒满一个扇区就擦写、回读比较并计入哈希，
+ *    每个请求最多擦写一个扇区（没用完的输入由主机从应答的偏移重发）；
+ *    每 UPDATE_CHECKPOINT_SECTORS 个扇区保存一次断点（应用进度 + 哈希状态），
+ *    断电、断线或切换模式后从最近的断点继续
+ * 3. UPDATE_FINISH 写入最后一个扇区，整个新镜像的 SHA-256 与头一致才切换启动分区，
+ *    记下试运行信息，应答发出后 UPDATE_REBOOT_DELAY_MS 重启
+ * 4. 新固件启动后处于试运行：上电自检通过则确认（记录新镜像哈希，下次升级不必重算）；
+ *    自检失败，或启动 UPDATE_TRIAL_MAX_BOOTS 次都没等到自检结果（自检前复位），
+ *    切回旧分区重启并写故障日志。结果保存在 NVS，UPDATE_STATUS 可查询
+ *
+ * 擦写闪存期间缓存关闭，所有任务停顿（扇区擦除约 RTA_FLASH_ERASE_US），
+ * 所以 BEGIN/DATA/FINISH 只在待机（加热、泵都关闭）时执行，其他模式返回 REJECTED，
+ * 会话保留，回到待机后继续；这些停顿也就不计入 ResponseTime.h 的分析。
+ * 在界面任务中调用（RpcServer 的扩展，见 main.cpp）。
+ */
+
+#ifndef FIRMWARE_UPDATE_H
+#define FIRMWARE_UPDATE_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include "config.h"
+#include "DeltaPatch.h"
+#include "FaultLog.h"
+#include "LinkProtocol.h"
+
+class FirmwareUpdate {
+public:
+    FirmwareUpdate();
+
+    /**
+     * @brief 上电时（自检之前）调用：试运行中的新固件计启动次数，超过上限直接回滚重启
+     */
+    void begin(FaultLog& log);
+
+    /**
+     * @brief 上电自检完成后调用：试运行中的新固件通过则确认，失败则回滚重启
+     */
+    void onSelfTestResult(bool passed);
+
+    /**
+     * @brief 处理升级请求（RpcServer 的扩展）
+     * @param writable 允许擦写闪存（待机）；否则 BEGIN/DATA/FINISH 返回 REJECTED
+     * @param response 完整应答 [操作][状态][数据]
+     * @return 应答长度，0 表示不是升级操作
+     */
+    size_t handle(uint8_t op, const uint8_t* args, size_t len, uint8_t* response, bool writable);
+
+    /**
+     * @brief UPDATE_FINISH 的应答已发出，到了重启时间
+     */
+    bool rebootDue(uint32_t now) const;
+
+    UpdateState state() const { return st; }
+    UpdateResult lastResult() const { return result; }
+
+    /**
+     * @brief 正在运行的分区名（app0/app1）
+     */
+    const char* runningLabel() const;
+
+    static const char* stateName(UpdateState s);
+    static const char* resultName(UpdateResult r);
+
+private:
+    /**
+     * @brief 试运行记录（NVS，FINISH 时写入，确认或回滚后删除）
+     */
+    struct Trial {
+        uint32_t slotAddress;           // 新固件所在分区
+        uint32_t previousAddress;       // 回滚目标
+        uint32_t size;                  // 新镜像字节数与哈希（确认后作为下次升级的源镜像）
+        uint8_t sha[SHA256_DIGEST_LEN];
+        uint8_t boots;                  // 试运行期间的启动次数
+    };
+
+    FaultLog* faultLog;
+    const esp_partition_t* running;
+    const esp_partition_t* target;      // 正在写入的分区
+    UpdateState st;
+    UpdateResult result;
+    Trial trial;                        // st == UPDATE_STATE_TRIAL 或刚写入时有效
+    uint32_t rebootAt;
+
+    // 进行中的会话
+    uint8_t headerBytes[DELTA_HEADER_LEN];
+    DeltaHeader header;
+    DeltaApplier applier;
+    Sha256 targetHash;                  // 已写入（回读确认）部分的哈希
+    uint8_t sector[UPDATE_SECTOR_SIZE]; // 待写入的输出；校验源镜像时作读缓冲
+    size_t sectorFill;
+
+    // 正在运行的镜像的哈希（启动后只算一次）
+    bool runningKnown;                  // runningSize/runningSha 有效
+    uint32_t runningSize;
+    uint8_t runningSha[SHA256_DIGEST_LEN];
+    Sha256 sourceHash;                  // 分段计算中
+    uint32_t sourceHashSize;            // 要计算的字节数，0 = 没有在算
+    uint32_t sourceHashed;
+
+    RpcStatus onBegin(const uint8_t* args, size_t len, uint8_t* out, size_t& outLen);
+    RpcStatus onData(const uint8_t* args, size_t len, uint8_t* out, size_t& outLen);
+    RpcStatus onFinish();
+    size_t onStatus(uint8_t* out) const;
+
+    RpcStatus checkSource(uint8_t* out, size_t& outLen);
+    RpcStatus process(const uint8_t* in, size_t len);
+    bool flushSector();
+    void saveCheckpoint();
+    void endSession(bool dropCheckpoint);
+
+    void commit();
+    void rollback(UpdateResult why);
+    void saveResult(UpdateResult r);
+
+    static bool readSource(void* ctx, uint32_t offset, uint8_t* buf, size_t len);
+};
+
+#endif // FIRMWARE_UPDATE_H
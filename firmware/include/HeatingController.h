@@ -1,12 +1,15 @@
 /**
  * @file HeatingController.h
  * @brief 加热片控制器（PID控制）
+ *
+ * 输出带租约：超过 HEATER_LEASE_MS 未经 update()/driveOpenLoop() 刷新即由定时器清零（见 OutputLease.h）。
  */
 
 #ifndef HEATING_CONTROLLER_H
 #define HEATING_CONTROLLER_H
 
 #include <Arduino.h>
+#include "OutputLease.h"
 
 class HeatingController {
 public:
@@ -35,6 +38,14 @@ public:
      */
     uint8_t update(float current_temp);
     
+    /**
+     * @brief 开环输出（预热阶段），不积分，只记录误差和时间以便无扰切换
+     * @param current_temp 当前温度（°C）
+     * @param output PWM占空比（0-255）
+     * @return 实际输出PWM占空比
+     */
+    uint8_t driveOpenLoop(float current_temp, uint8_t output);
+    
     /**
      * @brief 启用加热
      */
@@ -55,6 +66,22 @@ public:
      */
     void reset();
     
+    /**
+     * @brief 设置前馈（维持功率，PWM占空比单位），直接加到PID输出上，不受 INTEGRAL_MAX 限幅
+     */
+    void setFeedForward(float output) { feedForward = output; }
+    
+    /**
+     * @brief 输出上限（板温降额，见 BoardDerating.h），PID和开环输出都不超过此值
+     * @param limit PWM占空比（0-255）
+     */
+    void setOutputLimit(uint8_t limit) { outputLimit = limit; }
+    
+    /**
+     * @brief 当前输出PWM占空比（0-255）
+     */
+    uint8_t getOutput() const { return currentOutput; }
+    
     /**
      * @brief 设置PID参数
      */
@@ -76,14 +103,28 @@ public:
      */
     bool isEnabled() const { return enabled; }
     
+    /**
+     * @brief 获取目标温度
+     */
+    float getTargetTemperature() const { return targetTemp; }
+    
+    /**
+     * @brief 输出租约（登记到租约监视、取到期记录）
+     */
+    OutputLease& lease() { return outputLease; }
+    
 private:
     uint8_t heatingPin;
     uint8_t pwmChannel;
     float targetTemp;
     float lastError;
     float integral;
+    float feedForward;        // 维持功率前馈，积分项只需补偿模型误差
     uint8_t currentOutput;
+    uint8_t outputLimit;      // 降额后的占空比上限
     bool enabled;
+    uint32_t lastUpdateTime;  // 上次update时间（每个实例独立，多通道时互不干扰）
+    OutputLease outputLease;
     
     // PID参数 (调整后更保守,避免超调)
     float kp = 20.0f;   // 比例系数 (降低)
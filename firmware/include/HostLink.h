@@ -0,0 +1,69 @@
+/**
+ * @file HostLink.h
+ * @brief 主机链路：串口上的 RPC 请求接收与二进制帧发送（帧格式见 LinkFrame.h）
+ *
+ * 接收：串口收到数据时（USB CDC 接收事件，不轮询）调用 begin() 传入的通知函数，
+ * 由界面任务 serviceRequests() 取出完整的请求帧交给 RpcServer，应答在同一任务中发出。
+ * 每次最多处理 maxRequests 个请求，剩余数据留在串口接收缓冲中，下次再处理（背压传给主机）。
+ *
+ * 发送：整帧在串口锁内一次写出，不会与 safePrint 的文本交错。
+ * 发送缓冲放不下整帧时丢弃该帧并计数，不等待：主机不读串口时遥测任务和界面任务都不会阻塞，
+ * 丢失的应答由主机超时重发（同序号，设备返回缓存的应答）。
+ */
+
+#ifndef HOST_LINK_H
+#define HOST_LINK_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "LinkFrame.h"
+#include "LinkProtocol.h"
+#include "RpcServer.h"
+
+class HostLink {
+public:
+    struct Stats {
+        uint32_t rxFrames;
+        uint32_t rxErrors;          // CRC/COBS 错误、超长
+        uint32_t rxIgnored;         // 不是请求帧
+        uint32_t txFrames;
+        uint32_t txDropped;         // 发送缓冲不足而丢弃
+    };
+
+    HostLink();
+
+    /**
+     * @param serialMutex 与 safePrint 共用的串口锁
+     * @param onReceive 串口收到数据时调用（接收事件的任务上下文）
+     */
+    void begin(SemaphoreHandle_t serialMutex, void (*onReceive)());
+
+    /**
+     * @brief 处理已收到的请求（界面任务调用）
+     * @return 处理的请求数
+     */
+    size_t serviceRequests(RpcServer& server, size_t maxRequests);
+
+    /**
+     * @brief 串口接收缓冲中还有未处理的数据
+     */
+    bool hasPendingInput();
+
+    /**
+     * @brief 发送一帧（任意任务，不阻塞）
+     * @return false 发送缓冲不足，已丢弃
+     */
+    bool send(LinkFrameType type, uint8_t seq, const uint8_t* payload, size_t len);
+
+    Stats counters() const;
+
+private:
+    SemaphoreHandle_t mutex;
+    LinkDecoder decoder;
+    uint32_t txFrames;          // 串口锁内更新
+    uint32_t txDropped;
+    uint32_t rxIgnored;
+};
+
+#endif // HOST_LINK_H
@@ -0,0 +1,106 @@
+/**
+ * @file HotPath.h
+ * @brief 热路径的IRAM放置与回路执行时间统计
+ *
+ * ESP32-C3 的代码默认在外部闪存中，经指令缓存执行：
+ * - 缓存未命中时每条缓存行要从SPI闪存读取，控制回路的执行时间随缓存状态抖动
+ * - 写闪存（NVS保存学习值）期间缓存关闭，闪存中的代码完全不能执行
+ *
+ * 控制更新函数（PID、前馈、占空比换算）用 HOT_PATH 标记放入IRAM，消除缓存未命中的抖动；
+ * 它们调用的 ledcWrite()、millis() 等框架函数仍在闪存中，由审计构建列出
+ * （pio run -e iram_audit，见 scripts/iram_audit.py）。
+ * 急停中断路径不依赖此开关，始终在IRAM（见 EmergencyStop.h）。
+ *
+ * 基准模式（HOT_PATH_BENCH=1，pio run -e hotpath_bench）：后台任务交替"不写 / 连续写NVS"，
+ * 每个阶段结束时打印控制回路的最坏执行时间和周期抖动，对比闪存写入的影响。
+ */
+
+#ifndef HOT_PATH_H
+#define HOT_PATH_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#if HOT_PATH_IRAM
+#define HOT_PATH    IRAM_ATTR
+#else
+#define HOT_PATH
+#endif
+
+/**
+ * @brief 回路执行时间统计（基准模式以外为空操作）
+ *
+ * begin()/end() 由回路所在任务调用；snapshot() 由基准任务在调度器挂起时调用。
+ * 回路中途挂起（等待传感器转换）时用 pause()/resume() 扣除挂起时间，统计的是执行时间。
+ */
+class LoopTimer {
+public:
+    struct Stats {
+        uint32_t samples;
+        uint32_t worstUs;       // 最坏执行时间
+        uint32_t meanUs;
+        uint32_t jitterUs;      // 相邻两次开始时刻与标称周期的最大偏差
+    };
+
+    /**
+     * @param period_us 标称周期 (µs)
+     */
+    explicit LoopTimer(uint32_t period_us)
+        : periodUs(period_us), startUs(0), lastStartUs(0), pausedUs(0), count(0),
+          worstUs(0), totalUs(0), jitterUs(0) {
+    }
+
+    void begin() {
+        if (!HOT_PATH_BENCH) return;
+        startUs = micros();
+        if (lastStartUs != 0) {
+            uint32_t interval = startUs - lastStartUs;
+            uint32_t dev = interval > periodUs ? interval - periodUs : periodUs - interval;
+            if (dev > jitterUs) jitterUs = dev;
+        }
+        lastStartUs = startUs;
+    }
+
+    void pause() {
+        if (!HOT_PATH_BENCH) return;
+        pausedUs += micros() - startUs;
+    }
+
+    void resume() {
+        if (!HOT_PATH_BENCH) return;
+        startUs = micros();
+    }
+
+    void end() {
+        if (!HOT_PATH_BENCH) return;
+        uint32_t dt = pausedUs + (micros() - startUs);
+        pausedUs = 0;
+        if (dt > worstUs) worstUs = dt;
+        totalUs += dt;
+        count++;
+    }
+
+    /**
+     * @brief 取出本阶段统计并清零（调用方负责挂起调度器）
+     */
+    Stats snapshot() {
+        Stats s{count, worstUs, count > 0 ? (uint32_t)(totalUs / count) : 0, jitterUs};
+        count = 0;
+        worstUs = 0;
+        totalUs = 0;
+        jitterUs = 0;
+        return s;
+    }
+
+private:
+    uint32_t periodUs;
+    uint32_t startUs;
+    uint32_t lastStartUs;
+    uint32_t pausedUs;      // 本次回路挂起前已执行的时间
+    uint32_t count;
+    uint32_t worstUs;
+    uint64_t totalUs;
+    uint32_t jitterUs;
+};
+
+#endif // HOT_PATH_H
@@ -0,0 +1,70 @@
+/**
+ * @file KTypeThermocouple.h
+ * @brief K型热电偶NIST ITS-90线性化与冷端补偿
+ * 
+ * MAX31855 按固定斜率 41.276µV/°C 把热电偶电压换算成温度：
+ *   T_reported = T_cj + V_tc / 41.276µV
+ * K型热电偶实际不是线性的，且冷端的塞贝克系数与热端不同。正确做法是：
+ *   1. 由原始计数反推热电偶电压 V_tc = (T_reported - T_cj) * 41.276µV
+ *   2. 冷端电压 E(T_cj)（NIST正向多项式）
+ *   3. T = E⁻¹(V_tc + E(T_cj))（NIST反向多项式）
+ * 
+ * 工作范围内（热端 0~83°C，冷端 0~80°C）用预计算的定点分段线性表，
+ * 只有整数乘加；超出范围时回退到完整的浮点多项式。
+ * 表与多项式的最大偏差 < 0.003°C，远小于芯片 0.25°C 的分辨率。
+ */
+
+#ifndef KTYPE_THERMOCOUPLE_H
+#define KTYPE_THERMOCOUPLE_H
+
+#include <Arduino.h>
+
+class KTypeThermocouple {
+public:
+    /**
+     * @brief 由MAX31855原始计数计算线性化温度（定点查表，超范围回退多项式）
+     * @param hot_counts 热端14位有符号计数（0.25°C/LSB）
+     * @param cold_counts 冷端12位有符号计数（0.0625°C/LSB）
+     * @return 温度（°C）
+     */
+    static float linearize(int16_t hot_counts, int16_t cold_counts);
+    
+    /**
+     * @brief 同上，全程使用浮点NIST多项式（基准/回退路径）
+     */
+    static float linearizeFull(int16_t hot_counts, int16_t cold_counts);
+    
+    /**
+     * @brief NIST正向多项式：温度 -> 热电势
+     * @param temp_c 温度（°C），-270 ~ 1372
+     * @return 热电势（mV）
+     */
+    static float voltageFromTemperature(float temp_c);
+    
+    /**
+     * @brief NIST反向多项式：热电势 -> 温度
+     * @param mv 热电势（mV），-5.891 ~ 20.644（-200 ~ 500°C）
+     * @return 温度（°C）
+     */
+    static float temperatureFromVoltage(float mv);
+    
+private:
+    static const int32_t MAX31855_NV_PER_16TH = 41276;  // 41.276µV/°C = 41276nV/°C（按1/16°C计数再右移4位）
+    
+    // 冷端正向表：0~80°C，步长4°C（64个1/16°C计数），单位nV
+    static const uint8_t CJ_TABLE_SHIFT = 6;
+    static const uint8_t CJ_TABLE_SIZE = 21;
+    static const int32_t CJ_TABLE_NV[CJ_TABLE_SIZE];
+    
+    // 反向表：0~3.407mV，步长131.072µV（2^17 nV），单位1/1024°C
+    static const uint8_t INV_TABLE_SHIFT = 17;
+    static const uint8_t INV_TABLE_SIZE = 27;
+    static const int32_t INV_TABLE_Q10[INV_TABLE_SIZE];
+    
+    /**
+     * @brief 由原始计数求热电偶电压（nV，不含冷端）
+     */
+    static int32_t thermocoupleNanovolts(int16_t hot_counts, int16_t cold_counts);
+};
+
+#endif // KTYPE_THERMOCOUPLE_H
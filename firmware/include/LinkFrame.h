@@ -0,0 +1,116 @@
+/**
+ * @file LinkFrame.h
+ * @brief 串口二进制帧：COBS 编码 + CRC16，与文本日志共用同一条 USB CDC 链路
+ *
+ * 帧内容（编码前）: [类型 1B][序号 1B][载荷 0-LINK_MAX_PAYLOAD][CRC16 2B 小端]
+ * CRC16/CCITT-FALSE（多项式 0x1021，初值 0xFFFF）覆盖类型到载荷末尾。
+ * 线上格式: 0x00 COBS(帧内容) 0x00
+ *
+ * COBS 编码后不含 0x00，文本日志（UTF-8）也不含 0x00，所以两个 0x00 之间是帧、帧外是文本，
+ * 串口监视器照常看到日志（帧显示为少量乱码），主机工具把两者分开。
+ * 从数据流中途开始接收时，解码器在第一个坏帧处重新对齐，最多丢一帧。
+ *
+ * 本文件与 LinkFrame.cpp 不依赖 Arduino，主机工具（host/）直接编译同一份代码。
+ */
+
+#ifndef LINK_FRAME_H
+#define LINK_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LINK_MAX_PAYLOAD    120     // 单帧载荷上限（字节）
+#define LINK_HEADER_LEN     2       // 类型 + 序号
+#define LINK_CRC_LEN        2
+#define LINK_MAX_RAW        (LINK_HEADER_LEN + LINK_MAX_PAYLOAD + LINK_CRC_LEN)
+#define LINK_MAX_ENCODED    (LINK_MAX_RAW + LINK_MAX_RAW / 254 + 1)    // COBS 最坏开销
+#define LINK_MAX_WIRE       (LINK_MAX_ENCODED + 2)                      // 含首尾分隔符
+
+/**
+ * @brief CRC16/CCITT-FALSE
+ * @param crc 初值（分段计算时传入上一段的结果）
+ */
+uint16_t linkCrc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF);
+
+/**
+ * @brief COBS 编码（out 至少 len + len/254 + 1 字节）
+ * @return 编码后长度
+ */
+size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out);
+
+/**
+ * @brief COBS 解码（可原地解码：out 可以等于 in）
+ * @return 解码后长度，编码非法返回0
+ */
+size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out);
+
+/**
+ * @brief 组帧：加帧头、CRC，COBS 编码，加首尾分隔符
+ * @param out 输出缓冲（至少 LINK_MAX_WIRE 字节）
+ * @return 线上字节数，载荷过长返回0
+ */
+size_t linkEncodeFrame(uint8_t type, uint8_t seq, const uint8_t* payload, size_t len, uint8_t* out);
+
+/**
+ * @brief 解码出的一帧（载荷指向解码器内部缓冲，下一次 push() 前有效）
+ */
+struct LinkFrameView {
+    uint8_t type;
+    uint8_t seq;
+    const uint8_t* payload;
+    size_t len;
+};
+
+/**
+ * @brief 逐字节解码（帧与文本分离）
+ */
+class LinkDecoder {
+public:
+    enum Result : uint8_t {
+        LINK_PUSH_TEXT = 0,     // 该字节是帧外文本
+        LINK_PUSH_CONSUMED,     // 该字节属于帧，帧未结束
+        LINK_PUSH_FRAME,        // 一帧完整且校验通过，见 frame()
+        LINK_PUSH_ERROR         // 一帧结束但 COBS/CRC 错误或超长，已丢弃
+    };
+
+    struct Stats {
+        uint32_t frames;
+        uint32_t crcErrors;     // COBS 非法或 CRC 不符
+        uint32_t overruns;      // 超过 LINK_MAX_ENCODED 仍未结束
+    };
+
+    LinkDecoder() : inFrame(false), fill(0), stats{0, 0, 0} {}
+
+    Result push(uint8_t b);
+
+    const LinkFrameView& frame() const { return view; }
+    const Stats& counters() const { return stats; }
+
+    /**
+     * @brief 丢弃未完成的帧（链路断开重连时）
+     */
+    void reset() { inFrame = false; fill = 0; }
+
+private:
+    bool inFrame;
+    size_t fill;
+    uint8_t buf[LINK_MAX_ENCODED];
+    LinkFrameView view;
+    Stats stats;
+};
+
+// ---- 小端读写（帧载荷中的多字节字段一律小端） ----
+
+inline void linkPut16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+inline void linkPut32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+inline void linkPutFloat(uint8_t* p, float v) { uint32_t u; memcpy(&u, &v, 4); linkPut32(p, u); }
+inline uint16_t linkGet16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+inline uint32_t linkGet32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+inline float linkGetFloat(const uint8_t* p) { uint32_t u = linkGet32(p); float v; memcpy(&v, &u, 4); return v; }
+
+#endif // LINK_FRAME_H
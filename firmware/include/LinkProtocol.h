@@ -0,0 +1,204 @@
+/**
+ * @file LinkProtocol.h
+ * @brief 主机链路协议：帧类型、RPC 操作与错误码、参数编号、遥测记录格式
+ *
+ * 帧格式见 LinkFrame.h。三类帧共用一条链路：
+ * - LINK_FRAME_REQUEST  主机 -> 设备，序号由主机分配
+ * - LINK_FRAME_RESPONSE 设备 -> 主机，序号与请求相同
+ * - LINK_FRAME_TELEMETRY 设备 -> 主机，序号每帧加1（主机据此统计丢帧）
+ *
+ * RPC 请求载荷:  [操作 1B][参数...]
+ * RPC 应答载荷:  [操作 1B][状态 1B][数据...]
+ *
+ * | 操作 | 请求参数 | 应答数据 |
+ * |------|----------|----------|
+ * | PING | 任意字节 | 原样返回 |
+ * | INFO | - | 协议版本、通道数、参数个数、载荷上限、运行时间 ms (u32) |
+ * | LIST | 起始序号 | 个数，逐个 [编号][标志][最小 f32][最大 f32][名称长度][名称] |
+ * | GET  | 编号... | 逐个 [编号][状态][值 f32] |
+ * | SET  | [编号][值 f32]... | 逐个 [编号][状态] |
+ * | COMMAND | 命令 | - |
+ * | UPDATE_BEGIN | 差分头（DeltaPatch.h） | 续传的差分偏移 (u32) |
+ * | UPDATE_DATA | 差分偏移 (u32)、数据 | 已处理的差分偏移 (u32)、输出偏移 (u32) |
+ * | UPDATE_STATUS | - | 状态、上次结果、运行分区、试运行启动次数 (各 u8)，差分偏移/长度、输出偏移/新镜像长度 (各 u32) |
+ * | UPDATE_FINISH | - | -（校验通过后切换启动分区并重启） |
+ * | UPDATE_ABORT | - | - |
+ *
+ * GET/SET 可一次带多个参数，逐个执行并逐个返回状态（不是事务）。
+ * 主机超时重发时沿用原序号，设备对与上一请求序号和内容都相同的请求直接重发上次应答，
+ * 命令不会执行两次。多字节字段一律小端。
+ * 升级数据按差分偏移幂等：偏移小于期望值的部分直接确认，大于期望值返回 BAD_OFFSET 和期望值，
+ * 主机可以流水线发送、出错时从期望值重发（见 FirmwareUpdate.h）。
+ *
+ * 本文件不依赖 Arduino，主机工具（host/）共用。
+ */
+
+#ifndef LINK_PROTOCOL_H
+#define LINK_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LINK_PROTOCOL_VERSION   1
+
+enum LinkFrameType : uint8_t {
+    LINK_FRAME_REQUEST = 0x01,
+    LINK_FRAME_RESPONSE = 0x02,
+    LINK_FRAME_TELEMETRY = 0x03
+};
+
+enum RpcOp : uint8_t {
+    RPC_OP_PING = 0x01,
+    RPC_OP_INFO = 0x02,
+    RPC_OP_LIST = 0x03,
+    RPC_OP_GET = 0x04,
+    RPC_OP_SET = 0x05,
+    RPC_OP_COMMAND = 0x06,
+    RPC_OP_UPDATE_BEGIN = 0x10,
+    RPC_OP_UPDATE_DATA = 0x11,
+    RPC_OP_UPDATE_STATUS = 0x12,
+    RPC_OP_UPDATE_FINISH = 0x13,
+    RPC_OP_UPDATE_ABORT = 0x14
+};
+
+enum RpcStatus : uint8_t {
+    RPC_OK = 0,
+    RPC_ERR_UNKNOWN_OP,         // 不支持的操作
+    RPC_ERR_BAD_LENGTH,         // 请求参数长度不对
+    RPC_ERR_UNKNOWN_PARAM,      // 参数编号不存在
+    RPC_ERR_READ_ONLY,          // 参数只读
+    RPC_ERR_OUT_OF_RANGE,       // 设定值超出范围（或为NAN）
+    RPC_ERR_UNKNOWN_COMMAND,    // 命令编号不存在
+    RPC_ERR_REJECTED,           // 当前模式不允许该命令（如运行中再开始）
+    RPC_ERR_TOO_LARGE,          // 应答超过单帧载荷，请分批请求；升级：新镜像超过分区大小
+    RPC_ERR_BUSY,               // 升级：正在校验运行中的镜像，稍后重发（应答带已校验字节数）
+    RPC_ERR_BAD_OFFSET,         // 升级：数据偏移不是期望值（应答带期望值）或数据未收齐
+    RPC_ERR_MISMATCH,           // 升级：源镜像与运行中的不符、差分格式错误或新镜像校验不符
+    RPC_ERR_FLASH,              // 升级：闪存擦写或回读校验失败
+    RPC_ERR_NO_SESSION          // 升级：没有进行中的升级（先 UPDATE_BEGIN）
+};
+
+/**
+ * @brief 参数编号（固件的参数表见 main.cpp）
+ */
+enum RpcParamId : uint8_t {
+    PARAM_PRESSURE_GEAR = 0,    // 负压档位 1-PRESSURE_NUM_GEARS（读写）
+    PARAM_TARGET_TEMP,          // 目标温度 °C
+    PARAM_TARGET_PRESSURE,      // 目标负压 mmHg
+    PARAM_MODE,                 // 系统模式（SystemMode）
+    PARAM_TELEMETRY_PERIOD,     // 遥测周期 ms，0 = 关闭（读写）
+    PARAM_SELF_TEST,            // 上电自检：1 通过，0 有严重故障
+    PARAM_FAULT_COUNT,          // 故障日志条数
+    PARAM_HEATER_LIMIT,         // 板温降额后的加热上限 (0-255)
+    PARAM_PUMP_LIMIT,           // 板温降额后的泵速上限 (%)
+    PARAM_COUNT
+};
+
+#define RPC_PARAM_WRITABLE  0x01    // LIST 应答中的标志位
+
+/**
+ * @brief 命令（与按键操作对应；复位急停锁存只能在设备上长按，不提供远程命令）
+ */
+enum RpcCommand : uint8_t {
+    CMD_START = 0,              // 待机时开始疗程
+    CMD_PAUSE,                  // 运行中暂停抽气
+    CMD_RESUME,                 // 暂停时恢复抽气
+    CMD_STOP,                   // 结束疗程（泄压）
+    CMD_ESTOP,                  // 急停（锁存，需在设备上复位）
+    CMD_COUNT
+};
+
+// ---- 固件升级 ----
+
+#define UPDATE_CHUNK_MAX    (LINK_MAX_PAYLOAD - 5)  // UPDATE_DATA 单帧数据（操作码 + 偏移之后）
+
+/**
+ * @brief 升级状态（UPDATE_STATUS 应答）
+ */
+enum UpdateState : uint8_t {
+    UPDATE_STATE_IDLE = 0,
+    UPDATE_STATE_VERIFYING_SOURCE,  // 正在计算运行中镜像的哈希（UPDATE_BEGIN 返回 BUSY）
+    UPDATE_STATE_RECEIVING,         // 接收差分、写入非活动分区
+    UPDATE_STATE_REBOOTING,         // 校验通过，即将重启到新固件
+    UPDATE_STATE_TRIAL              // 新固件试运行：等待上电自检结果
+};
+
+/**
+ * @brief 上次升级的结果（NVS 保存，重启后可查询）
+ */
+enum UpdateResult : uint8_t {
+    UPDATE_RESULT_NONE = 0,
+    UPDATE_RESULT_COMMITTED,        // 新固件自检通过，已确认
+    UPDATE_RESULT_ROLLBACK_SELF_TEST,   // 新固件自检失败，已回到旧固件
+    UPDATE_RESULT_ROLLBACK_BOOTS,   // 新固件多次启动都没等到自检结果，已回到旧固件
+    UPDATE_RESULT_BOOT_FAILED,      // 引导程序没有启动新固件（镜像无效）
+    UPDATE_RESULT_VERIFY_FAILED     // 写入后哈希不符，未切换
+};
+
+// ---- 遥测记录 ----
+
+#define TELEMETRY_VERSION       1
+#define TELEMETRY_MAX_CHANNELS  4
+#define TELEMETRY_INVALID       INT16_MIN   // 温度/负压无效（采集失败或样本过期）
+
+#define TELEMETRY_FLAG_SELF_TEST_OK     0x01
+#define TELEMETRY_FLAG_DERATING         0x02
+
+#define TELEMETRY_CH_TEMP_OK            0x01
+#define TELEMETRY_CH_PRESSURE_OK        0x02
+#define TELEMETRY_CH_OVER_TEMP          0x04
+#define TELEMETRY_CH_MAINTENANCE        0x08
+
+/**
+ * @brief 单通道遥测
+ */
+struct TelemetryChannel {
+    int16_t padTempCenti;       // 加热片温度 (0.01°C)
+    int16_t pressureCenti;      // 负压 (0.01 mmHg)
+    uint8_t heaterDuty;         // 加热输出 (0-255)
+    uint8_t pumpPercent;        // 泵速 (%)
+    uint8_t flags;              // TELEMETRY_CH_*
+};
+
+/**
+ * @brief 一帧遥测（编码后 13 + 7 × 通道数 字节）
+ */
+struct TelemetryRecord {
+    uint32_t uptimeMs;
+    uint8_t mode;               // SystemMode
+    uint8_t gear;
+    uint8_t flags;              // TELEMETRY_FLAG_*
+    int16_t boardTempCenti;     // 板温 (0.01°C)
+    uint8_t heaterLimit;        // 降额后的加热上限 (0-255)
+    uint8_t pumpLimit;          // 降额后的泵速上限 (%)
+    uint8_t channelCount;
+    TelemetryChannel channels[TELEMETRY_MAX_CHANNELS];
+};
+
+#define TELEMETRY_HEADER_LEN    13
+#define TELEMETRY_CHANNEL_LEN   7
+
+/**
+ * @brief 物理量 -> 0.01 单位定点数（NAN 或超出范围为 TELEMETRY_INVALID）
+ */
+int16_t telemetryCenti(float value);
+
+/**
+ * @brief 0.01 单位定点数 -> 物理量（TELEMETRY_INVALID 为 NAN）
+ */
+float telemetryFromCenti(int16_t centi);
+
+/**
+ * @brief 编码遥测记录
+ * @param out 至少 TELEMETRY_HEADER_LEN + TELEMETRY_CHANNEL_LEN × 通道数 字节
+ * @return 载荷长度
+ */
+size_t telemetryEncode(const TelemetryRecord& rec, uint8_t* out);
+
+/**
+ * @brief 解码遥测记录
+ * @return false 版本不符或长度不对
+ */
+bool telemetryDecode(const uint8_t* payload, size_t len, TelemetryRecord& rec);
+
+#endif // LINK_PROTOCOL_H
@@ -0,0 +1,99 @@
+/**
+ * @file OutputLease.h
+ * @brief 执行器输出租约（控制任务停止刷新时由定时器把输出清零）
+ *
+ * 加热片和泵的PWM输出只在控制任务写入时有效一段时间：每次写入非零占空比都续约，
+ * 超过租约时限（HEATER_LEASE_MS / PUMP_LEASE_MS）未续约，租约监视定时器直接把LEDC占空比清零，
+ * 不依赖控制任务。例如温度读取失败时温度任务跳过PID，加热片不会一直保持上次的占空比（可能是100%）。
+ * 传感器驱动在连续出错达到上限之前返回上次读数，控制任务按 isFresh() 跳过这些读数，同样不续约。
+ * 读数恢复后控制任务再次写入，输出随之恢复；归零本身不锁存，持续的传感器故障由状态机转入故障模式。
+ *
+ * 监视定时器是 FreeRTOS 软件定时器，回调在定时器服务任务中每 OUTPUT_LEASE_CHECK_MS 检查一次；
+ * 检查和清零在调度器挂起时完成，不会与控制任务的续约交错。控制任务每个周期都会阻塞，
+ * 服务任务（ESP-IDF 默认优先级1）总能运行；任务死循环占满CPU的情况由任务看门狗处理。
+ */
+
+#ifndef OUTPUT_LEASE_H
+#define OUTPUT_LEASE_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/timers.h>
+#include "config.h"
+
+class OutputLease {
+public:
+    /**
+     * @param pwm_channel 输出的LEDC通道
+     * @param window_ms 租约时限 (ms)
+     */
+    OutputLease(uint8_t pwm_channel, uint32_t window_ms);
+
+    /**
+     * @brief 续约（写入非零占空比前调用）
+     */
+    void renew(uint32_t now) {
+        renewedAt = now;
+        armed = true;
+    }
+
+    /**
+     * @brief 输出已由控制器清零，不再需要监视
+     */
+    void release() { armed = false; }
+
+    /**
+     * @brief 监视定时器调用：超时则清零输出（调用方负责挂起调度器）
+     * @return true 本次到期
+     */
+    bool check(uint32_t now);
+
+    /**
+     * @brief 取出并清除"租约已到期"标志（控制任务调用，用于打印）
+     * @param late_ms 输出：到期时距最后一次续约的时间 (ms)
+     */
+    bool takeExpiry(uint32_t& late_ms);
+
+    uint32_t getExpiryCount() const { return expiryCount; }
+    uint32_t getWindowMs() const { return windowMs; }
+
+private:
+    uint8_t pwmChannel;
+    uint32_t windowMs;
+    volatile uint32_t renewedAt;
+    volatile bool armed;            // 输出非零、需要续约
+    volatile bool expired;          // 定时器置位、控制任务清除
+    volatile uint32_t lateMs;
+    volatile uint32_t expiryCount;
+};
+
+/**
+ * @brief 租约监视（所有输出共用一个周期定时器）
+ */
+class LeaseMonitor {
+public:
+    static const uint8_t MAX_LEASES = 2 * NUM_CHANNELS;    // 每通道加热片 + 泵
+
+    LeaseMonitor();
+
+    /**
+     * @brief 登记一个租约（在 begin() 之前调用）
+     * @return false 超过 MAX_LEASES
+     */
+    bool add(OutputLease& lease);
+
+    /**
+     * @brief 创建并启动监视定时器
+     */
+    bool begin();
+
+private:
+    static void onTimer(TimerHandle_t timer);
+    void checkAll();
+
+    OutputLease* leases[MAX_LEASES];
+    uint8_t leaseCount;
+    TimerHandle_t timer;
+};
+
+#endif // OUTPUT_LEASE_H
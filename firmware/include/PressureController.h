@@ -0,0 +1,67 @@
+/**
+ * @file PressureController.h
+ * @brief 负压控制器（PI + 温度耦合前馈）
+ *
+ * 腔体密封时，加热使腔内空气升温，按气体定律绝对压力随之升高：
+ *   dP/dt = P / T * dT/dt    （P 绝对压力，T 开尔文温度）
+ * 40°C、负压15mmHg时约 2.4 mmHg/K，即每次加热功率变化都会表现为
+ * 负压回路需要事后纠正的扰动。前馈项直接用温度变化率预先补偿泵速：
+ *   u_ff = (P / T) * k * dT/dt / PRESSURE_PUMP_GAIN
+ * 其中 dT/dt 为加热片温度变化率，k = PRESSURE_FF_COUPLING 为腔内气温
+ * 跟随加热片变化的比例（另一侧是皮肤，温度基本不变）。
+ * PI 只需处理剩余误差（泄漏、模型误差）。
+ */
+
+#ifndef PRESSURE_CONTROLLER_H
+#define PRESSURE_CONTROLLER_H
+
+#include <Arduino.h>
+
+class PressureController {
+public:
+    PressureController();
+
+    /**
+     * @brief 计算泵速
+     * @param target 目标负压（mmHg）
+     * @param vacuum 当前负压（mmHg，正值表示低于大气压）
+     * @param gas_temp 腔体温度（°C），NAN时不做前馈
+     * @param temp_rate 温度变化率（°C/s），NAN时不做前馈
+     * @return 泵速百分比（0-100）
+     */
+    uint8_t update(float target, float vacuum, float gas_temp, float temp_rate);
+
+    /**
+     * @brief 重置PI状态（泵重新启动前调用）
+     */
+    void reset();
+
+    /**
+     * @brief 设置PI参数
+     */
+    void setPI(float p, float i);
+
+    /**
+     * @brief 泵速上限（板温降额，见 BoardDerating.h），抗饱和按此上限判断
+     * @param percent 0-100
+     */
+    void setOutputLimit(uint8_t percent) { outputLimit = percent; }
+    
+    /**
+     * @brief 最近一次的前馈量（%）
+     */
+    float getFeedForward() const { return feedForward; }
+
+private:
+    float kp;
+    float ki;
+    float integral;             // 积分项输出（%）
+    float feedForward;          // 前馈输出（%）
+    uint32_t lastUpdateTime;
+    float outputLimit;          // 泵速上限（%），不超过 OUTPUT_MAX
+
+    static constexpr float OUTPUT_MIN = 0.0f;
+    static constexpr float OUTPUT_MAX = 100.0f;
+};
+
+#endif // PRESSURE_CONTROLLER_H
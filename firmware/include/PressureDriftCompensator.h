@@ -0,0 +1,112 @@
+/**
+ * @file PressureDriftCompensator.h
+ * @brief 压力传感器零点温漂补偿
+ * 
+ * 加热片工作后镜框升温，MEMS压力传感器的零点随之漂移，单一的 zeroOffset
+ * 无法覆盖。这里学习一条“零点偏移-板温”曲线并在每次读数时扣除：
+ * - 板温用热电偶芯片的冷端温度代替（与压力传感器同在主控板上）
+ * - 曲线为 10~60°C、每5°C一个节点的分段线性表
+ * - 仅在腔体确认通大气时学习：泄压完成回到待机并保持 PRESSURE_DRIFT_SETTLE_MS，
+ *   连续 PRESSURE_DRIFT_AVG_SAMPLES 个样本平稳且平均值接近0，此时平均值即为当前板温下的零点偏移。
+ *   保持中的密封腔体、未泄压就进入待机时的残余负压都不会被学成零点
+ * - 学习结果按通道保存到NVS，重启后继续使用
+ */
+
+#ifndef PRESSURE_DRIFT_COMPENSATOR_H
+#define PRESSURE_DRIFT_COMPENSATOR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+static_assert(PRESSURE_DRIFT_LEARN_BAND * KPA_TO_MMHG < VENT_PRESSURE_BAND,
+              "drift learn band must be tighter than the vent band");
+
+class PressureDriftCompensator {
+public:
+    static const uint8_t NUM_KNOTS = 11;    // 10, 15, ..., 60°C
+    
+    PressureDriftCompensator();
+    
+    /**
+     * @brief 从NVS加载本通道已学习的曲线
+     * @param channel 通道编号
+     */
+    void begin(uint8_t channel);
+    
+    /**
+     * @brief 查询某板温下的零点偏移
+     * @param board_temp 板温（°C）
+     * @return 偏移（kPa），尚未学习时为0
+     */
+    float offsetAt(float board_temp) const;
+    
+    /**
+     * @brief 扣除温漂
+     * @param raw_kpa 传感器读数（kPa）
+     * @param board_temp 板温（°C），NAN时不补偿
+     */
+    float compensate(float raw_kpa, float board_temp) const {
+        return isnan(board_temp) ? raw_kpa : raw_kpa - offsetAt(board_temp);
+    }
+    
+    /**
+     * @brief 累积一个通大气样本，攒满 PRESSURE_DRIFT_AVG_SAMPLES 个后用平均值学习一次
+     *
+     * 窗口内极差超过 PRESSURE_DRIFT_SPREAD_BAND 或平均值超出 PRESSURE_DRIFT_LEARN_BAND 时丢弃整个窗口。
+     * 调用方只在腔体确认通大气时调用，条件不满足时调用 discardWindow()。
+     * @param raw_kpa 传感器读数（kPa）
+     * @param board_temp 板温（°C），NAN时丢弃窗口
+     * @return true 本次完成了一次学习
+     */
+    bool observe(float raw_kpa, float board_temp);
+    
+    /**
+     * @brief 丢弃未攒满的样本窗口
+     */
+    void discardWindow() { windowCount = 0; }
+    
+    /**
+     * @brief 用一次“通大气”读数更新曲线
+     * @param raw_kpa 传感器读数（kPa），此时真实压差为0
+     * @param board_temp 板温（°C）
+     */
+    void learn(float raw_kpa, float board_temp);
+    
+    /**
+     * @brief 有新学习结果且距上次保存超过间隔时写入NVS
+     */
+    void saveIfDirty(uint32_t now_ms);
+    
+    /**
+     * @brief 清除学习结果（含NVS）
+     */
+    void clear();
+    
+    uint16_t getSampleCount(uint8_t knot) const { return knot < NUM_KNOTS ? count[knot] : 0; }
+    
+private:
+    float offset[NUM_KNOTS];        // 各节点零点偏移（kPa）
+    uint16_t count[NUM_KNOTS];      // 各节点累计学习次数（加权）
+    uint8_t channelIndex;
+    bool dirty;
+    uint32_t lastSaveTime;
+    float windowSum;                // 样本窗口：读数和、板温和、极值
+    float windowBoardSum;
+    float windowMin;
+    float windowMax;
+    uint8_t windowCount;
+    
+    /**
+     * @brief 板温 -> 节点位置（节点下标 + 插值权重）
+     */
+    static void locate(float board_temp, uint8_t& knot, float& frac);
+    
+    /**
+     * @brief 节点的有效值：未学习的节点取最近已学习节点的值
+     */
+    float knotValue(uint8_t knot) const;
+    
+    void save();
+};
+
+#endif // PRESSURE_DRIFT_COMPENSATOR_H
@@ -1,103 +1,130 @@
 /**
  * @file PressureSensor.h
- * @brief CPS610DSD003DH01压力传感器驱动（-3kPa ~ +3kPa）
+ * @brief 压力传感器型号选择（编译期）
  * 
- * 通信协议:
- * - I2C地址: 0x7F
- * - 命令寄存器: 0x30
- * - 数据寄存器: 0x06-0x08 (24位)
- * - 转换公式: P(kPa) = 7.5 * Code - 3.75
- *   其中 Code = P_raw / 8388608.0
+ * 由 config.h 中的 PRESSURE_SENSOR_MODEL 决定 PressureSensor 的实际类型:
+ * - PRESSURE_MODEL_CPS610DSD003DH01: CPS610Sensor
+ * - PRESSURE_MODEL_XGZP6897D:        XGZP6897DSensor
+ * - PRESSURE_MODEL_AUTO:             AutoPressureSensor（启动时按I2C地址识别）
+ * 
+ * 所有型号接口一致，调用均在编译期绑定，控制回路中没有虚函数开销。
  */
 
 #ifndef PRESSURE_SENSOR_H
 #define PRESSURE_SENSOR_H
 
 #include <Arduino.h>
-#include <Wire.h>
+#include "config.h"
+#include "CPS610Sensor.h"
+#include "XGZP6897DSensor.h"
 
-class PressureSensor {
+/**
+ * @brief 自动识别型号的压力传感器
+ * 
+ * begin() 时探测I2C地址：0x7F -> CPS610DSD003DH01，0x6D -> XGZP6897D。
+ * 识别后所有调用按识别结果分支转发（可预测分支，无虚表）。
+ */
+class AutoPressureSensor {
 public:
+    enum Model {
+        MODEL_NONE,
+        MODEL_CPS610DSD003DH01,
+        MODEL_XGZP6897D
+    };
+
     /**
      * @brief 构造函数
      * @param sda_pin I2C SDA引脚
      * @param scl_pin I2C SCL引脚
-     * @param i2c_addr I2C地址（默认0x7F - CPS610DSD003DH01）
-     */
-    PressureSensor(uint8_t sda_pin, uint8_t scl_pin, uint8_t i2c_addr = 0x7F);
-    
-    /**
-     * @brief 初始化传感器
-     * @return true 初始化成功，false 失败
-     */
-    bool begin();
-    
-    /**
-     * @brief 读取压力值
-     * @return 压力值（kPa），出错返回NAN
-     * @note 量程: -3.0 ~ +3.0 kPa
-     */
-    float readPressure();
-    
-    /**
-     * @brief 触发单次采集
-     * @return true 成功，false 失败
-     */
-    bool startMeasurement();
-    
-    /**
-     * @brief 读取原始24位数据
-     * @return 原始压力值（有符号24位整数）
-     */
-    int32_t readRaw24bit();
-    
-    /**
-     * @brief 校准零点（在大气压下调用）
+     * @param i2c_addr I2C地址，PRESSURE_I2C_ADDR_AUTO(0) 表示扫描两种型号的默认地址
      */
-    void calibrateZero();
-    
-    /**
-     * @brief 检查传感器是否正常
-     * @return true 正常，false 异常
-     */
-    bool isValid();
-    
+    AutoPressureSensor(uint8_t sda_pin, uint8_t scl_pin, uint8_t i2c_addr = PRESSURE_I2C_ADDR_AUTO)
+        : cps(sda_pin, scl_pin, i2c_addr),
+          xgzp(sda_pin, scl_pin, i2c_addr),
+          requestedAddr(i2c_addr), model(MODEL_NONE) {
+    }
+
     /**
-     * @brief 获取最后一次读取的压力
-     * @return 最后压力值
+     * @brief 识别型号并初始化
+     * @return true 识别并初始化成功
      */
-    float getLastPressure() const { return lastPressure; }
-    
+    bool begin() {
+        cps.beginBus();
+        delay(100);
+
+        if (requestedAddr == PRESSURE_I2C_ADDR_AUTO) {
+            if (cps.probe()) {
+                model = MODEL_CPS610DSD003DH01;
+            } else if (xgzp.probe()) {
+                model = MODEL_XGZP6897D;
+            }
+        } else if (cps.probe()) {
+            // 指定地址时按地址判断型号
+            model = (requestedAddr == XGZP6897DSensor::DEFAULT_ADDR) ? MODEL_XGZP6897D : MODEL_CPS610DSD003DH01;
+        }
+
+        if (model == MODEL_NONE) {
+            Serial.println("X No supported pressure sensor found (0x7F / 0x6D)");
+            return false;
+        }
+
+        Serial.printf("OK Detected %s\n", modelName());
+        return visit([](auto& s) { return s.begin(); });
+    }
+
+    const char* modelName() const {
+        switch (model) {
+            case MODEL_CPS610DSD003DH01: return cps.modelName();
+            case MODEL_XGZP6897D:        return xgzp.modelName();
+            default:                     return "unknown";
+        }
+    }
+
+    Model getModel() const { return model; }
+
+    bool startMeasurement() { return visit([](auto& s) { return s.startMeasurement(); }); }
+    bool isConversionDone() { return visit([](auto& s) { return s.isConversionDone(); }); }
+    float readResult() { return visit([](auto& s) { return s.readResult(); }); }
+    float readPressure() { return visit([](auto& s) { return s.readPressure(); }); }
+    ResumeState resumeSample(uint32_t now) { return visit([now](auto& s) { return s.resumeSample(now); }); }
+    uint32_t sampleWakeAt() const {
+        return model == MODEL_XGZP6897D ? xgzp.sampleWakeAt() : cps.sampleWakeAt();
+    }
+    float sampleResult() const {
+        return model == MODEL_XGZP6897D ? xgzp.sampleResult() : cps.sampleResult();
+    }
+    bool isFresh() const {
+        return model == MODEL_XGZP6897D ? xgzp.isFresh() : cps.isFresh();
+    }
+    void calibrateZero() { visit([](auto& s) { s.calibrateZero(); }); }
+    bool isValid() { return model != MODEL_NONE && visit([](auto& s) { return s.isValid(); }); }
+    float getLastPressure() const {
+        return model == MODEL_XGZP6897D ? xgzp.getLastPressure() : cps.getLastPressure();
+    }
+
 private:
-    uint8_t sdaPin;
-    uint8_t sclPin;
-    uint8_t i2cAddr;
-    float lastPressure;
-    float zeroOffset;
-    uint8_t errorCount;
-    static const uint8_t MAX_ERROR_COUNT = 3;
-    
-    // CPS610DSD003DH01 寄存器地址
-    static const uint8_t CMD_REG = 0x30;      // 命令/状态寄存器
-    static const uint8_t DATA_REG_H = 0x06;   // 数据高字节
-    static const uint8_t DATA_REG_M = 0x07;   // 数据中字节
-    static const uint8_t DATA_REG_L = 0x08;   // 数据低字节
-    
-    // CPS610DSD003DH01 命令
-    static const uint8_t CMD_START = 0x0A;    // 启动采集
-    static const uint8_t CMD_DONE = 0x02;     // 采集完成标志
-    
-    // CPS610DSD003DH01 计算参数
-    static constexpr float COEF_A = 7.5f;      // 传递函数系数A
-    static constexpr float COEF_B = -3.75f;    // 传递函数系数B
-    static constexpr float DIVISOR = 8388608.0f; // 2^23
-    
-    /**
-     * @brief 将24位原始数据转换为压力值
-     * @param raw24 原始24位数据
-     * @return 压力值（kPa）
-     */
-    float convertToPressure(int32_t raw24);
+    CPS610Sensor cps;
+    XGZP6897DSensor xgzp;
+    uint8_t requestedAddr;
+    Model model;
+
+    template <class F>
+    auto visit(F f) -> decltype(f(cps)) {
+        if (model == MODEL_XGZP6897D) {
+            return f(xgzp);
+        }
+        return f(cps);
+    }
 };
 
+#if PRESSURE_SENSOR_MODEL == PRESSURE_MODEL_CPS610DSD003DH01
+typedef CPS610Sensor PressureSensor;
+#elif PRESSURE_SENSOR_MODEL == PRESSURE_MODEL_XGZP6897D
+typedef XGZP6897DSensor PressureSensor;
+#elif PRESSURE_SENSOR_MODEL == PRESSURE_MODEL_AUTO
+typedef AutoPressureSensor PressureSensor;
+#else
+#error "Unknown PRESSURE_SENSOR_MODEL"
+#endif
+
 #endif // PRESSURE_SENSOR_H
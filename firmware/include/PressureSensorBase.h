@@ -0,0 +1,333 @@
+/**
+ * @file PressureSensorBase.h
+ * @brief I2C压力传感器驱动公共部分（CRTP，编译期绑定，无虚函数）
+ *
+ * CPS610DSD003DH01 与 XGZP6897D 使用同一套寄存器协议:
+ * - 命令寄存器 0x30: bit3 = SCO（写1启动转换，转换完成后自动清零）
+ * - 数据寄存器 0x06-0x08: 24位有符号压力原始值
+ *
+ * 异步接口（不阻塞）:
+ *   startMeasurement() -> isConversionDone() -> readResult()
+ * 可恢复接口 resumeSample(now)（见 Resumable.h）：触发后挂起到转换完成，由采集任务在
+ * sampleWakeAt() 再次调用取结果，等待期间任务可处理其他事件。帧（sampleFrame + sampleValue）
+ * 是对象成员，不占堆。
+ * 同步接口 readPressure() 基于可恢复接口实现（挂起期间 delay）。
+ *
+ * 派生类需提供:
+ * - const char* modelName() const
+ * - bool configure()                      探测成功后的寄存器配置
+ * - uint8_t measurementCommand() const    写入0x30的启动命令
+ * - uint32_t conversionTimeMs() const     转换时间上限
+ * - float convertToPressure(int32_t raw24) const   原始值 -> kPa（不含零点）
+ * 可选覆盖:
+ * - bool triggerConversion()              默认写 measurementCommand()
+ * - bool fetchRaw(int32_t& raw24)         默认读 0x06-0x08
+ */
+
+#ifndef PRESSURE_SENSOR_BASE_H
+#define PRESSURE_SENSOR_BASE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "Resumable.h"
+
+template <class Derived>
+class PressureSensorBase {
+public:
+    /**
+     * @brief 构造函数
+     * @param sda_pin I2C SDA引脚
+     * @param scl_pin I2C SCL引脚
+     * @param i2c_addr I2C地址
+     */
+    PressureSensorBase(uint8_t sda_pin, uint8_t scl_pin, uint8_t i2c_addr)
+        : sdaPin(sda_pin), sclPin(scl_pin), i2cAddr(i2c_addr),
+          lastPressure(0.0f), zeroOffset(0.0f), errorCount(0), sampleValue(NAN), sampleFresh(false) {
+    }
+
+    /**
+     * @brief 初始化I2C总线（多个传感器共用总线，可重复调用）
+     */
+    void beginBus() {
+        Wire.begin(sdaPin, sclPin);
+        Wire.setClock(100000); // 100kHz I2C时钟
+    }
+
+    /**
+     * @brief 检查设备是否应答
+     */
+    bool probe() {
+        Wire.beginTransmission(i2cAddr);
+        return Wire.endTransmission() == 0;
+    }
+
+    /**
+     * @brief 初始化传感器
+     * @return true 初始化成功，false 失败
+     */
+    bool begin() {
+        beginBus();
+        delay(100);
+
+        Serial.printf("Initializing %s at address 0x%02X...\n", derived().modelName(), i2cAddr);
+
+        if (!probe()) {
+            Serial.println("X I2C device not found!");
+            Serial.println("  Possible issues:");
+            Serial.println("  1. Check I2C wiring (SDA/SCL)");
+            Serial.println("  2. Check power supply");
+            Serial.printf("  3. Verify I2C address is 0x%02X\n", i2cAddr);
+            return false;
+        }
+
+        Serial.println("OK I2C device detected");
+
+        if (!derived().configure()) {
+            Serial.println("X Failed to configure sensor");
+            return false;
+        }
+
+        // 读取初始值
+        float pressure = readPressure();
+        if (isnan(pressure)) {
+            Serial.println("X Failed to read pressure during initialization");
+            return false;
+        }
+
+        Serial.printf("OK %s initialized, current: %.3f kPa\n", derived().modelName(), pressure);
+        return true;
+    }
+
+    /**
+     * @brief 触发单次采集（异步，立即返回）
+     * @return true 成功，false 失败
+     */
+    bool startMeasurement() {
+        return derived().triggerConversion();
+    }
+
+    /**
+     * @brief 查询转换是否完成（SCO位已清零）
+     */
+    bool isConversionDone() {
+        uint8_t cmd;
+        if (!readRegisters(CMD_REG, &cmd, 1)) {
+            return false;
+        }
+        return (cmd & CMD_SCO) == 0;
+    }
+
+    /**
+     * @brief 读取已完成的转换结果（异步接口的最后一步）
+     * @return 压力值（kPa，已减零点），出错返回NAN
+     */
+    float readResult() {
+        int32_t raw24;
+        if (!derived().fetchRaw(raw24)) {
+            return NAN;
+        }
+        return derived().convertToPressure(raw24) - zeroOffset;
+    }
+
+    /**
+     * @brief 可恢复采集（触发 -> 挂起到转换完成 -> 读取）
+     * @param now 当前时间 (ms)
+     * @return RESUME_PENDING 转换中，到 sampleWakeAt() 再调用；RESUME_DONE 结果见 sampleResult()
+     */
+    ResumeState resumeSample(uint32_t now) {
+        RESUMABLE_BEGIN(sampleFrame);
+
+        if (!startMeasurement()) {
+            sampleValue = recordError();
+            RESUMABLE_RETURN(sampleFrame);
+        }
+
+        RESUMABLE_SLEEP(sampleFrame, now, derived().conversionTimeMs());
+
+        sampleValue = readResult();
+        if (isnan(sampleValue)) {
+            Serial.println("X Pressure read error");
+            sampleValue = recordError();
+        } else {
+            errorCount = 0;
+            lastPressure = sampleValue;
+            sampleFresh = true;
+        }
+
+        RESUMABLE_END(sampleFrame);
+    }
+
+    /**
+     * @brief 挂起中的采集下次恢复的时刻 (ms)
+     */
+    uint32_t sampleWakeAt() const { return sampleFrame.wakeAt; }
+
+    /**
+     * @brief 最近一次完成的采集结果（kPa），连续出错为NAN
+     */
+    float sampleResult() const { return sampleValue; }
+
+    /**
+     * @brief 最近一次完成的采集是否为新读数
+     * @return false 本次采集出错，sampleResult() 是上次有效值（或NAN）；控制任务不应据此刷新输出
+     */
+    bool isFresh() const { return sampleFresh; }
+
+    /**
+     * @brief 同步读取压力值（触发 -> 等待 -> 读取）
+     * @return 压力值（kPa），连续出错返回NAN
+     */
+    float readPressure() {
+        sampleFrame.reset();
+        while (resumeSample(millis()) == RESUME_PENDING) {
+            int32_t wait = (int32_t)(sampleFrame.wakeAt - (uint32_t)millis());
+            delay(wait > 0 ? (uint32_t)wait : 1);
+        }
+        return sampleValue;
+    }
+
+    /**
+     * @brief 校准零点（在大气压下调用）
+     */
+    void calibrateZero() {
+        Serial.println("Starting zero calibration...");
+        Serial.println("Ensure sensor is at atmospheric pressure (no pressure difference)");
+
+        float sum = 0.0f;
+        int count = 0;
+
+        // 采集10个样本并求平均
+        for (int i = 0; i < 10; i++) {
+            if (!startMeasurement()) {
+                Serial.printf("  Sample %d: Failed to trigger\n", i + 1);
+                continue;
+            }
+
+            delay(derived().conversionTimeMs());
+
+            float pressure = readResult();
+            if (!isnan(pressure)) {
+                sum += pressure + zeroOffset; // 加回之前的偏移
+                count++;
+                Serial.printf("  Sample %d: %.3f kPa\n", i + 1, pressure + zeroOffset);
+            } else {
+                Serial.printf("  Sample %d: Read failed\n", i + 1);
+            }
+
+            delay(100);
+        }
+
+        if (count > 0) {
+            zeroOffset = sum / count;
+            Serial.printf("OK Zero calibration completed\n");
+            Serial.printf("   Offset: %.3f kPa (based on %d samples)\n", zeroOffset, count);
+        } else {
+            Serial.println("X Zero calibration failed - no valid samples");
+        }
+    }
+
+    /**
+     * @brief 检查传感器是否正常
+     */
+    bool isValid() {
+        return (errorCount < MAX_ERROR_COUNT) && !isnan(lastPressure);
+    }
+
+    /**
+     * @brief 获取最后一次读取的压力（无时间戳，仅供采集任务自身使用；
+     * 其他任务请读取通道的 SampleHub）
+     */
+    float getLastPressure() const { return lastPressure; }
+
+    uint8_t getAddress() const { return i2cAddr; }
+
+protected:
+    // 公共寄存器
+    static const uint8_t CMD_REG = 0x30;      // 命令/状态寄存器
+    static const uint8_t DATA_REG_H = 0x06;   // 压力数据高字节（0x06-0x08）
+    static const uint8_t CMD_SCO = 0x08;      // 启动转换位（完成后清零）
+
+    uint8_t sdaPin;
+    uint8_t sclPin;
+    uint8_t i2cAddr;
+    float lastPressure;
+    float zeroOffset;
+    uint8_t errorCount;
+    static const uint8_t MAX_ERROR_COUNT = 3;
+    ResumeFrame sampleFrame;    // resumeSample() 的挂起点
+    float sampleValue;          // resumeSample() 的结果（跨挂起点）
+    bool sampleFresh;           // sampleValue 是本次采集的新读数
+
+    /**
+     * @brief 默认触发：向0x30写入启动命令
+     */
+    bool triggerConversion() {
+        if (!writeRegister(CMD_REG, derived().measurementCommand())) {
+            Serial.println("X Failed to start measurement");
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 默认读取：0x06-0x08 共3字节
+     */
+    bool fetchRaw(int32_t& raw24) {
+        uint8_t buf[3];
+        if (!readRegisters(DATA_REG_H, buf, 3)) {
+            return false;
+        }
+        raw24 = signExtend24(buf[0], buf[1], buf[2]);
+        return true;
+    }
+
+    bool writeRegister(uint8_t reg, uint8_t value) {
+        Wire.beginTransmission(i2cAddr);
+        Wire.write(reg);
+        Wire.write(value);
+        return Wire.endTransmission() == 0;
+    }
+
+    bool readRegisters(uint8_t reg, uint8_t* buf, uint8_t len) {
+        Wire.beginTransmission(i2cAddr);
+        Wire.write(reg);
+        if (Wire.endTransmission(false) != 0) {
+            return false;
+        }
+
+        Wire.requestFrom(i2cAddr, len);
+        if (Wire.available() < len) {
+            return false;
+        }
+        for (uint8_t i = 0; i < len; i++) {
+            buf[i] = Wire.read();
+        }
+        return true;
+    }
+
+    /**
+     * @brief 拼接24位有符号数并符号扩展到32位
+     */
+    static int32_t signExtend24(uint8_t h, uint8_t m, uint8_t l) {
+        int32_t raw24 = ((int32_t)h << 16) | ((int32_t)m << 8) | l;
+        if (raw24 & 0x800000) {
+            raw24 |= 0xFF000000;
+        }
+        return raw24;
+    }
+
+private:
+    Derived& derived() { return static_cast<Derived&>(*this); }
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+    float recordError() {
+        errorCount++;
+        sampleFresh = false;
+        if (errorCount >= MAX_ERROR_COUNT) {
+            return NAN;
+        }
+        return lastPressure;
+    }
+};
+
+#endif // PRESSURE_SENSOR_BASE_H
@@ -1,12 +1,16 @@
 /**
  * @file PumpController.h
  * @brief 真空泵控制器
+ *
+ * 运行中的输出带租约：超过 PUMP_LEASE_MS 未经 setSpeed() 刷新即由定时器清零（见 OutputLease.h），
+ * 所以压力任务每个周期都调用 setSpeed()，泵速不变也要调用。
  */
 
 #ifndef PUMP_CONTROLLER_H
 #define PUMP_CONTROLLER_H
 
 #include <Arduino.h>
+#include "OutputLease.h"
 
 class PumpController {
 public:
@@ -23,7 +27,7 @@ public:
     void begin();
     
     /**
-     * @brief 设置泵速（0-100%）
+     * @brief 设置泵速（0-100%），运行中时写入输出并续约
      * @param speed 速度百分比
      */
     void setSpeed(uint8_t speed);
@@ -49,11 +53,17 @@ public:
      */
     bool isRunning() const { return running; }
     
+    /**
+     * @brief 输出租约（登记到租约监视、取到期记录）
+     */
+    OutputLease& lease() { return outputLease; }
+    
 private:
     uint8_t pwmPin;
     uint8_t pwmChannel;
     uint8_t currentSpeed;
     bool running;
+    OutputLease outputLease;
 };
 
 #endif // PUMP_CONTROLLER_H
@@ -0,0 +1,71 @@
+/**
+ * @file RateEstimator.h
+ * @brief 变化率估计（滑动窗口最小二乘斜率）
+ *
+ * 热电偶分辨率0.25°C、采样周期500ms，直接差分的量化噪声约0.5°C/s，
+ * 远大于加热瞬态本身。对最近 N 个样本做直线拟合，斜率噪声降到
+ * 约0.02°C/s（N=8），代价是约 N/2 个采样周期的延迟。
+ */
+
+#ifndef RATE_ESTIMATOR_H
+#define RATE_ESTIMATOR_H
+
+#include <Arduino.h>
+
+template <uint8_t N>
+class RateEstimator {
+public:
+    static_assert(N >= 2, "slope needs at least two samples");
+
+    RateEstimator() : head(0), count(0) {}
+
+    /**
+     * @brief 加入一个样本
+     * @param t_ms 采样时刻 (ms)
+     * @param value 样本值
+     */
+    void add(uint32_t t_ms, float value) {
+        times[head] = t_ms;
+        values[head] = value;
+        head = (head + 1) % N;
+        if (count < N) count++;
+    }
+
+    /**
+     * @brief 当前斜率（单位/秒），样本不足时返回NAN
+     */
+    float slope() const {
+        if (count < N) {
+            return NAN;
+        }
+
+        // 以最早样本为时间原点，避免 millis() 大数相乘丢失精度
+        uint32_t t0 = times[head];
+        float sumT = 0.0f, sumV = 0.0f, sumTT = 0.0f, sumTV = 0.0f;
+        for (uint8_t i = 0; i < N; i++) {
+            float t = (times[i] - t0) / 1000.0f;
+            sumT += t;
+            sumV += values[i];
+            sumTT += t * t;
+            sumTV += t * values[i];
+        }
+        float denom = N * sumTT - sumT * sumT;
+        if (denom <= 0.0f) {
+            return NAN;
+        }
+        return (N * sumTV - sumT * sumV) / denom;
+    }
+
+    void reset() {
+        head = 0;
+        count = 0;
+    }
+
+private:
+    uint32_t times[N];
+    float values[N];
+    uint8_t head;
+    uint8_t count;
+};
+
+#endif // RATE_ESTIMATOR_H
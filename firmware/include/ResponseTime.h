@@ -0,0 +1,216 @@
+/**
+ * @file ResponseTime.h
+ * @brief 固定优先级响应时间分析（编译期检查任务集的可调度性）
+ *
+ * 任务集列在 RTA_FIRMWARE_TASKS：优先级、周期直接取 config.h 的 TASK_PRIORITY_*、*_PERIOD_MS，
+ * 执行时间取 RTA_WCET_* 预算。对每个任务迭代求最坏响应时间：
+ *
+ *   R = C + S + B + Σ_{j∈hp(i)} ⌈(R + S_j) / T_j⌉ · C_j
+ *
+ * - hp(i)：优先级不低于 i 的其他任务（同优先级按时间片轮转，最坏情况排在最后）
+ * - S：作业中途自挂起（delay）的时长；对更低优先级任务相当于释放抖动，一个窗口内可多抢占一次
+ * - B：阻塞。互斥锁按优先级继承计：天花板不低于 i 的每个锁，取更低优先级任务的最长持有时间，求和；
+ *   另加更低优先级任务中最长的不可抢占段（写NVS时缓存关闭，单核上其他任务都不能运行）
+ *
+ * R 超过截止期 D（不大于周期）即可能错过周期。温度、压力数据不再有互斥锁（见 SampleHub.h），
+ * 参与阻塞的只有串口锁和故障日志锁。ESP32-C3 为单核，所有任务在同一个核上调度。
+ *
+ * src/ResponseTime.cpp 对硬实时任务做 static_assert：改 config.h 的优先级、周期、通道数或预算
+ * 使其不可调度时，固件和主机仿真都编译失败。软实时任务（界面）只在报告中标出。
+ * 基准模式（HOT_PATH_BENCH）用实测的回路最坏执行时间和NVS写入时间重算并打印，
+ * 主机仿真结束时打印按预算计算的结果。
+ */
+
+#ifndef RESPONSE_TIME_H
+#define RESPONSE_TIME_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+#define RTA_PRIORITY_ISR    0xFF    // 中断：高于所有任务，不受任务阻塞
+
+/**
+ * @brief 参与阻塞分析的互斥锁
+ */
+enum RtaLock : uint8_t {
+    RTA_LOCK_SERIAL = 0,        // safePrint 的串口锁
+    RTA_LOCK_FAULT_LOG,         // FaultLog 内部锁（持有期间写NVS）
+    RTA_LOCK_COUNT
+};
+
+/**
+ * @brief 任务（或同一任务中周期不同的一类作业）
+ */
+struct RtaTask {
+    const char* name;
+    uint8_t priority;               // FreeRTOS 优先级，中断为 RTA_PRIORITY_ISR
+    uint32_t periodUs;              // 周期或最小到达间隔 T
+    uint32_t deadlineUs;            // 相对截止期 D（不大于 T）
+    uint32_t wcetUs;                // 最坏执行时间 C（不含阻塞和自挂起）
+    uint32_t suspendUs;             // 作业中途自挂起的总时长 S
+    uint32_t holdUs[RTA_LOCK_COUNT];    // 每次持有各锁的最长时间，0 = 不使用
+    bool nonPreemptive;             // 整个作业不可抢占（NVS写入）
+    bool hard;                      // 硬实时：不可调度时编译失败
+};
+
+/**
+ * @brief 单个任务的分析结果
+ */
+struct RtaResult {
+    uint32_t blockingUs;            // B
+    uint32_t responseUs;            // R（不可调度时为第一次超过截止期的迭代值）
+    bool schedulable;
+};
+
+/**
+ * @brief 任务 i 受到的阻塞 B
+ */
+template <size_t N>
+constexpr uint32_t rtaBlocking(const RtaTask (&set)[N], size_t i) {
+    const uint8_t prio = set[i].priority;
+    if (prio == RTA_PRIORITY_ISR) {
+        return 0;
+    }
+    uint32_t blocking = 0;
+    for (size_t l = 0; l < RTA_LOCK_COUNT; l++) {
+        uint8_t ceiling = 0;
+        uint32_t longest = 0;
+        for (size_t j = 0; j < N; j++) {
+            if (set[j].holdUs[l] == 0) {
+                continue;
+            }
+            if (set[j].priority > ceiling) {
+                ceiling = set[j].priority;
+            }
+            if (set[j].priority < prio && set[j].holdUs[l] > longest) {
+                longest = set[j].holdUs[l];
+            }
+        }
+        if (ceiling >= prio) {
+            blocking += longest;
+        }
+    }
+    uint32_t nonPreemptive = 0;
+    for (size_t j = 0; j < N; j++) {
+        if (set[j].nonPreemptive && set[j].priority < prio && set[j].wcetUs > nonPreemptive) {
+            nonPreemptive = set[j].wcetUs;
+        }
+    }
+    return blocking + nonPreemptive;
+}
+
+/**
+ * @brief 任务 i 的最坏响应时间
+ */
+template <size_t N>
+constexpr RtaResult rtaAnalyze(const RtaTask (&set)[N], size_t i) {
+    const RtaTask& t = set[i];
+    const uint32_t blocking = rtaBlocking(set, i);
+    const uint64_t base = (uint64_t)t.wcetUs + t.suspendUs + blocking;
+    uint64_t r = base;
+    while (true) {
+        uint64_t next = base;
+        for (size_t j = 0; j < N; j++) {
+            if (j != i && set[j].priority >= t.priority) {
+                next += (r + set[j].suspendUs + set[j].periodUs - 1) / set[j].periodUs * set[j].wcetUs;
+            }
+        }
+        if (next > t.deadlineUs) {
+            return RtaResult{blocking, (uint32_t)(next < UINT32_MAX ? next : UINT32_MAX), false};
+        }
+        if (next == r) {
+            return RtaResult{blocking, (uint32_t)r, true};
+        }
+        r = next;
+    }
+}
+
+/**
+ * @brief 所有硬实时任务都可调度
+ */
+template <size_t N>
+constexpr bool rtaHardSchedulable(const RtaTask (&set)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        if (set[i].hard && !rtaAnalyze(set, i).schedulable) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 固件任务集中的序号
+ */
+enum RtaTaskId : uint8_t {
+    RTA_TICK = 0,
+    RTA_SUPERVISOR,
+    RTA_TEMPERATURE,
+    RTA_PRESSURE,
+    RTA_SAFETY,
+    RTA_NVS,
+    RTA_UI_SCAN,
+    RTA_UI_STATUS,
+    RTA_UI_RPC,
+    RTA_TELEMETRY,
+    RTA_TIMER_SERVICE,
+    RTA_TASK_COUNT
+};
+
+/**
+ * @brief 错峰后的服务间隔 (µs)，与 ChannelBank::slotPeriodMs 相同
+ */
+constexpr uint32_t rtaSlotUs(uint32_t periodMs) {
+    return ((periodMs / NUM_CHANNELS) > 0 ? (periodMs / NUM_CHANNELS) : 1) * 1000UL;
+}
+
+/**
+ * @brief 固件任务集（与 main.cpp 中创建的任务对应）
+ *
+ * - 状态机：最坏情况每个压力时间片一次转移；截止期取一个压力时间片，
+ *   模式变化在下一次泵输出更新前生效
+ * - 写NVS：控制运行中的连续写入（预热完成时保存学习值、板温报警写故障日志）合成一个
+ *   不可抢占的作业，最多含一次扇区擦除。疗程结束时的磨损记录和零点学习值在泵停止后写，
+ *   此时没有需要按时刷新的输出，不计入
+ * - 压力任务触发转换后挂起到转换完成（见 Resumable.h），挂起期间让出CPU，按自挂起 S 计
+ * - 界面任务的按键扫描、状态打印和主机请求按三类作业分析（同一任务，同一优先级）；
+ *   主机请求每 LINK_RPC_INTERVAL_MS 最多处理 LINK_RPC_PER_WAKE 个，主机连续发送时的最坏负载
+ * - 遥测按主机可设定的最短周期计
+ * - 定时器服务任务（ESP-IDF 默认优先级1）：租约检查必须在下一次检查前完成，
+ *   否则输出归零延迟超过"租约时限 + 检查周期"
+ */
+constexpr RtaTask RTA_FIRMWARE_TASKS[RTA_TASK_COUNT] = {
+    { "Tick", RTA_PRIORITY_ISR, 1000, 1000, RTA_WCET_TICK_US, 0,
+      { 0, 0 }, false, true },
+    { "Supervisor", TASK_PRIORITY_HIGH + 1, rtaSlotUs(PRESSURE_SAMPLE_PERIOD_MS), rtaSlotUs(PRESSURE_SAMPLE_PERIOD_MS),
+      RTA_WCET_SUPERVISOR_US, 0, { RTA_SERIAL_HOLD_US, 0 }, false, true },
+    { "Temperature", TASK_PRIORITY_HIGH, rtaSlotUs(TEMP_SAMPLE_PERIOD_MS), rtaSlotUs(TEMP_SAMPLE_PERIOD_MS),
+      RTA_WCET_TEMP_US, 0, { RTA_SERIAL_HOLD_US, 0 }, false, true },
+    { "Pressure", TASK_PRIORITY_HIGH, rtaSlotUs(PRESSURE_SAMPLE_PERIOD_MS), rtaSlotUs(PRESSURE_SAMPLE_PERIOD_MS),
+      RTA_WCET_PRESSURE_US, RTA_PRESSURE_CONVERSION_US, { RTA_SERIAL_HOLD_US, 0 }, false, true },
+    { "Safety", TASK_PRIORITY_HIGH, SAFETY_MONITOR_PERIOD_MS * 1000UL, SAFETY_MONITOR_PERIOD_MS * 1000UL,
+      RTA_WCET_SAFETY_US, 0, { RTA_SERIAL_HOLD_US, 0 }, false, true },
+    { "NVS", TASK_PRIORITY_HIGH, RTA_NVS_MIN_INTERVAL_MS * 1000UL, RTA_NVS_MIN_INTERVAL_MS * 1000UL,
+      RTA_FLASH_ERASE_US + RTA_NVS_BURST_WRITES * RTA_NVS_WRITE_US, 0,
+      { 0, RTA_FLASH_ERASE_US + RTA_NVS_WRITE_US }, true, true },
+    { "UI", TASK_PRIORITY_NORMAL, UI_ACTIVE_POLL_MS * 1000UL, UI_ACTIVE_POLL_MS * 1000UL,
+      RTA_WCET_UI_SCAN_US, 0, { RTA_SERIAL_HOLD_US, 0 }, false, false },
+    { "UI status", TASK_PRIORITY_NORMAL, UI_STATUS_PERIOD_MS * 1000UL, UI_STATUS_PERIOD_MS * 1000UL,
+      RTA_WCET_UI_STATUS_US, 0, { RTA_SERIAL_HOLD_US, 0 }, false, false },
+    { "UI RPC", TASK_PRIORITY_NORMAL, LINK_RPC_INTERVAL_MS * 1000UL, LINK_RPC_INTERVAL_MS * 1000UL,
+      LINK_RPC_PER_WAKE * RTA_WCET_RPC_US, 0, { RTA_SERIAL_HOLD_US, 0 }, false, false },
+    { "Telemetry", TASK_PRIORITY_NORMAL, TELEMETRY_MIN_PERIOD_MS * 1000UL, TELEMETRY_MIN_PERIOD_MS * 1000UL,
+      RTA_WCET_TELEMETRY_US, 0, { RTA_SERIAL_HOLD_US, 0 }, false, false },
+    { "Tmr Svc", TASK_PRIORITY_LOW, OUTPUT_LEASE_CHECK_MS * 1000UL, OUTPUT_LEASE_CHECK_MS * 1000UL,
+      RTA_WCET_TIMER_US, 0, { 0, 0 }, false, true },
+};
+
+/**
+ * @brief 打印分析结果（每个任务一行）
+ * @param set 任务集（可以是用实测值替换了预算的副本）
+ * @param print 逐行输出（不含换行）
+ * @return 不可调度的硬实时任务数
+ */
+uint8_t rtaReport(const RtaTask (&set)[RTA_TASK_COUNT], void (*print)(const char* line));
+
+#endif // RESPONSE_TIME_H
@@ -0,0 +1,67 @@
+/**
+ * @file Resumable.h
+ * @brief 无栈可恢复函数（挂起点 + 静态帧），用于传感器异步采集
+ *
+ * 目标工具链（Arduino-ESP32 2.x 的 riscv32-esp-elf-gcc 8.4.0）不支持 C++20 协程
+ * （GCC 10 起才有 -fcoroutines，且协程帧默认在堆上分配），这里用 switch/case 实现同样的挂起语义：
+ *
+ *   ResumeState resume(uint32_t now) {
+ *       RESUMABLE_BEGIN(frame);
+ *       trigger();
+ *       RESUMABLE_SLEEP(frame, now, CONVERSION_MS);     // 相当于 co_await 转换完成
+ *       value = read();
+ *       RESUMABLE_END(frame);
+ *   }
+ *
+ * - 条件不满足时 resume() 返回 RESUME_PENDING，下次调用从挂起点继续；完成时返回 RESUME_DONE
+ * - 帧就是 ResumeFrame 加上跨挂起点使用的成员变量，随对象静态分配，大小在编译期确定，无堆分配
+ * - 局部变量不能跨挂起点（下次调用时已不存在），挂起点不能写在另一个 switch 里，
+ *   同一行只能有一个挂起点（用 __LINE__ 区分）
+ *
+ * 调用方（采集任务）挂起期间阻塞到 frame.wakeAt 或处理别的事件，不占CPU、不在 delay() 中停留。
+ * 切换到支持协程的工具链后，RESUMABLE_SLEEP 一一对应 co_await，帧成员对应协程局部变量。
+ */
+
+#ifndef RESUMABLE_H
+#define RESUMABLE_H
+
+#include <stdint.h>
+
+enum ResumeState : uint8_t {
+    RESUME_PENDING = 0,     // 在挂起点等待，到 wakeAt 后再调用
+    RESUME_DONE             // 已完成，结果可读
+};
+
+/**
+ * @brief 可恢复函数的挂起状态
+ */
+struct ResumeFrame {
+    uint16_t point;         // 挂起点（源代码行号），0 = 未开始或已完成
+    uint32_t wakeAt;        // 挂起时：下次恢复的时刻 (ms)
+
+    ResumeFrame() : point(0), wakeAt(0) {}
+
+    bool isActive() const { return point != 0; }
+
+    /**
+     * @brief 放弃进行中的调用，下次从头开始
+     */
+    void reset() { point = 0; }
+};
+
+#define RESUMABLE_BEGIN(f)      switch ((f).point) { case 0:
+
+// cond 不成立时挂起，恢复后重新求值
+#define RESUMABLE_AWAIT(f, cond) \
+    do { (f).point = __LINE__; /* fall through */ case __LINE__: if (!(cond)) return RESUME_PENDING; } while (0)
+
+// 挂起到 now + ms（now 为 resume() 的参数，每次恢复时是新的时刻）
+#define RESUMABLE_SLEEP(f, now, ms) \
+    do { (f).wakeAt = (now) + (ms); RESUMABLE_AWAIT(f, (int32_t)((now) - (f).wakeAt) >= 0); } while (0)
+
+// 提前结束
+#define RESUMABLE_RETURN(f)     do { (f).point = 0; return RESUME_DONE; } while (0)
+
+#define RESUMABLE_END(f)        } (f).point = 0; return RESUME_DONE
+
+#endif // RESUMABLE_H
@@ -0,0 +1,88 @@
+/**
+ * @file RpcServer.h
+ * @brief RPC 请求分派：参数表、命令、重发去重（协议见 LinkProtocol.h）
+ *
+ * 参数表和命令处理函数由使用者提供（固件见 main.cpp，主机回环测试用自己的表），
+ * 本类只负责解析请求、检查长度和范围、组织应答。不依赖 Arduino，无堆分配。
+ * 在一个任务中调用（固件为界面任务），参数的 get/set 在该任务上下文执行。
+ */
+
+#ifndef RPC_SERVER_H
+#define RPC_SERVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "LinkFrame.h"
+#include "LinkProtocol.h"
+
+/**
+ * @brief 参数表的一项
+ */
+struct RpcParam {
+    uint8_t id;                     // RpcParamId
+    const char* name;
+    float minValue;                 // 可写参数的范围（含端点）
+    float maxValue;
+    float (*get)();
+    RpcStatus (*set)(float value);  // NULL = 只读；范围已检查
+};
+
+typedef RpcStatus (*RpcCommandHandler)(uint8_t command);
+
+/**
+ * @brief 本类不认识的操作交给扩展处理（固件升级）
+ * @param response 写入完整应答 [操作][状态][数据]
+ * @return 应答长度，0 表示也不认识（返回 UNKNOWN_OP）
+ */
+typedef size_t (*RpcExtension)(uint8_t op, const uint8_t* args, size_t len, uint8_t* response);
+
+class RpcServer {
+public:
+    struct Stats {
+        uint32_t requests;
+        uint32_t duplicates;        // 重发的请求（返回缓存的应答）
+        uint32_t errors;            // 应答状态不是 RPC_OK
+    };
+
+    /**
+     * @param params 参数表（静态存储）
+     * @param count 参数个数
+     * @param commands 命令处理（返回 RPC_ERR_REJECTED 表示当前不允许）
+     * @param channels INFO 中报告的通道数
+     * @param uptime INFO 中报告的运行时间 (ms)
+     */
+    RpcServer(const RpcParam* params, size_t count, RpcCommandHandler commands,
+              uint8_t channels, uint32_t (*uptime)());
+
+    /**
+     * @brief 处理一个请求
+     * @param seq 请求序号（与上一请求序号和内容都相同时返回缓存的应答，不再执行）
+     * @param response 应答载荷缓冲（至少 LINK_MAX_PAYLOAD 字节）
+     * @return 应答载荷长度
+     */
+    size_t handle(uint8_t seq, const uint8_t* request, size_t len, uint8_t* response);
+
+    void setExtension(RpcExtension handler) { extension = handler; }
+
+    const Stats& counters() const { return stats; }
+
+private:
+    const RpcParam* params;
+    size_t paramCount;
+    RpcCommandHandler commands;
+    uint8_t channelCount;
+    uint32_t (*uptime)();
+    RpcExtension extension;
+    Stats stats;
+
+    bool hasLast;
+    uint8_t lastSeq;
+    uint16_t lastRequestCrc;
+    size_t lastLen;
+    uint8_t lastResponse[LINK_MAX_PAYLOAD];
+
+    size_t dispatch(const uint8_t* request, size_t len, uint8_t* response);
+    const RpcParam* find(uint8_t id) const;
+};
+
+#endif // RPC_SERVER_H
@@ -0,0 +1,167 @@
+/**
+ * @file SampleHub.h
+ * @brief 传感器样本发布/订阅（带时间戳、质量标记和新鲜度检查）
+ *
+ * 每个传感器每次采集后发布一个样本（值、采集时刻、质量），其他任务按主题读取。
+ * 读取方必须给出允许的最大样本年龄：采集任务卡住或传感器持续失败时，
+ * 读取方得到的是"过期"而不是上一次的旧值，由读取方执行各自规定的安全动作。
+ *
+ * 无锁实现（单写者、多读者）：每个槽位两个缓冲 + 两个序号（开始写/写完）。
+ * 写者写入读者当前不读的那个缓冲，写之前递增"开始"序号，写完再递增"写完"序号；
+ * 读者按"写完"序号选缓冲、复制，再核对"开始"序号：期间写者开始了再下一次发布
+ * （即改写读者正在读的缓冲）才需要重读。
+ * 写者中途被读者抢占时，读者读的是另一个（完整的）缓冲，不会自旋等待写者，
+ * 所以高优先级任务读低优先级任务发布的样本也不会卡住。
+ * ESP32-C3 没有原子扩展（RV32IMC），序号只做32位对齐的读写，不用读-改-写原子操作。
+ */
+
+#ifndef SAMPLE_HUB_H
+#define SAMPLE_HUB_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "config.h"
+
+/**
+ * @brief 样本质量
+ */
+enum SampleQuality : uint8_t {
+    SAMPLE_NONE = 0,        // 从未发布
+    SAMPLE_GOOD,            // 采集成功
+    SAMPLE_FAULT            // 采集失败（值为NAN），时间戳仍为本次采集时刻
+};
+
+/**
+ * @brief 样本
+ */
+struct Sample {
+    float value;
+    uint32_t timestamp;     // 采集时刻 (ms)
+    uint32_t sequence;      // 发布序号（每次发布+1，可用于判断是否为新样本）
+    SampleQuality quality;
+
+    /**
+     * @brief 样本年龄 (ms)；读取方在写者发布前取的 now 可能略早于时间戳，按0计
+     */
+    uint32_t age(uint32_t now) const {
+        int32_t dt = (int32_t)(now - timestamp);
+        return dt > 0 ? (uint32_t)dt : 0;
+    }
+
+    /**
+     * @brief 过期：从未发布，或最近一次采集（无论成败）早于 maxAge
+     */
+    bool isStale(uint32_t now, uint32_t maxAge) const {
+        return quality == SAMPLE_NONE || age(now) > maxAge;
+    }
+
+    /**
+     * @brief 可用：采集成功且未过期
+     */
+    bool isUsable(uint32_t now, uint32_t maxAge) const {
+        return quality == SAMPLE_GOOD && !isStale(now, maxAge);
+    }
+};
+
+/**
+ * @brief 单个主题的样本槽位（单写者、多读者，无锁）
+ */
+class SampleSlot {
+public:
+    SampleSlot() : started(0), committed(0) {
+        buffers[0] = Sample{NAN, 0, 0, SAMPLE_NONE};
+        buffers[1] = buffers[0];
+    }
+
+    /**
+     * @brief 发布样本（只能由一个任务调用）
+     */
+    void publish(float value, uint32_t timestamp, SampleQuality quality) {
+        uint32_t next = committed.load(std::memory_order_relaxed) + 1;
+        started.store(next, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        Sample& b = buffers[next & 1];
+        b.value = value;
+        b.timestamp = timestamp;
+        b.sequence = next;
+        b.quality = quality;
+        committed.store(next, std::memory_order_release);
+    }
+
+    /**
+     * @brief 读取最新样本
+     */
+    Sample read() const {
+        Sample out;
+        uint32_t seq, latest;
+        do {
+            seq = committed.load(std::memory_order_acquire);
+            out = buffers[seq & 1];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            latest = started.load(std::memory_order_relaxed);
+        } while (latest - seq >= 2);        // 读的缓冲已开始被改写
+        return out;
+    }
+
+private:
+    Sample buffers[2];
+    std::atomic<uint32_t> started;      // 最近一次开始写的发布序号
+    std::atomic<uint32_t> committed;    // 最近一次写完的发布序号
+};
+
+/**
+ * @brief 样本主题
+ */
+enum SampleTopic : uint8_t {
+    TOPIC_PAD_TEMP = 0,     // 加热片温度 (°C)，温度任务发布
+    TOPIC_PAD_TEMP_RATE,    // 加热片温度变化率 (°C/s)，温度任务发布
+    TOPIC_BOARD_TEMP,       // 板温/冷端温度 (°C)，温度任务发布（MAX6675 无冷端输出，始终为采集失败）
+    TOPIC_PRESSURE,         // 腔体负压 (mmHg，已做温漂补偿)，压力任务发布
+    TOPIC_COUNT
+};
+
+/**
+ * @brief 一个通道的全部主题
+ */
+class SampleHub {
+public:
+    /**
+     * @brief 发布样本，值为NAN时按采集失败发布
+     */
+    void publish(SampleTopic topic, float value, uint32_t timestamp) {
+        slots[topic].publish(value, timestamp, isnan(value) ? SAMPLE_FAULT : SAMPLE_GOOD);
+    }
+
+    /**
+     * @brief 发布采集失败（值为NAN）
+     */
+    void publishFault(SampleTopic topic, uint32_t timestamp) {
+        slots[topic].publish(NAN, timestamp, SAMPLE_FAULT);
+    }
+
+    Sample read(SampleTopic topic) const {
+        return slots[topic].read();
+    }
+
+    /**
+     * @brief 读取可用的值，过期或采集失败时返回NAN
+     * @param maxAge 允许的最大样本年龄 (ms)
+     */
+    float readValue(SampleTopic topic, uint32_t now, uint32_t maxAge) const {
+        Sample s = slots[topic].read();
+        return s.isUsable(now, maxAge) ? s.value : NAN;
+    }
+
+    /**
+     * @brief 主题允许的最大样本年龄：采样周期的 SAMPLE_STALE_PERIODS 倍
+     */
+    static constexpr uint32_t maxAge(SampleTopic topic) {
+        return (topic == TOPIC_PRESSURE ? PRESSURE_SAMPLE_PERIOD_MS : TEMP_SAMPLE_PERIOD_MS)
+               * SAMPLE_STALE_PERIODS;
+    }
+
+private:
+    SampleSlot slots[TOPIC_COUNT];
+};
+
+#endif // SAMPLE_HUB_H
@@ -0,0 +1,229 @@
+/**
+ * @file SelfTest.h
+ * @brief 上电自检（执行器实际动作 + 传感器合理性，所有检查同时进行）
+ *
+ * 初始化只确认传感器有应答，不能发现加热片开路、热电偶没贴在加热片上、泵不转等问题。
+ * 自检在创建控制任务之前运行，总时长不超过 POST_BUDGET_MS：
+ *
+ *   0 ─ POST_BASELINE_MS         执行器关闭，采集基线：
+ *                                - 温度/负压读取成功、在合理范围内、波动不大
+ *                                - 加热片与冷端温差（MAX31855）
+ *                                - 未加热时的升温速率（加热开关管短路）
+ *   POST_BASELINE_MS ─ 预算结束   同时进行：
+ *                                - 加热脉冲：全功率，温升达到 POST_HEATER_MIN_RISE 即停
+ *                                - 抽气脉冲：泵速 POST_PUMP_SPEED，负压增加达到 POST_PUMP_MIN_RISE 即停
+ *
+ * 各通道同时自检；全部检查有结论即提前结束。预算用完仍未达到的检查判为失败。
+ * 失败写入故障日志（FaultLog）；严重故障（见 FaultLog::isCritical）时系统停在故障模式，
+ * 重启前不能开始疗程。抽气无负压可能只是没有佩戴，只记录。
+ * 蜂鸣器和执行器电流没有检测电路，无法自检。
+ */
+
+#ifndef SELF_TEST_H
+#define SELF_TEST_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "config.h"
+#include "FaultLog.h"
+#include "EmergencyStop.h"
+#include "HeatingController.h"
+#include "PumpController.h"
+
+/**
+ * @brief 自检项
+ */
+enum PostCheck : uint8_t {
+    POST_CHECK_TEMP_SENSOR = 0,     // 温度传感器合理性
+    POST_CHECK_PRESSURE_SENSOR,     // 压力传感器合理性
+    POST_CHECK_HEATER,              // 加热脉冲
+    POST_CHECK_PUMP,                // 抽气脉冲
+    POST_CHECK_COUNT
+};
+
+/**
+ * @brief 自检结果
+ */
+enum PostResult : uint8_t {
+    POST_PENDING = 0,
+    POST_PASS,
+    POST_FAIL,
+    POST_SKIPPED                    // 前置检查失败、热启动或被急停中断
+};
+
+/**
+ * @brief 单个检查的结论
+ */
+struct PostOutcome {
+    PostResult result;
+    FaultCode fault;                // 失败原因
+    float value;                    // 判定所用的测量值（温升、负压增加、升温速率等）
+    uint32_t elapsedMs;             // 从自检开始到得出结论的时间
+};
+
+/**
+ * @brief 单通道自检判定（只处理样本和时间，不接触硬件）
+ */
+class ChannelSelfTest {
+public:
+    ChannelSelfTest();
+
+    void start(uint32_t now);
+
+    /**
+     * @param pad 加热片温度，读取失败为NAN
+     * @param board 冷端温度，无冷端输出（MAX6675）为NAN
+     */
+    void addTemperature(uint32_t now, float pad, float board);
+
+    /**
+     * @param vacuum 负压 (mmHg)，读取失败为NAN
+     */
+    void addPressure(uint32_t now, float vacuum);
+
+    /**
+     * @brief 推进阶段并判定（每个采样节拍调用）
+     * @param aborted 急停：未完成的检查判为跳过，执行器立即关闭
+     */
+    void update(uint32_t now, bool aborted);
+
+    uint8_t heaterOutput() const { return heaterOn ? 255 : 0; }
+    uint8_t pumpSpeed() const { return pumpOn ? POST_PUMP_SPEED : 0; }
+    float lastTemperature() const { return lastTemp; }
+
+    bool done() const;
+    const PostOutcome& outcome(PostCheck check) const { return outcomes[check]; }
+
+    /**
+     * @brief 有失败的检查且其故障为严重故障
+     */
+    bool hasCriticalFailure() const;
+
+private:
+    void finishBaseline(uint32_t now);
+    void conclude(PostCheck check, PostResult result, FaultCode fault, float value, uint32_t now);
+
+    static const uint8_t MAX_BASELINE = POST_BASELINE_MS / POST_TEMP_SAMPLE_MS + 2;
+
+    uint32_t startMs;
+    bool baselineDone;
+    bool heaterOn;
+    bool pumpOn;
+    PostOutcome outcomes[POST_CHECK_COUNT];
+
+    // 基线样本
+    float tempT[MAX_BASELINE];
+    float tempV[MAX_BASELINE];
+    uint8_t tempCount;
+    uint8_t tempFailures;
+    float boardSum;
+    uint8_t boardCount;
+    float vacuumSum;
+    float vacuumMin;
+    float vacuumMax;
+    uint8_t vacuumCount;
+    uint8_t vacuumFailures;
+
+    // 基线结论
+    float restSlope;            // 未加热时的升温速率 (°C/s)
+    float baselineTemp;         // 基线末尾的温度（拟合值）
+    uint32_t baselineMs;
+    float baselineVacuum;
+    float lastTemp;
+    uint32_t lastTempMs;
+    float lastVacuum;
+};
+
+/**
+ * @brief 运行上电自检
+ * @param bank 通道组（ChannelBank）
+ * @param log 失败写入的故障日志
+ * @param estop 急停（自检期间按STOP立即关闭执行器并结束）
+ * @param tests 每通道的判定结果（输出，长度为通道数）
+ * @return true 无严重故障
+ */
+template <class BankT>
+bool runSelfTest(BankT& bank, FaultLog& log, const EmergencyStop& estop, ChannelSelfTest* tests) {
+    uint32_t start = millis();
+    for (size_t i = 0; i < bank.size(); i++) {
+        tests[i].start(start);
+    }
+    uint32_t nextTemp = start;
+    uint32_t nextPressure = start;
+    bool aborted = false;
+
+    while (true) {
+        uint32_t now = millis();
+        aborted = aborted || estop.isCut();
+        // 预算用完后不再采样：压力读取要等一次转换，采样后再判定会超出预算
+        bool sampling = !aborted && (now - start) < POST_BUDGET_MS;
+
+        if (sampling && (int32_t)(now - nextTemp) >= 0) {
+            for (size_t i = 0; i < bank.size(); i++) {
+                float pad = bank[i].temperature().readTemperature();
+                float board = bank[i].temperature().readInternalTemperature();
+                tests[i].addTemperature(now, pad, board);
+            }
+            nextTemp += POST_TEMP_SAMPLE_MS;
+        }
+        if (sampling && (int32_t)(now - nextPressure) >= 0) {
+            for (size_t i = 0; i < bank.size(); i++) {
+                float kpa = bank[i].pressure().readPressure();
+                tests[i].addPressure(now, isnan(kpa) ? NAN : -kpa * KPA_TO_MMHG);
+            }
+            nextPressure += PRESSURE_SAMPLE_PERIOD_MS;
+        }
+
+        bool allDone = true;
+        for (size_t i = 0; i < bank.size(); i++) {
+            ChannelSelfTest& t = tests[i];
+            t.update(millis(), aborted);
+            allDone = allDone && t.done();
+
+            HeatingController& heater = bank[i].heating();
+            if (t.heaterOutput() > 0) {
+                if (!heater.isEnabled()) {
+                    heater.enable();
+                }
+                heater.driveOpenLoop(t.lastTemperature(), t.heaterOutput());
+            } else if (heater.isEnabled()) {
+                heater.disable();
+            }
+
+            PumpController& pump = bank[i].pumpController();
+            if (t.pumpSpeed() > 0) {
+                pump.setSpeed(t.pumpSpeed());   // 每次都写：为输出续约（见 OutputLease.h）
+                if (!pump.isRunning()) {
+                    pump.start();
+                }
+            } else if (pump.isRunning()) {
+                pump.stop();
+            }
+        }
+        if (allDone) {
+            break;
+        }
+        vTaskDelay(1);
+    }
+
+    bool ok = true;
+    if (aborted) {
+        log.record(FAULT_POST_ABORTED, 0xFF, NAN);
+    }
+    for (size_t i = 0; i < bank.size(); i++) {
+        for (uint8_t c = 0; c < POST_CHECK_COUNT; c++) {
+            const PostOutcome& o = tests[i].outcome((PostCheck)c);
+            if (o.result == POST_FAIL) {
+                log.record(o.fault, (uint8_t)i, o.value);
+            }
+        }
+        ok = ok && !tests[i].hasCriticalFailure();
+    }
+    return ok;
+}
+
+const char* postCheckName(PostCheck check);
+const char* postResultName(PostResult result);
+
+#endif // SELF_TEST_H
@@ -0,0 +1,43 @@
+/**
+ * @file Sha256.h
+ * @brief SHA-256（固件升级的镜像校验，固件与主机工具共用）
+ *
+ * 状态是普通结构体，可以整块保存到 NVS，断点续传时从检查点继续计算。
+ * 不依赖 Arduino，无堆分配。
+ */
+
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA256_DIGEST_LEN   32
+
+class Sha256 {
+public:
+    Sha256() { reset(); }
+
+    void reset();
+    void update(const uint8_t* data, size_t len);
+
+    /**
+     * @brief 结束计算并输出摘要（之后须 reset() 才能再用）
+     */
+    void finish(uint8_t digest[SHA256_DIGEST_LEN]);
+
+    /**
+     * @brief 一次计算
+     */
+    static void hash(const uint8_t* data, size_t len, uint8_t digest[SHA256_DIGEST_LEN]);
+
+private:
+    uint32_t state[8];
+    uint64_t total;         // 已输入字节数
+    uint8_t block[64];
+    uint32_t fill;          // block 中的字节数
+
+    void compress(const uint8_t* p);
+};
+
+#endif // SHA256_H
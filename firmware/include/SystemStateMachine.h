@@ -0,0 +1,229 @@
+/**
+ * @file SystemStateMachine.h
+ * @brief 系统状态机（表驱动，急停锁存）
+ *
+ * 系统模式只由一个拥有者任务修改：其他任务把输入（按键、温度到达、
+ * 传感器异常……）作为事件放进队列，拥有者任务逐个调用 dispatch()。
+ * 控制任务只读取当前模式对应的执行器许可（heatingAllowed/pumpAllowed）。
+ *
+ * 转移表为 [模式][事件] 的二维常量表，查表 + 一个守卫判断，常数时间。
+ * 表中“目标 == 当前模式”表示忽略该事件。
+ *
+ *   Boot ──BOOT_OK──> Idle ──START──> WarmUp ──TEMP_REACHED──> Run <──RESUME── Hold
+ *     │                 ^                │                      │ └──PAUSE──────>┘
+ *     └──BOOT_FAIL──> Fault              └──────STOP──> Venting <──STOP─────────┘
+ *                       │                                 │
+ *                       └──FAULT_CLEARED──> Idle <──VENTED┘
+ *
+ *   任意模式 ──ESTOP──> EStopLatched ──RESET（STOP已松开）──> Idle
+ *
+ * 急停锁存：松开STOP不会恢复运行，必须显式复位（UP+DOWN同时长按）。
+ * 表的不变量（急停可达、锁存只能经复位离开等）在 SystemStateMachine.cpp
+ * 中以 static_assert 在编译期穷举检查。
+ *
+ * 本类不依赖FreeRTOS，队列和拥有者任务见 main.cpp。
+ */
+
+#ifndef SYSTEM_STATE_MACHINE_H
+#define SYSTEM_STATE_MACHINE_H
+
+#include <Arduino.h>
+
+/**
+ * @brief 系统模式
+ */
+enum SystemMode : uint8_t {
+    MODE_BOOT = 0,          // 上电初始化，执行器关闭
+    MODE_IDLE,              // 待机，执行器关闭
+    MODE_WARMUP,            // 预热：只加热，不抽气
+    MODE_RUN,               // 运行：加热 + 抽气
+    MODE_HOLD,              // 暂停：保温，泵停止
+    MODE_VENTING,           // 结束疗程：执行器关闭，等待腔体回到大气压
+    MODE_FAULT,             // 传感器故障/全部通道过温：执行器关闭，故障消失后回到待机
+    MODE_ESTOP_LATCHED,     // 急停锁存：执行器关闭，只能显式复位
+    MODE_COUNT
+};
+
+/**
+ * @brief 状态机输入事件
+ */
+enum SystemEvent : uint8_t {
+    EVT_BOOT_OK = 0,        // 硬件初始化完成
+    EVT_BOOT_FAIL,          // 硬件初始化失败
+    EVT_START,              // 开始疗程
+    EVT_TEMP_REACHED,       // 各通道达到目标温度
+    EVT_PAUSE,              // 暂停抽气
+    EVT_RESUME,             // 恢复抽气
+    EVT_STOP,               // 结束疗程（泄压）
+    EVT_VENTED,             // 腔体已回到大气压
+    EVT_FAULT,              // 检测到故障
+    EVT_FAULT_CLEARED,      // 故障消失
+    EVT_ESTOP,              // STOP按键按下
+    EVT_RESET,              // 显式复位急停锁存
+    EVT_COUNT
+};
+
+/**
+ * @brief 转移守卫（常数时间判断）
+ */
+enum TransitionGuard : uint8_t {
+    GUARD_NONE = 0,
+    GUARD_STOP_RELEASED,    // STOP按键已松开
+    GUARD_SENSORS_OK        // 所有传感器有效、至少一个通道未过温且板温未超限
+};
+
+/**
+ * @brief 守卫使用的输入快照（由拥有者任务在派发前采集）
+ */
+struct SystemInputs {
+    bool stopPressed;       // STOP按键当前是否按下
+    bool sensorsOk;         // 所有通道传感器有效
+    bool allOverTemp;       // 所有通道均已过温锁存
+    bool boardOverTemp;     // 板温/芯片温度超过硬限值，尚未回落（见 BoardDerating.h）
+};
+
+struct TransitionRule {
+    SystemMode to;
+    TransitionGuard guard;
+};
+
+struct TransitionTable {
+    TransitionRule rule[MODE_COUNT][EVT_COUNT];
+};
+
+/**
+ * @brief 各模式的执行器许可
+ */
+struct ModePolicy {
+    bool heating;
+    bool pump;
+};
+
+constexpr ModePolicy kModePolicy[MODE_COUNT] = {
+    { false, false },   // BOOT
+    { false, false },   // IDLE
+    { true,  false },   // WARMUP
+    { true,  true  },   // RUN
+    { true,  false },   // HOLD
+    { false, false },   // VENTING
+    { false, false },   // FAULT
+    { false, false },   // ESTOP_LATCHED
+};
+
+/**
+ * @brief 生成转移表（编译期求值）
+ */
+constexpr TransitionTable buildTransitionTable() {
+    TransitionTable t{};
+
+    // 默认：所有事件都被忽略
+    for (uint8_t m = 0; m < MODE_COUNT; m++) {
+        for (uint8_t e = 0; e < EVT_COUNT; e++) {
+            t.rule[m][e] = { (SystemMode)m, GUARD_NONE };
+        }
+    }
+
+    // 急停优先于一切；锁存状态下再次按下保持锁存
+    for (uint8_t m = 0; m < MODE_COUNT; m++) {
+        t.rule[m][EVT_ESTOP] = { MODE_ESTOP_LATCHED, GUARD_NONE };
+    }
+
+    // 故障：除急停锁存外任意模式进入
+    for (uint8_t m = 0; m < MODE_COUNT; m++) {
+        if (m != MODE_ESTOP_LATCHED) {
+            t.rule[m][EVT_FAULT] = { MODE_FAULT, GUARD_NONE };
+        }
+    }
+
+    t.rule[MODE_BOOT][EVT_BOOT_OK]          = { MODE_IDLE,    GUARD_NONE };
+    t.rule[MODE_BOOT][EVT_BOOT_FAIL]        = { MODE_FAULT,   GUARD_NONE };
+
+    t.rule[MODE_IDLE][EVT_START]            = { MODE_WARMUP,  GUARD_SENSORS_OK };
+
+    t.rule[MODE_WARMUP][EVT_TEMP_REACHED]   = { MODE_RUN,     GUARD_NONE };
+    t.rule[MODE_WARMUP][EVT_STOP]           = { MODE_VENTING, GUARD_NONE };
+
+    t.rule[MODE_RUN][EVT_PAUSE]             = { MODE_HOLD,    GUARD_NONE };
+    t.rule[MODE_RUN][EVT_STOP]              = { MODE_VENTING, GUARD_NONE };
+
+    t.rule[MODE_HOLD][EVT_RESUME]           = { MODE_RUN,     GUARD_NONE };
+    t.rule[MODE_HOLD][EVT_STOP]             = { MODE_VENTING, GUARD_NONE };
+
+    t.rule[MODE_VENTING][EVT_VENTED]        = { MODE_IDLE,    GUARD_NONE };
+
+    t.rule[MODE_FAULT][EVT_FAULT_CLEARED]   = { MODE_IDLE,    GUARD_SENSORS_OK };
+
+    t.rule[MODE_ESTOP_LATCHED][EVT_RESET]   = { MODE_IDLE,    GUARD_STOP_RELEASED };
+
+    return t;
+}
+
+constexpr TransitionTable kTransitionTable = buildTransitionTable();
+
+/**
+ * @brief 一次模式转移的记录（遥测用）
+ */
+struct TransitionRecord {
+    uint32_t timestamp;     // 转移时刻 (ms, millis())
+    SystemMode from;
+    SystemMode to;
+    SystemEvent event;
+};
+
+class SystemStateMachine {
+public:
+    static const uint8_t HISTORY_LEN = 16;     // 保留最近的转移记录条数
+
+    SystemStateMachine();
+
+    /**
+     * @brief 处理一个事件（只能由拥有者任务调用）
+     * @param event 事件
+     * @param inputs 守卫输入快照
+     * @param now_ms 当前时间 (ms)
+     * @return true 发生了模式转移
+     */
+    bool dispatch(SystemEvent event, const SystemInputs& inputs, uint32_t now_ms);
+
+    /**
+     * @brief 当前模式（单字节，其他任务可直接读取）
+     */
+    SystemMode mode() const { return current; }
+
+    /**
+     * @brief 进入当前模式的时刻 (ms)
+     */
+    uint32_t modeSince() const { return enteredAt; }
+
+    bool heatingAllowed() const { return kModePolicy[current].heating; }
+    bool pumpAllowed() const { return kModePolicy[current].pump; }
+
+    /**
+     * @brief 累计转移次数（含已被覆盖的记录）
+     */
+    uint32_t transitionCount() const { return totalTransitions; }
+
+    /**
+     * @brief 可读取的转移记录条数
+     */
+    uint8_t historySize() const;
+
+    /**
+     * @brief 读取转移记录
+     * @param age 0 = 最近一次
+     */
+    const TransitionRecord& history(uint8_t age) const;
+
+    static const char* modeName(SystemMode mode);
+    static const char* eventName(SystemEvent event);
+
+private:
+    volatile SystemMode current;
+    uint32_t enteredAt;
+    uint32_t totalTransitions;
+    TransitionRecord records[HISTORY_LEN];
+
+    static bool guardPasses(TransitionGuard guard, const SystemInputs& inputs);
+};
+
+#endif // SYSTEM_STATE_MACHINE_H
@@ -1,15 +1,23 @@
 /**
  * @file TemperatureSensor.h
  * @brief MAX31855/MAX6675热电偶温度传感器驱动
+ * 
+ * 前端芯片在编译期选择（config.h 中的 THERMO_CHIP），
+ * TemperatureSensor 为对应的 ThermocoupleSensor<Chip> 类型。
+ * 
+ * 驱动强制两次SPI读取之间至少间隔一个转换时间：
+ * 间隔不足时直接返回缓存结果，不拉低CS（拉低CS会中止正在进行的转换）。
  */
 
 #ifndef TEMPERATURE_SENSOR_H
 #define TEMPERATURE_SENSOR_H
 
 #include <Arduino.h>
-#include <Adafruit_MAX31855.h>
+#include "config.h"
+#include "ThermocoupleChip.h"
 
-class TemperatureSensor {
+template <class Chip>
+class ThermocoupleSensor {
 public:
     /**
      * @brief 构造函数
@@ -17,7 +25,7 @@ public:
      * @param cs_pin CS引脚
      * @param miso_pin MISO引脚
      */
-    TemperatureSensor(uint8_t sck_pin, uint8_t cs_pin, uint8_t miso_pin);
+    ThermocoupleSensor(uint8_t sck_pin, uint8_t cs_pin, uint8_t miso_pin);
     
     /**
      * @brief 初始化传感器
@@ -33,27 +41,67 @@ public:
     
     /**
      * @brief 读取内部温度（冷端补偿温度）
-     * @return 内部温度（°C）
+     * @return 内部温度（°C），芯片不支持（MAX6675）时返回NAN
      */
     float readInternalTemperature();
     
+    /**
+     * @brief 读取原始SPI帧（受最小转换间隔约束）
+     * @return 最近一次的原始帧
+     */
+    uint32_t readRawFrame();
+    
     /**
      * @brief 检查传感器是否正常
      * @return true 正常，false 异常
      */
     bool isValid();
     
+    /**
+     * @brief 最近一次 readTemperature() 的结果是否为新读数
+     * @return false 本次读取出错或落在转换间隔内，返回的是上次的值（或NAN）；控制任务不应据此刷新输出
+     */
+    bool isFresh() const { return fresh; }
+    
     /**
      * @brief 获取最后一次读取的温度
      * @return 最后温度值
      */
     float getLastTemperature() const { return lastTemp; }
     
+    /**
+     * @brief 获取最近一次读取的故障类型
+     */
+    ThermoFault getLastFault() const { return lastReading.fault; }
+    
+    static const char* chipName() { return Chip::name(); }
+    
 private:
-    Adafruit_MAX31855* thermocouple;
+    uint8_t sckPin;
+    uint8_t csPin;
+    uint8_t misoPin;
+    uint32_t lastFrame;
+    uint32_t lastFrameTime;     // 上次读帧（CS拉高）的时间
+    bool hasFrame;
+    ThermoReading lastReading;
     float lastTemp;
     uint8_t errorCount;
+    bool fresh;                 // 最近一次 readTemperature() 返回的是新读数
     static const uint8_t MAX_ERROR_COUNT = 3;
+    
+    /**
+     * @brief 转换完成时读取新帧，否则保持缓存
+     * @return true 本次读取了新帧
+     */
+    bool acquire();
 };
 
+#if THERMO_CHIP == THERMO_CHIP_MAX31855
+typedef ThermocoupleSensor<MAX31855Chip> TemperatureSensor;
+#elif THERMO_CHIP == THERMO_CHIP_MAX6675
+typedef ThermocoupleSensor<MAX6675Chip> TemperatureSensor;
+#else
+#error "Unknown THERMO_CHIP"
+#endif
+
 #endif // TEMPERATURE_SENSOR_H
@@ -0,0 +1,88 @@
+/**
+ * @file ThermalIdentifier.h
+ * @brief 加热片热模型辨识（维持功率前馈）
+ *
+ * 一阶模型（u 为PWM占空比，Ta 为环境温度）：
+ *   K * dT/dt = u - G * (T - Ta)
+ * G 为加热片对环境的热导（PWM/°C），K 为热容（PWM·s/°C）。
+ * 稳态维持功率 u_hold = G * (T_set - Ta)：环境温度和贴合程度（热阻）
+ * 都会改变它，10°C环境下可超过PID积分限幅 INTEGRAL_MAX，单靠积分永远到不了目标。
+ *
+ * 辨识：预热全功率阶段 u 恒定，升温速率随温差线性下降：
+ *   dT/dt = u/K - (G/K) * (T - Ta)
+ * 对 (T - Ta, dT/dt) 做直线拟合，截距 a = u/K、斜率 -b = -G/K，得 G = u * b / a。
+ * 环境温度取热电偶冷端温度（板温）。每次预热都重新辨识（贴合程度每次不同），
+ * 辨识失败（升温范围不足、拟合不合理）时用学习值。
+ * 学习值由预热结束后的稳态PID输出修正，按通道保存到NVS。
+ */
+
+#ifndef THERMAL_IDENTIFIER_H
+#define THERMAL_IDENTIFIER_H
+
+#include <Arduino.h>
+
+class ThermalIdentifier {
+public:
+    ThermalIdentifier();
+
+    /**
+     * @brief 从NVS加载本通道的热导学习值
+     * @param channel 通道编号
+     */
+    void begin(uint8_t channel);
+
+    /**
+     * @brief 开始辨识（全功率开始时调用）
+     * @param now_ms 当前时间 (ms)
+     */
+    void start(uint32_t now_ms);
+
+    /**
+     * @brief 加入一个恒定输出下的样本
+     * @param temp 加热片温度 (°C)
+     * @param rate 温度变化率 (°C/s)，NAN时忽略
+     * @param ambient 环境温度 (°C)
+     * @param output 本周期输出（PWM占空比，辨识期间须保持不变）
+     * @param now_ms 当前时间 (ms)
+     */
+    void addSample(float temp, float rate, float ambient, uint8_t output, uint32_t now_ms);
+
+    /**
+     * @brief 结束辨识，成功时本次会话使用辨识出的热导
+     * @return true 辨识成功
+     */
+    bool finish();
+
+    /**
+     * @brief 用稳态平均输出修正热导学习值（保存到NVS）
+     * @param output 稳态平均PWM占空比
+     * @param target 目标温度 (°C)
+     * @param ambient 环境温度 (°C)
+     */
+    void learnSteadyState(float output, float target, float ambient);
+
+    /**
+     * @brief 维持目标温度所需的PWM占空比 G * (target - ambient)
+     */
+    float holdingOutput(float target, float ambient) const;
+
+    bool isIdentifying() const { return identifying; }
+    float getConductance() const { return conductance; }
+    float getLearnedConductance() const { return learnedConductance; }
+
+private:
+    uint8_t channelIndex;
+    float learnedConductance;   // NVS中的学习值 (PWM/°C)
+    float conductance;          // 本次会话使用的热导 (PWM/°C)
+    bool identifying;
+    uint32_t startTime;
+    uint8_t sampleOutput;
+    // 直线拟合累计量：x = T - Ta，y = dT/dt
+    uint16_t n;
+    float sumX, sumY, sumXX, sumXY;
+    float minX, maxX;
+
+    void save();
+};
+
+#endif // THERMAL_IDENTIFIER_H
@@ -0,0 +1,83 @@
+/**
+ * @file ThermocoupleChip.h
+ * @brief 热电偶前端芯片定义（MAX31855 / MAX6675）与统一故障模型
+ * 
+ * 每个芯片是一个 traits 结构体，描述SPI帧格式、转换时间和解码方法，
+ * 供 ThermocoupleSensor<Chip> 在编译期绑定。
+ * 
+ * 两颗芯片在 CS 拉低时都会中止正在进行的转换，CS 拉高后重新开始，
+ * 因此两次读取之间必须间隔至少一个转换时间，否则读到的是上一次的旧结果。
+ */
+
+#ifndef THERMOCOUPLE_CHIP_H
+#define THERMOCOUPLE_CHIP_H
+
+#include <Arduino.h>
+
+/**
+ * @brief 统一故障模型
+ */
+enum ThermoFault {
+    THERMO_FAULT_NONE = 0,
+    THERMO_FAULT_OPEN,          // 热电偶开路
+    THERMO_FAULT_SHORT_GND,     // 热电偶对地短路（仅MAX31855可检测）
+    THERMO_FAULT_SHORT_VCC,     // 热电偶对VCC短路（仅MAX31855可检测）
+    THERMO_FAULT_BUS            // SPI无应答或帧格式错误
+};
+
+/**
+ * @brief 一次解码结果
+ */
+struct ThermoReading {
+    float hotJunction;      // 热电偶温度（°C），故障时为NAN
+    float coldJunction;     // 冷端温度（°C），芯片不支持时为NAN
+    float linearHotJunction;  // 芯片按线性斜率给出的原始热端温度（°C）
+    ThermoFault fault;
+};
+
+/**
+ * @brief MAX31855：32位帧，14位热端(0.25°C) + 12位冷端(0.0625°C)
+ * 
+ * D31-D18 热端温度(有符号) | D16 故障 | D15-D4 冷端温度(有符号)
+ * D2 SCV | D1 SCG | D0 OC | D17、D3 保留为0
+ * 
+ * THERMO_NIST_LINEARIZATION 开启时，hotJunction 为按NIST K型多项式
+ * 重新线性化并做冷端补偿后的温度（见 KTypeThermocouple.h）。
+ */
+struct MAX31855Chip {
+    static const uint8_t FRAME_BITS = 32;
+    static const uint32_t CONVERSION_TIME_MS = 100;     // 最大转换时间
+    static const uint32_t POWER_UP_TIME_MS = 200;
+    static const bool HAS_COLD_JUNCTION = true;
+    
+    static const char* name() { return "MAX31855"; }
+    static ThermoReading decode(uint32_t frame);
+};
+
+/**
+ * @brief MAX6675：16位帧，12位热端(0.25°C，无符号)，无冷端输出
+ * 
+ * D15 恒为0 | D14-D3 温度 | D2 开路 | D1 器件ID恒为0 | D0 三态
+ */
+struct MAX6675Chip {
+    static const uint8_t FRAME_BITS = 16;
+    static const uint32_t CONVERSION_TIME_MS = 220;     // 最大转换时间
+    static const uint32_t POWER_UP_TIME_MS = 500;
+    static const bool HAS_COLD_JUNCTION = false;
+    
+    static const char* name() { return "MAX6675"; }
+    static ThermoReading decode(uint32_t frame);
+};
+
+/**
+ * @brief 软件SPI读取一帧（MSB在前，SPI模式0）
+ * @param bits 帧长度（16或32）
+ */
+uint32_t thermoReadFrame(uint8_t sck_pin, uint8_t cs_pin, uint8_t miso_pin, uint8_t bits);
+
+/**
+ * @brief 故障描述（日志用）
+ */
+const char* thermoFaultName(ThermoFault fault);
+
+#endif // THERMOCOUPLE_CHIP_H
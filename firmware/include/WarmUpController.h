@@ -0,0 +1,136 @@
+/**
+ * @file WarmUpController.h
+ * @brief 最短时间预热（全功率 + 学习的切换点）
+ *
+ * PID 参数为避免在设定点超调而调得保守，从室温升到40°C很慢；
+ * 从远低于目标处直接交给PID，积分项在升温过程中累积，到达目标时又会超调。
+ * 预热分三段（双模控制）：
+ * 1. 全功率：直到预测温度 T + τ * dT/dt 达到目标
+ * 2. 滑行：以维持功率开环输出，靠加热片的热惯性滑到目标附近
+ * 3. 交给PID：温度不再上升（或超过目标+回差）时交给PID，维持功率作为前馈，
+ *    积分项从0开始只补偿模型误差，无扰切换
+ *
+ * τ 为加热片的热滞后，按设备学习：用滑行阶段的峰值相对目标的偏差修正 τ
+ * （超调 -> 提前切换，欠调 -> 推迟切换）。滑行时输出固定，峰值只取决于切换点；
+ * 交给PID之后的超调来自PID本身，不参与 τ 的学习。
+ * 维持功率由热模型按当前环境温度给出（见 ThermalIdentifier.h）：全功率阶段
+ * 同时做热导辨识，交给PID后 WARMUP_OBSERVE_MS 窗口最后1/3内的平均输出用于修正
+ * 热导学习值。τ 按通道保存到NVS。
+ * 每次预热的用时与超调作为报告输出。
+ */
+
+#ifndef WARMUP_CONTROLLER_H
+#define WARMUP_CONTROLLER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "ThermalIdentifier.h"
+
+/**
+ * @brief 本周期加热方式
+ */
+enum WarmUpAction : uint8_t {
+    WARMUP_PID = 0,         // 正常PID
+    WARMUP_FULL_POWER,      // 全功率
+    WARMUP_COAST,           // 以维持功率开环输出（getHoldingOutput()）
+    WARMUP_HANDOFF          // 本周期交给PID
+};
+
+/**
+ * @brief 单次预热的结果
+ */
+struct WarmUpReport {
+    float timeToSetpoint;   // 从开始预热到首次进入 目标-TEMP_HYSTERESIS 的时间 (s)，未到达为NAN
+    float overshoot;        // 整个预热及观察窗口内峰值 - 目标 (°C)
+    float switchTemp;       // 本次切换温度 (°C)
+    float lagSeconds;       // 学习后的热滞后 τ (s)
+    float holdingOutput;    // 观察窗口末段的平均输出（PWM占空比）
+    float conductance;      // 本次使用的热导 (PWM/°C)
+    bool identified;        // 本次全功率阶段热导辨识是否成功
+};
+
+class WarmUpController {
+public:
+    WarmUpController();
+
+    /**
+     * @brief 从NVS加载本通道的热滞后和热导
+     * @param channel 通道编号
+     */
+    void begin(uint8_t channel);
+
+    /**
+     * @brief 开始一次预热（加热从关闭变为开启时调用）
+     * @param temp 当前温度 (°C)
+     * @param now_ms 当前时间 (ms)
+     */
+    void start(float temp, uint32_t now_ms);
+
+    /**
+     * @brief 每个温度周期调用一次
+     * @param temp 当前温度 (°C)
+     * @param rate 温度变化率 (°C/s)，NAN时按0处理
+     * @param target 目标温度 (°C)
+     * @param ambient 环境温度 (°C)
+     * @param output 当前加热输出（PWM 0-255，观察窗口末段用于学习热导）
+     * @param now_ms 当前时间 (ms)
+     * @return 本周期加热方式
+     */
+    WarmUpAction update(float temp, float rate, float target, float ambient,
+                        float output, uint32_t now_ms);
+
+    /**
+     * @brief 中止（加热被关闭）
+     */
+    void cancel();
+
+    /**
+     * @brief 取出一次完成的预热报告
+     * @return true 有新报告
+     */
+    bool takeReport(WarmUpReport& out);
+
+    /**
+     * @brief 维持目标温度所需的PWM占空比（滑行输出，也是PID的前馈）
+     */
+    float getHoldingOutput(float target, float ambient) const {
+        return thermal.holdingOutput(target, ambient);
+    }
+
+    float getLagSeconds() const { return lagSeconds; }
+    ThermalIdentifier& thermalModel() { return thermal; }
+    bool isActive() const { return phase == PHASE_BOOST || phase == PHASE_COAST; }
+    bool hasReport() const { return reportReady; }
+
+private:
+    enum Phase : uint8_t {
+        PHASE_IDLE = 0,
+        PHASE_BOOST,        // 全功率
+        PHASE_COAST,        // 维持功率滑行
+        PHASE_OBSERVE       // 已交给PID，记录峰值
+    };
+
+    Phase phase;
+    uint8_t channelIndex;
+    float lagSeconds;       // 热滞后 τ (s)
+    ThermalIdentifier thermal;
+    uint32_t startTime;
+    uint32_t switchTime;
+    uint32_t handoffTime;
+    float startTemp;
+    float switchTemp;
+    float switchRate;
+    float peakTemp;
+    float coastPeak;        // 滑行结束时的峰值（用于学习 τ）
+    float timeToSetpoint;
+    float outputSum;        // 观察窗口末段的输出累计
+    uint16_t outputCount;
+    bool identified;
+    bool reportReady;
+    WarmUpReport report;
+
+    void finish(float target, float ambient);
+    void save();
+};
+
+#endif // WARMUP_CONTROLLER_H
@@ -0,0 +1,124 @@
+/**
+ * @file WearHistory.h
+ * @brief 泵/密封磨损趋势（疗程指纹的NVS环形缓冲 + 趋势估计 + 维护标志）
+ *
+ * 每个通道保存最近 WEAR_HISTORY_LEN 次疗程的指纹（见 WearTracker.h），
+ * 以及新件基准：各指标前 WEAR_BASELINE_SESSIONS 次有效测量的平均值
+ * （维持泵速、抽气用时按档位分别取基准）。基准齐全后每次疗程折算成相对基准的比值：
+ * - 密封：泄漏率 / 基准
+ * - 泵：维持泵速 / 基准 ÷ 密封比值（稳态 泵增益·泵速 = 泄漏率·负压，扣除漏气变化后只剩泵增益）；
+ *       本次未测到泄漏率时不计入
+ * - 抽气：抽气用时 / 同档位基准
+ *
+ * 趋势：对最近 WEAR_TREND_WINDOW 次疗程的比值按疗程序号做 Theil-Sen 直线拟合（两两斜率取中位数），
+ * 取拟合线在最近一次疗程处的值和每次疗程的斜率；单次异常疗程不会单独触发维护标志。
+ * 拟合值超过 WEAR_PUMP_LIMIT / WEAR_PULLDOWN_LIMIT（泵）或 WEAR_SEAL_LIMIT（密封）时置维护标志；
+ * 标志保存在NVS中，更换部件后调用 rebaseline() 清除并重新学习基准。
+ *
+ * 只在疗程结束时计算并写一次闪存。只在压力任务中调用，无锁。
+ */
+
+#ifndef WEAR_HISTORY_H
+#define WEAR_HISTORY_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "WearTracker.h"
+
+#define WEAR_FLAG_PUMP  (1u << 0)   // 泵需要维护
+#define WEAR_FLAG_SEAL  (1u << 1)   // 密封需要维护
+
+/**
+ * @brief 单个指标的趋势
+ */
+struct WearMetricTrend {
+    uint8_t points;         // 参与拟合的疗程数，0 = 基准未齐或无测量
+    float level;            // 拟合线在最近一次疗程处的值（相对基准，1 = 新件）
+    float slope;            // 每次疗程的变化
+    float sessionsToLimit;  // 按当前斜率再过多少次疗程达到限值，不上升为NAN
+};
+
+/**
+ * @brief 疗程结束时的趋势报告
+ */
+struct WearReport {
+    WearFingerprint fingerprint;    // 本次指纹（已填疗程序号）
+    WearMetricTrend pump;
+    WearMetricTrend pullDown;
+    WearMetricTrend seal;
+    uint8_t flags;                  // 当前维护标志（WEAR_FLAG_*）
+    uint8_t newFlags;               // 本次新置位的标志
+    bool baselineReady;             // 三项基准是否都已学完
+};
+
+class WearHistory {
+public:
+    WearHistory();
+
+    /**
+     * @brief 从NVS加载本通道的指纹和基准
+     * @param channel 通道编号
+     */
+    void begin(uint8_t channel);
+
+    /**
+     * @brief 追加一次疗程指纹，更新基准和趋势，保存到NVS
+     * @param fp 本次指纹（疗程序号由此处分配）
+     * @param report 输出：趋势报告
+     */
+    void add(const WearFingerprint& fp, WearReport& report);
+
+    /**
+     * @brief 按当前历史计算趋势（不修改状态，可对合成的历史调用）
+     */
+    void evaluate(WearReport& report) const;
+
+    uint8_t flags() const { return maintFlags; }
+    uint8_t count() const { return used; }
+    uint16_t sessionCount() const { return sessions; }
+
+    /**
+     * @brief 按新旧顺序取指纹
+     * @param age 0 = 最新
+     */
+    const WearFingerprint& get(uint8_t age) const;
+
+    /**
+     * @brief 更换泵或密封后：清除指纹、基准和维护标志，重新学习基准
+     */
+    void rebaseline();
+
+private:
+    /**
+     * @brief 新件基准（各指标前几次有效测量的平均）
+     */
+    struct Baseline {
+        float holdDuty[PRESSURE_NUM_GEARS];
+        float pullDown[PRESSURE_NUM_GEARS];
+        float leakRate;
+        uint8_t holdCount[PRESSURE_NUM_GEARS];
+        uint8_t pullCount[PRESSURE_NUM_GEARS];
+        uint8_t leakCount;
+    };
+    struct Stored;          // NVS中的存储格式（见 WearHistory.cpp）
+
+    void learnBaseline(const WearFingerprint& fp);
+    bool sealRatio(const WearFingerprint& fp, float& ratio) const;
+    bool pumpRatio(const WearFingerprint& fp, float& ratio) const;
+    bool pullDownRatio(const WearFingerprint& fp, float& ratio) const;
+
+    template <class RatioFn>
+    WearMetricTrend fit(RatioFn ratio, float limit) const;
+
+    void save();
+
+    WearFingerprint ring[WEAR_HISTORY_LEN];
+    Baseline baseline;
+    uint8_t head;           // 下一条写入位置
+    uint8_t used;
+    uint16_t sessions;      // 本通道累计疗程数（指纹序号）
+    uint8_t maintFlags;
+    uint8_t channelIndex;
+};
+
+#endif // WEAR_HISTORY_H
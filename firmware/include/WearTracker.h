@@ -0,0 +1,104 @@
+/**
+ * @file WearTracker.h
+ * @brief 单次疗程的泵/密封指纹采集
+ *
+ * 泵老化后同样的占空比抽气变慢，密封圈变硬后腔体漏气变快，用户抱怨之前看不出来。
+ * 每次疗程从压力任务的采样中提取三个指标（指纹），疗程结束时交给 WearHistory 做趋势：
+ * - 维持各档位所需泵速：负压在目标 ±WEAR_HOLD_BAND 内稳定后泵速的时间加权平均
+ * - 抽气用时：泵从接近大气压启动到负压达到目标的 WEAR_PULLDOWN_FRACTION
+ * - 泄漏率：泵停止后（暂停、泄压）负压按 v' = -k·v 衰减
+ *
+ * 泄压时加热片同时降温，腔内气体收缩使负压上升，与漏气同一量级，不扣除时泄漏率偏低数倍，
+ * 且随环境温度变化。按气体定律扣除（与 PressureController.h 的前馈相同）：
+ *   u = v + (P / T) * k * (S - S0)，du/dt = -k_leak * v
+ * 对 u0 - u 与 ∫v dt 做过原点的最小二乘，斜率即泄漏率。
+ *
+ * 稳态时 泵增益·泵速 = 泄漏率·负压，维持泵速同时反映泵和密封；
+ * 泵停止时的衰减只反映密封，两者相除即可分开（见 WearHistory.h）。
+ *
+ * 只在压力任务中调用，无锁。
+ */
+
+#ifndef WEAR_TRACKER_H
+#define WEAR_TRACKER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * @brief 单次疗程指纹（保存在NVS中，修改布局需同时修改 WearHistory 的存储版本）
+ */
+struct WearFingerprint {
+    uint16_t session;                       // 本通道疗程序号
+    uint16_t pullDownDs;                    // 抽气用时 (0.1 s)，0 = 未测到
+    uint8_t pullDownGear;                   // 抽气用时对应的档位 (1-10)，0 = 未测到
+    uint8_t reserved;
+    uint16_t holdDuty[PRESSURE_NUM_GEARS];  // 维持各档所需泵速 (0.01%)，0 = 本次未维持该档
+    float leakRate;                         // 泄漏率 (1/s)，NAN = 未测到
+};
+
+class WearTracker {
+public:
+    WearTracker();
+
+    /**
+     * @brief 开始一次疗程（清空上次的统计）
+     */
+    void beginSession(uint32_t now);
+
+    /**
+     * @brief 每次压力采样后调用（疗程外直接返回）
+     * @param pumpRunning 泵是否运行
+     * @param speed 泵速 (%)
+     * @param target 目标负压 (mmHg)
+     * @param vacuum 负压 (mmHg)，已做温漂补偿
+     * @param padTemp 加热片温度 (°C)，样本过期为NAN（本段衰减作废）
+     */
+    void observe(uint32_t now, bool pumpRunning, uint8_t speed, float target, float vacuum, float padTemp);
+
+    /**
+     * @brief 结束疗程并生成指纹
+     * @return false 本次疗程没有测到任何指标（如预热中被停止）
+     */
+    bool endSession(WearFingerprint& out);
+
+    bool inSession() const { return active; }
+
+    /**
+     * @brief 目标负压 -> 档位 (1-10)，与压力任务的 目标 = 默认目标 * 档位 / 档数 对应
+     */
+    static uint8_t gearOf(float target);
+
+private:
+    void finishDecay();
+
+    bool active;
+    uint32_t lastMs;
+    bool lastPumpRunning;
+    float lastTarget;
+
+    // 抽气用时
+    uint32_t pullStartMs;           // 0 = 未在抽气
+    uint16_t pullDownDs;
+    uint8_t pullDownGear;
+
+    // 维持泵速（按档位累计 泵速*时间 和 时间）
+    uint32_t holdSince;             // 0 = 不在维持带内
+    float holdDutyMs[PRESSURE_NUM_GEARS];
+    uint32_t holdMs[PRESSURE_NUM_GEARS];
+
+    // 泵停止后的衰减：y = u0 - u 对 x = ∫v dt 的过原点最小二乘
+    bool decaying;
+    uint32_t decayStartMs;
+    uint32_t decayLastMs;
+    float decayPad0;            // 衰减开始时的加热片温度
+    float decayU0;
+    float decayLastV;
+    float decayIntegral;        // ∫v dt (mmHg·s)
+    float sumXX, sumXY;
+    uint16_t decayCount;
+    float leakWeighted;             // 各段衰减的 泄漏率*时长 之和
+    float leakSeconds;
+};
+
+#endif // WEAR_TRACKER_H
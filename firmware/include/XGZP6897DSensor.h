@@ -0,0 +1,106 @@
+/**
+ * @file XGZP6897DSensor.h
+ * @brief XGZP6897D压力传感器驱动（数字I2C，内置温度）
+ * 
+ * 通信协议:
+ * - I2C地址: 0x6D
+ * - 命令寄存器 0x30:
+ *   bit3   SCO   写1启动转换，完成后自动清零
+ *   bit2:0 模式  000单次温度 / 001单次压力 / 010单次组合 / 011休眠(周期组合)
+ *   bit7:4 休眠时间（周期模式，n * 62.5ms）
+ * - 数据寄存器: 0x06-0x08 压力(24位有符号) / 0x09-0x0A 温度(16位有符号)
+ * - P_CONFIG 0xA6: bit2:0 压力过采样率 OSR_P
+ * - 转换公式: P(Pa) = raw24 / K，T(°C) = raw16 / 256
+ *   K 由量程决定（见 config.h XGZP6897D_K_FACTOR）
+ */
+
+#ifndef XGZP6897D_SENSOR_H
+#define XGZP6897D_SENSOR_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "PressureSensorBase.h"
+
+/**
+ * @brief 压力过采样率（P_CONFIG bit2:0）
+ */
+enum XGZPOversampling {
+    XGZP_OSR_1024X  = 0x00,
+    XGZP_OSR_2048X  = 0x01,
+    XGZP_OSR_4096X  = 0x02,
+    XGZP_OSR_8192X  = 0x03,
+    XGZP_OSR_256X   = 0x04,
+    XGZP_OSR_512X   = 0x05,
+    XGZP_OSR_16384X = 0x06,
+    XGZP_OSR_32768X = 0x07
+};
+
+/**
+ * @brief 转换模式
+ */
+enum XGZPConversionMode {
+    XGZP_MODE_SINGLE_SHOT,  // 每次触发一次组合转换（控制回路默认）
+    XGZP_MODE_PERIODIC      // 休眠模式：传感器按固定间隔自行转换，无需触发
+};
+
+class XGZP6897DSensor : public PressureSensorBase<XGZP6897DSensor> {
+public:
+    static const uint8_t DEFAULT_ADDR = 0x6D;
+
+    /**
+     * @brief 构造函数
+     * @param sda_pin I2C SDA引脚
+     * @param scl_pin I2C SCL引脚
+     * @param i2c_addr I2C地址（0表示默认0x6D）
+     * @param k_factor 量程系数K（P(Pa) = raw / K）
+     */
+    XGZP6897DSensor(uint8_t sda_pin, uint8_t scl_pin, uint8_t i2c_addr = 0,
+                    uint16_t k_factor = XGZP6897D_K_FACTOR);
+    
+    const char* modelName() const { return "XGZP6897D"; }
+    
+    /**
+     * @brief 设置压力过采样率（begin之前或之后均可调用）
+     * @note 过采样率越高噪声越低，转换时间越长
+     */
+    bool setOversampling(XGZPOversampling osr);
+    
+    /**
+     * @brief 设置转换模式
+     * @param mode 单次/周期
+     * @param period_code 周期模式的休眠时间代码（1-15，n * 62.5ms）
+     */
+    bool setMode(XGZPConversionMode mode, uint8_t period_code = 1);
+    
+    /**
+     * @brief 获取最后一次组合转换得到的传感器温度
+     * @return 温度（°C）
+     */
+    float getLastSensorTemperature() const { return lastSensorTemp; }
+    
+private:
+    friend class PressureSensorBase<XGZP6897DSensor>;
+    
+    static const uint8_t P_CONFIG_REG = 0xA6;
+    static const uint8_t OSR_MASK = 0x07;
+    
+    static const uint8_t MODE_COMBINED = 0x02;  // 单次组合转换（压力+温度）
+    static const uint8_t MODE_SLEEP = 0x03;     // 休眠模式（周期组合转换）
+    
+    uint16_t kFactor;
+    XGZPOversampling oversampling;
+    XGZPConversionMode mode;
+    uint8_t periodCode;
+    float lastSensorTemp;
+    
+    bool configure();
+    uint8_t measurementCommand() const { return CMD_SCO | MODE_COMBINED; }
+    uint32_t conversionTimeMs() const;
+    bool triggerConversion();
+    bool fetchRaw(int32_t& raw24);
+    float convertToPressure(int32_t raw24) const;
+    bool applyOversampling();
+    bool applyMode();
+};
+
+#endif // XGZP6897D_SENSOR_H
@@ -11,9 +11,11 @@
 // ============ GPIO引脚定义 ============
 // 根据 README.md 更新的引脚映射
 
-// 状态LED
+// 状态LED（固件未使用；双腔体主控板上这两个引脚分给通道1，见下）
+#if !defined(NUM_CHANNELS) || NUM_CHANNELS == 1
 #define LED1_PIN            0   // LED2 (GPIO0)
 #define LED2_PIN            3   // LED1 (GPIO3)
+#endif
 
 // 加热片控制 (PWM)
 #define HEATING_PAD_PIN     1   // GPIO1 PWM控制加热丝
@@ -21,22 +23,65 @@
 // 真空泵控制 (PWM)
 #define PUMP_PWM_PIN        2   // GPIO2 PWM控制负压泵
 
-// MAX31855热电偶模块 (SPI)
+// MAX31855/MAX6675热电偶模块 (SPI)
 #define THERMO_CLK_PIN      4   // GPIO4 SCK
 #define THERMO_MISO_PIN     5   // GPIO5 MISO
 #define THERMO_CS_PIN       7   // GPIO7 CS
 
+// 热电偶前端芯片（编译期选择，可通过 build_flags -DTHERMO_CHIP=n 覆盖）
+#define THERMO_CHIP_MAX31855    1   // 14位热端 + 冷端输出
+#define THERMO_CHIP_MAX6675     2   // 备选BOM：12位，无冷端输出
+#ifndef THERMO_CHIP
+#define THERMO_CHIP         THERMO_CHIP_MAX31855
+#endif
+#define THERMO_NIST_LINEARIZATION   1   // MAX31855: 按NIST K型多项式线性化 + 冷端补偿
+
 // 蜂鸣器 (PWM, 2.731kHz)
 #define BUZZER_PIN          6   // GPIO6 PWM输出
 
-// 压力传感器 XGZP6897D (I2C)
+// 压力传感器 CPS610DSD003DH01 / XGZP6897D (I2C)
 #define PRESSURE_SDA_PIN    8   // GPIO8 I2C SDA
 #define PRESSURE_SCL_PIN    9   // GPIO9 I2C SCL
+#define PRESSURE_I2C_ADDR_AUTO  0x00    // 0 = 使用型号默认地址（AUTO型号时扫描识别）
+#define PRESSURE_I2C_ADDR   PRESSURE_I2C_ADDR_AUTO
 
 // 按键
 #define BUTTON_STOP_PIN     10  // GPIO10 急停按键 (原为GPIO11，但GPIO11保留，用GPIO10)
 #define BUTTON_UP_PIN       20  // GPIO20 增加负压档位
 #define BUTTON_DOWN_PIN     21  // GPIO21 减少负压档位
+#define BUTTON_RESET_HOLD_MS    2000    // UP+DOWN同时长按：解除急停锁存
+#define BUTTON_SESSION_STOP_MS  2000    // DOWN长按：结束疗程（泄压）
+
+// ============ 多通道配置 ============
+// 每个通道 = 一个独立眼罩腔体（压力传感器 + 热电偶 + 加热片 + 负压泵）
+// 当前镜框为单腔体；左右眼独立腔体的新镜框设为2
+#ifndef NUM_CHANNELS
+#define NUM_CHANNELS        1
+#endif
+#if NUM_CHANNELS < 1 || NUM_CHANNELS > 2
+#error "NUM_CHANNELS 只支持 1 或 2（只定义了通道1的引脚）"
+#endif
+
+// 第二通道（右眼）引脚，双腔体主控板
+// ESP32-C3 可用的 GPIO 只有 0-10、20、21（12-17 为闪存，18/19 为 USB 串口），单腔体已全部占用：
+// - 加热片、泵使用单腔体的两个 LED 引脚，双腔体板不装状态LED
+// - 热电偶与通道0共用SCK/MISO，CS 使用 GPIO11：默认为闪存供电脚 VDD_SPI，
+//   需烧写 eFuse VDD_SPI_AS_GPIO，之后 VDD_SPI 不再给闪存供电。
+//   Super Mini 的 ESP32-C3FH4 封装内闪存由 VDD_SPI 供电，不能烧写（烧写后无法启动），
+//   双腔体板须使用闪存由 3V3 供电的模组，并以 -DBOARD_VDD_SPI_AS_GPIO=1 编译（见下方引脚检查）
+// - 压力传感器与通道0共用I2C总线，必须使用不同的I2C地址
+// - LEDC 通道 4/5：与通道0（0/1）、蜂鸣器（2）不共用定时器（见 ledcTimerOf()）
+#define CH1_HEATING_PAD_PIN     0
+#define CH1_PUMP_PWM_PIN        3
+#define CH1_THERMO_CS_PIN       11
+#define CH1_PRESSURE_I2C_ADDR   0x6D
+#define CH1_PWM_CHANNEL_HEAT    4
+#define CH1_PWM_CHANNEL_PUMP    5
+
+// 已烧写 eFuse VDD_SPI_AS_GPIO（GPIO11 可作普通IO）；默认未烧写，GPIO11 保留
+#ifndef BOARD_VDD_SPI_AS_GPIO
+#define BOARD_VDD_SPI_AS_GPIO   0
+#endif
 
 // ============ 系统参数 ============
 
@@ -46,12 +91,64 @@
 #define TEMP_MIN_LIMIT      35.0f   // 最低温度限制
 #define TEMP_HYSTERESIS     0.5f    // 温度回差（°C）
 
+// 预热（全功率 + 学习的切换点，见 WarmUpController.h）
+#define WARMUP_LAG_DEFAULT_S    5.0f    // 热滞后初值 (s)
+#define WARMUP_LAG_MAX_S        60.0f   // 热滞后上限 (s)
+#define WARMUP_LEARN_GAIN       0.5f    // 每次预热对超调的修正比例
+#define WARMUP_OBSERVE_MS       60000   // 交给PID后观察的时间（学习维持功率），也是滑行的最长时间
+#define WARMUP_MIN_RISE         3.0f    // 全功率阶段升温不足此值（°C）不参与学习
+#define WARMUP_HOLD_LEARN_BAND  2.0f    // 超调/欠调超过此值（°C）时不学习维持功率
+
+// 加热片热模型（维持功率前馈，见 ThermalIdentifier.h）
+#define THERMAL_G_DEFAULT       4.5f    // 热导初值 (PWM/°C)，首次预热后按实测更新
+#define THERMAL_G_MIN           0.5f    // 热导合理范围，超出视为辨识失败
+#define THERMAL_G_MAX           30.0f
+#define THERMAL_ID_SKIP_MS      5000    // 全功率开始后跳过的时间（变化率窗口 + 加热丝升温）
+#define THERMAL_ID_MIN_SAMPLES  8       // 辨识所需最少样本数
+#define THERMAL_ID_MIN_SPAN     3.0f    // 辨识所需最小温差范围 (°C)
+#define THERMAL_LEARN_MIN_DELTA 5.0f    // 目标与环境温差小于此值（°C）时不学习热导
+#define THERMAL_AMBIENT_FALLBACK 25.0f  // 无冷端温度（MAX6675）时假定的环境温度 (°C)
+
 // 压力控制参数（负压）
 #define PRESSURE_TARGET_DEFAULT 15.0f  // 默认目标负压（mmHg）- 固定15mmHg
 #define PRESSURE_MIN_GEAR   10.0f      // 最小档位负压 (mmHg)
 #define PRESSURE_MAX_GEAR   100.0f     // 最大档位负压 (mmHg)
 #define PRESSURE_GEAR_STEP  10.0f      // 每档增减 10%
 #define PRESSURE_NUM_GEARS  10         // 总共10档
+#define KPA_TO_MMHG         7.50062f   // 1 kPa = 7.50062 mmHg
+
+// 负压控制（PI + 温度耦合前馈，见 PressureController.h）
+#define PRESSURE_KP             4.0f    // 比例系数 (%/mmHg)
+#define PRESSURE_KI             2.0f    // 积分系数 (%/(mmHg·s))
+#define PRESSURE_PUMP_GAIN      0.125f  // 泵每1%占空比的抽气速率 ((mmHg/s)/%)，按实物标定
+#define PRESSURE_ATM_MMHG       760.0f  // 大气压 (mmHg)
+#define PRESSURE_FF_COUPLING    0.6f    // 腔内气温变化 / 加热片温度变化，按实物标定
+#ifndef PRESSURE_THERMAL_FF
+#define PRESSURE_THERMAL_FF     1       // 1 = 启用温度->压力前馈
+#endif
+#define TEMP_RATE_WINDOW        8       // 温度变化率拟合窗口（样本数，8 x 500ms）
+
+// 压力传感器型号（编译期选择，可通过 build_flags -DPRESSURE_SENSOR_MODEL=n 覆盖）
+#define PRESSURE_MODEL_AUTO              0  // 启动时按I2C地址识别（0x7F / 0x6D）
+#define PRESSURE_MODEL_CPS610DSD003DH01  1
+#define PRESSURE_MODEL_XGZP6897D         2
+#ifndef PRESSURE_SENSOR_MODEL
+#define PRESSURE_SENSOR_MODEL   PRESSURE_MODEL_AUTO
+#endif
+
+// 压力零点温漂补偿（板温取热电偶冷端温度）
+#define PRESSURE_DRIFT_TEMP_MIN         10.0f   // 曲线起点（°C），共11个节点
+#define PRESSURE_DRIFT_TEMP_STEP        5.0f    // 节点间隔（°C）
+#define PRESSURE_DRIFT_SETTLE_MS        60000   // 泄压完成回到待机后再等待的时间（泄压门限内的残余负压漏完）
+#define PRESSURE_DRIFT_LEARN_BAND       0.10f   // 平均读数绝对值小于此值（kPa）才视为通大气，须比泄压门限严
+#define PRESSURE_DRIFT_AVG_SAMPLES      16      // 每次学习平均的连续样本数
+#define PRESSURE_DRIFT_SPREAD_BAND      0.03f   // 样本极差上限（kPa），腔体仍在回气时超出
+#define PRESSURE_DRIFT_LEARN_RATE_MIN   0.02f   // 学习步长下限
+#define PRESSURE_DRIFT_SAVE_INTERVAL_MS 300000  // NVS保存最小间隔（5分钟）
+
+// XGZP6897D 参数
+#define XGZP6897D_K_FACTOR  2048    // 量程系数K，P(Pa) = raw / K（2~4kPa量程对应2048）
+#define XGZP6897D_OSR       0x00    // 压力过采样率 OSR_P（0x00 = 1024X）
 
 // PWM参数
 #define PWM_FREQUENCY       5000    // PWM频率 (Hz) - 加热和泵
@@ -65,6 +162,89 @@
 #define TEMP_EMERGENCY_STOP 50.0f   // 紧急停机温度
 #define OVERHEAT_TIMEOUT_MS 3000    // 过热超时时间(ms)
 
+// 系统状态机
+#define WARMUP_TEMP_MARGIN      1.0f    // 温度达到 目标-余量 即视为预热完成（°C）
+#define VENT_PRESSURE_BAND      1.0f    // 负压低于此值视为泄压完成（mmHg）
+
+// 事件总线（见 EventBus.h）
+#define BUS_POOL_SIZE           16      // 事件池槽位数
+#define BUS_MAILBOX_LEN         8       // 每个订阅者的邮箱长度
+#define BUS_LATENCY_BUDGET_US   10000   // 发布到订阅者取出的延迟预算 (µs)
+#define UI_ACTIVE_POLL_MS       20      // 按键按住/消抖期间的扫描周期（空闲时等按键中断）
+#define UI_STATUS_PERIOD_MS     10000   // 系统状态打印周期
+
+// 主机链路（见 HostLink.h、LinkProtocol.h）
+#define LINK_RPC_PER_WAKE       4       // 界面任务每批最多处理的请求数
+#define LINK_RPC_INTERVAL_MS    10      // 两批请求之间的最小间隔（限制主机请求占用的CPU，见 ResponseTime.h）
+#define TELEMETRY_DEFAULT_PERIOD_MS 0   // 上电时的遥测周期，0 = 关闭（串口监视器不出现二进制帧）
+#define TELEMETRY_MIN_PERIOD_MS 20      // 主机可设定的遥测周期范围
+#define TELEMETRY_MAX_PERIOD_MS 10000
+#define LINK_RX_BUFFER_SIZE     1024    // 串口接收缓冲，放得下 LINK_RPC_PER_WAKE 个满载请求帧（主机流水线发送）
+
+// 固件升级（见 FirmwareUpdate.h）
+#define UPDATE_SECTOR_SIZE      4096    // 闪存擦除单位；每个升级请求最多擦写一个扇区
+#define UPDATE_CHECKPOINT_SECTORS 4     // 每写这么多扇区在 NVS 保存一次断点（断点之后的部分重传）
+#define UPDATE_HASH_CHUNK       16384   // 校验正在运行的镜像时每个请求计算的字节数
+#define UPDATE_REBOOT_DELAY_MS  200     // 升级完成应答发出后到重启的时间
+#define UPDATE_TRIAL_MAX_BOOTS  3       // 新固件试运行期间最多启动次数（没等到自检结果就复位，视为失败）
+
+// 上电自检（见 SelfTest.h）；阈值由 tests/test_self_test.cpp 在仿真的正常/故障硬件上检查
+#define POST_BUDGET_MS          4000    // 自检总时长上限（所有通道、所有检查同时进行）
+#define POST_BASELINE_MS        750     // 执行器关闭的基线采样时长（合理性检查）
+#define POST_TEMP_SAMPLE_MS     250     // 自检期间温度采样间隔（不短于 MAX6675 转换时间）
+#define POST_TEMP_MIN           -10.0f  // 上电时加热片/板温合理范围 (°C)
+#define POST_TEMP_MAX           TEMP_EMERGENCY_STOP
+#define POST_TEMP_NOISE         1.0f    // 基线期间温度最大波动 (°C)
+#define POST_TEMP_AGREEMENT     20.0f   // 加热片与冷端（板温）最大温差 (°C)
+#define POST_REST_SLOPE_MAX     0.6f    // 未加热时允许的最大升温速率 (°C/s)，超过视为加热开关管短路
+#define POST_HEATER_PULSE_MS    2000    // 加热脉冲最长时长（全功率，达到温升即提前结束）
+#define POST_HEATER_MIN_RISE    0.75f   // 自检结束前应达到的温升 (°C)，3个热电偶LSB
+#define POST_HEATER_SKIP_TEMP   38.0f   // 加热片已高于此温度时跳过加热脉冲（热启动）
+#define POST_PUMP_BURST_MS      1500    // 抽气脉冲最长时长（达到负压即提前结束）
+#define POST_PUMP_SPEED         100     // 抽气脉冲泵速 (%)
+#define POST_PUMP_MIN_RISE      3.0f    // 自检结束前应达到的负压增加 (mmHg)
+#define POST_VACUUM_MIN         -5.0f   // 上电时负压合理范围 (mmHg)
+#define POST_VACUUM_MAX         PRESSURE_MAX_GEAR
+#define POST_PRESSURE_NOISE     2.0f    // 基线期间负压最大波动 (mmHg)
+#define FAULT_LOG_LEN           16      // 故障日志条数（NVS环形缓冲，见 FaultLog.h）
+
+// 泵/密封磨损趋势（见 WearTracker.h、WearHistory.h）
+#define WEAR_HISTORY_LEN        24      // 每通道保存的疗程指纹数（NVS环形缓冲）
+#define WEAR_BASELINE_SESSIONS  5       // 各指标前几次有效测量的平均值作为新件基准
+#define WEAR_TREND_WINDOW       8       // 趋势拟合使用的最近疗程数
+#define WEAR_TREND_MIN_POINTS   4       // 少于此数不判定维护标志
+#define WEAR_HOLD_BAND          1.0f    // |目标-负压| 小于此值视为维持 (mmHg)
+#define WEAR_HOLD_SETTLE_MS     3000    // 进入维持带后等待多久开始统计泵速
+#define WEAR_HOLD_MIN_MS        10000   // 一个档位累计维持满此时长才计入指纹
+#define WEAR_PULLDOWN_FRACTION  0.9f    // 负压达到目标的此比例即视为抽气完成
+#define WEAR_LEAK_MIN_VACUUM    1.5f    // 泄漏率拟合只用高于此负压的样本 (mmHg)
+#define WEAR_LEAK_MIN_MS        3000    // 泵停止后至少观察多久才计算泄漏率
+#define WEAR_PUMP_LIMIT         1.35f   // 泵效率下降：扣除泄漏变化后的维持泵速 / 基准
+#define WEAR_PULLDOWN_LIMIT     1.5f    // 抽气用时 / 基准
+#define WEAR_SEAL_LIMIT         1.6f    // 泄漏率 / 基准
+
+// 板温降额（见 BoardDerating.h）：温度在 START..FULL 之间时占空比上限线性降到 *_MIN
+#define DERATE_BOARD_START      45.0f   // 板温（热电偶冷端）开始降额 (°C)
+#define DERATE_BOARD_FULL       60.0f   // 板温降到最低上限
+#define DERATE_BOARD_LIMIT      65.0f   // 板温硬限值：输出关断、报警、进入故障模式
+#define DERATE_MCU_START        70.0f   // 芯片内部温度开始降额 (°C)
+#define DERATE_MCU_FULL         85.0f
+#define DERATE_MCU_LIMIT        95.0f
+#define DERATE_RECOVER_MARGIN   5.0f    // 两个温度都降到硬限值以下此值后解除报警
+#define DERATE_HEATER_MIN       0.2f    // 加热占空比上限的最低值（相对满功率）
+#define DERATE_PUMP_MIN         0.5f    // 泵速上限的最低值（泵发热少，保留维持负压的能力）
+#define DERATE_FILTER_ALPHA     0.2f    // 温度一阶低通系数（每个安全监控周期，500ms）
+
+// 热路径放置与基准测试（见 HotPath.h、EmergencyStop.h）
+#ifndef HOT_PATH_IRAM
+#define HOT_PATH_IRAM           1       // 1 = 控制更新函数放入IRAM（急停中断始终在IRAM）
+#endif
+#ifndef HOT_PATH_BENCH
+#define HOT_PATH_BENCH          0       // 1 = 基准模式：交替连续写NVS，统计控制回路最坏执行时间
+#endif
+#define HOT_PATH_BENCH_PHASE_MS     10000   // 基准模式每个阶段（不写 / 连续写闪存）的时长
+#define HOT_PATH_BENCH_WRITE_BYTES  256     // 基准模式每次写入NVS的字节数
+
 // FreeRTOS任务优先级
 #define TASK_PRIORITY_HIGH      3
 #define TASK_PRIORITY_NORMAL    2
@@ -79,5 +259,103 @@
 #define TEMP_SAMPLE_PERIOD_MS   500    // 温度采样周期
 #define PRESSURE_SAMPLE_PERIOD_MS 100  // 压力采样周期
 #define CONTROL_UPDATE_PERIOD_MS 200   // 控制更新周期
+#define SAFETY_MONITOR_PERIOD_MS 500   // 安全监控周期（条件检查、板温降额）
+#define SAMPLE_STALE_PERIODS    5      // 样本超过 N 个采样周期未更新即视为过期（见 SampleHub.h）
+
+// 执行器输出租约（见 OutputLease.h）：超过租约时限未刷新的输出由定时器清零
+// 最坏归零延迟 = 租约时限 + 检查周期 + 定时器服务任务的响应时间（从最后一次刷新算起，见 ResponseTime.h）
+#define HEATER_LEASE_MS         (TEMP_SAMPLE_PERIOD_MS * 2 + 200)      // 容许漏掉一次温度采样
+#define PUMP_LEASE_MS           (PRESSURE_SAMPLE_PERIOD_MS * 2 + 50)   // 容许漏掉一次压力采样
+#define OUTPUT_LEASE_CHECK_MS   50      // 租约检查周期
+
+// 响应时间分析（见 ResponseTime.h）：各任务每次作业的最坏执行时间预算 (µs)
+// 基准构建（pio run -e hotpath_bench）实测的回路最坏时间和NVS单次写入时间超过预算时，
+// 基准报告会标出并按实测值重算；预算改动后固件和主机仿真都会重新做编译期检查
+#define RTA_WCET_TICK_US        5       // 系统节拍中断
+#define RTA_WCET_SUPERVISOR_US  500     // 状态机一次转移（含总线发布、一行打印的格式化）
+#define RTA_WCET_TEMP_US        1500    // 温度任务一个时间片：热电偶读取、PID、一行打印
+#define RTA_WCET_PRESSURE_US    1500    // 压力任务一个时间片：I2C触发与读取（不含转换等待）、PI、一行打印
+#define RTA_PRESSURE_CONVERSION_US 8000 // 压力任务挂起等待转换（CPS610 8ms；XGZP6897D 1024X 6ms，OSR越高越长）
+#define RTA_WCET_SAFETY_US      2000    // 安全监控一个周期：芯片温度读取、样本检查、报警
+#define RTA_WCET_UI_SCAN_US     300     // 界面任务一次按键扫描
+#define RTA_WCET_UI_STATUS_US   5000    // 界面任务一次状态打印（十几行格式化）
+#define RTA_WCET_RPC_US         250     // 界面任务处理一个主机请求（解码、执行、应答组帧写出）
+#define RTA_WCET_TELEMETRY_US   300     // 遥测任务一帧（读样本、编码、写出）
+#define RTA_WCET_TIMER_US       100     // 定时器服务任务：租约检查 + 蜂鸣器换音符
+#define RTA_NVS_WRITE_US        2000    // 一次NVS条目写入，期间缓存关闭、不可抢占
+#define RTA_FLASH_ERASE_US      20000   // NVS页满时擦除一个扇区（一次连续写入中最多一次）
+#define RTA_NVS_BURST_WRITES    2       // 控制运行中一次连续写入的条数（预热完成：热滞后 + 热导学习值）
+#define RTA_NVS_MIN_INTERVAL_MS 1000    // 两次连续写入的最小间隔
+#define RTA_SERIAL_HOLD_US      5000    // 一次 safePrint 持有串口锁的最长时间（256字节，USB CDC 64字节/ms）
+
+// ============ 引脚冲突检查 ============
+// 新增引脚或改通道数时一并更新下表，以下情况编译失败：
+// - 同一 GPIO / LEDC 通道分给两个功能
+// - 使用保留的 GPIO：12-17 闪存、18/19 USB 串口、11 VDD_SPI（未定义 BOARD_VDD_SPI_AS_GPIO 时）
+// - 两个LEDC通道共用定时器但频率不同：ledcSetup() 设置的是定时器，后调用的会改掉另一个的PWM频率
+
+/**
+ * @brief arduino-esp32 2.x 中LEDC通道使用的定时器（ledcSetup: timer = (chan/2) % 4）
+ */
+constexpr uint8_t ledcTimerOf(uint8_t channel) {
+    return (uint8_t)((channel / 2) % 4);
+}
+
+#define PWM_FREQ_VARIABLE   0       // 频率随音符变化（蜂鸣器每个音符调用一次 ledcSetup）
+
+constexpr bool configPinReserved(uint8_t pin) {
+    return (pin >= 12 && pin <= 19) || (pin == 11 && !BOARD_VDD_SPI_AS_GPIO);
+}
+
+constexpr bool configPinsUnique() {
+    const uint8_t pins[] = {
+        HEATING_PAD_PIN, PUMP_PWM_PIN, THERMO_CLK_PIN, THERMO_MISO_PIN, THERMO_CS_PIN, BUZZER_PIN,
+        PRESSURE_SDA_PIN, PRESSURE_SCL_PIN, BUTTON_STOP_PIN, BUTTON_UP_PIN, BUTTON_DOWN_PIN,
+#if NUM_CHANNELS > 1
+        CH1_HEATING_PAD_PIN, CH1_PUMP_PWM_PIN, CH1_THERMO_CS_PIN,
+#else
+        LED1_PIN, LED2_PIN,
+#endif
+    };
+    const uint8_t pwmChannels[] = {
+        PWM_CHANNEL_HEAT, PWM_CHANNEL_PUMP, PWM_CHANNEL_BUZZER,
+#if NUM_CHANNELS > 1
+        CH1_PWM_CHANNEL_HEAT, CH1_PWM_CHANNEL_PUMP,
+#endif
+    };
+    const uint32_t pwmFrequencies[] = {     // 与 pwmChannels 一一对应
+        PWM_FREQUENCY, PWM_FREQUENCY, PWM_FREQ_VARIABLE,
+#if NUM_CHANNELS > 1
+        PWM_FREQUENCY, PWM_FREQUENCY,
+#endif
+    };
+    static_assert(sizeof(pwmChannels) == sizeof(pwmFrequencies) / sizeof(pwmFrequencies[0]),
+                  "config.h: pwmFrequencies 与 pwmChannels 不对应");
+    for (size_t i = 0; i < sizeof(pins); i++) {
+        if (configPinReserved(pins[i])) {
+            return false;
+        }
+        for (size_t j = i + 1; j < sizeof(pins); j++) {
+            if (pins[i] == pins[j]) {
+                return false;
+            }
+        }
+    }
+    for (size_t i = 0; i < sizeof(pwmChannels); i++) {
+        for (size_t j = i + 1; j < sizeof(pwmChannels); j++) {
+            if (pwmChannels[i] == pwmChannels[j]) {
+                return false;
+            }
+            bool sameTimer = ledcTimerOf(pwmChannels[i]) == ledcTimerOf(pwmChannels[j]);
+            bool sameFrequency = pwmFrequencies[i] == pwmFrequencies[j] && pwmFrequencies[i] != PWM_FREQ_VARIABLE;
+            if (sameTimer && !sameFrequency) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+static_assert(configPinsUnique(),
+              "config.h: GPIO/LEDC通道重复、使用了保留GPIO（GPIO11 需 BOARD_VDD_SPI_AS_GPIO），或共用LEDC定时器的通道频率不同");
 
 #endif // CONFIG_H
@@ -0,0 +1,263 @@
+"""
+IRAM 热路径审计
+
+从热路径入口函数出发，沿反汇编中的调用指令遍历调用图，列出：
+- 入口本身仍在闪存中的函数
+- IRAM 中的热路径函数调用的闪存函数（缓存未命中点；写闪存期间调用会等到写完）
+- 安装GPIO中断服务时的中断分配标志：不带 ESP_INTR_FLAG_IRAM 时，即使处理函数在IRAM中，
+  写闪存期间中断也推迟到写完（Arduino 的 attachInterrupt() 在 CONFIG_ARDUINO_ISR_IRAM=0 时即如此）
+
+ROM 中的函数（链接脚本给出的绝对地址，不在任何反汇编段中）不算未命中。
+只报告第一跳进入闪存的位置，不继续展开闪存函数内部。
+
+用法：
+- PlatformIO：pio run -e iram_audit（构建完成后自动运行，见 platformio.ini）
+- 独立运行：python3 scripts/iram_audit.py firmware.elf --objdump riscv32-esp-elf-objdump
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+# 热路径入口（反汇编符号名，不含参数表）
+HOT_PATH_ROOTS = [
+    # 急停：STOP中断 -> 关断输出 -> 通知状态机
+    "onStopEdge",
+    "onButtonEdge",
+    "buttonEdgeTrampoline",
+    "gpio_intr_service",
+    "EmergencyStop::trip",
+    "EventBus::notifyFromISR",
+    # 控制更新
+    "HeatingController::update",
+    "HeatingController::driveOpenLoop",
+    "HeatingController::calculatePID",
+    "PressureController::update",
+    "PumpController::setSpeed",
+    # 温度采集与线性化
+    "thermoReadFrame",
+    "MAX31855Chip::decode",
+    "MAX6675Chip::decode",
+    "KTypeThermocouple::linearize",
+]
+
+# 中断分配函数 -> 标志参数所在寄存器（RISC-V 调用约定）
+INTR_ALLOCATORS = {
+    "gpio_install_isr_service": "a0",
+}
+ESP_INTR_FLAG_IRAM = 1 << 10
+
+CALL_MNEMONICS = {
+    "jal", "jalr", "j", "jr", "c.j", "c.jal", "c.jr", "c.jalr", "call", "tail",  # RISC-V
+    "callq", "jmp", "jmpq",                                                     # 主机自测
+}
+
+SECTION_RE = re.compile(r"^Disassembly of section (\S+):")
+FUNC_RE = re.compile(r"^[0-9a-f]+ <(.+)>:$")
+INSN_RE = re.compile(r"^\s*[0-9a-f]+:\s+(\S+)\s.*<(.+)>\s*$")
+OPERANDS_RE = re.compile(r"^\s*[0-9a-f]+:\s+(\S+)\s+([^\s#]+)")
+STORE_MNEMONICS = {"sb", "sh", "sw", "sd", "c.sw", "c.sd", "c.swsp", "c.sdsp", "fsw", "fsd"}
+
+
+def base_name(symbol):
+    """去掉参数表和偏移：'Foo::bar(int)+0x1c' -> 'Foo::bar'"""
+    symbol = symbol.split("+0x")[0]
+    depth = 0
+    for i, ch in enumerate(symbol):
+        if ch == "<":
+            depth += 1
+        elif ch == ">":
+            depth -= 1
+        elif ch == "(" and depth == 0 and i > 0:
+            return symbol[:i]
+    return symbol
+
+
+def parse_objdump(text):
+    """返回 {函数: 段名} 和 {函数: [被调用函数]}（均为完整符号名）"""
+    sections = {}
+    calls = {}
+    section = None
+    current = None
+    for line in text.splitlines():
+        m = SECTION_RE.match(line)
+        if m:
+            section = m.group(1)
+            current = None
+            continue
+        m = FUNC_RE.match(line)
+        if m:
+            current = m.group(1)
+            sections[current] = section
+            calls.setdefault(current, [])
+            continue
+        if current is None:
+            continue
+        m = INSN_RE.match(line)
+        if not m or m.group(1) not in CALL_MNEMONICS:
+            continue
+        target = m.group(2).split("+0x")[0]
+        if target != current and target not in calls[current]:
+            calls[current].append(target)
+    return sections, calls
+
+
+def intr_allocations(text, allocators=INTR_ALLOCATORS):
+    """返回 [(调用者, 分配函数, 标志或None)]：标志取调用前最近一次对参数寄存器的立即数加载，
+    中间被其他指令改写或经调用返回时为 None（未知）"""
+    found = []
+    current = None
+    regs = {}       # 寄存器 -> 立即数，None 表示未知
+    for line in text.splitlines():
+        m = FUNC_RE.match(line)
+        if m:
+            current = m.group(1)
+            regs = {}
+            continue
+        if current is None:
+            continue
+        m = OPERANDS_RE.match(line)
+        if not m:
+            continue
+        mnemonic, operands = m.group(1), m.group(2).split(",")
+        if mnemonic in CALL_MNEMONICS:
+            target = INSN_RE.match(line)
+            callee = base_name(target.group(2)) if target else None
+            if callee in allocators:
+                found.append((current, callee, regs.get(allocators[callee])))
+            regs = {}
+        elif mnemonic in ("li", "c.li") and len(operands) == 2:
+            try:
+                regs[operands[0]] = int(operands[1], 0)
+            except ValueError:
+                regs[operands[0]] = None
+        elif mnemonic not in STORE_MNEMONICS and not mnemonic.startswith(("b", "c.b")):
+            regs[operands[0]] = None
+    return found
+
+
+def classify(section, flash_sections, iram_marker):
+    if section is None:
+        return "rom"
+    if section in flash_sections:
+        return "flash"
+    if iram_marker in section:
+        return "iram"
+    return "other"
+
+
+def audit(sections, calls, roots, flash_sections, iram_marker):
+    """返回 (入口列表[(入口, 完整名或None, 位置)], 闪存调用[(入口, 调用链, 被调函数)])"""
+    by_base = {}
+    for name in sections:
+        by_base.setdefault(base_name(name), []).append(name)
+
+    entries = []
+    misses = []
+    for root in roots:
+        names = by_base.get(root)
+        if not names:
+            entries.append((root, None, "missing"))
+            continue
+        for name in names:
+            where = classify(sections[name], flash_sections, iram_marker)
+            entries.append((root, name, where))
+            if where != "iram":
+                continue
+            # 深度优先，沿IRAM函数展开
+            stack = [(name, [name])]
+            seen = {name}
+            while stack:
+                fn, chain = stack.pop()
+                for callee in calls.get(fn, []):
+                    if callee in seen:
+                        continue
+                    seen.add(callee)
+                    kind = classify(sections.get(callee), flash_sections, iram_marker)
+                    if kind == "flash":
+                        misses.append((root, chain, callee))
+                    elif kind == "iram":
+                        stack.append((callee, chain + [callee]))
+    return entries, misses
+
+
+def report(entries, misses, allocs, out=sys.stdout):
+    out.write("========== IRAM 热路径审计 ==========\n")
+    in_flash = 0
+    for root, name, where in entries:
+        if where == "missing":
+            out.write("  [未链接] %s\n" % root)
+        elif where == "iram":
+            out.write("  [IRAM  ] %s\n" % name)
+        else:
+            in_flash += 1
+            out.write("  [%-6s] %s  <- 入口不在IRAM\n" % (where.upper(), name))
+
+    if misses:
+        out.write("---- IRAM 热路径中的闪存调用 ----\n")
+        for root, chain, callee in misses:
+            out.write("  %s\n      -> %s\n" % (" -> ".join(base_name(c) for c in chain), callee))
+    out.write("---- GPIO 中断分配标志 ----\n")
+    not_iram = 0
+    for caller, allocator, flags in allocs:
+        if flags is None:
+            not_iram += 1
+            out.write("  [未知  ] %s -> %s  <- 标志不是立即数\n" % (base_name(caller), allocator))
+        elif flags & ESP_INTR_FLAG_IRAM:
+            out.write("  [IRAM  ] %s -> %s(0x%x)\n" % (base_name(caller), allocator, flags))
+        else:
+            not_iram += 1
+            out.write("  [非IRAM] %s -> %s(0x%x)  <- 缺 ESP_INTR_FLAG_IRAM\n"
+                      % (base_name(caller), allocator, flags))
+    if not allocs:
+        out.write("  [未链接] %s\n" % ", ".join(sorted(INTR_ALLOCATORS)))
+    out.write("结果：%d 个入口, %d 个不在IRAM, %d 处闪存调用, %d 处中断分配未确认带IRAM标志\n"
+              % (len(entries), in_flash, len(misses), not_iram))
+    out.write("======================================\n")
+    return in_flash, len(misses), not_iram
+
+
+def run(elf, objdump, flash_sections, iram_marker, roots, environ=None):
+    text = subprocess.run([objdump, "-d", "-C", "--no-show-raw-insn", elf],
+                          check=True, stdout=subprocess.PIPE, universal_newlines=True,
+                          env=environ).stdout
+    sections, calls = parse_objdump(text)
+    entries, misses = audit(sections, calls, roots, flash_sections, iram_marker)
+    return report(entries, misses, intr_allocations(text))
+
+
+def main(argv):
+    ap = argparse.ArgumentParser(description="IRAM 热路径审计")
+    ap.add_argument("elf")
+    ap.add_argument("--objdump", default="riscv32-esp-elf-objdump")
+    ap.add_argument("--flash-sections", default=".flash.text",
+                    help="闪存代码段名，逗号分隔")
+    ap.add_argument("--iram-marker", default="iram",
+                    help="段名包含此字符串即视为IRAM")
+    ap.add_argument("--roots", default=None,
+                    help="热路径入口，逗号分隔（默认使用脚本内置列表）")
+    ap.add_argument("--strict", action="store_true",
+                    help="有入口不在IRAM、有闪存调用或有非IRAM中断分配时返回非0")
+    args = ap.parse_args(argv)
+    roots = args.roots.split(",") if args.roots else HOT_PATH_ROOTS
+    in_flash, miss, not_iram = run(args.elf, args.objdump, set(args.flash_sections.split(",")),
+                                   args.iram_marker, roots)
+    return 1 if args.strict and (in_flash or miss or not_iram) else 0
+
+
+try:
+    Import("env")  # noqa: F821  (PlatformIO extra_scripts)
+except NameError:
+    env = None
+
+if env is not None:
+    def _audit_after_link(target, source, env):
+        cc = env.subst("$CC")
+        objdump = cc[:-3] + "objdump" if cc.endswith("gcc") else "objdump"
+        run(str(target[0]), objdump, {".flash.text"}, "iram", HOT_PATH_ROOTS,
+            environ={k: str(v) for k, v in env["ENV"].items()})
+
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", _audit_after_link)
+elif __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
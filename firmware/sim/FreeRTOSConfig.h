@@ -0,0 +1,92 @@
+/**
+ * @file FreeRTOSConfig.h
+ * @brief 主机仿真用 FreeRTOS 配置（POSIX/Linux 移植层）
+ *
+ * 尽量与 Arduino-ESP32 (ESP32-C3) 的内核配置保持一致：1kHz节拍、25级优先级、
+ * 32位节拍计数、抢占 + 时间片轮转、互斥锁优先级继承。
+ * 差异：
+ * - 任务栈由宿主线程提供，栈大小不代表目标板（见 include/freertos/task.h）
+ * - 使用 heap_3（宿主 malloc），不模拟目标板的堆大小
+ * - 打开跟踪宏统计互斥锁等待与优先级继承（见 SimTrace.h）
+ * - 空闲钩子睡眠到下一个节拍，进程空闲时不占满宿主CPU（见 SimMain.cpp）
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#define configUSE_PREEMPTION                    1
+#define configUSE_TIME_SLICING                  1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#define configUSE_IDLE_HOOK                     1
+#define configUSE_TICK_HOOK                     0
+#define configUSE_DAEMON_TASK_STARTUP_HOOK      0
+#define configTICK_RATE_HZ                      1000
+#define configMAX_PRIORITIES                    25
+#define configMINIMAL_STACK_SIZE                ( ( unsigned short ) 4096 )
+#define configMAX_TASK_NAME_LEN                 16
+#define configTICK_TYPE_WIDTH_IN_BITS           TICK_TYPE_WIDTH_32_BITS
+#define configIDLE_SHOULD_YIELD                 1
+#define configUSE_TASK_NOTIFICATIONS            1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   1
+#define configUSE_MUTEXES                       1
+#define configUSE_RECURSIVE_MUTEXES             1
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configQUEUE_REGISTRY_SIZE               16
+#define configUSE_QUEUE_SETS                    0
+#define configUSE_NEWLIB_REENTRANT              0
+#define configENABLE_BACKWARD_COMPATIBILITY     1
+
+#define configSUPPORT_STATIC_ALLOCATION         0
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+#define configTOTAL_HEAP_SIZE                   ( ( size_t ) ( 256 * 1024 ) )   // heap_3 不使用
+#define configAPPLICATION_ALLOCATED_HEAP        0
+
+#define configUSE_MALLOC_FAILED_HOOK            0
+#define configCHECK_FOR_STACK_OVERFLOW          0   // POSIX 移植层不支持
+
+// 运行时间统计：宿主单调时钟（µs）
+#define configUSE_TRACE_FACILITY                1
+#define configUSE_STATS_FORMATTING_FUNCTIONS    1
+#define configGENERATE_RUN_TIME_STATS           1
+
+#define configUSE_CO_ROUTINES                   0
+#define configMAX_CO_ROUTINE_PRIORITIES         1
+
+#define configUSE_TIMERS                        1
+#define configTIMER_TASK_PRIORITY               1   // 与 ESP-IDF 默认一致
+#define configTIMER_QUEUE_LENGTH                10
+#define configTIMER_TASK_STACK_DEPTH            configMINIMAL_STACK_SIZE
+
+#define INCLUDE_vTaskPrioritySet                1
+#define INCLUDE_uxTaskPriorityGet               1
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_xTaskDelayUntil                 1
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_xTaskGetIdleTaskHandle          1
+#define INCLUDE_eTaskGetState                   1
+#define INCLUDE_xTimerPendFunctionCall          1
+#define INCLUDE_xSemaphoreGetMutexHolder        1
+#define INCLUDE_xTaskAbortDelay                 1
+#define INCLUDE_xTaskGetHandle                  1
+
+#ifndef __ASSEMBLER__
+#include "SimTrace.h"
+
+#define configASSERT( x )   do { if( ( x ) == 0 ) simAssertFailed( __FILE__, __LINE__ ); } while( 0 )
+
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    simRunTimeInit()
+#define portGET_RUN_TIME_COUNTER_VALUE()            simRunTimeMicros()
+
+// 跟踪宏：互斥锁/队列阻塞时长、优先级继承、任务切换
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )   simTraceBlockingOnReceive( ( void * ) ( pxQueue ) )
+#define traceQUEUE_RECEIVE( pxQueue )               simTraceReceive( ( void * ) ( pxQueue ) )
+#define traceQUEUE_RECEIVE_FAILED( pxQueue )        simTraceReceiveFailed( ( void * ) ( pxQueue ) )
+#define traceTASK_PRIORITY_INHERIT( pxTCBOfMutexHolder, uxInheritedPriority ) \
+    simTracePriorityInherit( ( void * ) ( pxTCBOfMutexHolder ), ( unsigned ) ( uxInheritedPriority ) )
+#endif
+
+#endif // FREERTOS_CONFIG_H
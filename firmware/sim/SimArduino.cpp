@@ -0,0 +1,862 @@
+/**
+ * @file SimArduino.cpp
+ * @brief Arduino-ESP32 API、Wire、Preferences 的主机实现
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Preferences.h>
+#include "SimHost.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <new>
+
+// ============ 宿主时钟与输出 ============
+
+uint64_t simMicros64() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static const uint64_t bootMicros = simMicros64();
+
+static bool schedulerRunning() {
+    return xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+}
+
+bool simSerialQuiet = false;
+
+void simWrite(const char* data, size_t len) {
+    if (schedulerRunning()) {
+        taskENTER_CRITICAL();
+        fwrite(data, 1, len, stdout);
+        fflush(stdout);
+        taskEXIT_CRITICAL();
+    } else {
+        fwrite(data, 1, len, stdout);
+        fflush(stdout);
+    }
+}
+
+void simPrintf(const char* format, ...) {
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (n > 0) {
+        simWrite(buffer, (size_t)n < sizeof(buffer) ? (size_t)n : sizeof(buffer) - 1);
+    }
+}
+
+// 固件代码的 new/delete 走 heap_3（挂起调度器后再 malloc），
+// 避免线程在 malloc 锁内被节拍信号切走
+void* operator new(size_t size) {
+    void* p = schedulerRunning() ? pvPortMalloc(size) : malloc(size);
+    if (p == NULL) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    if (schedulerRunning()) {
+        vPortFree(p);
+    } else {
+        free(p);
+    }
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+// ============ 时间 ============
+
+unsigned long millis() {
+    return (unsigned long)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+unsigned long micros() {
+    return (unsigned long)(simMicros64() - bootMicros);
+}
+
+void delay(uint32_t ms) {
+    if (schedulerRunning()) {
+        vTaskDelay(ms / portTICK_PERIOD_MS);
+    } else {
+        usleep(ms * 1000);
+    }
+}
+
+void delayMicroseconds(uint32_t us) {
+    // 与目标板一致：忙等，不让出CPU
+    uint64_t end = simMicros64() + us;
+    while (simMicros64() < end) {
+    }
+}
+
+// ============ GPIO ============
+
+static const uint8_t NUM_PINS = 48;
+static uint8_t pinModes[NUM_PINS];
+static uint8_t outputLevels[NUM_PINS];
+static bool inputForced[NUM_PINS];
+static uint8_t inputLevels[NUM_PINS];
+static void (*interruptHandlers[NUM_PINS])(void);
+static int interruptModes[NUM_PINS];
+static SimPinWriteHook pinWriteHook = NULL;
+static SimPinReadHook pinReadHook = NULL;
+
+static uint8_t inputLevel(uint8_t pin) {
+    if (inputForced[pin]) {
+        return inputLevels[pin];
+    }
+    // 未驱动的输入：上拉为高，其余为低
+    return (pinModes[pin] & PULLUP) ? HIGH : LOW;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < NUM_PINS) {
+        pinModes[pin] = mode;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin >= NUM_PINS) {
+        return;
+    }
+    outputLevels[pin] = val ? HIGH : LOW;
+    if (pinWriteHook != NULL) {
+        pinWriteHook(pin, outputLevels[pin]);
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    if (pin >= NUM_PINS) {
+        return LOW;
+    }
+    if (pinReadHook != NULL) {
+        int level = pinReadHook(pin);
+        if (level >= 0) {
+            return level;
+        }
+    }
+    return pinModes[pin] == OUTPUT ? outputLevels[pin] : inputLevel(pin);
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {
+    if (pin < NUM_PINS) {
+        interruptHandlers[pin] = handler;
+        interruptModes[pin] = mode;
+    }
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin < NUM_PINS) {
+        interruptHandlers[pin] = NULL;
+    }
+}
+
+void simDriveInput(uint8_t pin, bool forced, uint8_t level) {
+    if (pin >= NUM_PINS) {
+        return;
+    }
+    uint8_t before = inputLevel(pin);
+    inputForced[pin] = forced;
+    inputLevels[pin] = level ? HIGH : LOW;
+    uint8_t after = inputLevel(pin);
+
+    // 边沿中断：在调用者（仿真模型任务）上下文中执行处理函数
+    void (*handler)(void) = interruptHandlers[pin];
+    if (handler != NULL && before != after) {
+        int mode = interruptModes[pin];
+        bool rising = after == HIGH;
+        if (mode == CHANGE || (mode == RISING && rising) || (mode == FALLING && !rising)) {
+            handler();
+        }
+    }
+}
+
+uint8_t simOutputLevel(uint8_t pin) {
+    return pin < NUM_PINS ? outputLevels[pin] : LOW;
+}
+
+void simSetPinHooks(SimPinWriteHook write, SimPinReadHook read) {
+    pinWriteHook = write;
+    pinReadHook = read;
+}
+
+// ============ LEDC ============
+
+static const uint8_t NUM_LEDC = 16;
+static uint32_t ledcDuty[NUM_LEDC];
+
+double ledcSetup(uint8_t channel, double freq, uint8_t resolution_bits) {
+    (void)channel;
+    (void)resolution_bits;
+    return freq;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+    (void)pin;
+    (void)channel;
+}
+
+void ledcDetachPin(uint8_t pin) {
+    (void)pin;
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (channel < NUM_LEDC) {
+        ledcDuty[channel] = duty;
+    }
+}
+
+uint32_t ledcRead(uint8_t channel) {
+    return channel < NUM_LEDC ? ledcDuty[channel] : 0;
+}
+
+uint32_t simLedcDuty(uint8_t channel) {
+    return ledcRead(channel);
+}
+
+// ============ 杂项 ============
+
+static SimChipTemperatureHook chipTemperatureHook = NULL;
+
+void simSetChipTemperatureHook(SimChipTemperatureHook hook) {
+    chipTemperatureHook = hook;
+}
+
+float temperatureRead() {
+    return chipTemperatureHook ? chipTemperatureHook() : NAN;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    if (in_max == in_min) {
+        return out_min;
+    }
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// ============ Serial ============
+
+HardwareSerial Serial;
+EspClass ESP;
+
+void HardwareSerial::begin(unsigned long baud) {
+    (void)baud;
+}
+
+void HardwareSerial::flush() {
+}
+
+uint32_t simSerialBytesPerSecond = 0;
+static uint64_t txEmptyAt = 0;     // 发送缓冲排空的时刻 (µs)
+
+// 等待发送缓冲腾出 len 字节
+static void waitTxSpace(size_t len) {
+    for (;;) {
+        uint64_t now = simMicros64();
+        uint64_t pending = txEmptyAt > now
+                           ? (txEmptyAt - now) * simSerialBytesPerSecond / 1000000ull : 0;
+        if (pending + len <= SIM_SERIAL_TX_FIFO) {
+            txEmptyAt = (txEmptyAt > now ? txEmptyAt : now)
+                        + (uint64_t)len * 1000000ull / simSerialBytesPerSecond;
+            return;
+        }
+        delay(1);
+    }
+}
+
+// ---- 伪终端（-u） ----
+
+static int ptyMaster = -1;
+static int ptySlaveKeep = -1;       // 自己保持从端打开：主机工具未连接时主端写入不出错
+static bool ptyOutInFrame = false;  // stdout 过滤二进制帧（两个 0x00 之间）
+static uint8_t rxFifo[SIM_SERIAL_RX_FIFO];
+static size_t rxHead = 0;
+static size_t rxCount = 0;
+static esp_event_handler_t rxCallback = NULL;
+
+const char* simSerialOpenPty() {
+    // 重启（重新启动进程）时关闭，主机端读到断开
+    ptyMaster = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (ptyMaster < 0 || grantpt(ptyMaster) != 0 || unlockpt(ptyMaster) != 0) {
+        return NULL;
+    }
+    const char* name = ptsname(ptyMaster);
+    ptySlaveKeep = name ? open(name, O_RDWR | O_NOCTTY | O_CLOEXEC) : -1;
+    if (ptySlaveKeep < 0) {
+        return NULL;
+    }
+    // 原始模式：不回显、不转换换行，二进制帧原样通过
+    struct termios tio;
+    tcgetattr(ptySlaveKeep, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(ptySlaveKeep, TCSANOW, &tio);
+    fcntl(ptyMaster, F_SETFL, fcntl(ptyMaster, F_GETFL) | O_NONBLOCK);
+    return name;
+}
+
+void simSerialPoll() {
+    if (ptyMaster < 0) {
+        return;
+    }
+    uint8_t buf[SIM_SERIAL_RX_FIFO];
+    taskENTER_CRITICAL();
+    size_t space = SIM_SERIAL_RX_FIFO - rxCount;
+    taskEXIT_CRITICAL();
+    if (space == 0) {
+        return;
+    }
+    ssize_t n = read(ptyMaster, buf, space);
+    if (n <= 0) {
+        return;
+    }
+    taskENTER_CRITICAL();
+    for (ssize_t i = 0; i < n; i++) {
+        rxFifo[(rxHead + rxCount) % SIM_SERIAL_RX_FIFO] = buf[i];
+        rxCount++;
+    }
+    taskEXIT_CRITICAL();
+    if (rxCallback != NULL) {
+        rxCallback(NULL, "ARDUINO_HW_CDC_EVENTS", ARDUINO_HW_CDC_RX_EVENT, NULL);
+    }
+}
+
+void HardwareSerial::onEvent(arduino_hw_cdc_event_t event, esp_event_handler_t callback) {
+    if (event == ARDUINO_HW_CDC_RX_EVENT || event == ARDUINO_HW_CDC_ANY_EVENT) {
+        rxCallback = callback;
+    }
+}
+
+int HardwareSerial::available() {
+    taskENTER_CRITICAL();
+    int n = (int)rxCount;
+    taskEXIT_CRITICAL();
+    return n;
+}
+
+int HardwareSerial::read() {
+    int c = -1;
+    taskENTER_CRITICAL();
+    if (rxCount > 0) {
+        c = rxFifo[rxHead];
+        rxHead = (rxHead + 1) % SIM_SERIAL_RX_FIFO;
+        rxCount--;
+    }
+    taskEXIT_CRITICAL();
+    return c;
+}
+
+int HardwareSerial::availableForWrite() {
+    if (simSerialBytesPerSecond == 0) {
+        return SIM_SERIAL_TX_FIFO;
+    }
+    uint64_t now = simMicros64();
+    uint64_t pending = txEmptyAt > now ? (txEmptyAt - now) * simSerialBytesPerSecond / 1000000ull : 0;
+    return pending < SIM_SERIAL_TX_FIFO ? (int)(SIM_SERIAL_TX_FIFO - pending) : 0;
+}
+
+size_t HardwareSerial::write(const uint8_t* data, size_t len) {
+    if (simSerialBytesPerSecond > 0 && schedulerRunning()) {
+        for (size_t done = 0; done < len; ) {
+            size_t chunk = len - done < SIM_SERIAL_TX_FIFO ? len - done : SIM_SERIAL_TX_FIFO;
+            waitTxSpace(chunk);
+            done += chunk;
+        }
+    }
+    if (ptyMaster < 0) {
+        if (!simSerialQuiet) {
+            simWrite((const char*)data, len);
+        }
+        return len;
+    }
+
+    // 主机工具不读取时伪终端缓冲满，写不进的部分丢弃（与 USB CDC 未连接时一致）
+    ssize_t ignored = ::write(ptyMaster, data, len);
+    (void)ignored;
+    if (!simSerialQuiet) {
+        char text[256];
+        size_t n = 0;
+        for (size_t i = 0; i < len; i++) {
+            if (data[i] == 0) {
+                ptyOutInFrame = !ptyOutInFrame;
+            } else if (!ptyOutInFrame) {
+                text[n++] = (char)data[i];
+                if (n == sizeof(text)) {
+                    simWrite(text, n);
+                    n = 0;
+                }
+            }
+        }
+        if (n > 0) {
+            simWrite(text, n);
+        }
+    }
+    return len;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::print(const char* s) {
+    return write((const uint8_t*)s, strlen(s));
+}
+
+size_t HardwareSerial::print(char c) {
+    return write((uint8_t)c);
+}
+
+size_t HardwareSerial::print(int v) {
+    return printf("%d", v);
+}
+
+size_t HardwareSerial::print(unsigned int v) {
+    return printf("%u", v);
+}
+
+size_t HardwareSerial::print(long v) {
+    return printf("%ld", v);
+}
+
+size_t HardwareSerial::print(unsigned long v) {
+    return printf("%lu", v);
+}
+
+size_t HardwareSerial::print(double v, int digits) {
+    return printf("%.*f", digits, v);
+}
+
+size_t HardwareSerial::println() {
+    return print("\r\n");
+}
+
+size_t HardwareSerial::println(const char* s) {
+    return print(s) + println();
+}
+
+size_t HardwareSerial::println(char c) {
+    return print(c) + println();
+}
+
+size_t HardwareSerial::println(int v) {
+    return print(v) + println();
+}
+
+size_t HardwareSerial::println(unsigned int v) {
+    return print(v) + println();
+}
+
+size_t HardwareSerial::println(long v) {
+    return print(v) + println();
+}
+
+size_t HardwareSerial::println(unsigned long v) {
+    return print(v) + println();
+}
+
+size_t HardwareSerial::println(double v, int digits) {
+    return print(v, digits) + println();
+}
+
+size_t HardwareSerial::printf(const char* format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (n <= 0) {
+        return 0;
+    }
+    size_t len = (size_t)n < sizeof(buffer) ? (size_t)n : sizeof(buffer) - 1;
+    return write((const uint8_t*)buffer, len);
+}
+
+static char** restartArgv = NULL;
+
+void simSetRestartArgs(char** argv) {
+    restartArgv = argv;
+}
+
+unsigned simBootCount() {
+    const char* s = getenv("SIM_BOOT_COUNT");
+    return s != NULL ? (unsigned)atoi(s) : 1;
+}
+
+void EspClass::restart() {
+    if (!simFlashPersistent() || restartArgv == NULL) {
+        simPrintf("[仿真] ESP.restart()\n");
+        fflush(stdout);
+        _exit(2);
+    }
+
+    // 闪存文件保留：以相同参数重新启动进程，从 otadata 选择的分区"启动"
+    vTaskSuspendAll();
+    simPrintf("[仿真] ESP.restart()：重新启动（第 %u 次启动）\n", simBootCount() + 1);
+    fflush(stdout);
+    simFlashSync();
+
+    // 新进程继承信号屏蔽字和定时器：先恢复，避免节拍信号打断启动
+    signal(SIGALRM, SIG_IGN);
+    struct itimerval off = {};
+    setitimer(ITIMER_REAL, &off, NULL);
+    sigset_t none;
+    sigemptyset(&none);
+    pthread_sigmask(SIG_SETMASK, &none, NULL);
+
+    char count[16];
+    snprintf(count, sizeof(count), "%u", simBootCount() + 1);
+    setenv("SIM_BOOT_COUNT", count, 1);
+    execv("/proc/self/exe", restartArgv);
+    perror("execv");
+    _exit(2);
+}
+
+// ============ Wire ============
+
+TwoWire Wire;
+
+TwoWire::TwoWire()
+    : devices(), txAddress(0), txBuffer(), txLength(0), regPointer(0),
+      rxBuffer(), rxLength(0), rxIndex(0) {
+}
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    (void)sda;
+    (void)scl;
+    (void)frequency;
+    return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+    (void)frequency;
+    return true;
+}
+
+void TwoWire::attach(uint8_t address, SimI2CDevice* device) {
+    if (address < 128) {
+        devices[address] = device;
+    }
+}
+
+void TwoWire::beginTransmission(uint16_t address) {
+    txAddress = (uint8_t)(address & 0x7F);
+    txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (txLength >= BUFFER_LENGTH) {
+        return 0;
+    }
+    txBuffer[txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t len) {
+    size_t n = 0;
+    while (n < len && write(data[n])) {
+        n++;
+    }
+    return n;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    (void)sendStop;
+    SimI2CDevice* device = devices[txAddress];
+    if (device == NULL) {
+        return 2;   // 地址NACK
+    }
+    if (txLength >= 1) {
+        regPointer = txBuffer[0];
+        if (txLength > 1) {
+            device->writeRegisters(txBuffer[0], txBuffer + 1, txLength - 1);
+        }
+    }
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint16_t address, uint8_t len, bool sendStop) {
+    (void)sendStop;
+    SimI2CDevice* device = devices[address & 0x7F];
+    rxLength = 0;
+    rxIndex = 0;
+    if (device == NULL) {
+        return 0;
+    }
+    if (len > BUFFER_LENGTH) {
+        len = BUFFER_LENGTH;
+    }
+    for (uint8_t i = 0; i < len; i++) {
+        rxBuffer[i] = device->readRegister((uint8_t)(regPointer + i));
+    }
+    rxLength = len;
+    return len;
+}
+
+int TwoWire::available() {
+    return (int)(rxLength - rxIndex);
+}
+
+int TwoWire::read() {
+    return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1;
+}
+
+// ============ Preferences ============
+
+typedef std::map<std::string, std::vector<uint8_t> > NvsTable;
+
+// 闪存持久（-F）时整张表写到 nvs 分区：[魔数][条目数]{[键长][键][值长][值]}
+// 不是 NVS 的页格式，只保证重启后能读回
+static const uint32_t NVS_IMAGE_MAGIC = 0x53564E53;     // "SNVS"
+
+static void nvsLoad(NvsTable& table) {
+    size_t cap = 0;
+    const uint8_t* p = simFlashRegion("nvs", &cap);
+    uint32_t header[2];
+    if (p == NULL || !simFlashPersistent() || cap < sizeof(header)) {
+        return;
+    }
+    memcpy(header, p, sizeof(header));
+    if (header[0] != NVS_IMAGE_MAGIC) {
+        return;
+    }
+    const uint8_t* end = p + cap;
+    p += sizeof(header);
+    for (uint32_t i = 0; i < header[1]; i++) {
+        uint16_t keyLen, valueLen;
+        if (end - p < 2) return;
+        memcpy(&keyLen, p, 2);
+        if (end - p < 4 + keyLen) return;
+        std::string key((const char*)p + 2, keyLen);
+        p += 2 + keyLen;
+        memcpy(&valueLen, p, 2);
+        if (end - p < 2 + valueLen) return;
+        table[key].assign(p + 2, p + 2 + valueLen);
+        p += 2 + valueLen;
+    }
+}
+
+// 所有命名空间共用一张表，键为 "命名空间/键"
+static NvsTable& nvsStore() {
+    static NvsTable store;
+    static bool loaded = false;
+    if (!loaded) {
+        loaded = true;
+        nvsLoad(store);
+    }
+    return store;
+}
+
+// 修改后调用（已持有 NvsLock）
+static void nvsCommit() {
+    size_t cap = 0;
+    uint8_t* region = simFlashRegion("nvs", &cap);
+    if (region == NULL || !simFlashPersistent()) {
+        return;
+    }
+    std::vector<uint8_t> image(8);
+    uint32_t header[2] = { NVS_IMAGE_MAGIC, (uint32_t)nvsStore().size() };
+    memcpy(image.data(), header, sizeof(header));
+    for (NvsTable::const_iterator it = nvsStore().begin(); it != nvsStore().end(); ++it) {
+        uint16_t keyLen = (uint16_t)it->first.size();
+        uint16_t valueLen = (uint16_t)it->second.size();
+        image.insert(image.end(), (const uint8_t*)&keyLen, (const uint8_t*)&keyLen + 2);
+        image.insert(image.end(), it->first.begin(), it->first.end());
+        image.insert(image.end(), (const uint8_t*)&valueLen, (const uint8_t*)&valueLen + 2);
+        image.insert(image.end(), it->second.begin(), it->second.end());
+    }
+    if (image.size() > cap) {
+        simPrintf("[仿真] NVS 超过分区大小 (%zu > %zu 字节)，未写入闪存\n", image.size(), cap);
+        return;
+    }
+    memcpy(region, image.data(), image.size());
+}
+
+static std::string nvsKey(const char* space, const char* key) {
+    return std::string(space) + "/" + key;
+}
+
+// NVS 在目标板上自带锁；这里挂起调度器，避免两个任务交错修改表
+class NvsLock {
+public:
+    NvsLock() : suspended(schedulerRunning()) {
+        if (suspended) vTaskSuspendAll();
+    }
+    ~NvsLock() {
+        if (suspended) xTaskResumeAll();
+    }
+private:
+    bool suspended;
+};
+
+Preferences::Preferences() : space(), opened(false), readOnly(false) {
+}
+
+Preferences::~Preferences() {
+    end();
+}
+
+bool Preferences::begin(const char* name, bool read_only, const char* partition_label) {
+    (void)partition_label;
+    if (opened || name == NULL || strlen(name) >= sizeof(space)) {
+        return false;
+    }
+    // 与 NVS 一致：只读方式打开不存在的命名空间会失败
+    if (read_only) {
+        NvsLock lock;
+        std::string prefix = std::string(name) + "/";
+        NvsTable::iterator it = nvsStore().lower_bound(prefix);
+        if (it == nvsStore().end() || it->first.compare(0, prefix.size(), prefix) != 0) {
+            return false;
+        }
+    }
+    strncpy(space, name, sizeof(space) - 1);
+    opened = true;
+    readOnly = read_only;
+    return true;
+}
+
+void Preferences::end() {
+    opened = false;
+}
+
+bool Preferences::clear() {
+    if (!opened || readOnly) {
+        return false;
+    }
+    NvsLock lock;
+    std::string prefix = std::string(space) + "/";
+    NvsTable::iterator it = nvsStore().lower_bound(prefix);
+    while (it != nvsStore().end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+        nvsStore().erase(it++);
+    }
+    nvsCommit();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!opened || readOnly) {
+        return false;
+    }
+    NvsLock lock;
+    if (nvsStore().erase(nvsKey(space, key)) == 0) {
+        return false;
+    }
+    nvsCommit();
+    return true;
+}
+
+bool Preferences::isKey(const char* key) {
+    if (!opened) {
+        return false;
+    }
+    NvsLock lock;
+    return nvsStore().count(nvsKey(space, key)) > 0;
+}
+
+size_t Preferences::put(const char* key, const void* value, size_t len) {
+    if (!opened || readOnly) {
+        return 0;
+    }
+    NvsLock lock;
+    const uint8_t* bytes = (const uint8_t*)value;
+    nvsStore()[nvsKey(space, key)].assign(bytes, bytes + len);
+    nvsCommit();
+    return len;
+}
+
+size_t Preferences::get(const char* key, void* buf, size_t len) {
+    if (!opened) {
+        return 0;
+    }
+    NvsLock lock;
+    NvsTable::iterator it = nvsStore().find(nvsKey(space, key));
+    if (it == nvsStore().end() || it->second.size() != len) {
+        return 0;
+    }
+    memcpy(buf, it->second.data(), len);
+    return len;
+}
+
+size_t Preferences::putUChar(const char* key, uint8_t value) {
+    return put(key, &value, sizeof(value));
+}
+
+size_t Preferences::putUShort(const char* key, uint16_t value) {
+    return put(key, &value, sizeof(value));
+}
+
+size_t Preferences::putUInt(const char* key, uint32_t value) {
+    return put(key, &value, sizeof(value));
+}
+
+size_t Preferences::putFloat(const char* key, float value) {
+    return put(key, &value, sizeof(value));
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    return put(key, value, len);
+}
+
+uint8_t Preferences::getUChar(const char* key, uint8_t defaultValue) {
+    uint8_t value;
+    return get(key, &value, sizeof(value)) ? value : defaultValue;
+}
+
+uint16_t Preferences::getUShort(const char* key, uint16_t defaultValue) {
+    uint16_t value;
+    return get(key, &value, sizeof(value)) ? value : defaultValue;
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+    uint32_t value;
+    return get(key, &value, sizeof(value)) ? value : defaultValue;
+}
+
+float Preferences::getFloat(const char* key, float defaultValue) {
+    float value;
+    return get(key, &value, sizeof(value)) ? value : defaultValue;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!opened) {
+        return 0;
+    }
+    NvsLock lock;
+    NvsTable::iterator it = nvsStore().find(nvsKey(space, key));
+    return it == nvsStore().end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    size_t len = getBytesLength(key);
+    if (len == 0 || len > maxLen) {
+        return 0;
+    }
+    return get(key, buf, len);
+}
@@ -0,0 +1,217 @@
+/**
+ * @file SimFlash.cpp
+ * @brief 闪存与 OTA 分区的主机实现：4MB 闪存映射到文件（-F）或内存
+ *
+ * 闪存文件在重启（ESP.restart() 重新启动进程）之间保留 OTA 分区内容、启动分区选择和 NVS，
+ * 用于在 Linux 上检验固件升级的断点续传、回滚。
+ */
+
+#include "SimHost.h"
+#include <esp_ota_ops.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const size_t FLASH_SIZE = 0x400000;
+const uint32_t OTADATA_MAGIC = 0x41544F53;     // "SOTA"
+
+// Arduino-ESP32 default.csv（4MB）
+esp_partition_t partitions[] = {
+    { ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS, 0x9000, 0x5000, "nvs", false },
+    { ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_OTA, 0xE000, 0x2000, "otadata", false },
+    { ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_0, 0x10000, 0x140000, "app0", false },
+    { ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_1, 0x150000, 0x140000, "app1", false },
+};
+esp_partition_t& otadata = partitions[1];
+esp_partition_t* const appSlots[2] = { &partitions[2], &partitions[3] };
+
+uint8_t* flash = NULL;
+bool persistent = false;
+int runningSlot = 0;
+
+int bootSlot() {
+    uint32_t rec[2];
+    memcpy(rec, flash + otadata.address, sizeof(rec));
+    return (rec[0] == OTADATA_MAGIC && rec[1] < 2) ? (int)rec[1] : 0;
+}
+
+bool inPartition(const esp_partition_t* p, size_t offset, size_t size) {
+    return flash != NULL && p != NULL && offset <= p->size && size <= p->size - offset;
+}
+
+bool seed(const char* image) {
+    FILE* f = fopen(image, "rb");
+    if (f == NULL) {
+        perror(image);
+        return false;
+    }
+    size_t n = fread(flash + appSlots[0]->address, 1, appSlots[0]->size, f);
+    bool tooLarge = fgetc(f) != EOF;
+    fclose(f);
+    if (tooLarge) {
+        fprintf(stderr, "%s: 超过 app0 分区大小 (%u 字节)\n", image, (unsigned)appSlots[0]->size);
+        return false;
+    }
+    fprintf(stderr, "app0 写入镜像 %s (%zu 字节)\n", image, n);
+    return true;
+}
+
+} // namespace
+
+bool simFlashOpen(const char* path, const char* seedImage) {
+    bool fresh = true;
+    if (path == NULL) {
+        void* m = mmap(NULL, FLASH_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (m == MAP_FAILED) {
+            perror("mmap");
+            return false;
+        }
+        flash = (uint8_t*)m;
+    } else {
+        int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0) {
+            perror(path);
+            return false;
+        }
+        fresh = st.st_size == 0;
+        if (fresh && ftruncate(fd, FLASH_SIZE) != 0) {
+            perror(path);
+            return false;
+        }
+        if (!fresh && (size_t)st.st_size != FLASH_SIZE) {
+            fprintf(stderr, "%s: 不是闪存文件（应为 %zu 字节）\n", path, FLASH_SIZE);
+            return false;
+        }
+        void* m = mmap(NULL, FLASH_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (m == MAP_FAILED) {
+            perror("mmap");
+            return false;
+        }
+        flash = (uint8_t*)m;
+        persistent = true;
+    }
+
+    if (fresh) {
+        memset(flash, 0xFF, FLASH_SIZE);
+        const uint32_t rec[2] = { OTADATA_MAGIC, 0 };
+        memcpy(flash + otadata.address, rec, sizeof(rec));
+        if (seedImage != NULL && !seed(seedImage)) {
+            return false;
+        }
+    } else if (seedImage != NULL) {
+        fprintf(stderr, "闪存文件已存在，忽略 -I（删除 %s 重新开始）\n", path);
+    }
+    runningSlot = bootSlot();
+    return true;
+}
+
+bool simFlashPersistent() {
+    return persistent;
+}
+
+void simFlashSync() {
+    if (persistent) {
+        msync(flash, FLASH_SIZE, MS_SYNC);
+    }
+}
+
+uint8_t* simFlashRegion(const char* label, size_t* size) {
+    for (esp_partition_t& p : partitions) {
+        if (flash != NULL && strcmp(p.label, label) == 0) {
+            *size = p.size;
+            return flash + p.address;
+        }
+    }
+    return NULL;
+}
+
+const uint8_t* simFlashRunningImage(size_t* size) {
+    if (flash == NULL) {
+        return NULL;
+    }
+    *size = appSlots[runningSlot]->size;
+    return flash + appSlots[runningSlot]->address;
+}
+
+// ============ esp_partition / esp_ota ============
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK:                return "ESP_OK";
+        case ESP_FAIL:              return "ESP_FAIL";
+        case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+        default:                    return "?";
+    }
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* p, size_t src_offset, void* dst, size_t size) {
+    if (!inPartition(p, src_offset, size)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(dst, flash + p->address + src_offset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* p, size_t dst_offset, const void* src, size_t size) {
+    if (!inPartition(p, dst_offset, size)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    // NOR 闪存：编程只能把 1 变成 0
+    uint8_t* d = flash + p->address + dst_offset;
+    const uint8_t* s = (const uint8_t*)src;
+    for (size_t i = 0; i < size; i++) {
+        d[i] &= s[i];
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* p, size_t offset, size_t size) {
+    if (offset % SPI_FLASH_SEC_SIZE != 0 || size % SPI_FLASH_SEC_SIZE != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!inPartition(p, offset, size)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(flash + p->address + offset, 0xFF, size);
+    return ESP_OK;
+}
+
+const esp_partition_t* esp_ota_get_running_partition(void) {
+    return flash != NULL ? appSlots[runningSlot] : NULL;
+}
+
+const esp_partition_t* esp_ota_get_boot_partition(void) {
+    return flash != NULL ? appSlots[bootSlot()] : NULL;
+}
+
+const esp_partition_t* esp_ota_get_next_update_partition(const esp_partition_t* start_from) {
+    if (flash == NULL) {
+        return NULL;
+    }
+    if (start_from == NULL) {
+        start_from = appSlots[runningSlot];
+    }
+    return start_from == appSlots[0] ? appSlots[1] : appSlots[0];
+}
+
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t* partition) {
+    int slot = partition == appSlots[0] ? 0 : partition == appSlots[1] ? 1 : -1;
+    if (flash == NULL || slot < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    const uint32_t rec[2] = { OTADATA_MAGIC, (uint32_t)slot };
+    memset(flash + otadata.address, 0xFF, SPI_FLASH_SEC_SIZE);
+    memcpy(flash + otadata.address, rec, sizeof(rec));
+    simFlashSync();
+    return ESP_OK;
+}
@@ -0,0 +1,652 @@
+/**
+ * @file SimFleet.cpp
+ * @brief 机群负载：同时运行多台仿真设备，检验主机工具（采集、升级）在大量设备下的表现
+ *
+ * 每台设备是一个 glasses_sim 进程（完整的固件和被控对象模型），串口接到各自的伪终端
+ * （<目录>/devNNN.pty），遥测和文本日志与真实设备一样经伪终端输出。
+ * 各设备的环境温度、贴合程度、泄漏率、壳体散热按种子随机取值，同一种子结果可复现。
+ * 故障脚本按设备选择器给设备追加仿真选项（-f 硬件故障、-p 按键），
+ * 或安排机群层面的故障：unplug（拔出：结束进程、删除伪终端链接，稍后重新插入启动）、
+ * hang（卡死：进程暂停，伪终端仍在但没有输出、不响应）。
+ *
+ * 仿真进程在空闲时睡眠，CPU 占用主要是 1kHz 节拍和固件任务本身；
+ * 周期打印运行中的设备数和每台设备的平均CPU占用，结束时汇总退出码（3 = 互斥锁阻塞超限）。
+ * 每台的CPU占用尚未在 V11.1.0 POSIX 移植层上实测，一台机器能带多少台设备以状态打印为准。
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const unsigned FLEET_MAX_DEVICES = 1000;
+const uint32_t FLEET_TICK_MS = 10;              // 主循环间隔：回收进程、执行故障脚本
+const uint32_t FLEET_EXIT_GRACE_MS = 5000;      // 到时后等待各进程打印报告退出
+const uint32_t FLEET_DEFAULT_UNPLUG_MS = 3000;
+const uint32_t FLEET_DEFAULT_HANG_MS = 3000;
+
+enum FleetActionType { FLEET_UNPLUG, FLEET_HANG };
+
+/**
+ * @brief 机群层面的故障（时间为仿真时间，从机群启动算起）
+ */
+struct FleetAction {
+    FleetActionType type;
+    uint64_t atMs;
+    uint32_t durationMs;
+    bool started;
+};
+
+enum DeviceState { DEV_WAITING, DEV_RUNNING, DEV_HUNG, DEV_UNPLUGGED, DEV_EXITED };
+
+struct Device {
+    std::string name;
+    std::vector<std::string> args;      // 场景与脚本追加的仿真选项
+    std::vector<FleetAction> actions;
+    DeviceState state;
+    pid_t pid;
+    uint64_t launchAtMs;                // 墙钟（DEV_WAITING / DEV_UNPLUGGED 时）
+    uint64_t resumeAtMs;                // 墙钟（DEV_HUNG 时）
+    unsigned launches;
+    int exitCode;                       // 最后一次退出；被信号结束为 128+信号
+    bool forced;                        // 到时未退出，由机群强制结束
+    double reapedCpuSec;                // 已退出的进程累计CPU
+    long maxRssKb;
+};
+
+struct FleetOptions {
+    unsigned devices;
+    uint32_t durationMs;                // 仿真时间
+    unsigned timeScale;
+    unsigned seed;                      // 0 = 所有设备使用默认场景
+    uint32_t staggerMs;
+    uint32_t statusPeriodMs;
+    bool persistentFlash;
+    std::string dir;
+    std::string simPath;
+    std::string scriptPath;
+    std::vector<std::string> extraArgs; // -- 之后的选项，追加给每台设备
+};
+
+FleetOptions options;
+std::vector<Device> devices;
+uint64_t startMs;
+volatile sig_atomic_t stopRequested = 0;
+
+uint64_t nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ull + ts.tv_nsec / 1000000;
+}
+
+uint64_t simElapsedMs(uint64_t now) {
+    return (now - startMs) * options.timeScale;
+}
+
+void printUsage(const char* prog) {
+    fprintf(stderr,
+            "用法: %s [选项] [-- 仿真选项...]\n"
+            "  -n 台数      设备数（默认 8，最多 %u）\n"
+            "  -t 秒        仿真时长（默认 120，-x 时为仿真时间）\n"
+            "  -x 倍数      加速运行，传给每台设备（默认 1）\n"
+            "  -d 目录      伪终端链接 devNNN.pty、仿真输出 devNNN.out、闪存 devNNN.flash（默认 /tmp/glasses_fleet）\n"
+            "  -s 种子      场景随机种子（默认 1；0 = 所有设备使用默认场景）\n"
+            "  -S 脚本      故障脚本，每行: 选择器 动作\n"
+            "               选择器: *  3  0-9  1,5,7-9  %%10（每 10 台一台）\n"
+            "               动作:   仿真选项（如 -f heater_open、-p stop@30）\n"
+            "                       unplug@秒[+毫秒]  拔出，持续后重新插入（默认 %u ms）\n"
+            "                       hang@秒[+毫秒]    卡死，持续后恢复（默认 %u ms）\n"
+            "  -F           每台设备的闪存保存在文件中（重启、升级、拔出后保留）\n"
+            "  -w 毫秒      依次启动的间隔（默认 20）\n"
+            "  -i 秒        状态打印间隔（默认 5，0 = 不打印）\n"
+            "  -e 路径      glasses_sim（默认与本程序同目录）\n",
+            prog, FLEET_MAX_DEVICES, FLEET_DEFAULT_UNPLUG_MS, FLEET_DEFAULT_HANG_MS);
+}
+
+std::string defaultSimPath(const char* argv0) {
+    char self[PATH_MAX];
+    ssize_t n = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    std::string path = n > 0 ? std::string(self, (size_t)n) : std::string(argv0);
+    size_t slash = path.find_last_of('/');
+    return (slash == std::string::npos ? std::string(".") : path.substr(0, slash)) + "/glasses_sim";
+}
+
+bool parseOptions(int argc, char** argv) {
+    options.devices = 8;
+    options.durationMs = 120000;
+    options.timeScale = 1;
+    options.seed = 1;
+    options.staggerMs = 20;
+    options.statusPeriodMs = 5000;
+    options.persistentFlash = false;
+    options.dir = "/tmp/glasses_fleet";
+    options.simPath = defaultSimPath(argv[0]);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:x:d:s:S:Fw:i:e:h")) != -1) {
+        switch (opt) {
+            case 'n': options.devices = (unsigned)atoi(optarg); break;
+            case 't': options.durationMs = (uint32_t)(atof(optarg) * 1000.0); break;
+            case 'x': options.timeScale = (unsigned)atoi(optarg); break;
+            case 'd': options.dir = optarg; break;
+            case 's': options.seed = (unsigned)atoi(optarg); break;
+            case 'S': options.scriptPath = optarg; break;
+            case 'F': options.persistentFlash = true; break;
+            case 'w': options.staggerMs = (uint32_t)atol(optarg); break;
+            case 'i': options.statusPeriodMs = (uint32_t)(atof(optarg) * 1000.0); break;
+            case 'e': options.simPath = optarg; break;
+            default: return false;
+        }
+    }
+    for (int i = optind; i < argc; i++) {
+        options.extraArgs.push_back(argv[i]);
+    }
+    return options.devices >= 1 && options.devices <= FLEET_MAX_DEVICES && options.timeScale >= 1
+           && options.durationMs > 0;
+}
+
+/**
+ * @brief 选择器是否包含第 index 台设备：*、N、A-B、%K，可用逗号组合
+ */
+bool selectorMatches(const std::string& selector, unsigned index) {
+    size_t pos = 0;
+    while (pos <= selector.size()) {
+        size_t comma = selector.find(',', pos);
+        std::string item = selector.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        unsigned a = 0, b = 0;
+        if (item == "*") {
+            return true;
+        } else if (sscanf(item.c_str(), "%%%u", &a) == 1) {
+            if (a > 0 && index % a == 0) {
+                return true;
+            }
+        } else if (sscanf(item.c_str(), "%u-%u", &a, &b) == 2) {
+            if (index >= a && index <= b) {
+                return true;
+            }
+        } else if (sscanf(item.c_str(), "%u", &a) == 1 && index == a) {
+            return true;
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        pos = comma + 1;
+    }
+    return false;
+}
+
+bool selectorValid(const std::string& selector) {
+    size_t pos = 0;
+    while (pos <= selector.size()) {
+        size_t comma = selector.find(',', pos);
+        std::string item = selector.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        unsigned a, b;
+        char extra;
+        if (item != "*" && sscanf(item.c_str(), "%%%u%c", &a, &extra) != 1
+                && sscanf(item.c_str(), "%u-%u%c", &a, &b, &extra) != 2
+                && sscanf(item.c_str(), "%u%c", &a, &extra) != 1) {
+            return false;
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        pos = comma + 1;
+    }
+    return true;
+}
+
+bool parseAction(const std::string& word, FleetAction& a) {
+    char name[16];
+    double atSeconds = 0.0;
+    unsigned durationMs = 0;
+    int fields = sscanf(word.c_str(), "%15[a-z]@%lf+%u", name, &atSeconds, &durationMs);
+    if (fields < 2) {
+        return false;
+    }
+    if (strcmp(name, "unplug") == 0) {
+        a.type = FLEET_UNPLUG;
+        a.durationMs = fields == 3 ? durationMs : FLEET_DEFAULT_UNPLUG_MS;
+    } else if (strcmp(name, "hang") == 0) {
+        a.type = FLEET_HANG;
+        a.durationMs = fields == 3 ? durationMs : FLEET_DEFAULT_HANG_MS;
+    } else {
+        return false;
+    }
+    a.atMs = (uint64_t)(atSeconds * 1000.0);
+    a.started = false;
+    return true;
+}
+
+/**
+ * @brief 读取故障脚本：# 之后为注释，每行 "选择器 动作..."
+ */
+bool loadScript(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "r");
+    if (f == NULL) {
+        perror(path.c_str());
+        return false;
+    }
+    char line[512];
+    unsigned lineNo = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        lineNo++;
+        char* hash = strchr(line, '#');
+        if (hash != NULL) {
+            *hash = '\0';
+        }
+        std::vector<std::string> words;
+        for (char* w = strtok(line, " \t\r\n"); w != NULL; w = strtok(NULL, " \t\r\n")) {
+            words.push_back(w);
+        }
+        if (words.empty()) {
+            continue;
+        }
+        if (words.size() < 2 || !selectorValid(words[0])) {
+            fprintf(stderr, "%s:%u: 需要 \"选择器 动作\"\n", path.c_str(), lineNo);
+            ok = false;
+            continue;
+        }
+        for (size_t w = 1; w < words.size(); w++) {
+            FleetAction action;
+            std::vector<std::string> simArgs;
+            if (words[w][0] == '-') {
+                // 仿真选项：除 -q/-u 外都带参数（可以是下一个词，也可以紧跟在选项后）
+                simArgs.push_back(words[w]);
+                if (words[w].size() == 2 && words[w] != "-q" && words[w] != "-u") {
+                    if (w + 1 >= words.size()) {
+                        fprintf(stderr, "%s:%u: %s 缺少参数\n", path.c_str(), lineNo, words[w].c_str());
+                        ok = false;
+                        break;
+                    }
+                    simArgs.push_back(words[++w]);
+                }
+            } else if (!parseAction(words[w], action)) {
+                fprintf(stderr, "%s:%u: 无效的动作 %s\n", path.c_str(), lineNo, words[w].c_str());
+                ok = false;
+                break;
+            }
+            for (unsigned i = 0; i < devices.size(); i++) {
+                if (!selectorMatches(words[0], i)) {
+                    continue;
+                }
+                if (simArgs.empty()) {
+                    devices[i].actions.push_back(action);
+                } else {
+                    devices[i].args.insert(devices[i].args.end(), simArgs.begin(), simArgs.end());
+                }
+            }
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+std::string fmt(const char* format, double value) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), format, value);
+    return buf;
+}
+
+/**
+ * @brief 按种子给每台设备一个场景：环境 16-30°C、热阻 0.7-1.5、泄漏 0.03-0.08/s、壳体散热 0.8-1.5
+ */
+void buildDevices() {
+    devices.resize(options.devices);
+    for (unsigned i = 0; i < options.devices; i++) {
+        Device& d = devices[i];
+        char name[16];
+        snprintf(name, sizeof(name), "dev%03u", i);
+        d.name = name;
+        d.state = DEV_WAITING;
+        d.pid = -1;
+        d.launchAtMs = 0;
+        d.resumeAtMs = 0;
+        d.launches = 0;
+        d.exitCode = 0;
+        d.forced = false;
+        d.reapedCpuSec = 0.0;
+        d.maxRssKb = 0;
+        if (options.seed == 0) {
+            continue;
+        }
+        std::mt19937 rng(options.seed * 7919u + i);
+        std::uniform_real_distribution<double> u(0.0, 1.0);
+        d.args = {"-a", fmt("%.1f", 16.0 + 14.0 * u(rng)),
+                  "-r", fmt("%.2f", 0.7 + 0.8 * u(rng)),
+                  "-l", fmt("%.3f", 0.03 + 0.05 * u(rng)),
+                  "-e", fmt("%.2f", 0.8 + 0.7 * u(rng))};
+    }
+}
+
+std::string devicePath(const Device& d, const char* suffix) {
+    return options.dir + "/" + d.name + suffix;
+}
+
+void launch(Device& d, uint64_t now) {
+    uint64_t elapsed = simElapsedMs(now);
+    uint64_t remainingMs = elapsed < options.durationMs ? options.durationMs - elapsed : 0;
+    if (remainingMs == 0) {
+        d.state = DEV_EXITED;
+        return;
+    }
+
+    std::vector<std::string> args = {options.simPath, "-q", "-L", devicePath(d, ".pty"),
+                                     "-t", fmt("%.3f", remainingMs / 1000.0)};
+    if (options.timeScale > 1) {
+        args.push_back("-x");
+        args.push_back(std::to_string(options.timeScale));
+    }
+    if (options.persistentFlash) {
+        args.push_back("-F");
+        args.push_back(devicePath(d, ".flash"));
+    }
+    args.insert(args.end(), d.args.begin(), d.args.end());
+    args.insert(args.end(), options.extraArgs.begin(), options.extraArgs.end());
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        d.state = DEV_EXITED;
+        d.exitCode = 1;
+        return;
+    }
+    if (pid == 0) {
+        int fd = open(devicePath(d, ".out").c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd >= 0) {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        std::vector<char*> argv;
+        for (std::string& a : args) {
+            argv.push_back(&a[0]);
+        }
+        argv.push_back(NULL);
+        execv(argv[0], argv.data());
+        perror(argv[0]);
+        _exit(127);
+    }
+    d.pid = pid;
+    d.state = DEV_RUNNING;
+    d.launches++;
+}
+
+void signalDevice(Device& d, int sig) {
+    if (d.pid > 0) {
+        kill(d.pid, sig);
+    }
+}
+
+/**
+ * @brief 回收已退出的进程（wait4 同时取得CPU时间和峰值内存）
+ */
+void reap() {
+    for (;;) {
+        int status;
+        struct rusage ru;
+        pid_t pid = wait4(-1, &status, WNOHANG, &ru);
+        if (pid <= 0) {
+            return;
+        }
+        for (Device& d : devices) {
+            if (d.pid != pid) {
+                continue;
+            }
+            d.pid = -1;
+            d.reapedCpuSec += ru.ru_utime.tv_sec + ru.ru_stime.tv_sec
+                              + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+            if (ru.ru_maxrss > d.maxRssKb) {
+                d.maxRssKb = ru.ru_maxrss;
+            }
+            if (d.state == DEV_UNPLUGGED) {
+                break;      // 拔出时结束的，稍后重新启动
+            }
+            d.state = DEV_EXITED;
+            d.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+            if (d.exitCode != 0 && !d.forced) {
+                printf("[机群] t=%6.1fs %s 退出，退出码 %d（见 %s）\n", simElapsedMs(nowMs()) / 1000.0,
+                       d.name.c_str(), d.exitCode, devicePath(d, ".out").c_str());
+            }
+            break;
+        }
+    }
+}
+
+void runActions(Device& d, uint64_t now) {
+    const uint64_t simNow = simElapsedMs(now);
+    for (FleetAction& a : d.actions) {
+        if (a.started || simNow < a.atMs || d.state != DEV_RUNNING) {
+            continue;
+        }
+        a.started = true;
+        const uint64_t wallDuration = a.durationMs / options.timeScale;
+        if (a.type == FLEET_UNPLUG) {
+            d.state = DEV_UNPLUGGED;
+            d.launchAtMs = now + wallDuration;
+            signalDevice(d, SIGKILL);
+            unlink(devicePath(d, ".pty").c_str());
+            printf("[机群] t=%6.1fs %s 拔出 %u ms\n", simNow / 1000.0, d.name.c_str(), a.durationMs);
+        } else {
+            d.state = DEV_HUNG;
+            d.resumeAtMs = now + wallDuration;
+            signalDevice(d, SIGSTOP);
+            printf("[机群] t=%6.1fs %s 卡死 %u ms\n", simNow / 1000.0, d.name.c_str(), a.durationMs);
+        }
+        break;
+    }
+}
+
+void step(uint64_t now) {
+    reap();
+    for (Device& d : devices) {
+        switch (d.state) {
+            case DEV_WAITING:
+            case DEV_UNPLUGGED:
+                if (now >= d.launchAtMs && d.pid < 0) {
+                    launch(d, now);
+                }
+                break;
+            case DEV_HUNG:
+                if (now >= d.resumeAtMs) {
+                    signalDevice(d, SIGCONT);
+                    d.state = DEV_RUNNING;
+                }
+                break;
+            case DEV_RUNNING:
+                runActions(d, now);
+                break;
+            case DEV_EXITED:
+                break;
+        }
+    }
+}
+
+/**
+ * @brief 运行中进程的累计CPU时间（/proc/<pid>/stat 的 utime + stime）
+ */
+double liveCpuSec(const Device& d) {
+    if (d.pid <= 0) {
+        return 0.0;
+    }
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int)d.pid);
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        return 0.0;
+    }
+    char buf[1024];
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+    // 进程名可能含空格，从最后一个 ')' 之后数字段：状态是第3个字段，utime/stime 是第14、15个
+    const char* p = strrchr(buf, ')');
+    unsigned long utime = 0, stime = 0;
+    if (p == NULL || sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime) != 2) {
+        return 0.0;
+    }
+    return (double)(utime + stime) / sysconf(_SC_CLK_TCK);
+}
+
+double totalCpuSec() {
+    double sum = 0.0;
+    for (const Device& d : devices) {
+        sum += d.reapedCpuSec + liveCpuSec(d);
+    }
+    return sum;
+}
+
+void printStatus(uint64_t now, double cpuPercent) {
+    unsigned running = 0, hung = 0, unplugged = 0, exited = 0;
+    for (const Device& d : devices) {
+        running += d.state == DEV_RUNNING;
+        hung += d.state == DEV_HUNG;
+        unplugged += d.state == DEV_UNPLUGGED;
+        exited += d.state == DEV_EXITED;
+    }
+    printf("[机群] t=%6.1fs 运行 %u，卡死 %u，拔出 %u，已结束 %u | CPU %.0f%%（每台 %.2f%%）\n",
+           simElapsedMs(now) / 1000.0, running, hung, unplugged, exited, cpuPercent,
+           running > 0 ? cpuPercent / running : 0.0);
+    fflush(stdout);
+}
+
+void onSignal(int) {
+    stopRequested = 1;
+}
+
+/**
+ * @brief 结束所有设备：先恢复卡死的进程，等待它们按 -t 自行退出（打印报告），超时则强制结束
+ *        （卡死期间节拍停止，仿真时间比机群晚）
+ */
+void shutdown(bool graceful) {
+    for (Device& d : devices) {
+        if (d.state == DEV_HUNG) {
+            signalDevice(d, SIGCONT);
+            d.state = DEV_RUNNING;
+        }
+        if (!graceful && d.pid > 0) {
+            d.forced = true;
+            signalDevice(d, SIGTERM);
+        }
+    }
+    uint64_t deadline = nowMs() + FLEET_EXIT_GRACE_MS;
+    for (;;) {
+        reap();
+        bool alive = false;
+        for (const Device& d : devices) {
+            alive = alive || d.pid > 0;
+        }
+        if (!alive) {
+            break;
+        }
+        if (nowMs() >= deadline) {
+            for (Device& d : devices) {
+                if (d.pid > 0) {
+                    d.forced = true;
+                    signalDevice(d, SIGKILL);
+                }
+            }
+            deadline = UINT64_MAX;
+        }
+        usleep(FLEET_TICK_MS * 1000);
+    }
+    for (Device& d : devices) {
+        unlink(devicePath(d, ".pty").c_str());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (!parseOptions(argc, argv)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (access(options.simPath.c_str(), X_OK) != 0) {
+        fprintf(stderr, "找不到 %s（用 -e 指定 glasses_sim）\n", options.simPath.c_str());
+        return 1;
+    }
+    if (mkdir(options.dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        perror(options.dir.c_str());
+        return 1;
+    }
+
+    buildDevices();
+    if (!options.scriptPath.empty() && !loadScript(options.scriptPath)) {
+        return 1;
+    }
+
+    // 每台设备：仿真进程的线程（任务数 + 节拍）和伪终端
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NPROC, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY && rl.rlim_cur < options.devices * 16) {
+        fprintf(stderr, "警告: 进程/线程数上限 %lu，%u 台设备可能不够（ulimit -u）\n",
+                (unsigned long)rl.rlim_cur, options.devices);
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    startMs = nowMs();
+    for (unsigned i = 0; i < devices.size(); i++) {
+        devices[i].launchAtMs = startMs + (uint64_t)i * options.staggerMs;
+    }
+    printf("[机群] %u 台设备，%.0f 秒%s，伪终端 %s/devNNN.pty\n", options.devices, options.durationMs / 1000.0,
+           options.timeScale > 1 ? fmt("（%.0f 倍速）", options.timeScale).c_str() : "", options.dir.c_str());
+    fflush(stdout);
+
+    const uint64_t endMs = startMs + options.durationMs / options.timeScale;
+    uint64_t nextStatus = startMs + options.statusPeriodMs;
+    uint64_t lastStatus = startMs;
+    double lastCpu = 0.0;
+    while (!stopRequested && nowMs() < endMs) {
+        uint64_t now = nowMs();
+        step(now);
+        if (options.statusPeriodMs > 0 && now >= nextStatus) {
+            double cpu = totalCpuSec();
+            printStatus(now, (cpu - lastCpu) * 100.0 / ((now - lastStatus) / 1000.0));
+            lastCpu = cpu;
+            lastStatus = now;
+            nextStatus = now + options.statusPeriodMs;
+        }
+        usleep(FLEET_TICK_MS * 1000);
+    }
+    const double wallSec = (nowMs() - startMs) / 1000.0;
+    shutdown(!stopRequested);
+
+    unsigned launches = 0, failed = 0, stalled = 0, forced = 0;
+    long maxRss = 0;
+    double cpu = 0.0;
+    for (const Device& d : devices) {
+        launches += d.launches;
+        forced += d.forced;
+        stalled += !d.forced && d.exitCode == 3;
+        failed += !d.forced && d.exitCode != 0 && d.exitCode != 3;
+        cpu += d.reapedCpuSec;
+        if (d.maxRssKb > maxRss) {
+            maxRss = d.maxRssKb;
+        }
+    }
+    printf("\n========== 机群报告 (%.1fs 墙钟) ==========\n", wallSec);
+    printf("设备 %u 台，启动 %u 次；互斥锁阻塞超限 %u 台，异常退出 %u 台，强制结束 %u 台\n", options.devices,
+           launches, stalled, failed, forced);
+    printf("CPU 共 %.1f 秒，每台平均 %.2f%%（单核），单台峰值内存 %.1f MB\n", cpu,
+           cpu * 100.0 / wallSec / options.devices, maxRss / 1024.0);
+    if (stopRequested) {
+        return 1;
+    }
+    return failed > 0 ? 1 : (stalled > 0 ? 3 : 0);
+}
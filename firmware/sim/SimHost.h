@@ -0,0 +1,118 @@
+/**
+ * @file SimHost.h
+ * @brief 仿真宿主接口：时钟、输出、引脚/LEDC状态（供仿真模型使用，固件不直接调用）
+ */
+
+#ifndef SIM_HOST_H
+#define SIM_HOST_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief 宿主单调时钟 (µs)
+ */
+uint64_t simMicros64();
+
+/**
+ * @brief 线程安全输出：调度器运行时在临界区内写 stdout
+ *
+ * POSIX 移植层在节拍信号中切换任务，线程可能停在 stdio 锁内，
+ * 其他任务再打印就会死锁；临界区屏蔽节拍信号，避免这种情况。
+ */
+void simPrintf(const char* format, ...) __attribute__((format(printf, 1, 2)));
+void simWrite(const char* data, size_t len);
+
+/**
+ * @brief 静默固件的串口输出（仿真自身的输出不受影响）
+ */
+extern bool simSerialQuiet;
+
+/**
+ * @brief 串口吞吐 (字节/秒)，0 表示不限速
+ *
+ * 限速时按 SIM_SERIAL_TX_FIFO 字节的发送缓冲建模：缓冲满时 Serial.write 阻塞（让出CPU）
+ * 直到腾出空间，与 USB CDC / UART 在主机读取慢时的行为一致。
+ */
+extern uint32_t simSerialBytesPerSecond;
+#define SIM_SERIAL_TX_FIFO  256
+#define SIM_SERIAL_RX_FIFO  256     // 接收缓冲满时不再从伪终端读取，主机端写入被阻塞（与USB一致）
+
+/**
+ * @brief 串口接到伪终端（-u）：固件的全部串口输出（文本和二进制帧）写到伪终端，
+ *        主机工具从从端收发；stdout 仍显示文本（去掉二进制帧）
+ * @return 从端路径（如 /dev/pts/3），失败返回NULL
+ */
+const char* simSerialOpenPty();
+
+/**
+ * @brief 从伪终端读取主机发来的数据，有新数据时触发固件登记的 HWCDC 接收事件
+ *        （仿真 USB 任务每 1ms 调用一次，即 USB 全速帧间隔）
+ */
+void simSerialPoll();
+
+/**
+ * @brief 打开闪存（4MB，分区见 esp_partition.h）
+ * @param path 闪存文件（-F），不存在时新建；NULL 表示只在内存中
+ * @param seedImage 新建闪存时写入 app0 的镜像（-I），可为NULL
+ * @return false 打开失败（原因已打印到 stderr）
+ */
+bool simFlashOpen(const char* path, const char* seedImage);
+
+/**
+ * @brief 闪存是否保存在文件中：是则 NVS 写入 nvs 分区，ESP.restart() 重新启动进程
+ */
+bool simFlashPersistent();
+void simFlashSync();
+
+/**
+ * @brief 分区内容（直接映射，不经 esp_partition 的 NOR 写入规则）
+ * @return 分区不存在或闪存未打开时返回NULL
+ */
+uint8_t* simFlashRegion(const char* label, size_t* size);
+
+/**
+ * @brief 正在运行的分区（启动时 otadata 选择的 app 分区）的内容
+ */
+const uint8_t* simFlashRunningImage(size_t* size);
+
+/**
+ * @brief ESP.restart() 重新启动进程时使用的命令行（main 的 argv）
+ */
+void simSetRestartArgs(char** argv);
+
+/**
+ * @brief 第几次启动（ESP.restart() 重新启动进程时经环境变量 SIM_BOOT_COUNT 传递）
+ */
+unsigned simBootCount();
+
+/**
+ * @brief 外部驱动的数字输入（按键）：forced=true 时 digitalRead 返回 level
+ */
+void simDriveInput(uint8_t pin, bool forced, uint8_t level);
+
+/**
+ * @brief 固件最近一次 digitalWrite 的电平
+ */
+uint8_t simOutputLevel(uint8_t pin);
+
+/**
+ * @brief LEDC 通道当前占空比
+ */
+uint32_t simLedcDuty(uint8_t channel);
+
+/**
+ * @brief 数字引脚钩子（热电偶SPI时序由仿真模型实现）
+ * write: digitalWrite 之后调用；read: 返回 >=0 时作为 digitalRead 的结果
+ */
+typedef void (*SimPinWriteHook)(uint8_t pin, uint8_t level);
+typedef int (*SimPinReadHook)(uint8_t pin);
+void simSetPinHooks(SimPinWriteHook write, SimPinReadHook read);
+
+/**
+ * @brief 芯片内部温度钩子（temperatureRead() 的返回值，未设置时为NAN）
+ */
+typedef float (*SimChipTemperatureHook)();
+void simSetChipTemperatureHook(SimChipTemperatureHook hook);
+
+#endif // SIM_HOST_H
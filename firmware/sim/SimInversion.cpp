@@ -0,0 +1,80 @@
+/**
+ * @file SimInversion.cpp
+ * @brief 优先级反转检验实现
+ */
+
+#include "SimInversion.h"
+#include "SimHost.h"
+#include "SimTrace.h"
+#include "config.h"
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+// 固件（main.cpp）
+extern SemaphoreHandle_t xSerialMutex;
+
+static_assert(TASK_PRIORITY_LOW < TASK_PRIORITY_NORMAL && TASK_PRIORITY_NORMAL < TASK_PRIORITY_HIGH,
+              "SimInvHog 的优先级须在持有者和固件高优先级任务之间");
+
+namespace {
+
+uint32_t rounds = 0;
+
+TickType_t roundStart(uint32_t round) {
+    return pdMS_TO_TICKS(SIM_INV_START_MS) + round * pdMS_TO_TICKS(SIM_INV_ROUND_MS);
+}
+
+void sleepUntil(TickType_t tick) {
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(tick - now) > 0) {
+        vTaskDelay(tick - now);
+    }
+}
+
+// 占用CPU直到指定节拍（不让出，只能被更高优先级的任务抢占）
+void spinUntil(TickType_t tick) {
+    while ((int32_t)(xTaskGetTickCount() - tick) < 0) {
+    }
+}
+
+void holdTask(void* parameter) {
+    (void)parameter;
+    for (uint32_t round = 0;; round++) {
+        sleepUntil(roundStart(round));
+        if (xSerialMutex == NULL) {
+            continue;       // setup() 还没运行到创建互斥锁
+        }
+        xSemaphoreTake(xSerialMutex, portMAX_DELAY);
+        spinUntil(roundStart(round) + pdMS_TO_TICKS(SIM_INV_HOLD_MS));
+        xSemaphoreGive(xSerialMutex);
+        rounds++;
+    }
+}
+
+void hogTask(void* parameter) {
+    (void)parameter;
+    for (uint32_t round = 0;; round++) {
+        TickType_t start = roundStart(round) + pdMS_TO_TICKS(SIM_INV_HOG_AT_MS);
+        sleepUntil(start);
+        spinUntil(start + pdMS_TO_TICKS(SIM_INV_HOG_MS));
+    }
+}
+
+} // namespace
+
+void simInversionBegin() {
+    xTaskCreate(holdTask, "SimInvHold", SIM_TASK_STACK_WORDS, NULL, TASK_PRIORITY_LOW, NULL);
+    xTaskCreate(hogTask, "SimInvHog", SIM_TASK_STACK_WORDS, NULL, TASK_PRIORITY_NORMAL, NULL);
+}
+
+void simInversionReport() {
+    uint32_t blocks = 0;
+    uint32_t maxWaitUs = 0;
+    if (xSerialMutex != NULL) {
+        simTraceWaitsOn(xSerialMutex, TASK_PRIORITY_HIGH, &blocks, &maxWaitUs);
+    }
+    simPrintf("\n优先级反转检验（SimInvHold 持有 serial %u ms，%u ms 后 SimInvHog 占用 %u ms，每 %u ms 一轮）:\n",
+              SIM_INV_HOLD_MS, SIM_INV_HOG_AT_MS, SIM_INV_HOG_MS, SIM_INV_ROUND_MS);
+    simPrintf("  %lu 轮，高优先级固件任务在 serial 上阻塞 %lu 次，最长等待 %lu ms\n",
+              (unsigned long)rounds, (unsigned long)blocks, (unsigned long)(maxWaitUs / 1000));
+}
@@ -0,0 +1,36 @@
+/**
+ * @file SimInversion.h
+ * @brief 优先级反转检验（-P）：固件照常运行，仿真任务周期性占住固件的串口互斥锁
+ *
+ * 每轮：SimInvHold（优先级 TASK_PRIORITY_LOW）取 safePrint() 用的 xSerialMutex 后忙等 SIM_INV_HOLD_MS；
+ * SIM_INV_HOG_AT_MS 后 SimInvHog（TASK_PRIORITY_NORMAL）就绪并忙等 SIM_INV_HOG_MS。
+ * 温度/压力/安全/监督任务（TASK_PRIORITY_HIGH 及以上）的周期打印落在持有期内时阻塞在这把锁上：
+ * - 内核做了优先级继承：持有者被提升到请求者的优先级，SimInvHog 抢不走CPU，
+ *   固件任务最多等一个临界区（SIM_INV_HOLD_MS）
+ * - 没有继承：持有者被 SimInvHog 抢占，固件任务要等到 SimInvHog 结束，最长约 SIM_INV_HOG_MS + SIM_INV_HOLD_MS
+ * 轮长取与固件打印周期（5 s）不成整数倍的值，固件打印在各轮中的位置逐轮移动。
+ * 阻塞次数和最长等待取自跟踪钩子（SimTrace），提升次数在报告的"优先级继承"一节给出。
+ */
+
+#ifndef SIM_INVERSION_H
+#define SIM_INVERSION_H
+
+#include <FreeRTOS.h>
+
+#define SIM_INV_START_MS    1000    // 第一轮开始（固件 setup() 已创建 xSerialMutex）
+#define SIM_INV_HOLD_MS     20      // SimInvHold 的临界区
+#define SIM_INV_HOG_AT_MS   1       // SimInvHog 在本轮开始后多久就绪
+#define SIM_INV_HOG_MS      50      // SimInvHog 忙等的时间
+#define SIM_INV_ROUND_MS    97
+
+/**
+ * @brief 创建 SimInvHold 和 SimInvHog，须在启动调度器之前调用
+ */
+void simInversionBegin();
+
+/**
+ * @brief 打印轮数和高优先级固件任务在串口互斥锁上的阻塞次数、最长等待
+ */
+void simInversionReport();
+
+#endif // SIM_INVERSION_H
@@ -0,0 +1,409 @@
+/**
+ * @file SimMain.cpp
+ * @brief 主机仿真入口：在 FreeRTOS POSIX 移植层上运行未修改的固件
+ *
+ * 与 Arduino-ESP32 相同，setup()/loop() 在优先级1的 loopTask 中运行，
+ * 固件任务由 setup() 创建。另有两个仿真任务，优先级高于所有固件任务：
+ * - SimPlant：每 SIM_PLANT_PERIOD_MS 推进被控对象模型、执行按键脚本
+ * - SimMonitor：检查互斥锁长时间阻塞，仿真结束时打印统计并退出
+ * - SimUsb（-u）：每 1ms 从伪终端读取主机数据，触发串口接收事件
+ * - SimClock（-x）：加速运行，每个节拍后补上 倍数-1 个节拍
+ *
+ * -P 时另有 SimInvHold/SimInvHog 周期性占住固件的串口互斥锁，检验优先级继承（SimInversion.h）。
+ *
+ * 闪存（-F）保存在文件中时，ESP.restart() 以相同参数重新启动进程，固件"运行"otadata
+ * 选择的 app 分区：镜像内容不会被执行，只是其中的 SIMFAULT:故障 标记在启动时按 -f 注入，
+ * 用来模拟有缺陷的新固件（升级后自检失败、回滚）。
+ *
+ * 退出码：0 正常；3 检测到互斥锁阻塞超过阈值（可用于CI）；4 重启次数超过 SIM_MAX_BOOTS。
+ */
+
+#include <Arduino.h>
+#include <freertos/semphr.h>
+#include "config.h"
+#include "ResponseTime.h"
+#include "SimHost.h"
+#include "SimInversion.h"
+#include "SimPlant.h"
+#include "SimTrace.h"
+
+#include <getopt.h>
+#include <unistd.h>
+
+// 固件（main.cpp）
+void setup();
+void loop();
+extern SemaphoreHandle_t xSerialMutex;
+
+namespace {
+
+const UBaseType_t USB_PRIORITY = configMAX_PRIORITIES - 3;
+const UBaseType_t PLANT_PRIORITY = configMAX_PRIORITIES - 2;
+const UBaseType_t MONITOR_PRIORITY = configMAX_PRIORITIES - 1;
+const UBaseType_t CLOCK_PRIORITY = configMAX_PRIORITIES - 1;
+const uint32_t MONITOR_PERIOD_MS = 20;
+const unsigned SIM_MAX_BOOTS = 20;      // 防止回滚/重启循环无限进行
+const unsigned SIM_MAX_TIME_SCALE = 20;
+const useconds_t IDLE_SLEEP_US = 15000; // 空闲任务的睡眠（节拍信号会提前打断）
+
+struct SimOptions {
+    uint32_t durationMs;
+    uint32_t stallThresholdMs;
+    uint32_t statusPeriodMs;        // 0 = 不打印模型状态
+    unsigned timeScale;             // 1 = 实时；n = 每毫秒墙钟推进 n 个节拍
+    bool usbPty;                    // 串口接到伪终端
+    const char* ptyLink;            // 伪终端的符号链接（重启后路径不变）
+    const char* flashPath;          // NULL = 闪存只在内存中
+    const char* seedImage;
+    bool inversion;                 // -P：同时运行优先级反转检验
+    SimScenario scenario;
+};
+
+SimOptions options;
+
+void printUsage(const char* prog) {
+    fprintf(stderr,
+            "用法: %s [选项]\n"
+            "  -t 秒        仿真时长（默认 120）\n"
+            "  -a 温度      环境温度 °C（默认 22）\n"
+            "  -r 系数      加热片-皮肤热阻（默认 1.0，越大越省功率）\n"
+            "  -e 系数      壳体散热热阻倍数（默认 1.0，越大板温越高）\n"
+            "  -l 泄漏率    腔体泄漏率 1/s（默认 0.05）\n"
+            "  -z 系数      压力传感器零点温漂 kPa/°C（以 25°C 板温为零点，默认 0）\n"
+            "  -f 故障[:通道][@秒[+毫秒]]  注入硬件故障（可重复，默认通道0；带@为限时故障，默认 1000ms）：\n"
+            "               heater_open/heater_stuck/thermo_open/thermo_detached/pump_dead/\n"
+            "               pressure_absent/pressure_noisy/chamber_open\n"
+            "               例: -f heater_open  -f thermo_open@60+3000  -f pressure_absent:1@45+500\n"
+            "  -p 按键@秒[+毫秒]  按键脚本，按键: stop/up/down/updown，默认保持 200ms\n"
+            "               例: -p stop@30  -p updown@35+2500  -p down@60+2500\n"
+            "  -b 字节/秒   串口吞吐限制（默认 0 不限速）\n"
+            "  -s 毫秒      互斥锁阻塞报警阈值（默认 100）\n"
+            "  -v 毫秒      周期打印模型状态\n"
+            "  -x 倍数      加速运行（整数，最大 %u）：固件与模型时间按倍数推进，-t 为仿真时间\n"
+            "  -u           串口接到伪终端（路径打印到 stderr），主机工具经此收发二进制帧\n"
+            "  -L 路径      同 -u，并把伪终端链接到该路径（重启后主机工具用同一路径重连）\n"
+            "  -F 文件      闪存保存在文件中（不存在则新建）：NVS、OTA 分区在重启间保留，\n"
+            "               ESP.restart() 重新启动进程\n"
+            "  -I 镜像      新建闪存时写入 app0 的固件镜像（升级的源镜像）\n"
+            "  -P           优先级反转检验：仿真任务占住串口互斥锁，固件任务在 safePrint() 中等待\n"
+            "  -q           不显示固件串口输出\n",
+            prog, SIM_MAX_TIME_SCALE);
+}
+
+bool parseButton(const char* arg, SimButtonEvent& e) {
+    char name[16];
+    double atSeconds = 0.0;
+    unsigned holdMs = 200;
+    if (sscanf(arg, "%15[a-z]@%lf+%u", name, &atSeconds, &holdMs) < 2) {
+        return false;
+    }
+    e.pin2 = 0xFF;
+    if (strcmp(name, "stop") == 0) {
+        e.pin = BUTTON_STOP_PIN;
+    } else if (strcmp(name, "up") == 0) {
+        e.pin = BUTTON_UP_PIN;
+    } else if (strcmp(name, "down") == 0) {
+        e.pin = BUTTON_DOWN_PIN;
+    } else if (strcmp(name, "updown") == 0) {
+        e.pin = BUTTON_UP_PIN;
+        e.pin2 = BUTTON_DOWN_PIN;
+    } else {
+        return false;
+    }
+    e.atMs = (uint32_t)(atSeconds * 1000.0);
+    e.holdMs = holdMs;
+    return true;
+}
+
+bool parseFault(const char* arg, SimScenario& s) {
+    char name[24];
+    unsigned channel = 0;
+    int consumed = 0;
+    if (sscanf(arg, "%23[a-z_]%n", name, &consumed) < 1) {
+        return false;
+    }
+    const char* rest = arg + consumed;
+    if (*rest == ':') {
+        char* end;
+        channel = (unsigned)strtoul(rest + 1, &end, 10);
+        rest = end;
+    }
+    uint16_t fault = simFaultFromName(name);
+    if (fault == 0 || channel >= SIM_MAX_CHANNELS) {
+        return false;
+    }
+    if (*rest == '\0') {
+        s.faults[channel] |= fault;
+        return true;
+    }
+
+    // 限时故障：@秒[+毫秒]，默认持续 1000ms
+    double atSeconds = 0.0;
+    unsigned durationMs = 1000;
+    if (s.faultWindowCount >= SIM_MAX_FAULT_WINDOWS
+            || sscanf(rest, "@%lf+%u", &atSeconds, &durationMs) < 1) {
+        return false;
+    }
+    SimFaultWindow& w = s.faultWindows[s.faultWindowCount++];
+    w.channel = (uint8_t)channel;
+    w.fault = fault;
+    w.atMs = (uint32_t)(atSeconds * 1000.0);
+    w.durationMs = durationMs;
+    return true;
+}
+
+bool parseOptions(int argc, char** argv) {
+    options.durationMs = 120000;
+    options.stallThresholdMs = 100;
+    options.statusPeriodMs = 0;
+    options.timeScale = 1;
+    options.usbPty = false;
+    options.ptyLink = NULL;
+    options.flashPath = NULL;
+    options.seedImage = NULL;
+    options.inversion = false;
+    options.scenario.ambient = 22.0f;
+    options.scenario.padResistance = 1.0f;
+    options.scenario.boardResistance = 1.0f;
+    options.scenario.leakRate = 0.05f;
+    options.scenario.zeroDrift = 0.0f;
+    options.scenario.buttonCount = 0;
+    memset(options.scenario.faults, 0, sizeof(options.scenario.faults));
+    options.scenario.faultWindowCount = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "t:a:r:e:l:z:p:f:b:s:v:x:uL:F:I:Pqh")) != -1) {
+        switch (opt) {
+            case 't': options.durationMs = (uint32_t)(atof(optarg) * 1000.0); break;
+            case 'a': options.scenario.ambient = (float)atof(optarg); break;
+            case 'r': options.scenario.padResistance = (float)atof(optarg); break;
+            case 'e': options.scenario.boardResistance = (float)atof(optarg); break;
+            case 'l': options.scenario.leakRate = (float)atof(optarg); break;
+            case 'z': options.scenario.zeroDrift = (float)atof(optarg); break;
+            case 'b': simSerialBytesPerSecond = (uint32_t)atol(optarg); break;
+            case 's': options.stallThresholdMs = (uint32_t)atol(optarg); break;
+            case 'v': options.statusPeriodMs = (uint32_t)atol(optarg); break;
+            case 'x': options.timeScale = (unsigned)atoi(optarg); break;
+            case 'u': options.usbPty = true; break;
+            case 'L': options.usbPty = true; options.ptyLink = optarg; break;
+            case 'F': options.flashPath = optarg; break;
+            case 'I': options.seedImage = optarg; break;
+            case 'P': options.inversion = true; break;
+            case 'q': simSerialQuiet = true; break;
+            case 'p': {
+                SimScenario& s = options.scenario;
+                if (s.buttonCount >= SIM_MAX_BUTTON_EVENTS || !parseButton(optarg, s.buttons[s.buttonCount])) {
+                    fprintf(stderr, "无效的按键脚本: %s\n", optarg);
+                    return false;
+                }
+                s.buttonCount++;
+                break;
+            }
+            case 'f':
+                if (!parseFault(optarg, options.scenario)) {
+                    fprintf(stderr, "无效的故障: %s\n", optarg);
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+    return options.scenario.padResistance > 0.0f && options.scenario.boardResistance >= 0.0f
+           && options.timeScale >= 1 && options.timeScale <= SIM_MAX_TIME_SCALE;
+}
+
+/**
+ * @brief 正在运行的镜像中的 SIMFAULT:故障 标记（格式同 -f），按 -f 注入
+ */
+void applyImageFaults() {
+    static const char MARKER[] = "SIMFAULT:";
+    size_t size = 0;
+    const uint8_t* image = simFlashRunningImage(&size);
+    const uint8_t* end = image + size;
+    while (image != NULL && image < end) {
+        const uint8_t* hit = (const uint8_t*)memmem(image, end - image, MARKER, sizeof(MARKER) - 1);
+        if (hit == NULL) {
+            break;
+        }
+        const char* arg = (const char*)hit + sizeof(MARKER) - 1;
+        size_t len = strnlen(arg, end - (const uint8_t*)arg);
+        char fault[48];
+        // 本程序自己的 MARKER 字符串后面没有故障名，跳过
+        if (len > 0 && len < sizeof(fault)) {
+            memcpy(fault, arg, len);
+            fault[len] = '\0';
+            if (parseFault(fault, options.scenario)) {
+                fprintf(stderr, "镜像故障标记: %s\n", fault);
+            }
+        }
+        image = hit + 1;
+    }
+}
+
+void printStatus(uint32_t now_ms) {
+    for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+        SimChannelState s = simPlantChannel(i);
+        simPrintf("[模型] t=%6.1fs 通道%u 加热片 %.2f°C 加热丝 %.2f°C 占空比 %3.0f%% | 负压 %.2f mmHg 泵速 %3.0f%%\n",
+                  now_ms / 1000.0, (unsigned)i, s.padTemp, s.heaterTemp, s.heaterDuty * 100.0f,
+                  s.vacuum, s.pumpPercent);
+    }
+    float board = simPlantBoardTemp();
+    if (options.scenario.zeroDrift != 0.0f) {
+        simPrintf("[模型] t=%6.1fs 板温 %.2f°C 芯片 %.2f°C 压力零点 %+.3f kPa\n", now_ms / 1000.0, board,
+                  temperatureRead(), simPlantPressureZero());
+    } else {
+        simPrintf("[模型] t=%6.1fs 板温 %.2f°C 芯片 %.2f°C\n", now_ms / 1000.0, board, temperatureRead());
+    }
+}
+
+/**
+ * @brief Arduino-ESP32 的 loopTask：setup() 一次，然后循环 loop()
+ */
+void loopTask(void* parameter) {
+    (void)parameter;
+    setup();
+
+    // 给固件的同步对象命名，统计报告中按名字显示
+    vQueueAddToRegistry(xSerialMutex, "serial");
+
+    for (;;) {
+        loop();
+    }
+}
+
+void plantTask(void* parameter) {
+    (void)parameter;
+    TickType_t lastWake = xTaskGetTickCount();
+    uint32_t nextStatus = 0;
+    for (;;) {
+        uint32_t now = millis();
+        simPlantStep(now);
+        if (options.statusPeriodMs > 0 && now >= nextStatus) {
+            printStatus(now);
+            nextStatus = now + options.statusPeriodMs;
+        }
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(SIM_PLANT_PERIOD_MS));
+    }
+}
+
+void usbTask(void* parameter) {
+    (void)parameter;
+    TickType_t lastWake = xTaskGetTickCount();
+    for (;;) {
+        simSerialPoll();
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(1));
+    }
+}
+
+/**
+ * @brief 加速运行（-x）：每个节拍后补上 timeScale-1 个节拍
+ *
+ * 补上的节拍由内核逐个处理（xTaskCatchUpTicks），到期的任务按优先级依次运行，
+ * 所以一毫秒墙钟内的几个节拍是成批推进的。固件周期都不短于 1ms，倍数不大时不影响控制回路；
+ * micros()、串口限速、互斥锁阻塞报警仍按墙钟计时。
+ */
+void clockTask(void* parameter) {
+    (void)parameter;
+    for (;;) {
+        vTaskDelay(1);
+        xTaskCatchUpTicks(options.timeScale - 1);
+    }
+}
+
+void printReport() {
+    static char stats[2048];
+    vTaskGetRunTimeStats(stats);
+    if (options.timeScale > 1) {
+        simPrintf("\n========== 仿真报告 (%.1fs，%u 倍速) ==========\n", millis() / 1000.0, options.timeScale);
+    } else {
+        simPrintf("\n========== 仿真报告 (%.1fs) ==========\n", millis() / 1000.0);
+    }
+    simPrintf("CPU占用（任务 / 累计µs / 占比）:\n%s", stats);
+    simTraceReport();
+    simPrintf("\n互斥锁阻塞超过 %lu ms: %lu 次\n",
+              (unsigned long)options.stallThresholdMs, (unsigned long)simTraceStallCount());
+    simPrintf("\n响应时间分析（config.h 中的预算，目标板160MHz，不是仿真实测）:\n");
+    rtaReport(RTA_FIRMWARE_TASKS, [](const char* line) { simPrintf("%s\n", line); });
+    if (options.inversion) {
+        simInversionReport();
+    }
+    printStatus(millis());
+}
+
+void monitorTask(void* parameter) {
+    (void)parameter;
+    TickType_t lastWake = xTaskGetTickCount();
+    while (millis() < options.durationMs) {
+        simTraceCheckStalls(options.stallThresholdMs);
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(MONITOR_PERIOD_MS));
+    }
+
+    vTaskSuspendAll();
+    printReport();
+    fflush(stdout);
+    // 其他任务的线程仍挂起在调度器中，直接结束进程
+    _exit(simTraceStallCount() > 0 ? 3 : 0);
+}
+
+} // namespace
+
+/**
+ * @brief 空闲钩子：POSIX 移植层的空闲任务是宿主线程上的忙循环，不睡眠则每个仿真进程占满一个核。
+ *        节拍信号打断 usleep，有任务就绪时照常切换，不影响时序
+ */
+extern "C" void vApplicationIdleHook(void) {
+    usleep(IDLE_SLEEP_US);
+}
+
+int main(int argc, char** argv) {
+    if (!parseOptions(argc, argv)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (simBootCount() > SIM_MAX_BOOTS) {
+        fprintf(stderr, "重启超过 %u 次，停止\n", SIM_MAX_BOOTS);
+        return 4;
+    }
+    if (!simFlashOpen(options.flashPath, options.seedImage)) {
+        return 1;
+    }
+    simSetRestartArgs(argv);
+    if (simBootCount() > 1) {
+        fprintf(stderr, "第 %u 次启动\n", simBootCount());
+    }
+    applyImageFaults();
+
+    simPlantBegin(options.scenario);
+    if (options.usbPty) {
+        const char* pty = simSerialOpenPty();
+        if (pty == NULL) {
+            perror("posix_openpt");
+            return 1;
+        }
+        fprintf(stderr, "串口伪终端: %s\n", pty);
+        if (options.ptyLink != NULL) {
+            unlink(options.ptyLink);
+            if (symlink(pty, options.ptyLink) != 0) {
+                perror(options.ptyLink);
+                return 1;
+            }
+        }
+        xTaskCreate(usbTask, "SimUsb", SIM_TASK_STACK_WORDS, NULL, USB_PRIORITY, NULL);
+    }
+
+    // Arduino-ESP32：loopTask 优先级1，栈 8KB
+    xTaskCreate(loopTask, "loopTask", SIM_TASK_STACK_WORDS, NULL, 1, NULL);
+    if (options.inversion) {
+        simInversionBegin();
+    }
+    xTaskCreate(plantTask, "SimPlant", SIM_TASK_STACK_WORDS, NULL, PLANT_PRIORITY, NULL);
+    xTaskCreate(monitorTask, "SimMonitor", SIM_TASK_STACK_WORDS, NULL, MONITOR_PRIORITY, NULL);
+    if (options.timeScale > 1) {
+        xTaskCreate(clockTask, "SimClock", SIM_TASK_STACK_WORDS, NULL, CLOCK_PRIORITY, NULL);
+    }
+
+    vTaskStartScheduler();
+    return 0;
+}
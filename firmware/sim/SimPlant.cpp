@@ -0,0 +1,403 @@
+/**
+ * @file SimPlant.cpp
+ * @brief 被控对象与外设模型实现
+ */
+
+#include "SimPlant.h"
+#include "SimHost.h"
+#include <Arduino.h>
+#include <Wire.h>
+#include "config.h"
+#include "KTypeThermocouple.h"
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+const float HEATER_GAIN = 60.0f;        // 全功率时加热丝升温速率 (°C/s)
+const float HEATER_COUPLING = 0.25f;    // 加热丝-加热片热阻
+const float PAD_CAPACITY = 60.0f;       // 加热片相对热容
+const float OPEN_CHAMBER_LEAK = 5.0f;   // 腔体未密封时的泄漏率 (1/s)
+const float NOISY_PRESSURE_MMHG = 4.0f; // 压力噪声故障的幅度
+const float BOARD_HEATER_RISE = 12.0f;  // 每通道加热满功率时板温稳态温升 (°C)
+const float BOARD_PUMP_RISE = 6.0f;     // 每通道泵满速时板温稳态温升 (°C)
+const float BOARD_TAU_S = 60.0f;        // 板温时间常数 (s)
+const float CHIP_SELF_HEATING = 8.0f;   // 芯片内部温度高于板温 (°C)
+const float SENSOR_ZERO_REF = 25.0f;    // 压力传感器零点无漂移的板温 (°C)
+
+/**
+ * @brief 压力传感器寄存器模型（CPS610DSD003DH01 / XGZP6897D 共用 0x30 命令寄存器）
+ */
+class SimPressureSensor : public SimI2CDevice {
+public:
+    SimPressureSensor() : xgzp(false), kpa(0.0f), sensorTemp(25.0f),
+                          cmd(0x02), config(0x00), conversionEnd(0) {}
+
+    void setModel(bool is_xgzp) { xgzp = is_xgzp; }
+
+    void setReading(float gauge_kpa, float temp_c) {
+        kpa = gauge_kpa;
+        sensorTemp = temp_c;
+    }
+
+    void writeRegisters(uint8_t reg, const uint8_t* data, size_t len) override {
+        if (len == 0) {
+            return;
+        }
+        if (reg == CMD_REG) {
+            cmd = data[0];
+            if (cmd & CMD_SCO) {
+                conversionEnd = millis() + (xgzp ? 6 : 8);
+            }
+        } else if (reg == P_CONFIG_REG) {
+            config = data[0];
+        }
+    }
+
+    uint8_t readRegister(uint8_t reg) override {
+        if (reg == CMD_REG) {
+            // 转换完成后SCO位清零
+            if ((cmd & CMD_SCO) && (int32_t)(millis() - conversionEnd) >= 0) {
+                cmd &= (uint8_t)~CMD_SCO;
+            }
+            return cmd;
+        }
+        if (reg == P_CONFIG_REG) {
+            return config;
+        }
+
+        int32_t raw = xgzp ? (int32_t)lroundf(kpa * 1000.0f * XGZP6897D_K_FACTOR)
+                           : (int32_t)lroundf((kpa + 3.75f) / 7.5f * 8388608.0f);
+        int16_t rawTemp = (int16_t)lroundf(sensorTemp * 256.0f);
+        switch (reg) {
+            case 0x06: return (uint8_t)(raw >> 16);
+            case 0x07: return (uint8_t)(raw >> 8);
+            case 0x08: return (uint8_t)raw;
+            case 0x09: return (uint8_t)(rawTemp >> 8);
+            case 0x0A: return (uint8_t)rawTemp;
+            default:   return 0x00;
+        }
+    }
+
+private:
+    static const uint8_t CMD_REG = 0x30;
+    static const uint8_t CMD_SCO = 0x08;
+    static const uint8_t P_CONFIG_REG = 0xA6;
+
+    bool xgzp;
+    float kpa;
+    float sensorTemp;
+    uint8_t cmd;
+    uint8_t config;
+    uint32_t conversionEnd;
+};
+
+struct ChannelModel {
+    uint8_t heatPwmChannel;
+    uint8_t pumpPwmChannel;
+    uint8_t csPin;
+    uint8_t pressureAddr;
+    float heater;
+    float pad;
+    float vacuum;
+    uint32_t frame;             // CS拉低时锁存的热电偶数据帧
+    uint16_t faults;            // 当前生效的 SimFault 位掩码（常驻 + 限时）
+    uint32_t heaterDropoutMs;   // 热电偶限时中断开始时刻（加热输出清零后清除），0 = 无
+    uint32_t pumpDropoutMs;     // 压力传感器限时中断开始时刻，0 = 无
+    SimPressureSensor sensor;
+};
+
+ChannelModel channels[NUM_CHANNELS];
+SimScenario scenario;
+float board = 0.0f;             // 板温 B
+uint32_t lastStepMs = 0;
+bool started = false;
+
+// 热电偶SPI移位寄存器
+int8_t selected = -1;           // CS拉低的通道
+uint8_t bitIndex = 0;
+
+#if THERMO_CHIP == THERMO_CHIP_MAX6675
+const uint8_t FRAME_BITS = 16;
+#else
+const uint8_t FRAME_BITS = 32;
+#endif
+
+uint8_t resolvePressureAddr(uint8_t addr) {
+    if (addr != PRESSURE_I2C_ADDR_AUTO) {
+        return addr;
+    }
+    return PRESSURE_SENSOR_MODEL == PRESSURE_MODEL_XGZP6897D ? 0x6D : 0x7F;
+}
+
+bool isXgzp(uint8_t addr) {
+    if (PRESSURE_SENSOR_MODEL == PRESSURE_MODEL_XGZP6897D) return true;
+    if (PRESSURE_SENSOR_MODEL == PRESSURE_MODEL_CPS610DSD003DH01) return false;
+    return addr == 0x6D;
+}
+
+/**
+ * @brief 按芯片格式编码热电偶数据帧
+ */
+uint32_t encodeFrame(float hot, float cold) {
+#if THERMO_CHIP == THERMO_CHIP_MAX6675
+    (void)cold;
+    int32_t counts = (int32_t)lroundf(hot * 4.0f);
+    if (counts < 0) counts = 0;
+    return ((uint32_t)counts & 0x0FFF) << 3;
+#else
+    // MAX31855 按 41.276µV/°C 线性换算热电偶电压：先求实际电压，再换算成芯片读数
+    float mv = KTypeThermocouple::voltageFromTemperature(hot) - KTypeThermocouple::voltageFromTemperature(cold);
+    float chipHot = cold + mv / 0.041276f;
+    int32_t hotCounts = (int32_t)lroundf(chipHot * 4.0f) & 0x3FFF;
+    int32_t coldCounts = (int32_t)lroundf(cold * 16.0f) & 0x0FFF;
+    return ((uint32_t)hotCounts << 18) | ((uint32_t)coldCounts << 4);
+#endif
+}
+
+/**
+ * @brief CS拉低时锁存的数据帧（含注入的热电偶故障）
+ */
+uint32_t thermoFrame(const ChannelModel& ch) {
+    if (ch.faults & SIM_FAULT_THERMO_OPEN) {
+#if THERMO_CHIP == THERMO_CHIP_MAX6675
+        return 0x0004;
+#else
+        return encodeFrame(board, board) | 0x00010001;
+#endif
+    }
+    float hot = (ch.faults & SIM_FAULT_THERMO_DETACHED) ? scenario.ambient : ch.pad;
+    return encodeFrame(hot, board);
+}
+
+float chipTemperature() {
+    return board + CHIP_SELF_HEATING;
+}
+
+void onPinWrite(uint8_t pin, uint8_t level) {
+    for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+        if (pin != channels[i].csPin) {
+            continue;
+        }
+        if (level == LOW) {
+            selected = i;
+            bitIndex = 0;
+            channels[i].frame = thermoFrame(channels[i]);
+        } else if (selected == (int8_t)i) {
+            selected = -1;
+        }
+        return;
+    }
+    // 下降沿移出下一位
+    if (pin == THERMO_CLK_PIN && level == LOW && selected >= 0 && bitIndex < FRAME_BITS) {
+        bitIndex++;
+    }
+}
+
+int onPinRead(uint8_t pin) {
+    if (pin != THERMO_MISO_PIN || selected < 0) {
+        return -1;
+    }
+    if (bitIndex >= FRAME_BITS) {
+        return LOW;
+    }
+    return (channels[selected].frame >> (FRAME_BITS - 1 - bitIndex)) & 1;
+}
+
+/**
+ * @brief 当前生效的故障：常驻故障 + 处于时间窗内的限时故障
+ */
+uint16_t activeFaults(uint8_t channel, uint32_t now_ms) {
+    uint16_t faults = channel < SIM_MAX_CHANNELS ? scenario.faults[channel] : 0;
+    for (uint8_t i = 0; i < scenario.faultWindowCount; i++) {
+        const SimFaultWindow& w = scenario.faultWindows[i];
+        if (w.channel == channel && now_ms >= w.atMs && now_ms - w.atMs < w.durationMs) {
+            faults |= w.fault;
+        }
+    }
+    return faults;
+}
+
+/**
+ * @brief 传感器中断期间跟踪对应执行器输出，清零时打印距中断开始的时间
+ * @param since 中断开始时刻（0 = 未在跟踪）
+ * @param dropped 传感器当前处于中断
+ * @param output 执行器当前占空比
+ */
+void trackDropout(uint8_t channel, const char* name, uint32_t& since, bool dropped,
+                  uint32_t output, uint32_t now_ms) {
+    if (since == 0) {
+        if (dropped && output > 0) {
+            since = now_ms;
+        }
+        return;
+    }
+    if (output == 0) {
+        simPrintf("[模型] t=%6.1fs 通道%u 传感器中断 %lu ms 后%s输出清零\n", now_ms / 1000.0,
+                  (unsigned)channel, (unsigned long)(now_ms - since), name);
+        since = 0;
+    } else if (!dropped) {
+        simPrintf("[模型] t=%6.1fs 通道%u 传感器中断 %lu ms 已恢复，%s输出未清零\n", now_ms / 1000.0,
+                  (unsigned)channel, (unsigned long)(now_ms - since), name);
+        since = 0;
+    }
+}
+
+void stepButtons(uint32_t now_ms) {
+    // 同一按键可能出现在多条脚本中，先合并再驱动
+    const uint8_t MAX_PIN = 48;
+    bool used[MAX_PIN] = {};
+    bool pressed[MAX_PIN] = {};
+    for (uint8_t i = 0; i < scenario.buttonCount; i++) {
+        const SimButtonEvent& e = scenario.buttons[i];
+        bool active = now_ms >= e.atMs && now_ms - e.atMs < e.holdMs;
+        uint8_t pins[2] = { e.pin, e.pin2 };
+        for (uint8_t p : pins) {
+            if (p < MAX_PIN) {
+                used[p] = true;
+                pressed[p] = pressed[p] || active;
+            }
+        }
+    }
+    for (uint8_t p = 0; p < MAX_PIN; p++) {
+        if (used[p]) {
+            simDriveInput(p, pressed[p], LOW);  // 低电平为按下，松开时恢复上拉
+        }
+    }
+}
+
+} // namespace
+
+uint16_t simFaultFromName(const char* name) {
+    static const struct { const char* name; uint16_t fault; } table[] = {
+        { "heater_open",      SIM_FAULT_HEATER_OPEN },
+        { "heater_stuck",     SIM_FAULT_HEATER_STUCK },
+        { "thermo_open",      SIM_FAULT_THERMO_OPEN },
+        { "thermo_detached",  SIM_FAULT_THERMO_DETACHED },
+        { "pump_dead",        SIM_FAULT_PUMP_DEAD },
+        { "pressure_absent",  SIM_FAULT_PRESSURE_ABSENT },
+        { "pressure_noisy",   SIM_FAULT_PRESSURE_NOISY },
+        { "chamber_open",     SIM_FAULT_CHAMBER_OPEN },
+    };
+    for (const auto& e : table) {
+        if (strcmp(name, e.name) == 0) {
+            return e.fault;
+        }
+    }
+    return 0;
+}
+
+void simPlantBegin(const SimScenario& s) {
+    scenario = s;
+
+    static const uint8_t heatChannels[] = { PWM_CHANNEL_HEAT, CH1_PWM_CHANNEL_HEAT };
+    static const uint8_t pumpChannels[] = { PWM_CHANNEL_PUMP, CH1_PWM_CHANNEL_PUMP };
+    static const uint8_t csPins[] = { THERMO_CS_PIN, CH1_THERMO_CS_PIN };
+    static const uint8_t addrs[] = { PRESSURE_I2C_ADDR, CH1_PRESSURE_I2C_ADDR };
+
+    for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+        ChannelModel& ch = channels[i];
+        ch.heatPwmChannel = heatChannels[i];
+        ch.pumpPwmChannel = pumpChannels[i];
+        ch.csPin = csPins[i];
+        ch.pressureAddr = resolvePressureAddr(addrs[i]);
+        ch.heater = scenario.ambient;
+        ch.pad = scenario.ambient;
+        ch.vacuum = 0.0f;
+        ch.frame = 0;
+        ch.faults = activeFaults(i, 0);
+        ch.heaterDropoutMs = 0;
+        ch.pumpDropoutMs = 0;
+        ch.sensor.setModel(isXgzp(ch.pressureAddr));
+        ch.sensor.setReading(0.0f, scenario.ambient);
+        Wire.attach(ch.pressureAddr, (ch.faults & SIM_FAULT_PRESSURE_ABSENT) ? NULL : &ch.sensor);
+    }
+    board = scenario.ambient;
+    simSetPinHooks(onPinWrite, onPinRead);
+    simSetChipTemperatureHook(chipTemperature);
+    started = false;
+}
+
+void simPlantStep(uint32_t now_ms) {
+    if (!started) {
+        lastStepMs = now_ms;
+        started = true;
+    }
+    float dt = (now_ms - lastStepMs) / 1000.0f;
+    lastStepMs = now_ms;
+
+    stepButtons(now_ms);
+    if (dt <= 0.0f) {
+        return;
+    }
+
+    float boardRise = 0.0f;
+    for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+        ChannelModel& ch = channels[i];
+        uint16_t faults = activeFaults(i, now_ms);
+        if ((faults ^ ch.faults) & SIM_FAULT_PRESSURE_ABSENT) {
+            Wire.attach(ch.pressureAddr, (faults & SIM_FAULT_PRESSURE_ABSENT) ? NULL : &ch.sensor);
+        }
+        ch.faults = faults;
+        trackDropout(i, "加热", ch.heaterDropoutMs, faults & SIM_FAULT_THERMO_OPEN,
+                     simLedcDuty(ch.heatPwmChannel), now_ms);
+        trackDropout(i, "泵", ch.pumpDropoutMs, faults & SIM_FAULT_PRESSURE_ABSENT,
+                     simLedcDuty(ch.pumpPwmChannel), now_ms);
+
+        float duty = simLedcDuty(ch.heatPwmChannel) / 255.0f;
+        float pump = simLedcDuty(ch.pumpPwmChannel) * 100.0f / 255.0f;
+        if (ch.faults & SIM_FAULT_HEATER_OPEN) duty = 0.0f;
+        if (ch.faults & SIM_FAULT_HEATER_STUCK) duty = 1.0f;
+        if (ch.faults & SIM_FAULT_PUMP_DEAD) pump = 0.0f;
+        float leak = (ch.faults & SIM_FAULT_CHAMBER_OPEN) ? OPEN_CHAMBER_LEAK : scenario.leakRate;
+        boardRise += BOARD_HEATER_RISE * duty + BOARD_PUMP_RISE * pump / 100.0f;
+
+        // 步长可能因调度抖动变大，按 1ms 细分积分保证稳定
+        uint32_t steps = (uint32_t)(dt * 1000.0f + 0.5f);
+        if (steps == 0) steps = 1;
+        float h = dt / steps;
+        float padBefore = ch.pad;
+        for (uint32_t k = 0; k < steps; k++) {
+            float flow = (ch.heater - ch.pad) / HEATER_COUPLING;
+            ch.heater += h * (HEATER_GAIN * duty - flow);
+            ch.pad += h * (flow - (ch.pad - scenario.ambient) / scenario.padResistance) / PAD_CAPACITY;
+        }
+
+        float padRate = (ch.pad - padBefore) / dt;
+        float absPressure = PRESSURE_ATM_MMHG - ch.vacuum;
+        float airKelvin = scenario.ambient + PRESSURE_FF_COUPLING * (ch.pad - scenario.ambient) + 273.15f;
+        ch.vacuum += dt * (PRESSURE_PUMP_GAIN * pump - leak * ch.vacuum
+                           - absPressure / airKelvin * PRESSURE_FF_COUPLING * padRate);
+        if (ch.vacuum < 0.0f) ch.vacuum = 0.0f;
+
+        // 传感器输出表压 (kPa)，负压为负值
+        float reading = ch.vacuum;
+        if (ch.faults & SIM_FAULT_PRESSURE_NOISY) {
+            reading += NOISY_PRESSURE_MMHG * (2.0f * rand() / (float)RAND_MAX - 1.0f);
+        }
+        ch.sensor.setReading(-reading / KPA_TO_MMHG + simPlantPressureZero(), board);
+    }
+
+    board += dt * (scenario.ambient + scenario.boardResistance * boardRise - board) / BOARD_TAU_S;
+}
+
+float simPlantBoardTemp() {
+    return board;
+}
+
+float simPlantPressureZero() {
+    return scenario.zeroDrift * (board - SENSOR_ZERO_REF);
+}
+
+SimChannelState simPlantChannel(uint8_t channel) {
+    SimChannelState s = {};
+    if (channel < NUM_CHANNELS) {
+        const ChannelModel& ch = channels[channel];
+        s.heaterTemp = ch.heater;
+        s.padTemp = ch.pad;
+        s.vacuum = ch.vacuum;
+        s.heaterDuty = simLedcDuty(ch.heatPwmChannel) / 255.0f;
+        s.pumpPercent = simLedcDuty(ch.pumpPwmChannel) * 100.0f / 255.0f;
+    }
+    return s;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file SimPlant.h
+ * @brief 被控对象与外设模型：加热片热模型、腔体负压、热电偶SPI、压力传感器I2C、按键
+ *
+ * 热模型（每通道两节点，与 ThermalIdentifier.h 的一阶模型相容）：
+ *   加热丝 H：dH/dt = 60 * duty - (H - S) / 0.25
+ *   加热片 S：60 * dS/dt = (H - S) / 0.25 - (S - Ta) / R
+ * duty 为加热PWM占空比（0-1），S 为热电偶测点，R 为加热片-皮肤热阻（贴合程度）。
+ *
+ * 腔体负压 v（mmHg，低于大气压为正）：
+ *   dv/dt = PRESSURE_PUMP_GAIN * 泵速% - LEAK * v - (P / T) * k * dS/dt
+ * 最后一项为气体定律：腔内气温按比例 k = PRESSURE_FF_COUPLING 跟随加热片（见 PressureController.h）。
+ *
+ * 电路板 B（所有通道共用一块板，热电偶冷端和压力传感器都在板上）：
+ *   60 * dB/dt = Ta + Rb * Σ(12 * duty + 6 * 泵速%/100) - B
+ * 即每通道加热满功率使板温稳态升高 12°C、泵满速升高 6°C，时间常数 60s；
+ * Rb 为壳体散热热阻倍数（1 = 标称）。芯片内部温度 = B + 8°C（自身功耗）。
+ *
+ * 压力传感器零点随板温漂移：读数 = 表压 + Z * (B - 25°C)，Z 为漂移系数（kPa/°C，
+ * 默认0），用于检验零点温漂补偿（见 PressureDriftCompensator.h）。
+ *
+ * 模型运行在最高优先级的仿真任务中（每 SIM_PLANT_PERIOD_MS），
+ * 固件任务只通过引脚、LEDC、I2C 与之交互，与目标板一致。
+ */
+
+#ifndef SIM_PLANT_H
+#define SIM_PLANT_H
+
+#include <stdint.h>
+
+#define SIM_PLANT_PERIOD_MS     10
+#define SIM_MAX_BUTTON_EVENTS   16
+#define SIM_MAX_CHANNELS        4
+#define SIM_MAX_FAULT_WINDOWS   8
+
+/**
+ * @brief 注入的硬件故障（按通道的位掩码，用于检验上电自检的判定阈值）
+ */
+enum SimFault : uint16_t {
+    SIM_FAULT_HEATER_OPEN       = 1u << 0,  // 加热片开路：占空比无效
+    SIM_FAULT_HEATER_STUCK      = 1u << 1,  // 加热开关管短路：始终全功率
+    SIM_FAULT_THERMO_OPEN       = 1u << 2,  // 热电偶开路：芯片报告开路故障
+    SIM_FAULT_THERMO_DETACHED   = 1u << 3,  // 热电偶未贴在加热片上：读数为环境温度
+    SIM_FAULT_PUMP_DEAD         = 1u << 4,  // 泵不转
+    SIM_FAULT_PRESSURE_ABSENT   = 1u << 5,  // 压力传感器无应答
+    SIM_FAULT_PRESSURE_NOISY    = 1u << 6,  // 压力读数噪声大（约 ±4 mmHg）
+    SIM_FAULT_CHAMBER_OPEN      = 1u << 7,  // 腔体未密封（未佩戴或气管脱落）
+};
+
+/**
+ * @brief 限时故障（如传感器短时中断）：从 atMs 起持续 durationMs
+ *
+ * thermo_open / pressure_absent 限时注入时，模型记录中断开始到对应执行器输出清零的时间并打印，
+ * 用于检验输出租约（见 OutputLease.h）。
+ */
+struct SimFaultWindow {
+    uint8_t channel;
+    uint16_t fault;         // SimFault 位掩码
+    uint32_t atMs;
+    uint32_t durationMs;
+};
+
+/**
+ * @brief 按键脚本：在 atMs 按下 pin，保持 holdMs 后松开
+ */
+struct SimButtonEvent {
+    uint8_t pin;
+    uint8_t pin2;           // 组合键的第二个引脚，0xFF 表示无
+    uint32_t atMs;
+    uint32_t holdMs;
+};
+
+/**
+ * @brief 仿真场景参数
+ */
+struct SimScenario {
+    float ambient;          // 环境温度 (°C)
+    float padResistance;    // 加热片-皮肤热阻 R
+    float boardResistance;  // 壳体散热热阻倍数 Rb（1 = 标称，越大板温越高）
+    float leakRate;         // 腔体泄漏率 (1/s)
+    float zeroDrift;        // 压力传感器零点温漂 Z (kPa/°C)
+    SimButtonEvent buttons[SIM_MAX_BUTTON_EVENTS];
+    uint8_t buttonCount;
+    uint16_t faults[SIM_MAX_CHANNELS];  // SimFault 位掩码（从上电起一直存在）
+    SimFaultWindow faultWindows[SIM_MAX_FAULT_WINDOWS];
+    uint8_t faultWindowCount;
+};
+
+/**
+ * @brief 按名称查找故障（heater_open、pump_dead 等），未知名称返回 0
+ */
+uint16_t simFaultFromName(const char* name);
+
+/**
+ * @brief 单通道状态快照
+ */
+struct SimChannelState {
+    float heaterTemp;       // 加热丝 H (°C)
+    float padTemp;          // 加热片 S (°C)
+    float vacuum;           // 腔体负压 (mmHg)
+    float heaterDuty;       // 加热占空比 (0-1)
+    float pumpPercent;      // 泵速 (%)
+};
+
+/**
+ * @brief 初始化模型并挂接引脚钩子和I2C器件（调度器启动前调用）
+ */
+void simPlantBegin(const SimScenario& scenario);
+
+/**
+ * @brief 推进模型（仿真任务周期调用）
+ * @param now_ms 当前时间 (ms)
+ */
+void simPlantStep(uint32_t now_ms);
+
+/**
+ * @brief 通道状态快照
+ */
+SimChannelState simPlantChannel(uint8_t channel);
+
+/**
+ * @brief 板温 B (°C)，芯片内部温度为 B + 8°C
+ */
+float simPlantBoardTemp();
+
+/**
+ * @brief 压力传感器当前的零点偏移 Z * (B - 25°C) (kPa)
+ */
+float simPlantPressureZero();
+
+#endif // SIM_PLANT_H
@@ -0,0 +1,241 @@
+/**
+ * @file SimTrace.cpp
+ * @brief 内核跟踪钩子实现
+ */
+
+#include "SimTrace.h"
+#include "SimHost.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <semphr.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace {
+
+const uint8_t MAX_TASKS = 24;
+const uint8_t MAX_WAIT_STATS = 96;
+
+struct TaskSlot {
+    void* task;
+    void* blockedOn;            // 正在等待的队列/互斥锁，NULL表示未阻塞
+    uint64_t blockStart;        // 开始阻塞的时刻 (µs)
+    bool stallReported;
+    uint32_t inheritCount;      // 作为持有者被提升优先级的次数
+    unsigned maxInherited;      // 被提升到的最高优先级
+};
+
+struct WaitStat {
+    void* task;
+    void* queue;
+    uint32_t takes;             // 成功获取次数
+    uint32_t blocks;            // 其中需要阻塞的次数
+    uint32_t timeouts;          // 超时次数
+    uint64_t totalWaitUs;
+    uint32_t maxWaitUs;
+};
+
+TaskSlot tasks[MAX_TASKS];
+WaitStat waits[MAX_WAIT_STATS];
+uint32_t stallCount = 0;
+uint64_t runTimeOrigin = 0;
+
+TaskSlot* taskSlot(void* task) {
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        if (tasks[i].task == task) {
+            return &tasks[i];
+        }
+        if (tasks[i].task == NULL) {
+            tasks[i].task = task;
+            return &tasks[i];
+        }
+    }
+    return NULL;    // 表满：不统计
+}
+
+WaitStat* waitStat(void* task, void* queue) {
+    for (uint8_t i = 0; i < MAX_WAIT_STATS; i++) {
+        if (waits[i].task == task && waits[i].queue == queue) {
+            return &waits[i];
+        }
+        if (waits[i].task == NULL) {
+            waits[i].task = task;
+            waits[i].queue = queue;
+            return &waits[i];
+        }
+    }
+    return NULL;
+}
+
+// 结束一次获取（成功或超时），返回本次等待时长
+void finishWait(void* queue, bool success) {
+    void* self = xTaskGetCurrentTaskHandle();
+    TaskSlot* slot = taskSlot(self);
+    WaitStat* stat = waitStat(self, queue);
+    if (slot == NULL || stat == NULL) {
+        return;
+    }
+
+    uint32_t waited = 0;
+    if (slot->blockedOn == queue) {
+        waited = (uint32_t)(simMicros64() - slot->blockStart);
+        stat->blocks++;
+        slot->blockedOn = NULL;
+    }
+    if (success) {
+        stat->takes++;
+    } else {
+        stat->timeouts++;
+    }
+    stat->totalWaitUs += waited;
+    if (waited > stat->maxWaitUs) {
+        stat->maxWaitUs = waited;
+    }
+}
+
+bool isMutex(void* queue) {
+    uint8_t type = ucQueueGetQueueType((QueueHandle_t)queue);
+    return type == queueQUEUE_TYPE_MUTEX || type == queueQUEUE_TYPE_RECURSIVE_MUTEX;
+}
+
+const char* objectName(void* queue, char* buf, size_t len) {
+    const char* name = pcQueueGetName((QueueHandle_t)queue);
+    if (name != NULL) {
+        return name;
+    }
+    snprintf(buf, len, "%p", queue);
+    return buf;
+}
+
+} // namespace
+
+extern "C" void simAssertFailed(const char* file, int line) {
+    fprintf(stderr, "[仿真] configASSERT 失败: %s:%d\n", file, line);
+    fflush(stderr);
+    abort();
+}
+
+extern "C" void simRunTimeInit(void) {
+    runTimeOrigin = simMicros64();
+}
+
+extern "C" uint32_t simRunTimeMicros(void) {
+    return (uint32_t)(simMicros64() - runTimeOrigin);
+}
+
+extern "C" void simTraceBlockingOnReceive(void* queue) {
+    TaskSlot* slot = taskSlot(xTaskGetCurrentTaskHandle());
+    if (slot == NULL) {
+        return;
+    }
+    // 被唤醒后没抢到会再次阻塞，等待时长从第一次阻塞算起
+    if (slot->blockedOn != queue) {
+        slot->blockedOn = queue;
+        slot->blockStart = simMicros64();
+        slot->stallReported = false;
+    }
+}
+
+extern "C" void simTraceReceive(void* queue) {
+    finishWait(queue, true);
+}
+
+extern "C" void simTraceReceiveFailed(void* queue) {
+    finishWait(queue, false);
+}
+
+extern "C" void simTracePriorityInherit(void* holder, unsigned priority) {
+    TaskSlot* slot = taskSlot(holder);
+    if (slot == NULL) {
+        return;
+    }
+    slot->inheritCount++;
+    if (priority > slot->maxInherited) {
+        slot->maxInherited = priority;
+    }
+}
+
+uint32_t simTraceCheckStalls(uint32_t threshold_ms) {
+    uint32_t found = 0;
+    uint64_t now = simMicros64();
+
+    taskENTER_CRITICAL();
+    for (uint8_t i = 0; i < MAX_TASKS && tasks[i].task != NULL; i++) {
+        TaskSlot& slot = tasks[i];
+        if (slot.blockedOn == NULL || slot.stallReported || !isMutex(slot.blockedOn)) {
+            continue;   // 队列上长时间等待（事件驱动任务）是正常的
+        }
+        uint32_t waited_ms = (uint32_t)((now - slot.blockStart) / 1000);
+        if (waited_ms < threshold_ms) {
+            continue;
+        }
+        slot.stallReported = true;
+        found++;
+
+        char buf[24];
+        TaskHandle_t holder = xSemaphoreGetMutexHolder((SemaphoreHandle_t)slot.blockedOn);
+        simPrintf("[仿真] 警告：任务 %s 等待互斥锁 %s 已 %lu ms，持有者: %s\n",
+                  pcTaskGetName((TaskHandle_t)slot.task),
+                  objectName(slot.blockedOn, buf, sizeof(buf)),
+                  (unsigned long)waited_ms,
+                  holder != NULL ? pcTaskGetName(holder) : "无");
+    }
+    stallCount += found;
+    taskEXIT_CRITICAL();
+
+    return found;
+}
+
+void simTraceReport() {
+    taskENTER_CRITICAL();
+    simPrintf("\n互斥锁/队列等待统计:\n");
+    simPrintf("  %-12s %-12s %8s %8s %6s %12s %12s\n",
+              "对象", "任务", "获取", "阻塞", "超时", "最长等待ms", "平均等待ms");
+    for (uint8_t i = 0; i < MAX_WAIT_STATS && waits[i].task != NULL; i++) {
+        const WaitStat& w = waits[i];
+        char buf[24];
+        uint32_t n = w.takes + w.timeouts;
+        simPrintf("  %-12s %-12s %8lu %8lu %6lu %12.2f %12.3f\n",
+                  objectName(w.queue, buf, sizeof(buf)),
+                  pcTaskGetName((TaskHandle_t)w.task),
+                  (unsigned long)w.takes, (unsigned long)w.blocks, (unsigned long)w.timeouts,
+                  w.maxWaitUs / 1000.0, n > 0 ? w.totalWaitUs / 1000.0 / n : 0.0);
+    }
+
+    simPrintf("\n优先级继承（互斥锁持有者被提升）:\n");
+    bool any = false;
+    for (uint8_t i = 0; i < MAX_TASKS && tasks[i].task != NULL; i++) {
+        if (tasks[i].inheritCount > 0) {
+            simPrintf("  %-12s %lu 次，最高提升到优先级 %u\n",
+                      pcTaskGetName((TaskHandle_t)tasks[i].task),
+                      (unsigned long)tasks[i].inheritCount, tasks[i].maxInherited);
+            any = true;
+        }
+    }
+    if (!any) {
+        simPrintf("  无\n");
+    }
+    taskEXIT_CRITICAL();
+}
+
+uint32_t simTraceStallCount() {
+    return stallCount;
+}
+
+void simTraceWaitsOn(void* queue, unsigned minPriority, uint32_t* blocks, uint32_t* maxWaitUs) {
+    *blocks = 0;
+    *maxWaitUs = 0;
+    taskENTER_CRITICAL();
+    for (uint8_t i = 0; i < MAX_WAIT_STATS && waits[i].task != NULL; i++) {
+        const WaitStat& w = waits[i];
+        if (w.queue != queue || uxTaskPriorityGet((TaskHandle_t)w.task) < minPriority) {
+            continue;
+        }
+        *blocks += w.blocks;
+        if (w.maxWaitUs > *maxWaitUs) {
+            *maxWaitUs = w.maxWaitUs;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,59 @@
+/**
+ * @file SimTrace.h
+ * @brief 内核跟踪钩子：互斥锁/队列等待时长、优先级继承、长时间阻塞检测
+ *
+ * FreeRTOSConfig.h 把 traceBLOCKING_ON_QUEUE_RECEIVE 等跟踪宏接到这里，
+ * 固件源码不需要任何修改。互斥锁在内核中是队列，获取互斥锁走同一组宏。
+ *
+ * 钩子在内核临界区内、当前任务的线程上执行，只做定长数组的查找和累加，
+ * 不分配内存、不打印。打印由仿真监视任务（SimMain.cpp）完成。
+ */
+
+#ifndef SIM_TRACE_H
+#define SIM_TRACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void simAssertFailed(const char* file, int line);
+
+void simRunTimeInit(void);
+uint32_t simRunTimeMicros(void);
+
+void simTraceBlockingOnReceive(void* queue);
+void simTraceReceive(void* queue);
+void simTraceReceiveFailed(void* queue);
+void simTracePriorityInherit(void* holder, unsigned priority);
+
+#ifdef __cplusplus
+}
+
+/**
+ * @brief 检查是否有任务在互斥锁上阻塞超过阈值（每次阻塞只报告一次）
+ * @param threshold_ms 阈值 (ms)
+ * @return 本次新发现的长时间阻塞数
+ */
+uint32_t simTraceCheckStalls(uint32_t threshold_ms);
+
+/**
+ * @brief 打印等待统计和优先级继承统计
+ */
+void simTraceReport();
+
+/**
+ * @brief 累计发现的长时间阻塞数
+ */
+uint32_t simTraceStallCount();
+
+/**
+ * @brief 汇总优先级不低于 minPriority 的任务在某个互斥锁/队列上的阻塞
+ * @param blocks    阻塞次数
+ * @param maxWaitUs 最长一次等待 (µs)
+ */
+void simTraceWaitsOn(void* queue, unsigned minPriority, uint32_t* blocks, uint32_t* maxWaitUs);
+#endif
+
+#endif // SIM_TRACE_H
@@ -0,0 +1,149 @@
+/**
+ * @file Arduino.h
+ * @brief Arduino-ESP32 API 的主机实现（仅固件用到的部分）
+ *
+ * 时间取自 FreeRTOS 节拍（与目标板一致，millis() 与 vTaskDelay 同一时基）；
+ * 引脚、LEDC 只记录状态，由仿真模型读取（见 SimHost.h）。
+ */
+
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+
+// 与 Arduino-ESP32 一致：Arduino.h 已包含 FreeRTOS
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// 与 super_mini_esp32c3 环境一致：Serial 为 USB Serial/JTAG（HWCDC）
+#define ARDUINO_USB_MODE        1
+#define ARDUINO_USB_CDC_ON_BOOT 1
+
+using std::isnan;
+using std::isinf;
+using std::min;
+using std::max;
+
+#define HIGH            0x1
+#define LOW             0x0
+
+#define INPUT           0x01
+#define OUTPUT          0x03
+#define PULLUP          0x04
+#define INPUT_PULLUP    0x05
+#define PULLDOWN        0x08
+#define INPUT_PULLDOWN  0x09
+
+#define RISING          0x01
+#define FALLING         0x02
+#define CHANGE          0x03
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+typedef uint8_t byte;
+
+// ---- 时间 ----
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+// ---- GPIO ----
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t pin);
+#define digitalPinToInterrupt(p)    (p)
+
+// ---- LEDC ----
+double ledcSetup(uint8_t channel, double freq, uint8_t resolution_bits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcDetachPin(uint8_t pin);
+void ledcWrite(uint8_t channel, uint32_t duty);
+uint32_t ledcRead(uint8_t channel);
+
+// ---- 杂项 ----
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+float temperatureRead();    // 芯片内部温度传感器 (°C)，由仿真模型提供
+
+template <class T, class L, class H>
+inline T constrain(T x, L low, H high) {
+    return x < low ? (T)low : (x > high ? (T)high : x);
+}
+
+// ---- HWCDC 事件（接收回调） ----
+typedef const char* esp_event_base_t;
+typedef void (*esp_event_handler_t)(void* arg, esp_event_base_t base, int32_t id, void* data);
+typedef enum {
+    ARDUINO_HW_CDC_ANY_EVENT = -1,
+    ARDUINO_HW_CDC_CONNECTED_EVENT = 0,
+    ARDUINO_HW_CDC_BUS_RESET_EVENT,
+    ARDUINO_HW_CDC_RX_EVENT,
+    ARDUINO_HW_CDC_TX_EVENT,
+    ARDUINO_HW_CDC_MAX_EVENT
+} arduino_hw_cdc_event_t;
+
+/**
+ * @brief 串口（USB CDC）：写到宿主 stdout；-u 时收发经伪终端（见 SimHost.h）
+ */
+class HardwareSerial {
+public:
+    void begin(unsigned long baud);
+    void end() {}
+    size_t setRxBufferSize(size_t size) { return size; }    // 接收缓冲固定为 SIM_SERIAL_RX_FIFO
+    operator bool() const { return true; }
+
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* data, size_t len);
+    int available();
+    int read();
+    int availableForWrite();
+    void flush();
+    void onEvent(arduino_hw_cdc_event_t event, esp_event_handler_t callback);
+
+    size_t print(const char* s);
+    size_t print(char c);
+    size_t print(int v);
+    size_t print(unsigned int v);
+    size_t print(long v);
+    size_t print(unsigned long v);
+    size_t print(double v, int digits = 2);
+
+    size_t println();
+    size_t println(const char* s);
+    size_t println(char c);
+    size_t println(int v);
+    size_t println(unsigned int v);
+    size_t println(long v);
+    size_t println(unsigned long v);
+    size_t println(double v, int digits = 2);
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HardwareSerial Serial;
+
+/**
+ * @brief 芯片信息
+ */
+class EspClass {
+public:
+    const char* getChipModel() { return "ESP32-C3 (host sim)"; }
+    uint32_t getCpuFreqMHz() { return 160; }
+    uint32_t getFreeHeap() { return 200 * 1024; }
+    void restart();
+};
+
+extern EspClass ESP;
+
+#endif // SIM_ARDUINO_H
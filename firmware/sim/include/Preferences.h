@@ -0,0 +1,45 @@
+/**
+ * @file Preferences.h
+ * @brief NVS（Preferences）的内存实现，进程退出即丢失；-F 时保存到闪存文件的 nvs 分区
+ */
+
+#ifndef SIM_PREFERENCES_H
+#define SIM_PREFERENCES_H
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+    Preferences();
+    ~Preferences();
+
+    bool begin(const char* name, bool readOnly = false, const char* partition_label = NULL);
+    void end();
+
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putUChar(const char* key, uint8_t value);
+    size_t putUShort(const char* key, uint16_t value);
+    size_t putUInt(const char* key, uint32_t value);
+    size_t putFloat(const char* key, float value);
+    size_t putBytes(const char* key, const void* value, size_t len);
+
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0);
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0);
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+    float getFloat(const char* key, float defaultValue = NAN);
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+
+private:
+    char space[16];
+    bool opened;
+    bool readOnly;
+
+    size_t put(const char* key, const void* value, size_t len);
+    size_t get(const char* key, void* buf, size_t len);
+};
+
+#endif // SIM_PREFERENCES_H
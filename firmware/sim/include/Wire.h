@@ -0,0 +1,63 @@
+/**
+ * @file Wire.h
+ * @brief I2C 主机实现：按地址转发到仿真器件（见 SimI2CDevice）
+ */
+
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+#include <Arduino.h>
+
+/**
+ * @brief 仿真I2C器件：寄存器读写接口
+ */
+class SimI2CDevice {
+public:
+    virtual ~SimI2CDevice() {}
+    /**
+     * @brief 写寄存器（reg 后跟 len 字节数据）
+     */
+    virtual void writeRegisters(uint8_t reg, const uint8_t* data, size_t len) = 0;
+    /**
+     * @brief 读单个寄存器（连续读时地址自增）
+     */
+    virtual uint8_t readRegister(uint8_t reg) = 0;
+};
+
+class TwoWire {
+public:
+    static const uint8_t BUFFER_LENGTH = 32;
+
+    TwoWire();
+
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool setClock(uint32_t frequency);
+
+    void beginTransmission(uint16_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t* data, size_t len);
+    uint8_t endTransmission(bool sendStop = true);
+
+    uint8_t requestFrom(uint16_t address, uint8_t len, bool sendStop = true);
+    int available();
+    int read();
+
+    /**
+     * @brief 挂接仿真器件（仿真模型调用），device=NULL 表示移除
+     */
+    void attach(uint8_t address, SimI2CDevice* device);
+
+private:
+    SimI2CDevice* devices[128];
+    uint8_t txAddress;
+    uint8_t txBuffer[BUFFER_LENGTH];
+    size_t txLength;
+    uint8_t regPointer;
+    uint8_t rxBuffer[BUFFER_LENGTH];
+    size_t rxLength;
+    size_t rxIndex;
+};
+
+extern TwoWire Wire;
+
+#endif // SIM_WIRE_H
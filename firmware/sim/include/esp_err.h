@@ -0,0 +1,21 @@
+/**
+ * @file esp_err.h
+ * @brief ESP-IDF 错误码（主机仿真用到的部分）
+ */
+
+#ifndef SIM_ESP_ERR_H
+#define SIM_ESP_ERR_H
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK                  0
+#define ESP_FAIL                -1
+#define ESP_ERR_INVALID_ARG     0x102
+#define ESP_ERR_INVALID_SIZE    0x104
+#define ESP_ERR_NOT_FOUND       0x105
+
+const char* esp_err_to_name(esp_err_t code);
+
+#endif // SIM_ESP_ERR_H
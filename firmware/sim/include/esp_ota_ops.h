@@ -0,0 +1,19 @@
+/**
+ * @file esp_ota_ops.h
+ * @brief ESP-IDF OTA 分区选择的主机实现
+ *
+ * 启动分区记录在 otadata 分区；esp_ota_get_running_partition() 是进程启动时的启动分区。
+ * 与目标板不同，esp_ota_set_boot_partition() 不检查镜像格式（仿真的镜像是任意数据）。
+ */
+
+#ifndef SIM_ESP_OTA_OPS_H
+#define SIM_ESP_OTA_OPS_H
+
+#include "esp_partition.h"
+
+const esp_partition_t* esp_ota_get_running_partition(void);
+const esp_partition_t* esp_ota_get_boot_partition(void);
+const esp_partition_t* esp_ota_get_next_update_partition(const esp_partition_t* start_from);
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t* partition);
+
+#endif // SIM_ESP_OTA_OPS_H
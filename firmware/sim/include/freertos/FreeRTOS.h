@@ -0,0 +1,11 @@
+/**
+ * @file FreeRTOS.h
+ * @brief ESP-IDF 风格的包含路径（freertos/FreeRTOS.h）转发到内核头文件
+ */
+
+#ifndef SIM_FREERTOS_FREERTOS_H
+#define SIM_FREERTOS_FREERTOS_H
+
+#include <FreeRTOS.h>
+
+#endif // SIM_FREERTOS_FREERTOS_H
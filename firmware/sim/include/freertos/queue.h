@@ -0,0 +1,12 @@
+/**
+ * @file queue.h
+ * @brief ESP-IDF 风格的包含路径转发
+ */
+
+#ifndef SIM_FREERTOS_QUEUE_H
+#define SIM_FREERTOS_QUEUE_H
+
+#include "freertos/FreeRTOS.h"
+#include <queue.h>
+
+#endif // SIM_FREERTOS_QUEUE_H
@@ -0,0 +1,12 @@
+/**
+ * @file semphr.h
+ * @brief ESP-IDF 风格的包含路径转发
+ */
+
+#ifndef SIM_FREERTOS_SEMPHR_H
+#define SIM_FREERTOS_SEMPHR_H
+
+#include "freertos/FreeRTOS.h"
+#include <semphr.h>
+
+#endif // SIM_FREERTOS_SEMPHR_H
@@ -0,0 +1,38 @@
+/**
+ * @file task.h
+ * @brief ESP-IDF 风格的包含路径转发 + ESP-IDF 任务扩展
+ *
+ * ESP-IDF 的任务栈深度以字节为单位，原版 FreeRTOS 以字（StackType_t）为单位。
+ * 宿主线程上的 glibc 比 newlib 用栈多得多，统一放大到 SIM_TASK_STACK_WORDS，
+ * 栈大小是否够用只能在目标板上用 uxTaskGetStackHighWaterMark() 确认。
+ */
+
+#ifndef SIM_FREERTOS_TASK_H
+#define SIM_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+#include <task.h>
+
+#ifndef SIM_TASK_STACK_WORDS
+#define SIM_TASK_STACK_WORDS    ( 64 * 1024 / sizeof( StackType_t ) )
+#endif
+
+#define tskNO_AFFINITY          0x7FFFFFFF
+
+/**
+ * @brief ESP-IDF: 创建任务并绑定到核（ESP32-C3 单核，绑核参数被忽略，与目标板一致）
+ */
+static inline BaseType_t xTaskCreatePinnedToCore( TaskFunction_t pxTaskCode,
+                                                  const char * const pcName,
+                                                  const uint32_t usStackDepthBytes,
+                                                  void * const pvParameters,
+                                                  UBaseType_t uxPriority,
+                                                  TaskHandle_t * const pxCreatedTask,
+                                                  const BaseType_t xCoreID )
+{
+    ( void ) usStackDepthBytes;
+    ( void ) xCoreID;
+    return xTaskCreate( pxTaskCode, pcName, SIM_TASK_STACK_WORDS, pvParameters, uxPriority, pxCreatedTask );
+}
+
+#endif // SIM_FREERTOS_TASK_H
@@ -0,0 +1,12 @@
+/**
+ * @file timers.h
+ * @brief ESP-IDF 风格的包含路径转发
+ */
+
+#ifndef SIM_FREERTOS_TIMERS_H
+#define SIM_FREERTOS_TIMERS_H
+
+#include "freertos/FreeRTOS.h"
+#include <timers.h>
+
+#endif // SIM_FREERTOS_TIMERS_H
@@ -0,0 +1,90 @@
+# 运行一个仿真场景并检查输出（ctest 调用，见 ../CMakeLists.txt）
+#
+#   cmake -DSCENARIO=two_channel_runaway.scn -DSIM_DIR=build-sim -P run_scenario.cmake
+#
+# 场景文件每行一个指令，# 开头为注释：
+#   sim 程序            仿真程序（默认 glasses_sim）
+#   args 选项...        命令行选项
+#   exit 码             期望的退出码（默认 0）
+#   expect 正则         输出中必须出现
+#   reject 正则         输出中不能出现
+#   final 正则          仿真报告（"仿真报告"之后，含各通道最终状态）中必须出现
+# 正则为 CMake 语法（不支持 \d，用 [0-9]）。
+
+cmake_minimum_required(VERSION 3.16)
+
+if(NOT SCENARIO OR NOT SIM_DIR)
+    message(FATAL_ERROR "需要 -DSCENARIO=场景文件 -DSIM_DIR=仿真程序目录")
+endif()
+
+set(program glasses_sim)
+set(args)
+set(expected_exit 0)
+set(expects)
+set(rejects)
+set(finals)
+
+file(STRINGS ${SCENARIO} lines ENCODING UTF-8)
+foreach(line IN LISTS lines)
+    if(line MATCHES "^[ \t]*(#|$)")
+        continue()
+    endif()
+    if(NOT line MATCHES "^([a-z]+)[ \t]+(.*)$")
+        message(FATAL_ERROR "无法解析: ${line}")
+    endif()
+    set(key ${CMAKE_MATCH_1})
+    set(value "${CMAKE_MATCH_2}")
+    if(key STREQUAL "sim")
+        set(program ${value})
+    elseif(key STREQUAL "args")
+        separate_arguments(args UNIX_COMMAND "${value}")
+    elseif(key STREQUAL "exit")
+        set(expected_exit ${value})
+    elseif(key STREQUAL "expect")
+        list(APPEND expects "${value}")
+    elseif(key STREQUAL "reject")
+        list(APPEND rejects "${value}")
+    elseif(key STREQUAL "final")
+        list(APPEND finals "${value}")
+    else()
+        message(FATAL_ERROR "未知指令 ${key}: ${line}")
+    endif()
+endforeach()
+
+execute_process(COMMAND ${SIM_DIR}/${program} ${args}
+                OUTPUT_VARIABLE output ERROR_VARIABLE errors RESULT_VARIABLE result)
+message("${output}${errors}")
+
+set(failures 0)
+if(NOT "${result}" STREQUAL "${expected_exit}")
+    message("✗ 退出码 ${result}，期望 ${expected_exit}")
+    math(EXPR failures "${failures} + 1")
+endif()
+foreach(re IN LISTS expects)
+    if(NOT output MATCHES "${re}")
+        message("✗ 没有出现: ${re}")
+        math(EXPR failures "${failures} + 1")
+    endif()
+endforeach()
+foreach(re IN LISTS rejects)
+    if(output MATCHES "${re}")
+        message("✗ 不应出现: ${re}（${CMAKE_MATCH_0}）")
+        math(EXPR failures "${failures} + 1")
+    endif()
+endforeach()
+string(FIND "${output}" "仿真报告" reportAt)
+if(reportAt LESS 0)
+    set(report "")
+else()
+    string(SUBSTRING "${output}" ${reportAt} -1 report)
+endif()
+foreach(re IN LISTS finals)
+    if(NOT report MATCHES "${re}")
+        message("✗ 仿真报告中没有: ${re}")
+        math(EXPR failures "${failures} + 1")
+    endif()
+endforeach()
+
+if(failures GREATER 0)
+    message(FATAL_ERROR "${SCENARIO}: ${failures} 项检查失败")
+endif()
@@ -0,0 +1,54 @@
+/**
+ * @file BoardDerating.cpp
+ * @brief 板温降额实现
+ */
+
+#include "BoardDerating.h"
+
+BoardDerating::BoardDerating()
+    : mcuFiltered(NAN), boardFiltered(NAN), derateLevel(0.0f), overLimit(false),
+      heaterMax(255), pumpMax(100) {
+}
+
+void BoardDerating::filter(float& state, float sample) {
+    if (isnan(sample)) {
+        state = NAN;    // 读不到时不沿用旧值
+    } else if (isnan(state)) {
+        state = sample;
+    } else {
+        state += DERATE_FILTER_ALPHA * (sample - state);
+    }
+}
+
+float BoardDerating::ramp(float temp, float start, float full) {
+    if (isnan(temp) || temp <= start) return 0.0f;
+    if (temp >= full) return 1.0f;
+    return (temp - start) / (full - start);
+}
+
+bool BoardDerating::update(float mcu_temp, float board_temp) {
+    filter(mcuFiltered, mcu_temp);
+    filter(boardFiltered, board_temp);
+
+    float mcuLevel = ramp(mcuFiltered, DERATE_MCU_START, DERATE_MCU_FULL);
+    float boardLevel = ramp(boardFiltered, DERATE_BOARD_START, DERATE_BOARD_FULL);
+    derateLevel = mcuLevel > boardLevel ? mcuLevel : boardLevel;
+
+    // 硬限值带回差：NAN 比较为 false，读不到的温度不触发也不阻止解除
+    bool wasOver = overLimit;
+    if (mcuFiltered >= DERATE_MCU_LIMIT || boardFiltered >= DERATE_BOARD_LIMIT) {
+        overLimit = true;
+    } else if (!(mcuFiltered >= DERATE_MCU_LIMIT - DERATE_RECOVER_MARGIN)
+               && !(boardFiltered >= DERATE_BOARD_LIMIT - DERATE_RECOVER_MARGIN)) {
+        overLimit = false;
+    }
+
+    if (overLimit) {
+        heaterMax = 0;
+        pumpMax = 0;
+    } else {
+        heaterMax = (uint8_t)(255.0f * (1.0f - derateLevel * (1.0f - DERATE_HEATER_MIN)) + 0.5f);
+        pumpMax = (uint8_t)(100.0f * (1.0f - derateLevel * (1.0f - DERATE_PUMP_MIN)) + 0.5f);
+    }
+    return overLimit != wasOver;
+}
@@ -5,6 +5,17 @@
 
 #include "Button.h"
 
+#if defined(ARDUINO_ARCH_ESP32)
+#include "driver/gpio.h"
+
+static bool isrServiceInstalled = false;
+
+// GPIO中断服务的处理函数带参数，按键的处理函数不带：参数即处理函数
+static void IRAM_ATTR buttonEdgeTrampoline(void* arg) {
+    ((void (*)())arg)();
+}
+#endif
+
 Button::Button(uint8_t pin, bool pull_up)
     : buttonPin(pin), pullUp(pull_up), currentState(false), lastState(false),
       pressed(false), released(false), pressedTime(0), lastDebounceTime(0) {
@@ -48,6 +59,30 @@ void Button::update() {
     lastState = reading;
 }
 
+bool Button::attachEdgeInterrupt(void (*isr)()) {
+#if defined(ARDUINO_ARCH_ESP32)
+    if (!isrServiceInstalled) {
+        // ESP_ERR_INVALID_STATE：服务已被别处安装，不知道是否为IRAM中断，按失败处理
+        if (gpio_install_isr_service(ESP_INTR_FLAG_IRAM) != ESP_OK) {
+            return false;
+        }
+        isrServiceInstalled = true;
+    }
+    gpio_num_t pin = (gpio_num_t)buttonPin;
+    return gpio_set_intr_type(pin, GPIO_INTR_ANYEDGE) == ESP_OK
+           && gpio_isr_handler_add(pin, buttonEdgeTrampoline, (void*)isr) == ESP_OK
+           && gpio_intr_enable(pin) == ESP_OK;
+#else
+    // 主机仿真：没有闪存缓存，attachInterrupt() 直接在引脚变化时调用
+    attachInterrupt(digitalPinToInterrupt(buttonPin), isr, CHANGE);
+    return true;
+#endif
+}
+
+bool Button::isIdle() const {
+    return !currentState && !lastState;
+}
+
 bool Button::wasPressed() {
     if (pressed) {
         pressed = false;
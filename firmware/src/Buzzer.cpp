@@ -5,8 +5,23 @@
 
 #include "Buzzer.h"
 
+const Buzzer::Note Buzzer::BEEP_NOTES[] = {
+    { 2731, 100 },
+};
+
+const Buzzer::Note Buzzer::WARNING_NOTES[] = {
+    { 2731, 200 }, { 0, 100 },
+    { 2731, 200 }, { 0, 100 },
+    { 2731, 200 }, { 0, 100 },
+};
+
+const Buzzer::Note Buzzer::ERROR_NOTES[] = {
+    { 2000, 1000 },
+};
+
 Buzzer::Buzzer(uint8_t pin, uint8_t pwm_channel)
-    : buzzerPin(pin), pwmChannel(pwm_channel) {
+    : buzzerPin(pin), pwmChannel(pwm_channel), timer(NULL), single{0, 0},
+      pattern(NULL), patternLength(0), noteIndex(0), noteStart(0) {
 }
 
 void Buzzer::begin() {
@@ -14,34 +29,87 @@ void Buzzer::begin() {
     ledcSetup(pwmChannel, 2731, 8); // HY9055谐振频率2731Hz
     ledcAttachPin(buzzerPin, pwmChannel);
     ledcWrite(pwmChannel, 0);
+    timer = xTimerCreate("Buzzer", 1, pdFALSE, this, onTimer);
     Serial.println("Buzzer Init Success");
 }
 
 void Buzzer::tone(uint16_t frequency, uint32_t duration) {
-    ledcSetup(pwmChannel, frequency, 8);
-    ledcWrite(pwmChannel, 128); // 50%占空比
-    
-    if (duration > 0) {
-        delay(duration);
-        noTone();
-    }
+    single = Note{frequency, (uint16_t)(duration < 0xFFFF ? duration : 0xFFFF)};
+    play(&single, 1);
 }
 
 void Buzzer::noTone() {
+    vTaskSuspendAll();
+    pattern = NULL;
     ledcWrite(pwmChannel, 0);
+    xTaskResumeAll();
+    if (timer != NULL) {
+        xTimerStop(timer, 0);
+    }
 }
 
 void Buzzer::beep() {
-    tone(2731, 100);
+    play(BEEP_NOTES, sizeof(BEEP_NOTES) / sizeof(BEEP_NOTES[0]));
 }
 
 void Buzzer::warning() {
-    for (int i = 0; i < 3; i++) {
-        tone(2731, 200);
-        delay(100);
-    }
+    play(WARNING_NOTES, sizeof(WARNING_NOTES) / sizeof(WARNING_NOTES[0]));
 }
 
 void Buzzer::error() {
-    tone(2000, 1000);
+    play(ERROR_NOTES, sizeof(ERROR_NOTES) / sizeof(ERROR_NOTES[0]));
+}
+
+void Buzzer::play(const Note* notes, uint8_t count) {
+    // 挂起调度器：换音型与定时器回调的换音符不交错
+    vTaskSuspendAll();
+    pattern = notes;
+    patternLength = count;
+    noteIndex = 0;
+    startNote();
+    xTaskResumeAll();
+    if (timer == NULL) {
+        return;
+    }
+    if (notes[0].durationMs > 0) {
+        xTimerChangePeriod(timer, pdMS_TO_TICKS(notes[0].durationMs), 0);
+    } else {
+        xTimerStop(timer, 0);
+    }
+}
+
+void Buzzer::startNote() {
+    const Note& n = pattern[noteIndex];
+    if (n.frequency > 0) {
+        ledcSetup(pwmChannel, n.frequency, 8);
+        ledcWrite(pwmChannel, 128); // 50%占空比
+    } else {
+        ledcWrite(pwmChannel, 0);
+    }
+    noteStart = millis();
+}
+
+void Buzzer::onTimer(TimerHandle_t timer) {
+    static_cast<Buzzer*>(pvTimerGetTimerID(timer))->step();
+}
+
+void Buzzer::step() {
+    uint16_t next = 0;
+    vTaskSuspendAll();
+    // 音符没放完的到期是被新音型打断前排队的，忽略（新音型已重新设置定时器）
+    if (pattern != NULL && pattern[noteIndex].durationMs > 0
+            && millis() - noteStart + 1 >= pattern[noteIndex].durationMs) {
+        noteIndex++;
+        if (noteIndex < patternLength) {
+            startNote();
+            next = pattern[noteIndex].durationMs;
+        } else {
+            pattern = NULL;
+            ledcWrite(pwmChannel, 0);
+        }
+    }
+    xTaskResumeAll();
+    if (next > 0) {
+        xTimerChangePeriod(timer, pdMS_TO_TICKS(next), 0);
+    }
 }
@@ -0,0 +1,33 @@
+/**
+ * @file CPS610Sensor.cpp
+ * @brief CPS610DSD003DH01 压力传感器实现
+ * 
+ * 通信协议:
+ * 1. 向0x30寄存器写入0x0A触发采集
+ * 2. 等待5-10ms（或轮询0x30直到变为0x02）
+ * 3. 从0x06-0x08读取24位数据
+ * 4. 转换公式: P(kPa) = 7.5 * (raw/8388608) - 3.75
+ */
+
+#include "CPS610Sensor.h"
+
+CPS610Sensor::CPS610Sensor(uint8_t sda_pin, uint8_t scl_pin, uint8_t i2c_addr)
+    : PressureSensorBase<CPS610Sensor>(sda_pin, scl_pin, i2c_addr ? i2c_addr : DEFAULT_ADDR) {
+}
+
+int32_t CPS610Sensor::readRaw24bit() {
+    int32_t raw24;
+    if (!fetchRaw(raw24)) {
+        Serial.println("X Failed to read raw data");
+        return 0x7FFFFFFF; // 错误标记
+    }
+    return raw24;
+}
+
+float CPS610Sensor::convertToPressure(int32_t raw24) const {
+    // CPS610DSD003DH01 转换公式:
+    // Code = raw24 / 8388608.0
+    // P(kPa) = 7.5 * Code - 3.75
+    float code = (float)raw24 / DIVISOR;
+    return COEF_A * code + COEF_B;
+}
@@ -0,0 +1,209 @@
+/**
+ * @file DeltaPatch.cpp
+ * @brief 固件差分格式与流式应用实现
+ */
+
+#include "DeltaPatch.h"
+#include "LinkFrame.h"
+#include <string.h>
+
+enum ApplierStage : uint8_t {
+    STAGE_OP = 0,       // 等待操作码
+    STAGE_ARG,          // 读取 varint 参数
+    STAGE_COPY,
+    STAGE_LITERAL
+};
+
+size_t deltaHeaderEncode(const DeltaHeader& h, uint8_t* out) {
+    linkPut32(out, DELTA_MAGIC);
+    out[4] = DELTA_VERSION;
+    out[5] = out[6] = out[7] = 0;
+    linkPut32(out + 8, h.sourceSize);
+    memcpy(out + 12, h.sourceSha, SHA256_DIGEST_LEN);
+    linkPut32(out + 44, h.targetSize);
+    memcpy(out + 48, h.targetSha, SHA256_DIGEST_LEN);
+    linkPut32(out + 80, h.deltaSize);
+    return DELTA_HEADER_LEN;
+}
+
+bool deltaHeaderDecode(const uint8_t* in, size_t len, DeltaHeader& h) {
+    if (len != DELTA_HEADER_LEN || linkGet32(in) != DELTA_MAGIC || in[4] != DELTA_VERSION) {
+        return false;
+    }
+    h.sourceSize = linkGet32(in + 8);
+    memcpy(h.sourceSha, in + 12, SHA256_DIGEST_LEN);
+    h.targetSize = linkGet32(in + 44);
+    memcpy(h.targetSha, in + 48, SHA256_DIGEST_LEN);
+    h.deltaSize = linkGet32(in + 80);
+    return true;
+}
+
+size_t deltaPutVarint(uint8_t* out, uint32_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+DeltaApplier::DeltaApplier() : sourceSize(0), targetSize(0), deltaSize(0), st(), err(DELTA_OK) {
+}
+
+void DeltaApplier::begin(const DeltaHeader& header) {
+    DeltaApplierState fresh = {};
+    restore(header, fresh);
+}
+
+void DeltaApplier::restore(const DeltaHeader& header, const DeltaApplierState& saved) {
+    sourceSize = header.sourceSize;
+    targetSize = header.targetSize;
+    deltaSize = header.deltaSize;
+    st = saved;
+    err = DELTA_OK;
+}
+
+bool DeltaApplier::done() const {
+    return err == DELTA_OK && st.stage == STAGE_OP && st.inputPos == deltaSize && st.outputPos == targetSize;
+}
+
+// 参数读齐后检查范围，进入复制/字面量阶段
+bool DeltaApplier::startOp() {
+    if (st.op == DELTA_OP_COPY) {
+        int64_t src = (int64_t)st.copyEnd + deltaUnzigzag(st.args[0]);
+        uint32_t len = st.args[1];
+        if (src < 0 || (uint64_t)src + len > sourceSize) {
+            return fail(DELTA_ERR_SOURCE_RANGE);
+        }
+        if ((uint64_t)st.outputPos + len > targetSize) {
+            return fail(DELTA_ERR_TARGET_OVERFLOW);
+        }
+        st.srcPos = (uint32_t)src;
+        st.copyEnd = (uint32_t)src + len;
+        st.remaining = len;
+        st.stage = len > 0 ? STAGE_COPY : STAGE_OP;
+    } else {
+        uint32_t len = st.args[0];
+        if ((uint64_t)st.outputPos + len > targetSize) {
+            return fail(DELTA_ERR_TARGET_OVERFLOW);
+        }
+        st.remaining = len;
+        st.stage = len > 0 ? STAGE_LITERAL : STAGE_OP;
+    }
+    return true;
+}
+
+bool DeltaApplier::step(const uint8_t* in, size_t len, size_t& consumed,
+                        uint8_t* out, size_t outCap, size_t& produced,
+                        DeltaSourceReader read, void* ctx) {
+    consumed = 0;
+    produced = 0;
+    if (err != DELTA_OK) {
+        return false;
+    }
+    if (len > deltaSize - st.inputPos) {
+        return fail(DELTA_ERR_INPUT_OVERFLOW);
+    }
+
+    for (;;) {
+        switch (st.stage) {
+            case STAGE_OP: {
+                if (consumed == len) {
+                    return true;
+                }
+                uint8_t op = in[consumed++];
+                st.inputPos++;
+                if (op != DELTA_OP_COPY && op != DELTA_OP_LITERAL) {
+                    return fail(DELTA_ERR_BAD_OP);
+                }
+                st.op = op;
+                st.argIndex = 0;
+                st.arg = 0;
+                st.shift = 0;
+                st.stage = STAGE_ARG;
+                break;
+            }
+
+            case STAGE_ARG: {
+                if (consumed == len) {
+                    return true;
+                }
+                uint8_t b = in[consumed++];
+                st.inputPos++;
+                if (st.shift > 28) {
+                    return fail(DELTA_ERR_VARINT);
+                }
+                st.arg |= (uint32_t)(b & 0x7F) << st.shift;
+                st.shift += 7;
+                if (b & 0x80) {
+                    break;
+                }
+                st.args[st.argIndex++] = st.arg;
+                st.arg = 0;
+                st.shift = 0;
+                if (st.argIndex == (st.op == DELTA_OP_COPY ? 2 : 1) && !startOp()) {
+                    return false;
+                }
+                break;
+            }
+
+            case STAGE_COPY: {
+                size_t n = outCap - produced;
+                if (n == 0) {
+                    return true;
+                }
+                if (n > st.remaining) {
+                    n = st.remaining;
+                }
+                if (!read(ctx, st.srcPos, out + produced, n)) {
+                    return fail(DELTA_ERR_SOURCE_READ);
+                }
+                produced += n;
+                st.srcPos += (uint32_t)n;
+                st.outputPos += (uint32_t)n;
+                st.remaining -= (uint32_t)n;
+                if (st.remaining == 0) {
+                    st.stage = STAGE_OP;
+                }
+                break;
+            }
+
+            case STAGE_LITERAL: {
+                size_t n = outCap - produced;
+                if (n == 0 || consumed == len) {
+                    return true;
+                }
+                if (n > st.remaining) {
+                    n = st.remaining;
+                }
+                if (n > len - consumed) {
+                    n = len - consumed;
+                }
+                memcpy(out + produced, in + consumed, n);
+                consumed += n;
+                produced += n;
+                st.inputPos += (uint32_t)n;
+                st.outputPos += (uint32_t)n;
+                st.remaining -= (uint32_t)n;
+                if (st.remaining == 0) {
+                    st.stage = STAGE_OP;
+                }
+                break;
+            }
+        }
+    }
+}
+
+const char* DeltaApplier::errorName(DeltaError e) {
+    switch (e) {
+        case DELTA_OK:                  return "OK";
+        case DELTA_ERR_BAD_OP:          return "未知操作码";
+        case DELTA_ERR_VARINT:          return "varint 过长";
+        case DELTA_ERR_SOURCE_RANGE:    return "复制超出源镜像";
+        case DELTA_ERR_TARGET_OVERFLOW: return "输出超过新镜像大小";
+        case DELTA_ERR_INPUT_OVERFLOW:  return "输入超过差分长度";
+        case DELTA_ERR_SOURCE_READ:     return "读源镜像失败";
+    }
+    return "?";
+}
@@ -0,0 +1,70 @@
+/**
+ * @file EmergencyStop.cpp
+ * @brief 急停快速路径实现
+ */
+
+#include "EmergencyStop.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include "hal/gpio_ll.h"
+#include "esp_rom_gpio.h"
+#include "soc/gpio_sig_map.h"
+#endif
+
+EmergencyStop::EmergencyStop(uint8_t stop_pin)
+    : stopPin(stop_pin), outputCount(0), pending(false), cut(false), tripCount(0) {
+}
+
+bool EmergencyStop::addOutput(uint8_t pin, uint8_t pwm_channel) {
+    if (outputCount >= MAX_OUTPUTS) {
+        return false;
+    }
+    outputs[outputCount].pin = pin;
+    outputs[outputCount].pwmChannel = pwm_channel;
+    outputCount++;
+    return true;
+}
+
+bool IRAM_ATTR EmergencyStop::trip() {
+#if defined(ARDUINO_ARCH_ESP32)
+    // digitalRead()/ledcWrite() 在闪存中，这里直接操作GPIO寄存器和ROM中的GPIO矩阵
+    if (gpio_ll_get_level(&GPIO, (gpio_num_t)stopPin) != 0) {
+        return false;   // 松开边沿
+    }
+    for (uint8_t i = 0; i < outputCount; i++) {
+        // 先把GPIO输出寄存器清零再切换信号源，切换瞬间不会输出高电平
+        gpio_ll_set_level(&GPIO, (gpio_num_t)outputs[i].pin, 0);
+        esp_rom_gpio_connect_out_signal(outputs[i].pin, SIG_GPIO_OUT_IDX, false, false);
+    }
+#else
+    // 主机仿真：LEDC只记录占空比，直接清零
+    if (digitalRead(stopPin) != LOW) {
+        return false;
+    }
+    for (uint8_t i = 0; i < outputCount; i++) {
+        ledcWrite(outputs[i].pwmChannel, 0);
+    }
+#endif
+    cut = true;
+    pending = true;
+    tripCount = tripCount + 1;
+    return true;
+}
+
+bool EmergencyStop::takePending() {
+    if (!pending) {
+        return false;
+    }
+    pending = false;    // 清除前中断再次触发也无妨：急停已锁存
+    return true;
+}
+
+void EmergencyStop::rearm() {
+    if (!cut) {
+        return;
+    }
+    for (uint8_t i = 0; i < outputCount; i++) {
+        ledcAttachPin(outputs[i].pin, outputs[i].pwmChannel);
+    }
+    cut = false;
+}
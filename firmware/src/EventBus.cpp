@@ -0,0 +1,185 @@
+/**
+ * @file EventBus.cpp
+ * @brief 静态事件总线实现
+ */
+
+#include "EventBus.h"
+
+namespace {
+
+constexpr bool everyTopicRouted() {
+    for (uint8_t t = 0; t < BUS_TOPIC_COUNT; t++) {
+        if (BUS_ROUTES[t] == 0) return false;
+    }
+    return true;
+}
+
+constexpr bool routesInRange() {
+    for (uint8_t t = 0; t < BUS_TOPIC_COUNT; t++) {
+        if (BUS_ROUTES[t] >> BUS_SUBSCRIBER_COUNT) return false;
+    }
+    return true;
+}
+
+static_assert(sizeof(BUS_ROUTES) / sizeof(BUS_ROUTES[0]) == BUS_TOPIC_COUNT, "one route per topic");
+static_assert(everyTopicRouted(), "every topic needs at least one subscriber");
+static_assert(routesInRange(), "route refers to an unknown subscriber");
+static_assert(BUS_SUBSCRIBER_COUNT <= 8, "subscriber bitmap is 8 bits");
+static_assert(BUS_POOL_SIZE > 0 && BUS_POOL_SIZE <= 127, "slot index is int8_t");
+static_assert(BUS_MAILBOX_LEN > 0 && BUS_MAILBOX_LEN <= 255, "mailbox index is uint8_t");
+
+} // namespace
+
+EventBus::EventBus() {
+    for (uint8_t i = 0; i < BUS_POOL_SIZE; i++) {
+        refs[i] = 0;
+    }
+    for (uint8_t s = 0; s < BUS_SUBSCRIBER_COUNT; s++) {
+        mailboxes[s].head = 0;
+        mailboxes[s].count = 0;
+        tasks[s] = NULL;
+    }
+    for (uint8_t t = 0; t < BUS_TOPIC_COUNT; t++) {
+        topicStats[t] = BusTopicStats{0, 0, 0, 0, 0};
+    }
+}
+
+void EventBus::attach(BusSubscriber sub, TaskHandle_t task) {
+    tasks[sub] = task;
+}
+
+int8_t EventBus::allocate() {
+    for (uint8_t i = 0; i < BUS_POOL_SIZE; i++) {
+        if (refs[i] == 0) {
+            return (int8_t)i;
+        }
+    }
+    return -1;
+}
+
+bool EventBus::enqueue(Mailbox& box, uint8_t slot, bool urgent) {
+    if (box.count >= BUS_MAILBOX_LEN) {
+        return false;
+    }
+    if (urgent) {
+        box.head = (uint8_t)((box.head + BUS_MAILBOX_LEN - 1) % BUS_MAILBOX_LEN);
+        box.slots[box.head] = slot;
+    } else {
+        box.slots[(box.head + box.count) % BUS_MAILBOX_LEN] = slot;
+    }
+    box.count++;
+    return true;
+}
+
+bool EventBus::publish(const BusEvent& event, bool urgent) {
+    uint32_t posted = micros();
+    uint8_t routes = BUS_ROUTES[event.topic];
+    TaskHandle_t wake[BUS_SUBSCRIBER_COUNT];
+    uint8_t wakeCount = 0;
+    BusTopicStats& st = topicStats[event.topic];
+
+    vTaskSuspendAll();
+    int8_t slot = allocate();
+    if (slot < 0) {
+        st.dropped++;
+        xTaskResumeAll();
+        return false;
+    }
+    pool[slot] = event;
+    pool[slot].postedUs = posted;
+
+    uint8_t delivered = 0;
+    for (uint8_t s = 0; s < BUS_SUBSCRIBER_COUNT; s++) {
+        if (!(routes & BUS_SUB(s))) {
+            continue;
+        }
+        if (!enqueue(mailboxes[s], (uint8_t)slot, urgent)) {
+            st.dropped++;
+            continue;
+        }
+        delivered++;
+        if (tasks[s] != NULL) {
+            wake[wakeCount++] = tasks[s];
+        }
+    }
+    refs[slot] = delivered;     // 0：槽位保持空闲
+    xTaskResumeAll();
+
+    for (uint8_t i = 0; i < wakeCount; i++) {
+        xTaskNotify(wake[i], BUS_NOTIFY_EVENT, eSetBits);
+    }
+    return delivered > 0;
+}
+
+uint32_t EventBus::wait(BusSubscriber sub, TickType_t timeout) {
+    // 通知在发布时先于等待到达也不会丢：通知值保留到下一次 xTaskNotifyWait
+    if (mailboxes[sub].count > 0) {
+        return BUS_NOTIFY_EVENT;
+    }
+    uint32_t bits = 0;
+    if (xTaskNotifyWait(0, 0xFFFFFFFFu, &bits, timeout) != pdTRUE) {
+        return 0;
+    }
+    return bits;
+}
+
+const BusEvent* EventBus::take(BusSubscriber sub) {
+    Mailbox& box = mailboxes[sub];
+    vTaskSuspendAll();
+    if (box.count == 0) {
+        xTaskResumeAll();
+        return NULL;
+    }
+    uint8_t slot = box.slots[box.head];
+    box.head = (uint8_t)((box.head + 1) % BUS_MAILBOX_LEN);
+    box.count--;
+    xTaskResumeAll();
+
+    const BusEvent* ev = &pool[slot];
+    uint32_t latency = micros() - ev->postedUs;
+    BusTopicStats& st = topicStats[ev->topic];
+    vTaskSuspendAll();
+    st.delivered++;
+    st.totalLatencyUs += latency;
+    if (latency > st.maxLatencyUs) {
+        st.maxLatencyUs = latency;
+    }
+    if (latency > BUS_LATENCY_BUDGET_US) {
+        st.overBudget++;
+    }
+    xTaskResumeAll();
+    return ev;
+}
+
+void EventBus::release(const BusEvent* event) {
+    uint8_t slot = (uint8_t)(event - pool);
+    vTaskSuspendAll();
+    if (refs[slot] > 0) {
+        refs[slot]--;
+    }
+    xTaskResumeAll();
+}
+
+void EventBus::notify(BusSubscriber sub, uint32_t bits) {
+    TaskHandle_t task = tasks[sub];
+    if (task != NULL) {
+        xTaskNotify(task, bits, eSetBits);
+    }
+}
+
+void IRAM_ATTR EventBus::notifyFromISR(BusSubscriber sub, uint32_t bits) {
+    TaskHandle_t task = tasks[sub];
+    if (task == NULL) {
+        return;
+    }
+    BaseType_t woken = pdFALSE;
+    xTaskNotifyFromISR(task, bits, eSetBits, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+const char* EventBus::topicName(BusTopic topic) {
+    static const char* const names[BUS_TOPIC_COUNT] = {
+        "系统事件", "模式转移", "档位变化", "报警"
+    };
+    return topic < BUS_TOPIC_COUNT ? names[topic] : "?";
+}
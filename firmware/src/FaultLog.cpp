@@ -0,0 +1,131 @@
+/**
+ * @file FaultLog.cpp
+ * @brief 故障日志实现
+ */
+
+#include "FaultLog.h"
+#include <Preferences.h>
+
+static const char* NVS_NAMESPACE = "faultlog";
+
+namespace {
+
+/**
+ * @brief NVS中的存储格式（长度不符时视为无记录）
+ */
+struct StoredLog {
+    uint8_t head;
+    uint8_t used;
+    uint8_t reserved[2];
+    uint32_t boot;
+    FaultRecord records[FAULT_LOG_LEN];
+};
+
+} // namespace
+
+FaultLog::FaultLog() : head(0), used(0), boot(0), mutex(NULL) {
+    for (uint8_t i = 0; i < FAULT_LOG_LEN; i++) {
+        records[i] = FaultRecord{0, 0, FAULT_NONE, 0xFF, NAN};
+    }
+}
+
+void FaultLog::begin() {
+    mutex = xSemaphoreCreateMutex();
+    
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, false)) {
+        StoredLog stored;
+        if (prefs.getBytesLength("log") == sizeof(stored)
+                && prefs.getBytes("log", &stored, sizeof(stored)) == sizeof(stored)
+                && stored.head < FAULT_LOG_LEN && stored.used <= FAULT_LOG_LEN) {
+            head = stored.head;
+            used = stored.used;
+            boot = stored.boot;
+            memcpy(records, stored.records, sizeof(records));
+        }
+        prefs.end();
+    }
+    
+    boot++;
+    save();
+    Serial.printf("Fault log: boot #%lu, %u record(s)\n", (unsigned long)boot, used);
+}
+
+void FaultLog::record(FaultCode code, uint8_t channel, float value) {
+    if (mutex != NULL) {
+        xSemaphoreTake(mutex, portMAX_DELAY);
+    }
+    records[head] = FaultRecord{boot, (uint32_t)millis(), code, channel, value};
+    head = (uint8_t)((head + 1) % FAULT_LOG_LEN);
+    if (used < FAULT_LOG_LEN) {
+        used++;
+    }
+    save();
+    if (mutex != NULL) {
+        xSemaphoreGive(mutex);
+    }
+}
+
+const FaultRecord& FaultLog::get(uint8_t age) const {
+    if (age >= used) {
+        age = used > 0 ? used - 1 : 0;
+    }
+    return records[(head + FAULT_LOG_LEN - 1 - age) % FAULT_LOG_LEN];
+}
+
+uint8_t FaultLog::countThisBoot() const {
+    uint8_t n = 0;
+    while (n < used && get(n).boot == boot) {
+        n++;
+    }
+    return n;
+}
+
+void FaultLog::clear() {
+    head = 0;
+    used = 0;
+    save();
+}
+
+void FaultLog::save() {
+    StoredLog stored;
+    stored.head = head;
+    stored.used = used;
+    stored.reserved[0] = 0;
+    stored.reserved[1] = 0;
+    stored.boot = boot;
+    memcpy(stored.records, records, sizeof(records));
+    
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        return;
+    }
+    prefs.putBytes("log", &stored, sizeof(stored));
+    prefs.end();
+}
+
+bool FaultLog::isCritical(FaultCode code) {
+    // 抽气无负压可能只是没有佩戴（腔体不密封）；自检被急停中断时急停本身已锁存
+    return code != FAULT_NONE && code != FAULT_POST_PUMP_NO_VACUUM && code != FAULT_POST_ABORTED
+           && code != FAULT_MAINT_PUMP && code != FAULT_MAINT_SEAL && code != FAULT_UPDATE_ROLLBACK;
+}
+
+const char* FaultLog::codeName(FaultCode code) {
+    switch (code) {
+        case FAULT_NONE:                 return "NONE";
+        case FAULT_POST_TEMP_SENSOR:     return "POST_TEMP_SENSOR";
+        case FAULT_POST_TEMP_RANGE:      return "POST_TEMP_RANGE";
+        case FAULT_POST_COLD_JUNCTION:   return "POST_COLD_JUNCTION";
+        case FAULT_POST_PRESSURE_SENSOR: return "POST_PRESSURE_SENSOR";
+        case FAULT_POST_PRESSURE_RANGE:  return "POST_PRESSURE_RANGE";
+        case FAULT_POST_HEATER_STUCK_ON: return "POST_HEATER_STUCK_ON";
+        case FAULT_POST_HEATER_NO_RISE:  return "POST_HEATER_NO_RISE";
+        case FAULT_POST_PUMP_NO_VACUUM:  return "POST_PUMP_NO_VACUUM";
+        case FAULT_POST_ABORTED:         return "POST_ABORTED";
+        case FAULT_MAINT_PUMP:           return "MAINT_PUMP";
+        case FAULT_MAINT_SEAL:           return "MAINT_SEAL";
+        case FAULT_BOARD_OVER_TEMP:      return "BOARD_OVER_TEMP";
+        case FAULT_UPDATE_ROLLBACK:      return "UPDATE_ROLLBACK";
+        default:                         return "?";
+    }
+}
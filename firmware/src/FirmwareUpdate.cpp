@@ -0,0 +1,492 @@
+/**
+ * @file FirmwareUpdate.cpp
+ * @brief 差分固件升级实现
+ */
+
+#include "FirmwareUpdate.h"
+#include "LinkFrame.h"
+#include <Preferences.h>
+#include <esp_ota_ops.h>
+#include <string.h>
+#include <type_traits>
+
+static const char* NVS_NAMESPACE = "fwupdate";
+static const uint32_t CHECKPOINT_VERSION = 1;
+
+/**
+ * @brief 断点（每 UPDATE_CHECKPOINT_SECTORS 个扇区写一次，输出在扇区边界上）
+ */
+struct Checkpoint {
+    uint32_t version;
+    uint32_t slotAddress;
+    uint8_t header[DELTA_HEADER_LEN];
+    DeltaApplierState applier;
+    Sha256 hash;
+};
+static_assert(std::is_trivially_copyable<Checkpoint>::value, "checkpoint is stored as one NVS blob");
+
+/**
+ * @brief 确认过的镜像（下次升级时作为源镜像，不必重算哈希）
+ */
+struct ImageRecord {
+    uint32_t slotAddress;
+    uint32_t size;
+    uint8_t sha[SHA256_DIGEST_LEN];
+};
+
+static size_t reply(uint8_t* response, uint8_t op, RpcStatus status, size_t dataLen) {
+    response[0] = op;
+    response[1] = status;
+    return 2 + dataLen;
+}
+
+FirmwareUpdate::FirmwareUpdate()
+    : faultLog(NULL), running(NULL), target(NULL), st(UPDATE_STATE_IDLE), result(UPDATE_RESULT_NONE),
+      trial(), rebootAt(0), headerBytes(), header(), applier(), targetHash(), sectorFill(0),
+      runningKnown(false), runningSize(0), runningSha(), sourceHash(), sourceHashSize(0), sourceHashed(0) {
+}
+
+void FirmwareUpdate::begin(FaultLog& log) {
+    faultLog = &log;
+    running = esp_ota_get_running_partition();
+
+    Preferences prefs;
+    if (running == NULL || !prefs.begin(NVS_NAMESPACE, false)) {
+        return;
+    }
+    result = (UpdateResult)prefs.getUChar("result", UPDATE_RESULT_NONE);
+
+    ImageRecord image;
+    if (prefs.getBytes("image", &image, sizeof(image)) == sizeof(image)
+            && image.slotAddress == running->address) {
+        runningKnown = true;
+        runningSize = image.size;
+        memcpy(runningSha, image.sha, sizeof(runningSha));
+    }
+
+    bool pending = prefs.getBytes("trial", &trial, sizeof(trial)) == sizeof(trial);
+    if (pending && trial.slotAddress != running->address) {
+        // 切换了启动分区，引导程序却启动了旧分区：新镜像无效
+        prefs.remove("trial");
+        prefs.putUChar("result", UPDATE_RESULT_BOOT_FAILED);
+        result = UPDATE_RESULT_BOOT_FAILED;
+        Serial.printf("✗ 升级: 新固件没有启动（仍运行 %s）\n", running->label);
+    } else if (pending) {
+        trial.boots++;
+        prefs.putBytes("trial", &trial, sizeof(trial));
+        st = UPDATE_STATE_TRIAL;
+        Serial.printf("升级: 新固件试运行（%s，第 %u 次启动）\n", running->label, trial.boots);
+    }
+    prefs.end();
+
+    // 前几次启动都在自检完成前复位
+    if (st == UPDATE_STATE_TRIAL && trial.boots > UPDATE_TRIAL_MAX_BOOTS) {
+        rollback(UPDATE_RESULT_ROLLBACK_BOOTS);
+    }
+}
+
+void FirmwareUpdate::onSelfTestResult(bool passed) {
+    if (st != UPDATE_STATE_TRIAL) {
+        return;
+    }
+    if (passed) {
+        commit();
+    } else {
+        rollback(UPDATE_RESULT_ROLLBACK_SELF_TEST);
+    }
+}
+
+void FirmwareUpdate::commit() {
+    ImageRecord image = { trial.slotAddress, trial.size, {} };
+    memcpy(image.sha, trial.sha, sizeof(image.sha));
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, false)) {
+        prefs.putBytes("image", &image, sizeof(image));
+        prefs.remove("trial");
+        prefs.end();
+    }
+    saveResult(UPDATE_RESULT_COMMITTED);
+    runningKnown = true;
+    runningSize = image.size;
+    memcpy(runningSha, image.sha, sizeof(runningSha));
+    st = UPDATE_STATE_IDLE;
+#if CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE
+    // 引导程序的回滚打开时同样要确认，否则下次复位被引导程序回滚
+    esp_ota_mark_app_valid_cancel_rollback();
+#endif
+    Serial.printf("✓ 升级: 新固件自检通过，已确认（%s）\n", running->label);
+}
+
+void FirmwareUpdate::rollback(UpdateResult why) {
+    const esp_partition_t* previous = esp_ota_get_next_update_partition(NULL);
+    if (previous == NULL || previous->address != trial.previousAddress
+            || esp_ota_set_boot_partition(previous) != ESP_OK) {
+        // 旧分区不可用：只能留在新固件（自检失败时照常停在故障模式）
+        Serial.printf("✗ 升级: 无法回滚到旧固件（%s）\n", resultName(why));
+        return;
+    }
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, false)) {
+        prefs.remove("trial");
+        prefs.end();
+    }
+    saveResult(why);
+    faultLog->record(FAULT_UPDATE_ROLLBACK, 0xFF, (float)why);
+    Serial.printf("✗ 升级: %s，回到 %s 并重启\n", resultName(why), previous->label);
+    Serial.flush();
+    delay(100);
+    ESP.restart();
+}
+
+void FirmwareUpdate::saveResult(UpdateResult r) {
+    result = r;
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, false)) {
+        prefs.putUChar("result", r);
+        prefs.end();
+    }
+}
+
+size_t FirmwareUpdate::handle(uint8_t op, const uint8_t* args, size_t len, uint8_t* response, bool writable) {
+    uint8_t* out = response + 2;
+    size_t outLen = 0;
+    RpcStatus status;
+    switch (op) {
+        case RPC_OP_UPDATE_BEGIN:
+            status = writable ? onBegin(args, len, out, outLen) : RPC_ERR_REJECTED;
+            break;
+        case RPC_OP_UPDATE_DATA:
+            status = writable ? onData(args, len, out, outLen) : RPC_ERR_REJECTED;
+            break;
+        case RPC_OP_UPDATE_FINISH:
+            status = len != 0 ? RPC_ERR_BAD_LENGTH : writable ? onFinish() : RPC_ERR_REJECTED;
+            break;
+        case RPC_OP_UPDATE_STATUS:
+            status = len != 0 ? RPC_ERR_BAD_LENGTH : RPC_OK;
+            outLen = status == RPC_OK ? onStatus(out) : 0;
+            break;
+        case RPC_OP_UPDATE_ABORT:
+            status = len != 0 ? RPC_ERR_BAD_LENGTH : st == UPDATE_STATE_REBOOTING ? RPC_ERR_REJECTED : RPC_OK;
+            if (status == RPC_OK) {
+                endSession(true);
+            }
+            break;
+        default:
+            return 0;
+    }
+    return reply(response, op, status, outLen);
+}
+
+bool FirmwareUpdate::rebootDue(uint32_t now) const {
+    return st == UPDATE_STATE_REBOOTING && (int32_t)(now - rebootAt) >= 0;
+}
+
+// ============ 会话 ============
+
+RpcStatus FirmwareUpdate::onBegin(const uint8_t* args, size_t len, uint8_t* out, size_t& outLen) {
+    if (len != DELTA_HEADER_LEN) {
+        return RPC_ERR_BAD_LENGTH;
+    }
+    if (st == UPDATE_STATE_REBOOTING) {
+        return RPC_ERR_REJECTED;
+    }
+    // 重发的 BEGIN（或断线重连后）：会话照旧
+    if (st == UPDATE_STATE_RECEIVING && memcmp(args, headerBytes, len) == 0) {
+        linkPut32(out, applier.state().inputPos);
+        outLen = 4;
+        return RPC_OK;
+    }
+    DeltaHeader h;
+    if (!deltaHeaderDecode(args, len, h)) {
+        return RPC_ERR_MISMATCH;
+    }
+    if (st == UPDATE_STATE_RECEIVING) {
+        endSession(false);      // 换了差分：旧会话的断点在新会话开始时删除
+    }
+    target = esp_ota_get_next_update_partition(NULL);
+    if (running == NULL || target == NULL) {
+        return RPC_ERR_FLASH;
+    }
+    if (h.targetSize == 0 || h.targetSize > target->size) {
+        return RPC_ERR_TOO_LARGE;
+    }
+    header = h;
+    memcpy(headerBytes, args, len);
+
+    RpcStatus status = checkSource(out, outLen);
+    if (status != RPC_OK) {
+        st = status == RPC_ERR_BUSY ? UPDATE_STATE_VERIFYING_SOURCE : UPDATE_STATE_IDLE;
+        return status;
+    }
+
+    Checkpoint ck;
+    Preferences prefs;
+    bool opened = prefs.begin(NVS_NAMESPACE, false);
+    bool resume = opened && prefs.getBytes("ckpt", &ck, sizeof(ck)) == sizeof(ck)
+                  && ck.version == CHECKPOINT_VERSION && ck.slotAddress == target->address
+                  && memcmp(ck.header, headerBytes, DELTA_HEADER_LEN) == 0;
+    if (resume) {
+        applier.restore(header, ck.applier);
+        targetHash = ck.hash;
+    } else {
+        if (opened) {
+            prefs.remove("ckpt");
+        }
+        applier.begin(header);
+        targetHash.reset();
+    }
+    if (opened) {
+        prefs.end();
+    }
+    sectorFill = 0;
+    st = UPDATE_STATE_RECEIVING;
+    linkPut32(out, applier.state().inputPos);
+    outLen = 4;
+    return RPC_OK;
+}
+
+/**
+ * @brief 确认正在运行的镜像是差分的源镜像
+ * @return RPC_ERR_BUSY 还在计算（out 为已计算的字节数），主机重发 BEGIN 继续
+ */
+RpcStatus FirmwareUpdate::checkSource(uint8_t* out, size_t& outLen) {
+    if (header.sourceSize == 0) {
+        return RPC_OK;          // 完整镜像
+    }
+    if (header.sourceSize > running->size) {
+        return RPC_ERR_MISMATCH;
+    }
+    if (!runningKnown || runningSize != header.sourceSize) {
+        if (sourceHashSize != header.sourceSize) {
+            sourceHash.reset();
+            sourceHashSize = header.sourceSize;
+            sourceHashed = 0;
+        }
+        uint32_t end = sourceHashSize - sourceHashed > UPDATE_HASH_CHUNK
+                       ? sourceHashed + UPDATE_HASH_CHUNK : sourceHashSize;
+        while (sourceHashed < end) {
+            size_t n = end - sourceHashed < sizeof(sector) ? end - sourceHashed : sizeof(sector);
+            if (esp_partition_read(running, sourceHashed, sector, n) != ESP_OK) {
+                sourceHashSize = 0;
+                return RPC_ERR_FLASH;
+            }
+            sourceHash.update(sector, n);
+            sourceHashed += (uint32_t)n;
+        }
+        if (sourceHashed < sourceHashSize) {
+            linkPut32(out, sourceHashed);
+            outLen = 4;
+            return RPC_ERR_BUSY;
+        }
+        sourceHash.finish(runningSha);
+        runningSize = sourceHashSize;
+        runningKnown = true;
+        sourceHashSize = 0;
+    }
+    return memcmp(runningSha, header.sourceSha, SHA256_DIGEST_LEN) == 0 ? RPC_OK : RPC_ERR_MISMATCH;
+}
+
+RpcStatus FirmwareUpdate::onData(const uint8_t* args, size_t len, uint8_t* out, size_t& outLen) {
+    if (len < 4) {
+        return RPC_ERR_BAD_LENGTH;
+    }
+    if (st != UPDATE_STATE_RECEIVING) {
+        return RPC_ERR_NO_SESSION;
+    }
+    uint32_t offset = linkGet32(args);
+    const uint8_t* chunk = args + 4;
+    size_t chunkLen = len - 4;
+    uint32_t expected = applier.state().inputPos;
+
+    RpcStatus status = RPC_OK;
+    if (offset > expected) {
+        status = RPC_ERR_BAD_OFFSET;        // 前面有请求丢了，主机从应答的偏移重发
+    } else {
+        // 与已处理部分重叠（重发、流水线回退）：跳过重叠部分
+        size_t skip = expected - offset;
+        if (skip < chunkLen || chunkLen == 0) {
+            status = process(chunk + (skip < chunkLen ? skip : chunkLen), skip < chunkLen ? chunkLen - skip : 0);
+        }
+    }
+    linkPut32(out, applier.state().inputPos);
+    linkPut32(out + 4, applier.state().outputPos);
+    outLen = 8;
+    return status;
+}
+
+/**
+ * @brief 应用一段差分：输出攒满一个扇区就写入，每个请求最多写一个扇区
+ *
+ * 空输入也会继续未完成的 COPY（差分末尾的长复制由主机在末尾偏移发空数据推进）。
+ */
+RpcStatus FirmwareUpdate::process(const uint8_t* in, size_t len) {
+    bool flushed = false;
+    for (;;) {
+        if (sectorFill == UPDATE_SECTOR_SIZE) {
+            if (flushed) {
+                return RPC_OK;
+            }
+            if (!flushSector()) {
+                endSession(false);          // 从断点重新开始
+                return RPC_ERR_FLASH;
+            }
+            flushed = true;
+        }
+        size_t consumed, produced;
+        bool ok = applier.step(in, len, consumed, sector + sectorFill, UPDATE_SECTOR_SIZE - sectorFill,
+                               produced, readSource, this);
+        sectorFill += produced;
+        in += consumed;
+        len -= consumed;
+        if (!ok) {
+            endSession(true);               // 差分本身有错，断点没有用
+            return RPC_ERR_MISMATCH;
+        }
+        if (sectorFill < UPDATE_SECTOR_SIZE) {
+            return RPC_OK;                  // 输入用完
+        }
+    }
+}
+
+bool FirmwareUpdate::readSource(void* ctx, uint32_t offset, uint8_t* buf, size_t len) {
+    FirmwareUpdate* self = (FirmwareUpdate*)ctx;
+    return esp_partition_read(self->running, offset, buf, len) == ESP_OK;
+}
+
+/**
+ * @brief 擦除并写入当前扇区，回读比较后计入哈希
+ */
+bool FirmwareUpdate::flushSector() {
+    uint32_t offset = applier.state().outputPos - (uint32_t)sectorFill;     // 扇区对齐
+    if (esp_partition_erase_range(target, offset, UPDATE_SECTOR_SIZE) != ESP_OK
+            || esp_partition_write(target, offset, sector, sectorFill) != ESP_OK) {
+        return false;
+    }
+    uint8_t check[256];
+    for (size_t i = 0; i < sectorFill; i += sizeof(check)) {
+        size_t n = sectorFill - i < sizeof(check) ? sectorFill - i : sizeof(check);
+        if (esp_partition_read(target, offset + i, check, n) != ESP_OK || memcmp(check, sector + i, n) != 0) {
+            return false;
+        }
+    }
+    targetHash.update(sector, sectorFill);
+    sectorFill = 0;
+    if ((offset / UPDATE_SECTOR_SIZE + 1) % UPDATE_CHECKPOINT_SECTORS == 0) {
+        saveCheckpoint();
+    }
+    return true;
+}
+
+void FirmwareUpdate::saveCheckpoint() {
+    Checkpoint ck;
+    ck.version = CHECKPOINT_VERSION;
+    ck.slotAddress = target->address;
+    memcpy(ck.header, headerBytes, DELTA_HEADER_LEN);
+    ck.applier = applier.state();
+    ck.hash = targetHash;
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, false)) {
+        prefs.putBytes("ckpt", &ck, sizeof(ck));
+        prefs.end();
+    }
+}
+
+void FirmwareUpdate::endSession(bool dropCheckpoint) {
+    st = UPDATE_STATE_IDLE;
+    sectorFill = 0;
+    sourceHashSize = 0;
+    if (dropCheckpoint) {
+        Preferences prefs;
+        if (prefs.begin(NVS_NAMESPACE, false)) {
+            prefs.remove("ckpt");
+            prefs.end();
+        }
+    }
+}
+
+RpcStatus FirmwareUpdate::onFinish() {
+    if (st == UPDATE_STATE_REBOOTING) {
+        return RPC_OK;
+    }
+    if (st != UPDATE_STATE_RECEIVING) {
+        return RPC_ERR_NO_SESSION;
+    }
+    if (!applier.done()) {
+        return RPC_ERR_BAD_OFFSET;
+    }
+    if (sectorFill > 0 && !flushSector()) {
+        endSession(false);
+        return RPC_ERR_FLASH;
+    }
+    uint8_t digest[SHA256_DIGEST_LEN];
+    targetHash.finish(digest);
+    if (memcmp(digest, header.targetSha, SHA256_DIGEST_LEN) != 0) {
+        // 源镜像的哈希可能过期（比如分区被直接烧写过），下次重新计算
+        runningKnown = false;
+        endSession(true);
+        saveResult(UPDATE_RESULT_VERIFY_FAILED);
+        return RPC_ERR_MISMATCH;
+    }
+    if (esp_ota_set_boot_partition(target) != ESP_OK) {
+        endSession(true);
+        return RPC_ERR_FLASH;
+    }
+
+    trial.slotAddress = target->address;
+    trial.previousAddress = running->address;
+    trial.size = header.targetSize;
+    memcpy(trial.sha, header.targetSha, SHA256_DIGEST_LEN);
+    trial.boots = 0;
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, false)) {
+        prefs.putBytes("trial", &trial, sizeof(trial));
+        prefs.remove("ckpt");
+        prefs.end();
+    }
+    st = UPDATE_STATE_REBOOTING;
+    rebootAt = millis() + UPDATE_REBOOT_DELAY_MS;
+    return RPC_OK;
+}
+
+/**
+ * @brief [状态][上次结果][运行的分区][试运行启动次数][差分偏移][差分长度][输出偏移][新镜像长度]
+ */
+size_t FirmwareUpdate::onStatus(uint8_t* out) const {
+    bool session = st == UPDATE_STATE_RECEIVING || st == UPDATE_STATE_REBOOTING;
+    out[0] = st;
+    out[1] = result;
+    out[2] = running != NULL ? (uint8_t)(running->subtype - ESP_PARTITION_SUBTYPE_APP_OTA_MIN) : 0xFF;
+    out[3] = st == UPDATE_STATE_TRIAL ? trial.boots : 0;
+    linkPut32(out + 4, session ? applier.state().inputPos : st == UPDATE_STATE_VERIFYING_SOURCE ? sourceHashed : 0);
+    linkPut32(out + 8, session ? header.deltaSize : 0);
+    linkPut32(out + 12, session ? applier.state().outputPos : 0);
+    linkPut32(out + 16, session ? header.targetSize : 0);
+    return 20;
+}
+
+const char* FirmwareUpdate::runningLabel() const {
+    return running != NULL ? running->label : "?";
+}
+
+const char* FirmwareUpdate::stateName(UpdateState s) {
+    switch (s) {
+        case UPDATE_STATE_IDLE:             return "IDLE";
+        case UPDATE_STATE_VERIFYING_SOURCE: return "VERIFYING_SOURCE";
+        case UPDATE_STATE_RECEIVING:        return "RECEIVING";
+        case UPDATE_STATE_REBOOTING:        return "REBOOTING";
+        case UPDATE_STATE_TRIAL:            return "TRIAL";
+    }
+    return "?";
+}
+
+const char* FirmwareUpdate::resultName(UpdateResult r) {
+    switch (r) {
+        case UPDATE_RESULT_NONE:                return "NONE";
+        case UPDATE_RESULT_COMMITTED:           return "COMMITTED";
+        case UPDATE_RESULT_ROLLBACK_SELF_TEST:  return "ROLLBACK_SELF_TEST";
+        case UPDATE_RESULT_ROLLBACK_BOOTS:      return "ROLLBACK_BOOTS";
+        case UPDATE_RESULT_BOOT_FAILED:         return "BOOT_FAILED";
+        case UPDATE_RESULT_VERIFY_FAILED:       return "VERIFY_FAILED";
+    }
+    return "?";
+}
@@ -5,11 +5,13 @@
 
 #include "HeatingController.h"
 #include "config.h"
+#include "HotPath.h"
 
 HeatingController::HeatingController(uint8_t heating_pin, uint8_t pwm_channel)
     : heatingPin(heating_pin), pwmChannel(pwm_channel),
       targetTemp(TEMP_TARGET_DEFAULT), lastError(0.0f), integral(0.0f),
-      currentOutput(0), enabled(false) {
+      feedForward(0.0f), currentOutput(0), outputLimit(OUTPUT_MAX), enabled(false), lastUpdateTime(0),
+      outputLease(pwm_channel, HEATER_LEASE_MS) {
 }
 
 void HeatingController::begin() {
@@ -36,7 +38,7 @@ void HeatingController::setTargetTemperature(float target) {
     }
 }
 
-float HeatingController::calculatePID(float error, float dt) {
+float HOT_PATH HeatingController::calculatePID(float error, float dt) {
     // Proportional term
     float p = kp * error;
     
@@ -50,15 +52,16 @@ float HeatingController::calculatePID(float error, float dt) {
     float d = kd * (error - lastError) / dt;
     lastError = error;
     
-    // 总输出
-    float output = p + i + d;
+    // 总输出（含维持功率前馈）
+    float output = p + i + d + feedForward;
     
     return output;
 }
 
-uint8_t HeatingController::update(float current_temp) {
+uint8_t HOT_PATH HeatingController::update(float current_temp) {
     if (!enabled) {
         currentOutput = 0;
+        outputLease.release();
         ledcWrite(pwmChannel, 0);
         return 0;
     }
@@ -74,7 +77,6 @@ uint8_t HeatingController::update(float current_temp) {
     float error = targetTemp - current_temp;
     
     // 修正: 使用实际调用间隔,而不是配置中的固定值
-    static uint32_t lastUpdateTime = 0;
     uint32_t currentTime = millis();
     float dt = (currentTime - lastUpdateTime) / 1000.0f;
     
@@ -89,24 +91,49 @@ uint8_t HeatingController::update(float current_temp) {
     // 限幅
     if (output < OUTPUT_MIN) output = OUTPUT_MIN;
     if (output > OUTPUT_MAX) output = OUTPUT_MAX;
+    if (output > outputLimit) output = outputLimit;
     
     currentOutput = (uint8_t)output;
+    outputLease.renew(currentTime);
     ledcWrite(pwmChannel, currentOutput);
     
     return currentOutput;
 }
 
+uint8_t HOT_PATH HeatingController::driveOpenLoop(float current_temp, uint8_t output) {
+    if (!enabled) {
+        return 0;
+    }
+    
+    if (current_temp >= TEMP_EMERGENCY_STOP) {
+        emergencyStop();
+        Serial.println("Temperature too high! Emergency stop heating!");
+        return 0;
+    }
+    
+    // 不积分（全功率期间积分会严重饱和）；记录误差和时间，交给PID时微分项和dt连续
+    lastError = targetTemp - current_temp;
+    lastUpdateTime = millis();
+    
+    currentOutput = output > outputLimit ? outputLimit : output;
+    outputLease.renew(lastUpdateTime);
+    ledcWrite(pwmChannel, currentOutput);
+    return currentOutput;
+}
+
 void HeatingController::enable() {
     enabled = true;
     // 重置PID
     integral = 0.0f;
     lastError = 0.0f;
+    lastUpdateTime = 0;
     Serial.println("Heating Enabled");
 }
 
 void HeatingController::disable() {
     enabled = false;
     currentOutput = 0;
+    outputLease.release();
     ledcWrite(pwmChannel, 0);
     Serial.println("Heating Disabled");
 }
@@ -114,6 +141,7 @@ void HeatingController::disable() {
 void HeatingController::emergencyStop() {
     enabled = false;
     currentOutput = 0;
+    outputLease.release();
     ledcWrite(pwmChannel, 0);
     integral = 0.0f;
     lastError = 0.0f;
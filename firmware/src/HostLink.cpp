@@ -0,0 +1,87 @@
+/**
+ * @file HostLink.cpp
+ * @brief 主机链路实现
+ */
+
+#include "HostLink.h"
+
+static void (*receiveCallback)() = NULL;
+
+#if ARDUINO_USB_CDC_ON_BOOT && ARDUINO_USB_MODE
+// USB Serial/JTAG（HWCDC）：接收事件在事件循环任务中回调
+static void onCdcEvent(void* arg, esp_event_base_t base, int32_t id, void* data) {
+    if (id == ARDUINO_HW_CDC_RX_EVENT && receiveCallback != NULL) {
+        receiveCallback();
+    }
+}
+#endif
+
+HostLink::HostLink() : mutex(NULL), txFrames(0), txDropped(0), rxIgnored(0) {
+}
+
+void HostLink::begin(SemaphoreHandle_t serialMutex, void (*onReceive)()) {
+    mutex = serialMutex;
+    receiveCallback = onReceive;
+#if ARDUINO_USB_CDC_ON_BOOT && ARDUINO_USB_MODE
+    Serial.onEvent(ARDUINO_HW_CDC_RX_EVENT, onCdcEvent);
+#else
+    // UART：接收超时（一帧结束）时在 UART 事件任务中回调
+    Serial.onReceive([]() {
+        if (receiveCallback != NULL) {
+            receiveCallback();
+        }
+    });
+#endif
+}
+
+size_t HostLink::serviceRequests(RpcServer& server, size_t maxRequests) {
+    size_t handled = 0;
+    while (handled < maxRequests && Serial.available() > 0) {
+        int c = Serial.read();
+        if (c < 0) {
+            break;
+        }
+        if (decoder.push((uint8_t)c) != LinkDecoder::LINK_PUSH_FRAME) {
+            continue;
+        }
+        const LinkFrameView& f = decoder.frame();
+        if (f.type != LINK_FRAME_REQUEST) {
+            rxIgnored++;
+            continue;
+        }
+        uint8_t response[LINK_MAX_PAYLOAD];
+        size_t len = server.handle(f.seq, f.payload, f.len, response);
+        send(LINK_FRAME_RESPONSE, f.seq, response, len);
+        handled++;
+    }
+    return handled;
+}
+
+bool HostLink::hasPendingInput() {
+    return Serial.available() > 0;
+}
+
+bool HostLink::send(LinkFrameType type, uint8_t seq, const uint8_t* payload, size_t len) {
+    uint8_t wire[LINK_MAX_WIRE];
+    size_t n = linkEncodeFrame(type, seq, payload, len, wire);
+    if (n == 0) {
+        return false;
+    }
+    bool sent = false;
+    if (xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE) {
+        if ((size_t)Serial.availableForWrite() >= n) {
+            Serial.write(wire, n);
+            sent = true;
+            txFrames++;
+        } else {
+            txDropped++;
+        }
+        xSemaphoreGive(mutex);
+    }
+    return sent;
+}
+
+HostLink::Stats HostLink::counters() const {
+    const LinkDecoder::Stats& d = decoder.counters();
+    return Stats{d.frames, d.crcErrors + d.overruns, rxIgnored, txFrames, txDropped};
+}
@@ -0,0 +1,121 @@
+/**
+ * @file KTypeThermocouple.cpp
+ * @brief K型热电偶线性化实现
+ * 
+ * 多项式系数来自 NIST ITS-90 热电偶数据库（K型）。
+ * 查表数据由同一组多项式离线计算：
+ * - CJ_TABLE_NV[i]   = E(4°C * i) * 1e6
+ * - INV_TABLE_Q10[i] = E⁻¹(0.131072mV * i) * 1024
+ */
+
+#include "KTypeThermocouple.h"
+#include "HotPath.h"
+
+// ============ 定点查表 ============
+// 查表由IRAM中的 linearize() 每个采样周期使用，放在内部RAM，不经闪存缓存
+
+DRAM_ATTR const int32_t KTypeThermocouple::CJ_TABLE_NV[CJ_TABLE_SIZE] = {
+          0,  158186,  317122,  476777,  637120,  798120,  959743, 1121957,
+    1284727, 1448018, 1611792, 1776009, 1940630, 2105610, 2270906, 2436472,
+    2602259, 2768219, 2934303, 3100460, 3266642
+};
+
+DRAM_ATTR const int32_t KTypeThermocouple::INV_TABLE_Q10[INV_TABLE_SIZE] = {
+        0,  3367,  6735, 10099, 13458, 16810, 20154, 23489,
+    26815, 30130, 33435, 36730, 40016, 43292, 46560, 49819,
+    53071, 56317, 59556, 62792, 66023, 69251, 72477, 75702,
+    78927, 82152, 85378
+};
+
+// ============ NIST ITS-90 系数 ============
+
+// 正向 0 ~ 1372°C：E = Σ c_i t^i + a0 * exp(a1 * (t - a2)^2)
+static const float FWD_POS[] = {
+    -1.76004136860e-02f,  3.89212049750e-02f,  1.85587700320e-05f, -9.94575928740e-08f,
+     3.18409457190e-10f, -5.60728448890e-13f,  5.60750590590e-16f, -3.20207200030e-19f,
+     9.71511471520e-23f, -1.21047212750e-26f
+};
+static const float FWD_A0 = 1.185976e-01f;
+static const float FWD_A1 = -1.183432e-04f;
+static const float FWD_A2 = 1.269686e+02f;
+
+// 正向 -270 ~ 0°C
+static const float FWD_NEG[] = {
+     0.0f,                3.94501280250e-02f,  2.36223735980e-05f, -3.28589067840e-07f,
+    -4.99048287770e-09f, -6.75090591730e-11f, -5.74103274280e-13f, -3.10888728940e-15f,
+    -1.04516093650e-17f, -1.98892668780e-20f, -1.63226974860e-23f
+};
+
+// 反向 0 ~ 500°C（0 ~ 20.644mV）
+static const float INV_POS[] = {
+     0.0f,          2.508355e+01f,  7.860106e-02f, -2.503131e-01f,  8.315270e-02f,
+    -1.228034e-02f, 9.804036e-04f, -4.413030e-05f,  1.057734e-06f, -1.052755e-08f
+};
+
+// 反向 -200 ~ 0°C（-5.891 ~ 0mV）
+static const float INV_NEG[] = {
+     0.0f,           2.5173462e+01f, -1.1662878e+00f, -1.0833638e+00f, -8.9773540e-01f,
+    -3.7342377e-01f, -8.6632643e-02f, -1.0450598e-02f, -5.1920577e-04f
+};
+
+/**
+ * @brief Horner法求多项式
+ */
+static float evalPolynomial(const float* coef, int count, float x) {
+    float result = coef[count - 1];
+    for (int i = count - 2; i >= 0; i--) {
+        result = result * x + coef[i];
+    }
+    return result;
+}
+
+float KTypeThermocouple::voltageFromTemperature(float temp_c) {
+    if (temp_c < 0.0f) {
+        return evalPolynomial(FWD_NEG, sizeof(FWD_NEG) / sizeof(FWD_NEG[0]), temp_c);
+    }
+    float d = temp_c - FWD_A2;
+    return evalPolynomial(FWD_POS, sizeof(FWD_POS) / sizeof(FWD_POS[0]), temp_c)
+         + FWD_A0 * expf(FWD_A1 * d * d);
+}
+
+float KTypeThermocouple::temperatureFromVoltage(float mv) {
+    if (mv < 0.0f) {
+        return evalPolynomial(INV_NEG, sizeof(INV_NEG) / sizeof(INV_NEG[0]), mv);
+    }
+    return evalPolynomial(INV_POS, sizeof(INV_POS) / sizeof(INV_POS[0]), mv);
+}
+
+int32_t HOT_PATH KTypeThermocouple::thermocoupleNanovolts(int16_t hot_counts, int16_t cold_counts) {
+    // 统一换算到1/16°C：热端计数 * 4，冷端计数本身即1/16°C
+    int32_t diff16 = (int32_t)hot_counts * 4 - cold_counts;
+    return (diff16 * MAX31855_NV_PER_16TH + 8) >> 4;
+}
+
+float HOT_PATH KTypeThermocouple::linearize(int16_t hot_counts, int16_t cold_counts) {
+    int32_t v_nv = thermocoupleNanovolts(hot_counts, cold_counts);
+    
+    // 冷端电压
+    if (cold_counts >= 0 && cold_counts < ((CJ_TABLE_SIZE - 1) << CJ_TABLE_SHIFT)) {
+        int32_t i = cold_counts >> CJ_TABLE_SHIFT;
+        int32_t frac = cold_counts & ((1 << CJ_TABLE_SHIFT) - 1);
+        v_nv += CJ_TABLE_NV[i] + (((CJ_TABLE_NV[i + 1] - CJ_TABLE_NV[i]) * frac) >> CJ_TABLE_SHIFT);
+    } else {
+        return linearizeFull(hot_counts, cold_counts);
+    }
+    
+    // 反查温度
+    if (v_nv >= 0 && v_nv < ((int32_t)(INV_TABLE_SIZE - 1) << INV_TABLE_SHIFT)) {
+        int32_t i = v_nv >> INV_TABLE_SHIFT;
+        int32_t frac = v_nv & ((1 << INV_TABLE_SHIFT) - 1);
+        int32_t t_q10 = INV_TABLE_Q10[i] + (((INV_TABLE_Q10[i + 1] - INV_TABLE_Q10[i]) * frac) >> INV_TABLE_SHIFT);
+        return t_q10 / 1024.0f;
+    }
+    
+    return temperatureFromVoltage(v_nv * 1e-6f);
+}
+
+float KTypeThermocouple::linearizeFull(int16_t hot_counts, int16_t cold_counts) {
+    float v_mv = thermocoupleNanovolts(hot_counts, cold_counts) * 1e-6f;
+    v_mv += voltageFromTemperature(cold_counts * 0.0625f);
+    return temperatureFromVoltage(v_mv);
+}
@@ -0,0 +1,76 @@
+/**
+ * @file LinkProtocol.cpp
+ * @brief 遥测记录编解码（固件与主机工具共用）
+ */
+
+#include "LinkProtocol.h"
+#include "LinkFrame.h"
+#include <math.h>
+
+int16_t telemetryCenti(float value) {
+    if (isnan(value)) {
+        return TELEMETRY_INVALID;
+    }
+    float centi = roundf(value * 100.0f);
+    if (centi <= (float)TELEMETRY_INVALID || centi > (float)INT16_MAX) {
+        return TELEMETRY_INVALID;
+    }
+    return (int16_t)centi;
+}
+
+float telemetryFromCenti(int16_t centi) {
+    return centi == TELEMETRY_INVALID ? NAN : centi / 100.0f;
+}
+
+size_t telemetryEncode(const TelemetryRecord& rec, uint8_t* out) {
+    uint8_t count = rec.channelCount < TELEMETRY_MAX_CHANNELS ? rec.channelCount : TELEMETRY_MAX_CHANNELS;
+    out[0] = TELEMETRY_VERSION;
+    linkPut32(out + 1, rec.uptimeMs);
+    out[5] = rec.mode;
+    out[6] = rec.gear;
+    out[7] = rec.flags;
+    linkPut16(out + 8, (uint16_t)rec.boardTempCenti);
+    out[10] = rec.heaterLimit;
+    out[11] = rec.pumpLimit;
+    out[12] = count;
+    uint8_t* p = out + TELEMETRY_HEADER_LEN;
+    for (uint8_t i = 0; i < count; i++) {
+        const TelemetryChannel& ch = rec.channels[i];
+        linkPut16(p, (uint16_t)ch.padTempCenti);
+        linkPut16(p + 2, (uint16_t)ch.pressureCenti);
+        p[4] = ch.heaterDuty;
+        p[5] = ch.pumpPercent;
+        p[6] = ch.flags;
+        p += TELEMETRY_CHANNEL_LEN;
+    }
+    return (size_t)(p - out);
+}
+
+bool telemetryDecode(const uint8_t* payload, size_t len, TelemetryRecord& rec) {
+    if (len < TELEMETRY_HEADER_LEN || payload[0] != TELEMETRY_VERSION) {
+        return false;
+    }
+    uint8_t count = payload[12];
+    if (count > TELEMETRY_MAX_CHANNELS || len != TELEMETRY_HEADER_LEN + (size_t)count * TELEMETRY_CHANNEL_LEN) {
+        return false;
+    }
+    rec.uptimeMs = linkGet32(payload + 1);
+    rec.mode = payload[5];
+    rec.gear = payload[6];
+    rec.flags = payload[7];
+    rec.boardTempCenti = (int16_t)linkGet16(payload + 8);
+    rec.heaterLimit = payload[10];
+    rec.pumpLimit = payload[11];
+    rec.channelCount = count;
+    const uint8_t* p = payload + TELEMETRY_HEADER_LEN;
+    for (uint8_t i = 0; i < count; i++) {
+        TelemetryChannel& ch = rec.channels[i];
+        ch.padTempCenti = (int16_t)linkGet16(p);
+        ch.pressureCenti = (int16_t)linkGet16(p + 2);
+        ch.heaterDuty = p[4];
+        ch.pumpPercent = p[5];
+        ch.flags = p[6];
+        p += TELEMETRY_CHANNEL_LEN;
+    }
+    return true;
+}
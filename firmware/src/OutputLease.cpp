@@ -0,0 +1,66 @@
+/**
+ * @file OutputLease.cpp
+ * @brief 执行器输出租约实现
+ */
+
+#include "OutputLease.h"
+
+OutputLease::OutputLease(uint8_t pwm_channel, uint32_t window_ms)
+    : pwmChannel(pwm_channel), windowMs(window_ms), renewedAt(0), armed(false),
+      expired(false), lateMs(0), expiryCount(0) {
+}
+
+bool OutputLease::check(uint32_t now) {
+    if (!armed) {
+        return false;
+    }
+    uint32_t age = now - renewedAt;
+    if (age <= windowMs) {
+        return false;
+    }
+    ledcWrite(pwmChannel, 0);
+    armed = false;
+    lateMs = age;
+    expired = true;
+    expiryCount = expiryCount + 1;
+    return true;
+}
+
+bool OutputLease::takeExpiry(uint32_t& late_ms) {
+    if (!expired) {
+        return false;
+    }
+    late_ms = lateMs;
+    expired = false;
+    return true;
+}
+
+LeaseMonitor::LeaseMonitor() : leaseCount(0), timer(NULL) {
+}
+
+bool LeaseMonitor::add(OutputLease& lease) {
+    if (leaseCount >= MAX_LEASES) {
+        return false;
+    }
+    leases[leaseCount++] = &lease;
+    return true;
+}
+
+bool LeaseMonitor::begin() {
+    timer = xTimerCreate("Lease", pdMS_TO_TICKS(OUTPUT_LEASE_CHECK_MS), pdTRUE, this, onTimer);
+    return timer != NULL && xTimerStart(timer, 0) == pdPASS;
+}
+
+void LeaseMonitor::onTimer(TimerHandle_t timer) {
+    static_cast<LeaseMonitor*>(pvTimerGetTimerID(timer))->checkAll();
+}
+
+void LeaseMonitor::checkAll() {
+    // 挂起调度器：检查与清零之间控制任务不能续约并写入新占空比
+    vTaskSuspendAll();
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < leaseCount; i++) {
+        leases[i]->check(now);
+    }
+    xTaskResumeAll();
+}
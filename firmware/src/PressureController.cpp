@@ -0,0 +1,65 @@
+/**
+ * @file PressureController.cpp
+ * @brief 负压控制器实现
+ */
+
+#include "PressureController.h"
+#include "config.h"
+#include "HotPath.h"
+
+PressureController::PressureController()
+    : kp(PRESSURE_KP), ki(PRESSURE_KI), integral(0.0f), feedForward(0.0f),
+      lastUpdateTime(0), outputLimit(OUTPUT_MAX) {
+}
+
+void PressureController::reset() {
+    integral = 0.0f;
+    feedForward = 0.0f;
+    lastUpdateTime = 0;
+}
+
+void PressureController::setPI(float p, float i) {
+    kp = p;
+    ki = i;
+    integral = 0.0f;
+    Serial.printf("Pressure PI updated: Kp=%.2f, Ki=%.2f\n", kp, ki);
+}
+
+uint8_t HOT_PATH PressureController::update(float target, float vacuum, float gas_temp, float temp_rate) {
+    uint32_t currentTime = millis();
+    float dt = (currentTime - lastUpdateTime) / 1000.0f;
+    if (lastUpdateTime == 0) {
+        dt = PRESSURE_SAMPLE_PERIOD_MS / 1000.0f;
+    }
+    lastUpdateTime = currentTime;
+
+    // 温度耦合前馈：升温使负压减小，需要额外的抽气速率来抵消
+    feedForward = 0.0f;
+#if PRESSURE_THERMAL_FF
+    if (!isnan(gas_temp) && !isnan(temp_rate)) {
+        float absPressure = PRESSURE_ATM_MMHG - vacuum;
+        float kelvin = gas_temp + 273.15f;
+        feedForward = (absPressure / kelvin) * temp_rate * PRESSURE_FF_COUPLING / PRESSURE_PUMP_GAIN;
+    }
+#endif
+
+    float error = target - vacuum;
+    float p = kp * error;
+    float output = p + integral + feedForward;
+
+    // 条件积分（抗饱和）：输出已饱和且误差会加深饱和时不再积分
+    bool saturatedHigh = output >= outputLimit && error > 0.0f;
+    bool saturatedLow = output <= OUTPUT_MIN && error < 0.0f;
+    if (!saturatedHigh && !saturatedLow) {
+        integral += ki * error * dt;
+        if (integral > OUTPUT_MAX) integral = OUTPUT_MAX;
+        if (integral < -OUTPUT_MAX) integral = -OUTPUT_MAX;
+        output = p + integral + feedForward;
+    }
+
+    // 限幅
+    if (output < OUTPUT_MIN) output = OUTPUT_MIN;
+    if (output > outputLimit) output = outputLimit;
+
+    return (uint8_t)(output + 0.5f);
+}
@@ -0,0 +1,162 @@
+/**
+ * @file PressureDriftCompensator.cpp
+ * @brief 压力零点温漂补偿实现
+ */
+
+#include "PressureDriftCompensator.h"
+#include <Preferences.h>
+
+static const char* NVS_NAMESPACE = "pdrift";
+
+PressureDriftCompensator::PressureDriftCompensator()
+    : channelIndex(0), dirty(false), lastSaveTime(0),
+      windowSum(0.0f), windowBoardSum(0.0f), windowMin(0.0f), windowMax(0.0f), windowCount(0) {
+    for (uint8_t i = 0; i < NUM_KNOTS; i++) {
+        offset[i] = 0.0f;
+        count[i] = 0;
+    }
+}
+
+void PressureDriftCompensator::begin(uint8_t channel) {
+    channelIndex = channel;
+    
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true)) {
+        return;  // 尚无记录
+    }
+    
+    char key[8];
+    snprintf(key, sizeof(key), "off%u", channelIndex);
+    if (prefs.getBytesLength(key) == sizeof(offset)) {
+        prefs.getBytes(key, offset, sizeof(offset));
+        snprintf(key, sizeof(key), "cnt%u", channelIndex);
+        prefs.getBytes(key, count, sizeof(count));
+        Serial.printf("Pressure drift curve loaded (channel %u)\n", channelIndex);
+    }
+    prefs.end();
+}
+
+void PressureDriftCompensator::locate(float board_temp, uint8_t& knot, float& frac) {
+    float x = (board_temp - PRESSURE_DRIFT_TEMP_MIN) / PRESSURE_DRIFT_TEMP_STEP;
+    if (x <= 0.0f) {
+        knot = 0;
+        frac = 0.0f;
+    } else if (x >= NUM_KNOTS - 1) {
+        knot = NUM_KNOTS - 2;
+        frac = 1.0f;
+    } else {
+        knot = (uint8_t)x;
+        frac = x - knot;
+    }
+}
+
+float PressureDriftCompensator::knotValue(uint8_t knot) const {
+    if (count[knot] > 0) {
+        return offset[knot];
+    }
+    // 向两侧查找最近的已学习节点（曲线两端平直外推）
+    for (uint8_t d = 1; d < NUM_KNOTS; d++) {
+        if (knot >= d && count[knot - d] > 0) return offset[knot - d];
+        if (knot + d < NUM_KNOTS && count[knot + d] > 0) return offset[knot + d];
+    }
+    return 0.0f;
+}
+
+float PressureDriftCompensator::offsetAt(float board_temp) const {
+    uint8_t knot;
+    float frac;
+    locate(board_temp, knot, frac);
+    float a = knotValue(knot);
+    float b = knotValue(knot + 1);
+    return a + (b - a) * frac;
+}
+
+bool PressureDriftCompensator::observe(float raw_kpa, float board_temp) {
+    if (isnan(raw_kpa) || isnan(board_temp)) {
+        windowCount = 0;
+        return false;
+    }
+    if (windowCount == 0) {
+        windowSum = 0.0f;
+        windowBoardSum = 0.0f;
+        windowMin = raw_kpa;
+        windowMax = raw_kpa;
+    }
+    windowSum += raw_kpa;
+    windowBoardSum += board_temp;
+    windowMin = fminf(windowMin, raw_kpa);
+    windowMax = fmaxf(windowMax, raw_kpa);
+    if (++windowCount < PRESSURE_DRIFT_AVG_SAMPLES) {
+        return false;
+    }
+    
+    windowCount = 0;
+    float mean = windowSum / PRESSURE_DRIFT_AVG_SAMPLES;
+    if (windowMax - windowMin > PRESSURE_DRIFT_SPREAD_BAND || fabsf(mean) >= PRESSURE_DRIFT_LEARN_BAND) {
+        return false;  // 仍在回气或没有通大气
+    }
+    learn(mean, windowBoardSum / PRESSURE_DRIFT_AVG_SAMPLES);
+    return true;
+}
+
+void PressureDriftCompensator::learn(float raw_kpa, float board_temp) {
+    if (isnan(raw_kpa) || isnan(board_temp)) {
+        return;
+    }
+    
+    uint8_t knot;
+    float frac;
+    locate(board_temp, knot, frac);
+    
+    // 按插值权重把残差分配到相邻两个节点（LMS），
+    // 步长随学习次数减小，下限 PRESSURE_DRIFT_LEARN_RATE_MIN 以跟踪老化
+    float error = raw_kpa - offsetAt(board_temp);
+    const float weights[2] = { 1.0f - frac, frac };
+    for (uint8_t k = 0; k < 2; k++) {
+        uint8_t idx = knot + k;
+        if (weights[k] < 0.25f) {
+            continue;  // 离该节点太远，不更新
+        }
+        if (count[idx] == 0) {
+            offset[idx] = knotValue(idx);  // 从外推值开始学习
+        }
+        float rate = 1.0f / (count[idx] + 1);
+        if (rate < PRESSURE_DRIFT_LEARN_RATE_MIN) {
+            rate = PRESSURE_DRIFT_LEARN_RATE_MIN;
+        }
+        offset[idx] += rate * weights[k] * error;
+        if (count[idx] < 0xFFFF) {
+            count[idx]++;
+        }
+    }
+    dirty = true;
+}
+
+void PressureDriftCompensator::saveIfDirty(uint32_t now_ms) {
+    if (dirty && (now_ms - lastSaveTime) >= PRESSURE_DRIFT_SAVE_INTERVAL_MS) {
+        save();
+        lastSaveTime = now_ms;
+    }
+}
+
+void PressureDriftCompensator::save() {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        return;
+    }
+    char key[8];
+    snprintf(key, sizeof(key), "off%u", channelIndex);
+    prefs.putBytes(key, offset, sizeof(offset));
+    snprintf(key, sizeof(key), "cnt%u", channelIndex);
+    prefs.putBytes(key, count, sizeof(count));
+    prefs.end();
+    dirty = false;
+}
+
+void PressureDriftCompensator::clear() {
+    for (uint8_t i = 0; i < NUM_KNOTS; i++) {
+        offset[i] = 0.0f;
+        count[i] = 0;
+    }
+    save();
+}
@@ -5,9 +5,11 @@
 
 #include "PumpController.h"
 #include "config.h"
+#include "HotPath.h"
 
 PumpController::PumpController(uint8_t pwm_pin, uint8_t pwm_channel)
-    : pwmPin(pwm_pin), pwmChannel(pwm_channel), currentSpeed(0), running(false) {
+    : pwmPin(pwm_pin), pwmChannel(pwm_channel), currentSpeed(0), running(false),
+      outputLease(pwm_channel, PUMP_LEASE_MS) {
 }
 
 void PumpController::begin() {
@@ -21,27 +23,29 @@ void PumpController::begin() {
     Serial.println("Pump controller initialized");
 }
 
-void PumpController::setSpeed(uint8_t speed) {
+void HOT_PATH PumpController::setSpeed(uint8_t speed) {
     if (speed > 100) speed = 100;
     
     currentSpeed = speed;
     
     if (running) {
         uint8_t pwm_value = map(speed, 0, 100, 0, 255);
-        ledcWrite(pwmChannel, pwm_value);
-        Serial.printf("Pump speed set to: %d%%\n", speed);
+        outputLease.renew(millis());
+        ledcWrite(pwmChannel, pwm_value);  // 闭环控制每个周期都会调用，不打印
     }
 }
 
 void PumpController::start() {
     running = true;
     uint8_t pwm_value = map(currentSpeed, 0, 100, 0, 255);
+    outputLease.renew(millis());
     ledcWrite(pwmChannel, pwm_value);
     Serial.printf("Pump started, speed: %d%%\n", currentSpeed);
 }
 
 void PumpController::stop() {
     running = false;
+    outputLease.release();
     ledcWrite(pwmChannel, 0);
     Serial.println("Pump stopped");
 }
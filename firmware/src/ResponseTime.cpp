@@ -0,0 +1,49 @@
+/**
+ * @file ResponseTime.cpp
+ * @brief 响应时间分析：编译期检查与报告
+ */
+
+#include "ResponseTime.h"
+#include <stdio.h>
+
+// 改动 config.h 后某个硬实时任务可能错过截止期时编译失败（固件和主机仿真相同）
+static_assert(rtaAnalyze(RTA_FIRMWARE_TASKS, RTA_TICK).schedulable,
+              "RTA: tick interrupt misses its period");
+static_assert(rtaAnalyze(RTA_FIRMWARE_TASKS, RTA_SUPERVISOR).schedulable,
+              "RTA: supervisor can miss one pressure slot (see ResponseTime.h)");
+static_assert(rtaAnalyze(RTA_FIRMWARE_TASKS, RTA_TEMPERATURE).schedulable,
+              "RTA: temperature task can miss its slot (see ResponseTime.h)");
+static_assert(rtaAnalyze(RTA_FIRMWARE_TASKS, RTA_PRESSURE).schedulable,
+              "RTA: pressure task can miss its slot (see ResponseTime.h)");
+static_assert(rtaAnalyze(RTA_FIRMWARE_TASKS, RTA_SAFETY).schedulable,
+              "RTA: safety monitor can miss its period (see ResponseTime.h)");
+static_assert(rtaAnalyze(RTA_FIRMWARE_TASKS, RTA_NVS).schedulable,
+              "RTA: NVS writes exceed their minimum interval (see ResponseTime.h)");
+static_assert(rtaAnalyze(RTA_FIRMWARE_TASKS, RTA_TIMER_SERVICE).schedulable,
+              "RTA: lease check can be delayed past the next check (see ResponseTime.h)");
+static_assert(rtaHardSchedulable(RTA_FIRMWARE_TASKS), "RTA: hard task not schedulable");
+
+uint8_t rtaReport(const RtaTask (&set)[RTA_TASK_COUNT], void (*print)(const char* line)) {
+    char line[128];
+    uint8_t misses = 0;
+    print("[响应时间] 任务          优先级  C(µs)   B(µs)   R(µs)   D(µs)");
+    for (size_t i = 0; i < RTA_TASK_COUNT; i++) {
+        const RtaTask& t = set[i];
+        RtaResult r = rtaAnalyze(set, i);
+        char prio[8];
+        if (t.priority == RTA_PRIORITY_ISR) {
+            snprintf(prio, sizeof(prio), "ISR");
+        } else {
+            snprintf(prio, sizeof(prio), "%u", t.priority);
+        }
+        snprintf(line, sizeof(line), "[响应时间] %-12s  %-6s  %-6lu  %-6lu  %s%-6lu  %-7lu %s",
+                 t.name, prio, (unsigned long)t.wcetUs, (unsigned long)r.blockingUs,
+                 r.schedulable ? "" : ">", (unsigned long)r.responseUs, (unsigned long)t.deadlineUs,
+                 r.schedulable ? "✓" : (t.hard ? "✗ 可能错过截止期" : "! 可能错过截止期（软实时）"));
+        print(line);
+        if (!r.schedulable && t.hard) {
+            misses++;
+        }
+    }
+    return misses;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file RpcServer.cpp
+ * @brief RPC 请求分派实现
+ */
+
+#include "RpcServer.h"
+#include <math.h>
+#include <string.h>
+
+RpcServer::RpcServer(const RpcParam* params, size_t count, RpcCommandHandler commands,
+                     uint8_t channels, uint32_t (*uptime)())
+    : params(params), paramCount(count), commands(commands), channelCount(channels),
+      uptime(uptime), extension(nullptr), stats{0, 0, 0}, hasLast(false), lastSeq(0), lastRequestCrc(0), lastLen(0) {
+}
+
+size_t RpcServer::handle(uint8_t seq, const uint8_t* request, size_t len, uint8_t* response) {
+    uint16_t crc = linkCrc16(request, len);
+    if (hasLast && seq == lastSeq && crc == lastRequestCrc) {
+        stats.duplicates++;
+        memcpy(response, lastResponse, lastLen);
+        return lastLen;
+    }
+
+    stats.requests++;
+    size_t n = dispatch(request, len, response);
+    if (n < 2 || response[1] != RPC_OK) {
+        stats.errors++;
+    }
+
+    hasLast = true;
+    lastSeq = seq;
+    lastRequestCrc = crc;
+    lastLen = n;
+    memcpy(lastResponse, response, n);
+    return n;
+}
+
+const RpcParam* RpcServer::find(uint8_t id) const {
+    for (size_t i = 0; i < paramCount; i++) {
+        if (params[i].id == id) {
+            return &params[i];
+        }
+    }
+    return nullptr;
+}
+
+size_t RpcServer::dispatch(const uint8_t* request, size_t len, uint8_t* response) {
+    if (len == 0) {
+        response[0] = 0;
+        response[1] = RPC_ERR_BAD_LENGTH;
+        return 2;
+    }
+    const uint8_t op = request[0];
+    const uint8_t* args = request + 1;
+    const size_t argLen = len - 1;
+    response[0] = op;
+    response[1] = RPC_OK;
+    size_t n = 2;
+
+    switch (op) {
+        case RPC_OP_PING:
+            if (n + argLen > LINK_MAX_PAYLOAD) {
+                response[1] = RPC_ERR_TOO_LARGE;
+                return 2;
+            }
+            memcpy(response + n, args, argLen);
+            return n + argLen;
+
+        case RPC_OP_INFO:
+            response[n++] = LINK_PROTOCOL_VERSION;
+            response[n++] = channelCount;
+            response[n++] = (uint8_t)paramCount;
+            response[n++] = LINK_MAX_PAYLOAD;
+            linkPut32(response + n, uptime ? uptime() : 0);
+            return n + 4;
+
+        case RPC_OP_LIST: {
+            if (argLen != 1) {
+                response[1] = RPC_ERR_BAD_LENGTH;
+                return 2;
+            }
+            // 放不下的部分由主机从下一个序号继续请求
+            size_t countAt = n++;
+            uint8_t listed = 0;
+            for (size_t i = args[0]; i < paramCount; i++) {
+                const RpcParam& p = params[i];
+                size_t nameLen = strlen(p.name);
+                if (nameLen > 32) {
+                    nameLen = 32;
+                }
+                if (n + 11 + nameLen > LINK_MAX_PAYLOAD) {
+                    break;
+                }
+                response[n++] = p.id;
+                response[n++] = p.set ? RPC_PARAM_WRITABLE : 0;
+                linkPutFloat(response + n, p.minValue);
+                linkPutFloat(response + n + 4, p.maxValue);
+                n += 8;
+                response[n++] = (uint8_t)nameLen;
+                memcpy(response + n, p.name, nameLen);
+                n += nameLen;
+                listed++;
+            }
+            response[countAt] = listed;
+            return n;
+        }
+
+        case RPC_OP_GET:
+            if (argLen == 0) {
+                response[1] = RPC_ERR_BAD_LENGTH;
+                return 2;
+            }
+            if (n + argLen * 6 > LINK_MAX_PAYLOAD) {
+                response[1] = RPC_ERR_TOO_LARGE;
+                return 2;
+            }
+            for (size_t i = 0; i < argLen; i++) {
+                const RpcParam* p = find(args[i]);
+                response[n] = args[i];
+                response[n + 1] = p ? RPC_OK : RPC_ERR_UNKNOWN_PARAM;
+                linkPutFloat(response + n + 2, p ? p->get() : NAN);
+                n += 6;
+            }
+            return n;
+
+        case RPC_OP_SET:
+            if (argLen == 0 || argLen % 5 != 0) {
+                response[1] = RPC_ERR_BAD_LENGTH;
+                return 2;
+            }
+            for (size_t i = 0; i < argLen; i += 5) {
+                const RpcParam* p = find(args[i]);
+                float value = linkGetFloat(args + i + 1);
+                RpcStatus st;
+                if (p == nullptr) {
+                    st = RPC_ERR_UNKNOWN_PARAM;
+                } else if (p->set == nullptr) {
+                    st = RPC_ERR_READ_ONLY;
+                } else if (isnan(value) || value < p->minValue || value > p->maxValue) {
+                    st = RPC_ERR_OUT_OF_RANGE;
+                } else {
+                    st = p->set(value);
+                }
+                response[n++] = args[i];
+                response[n++] = st;
+            }
+            return n;
+
+        case RPC_OP_COMMAND:
+            if (argLen != 1) {
+                response[1] = RPC_ERR_BAD_LENGTH;
+                return 2;
+            }
+            response[1] = (args[0] >= CMD_COUNT || commands == nullptr) ? RPC_ERR_UNKNOWN_COMMAND
+                                                                        : commands(args[0]);
+            return 2;
+
+        default:
+            if (extension != nullptr) {
+                size_t handled = extension(op, args, argLen, response);
+                if (handled > 0) {
+                    return handled;
+                }
+            }
+            response[0] = op;
+            response[1] = RPC_ERR_UNKNOWN_OP;
+            return 2;
+    }
+}
@@ -0,0 +1,238 @@
+/**
+ * @file SelfTest.cpp
+ * @brief 上电自检判定
+ */
+
+#include "SelfTest.h"
+
+ChannelSelfTest::ChannelSelfTest() {
+    start(0);
+}
+
+void ChannelSelfTest::start(uint32_t now) {
+    startMs = now;
+    baselineDone = false;
+    heaterOn = false;
+    pumpOn = false;
+    for (uint8_t c = 0; c < POST_CHECK_COUNT; c++) {
+        outcomes[c] = PostOutcome{POST_PENDING, FAULT_NONE, NAN, 0};
+    }
+    tempCount = 0;
+    tempFailures = 0;
+    boardSum = 0.0f;
+    boardCount = 0;
+    vacuumSum = 0.0f;
+    vacuumMin = INFINITY;
+    vacuumMax = -INFINITY;
+    vacuumCount = 0;
+    vacuumFailures = 0;
+    restSlope = 0.0f;
+    baselineTemp = NAN;
+    baselineMs = now;
+    baselineVacuum = NAN;
+    lastTemp = NAN;
+    lastTempMs = now;
+    lastVacuum = NAN;
+}
+
+void ChannelSelfTest::addTemperature(uint32_t now, float pad, float board) {
+    if (!isnan(pad)) {
+        lastTemp = pad;
+        lastTempMs = now;
+    }
+    if (baselineDone) {
+        return;
+    }
+    if (isnan(pad)) {
+        tempFailures++;
+    } else if (tempCount < MAX_BASELINE) {
+        tempT[tempCount] = (now - startMs) / 1000.0f;
+        tempV[tempCount] = pad;
+        tempCount++;
+    }
+    if (!isnan(board)) {
+        boardSum += board;
+        boardCount++;
+    }
+}
+
+void ChannelSelfTest::addPressure(uint32_t now, float vacuum) {
+    (void)now;
+    if (!isnan(vacuum)) {
+        lastVacuum = vacuum;
+    }
+    if (baselineDone) {
+        return;
+    }
+    if (isnan(vacuum)) {
+        vacuumFailures++;
+        return;
+    }
+    vacuumSum += vacuum;
+    vacuumCount++;
+    if (vacuum < vacuumMin) vacuumMin = vacuum;
+    if (vacuum > vacuumMax) vacuumMax = vacuum;
+}
+
+void ChannelSelfTest::finishBaseline(uint32_t now) {
+    baselineDone = true;
+
+    // ---- 温度：读取 -> 范围/噪声 -> 冷端一致性 ----
+    if (tempCount < 2 || tempFailures > 1) {
+        conclude(POST_CHECK_TEMP_SENSOR, POST_FAIL, FAULT_POST_TEMP_SENSOR, tempFailures, now);
+    } else {
+        // 最小二乘直线：斜率为未加热时的升温速率，残差为噪声（升温本身不算噪声）
+        float mt = 0.0f, mv = 0.0f;
+        for (uint8_t i = 0; i < tempCount; i++) {
+            mt += tempT[i];
+            mv += tempV[i];
+        }
+        mt /= tempCount;
+        mv /= tempCount;
+        float sxy = 0.0f, sxx = 0.0f;
+        for (uint8_t i = 0; i < tempCount; i++) {
+            sxy += (tempT[i] - mt) * (tempV[i] - mv);
+            sxx += (tempT[i] - mt) * (tempT[i] - mt);
+        }
+        restSlope = sxx > 0.0f ? sxy / sxx : 0.0f;
+        float noise = 0.0f;
+        for (uint8_t i = 0; i < tempCount; i++) {
+            float r = fabsf(tempV[i] - (mv + restSlope * (tempT[i] - mt)));
+            if (r > noise) noise = r;
+        }
+        // 基线取最后一个采样时刻的拟合值，热启动后正在冷却时按冷却趋势外推
+        baselineMs = startMs + (uint32_t)(tempT[tempCount - 1] * 1000.0f);
+        baselineTemp = mv + restSlope * (tempT[tempCount - 1] - mt);
+
+        if (mv < POST_TEMP_MIN || mv > POST_TEMP_MAX) {
+            conclude(POST_CHECK_TEMP_SENSOR, POST_FAIL, FAULT_POST_TEMP_RANGE, mv, now);
+        } else if (noise > POST_TEMP_NOISE) {
+            conclude(POST_CHECK_TEMP_SENSOR, POST_FAIL, FAULT_POST_TEMP_RANGE, noise, now);
+        } else if (boardCount > 0 && fabsf(mv - boardSum / boardCount) > POST_TEMP_AGREEMENT) {
+            conclude(POST_CHECK_TEMP_SENSOR, POST_FAIL, FAULT_POST_COLD_JUNCTION,
+                     mv - boardSum / boardCount, now);
+        } else {
+            conclude(POST_CHECK_TEMP_SENSOR, POST_PASS, FAULT_NONE, mv, now);
+        }
+    }
+
+    if (outcomes[POST_CHECK_TEMP_SENSOR].result != POST_PASS) {
+        conclude(POST_CHECK_HEATER, POST_SKIPPED, FAULT_NONE, NAN, now);
+    } else if (restSlope > POST_REST_SLOPE_MAX) {
+        conclude(POST_CHECK_HEATER, POST_FAIL, FAULT_POST_HEATER_STUCK_ON, restSlope, now);
+    } else if (baselineTemp >= POST_HEATER_SKIP_TEMP) {
+        conclude(POST_CHECK_HEATER, POST_SKIPPED, FAULT_NONE, baselineTemp, now);
+    }
+
+    // ---- 负压：读取 -> 范围/噪声 ----
+    if (vacuumCount < 2 || vacuumFailures > 1) {
+        conclude(POST_CHECK_PRESSURE_SENSOR, POST_FAIL, FAULT_POST_PRESSURE_SENSOR, vacuumFailures, now);
+    } else {
+        baselineVacuum = vacuumSum / vacuumCount;
+        if (baselineVacuum < POST_VACUUM_MIN || baselineVacuum > POST_VACUUM_MAX) {
+            conclude(POST_CHECK_PRESSURE_SENSOR, POST_FAIL, FAULT_POST_PRESSURE_RANGE, baselineVacuum, now);
+        } else if (vacuumMax - vacuumMin > POST_PRESSURE_NOISE) {
+            conclude(POST_CHECK_PRESSURE_SENSOR, POST_FAIL, FAULT_POST_PRESSURE_RANGE,
+                     vacuumMax - vacuumMin, now);
+        } else {
+            conclude(POST_CHECK_PRESSURE_SENSOR, POST_PASS, FAULT_NONE, baselineVacuum, now);
+        }
+    }
+
+    if (outcomes[POST_CHECK_PRESSURE_SENSOR].result != POST_PASS) {
+        conclude(POST_CHECK_PUMP, POST_SKIPPED, FAULT_NONE, NAN, now);
+    }
+}
+
+void ChannelSelfTest::update(uint32_t now, bool aborted) {
+    if (aborted) {
+        heaterOn = false;
+        pumpOn = false;
+        for (uint8_t c = 0; c < POST_CHECK_COUNT; c++) {
+            conclude((PostCheck)c, POST_SKIPPED, FAULT_NONE, NAN, now);
+        }
+        return;
+    }
+
+    uint32_t elapsed = now - startMs;
+    if (!baselineDone) {
+        if (elapsed < POST_BASELINE_MS) {
+            return;
+        }
+        finishBaseline(now);
+    }
+    uint32_t active = elapsed - POST_BASELINE_MS;
+
+    // 加热脉冲：温升相对于基线趋势（冷却中的加热片不会因冷却而判失败）
+    if (outcomes[POST_CHECK_HEATER].result == POST_PENDING) {
+        float trend = restSlope < 0.0f ? restSlope * (lastTempMs - baselineMs) / 1000.0f : 0.0f;
+        float rise = lastTemp - (baselineTemp + trend);
+        if (rise >= POST_HEATER_MIN_RISE) {
+            conclude(POST_CHECK_HEATER, POST_PASS, FAULT_NONE, rise, now);
+        } else if (elapsed >= POST_BUDGET_MS) {
+            conclude(POST_CHECK_HEATER, POST_FAIL, FAULT_POST_HEATER_NO_RISE, rise, now);
+        }
+    }
+    heaterOn = outcomes[POST_CHECK_HEATER].result == POST_PENDING
+               && active < POST_HEATER_PULSE_MS && lastTemp < TEMP_TARGET_DEFAULT;
+
+    // 抽气脉冲
+    if (outcomes[POST_CHECK_PUMP].result == POST_PENDING) {
+        float rise = lastVacuum - baselineVacuum;
+        if (rise >= POST_PUMP_MIN_RISE) {
+            conclude(POST_CHECK_PUMP, POST_PASS, FAULT_NONE, rise, now);
+        } else if (elapsed >= POST_BUDGET_MS) {
+            conclude(POST_CHECK_PUMP, POST_FAIL, FAULT_POST_PUMP_NO_VACUUM, rise, now);
+        }
+    }
+    pumpOn = outcomes[POST_CHECK_PUMP].result == POST_PENDING && active < POST_PUMP_BURST_MS;
+}
+
+void ChannelSelfTest::conclude(PostCheck check, PostResult result, FaultCode fault, float value, uint32_t now) {
+    PostOutcome& o = outcomes[check];
+    if (o.result != POST_PENDING) {
+        return;
+    }
+    o.result = result;
+    o.fault = fault;
+    o.value = value;
+    o.elapsedMs = now - startMs;
+}
+
+bool ChannelSelfTest::done() const {
+    for (uint8_t c = 0; c < POST_CHECK_COUNT; c++) {
+        if (outcomes[c].result == POST_PENDING) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ChannelSelfTest::hasCriticalFailure() const {
+    for (uint8_t c = 0; c < POST_CHECK_COUNT; c++) {
+        if (outcomes[c].result == POST_FAIL && FaultLog::isCritical(outcomes[c].fault)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* postCheckName(PostCheck check) {
+    switch (check) {
+        case POST_CHECK_TEMP_SENSOR:     return "温度传感器";
+        case POST_CHECK_PRESSURE_SENSOR: return "压力传感器";
+        case POST_CHECK_HEATER:          return "加热脉冲";
+        case POST_CHECK_PUMP:            return "抽气脉冲";
+        default:                         return "?";
+    }
+}
+
+const char* postResultName(PostResult result) {
+    switch (result) {
+        case POST_PENDING: return "未完成";
+        case POST_PASS:    return "通过";
+        case POST_FAIL:    return "失败";
+        case POST_SKIPPED: return "跳过";
+        default:           return "?";
+    }
+}
@@ -0,0 +1,194 @@
+/**
+ * @file SystemStateMachine.cpp
+ * @brief 系统状态机实现 + 转移表不变量（编译期穷举检查）
+ */
+
+#include "SystemStateMachine.h"
+
+// ============ 转移表不变量 ============
+// 对 [模式][事件] 的每一项穷举检查，表被改坏时直接编译失败
+
+namespace {
+
+constexpr const TransitionTable& T = kTransitionTable;
+
+// 任意模式按下急停都进入锁存
+constexpr bool estopFromEveryMode() {
+    for (uint8_t m = 0; m < MODE_COUNT; m++) {
+        if (T.rule[m][EVT_ESTOP].to != MODE_ESTOP_LATCHED ||
+            T.rule[m][EVT_ESTOP].guard != GUARD_NONE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 锁存只能经（STOP已松开的）复位离开，且只回到待机
+constexpr bool latchOnlyLeavesByReset() {
+    for (uint8_t e = 0; e < EVT_COUNT; e++) {
+        const TransitionRule& r = T.rule[MODE_ESTOP_LATCHED][e];
+        if (e == EVT_RESET) {
+            if (r.to != MODE_IDLE || r.guard != GUARD_STOP_RELEASED) return false;
+        } else if (r.to != MODE_ESTOP_LATCHED) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 没有任何转移回到 Boot
+constexpr bool bootNeverReentered() {
+    for (uint8_t m = 0; m < MODE_COUNT; m++) {
+        for (uint8_t e = 0; e < EVT_COUNT; e++) {
+            if (m != MODE_BOOT && T.rule[m][e].to == MODE_BOOT) return false;
+        }
+    }
+    return true;
+}
+
+// 执行器开启的模式都会被故障事件关断
+constexpr bool faultStopsActuators() {
+    for (uint8_t m = 0; m < MODE_COUNT; m++) {
+        if ((kModePolicy[m].heating || kModePolicy[m].pump) &&
+            T.rule[m][EVT_FAULT].to != MODE_FAULT) {
+            return false;
+        }
+    }
+    return kModePolicy[MODE_FAULT].heating == false && kModePolicy[MODE_FAULT].pump == false &&
+           kModePolicy[MODE_ESTOP_LATCHED].heating == false &&
+           kModePolicy[MODE_ESTOP_LATCHED].pump == false;
+}
+
+// 从执行器全关的模式开启执行器，必须经过传感器守卫
+constexpr bool actuatorStartIsGuarded() {
+    for (uint8_t m = 0; m < MODE_COUNT; m++) {
+        bool off = !kModePolicy[m].heating && !kModePolicy[m].pump;
+        for (uint8_t e = 0; e < EVT_COUNT; e++) {
+            SystemMode to = T.rule[m][e].to;
+            bool on = kModePolicy[to].heating || kModePolicy[to].pump;
+            if (off && on && T.rule[m][e].guard != GUARD_SENSORS_OK) return false;
+        }
+    }
+    return true;
+}
+
+// 抽气前必须已经在加热（只能从预热/暂停进入抽气）
+constexpr bool pumpOnlyAfterHeating() {
+    for (uint8_t m = 0; m < MODE_COUNT; m++) {
+        for (uint8_t e = 0; e < EVT_COUNT; e++) {
+            SystemMode to = T.rule[m][e].to;
+            if (to != m && kModePolicy[to].pump && !kModePolicy[m].heating) return false;
+        }
+    }
+    return true;
+}
+
+// 每个模式都能经若干事件回到待机（不考虑守卫的可达性，不动点迭代）
+constexpr bool idleReachableFromEveryMode() {
+    bool reach[MODE_COUNT] = {};
+    reach[MODE_IDLE] = true;
+    for (uint8_t pass = 0; pass < MODE_COUNT; pass++) {
+        for (uint8_t m = 0; m < MODE_COUNT; m++) {
+            for (uint8_t e = 0; e < EVT_COUNT; e++) {
+                if (reach[T.rule[m][e].to]) reach[m] = true;
+            }
+        }
+    }
+    for (uint8_t m = 0; m < MODE_COUNT; m++) {
+        if (!reach[m]) return false;
+    }
+    return true;
+}
+
+static_assert(estopFromEveryMode(), "EVT_ESTOP must latch from every mode");
+static_assert(latchOnlyLeavesByReset(), "EStopLatched must only exit via guarded EVT_RESET to Idle");
+static_assert(bootNeverReentered(), "no transition may target MODE_BOOT");
+static_assert(faultStopsActuators(), "modes with actuators on must fall to MODE_FAULT on EVT_FAULT");
+static_assert(actuatorStartIsGuarded(), "enabling actuators requires GUARD_SENSORS_OK");
+static_assert(pumpOnlyAfterHeating(), "pump modes must be entered from a heating mode");
+static_assert(idleReachableFromEveryMode(), "every mode must be able to return to Idle");
+
+} // namespace
+
+// ============ 状态机 ============
+
+SystemStateMachine::SystemStateMachine()
+    : current(MODE_BOOT), enteredAt(0), totalTransitions(0), records{} {
+}
+
+bool SystemStateMachine::guardPasses(TransitionGuard guard, const SystemInputs& inputs) {
+    switch (guard) {
+        case GUARD_NONE:          return true;
+        case GUARD_STOP_RELEASED: return !inputs.stopPressed;
+        case GUARD_SENSORS_OK:    return inputs.sensorsOk && !inputs.allOverTemp && !inputs.boardOverTemp;
+    }
+    return false;
+}
+
+bool SystemStateMachine::dispatch(SystemEvent event, const SystemInputs& inputs, uint32_t now_ms) {
+    if (event >= EVT_COUNT) {
+        return false;
+    }
+
+    SystemMode from = current;
+    const TransitionRule& rule = kTransitionTable.rule[from][event];
+    if (rule.to == from || !guardPasses(rule.guard, inputs)) {
+        return false;
+    }
+
+    TransitionRecord& rec = records[totalTransitions % HISTORY_LEN];
+    rec.timestamp = now_ms;
+    rec.from = from;
+    rec.to = rule.to;
+    rec.event = event;
+    totalTransitions++;
+
+    enteredAt = now_ms;
+    current = rule.to;
+    return true;
+}
+
+uint8_t SystemStateMachine::historySize() const {
+    return totalTransitions < HISTORY_LEN ? (uint8_t)totalTransitions : HISTORY_LEN;
+}
+
+const TransitionRecord& SystemStateMachine::history(uint8_t age) const {
+    if (age >= historySize()) {
+        age = historySize() > 0 ? historySize() - 1 : 0;
+    }
+    return records[(totalTransitions - 1 - age) % HISTORY_LEN];
+}
+
+const char* SystemStateMachine::modeName(SystemMode mode) {
+    switch (mode) {
+        case MODE_BOOT:          return "Boot";
+        case MODE_IDLE:          return "Idle";
+        case MODE_WARMUP:        return "WarmUp";
+        case MODE_RUN:           return "Run";
+        case MODE_HOLD:          return "Hold";
+        case MODE_VENTING:       return "Venting";
+        case MODE_FAULT:         return "Fault";
+        case MODE_ESTOP_LATCHED: return "EStopLatched";
+        case MODE_COUNT:         break;
+    }
+    return "?";
+}
+
+const char* SystemStateMachine::eventName(SystemEvent event) {
+    switch (event) {
+        case EVT_BOOT_OK:       return "BOOT_OK";
+        case EVT_BOOT_FAIL:     return "BOOT_FAIL";
+        case EVT_START:         return "START";
+        case EVT_TEMP_REACHED:  return "TEMP_REACHED";
+        case EVT_PAUSE:         return "PAUSE";
+        case EVT_RESUME:        return "RESUME";
+        case EVT_STOP:          return "STOP";
+        case EVT_VENTED:        return "VENTED";
+        case EVT_FAULT:         return "FAULT";
+        case EVT_FAULT_CLEARED: return "FAULT_CLEARED";
+        case EVT_ESTOP:         return "ESTOP";
+        case EVT_RESET:         return "RESET";
+        case EVT_COUNT:         break;
+    }
+    return "?";
+}
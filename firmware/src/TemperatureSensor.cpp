@@ -5,32 +5,64 @@
 
 #include "TemperatureSensor.h"
 
-TemperatureSensor::TemperatureSensor(uint8_t sck_pin, uint8_t cs_pin, uint8_t miso_pin)
-    : lastTemp(0.0f), errorCount(0) {
-    thermocouple = new Adafruit_MAX31855(sck_pin, cs_pin, miso_pin);
+template <class Chip>
+ThermocoupleSensor<Chip>::ThermocoupleSensor(uint8_t sck_pin, uint8_t cs_pin, uint8_t miso_pin)
+    : sckPin(sck_pin), csPin(cs_pin), misoPin(miso_pin),
+      lastFrame(0), lastFrameTime(0), hasFrame(false),
+      lastReading{NAN, NAN, NAN, THERMO_FAULT_NONE}, lastTemp(0.0f), errorCount(0), fresh(false) {
 }
 
-bool TemperatureSensor::begin() {
-    delay(500); // MAX31855需要启动时间
+template <class Chip>
+bool ThermocoupleSensor<Chip>::begin() {
+    pinMode(csPin, OUTPUT);
+    pinMode(sckPin, OUTPUT);
+    pinMode(misoPin, INPUT);
+    digitalWrite(csPin, HIGH);
+    
+    delay(Chip::POWER_UP_TIME_MS); // 上电后等待第一次转换完成
     
     // 尝试读取一次测试
-    float temp = thermocouple->readCelsius();
-    if (isnan(temp)) {
-        Serial.println("Temperature sensor initialization failed!");
+    acquire();
+    if (lastReading.fault != THERMO_FAULT_NONE) {
+        Serial.printf("Temperature sensor (%s) initialization failed: %s\n",
+                      Chip::name(), thermoFaultName(lastReading.fault));
+        return false;
+    }
+    
+    lastTemp = lastReading.hotJunction;
+    fresh = true;
+    Serial.printf("Temperature sensor (%s) initialized successfully, current temperature: %.2f°C\n",
+                  Chip::name(), lastTemp);
+    return true;
+}
+
+template <class Chip>
+bool ThermocoupleSensor<Chip>::acquire() {
+    uint32_t now = millis();
+    
+    // 转换未完成：返回缓存，不能拉低CS
+    if (hasFrame && (now - lastFrameTime) < Chip::CONVERSION_TIME_MS) {
         return false;
     }
     
-    lastTemp = temp;
-    Serial.printf("Temperature sensor initialized successfully, current temperature: %.2f°C\n", temp);
+    lastFrame = thermoReadFrame(sckPin, csPin, misoPin, Chip::FRAME_BITS);
+    lastFrameTime = millis();
+    hasFrame = true;
+    lastReading = Chip::decode(lastFrame);
     return true;
 }
 
-float TemperatureSensor::readTemperature() {
-    float temp = thermocouple->readCelsius();
+template <class Chip>
+float ThermocoupleSensor<Chip>::readTemperature() {
+    if (!acquire()) {
+        fresh = false;    // 转换间隔内，沿用上次结果（不是新读数，控制任务不据此刷新输出）
+        return lastTemp;
+    }
     
-    if (isnan(temp)) {
+    if (lastReading.fault != THERMO_FAULT_NONE) {
         errorCount++;
-        Serial.println("Temperature read error!");
+        fresh = false;
+        Serial.printf("Temperature read error: %s\n", thermoFaultName(lastReading.fault));
         
         // 如果连续多次错误，返回NAN
         if (errorCount >= MAX_ERROR_COUNT) {
@@ -41,14 +73,31 @@ float TemperatureSensor::readTemperature() {
     }
     
     errorCount = 0;
-    lastTemp = temp;
-    return temp;
+    lastTemp = lastReading.hotJunction;
+    fresh = true;
+    return lastTemp;
 }
 
-float TemperatureSensor::readInternalTemperature() {
-    return thermocouple->readInternal();
+template <class Chip>
+float ThermocoupleSensor<Chip>::readInternalTemperature() {
+    if (!Chip::HAS_COLD_JUNCTION) {
+        return NAN;
+    }
+    acquire();
+    return lastReading.coldJunction;
 }
 
-bool TemperatureSensor::isValid() {
+template <class Chip>
+uint32_t ThermocoupleSensor<Chip>::readRawFrame() {
+    acquire();
+    return lastFrame;
+}
+
+template <class Chip>
+bool ThermocoupleSensor<Chip>::isValid() {
     return (errorCount < MAX_ERROR_COUNT) && !isnan(lastTemp);
 }
+
+// 显式实例化支持的前端芯片
+template class ThermocoupleSensor<MAX31855Chip>;
+template class ThermocoupleSensor<MAX6675Chip>;
@@ -0,0 +1,131 @@
+/**
+ * @file ThermalIdentifier.cpp
+ * @brief 加热片热模型辨识实现
+ */
+
+#include "ThermalIdentifier.h"
+#include "config.h"
+#include <Preferences.h>
+
+static const char* NVS_NAMESPACE = "thermal";
+
+// 变化率是最近 TEMP_RATE_WINDOW 个样本的拟合斜率，对应窗口中点的时刻
+static constexpr float RATE_DELAY_S = (TEMP_RATE_WINDOW - 1) * TEMP_SAMPLE_PERIOD_MS / 2000.0f;
+
+ThermalIdentifier::ThermalIdentifier()
+    : channelIndex(0), learnedConductance(THERMAL_G_DEFAULT), conductance(THERMAL_G_DEFAULT),
+      identifying(false), startTime(0), sampleOutput(0),
+      n(0), sumX(0.0f), sumY(0.0f), sumXX(0.0f), sumXY(0.0f), minX(0.0f), maxX(0.0f) {
+}
+
+void ThermalIdentifier::begin(uint8_t channel) {
+    channelIndex = channel;
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true)) {
+        return;  // 尚无记录
+    }
+    char key[8];
+    snprintf(key, sizeof(key), "g%u", channelIndex);
+    float g = prefs.getFloat(key, NAN);
+    prefs.end();
+
+    if (!isnan(g) && g >= THERMAL_G_MIN && g <= THERMAL_G_MAX) {
+        learnedConductance = g;
+    }
+    conductance = learnedConductance;
+    Serial.printf("Thermal model (channel %u): G=%.2f PWM/C\n", channelIndex, learnedConductance);
+}
+
+void ThermalIdentifier::start(uint32_t now_ms) {
+    identifying = true;
+    startTime = now_ms;
+    sampleOutput = 0;
+    n = 0;
+    sumX = sumY = sumXX = sumXY = 0.0f;
+    minX = maxX = 0.0f;
+    conductance = learnedConductance;
+}
+
+void ThermalIdentifier::addSample(float temp, float rate, float ambient, uint8_t output, uint32_t now_ms) {
+    if (!identifying || isnan(rate) || isnan(ambient)) {
+        return;
+    }
+    // 跳过开头：变化率窗口还包含加热开启前的样本，加热丝本身也在升温
+    if (now_ms - startTime < THERMAL_ID_SKIP_MS) {
+        return;
+    }
+    if (n == 0) {
+        sampleOutput = output;
+    } else if (output != sampleOutput) {
+        identifying = false;    // 输出变了，模型不成立
+        return;
+    }
+
+    // 变化率对应窗口中点，温差也取中点时刻的值
+    float x = temp - rate * RATE_DELAY_S - ambient;
+    if (n == 0 || x < minX) minX = x;
+    if (n == 0 || x > maxX) maxX = x;
+    sumX += x;
+    sumY += rate;
+    sumXX += x * x;
+    sumXY += x * rate;
+    n++;
+}
+
+bool ThermalIdentifier::finish() {
+    if (!identifying) {
+        return false;
+    }
+    identifying = false;
+
+    if (n < THERMAL_ID_MIN_SAMPLES || maxX - minX < THERMAL_ID_MIN_SPAN) {
+        return false;
+    }
+    float denom = n * sumXX - sumX * sumX;
+    if (denom <= 0.0f) {
+        return false;
+    }
+    float slope = (n * sumXY - sumX * sumY) / denom;    // -G/K
+    float intercept = (sumY - slope * sumX) / n;        // u/K
+    if (slope >= 0.0f || intercept <= 0.0f) {
+        return false;
+    }
+
+    float g = sampleOutput * -slope / intercept;
+    if (g < THERMAL_G_MIN || g > THERMAL_G_MAX) {
+        return false;
+    }
+    conductance = g;
+    return true;
+}
+
+void ThermalIdentifier::learnSteadyState(float output, float target, float ambient) {
+    if (isnan(ambient) || target - ambient < THERMAL_LEARN_MIN_DELTA) {
+        return;     // 温差太小，除法误差大
+    }
+    float g = output / (target - ambient);
+    if (g < THERMAL_G_MIN || g > THERMAL_G_MAX) {
+        return;
+    }
+    learnedConductance += WARMUP_LEARN_GAIN * (g - learnedConductance);
+    save();
+}
+
+float ThermalIdentifier::holdingOutput(float target, float ambient) const {
+    float u = conductance * (target - ambient);
+    if (u < 0.0f) u = 0.0f;
+    if (u > 255.0f) u = 255.0f;
+    return u;
+}
+
+void ThermalIdentifier::save() {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        return;
+    }
+    char key[8];
+    snprintf(key, sizeof(key), "g%u", channelIndex);
+    prefs.putFloat(key, learnedConductance);
+    prefs.end();
+}
@@ -0,0 +1,103 @@
+/**
+ * @file ThermocoupleChip.cpp
+ * @brief MAX31855 / MAX6675 帧解码与软件SPI
+ */
+
+#include "ThermocoupleChip.h"
+#include "config.h"
+#include "KTypeThermocouple.h"
+#include "HotPath.h"
+
+ThermoReading HOT_PATH MAX31855Chip::decode(uint32_t frame) {
+    ThermoReading r = { NAN, NAN, NAN, THERMO_FAULT_NONE };
+    
+    // 全0/全1或保留位非0：MISO悬空或芯片未接
+    if (frame == 0x00000000 || frame == 0xFFFFFFFF || (frame & 0x00020008)) {
+        r.fault = THERMO_FAULT_BUS;
+        return r;
+    }
+    
+    // 冷端温度：D15-D4，12位有符号，0.0625°C/LSB
+    int16_t internal = (int16_t)((frame >> 4) & 0x0FFF);
+    if (internal & 0x0800) {
+        internal |= (int16_t)0xF000;
+    }
+    r.coldJunction = internal * 0.0625f;
+    
+    if (frame & 0x00010000) {
+        if (frame & 0x01) {
+            r.fault = THERMO_FAULT_OPEN;
+        } else if (frame & 0x02) {
+            r.fault = THERMO_FAULT_SHORT_GND;
+        } else {
+            r.fault = THERMO_FAULT_SHORT_VCC;
+        }
+        return r;
+    }
+    
+    // 热端温度：D31-D18，14位有符号，0.25°C/LSB
+    int16_t hot = (int16_t)((frame >> 18) & 0x3FFF);
+    if (hot & 0x2000) {
+        hot |= (int16_t)0xC000;
+    }
+    r.linearHotJunction = hot * 0.25f;
+#if THERMO_NIST_LINEARIZATION
+    r.hotJunction = KTypeThermocouple::linearize(hot, internal);
+#else
+    r.hotJunction = r.linearHotJunction;
+#endif
+    return r;
+}
+
+ThermoReading HOT_PATH MAX6675Chip::decode(uint32_t frame) {
+    ThermoReading r = { NAN, NAN, NAN, THERMO_FAULT_NONE };
+    uint16_t word = (uint16_t)frame;
+    
+    // 全0/全1：MISO悬空或芯片未接（全0即0°C且未开路，与MAX31855一样按总线错误处理）
+    // D15 和 D1（器件ID）恒为0，否则为总线错误
+    if (word == 0x0000 || word == 0xFFFF || (word & 0x8002)) {
+        r.fault = THERMO_FAULT_BUS;
+        return r;
+    }
+    
+    if (word & 0x0004) {
+        r.fault = THERMO_FAULT_OPEN;
+        return r;
+    }
+    
+    // D14-D3，12位无符号，0.25°C/LSB
+    // 无冷端输出，无法重建热电偶电压，只能使用芯片的线性结果
+    r.hotJunction = ((word >> 3) & 0x0FFF) * 0.25f;
+    r.linearHotJunction = r.hotJunction;
+    return r;
+}
+
+uint32_t HOT_PATH thermoReadFrame(uint8_t sck_pin, uint8_t cs_pin, uint8_t miso_pin, uint8_t bits) {
+    uint32_t frame = 0;
+    
+    digitalWrite(sck_pin, LOW);
+    digitalWrite(cs_pin, LOW);      // 拉低CS：停止转换并锁存结果
+    delayMicroseconds(1);
+    
+    for (uint8_t i = 0; i < bits; i++) {
+        digitalWrite(sck_pin, HIGH);
+        delayMicroseconds(1);
+        frame = (frame << 1) | (digitalRead(miso_pin) ? 1 : 0);
+        digitalWrite(sck_pin, LOW);
+        delayMicroseconds(1);
+    }
+    
+    digitalWrite(cs_pin, HIGH);     // 拉高CS：开始新一次转换
+    return frame;
+}
+
+const char* thermoFaultName(ThermoFault fault) {
+    switch (fault) {
+        case THERMO_FAULT_NONE:      return "none";
+        case THERMO_FAULT_OPEN:      return "open circuit";
+        case THERMO_FAULT_SHORT_GND: return "short to GND";
+        case THERMO_FAULT_SHORT_VCC: return "short to VCC";
+        case THERMO_FAULT_BUS:       return "SPI bus error";
+    }
+    return "unknown";
+}
@@ -0,0 +1,159 @@
+/**
+ * @file WarmUpController.cpp
+ * @brief 最短时间预热实现
+ */
+
+#include "WarmUpController.h"
+#include <Preferences.h>
+
+static const char* NVS_NAMESPACE = "warmup";
+
+WarmUpController::WarmUpController()
+    : phase(PHASE_IDLE), channelIndex(0), lagSeconds(WARMUP_LAG_DEFAULT_S),
+      startTime(0), switchTime(0), handoffTime(0), startTemp(0.0f), switchTemp(0.0f),
+      switchRate(0.0f), peakTemp(0.0f), coastPeak(0.0f), timeToSetpoint(NAN), outputSum(0.0f), outputCount(0), identified(false), reportReady(false),
+      report{NAN, 0.0f, 0.0f, WARMUP_LAG_DEFAULT_S, 0.0f, THERMAL_G_DEFAULT, false} {
+}
+
+void WarmUpController::begin(uint8_t channel) {
+    channelIndex = channel;
+    thermal.begin(channel);
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true)) {
+        return;  // 尚无记录
+    }
+    char key[8];
+    snprintf(key, sizeof(key), "lag%u", channelIndex);
+    float lag = prefs.getFloat(key, NAN);
+    prefs.end();
+
+    if (!isnan(lag) && lag >= 0.0f && lag <= WARMUP_LAG_MAX_S) {
+        lagSeconds = lag;
+    }
+    Serial.printf("Warm-up (channel %u): lag %.1fs\n", channelIndex, lagSeconds);
+}
+
+void WarmUpController::start(float temp, uint32_t now_ms) {
+    phase = PHASE_BOOST;
+    startTime = now_ms;
+    startTemp = temp;
+    peakTemp = temp;
+    coastPeak = temp;
+    timeToSetpoint = NAN;
+    outputSum = 0.0f;
+    outputCount = 0;
+    identified = false;
+    thermal.start(now_ms);
+}
+
+void WarmUpController::cancel() {
+    phase = PHASE_IDLE;
+    thermal.finish();
+}
+
+WarmUpAction WarmUpController::update(float temp, float rate, float target, float ambient,
+                                      float output, uint32_t now_ms) {
+    if (phase == PHASE_IDLE) {
+        return WARMUP_PID;
+    }
+
+    if (isnan(timeToSetpoint) && temp >= target - TEMP_HYSTERESIS) {
+        timeToSetpoint = (now_ms - startTime) / 1000.0f;
+    }
+
+    if (phase == PHASE_BOOST) {
+        float r = (isnan(rate) || rate < 0.0f) ? 0.0f : rate;
+        // 预测断开全功率后的温度：T + τ * dT/dt
+        if (temp + lagSeconds * r < target) {
+            // 全功率期间输出恒定，同时辨识热导
+            thermal.addSample(temp, rate, ambient, 255, now_ms);
+            return WARMUP_FULL_POWER;
+        }
+        identified = thermal.finish();
+        switchTime = now_ms;
+        switchTemp = temp;
+        switchRate = r;
+        peakTemp = temp;
+        phase = PHASE_COAST;
+    }
+
+    if (temp > peakTemp) {
+        peakTemp = temp;
+    }
+
+    if (phase == PHASE_COAST) {
+        // 维持功率下滑行到不再上升为止，此时的峰值只取决于切换点，与PID无关；
+        // 超过目标+回差则提前交给PID，避免过冲继续扩大
+        bool stalled = !isnan(rate) && rate <= 0.0f;
+        if (stalled || temp >= target + TEMP_HYSTERESIS ||
+            now_ms - switchTime >= WARMUP_OBSERVE_MS) {
+            coastPeak = peakTemp;
+            handoffTime = now_ms;
+            phase = PHASE_OBSERVE;
+            return WARMUP_HANDOFF;
+        }
+        return WARMUP_COAST;
+    }
+
+    // PHASE_OBSERVE：窗口末段已接近稳态，平均输出即维持功率
+    uint32_t elapsed = now_ms - handoffTime;
+    if (elapsed >= WARMUP_OBSERVE_MS * 2 / 3) {
+        outputSum += output;
+        outputCount++;
+    }
+    if (elapsed >= WARMUP_OBSERVE_MS) {
+        finish(target, ambient);
+    }
+    return WARMUP_PID;
+}
+
+void WarmUpController::finish(float target, float ambient) {
+    phase = PHASE_IDLE;
+
+    float overshoot = peakTemp - target;
+    float coastError = coastPeak - target;
+
+    // 只有真正全功率升温过的预热才用于学习（已接近目标时的重新加热不算）
+    if (switchTemp - startTemp >= WARMUP_MIN_RISE && switchRate > 0.0f) {
+        // 滑行峰值超出目标 e，切换点应提前 e，即 τ 增加 e / 切换时的升温速率；
+        // 停在目标以下则 e 为负，推迟切换
+        lagSeconds += WARMUP_LEARN_GAIN * coastError / switchRate;
+        if (lagSeconds < 0.0f) lagSeconds = 0.0f;
+        if (lagSeconds > WARMUP_LAG_MAX_S) lagSeconds = WARMUP_LAG_MAX_S;
+
+        if (outputCount > 0 && fabsf(overshoot) < WARMUP_HOLD_LEARN_BAND) {
+            thermal.learnSteadyState(outputSum / outputCount, target, ambient);
+        }
+        save();
+    }
+
+    report.timeToSetpoint = timeToSetpoint;
+    report.overshoot = overshoot;
+    report.switchTemp = switchTemp;
+    report.lagSeconds = lagSeconds;
+    report.holdingOutput = outputCount > 0 ? outputSum / outputCount : NAN;
+    report.conductance = thermal.getConductance();
+    report.identified = identified;
+    reportReady = true;
+}
+
+bool WarmUpController::takeReport(WarmUpReport& out) {
+    if (!reportReady) {
+        return false;
+    }
+    out = report;
+    reportReady = false;
+    return true;
+}
+
+void WarmUpController::save() {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        return;
+    }
+    char key[8];
+    snprintf(key, sizeof(key), "lag%u", channelIndex);
+    prefs.putFloat(key, lagSeconds);
+    prefs.end();
+}
@@ -0,0 +1,257 @@
+/**
+ * @file WearHistory.cpp
+ * @brief 泵/密封磨损趋势实现
+ */
+
+#include "WearHistory.h"
+#include <Preferences.h>
+
+static const char* NVS_NAMESPACE = "wear";
+static const uint8_t STORED_VERSION = 1;
+
+/**
+ * @brief NVS中的存储格式（版本或长度不符时视为无记录）
+ */
+struct WearHistory::Stored {
+    uint8_t version;
+    uint8_t head;
+    uint8_t used;
+    uint8_t maintFlags;
+    uint16_t sessions;
+    uint16_t reserved;
+    Baseline baseline;
+    WearFingerprint ring[WEAR_HISTORY_LEN];
+};
+
+WearHistory::WearHistory()
+    : head(0), used(0), sessions(0), maintFlags(0), channelIndex(0) {
+    memset(ring, 0, sizeof(ring));
+    memset(&baseline, 0, sizeof(baseline));
+}
+
+void WearHistory::begin(uint8_t channel) {
+    channelIndex = channel;
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true)) {
+        return;  // 尚无记录
+    }
+    char key[8];
+    snprintf(key, sizeof(key), "hist%u", channelIndex);
+    static Stored stored;   // 近1KB，不放在任务栈上（加载在setup中，保存只在压力任务中）
+    if (prefs.getBytesLength(key) == sizeof(stored)
+            && prefs.getBytes(key, &stored, sizeof(stored)) == sizeof(stored)
+            && stored.version == STORED_VERSION
+            && stored.head < WEAR_HISTORY_LEN && stored.used <= WEAR_HISTORY_LEN) {
+        head = stored.head;
+        used = stored.used;
+        maintFlags = stored.maintFlags;
+        sessions = stored.sessions;
+        baseline = stored.baseline;
+        memcpy(ring, stored.ring, sizeof(ring));
+        Serial.printf("Wear history loaded (channel %u): %u session(s), flags 0x%02X\n",
+                      channelIndex, sessions, maintFlags);
+    }
+    prefs.end();
+}
+
+const WearFingerprint& WearHistory::get(uint8_t age) const {
+    if (age >= used) {
+        age = used > 0 ? used - 1 : 0;
+    }
+    return ring[(head + WEAR_HISTORY_LEN - 1 - age) % WEAR_HISTORY_LEN];
+}
+
+void WearHistory::learnBaseline(const WearFingerprint& fp) {
+    // 前 WEAR_BASELINE_SESSIONS 次有效测量的滑动平均，之后冻结
+    for (uint8_t g = 0; g < PRESSURE_NUM_GEARS; g++) {
+        if (fp.holdDuty[g] > 0 && baseline.holdCount[g] < WEAR_BASELINE_SESSIONS) {
+            uint8_t n = ++baseline.holdCount[g];
+            baseline.holdDuty[g] += (fp.holdDuty[g] - baseline.holdDuty[g]) / n;
+        }
+    }
+    if (fp.pullDownGear > 0) {
+        uint8_t g = fp.pullDownGear - 1;
+        if (baseline.pullCount[g] < WEAR_BASELINE_SESSIONS) {
+            uint8_t n = ++baseline.pullCount[g];
+            baseline.pullDown[g] += (fp.pullDownDs - baseline.pullDown[g]) / n;
+        }
+    }
+    if (!isnan(fp.leakRate) && baseline.leakCount < WEAR_BASELINE_SESSIONS) {
+        uint8_t n = ++baseline.leakCount;
+        baseline.leakRate += (fp.leakRate - baseline.leakRate) / n;
+    }
+}
+
+bool WearHistory::sealRatio(const WearFingerprint& fp, float& ratio) const {
+    if (isnan(fp.leakRate) || baseline.leakCount < WEAR_BASELINE_SESSIONS || baseline.leakRate <= 0.0f) {
+        return false;
+    }
+    ratio = fp.leakRate / baseline.leakRate;
+    return true;
+}
+
+bool WearHistory::pumpRatio(const WearFingerprint& fp, float& ratio) const {
+    float sum = 0.0f;
+    uint8_t n = 0;
+    for (uint8_t g = 0; g < PRESSURE_NUM_GEARS; g++) {
+        if (fp.holdDuty[g] > 0 && baseline.holdCount[g] >= WEAR_BASELINE_SESSIONS) {
+            sum += fp.holdDuty[g] / baseline.holdDuty[g];
+            n++;
+        }
+    }
+    if (n == 0) {
+        return false;
+    }
+    // 维持泵速随泄漏率成正比上升，本次没有测到泄漏率时无法扣除，不计入
+    float seal;
+    if (!sealRatio(fp, seal)) {
+        return false;
+    }
+    ratio = sum / n / seal;
+    return true;
+}
+
+bool WearHistory::pullDownRatio(const WearFingerprint& fp, float& ratio) const {
+    if (fp.pullDownGear == 0 || baseline.pullCount[fp.pullDownGear - 1] < WEAR_BASELINE_SESSIONS) {
+        return false;
+    }
+    ratio = fp.pullDownDs / baseline.pullDown[fp.pullDownGear - 1];
+    return true;
+}
+
+/**
+ * @brief 中位数（原地插入排序，n 很小）
+ */
+static float median(float* v, uint8_t n) {
+    for (uint8_t i = 1; i < n; i++) {
+        float key = v[i];
+        int8_t j = i - 1;
+        while (j >= 0 && v[j] > key) {
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = key;
+    }
+    return (n & 1) ? v[n / 2] : 0.5f * (v[n / 2 - 1] + v[n / 2]);
+}
+
+template <class RatioFn>
+WearMetricTrend WearHistory::fit(RatioFn ratio, float limit) const {
+    WearMetricTrend t = { 0, NAN, NAN, NAN };
+
+    // x = 相对最近一次疗程的序号（<= 0）
+    float xs[WEAR_TREND_WINDOW];
+    float ys[WEAR_TREND_WINDOW];
+    uint16_t newest = used > 0 ? get(0).session : 0;
+    for (uint8_t age = 0; age < used && t.points < WEAR_TREND_WINDOW; age++) {
+        const WearFingerprint& fp = get(age);
+        float y;
+        if (!ratio(fp, y)) {
+            continue;
+        }
+        xs[t.points] = (int16_t)(fp.session - newest);
+        ys[t.points] = y;
+        t.points++;
+    }
+    if (t.points == 0) {
+        return t;
+    }
+
+    // Theil-Sen：斜率取两两斜率的中位数，截距取残差的中位数。
+    // 单次异常疗程（如中途摘下眼镜）不会把拟合值拉过限值
+    float slopes[WEAR_TREND_WINDOW * (WEAR_TREND_WINDOW - 1) / 2];
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < t.points; i++) {
+        for (uint8_t j = i + 1; j < t.points; j++) {
+            slopes[n++] = (ys[i] - ys[j]) / (xs[i] - xs[j]);
+        }
+    }
+    t.slope = n > 0 ? median(slopes, n) : 0.0f;
+    for (uint8_t i = 0; i < t.points; i++) {
+        ys[i] -= t.slope * xs[i];
+    }
+    t.level = median(ys, t.points);  // 拟合线在最近一次疗程（x = 0）处的值
+
+    if (t.level >= limit) {
+        t.sessionsToLimit = 0.0f;
+    } else if (t.slope > 0.0f) {
+        t.sessionsToLimit = (limit - t.level) / t.slope;
+    }
+    return t;
+}
+
+void WearHistory::evaluate(WearReport& report) const {
+    report.seal = fit([this](const WearFingerprint& fp, float& r) { return sealRatio(fp, r); },
+                      WEAR_SEAL_LIMIT);
+    report.pump = fit([this](const WearFingerprint& fp, float& r) { return pumpRatio(fp, r); },
+                      WEAR_PUMP_LIMIT);
+    report.pullDown = fit([this](const WearFingerprint& fp, float& r) { return pullDownRatio(fp, r); },
+                          WEAR_PULLDOWN_LIMIT);
+
+    uint8_t flags = 0;
+    if ((report.pump.points >= WEAR_TREND_MIN_POINTS && report.pump.level > WEAR_PUMP_LIMIT)
+            || (report.pullDown.points >= WEAR_TREND_MIN_POINTS && report.pullDown.level > WEAR_PULLDOWN_LIMIT)) {
+        flags |= WEAR_FLAG_PUMP;
+    }
+    if (report.seal.points >= WEAR_TREND_MIN_POINTS && report.seal.level > WEAR_SEAL_LIMIT) {
+        flags |= WEAR_FLAG_SEAL;
+    }
+    report.newFlags = flags & ~maintFlags;
+    report.flags = flags | maintFlags;
+
+    bool holdReady = false;
+    bool pullReady = false;
+    for (uint8_t g = 0; g < PRESSURE_NUM_GEARS; g++) {
+        holdReady = holdReady || baseline.holdCount[g] >= WEAR_BASELINE_SESSIONS;
+        pullReady = pullReady || baseline.pullCount[g] >= WEAR_BASELINE_SESSIONS;
+    }
+    report.baselineReady = holdReady && pullReady && baseline.leakCount >= WEAR_BASELINE_SESSIONS;
+}
+
+void WearHistory::add(const WearFingerprint& fp, WearReport& report) {
+    WearFingerprint entry = fp;
+    entry.session = ++sessions;
+    learnBaseline(entry);
+
+    ring[head] = entry;
+    head = (uint8_t)((head + 1) % WEAR_HISTORY_LEN);
+    if (used < WEAR_HISTORY_LEN) {
+        used++;
+    }
+
+    report.fingerprint = entry;
+    evaluate(report);
+    maintFlags = report.flags;
+    save();
+}
+
+void WearHistory::rebaseline() {
+    head = 0;
+    used = 0;
+    maintFlags = 0;
+    memset(ring, 0, sizeof(ring));
+    memset(&baseline, 0, sizeof(baseline));
+    save();
+}
+
+void WearHistory::save() {
+    static Stored stored;
+    memset(&stored, 0, sizeof(stored));
+    stored.version = STORED_VERSION;
+    stored.head = head;
+    stored.used = used;
+    stored.maintFlags = maintFlags;
+    stored.sessions = sessions;
+    stored.baseline = baseline;
+    memcpy(stored.ring, ring, sizeof(ring));
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        return;
+    }
+    char key[8];
+    snprintf(key, sizeof(key), "hist%u", channelIndex);
+    prefs.putBytes(key, &stored, sizeof(stored));
+    prefs.end();
+}
@@ -0,0 +1,144 @@
+/**
+ * @file WearTracker.cpp
+ * @brief 单次疗程指纹采集实现
+ */
+
+#include "WearTracker.h"
+
+WearTracker::WearTracker()
+    : active(false), lastMs(0), lastPumpRunning(false), lastTarget(NAN),
+      pullStartMs(0), pullDownDs(0), pullDownGear(0), holdSince(0),
+      decaying(false), decayStartMs(0), decayLastMs(0), decayPad0(NAN), decayU0(0.0f),
+      decayLastV(0.0f), decayIntegral(0.0f), sumXX(0.0f), sumXY(0.0f), decayCount(0),
+      leakWeighted(0.0f), leakSeconds(0.0f) {
+    for (uint8_t g = 0; g < PRESSURE_NUM_GEARS; g++) {
+        holdDutyMs[g] = 0.0f;
+        holdMs[g] = 0;
+    }
+}
+
+uint8_t WearTracker::gearOf(float target) {
+    long gear = lroundf(target * PRESSURE_NUM_GEARS / PRESSURE_TARGET_DEFAULT);
+    if (gear < 1) return 1;
+    if (gear > PRESSURE_NUM_GEARS) return PRESSURE_NUM_GEARS;
+    return (uint8_t)gear;
+}
+
+void WearTracker::beginSession(uint32_t now) {
+    *this = WearTracker();
+    active = true;
+    lastMs = now;
+}
+
+void WearTracker::observe(uint32_t now, bool pumpRunning, uint8_t speed, float target, float vacuum,
+                          float padTemp) {
+    if (!active || isnan(vacuum)) {
+        return;
+    }
+    uint32_t dt = now - lastMs;
+    bool targetChanged = target != lastTarget;
+
+    // 抽气用时：泵从接近大气压启动时开始计时，改档或泵停止则放弃本次
+    if (pumpRunning && !lastPumpRunning && pullDownGear == 0 && vacuum < 0.25f * target) {
+        pullStartMs = now;
+    } else if (pullStartMs != 0 && (!pumpRunning || targetChanged)) {
+        pullStartMs = 0;
+    }
+    if (pullStartMs != 0 && vacuum >= WEAR_PULLDOWN_FRACTION * target) {
+        uint32_t ds = (now - pullStartMs + 50) / 100;
+        pullDownDs = (uint16_t)(ds > 0xFFFF ? 0xFFFF : (ds > 0 ? ds : 1));
+        pullDownGear = gearOf(target);
+        pullStartMs = 0;
+    }
+
+    // 维持泵速：在维持带内稳定 WEAR_HOLD_SETTLE_MS 后按时间加权累计
+    bool holding = pumpRunning && lastPumpRunning && !targetChanged
+                   && fabsf(target - vacuum) < WEAR_HOLD_BAND;
+    if (!holding) {
+        holdSince = 0;
+    } else if (holdSince == 0) {
+        holdSince = now;
+    } else if (now - holdSince >= WEAR_HOLD_SETTLE_MS && dt < 1000) {
+        uint8_t g = gearOf(target) - 1;
+        holdDutyMs[g] += (float)speed * dt;
+        holdMs[g] += dt;
+    }
+
+    // 泵停止后的衰减（加热片样本过期时无法扣除气体定律项，本段作废）
+    if (decaying && isnan(padTemp)) {
+        decaying = false;
+    }
+    if (decaying && (pumpRunning || vacuum <= WEAR_LEAK_MIN_VACUUM)) {
+        finishDecay();
+    }
+    if (!pumpRunning && lastPumpRunning && vacuum > WEAR_LEAK_MIN_VACUUM && !isnan(padTemp)) {
+        decaying = true;
+        decayStartMs = now;
+        decayLastMs = now;
+        decayPad0 = padTemp;
+        decayU0 = vacuum;
+        decayLastV = vacuum;
+        decayIntegral = 0.0f;
+        sumXX = sumXY = 0.0f;
+        decayCount = 0;
+    } else if (decaying) {
+        float absPressure = PRESSURE_ATM_MMHG - vacuum;
+        float u = vacuum + absPressure / (padTemp + 273.15f) * PRESSURE_FF_COUPLING * (padTemp - decayPad0);
+        decayIntegral += 0.5f * (vacuum + decayLastV) * (now - decayLastMs) / 1000.0f;
+        float y = decayU0 - u;
+        sumXX += decayIntegral * decayIntegral;
+        sumXY += decayIntegral * y;
+        decayCount++;
+        decayLastMs = now;
+        decayLastV = vacuum;
+    }
+
+    lastMs = now;
+    lastPumpRunning = pumpRunning;
+    lastTarget = target;
+}
+
+void WearTracker::finishDecay() {
+    decaying = false;
+    float seconds = (decayLastMs - decayStartMs) / 1000.0f;
+    if (decayCount < 3 || seconds * 1000.0f < WEAR_LEAK_MIN_MS) {
+        return;
+    }
+    if (sumXX <= 0.0f) {
+        return;
+    }
+    float k = sumXY / sumXX;
+    if (k <= 0.0f) {
+        return;  // 扣除温度影响后负压仍不降，本段无效
+    }
+    leakWeighted += k * seconds;
+    leakSeconds += seconds;
+}
+
+bool WearTracker::endSession(WearFingerprint& out) {
+    if (!active) {
+        return false;
+    }
+    if (decaying) {
+        finishDecay();
+    }
+    active = false;
+
+    bool any = false;
+    out.session = 0;
+    out.pullDownDs = pullDownDs;
+    out.pullDownGear = pullDownGear;
+    out.reserved = 0;
+    any = any || pullDownGear != 0;
+    for (uint8_t g = 0; g < PRESSURE_NUM_GEARS; g++) {
+        out.holdDuty[g] = 0;
+        if (holdMs[g] >= WEAR_HOLD_MIN_MS) {
+            long duty = lroundf(holdDutyMs[g] / holdMs[g] * 100.0f);
+            out.holdDuty[g] = (uint16_t)(duty < 1 ? 1 : duty);
+            any = true;
+        }
+    }
+    out.leakRate = leakSeconds > 0.0f ? leakWeighted / leakSeconds : NAN;
+    any = any || !isnan(out.leakRate);
+    return any;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file XGZP6897DSensor.cpp
+ * @brief XGZP6897D 压力传感器实现
+ * 
+ * 单次模式:
+ * 1. 向0x30写入0x0A（SCO + 组合转换）
+ * 2. 等待转换时间（由OSR决定）或轮询0x30的SCO位
+ * 3. 从0x06-0x0A读取压力(24位)和温度(16位)
+ * 
+ * 周期模式:
+ * 传感器按休眠时间自行转换，直接读取0x06-0x0A的最新结果
+ */
+
+#include "XGZP6897DSensor.h"
+#include "config.h"
+
+XGZP6897DSensor::XGZP6897DSensor(uint8_t sda_pin, uint8_t scl_pin, uint8_t i2c_addr, uint16_t k_factor)
+    : PressureSensorBase<XGZP6897DSensor>(sda_pin, scl_pin, i2c_addr ? i2c_addr : DEFAULT_ADDR),
+      kFactor(k_factor), oversampling((XGZPOversampling)XGZP6897D_OSR),
+      mode(XGZP_MODE_SINGLE_SHOT), periodCode(1), lastSensorTemp(NAN) {
+}
+
+bool XGZP6897DSensor::configure() {
+    return applyOversampling() && applyMode();
+}
+
+bool XGZP6897DSensor::setOversampling(XGZPOversampling osr) {
+    oversampling = osr;
+    return applyOversampling();
+}
+
+bool XGZP6897DSensor::setMode(XGZPConversionMode new_mode, uint8_t period_code) {
+    mode = new_mode;
+    periodCode = constrain(period_code, (uint8_t)1, (uint8_t)15);
+    return applyMode();
+}
+
+bool XGZP6897DSensor::applyOversampling() {
+    // 读-改-写，保留 P_CONFIG 的增益等其他位
+    uint8_t config;
+    if (!readRegisters(P_CONFIG_REG, &config, 1)) {
+        return false;
+    }
+    config = (config & ~OSR_MASK) | (oversampling & OSR_MASK);
+    return writeRegister(P_CONFIG_REG, config);
+}
+
+bool XGZP6897DSensor::applyMode() {
+    if (mode == XGZP_MODE_PERIODIC) {
+        // 休眠时间在高4位，SCO启动周期转换
+        return writeRegister(CMD_REG, (uint8_t)(periodCode << 4) | CMD_SCO | MODE_SLEEP);
+    }
+    // 单次模式：写入单次组合模式但不启动，等待触发（也会退出周期模式）
+    return writeRegister(CMD_REG, MODE_COMBINED);
+}
+
+uint32_t XGZP6897DSensor::conversionTimeMs() const {
+    if (mode == XGZP_MODE_PERIODIC) {
+        return 0;  // 数据随时可读
+    }
+    // 组合转换时间上限（温度转换 + 压力转换，保守估计）
+    switch (oversampling) {
+        case XGZP_OSR_256X:   return 3;
+        case XGZP_OSR_512X:   return 4;
+        case XGZP_OSR_1024X:  return 6;
+        case XGZP_OSR_2048X:  return 9;
+        case XGZP_OSR_4096X:  return 15;
+        case XGZP_OSR_8192X:  return 27;
+        case XGZP_OSR_16384X: return 52;
+        case XGZP_OSR_32768X: return 102;
+    }
+    return 102;
+}
+
+bool XGZP6897DSensor::triggerConversion() {
+    if (mode == XGZP_MODE_PERIODIC) {
+        return true;  // 传感器自行转换
+    }
+    if (!writeRegister(CMD_REG, measurementCommand())) {
+        Serial.println("X Failed to start measurement");
+        return false;
+    }
+    return true;
+}
+
+bool XGZP6897DSensor::fetchRaw(int32_t& raw24) {
+    // 一次读出 0x06-0x0A：压力3字节 + 温度2字节
+    uint8_t buf[5];
+    if (!readRegisters(DATA_REG_H, buf, 5)) {
+        return false;
+    }
+    raw24 = signExtend24(buf[0], buf[1], buf[2]);
+    int16_t rawTemp = (int16_t)(((uint16_t)buf[3] << 8) | buf[4]);
+    lastSensorTemp = rawTemp / 256.0f;
+    return true;
+}
+
+float XGZP6897DSensor::convertToPressure(int32_t raw24) const {
+    // P(Pa) = raw24 / K
+    return (float)raw24 / (float)kFactor / 1000.0f;
+}
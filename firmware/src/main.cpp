@@ -3,17 +3,40 @@
  * @brief 带加热负压眼镜主程序 - FreeRTOS多任务实现
  * 
  * 系统架构：
- * - 温度监控任务：读取 MAX31855 K型热电偶温度，PID控制维持40°C
- * - 压力监控任务：读取 XGZP6897D 气压传感器，PID控制维持15mmHg负压
- * - 用户界面任务：按键处理（UP/DOWN调节负压档位，STOP急停）
- * - 安全监控任务：异常报警（蜂鸣器）
+ * - 控制通道：每个眼罩腔体一个通道（传感器+执行器），通道数由 NUM_CHANNELS 决定
+ * - 温度监控任务：读取 MAX31855/MAX6675 K型热电偶温度，PID控制维持40°C（各通道错峰）
+ * - 压力监控任务：读取 CPS610DSD003DH01/XGZP6897D 气压传感器，PID控制维持15mmHg负压（各通道错峰）
+ *   转换等待期间挂起并处理总线事件（可恢复采集，见 Resumable.h）
+ * - 状态机任务：系统模式的唯一拥有者，从事件总线读取输入并执行转移（见 SystemStateMachine.h）
+ * - 用户界面任务：按键 -> 状态机事件 / 负压档位（空闲时等待按键中断，不轮询）；
+ *   同时执行主机经串口发来的二进制 RPC 请求（参数读写、命令，见 LinkProtocol.h / HostLink.h）
+ * - 遥测任务：主机设定周期后按周期发送二进制遥测帧，默认关闭
+ * - 安全监控任务：异常报警和提示音（蜂鸣器，定时器播放不阻塞），把预热完成/泄压完成/故障等条件转换为事件
+ * - 响应时间：任务优先级、周期和执行时间预算在编译期做可调度性检查（见 ResponseTime.h）
+ * - 事件总线：状态机输入、模式转移、档位变化、报警经静态事件总线以任务通知投递（见 EventBus.h）
+ * - 传感器数据：各通道每次采集后发布到 SampleHub（带时间戳和质量），其他任务无锁读取；
+ *   样本过期（采集任务卡住）与采集失败同样按传感器故障处理，进入故障模式关断执行器
+ * - 急停：STOP中断在IRAM中直接关断执行器输出引脚，再通知状态机锁存（见 EmergencyStop.h）
+ * - 板温降额：按芯片内部温度和冷端温度限制加热/泵占空比，超过硬限值报警并进入故障模式（见 BoardDerating.h）
+ * - 输出租约：加热片和泵的输出须由控制任务按周期刷新，超时未刷新由定时器清零（见 OutputLease.h）
+ * - 磨损趋势：每次疗程记录泵/密封指纹，疗程结束时计算趋势，超限置维护标志（见 WearHistory.h）
+ * - 上电自检：创建任务前同时进行加热脉冲、抽气脉冲和传感器合理性检查，失败写入故障日志；
+ *   严重故障时停在故障模式，重启前不能开始疗程（见 SelfTest.h）
+ * - 固件升级：待机时经串口接收差分写入另一个 OTA 分区，可断点续传；新固件以上电自检结果
+ *   决定确认还是回滚到旧固件（见 FirmwareUpdate.h）
+ * 
+ * 按键操作：
+ * - STOP：急停并锁存，松开后不会自动恢复
+ * - UP+DOWN同时长按2秒：解除急停锁存（回到待机）
+ * - UP：待机时开始疗程，暂停时恢复抽气，运行时增加负压档位
+ * - DOWN：减少负压档位，档位1时再按暂停抽气；长按2秒结束疗程（泄压）
  * 
  * 硬件连接：
  * - GPIO1: 加热片PWM
  * - GPIO2: 负压泵PWM
- * - GPIO4/5/7: MAX31855 (SCK/MISO/CS)
+ * - GPIO4/5/7: MAX31855 或 MAX6675 (SCK/MISO/CS，型号见 config.h)
  * - GPIO6: 蜂鸣器PWM (2.731kHz)
- * - GPIO8/9: XGZP6897D (SDA/SCL)
+ * - GPIO8/9: CPS610DSD003DH01 或 XGZP6897D (SDA/SCL，型号见 config.h)
  * - GPIO10: STOP按键（低电平触发急停）
  * - GPIO20: UP按键（增加负压档位）
  * - GPIO21: DOWN按键（减少负压档位）
@@ -23,41 +46,76 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/semphr.h>
-#include <freertos/queue.h>
 
 #include "config.h"
 #include "TemperatureSensor.h"
 #include "PressureSensor.h"
-#include "HeatingController.h"
-#include "PumpController.h"
+#include "ControlChannel.h"
+#include "SystemStateMachine.h"
+#include "EventBus.h"
+#include "EmergencyStop.h"
+#include "OutputLease.h"
+#include "BoardDerating.h"
+#include "HotPath.h"
+#include "ResponseTime.h"
+#include "FaultLog.h"
+#include "SelfTest.h"
 #include "Buzzer.h"
 #include "Button.h"
+#include "HostLink.h"
+#include "RpcServer.h"
+#include "FirmwareUpdate.h"
+#if HOT_PATH_BENCH
+#include <Preferences.h>
+#endif
+
+// ============ 控制通道 ============
+typedef ControlChannel<PressureSensor, TemperatureSensor> Channel;
+
+static const ChannelPins kChannelPins[NUM_CHANNELS] = {
+    // 通道0（单腔体镜框 / 双腔体左眼）
+    { HEATING_PAD_PIN, PWM_CHANNEL_HEAT, PUMP_PWM_PIN, PWM_CHANNEL_PUMP,
+      THERMO_CLK_PIN, THERMO_CS_PIN, THERMO_MISO_PIN,
+      PRESSURE_SDA_PIN, PRESSURE_SCL_PIN, PRESSURE_I2C_ADDR },
+#if NUM_CHANNELS > 1
+    // 通道1（双腔体右眼）
+    { CH1_HEATING_PAD_PIN, CH1_PWM_CHANNEL_HEAT, CH1_PUMP_PWM_PIN, CH1_PWM_CHANNEL_PUMP,
+      THERMO_CLK_PIN, CH1_THERMO_CS_PIN, THERMO_MISO_PIN,
+      PRESSURE_SDA_PIN, PRESSURE_SCL_PIN, CH1_PRESSURE_I2C_ADDR },
+#endif
+};
+
+ChannelBank<NUM_CHANNELS, Channel> channels(kChannelPins);
+
+// ============ 系统状态机 ============
+SystemStateMachine stateMachine;     // 只由 taskSupervisor 修改
+EventBus eventBus;                   // 子系统间事件（状态机输入、模式转移、档位、报警）
+EmergencyStop estop(BUTTON_STOP_PIN); // STOP中断直接关断执行器输出
+LeaseMonitor leaseMonitor;           // 控制任务停止刷新时清零执行器输出
+BoardDerating boardDerating;         // 板温降额（安全监控任务更新，控制任务每周期取上限）
+FaultLog faultLog;                   // 自检失败等故障（NVS，重启后保留）
+FirmwareUpdate firmwareUpdate;       // 固件升级（界面任务处理主机请求）
+bool selfTestPassed = true;          // 上电自检无严重故障（setup 中写一次，之后只读）
 
 // ============ 全局对象 ============
-TemperatureSensor* tempSensor;      // MAX31855温度传感器
-PressureSensor* pressureSensor;     // XGZP6897D压力传感器
-HeatingController* heatingCtrl;     // 加热控制器（PID）
-PumpController* pumpCtrl;           // 负压泵控制器（PID）
-Buzzer* buzzer;                     // 蜂鸣器
+Buzzer* buzzer;                     // 蜂鸣器（只由安全监控任务使用，启动提示音除外）
 Button* btnStop;                    // 急停按键
 Button* btnUp;                      // 增加档位
 Button* btnDown;                    // 减少档位
 
 // ============ 互斥锁和信号量 ============
-SemaphoreHandle_t xSerialMutex;      // 串口打印互斥锁
-SemaphoreHandle_t xTempMutex;        // 温度数据互斥锁
-SemaphoreHandle_t xPressureMutex;    // 压力数据互斥锁
+SemaphoreHandle_t xSerialMutex;      // 串口打印互斥锁（文本和二进制帧共用）
+
+// ============ 主机链路（见 HostLink.h） ============
+HostLink hostLink;
+volatile uint16_t telemetryPeriodMs = TELEMETRY_DEFAULT_PERIOD_MS;  // 界面任务（RPC）写，遥测任务读
 
 // ============ 共享数据 ============
+// 传感器数据不在这里：由各通道的 SampleHub 发布（channels[i].samples()）
 struct SystemState {
-    float currentTemp;          // 当前温度 (°C)
     float targetTemp;           // 目标温度 (°C) - 固定40°C
-    float currentPressure;      // 当前负压 (mmHg)
     float targetPressure;       // 目标负压 (mmHg)
-    uint8_t pressureGear;       // 负压档位 (1-10)
-    bool systemEnabled;         // 系统运行状态
-    bool emergencyStop;         // 急停状态
-    bool overTemp;              // 过温标志
+    uint8_t pressureGear;       // 负压档位 (1-10)，各通道共用；界面任务拥有，变化经总线通知压力任务
 } sysState;
 
 // ============ 任务句柄 ============
@@ -65,23 +123,55 @@ TaskHandle_t xTaskTemperatureHandle = NULL;
 TaskHandle_t xTaskPressureHandle = NULL;
 TaskHandle_t xTaskUIHandle = NULL;
 TaskHandle_t xTaskSafetyHandle = NULL;
+TaskHandle_t xTaskSupervisorHandle = NULL;
+TaskHandle_t xTaskTelemetryHandle = NULL;
+
+// ============ 回路执行时间（基准模式以外为空操作，见 HotPath.h） ============
+LoopTimer tempLoopTimer(channels.slotPeriodMs(TEMP_SAMPLE_PERIOD_MS) * 1000UL);
+LoopTimer pressureLoopTimer(channels.slotPeriodMs(PRESSURE_SAMPLE_PERIOD_MS) * 1000UL);
 
 // ============ 任务函数声明 ============
 void taskTemperatureControl(void* parameter);
 void taskPressureControl(void* parameter);
 void taskUserInterface(void* parameter);
 void taskSafetyMonitor(void* parameter);
+void taskSupervisor(void* parameter);
+void taskTelemetry(void* parameter);
 
 // ============ 辅助函数 ============
 void safePrint(const char* format, ...);
 void initializeHardware();
 void initializeSystem();
+void runPowerOnSelfTest();
+void reportWear(size_t channel, const WearReport& report);
+bool postSystemEvent(SystemEvent event);
+SystemInputs collectSystemInputs();
+void onButtonEdge();
+void onStopEdge();
+void onHostLinkReceive();
+#if HOT_PATH_BENCH
+void taskFlashBench(void* parameter);
+void benchResumable();
+#endif
+
+/**
+ * @brief 通道样本快照（读取方统一的新鲜度判断）
+ */
+struct ChannelReading {
+    Sample temp;
+    Sample pressure;
+    bool tempOk;                // 采集成功且未过期
+    bool pressureOk;
+    bool overTemp;
+};
+ChannelReading readChannel(size_t i, uint32_t now);
 
 /**
  * @brief Arduino setup函数
  */
 void setup() {
-    // 使用 USB CDC 串口
+    // 使用 USB CDC 串口（接收缓冲在 begin 之前设定）
+    Serial.setRxBufferSize(LINK_RX_BUFFER_SIZE);
     Serial.begin(115200);
     
     // 等待串口连接（最多3秒）
@@ -101,13 +191,29 @@ void setup() {
     // 初始化硬件
     initializeHardware();
     
+    // 上电自检（控制任务创建之前，执行器由自检独占）
+    runPowerOnSelfTest();
+    
+    // 升级后的试运行：自检结果决定确认还是回滚（回滚时在这里重启）
+    firmwareUpdate.onSelfTestResult(selfTestPassed);
+    
     // 初始化系统状态
     initializeSystem();
     
     // 创建互斥锁
     xSerialMutex = xSemaphoreCreateMutex();
-    xTempMutex = xSemaphoreCreateMutex();
-    xPressureMutex = xSemaphoreCreateMutex();
+    hostLink.begin(xSerialMutex, onHostLinkReceive);
+    
+    // 状态机任务优先级最高：急停事件入队后立即被处理
+    xTaskCreatePinnedToCore(
+        taskSupervisor,                   // 状态机任务
+        "Supervisor",
+        TASK_STACK_SIZE_MEDIUM,
+        NULL,
+        TASK_PRIORITY_HIGH + 1,
+        &xTaskSupervisorHandle,
+        0
+    );
     
     // 创建FreeRTOS任务
     xTaskCreatePinnedToCore(
@@ -123,7 +229,7 @@ void setup() {
     xTaskCreatePinnedToCore(
         taskPressureControl,              // 压力控制任务（包含PID）
         "Pressure",
-        TASK_STACK_SIZE_MEDIUM,
+        TASK_STACK_SIZE_LARGE,            // 疗程结束时写磨损记录（NVS）
         NULL,
         TASK_PRIORITY_HIGH,
         &xTaskPressureHandle,
@@ -150,7 +256,39 @@ void setup() {
         1
     );
     
+    xTaskCreatePinnedToCore(
+        taskTelemetry,                    // 二进制遥测（主机打开后才发送）
+        "Telemetry",
+        TASK_STACK_SIZE_MEDIUM,
+        NULL,
+        TASK_PRIORITY_NORMAL,
+        &xTaskTelemetryHandle,
+        1
+    );
+    
+#if HOT_PATH_BENCH
+    // 基准模式：最低优先级的后台任务交替连续写NVS
+    xTaskCreatePinnedToCore(
+        taskFlashBench,
+        "FlashBench",
+        TASK_STACK_SIZE_LARGE,
+        NULL,
+        TASK_PRIORITY_LOW,
+        NULL,
+        0
+    );
+#endif
+    
     Serial.println("✓ 所有任务已创建");
+    
+    // 初始化结果交给状态机；系统默认上电即开始疗程
+    bool sensorsOk = selfTestPassed;
+    for (size_t i = 0; i < NUM_CHANNELS; i++) {
+        sensorsOk = sensorsOk && channels[i].getStatus().tempValid && channels[i].getStatus().pressureValid;
+    }
+    postSystemEvent(sensorsOk ? EVT_BOOT_OK : EVT_BOOT_FAIL);
+    postSystemEvent(EVT_START);
+    
     Serial.println("✓ 系统运行中...\n");
     buzzer->beep();  // 启动提示音
 }
@@ -168,13 +306,9 @@ void loop() {
 void initializeHardware() {
     Serial.println("初始化硬件...");
     
-    // 创建传感器对象（使用新的引脚定义）
-    tempSensor = new TemperatureSensor(THERMO_CLK_PIN, THERMO_CS_PIN, THERMO_MISO_PIN);
-    pressureSensor = new PressureSensor(PRESSURE_SDA_PIN, PRESSURE_SCL_PIN);
+    faultLog.begin();
+    firmwareUpdate.begin(faultLog);
     
-    // 创建控制器对象
-    heatingCtrl = new HeatingController(HEATING_PAD_PIN, PWM_CHANNEL_HEAT);
-    pumpCtrl = new PumpController(PUMP_PWM_PIN, PWM_CHANNEL_PUMP);
     buzzer = new Buzzer(BUZZER_PIN, PWM_CHANNEL_BUZZER);
     
     // 创建按键对象
@@ -182,26 +316,41 @@ void initializeHardware() {
     btnUp = new Button(BUTTON_UP_PIN);
     btnDown = new Button(BUTTON_DOWN_PIN);
     
-    // 初始化传感器
-    if (!tempSensor->begin()) {
-        Serial.println("⚠ 警告：MAX31855温度传感器初始化失败！");
-    } else {
-        Serial.println("✓ MAX31855温度传感器就绪");
+    // 初始化各通道的传感器和控制器
+    for (size_t i = 0; i < channels.size(); i++) {
+        Serial.printf("通道%u:\n", (unsigned)i);
+        channels[i].begin();
+        
+        const ChannelStatus& st = channels[i].getStatus();
+        if (!st.tempValid) {
+            Serial.printf("⚠ 警告：%s温度传感器初始化失败！\n", TemperatureSensor::chipName());
+        } else {
+            Serial.printf("✓ %s温度传感器就绪\n", TemperatureSensor::chipName());
+        }
+        
+        if (!st.pressureValid) {
+            Serial.printf("⚠ 警告：%s压力传感器初始化失败！\n", channels[i].pressure().modelName());
+        } else {
+            Serial.printf("✓ %s压力传感器就绪\n", channels[i].pressure().modelName());
+        }
+        
+        Serial.println("✓ 加热控制器就绪");
+        Serial.println("✓ 负压泵控制器就绪");
+        
+        estop.addOutput(kChannelPins[i].heatingPin, kChannelPins[i].heatingPwmChannel);
+        estop.addOutput(kChannelPins[i].pumpPin, kChannelPins[i].pumpPwmChannel);
+        leaseMonitor.add(channels[i].heating().lease());
+        leaseMonitor.add(channels[i].pumpController().lease());
     }
     
-    if (!pressureSensor->begin()) {
-        Serial.println("⚠ 警告：XGZP6897D压力传感器初始化失败！");
+    // 租约监视在自检之前启动：自检的加热/抽气脉冲同样受保护
+    if (leaseMonitor.begin()) {
+        Serial.println("✓ 输出租约监视就绪");
     } else {
-        Serial.println("✓ XGZP6897D压力传感器就绪");
+        Serial.println("✗ 输出租约监视定时器创建失败");
     }
     
-    // 初始化控制器
-    heatingCtrl->begin();
-    pumpCtrl->begin();
     buzzer->begin();
-    
-    Serial.println("✓ 加热控制器就绪");
-    Serial.println("✓ 负压泵控制器就绪");
     Serial.println("✓ 蜂鸣器就绪");
     
     // 初始化按键
@@ -209,7 +358,12 @@ void initializeHardware() {
     btnUp->begin();
     btnDown->begin();
     
-    Serial.println("✓ 按键初始化完成");
+    // 急停中断在自检之前挂上：自检期间按STOP同样立即关断
+    if (btnStop->attachEdgeInterrupt(onStopEdge)) {
+        Serial.println("✓ 按键初始化完成");
+    } else {
+        Serial.println("✗ 急停中断登记失败，只有界面任务的扫描路径");
+    }
     Serial.println("硬件初始化完成\n");
 }
 
@@ -217,22 +371,43 @@ void initializeHardware() {
  * @brief 初始化系统状态
  */
 void initializeSystem() {
-    sysState.currentTemp = 0.0f;
     sysState.targetTemp = TEMP_TARGET_DEFAULT;  // 固定40°C
-    sysState.currentPressure = 0.0f;
     sysState.targetPressure = PRESSURE_TARGET_DEFAULT;  // 默认15mmHg
     sysState.pressureGear = 5;  // 默认档位5 (中档)
-    sysState.systemEnabled = true;  // 系统默认启动
-    sysState.emergencyStop = false;
-    sysState.overTemp = false;
-    
-    heatingCtrl->setTargetTemperature(sysState.targetTemp);
     
     Serial.printf("目标温度: %.1f°C\n", sysState.targetTemp);
     Serial.printf("目标负压: %.1f mmHg\n", sysState.targetPressure);
     Serial.printf("当前档位: %d/10\n", sysState.pressureGear);
 }
 
+/**
+ * @brief 上电自检并打印结果
+ */
+void runPowerOnSelfTest() {
+    static ChannelSelfTest tests[NUM_CHANNELS];
+    
+    Serial.println("上电自检...");
+    uint32_t start = millis();
+    selfTestPassed = runSelfTest(channels, faultLog, estop, tests);
+    uint32_t elapsed = millis() - start;
+    
+    for (size_t i = 0; i < NUM_CHANNELS; i++) {
+        for (uint8_t c = 0; c < POST_CHECK_COUNT; c++) {
+            const PostOutcome& o = tests[i].outcome((PostCheck)c);
+            Serial.printf("  通道%u %s: %s (%.2f, %lu ms)%s%s\n", (unsigned)i,
+                         postCheckName((PostCheck)c), postResultName(o.result),
+                         o.value, (unsigned long)o.elapsedMs,
+                         o.result == POST_FAIL ? " " : "",
+                         o.result == POST_FAIL ? FaultLog::codeName(o.fault) : "");
+        }
+        // 自检期间不发布样本，重新发布一次，控制任务开始前样本不过期
+        channels[i].primeSamples();
+    }
+    Serial.printf("%s 自检%s，用时 %lu ms，故障日志 %u 条（本次 %u 条）\n\n",
+                 selfTestPassed ? "✓" : "✗", selfTestPassed ? "通过" : "发现严重故障，重启前不能开始疗程",
+                 (unsigned long)elapsed, faultLog.count(), faultLog.countThisBoot());
+}
+
 /**
  * @brief 线程安全的串口打印
  */
@@ -248,205 +423,771 @@ void safePrint(const char* format, ...) {
     }
 }
 
+/**
+ * @brief 向状态机投递事件（任意任务可调用）
+ * 
+ * 急停插到邮箱队首；事件池或邮箱满时丢弃（计入总线统计），
+ * 急停在STOP按住期间由界面任务持续重发，条件类事件由安全监控任务周期性重发。
+ */
+bool postSystemEvent(SystemEvent event) {
+    return eventBus.publish(BusEvent::systemEvent(event), event == EVT_ESTOP);
+}
+
+/**
+ * @brief 按键边沿中断：唤醒界面任务扫描
+ */
+void IRAM_ATTR onButtonEdge() {
+    eventBus.notifyFromISR(SUB_UI, BUS_NOTIFY_INPUT);
+}
+
+/**
+ * @brief STOP边沿中断：按下时直接关断输出并唤醒状态机，同时唤醒界面任务消抖扫描
+ */
+void IRAM_ATTR onStopEdge() {
+    if (estop.trip()) {
+        eventBus.notifyFromISR(SUB_SUPERVISOR, BUS_NOTIFY_ESTOP);
+    }
+    eventBus.notifyFromISR(SUB_UI, BUS_NOTIFY_INPUT);
+}
+
+/**
+ * @brief 串口收到主机数据（USB CDC 接收事件的任务上下文）：唤醒界面任务处理请求
+ */
+void onHostLinkReceive() {
+    eventBus.notify(SUB_UI, BUS_NOTIFY_LINK);
+}
+
+// ============ 主机 RPC（界面任务执行，见 LinkProtocol.h） ============
+
+static float rpcGetGear() { return sysState.pressureGear; }
+static float rpcGetTargetTemp() { return sysState.targetTemp; }
+static float rpcGetTargetPressure() { return sysState.targetPressure; }
+static float rpcGetMode() { return (float)stateMachine.mode(); }
+static float rpcGetTelemetryPeriod() { return telemetryPeriodMs; }
+static float rpcGetSelfTest() { return selfTestPassed ? 1.0f : 0.0f; }
+static float rpcGetFaultCount() { return faultLog.count(); }
+static float rpcGetHeaterLimit() { return boardDerating.heaterLimit(); }
+static float rpcGetPumpLimit() { return boardDerating.pumpLimit(); }
+
+/**
+ * @brief 主机设定档位：与按键相同，发布到总线（压力任务更新目标、安全监控任务提示音）
+ */
+static RpcStatus rpcSetGear(float value) {
+    if (stateMachine.mode() == MODE_ESTOP_LATCHED) {
+        return RPC_ERR_REJECTED;    // 锁存期间按键也不能改档位
+    }
+    uint8_t level = (uint8_t)lroundf(value);
+    if (level != sysState.pressureGear) {
+        sysState.pressureGear = level;
+        eventBus.publish(BusEvent::gearChanged(level, false));
+        safePrint("[设置] 主机设定档位: %d/10 (%.0f%%)\n", level, (float)level * 10.0f);
+    }
+    return RPC_OK;
+}
+
+static RpcStatus rpcSetTelemetryPeriod(float value) {
+    uint16_t period = (uint16_t)lroundf(value);
+    if (period != 0 && period < TELEMETRY_MIN_PERIOD_MS) {
+        return RPC_ERR_OUT_OF_RANGE;
+    }
+    telemetryPeriodMs = period;
+    xTaskNotify(xTaskTelemetryHandle, 1, eSetBits);     // 立即按新周期开始
+    return RPC_OK;
+}
+
+static const RpcParam kRpcParams[] = {
+    { PARAM_PRESSURE_GEAR, "gear", 1, PRESSURE_NUM_GEARS, rpcGetGear, rpcSetGear },
+    { PARAM_TARGET_TEMP, "target_temp", 0, 0, rpcGetTargetTemp, NULL },
+    { PARAM_TARGET_PRESSURE, "target_pressure", 0, 0, rpcGetTargetPressure, NULL },
+    { PARAM_MODE, "mode", 0, 0, rpcGetMode, NULL },
+    { PARAM_TELEMETRY_PERIOD, "telemetry_ms", 0, TELEMETRY_MAX_PERIOD_MS, rpcGetTelemetryPeriod, rpcSetTelemetryPeriod },
+    { PARAM_SELF_TEST, "self_test_ok", 0, 0, rpcGetSelfTest, NULL },
+    { PARAM_FAULT_COUNT, "fault_count", 0, 0, rpcGetFaultCount, NULL },
+    { PARAM_HEATER_LIMIT, "heater_limit", 0, 0, rpcGetHeaterLimit, NULL },
+    { PARAM_PUMP_LIMIT, "pump_limit", 0, 0, rpcGetPumpLimit, NULL },
+};
+
+/**
+ * @brief 主机命令：与按键操作相同的模式条件，不满足时拒绝；RPC_OK 表示事件已投递给状态机
+ */
+static RpcStatus rpcCommand(uint8_t command) {
+    SystemMode mode = stateMachine.mode();
+    switch (command) {
+        case CMD_START:
+            if (mode != MODE_IDLE) return RPC_ERR_REJECTED;
+            postSystemEvent(EVT_START);
+            break;
+        case CMD_PAUSE:
+            if (mode != MODE_RUN) return RPC_ERR_REJECTED;
+            postSystemEvent(EVT_PAUSE);
+            break;
+        case CMD_RESUME:
+            if (mode != MODE_HOLD) return RPC_ERR_REJECTED;
+            postSystemEvent(EVT_RESUME);
+            break;
+        case CMD_STOP:
+            if (mode != MODE_WARMUP && mode != MODE_RUN && mode != MODE_HOLD) return RPC_ERR_REJECTED;
+            postSystemEvent(EVT_STOP);
+            safePrint("[系统] 主机结束疗程，泄压中\n");
+            break;
+        case CMD_ESTOP:
+            postSystemEvent(EVT_ESTOP);
+            safePrint("[系统] 主机急停\n");
+            break;
+        default:
+            return RPC_ERR_UNKNOWN_COMMAND;
+    }
+    return RPC_OK;
+}
+
+static uint32_t rpcUptime() { return millis(); }
+
+RpcServer rpcServer(kRpcParams, sizeof(kRpcParams) / sizeof(kRpcParams[0]), rpcCommand,
+                    NUM_CHANNELS, rpcUptime);
+
+/**
+ * @brief 固件升级请求：只在待机时擦写闪存（见 FirmwareUpdate.h）
+ */
+static size_t rpcUpdate(uint8_t op, const uint8_t* args, size_t len, uint8_t* response) {
+    UpdateState before = firmwareUpdate.state();
+    size_t n = firmwareUpdate.handle(op, args, len, response, stateMachine.mode() == MODE_IDLE);
+    UpdateState after = firmwareUpdate.state();
+    if (after != before) {
+        safePrint("[升级] %s -> %s\n", FirmwareUpdate::stateName(before), FirmwareUpdate::stateName(after));
+    }
+    if (n > 1 && response[1] == RPC_ERR_MISMATCH && op != RPC_OP_UPDATE_BEGIN) {
+        safePrint("[升级] 差分或新镜像校验错误，已放弃\n");
+    }
+    return n;
+}
+
+/**
+ * @brief 读取通道的最新样本并判断新鲜度
+ * 
+ * 过温标志由温度任务锁存（单字节，只写一次），可直接读取。
+ */
+ChannelReading readChannel(size_t i, uint32_t now) {
+    const SampleHub& hub = channels[i].samples();
+    ChannelReading r;
+    r.temp = hub.read(TOPIC_PAD_TEMP);
+    r.pressure = hub.read(TOPIC_PRESSURE);
+    r.tempOk = r.temp.isUsable(now, SampleHub::maxAge(TOPIC_PAD_TEMP));
+    r.pressureOk = r.pressure.isUsable(now, SampleHub::maxAge(TOPIC_PRESSURE));
+    r.overTemp = channels[i].getStatus().overTemp;
+    return r;
+}
+
+/**
+ * @brief 采集守卫输入快照
+ */
+SystemInputs collectSystemInputs() {
+    SystemInputs in;
+    in.stopPressed = btnStop->isPressed();
+    in.sensorsOk = selfTestPassed;      // 自检严重故障视同传感器故障，重启前不恢复
+    in.allOverTemp = true;
+    in.boardOverTemp = boardDerating.isOverLimit();
+    
+    uint32_t now = millis();
+    for (size_t i = 0; i < NUM_CHANNELS; i++) {
+        ChannelReading r = readChannel(i, now);
+        in.sensorsOk = in.sensorsOk && r.tempOk && r.pressureOk;
+        in.allOverTemp = in.allOverTemp && r.overTemp;
+    }
+    
+    return in;
+}
+
+/**
+ * @brief 状态机任务（系统模式的唯一拥有者）
+ * 
+ * 逐个处理总线上的状态机输入；发生转移时立即执行进入动作，
+ * 不等控制任务的下一个周期。提示音由安全监控任务按模式转移事件播放，
+ * 本任务不做任何阻塞的输出动作。
+ * 急停中断先于邮箱中的事件处理（中断已关断输出，这里补齐控制器状态和锁存）。
+ */
+void taskSupervisor(void* parameter) {
+    eventBus.attach(SUB_SUPERVISOR, xTaskGetCurrentTaskHandle());
+    
+    while (1) {
+        eventBus.wait(SUB_SUPERVISOR, portMAX_DELAY);
+        SystemEvent event;
+        if (estop.takePending()) {
+            event = EVT_ESTOP;
+        } else {
+            const BusEvent* ev = eventBus.take(SUB_SUPERVISOR);
+            if (ev == NULL) {
+                continue;
+            }
+            event = ev->system;
+            eventBus.release(ev);
+        }
+        
+        SystemMode from = stateMachine.mode();
+        if (!stateMachine.dispatch(event, collectSystemInputs(), millis())) {
+            continue;
+        }
+        SystemMode to = stateMachine.mode();
+        
+        // 进入动作：关断本模式不允许的执行器
+        if (!stateMachine.heatingAllowed() && !stateMachine.pumpAllowed()) {
+            channels.shutdownAll();
+        } else if (!stateMachine.pumpAllowed()) {
+            for (size_t i = 0; i < NUM_CHANNELS; i++) {
+                channels[i].pumpController().stop();
+            }
+        }
+        
+        // 离开急停锁存：输出引脚交还给LEDC（此时各控制器占空比均为0）
+        if (from == MODE_ESTOP_LATCHED) {
+            estop.rearm();
+        }
+        
+        eventBus.publish(BusEvent::modeChanged(from, to, event));
+        
+        const TransitionRecord& rec = stateMachine.history(0);
+        safePrint("[状态] %s -> %s (%s) @%lu ms\n",
+                 SystemStateMachine::modeName(from), SystemStateMachine::modeName(to),
+                 SystemStateMachine::eventName(event), (unsigned long)rec.timestamp);
+    }
+}
+
 /**
  * @brief 温度控制任务（读取+PID控制）
+ * 
+ * 各通道错峰：每个时间片只服务一个通道，每个通道的采样周期仍为 TEMP_SAMPLE_PERIOD_MS
  */
 void taskTemperatureControl(void* parameter) {
     TickType_t xLastWakeTime = xTaskGetTickCount();
+    const TickType_t xSlot = pdMS_TO_TICKS(channels.slotPeriodMs(TEMP_SAMPLE_PERIOD_MS));
+    size_t slot = 0;
+    static uint32_t lastPrintTime[NUM_CHANNELS] = {0};
     
     while (1) {
-        // 读取温度
-        float temp = tempSensor->readTemperature();
-        
-        if (!isnan(temp)) {
-            // 更新共享数据
-            if (xSemaphoreTake(xTempMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-                sysState.currentTemp = temp;
-                xSemaphoreGive(xTempMutex);
-            }
-            
-            // PID温度控制（如果系统运行且未急停）
-            if (sysState.systemEnabled && !sysState.emergencyStop) {
-                uint8_t output = heatingCtrl->update(temp);
-                
-                // 定期打印控制状态
-                static uint32_t lastPrintTime = 0;
-                if (millis() - lastPrintTime > 5000) {
-                    safePrint("[温度] 当前: %.1f°C, 目标: %.1f°C, 功率: %.0f%%\n",
-                             temp, sysState.targetTemp, heatingCtrl->getPowerPercent());
-                    lastPrintTime = millis();
-                }
-            } else {
-                // 系统停止，关闭加热
-                heatingCtrl->disable();
-            }
-            
-            // 过温检测
-            if (temp >= TEMP_EMERGENCY_STOP) {
-                sysState.overTemp = true;
-                sysState.emergencyStop = true;
-                heatingCtrl->emergencyStop();
-                safePrint("[紧急] 温度过高！%.2f°C\n", temp);
+        Channel& ch = channels[slot];
+        
+        // 读取温度 + PID温度控制（当前模式允许加热时；预热模式先全功率）
+        bool allowHeating = stateMachine.heatingAllowed();
+        ch.heating().setOutputLimit(boardDerating.heaterLimit());
+        tempLoopTimer.begin();
+        ChannelEvent evt = ch.serviceTemperature(allowHeating, stateMachine.mode() == MODE_WARMUP);
+        tempLoopTimer.end();
+        const ChannelStatus& st = ch.getStatus();
+        
+        uint32_t lateMs;
+        if (ch.heating().lease().takeExpiry(lateMs)) {
+            safePrint("[安全] 通道%u 加热输出 %lu ms 未刷新，已由租约定时器清零\n",
+                     (unsigned)slot, (unsigned long)lateMs);
+        }
+        
+        if (evt == CHANNEL_EVENT_OVER_TEMP) {
+            // 过温只关断本通道，其他通道继续运行
+            eventBus.publish(BusEvent::alarmRaised(ALARM_OVER_TEMP, (uint8_t)slot, st.currentTemp));
+            safePrint("[紧急] 通道%u 温度过高！%.2f°C，本通道已关断\n", (unsigned)slot, st.currentTemp);
+        } else if (evt == CHANNEL_EVENT_TEMP_ERROR) {
+            eventBus.publish(BusEvent::alarmRaised(ALARM_TEMP_SENSOR, (uint8_t)slot, NAN));
+            safePrint("[错误] 通道%u 温度读取失败\n", (unsigned)slot);
+        } else if (evt == CHANNEL_EVENT_WARMUP_DONE) {
+            WarmUpReport report;
+            if (ch.warmUp().takeReport(report)) {
+                safePrint("[预热] 通道%u 用时: %.1fs, 超调: %+.2f°C, 切换点: %.1f°C, 热滞后: %.1fs, "
+                          "热导: %.2f%s, 维持功率: %.0f\n",
+                         (unsigned)slot, report.timeToSetpoint, report.overshoot,
+                         report.switchTemp, report.lagSeconds,
+                         report.conductance, report.identified ? "（本次辨识）" : "（学习值）",
+                         report.holdingOutput);
             }
-        } else {
-            safePrint("[错误] 温度读取失败\n");
+        } else if (allowHeating && millis() - lastPrintTime[slot] > 5000) {
+            // 定期打印控制状态
+            safePrint("[温度] 通道%u 当前: %.1f°C, 目标: %.1f°C, 功率: %.0f%%\n",
+                     (unsigned)slot, st.currentTemp, sysState.targetTemp,
+                     ch.heating().getPowerPercent());
+            lastPrintTime[slot] = millis();
         }
         
+        slot = (slot + 1) % channels.size();
+        
         // 周期性休眠
-        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(TEMP_SAMPLE_PERIOD_MS));
+        vTaskDelayUntil(&xLastWakeTime, xSlot);
     }
 }
 
 /**
  * @brief 压力控制任务（读取+PID控制）
+ * 
+ * 各通道错峰：共享I2C总线上同一时刻只有一个通道的采集事务。
+ * 采集可恢复：触发转换后挂起到转换完成（见 Resumable.h），不占CPU。
+ * 档位变化经总线送达，在两次采样之间和转换等待期间随到随处理。
+ * 疗程（预热到泄压完成）开始/结束时开始/结束各通道的磨损指纹采集，
+ * 结束时保存指纹并计算趋势（每次疗程一次，此时泵已停止）。
  */
 void taskPressureControl(void* parameter) {
+    eventBus.attach(SUB_PRESSURE, xTaskGetCurrentTaskHandle());
     TickType_t xLastWakeTime = xTaskGetTickCount();
+    const TickType_t xSlot = pdMS_TO_TICKS(channels.slotPeriodMs(PRESSURE_SAMPLE_PERIOD_MS));
+    size_t slot = 0;
+    static uint32_t lastPrintTime[NUM_CHANNELS] = {0};
+    uint8_t gear = sysState.pressureGear;
+    bool inSession = false;
+    bool vented = false;    // 泄压完成回到待机后未再转移：腔体通大气，可学习零点
+    auto onBusEvent = [&gear, &vented](const BusEvent& ev) {
+        if (ev.topic == BUS_GEAR_CHANGED) {
+            gear = ev.gear.level;
+        } else if (ev.topic == BUS_MODE_CHANGED) {
+            vented = ev.mode.from == MODE_VENTING && ev.mode.to == MODE_IDLE;
+        }
+    };
     
     while (1) {
-        // 读取压力
-        float pressure = pressureSensor->readPressure();
-        
-        if (!isnan(pressure)) {
-            // 更新共享数据
-            if (xSemaphoreTake(xPressureMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-                sysState.currentPressure = pressure;
-                xSemaphoreGive(xPressureMutex);
-            }
-            
-            // PID压力控制（如果系统运行且未急停）
-            if (sysState.systemEnabled && !sysState.emergencyStop) {
-                // 根据档位计算目标压力 (10% - 100%)
-                float gearPercent = (float)sysState.pressureGear / (float)PRESSURE_NUM_GEARS;
-                sysState.targetPressure = PRESSURE_TARGET_DEFAULT * gearPercent;
-                
-                // 简单的压力控制（可改进为PID）
-                float error = sysState.targetPressure - pressure;
-                
-                if (error > 2.0f) {
-                    // 实际压力小于目标，需要增加泵速
-                    pumpCtrl->setSpeed(80);
-                } else if (error < -2.0f) {
-                    // 实际压力大于目标，减小泵速
-                    pumpCtrl->setSpeed(40);
-                } else {
-                    // 维持当前压力
-                    pumpCtrl->setSpeed(60);
+        SystemMode mode = stateMachine.mode();
+        bool session = mode == MODE_WARMUP || mode == MODE_RUN || mode == MODE_HOLD || mode == MODE_VENTING;
+        if (session != inSession) {
+            for (size_t i = 0; i < NUM_CHANNELS; i++) {
+                WearFingerprint fp;
+                if (session) {
+                    channels[i].wearTracker().beginSession(millis());
+                } else if (channels[i].wearTracker().endSession(fp)) {
+                    WearReport report;
+                    channels[i].wearHistory().add(fp, report);
+                    reportWear(i, report);
                 }
-                
-                // 定期打印压力状态
-                static uint32_t lastPrintTime = 0;
-                if (millis() - lastPrintTime > 5000) {
-                    safePrint("[压力] 当前: %.1f mmHg, 目标: %.1f mmHg, 档位: %d\n",
-                             pressure, sysState.targetPressure, sysState.pressureGear);
-                    lastPrintTime = millis();
-                }
-            } else {
-                // 系统停止，关闭泵
-                pumpCtrl->stop();
             }
-        } else {
-            safePrint("[错误] 压力读取失败\n");
+            inSession = session;
+        }
+        
+        Channel& ch = channels[slot];
+        
+        // 根据档位计算目标压力 (10% - 100%)
+        float gearPercent = (float)gear / (float)PRESSURE_NUM_GEARS;
+        sysState.targetPressure = PRESSURE_TARGET_DEFAULT * gearPercent;
+        
+        // 读取压力 + 泵控制（当前模式允许抽气时）
+        bool allowPump = stateMachine.pumpAllowed();
+        ch.pressureControl().setOutputLimit(boardDerating.pumpLimit());
+        pressureLoopTimer.begin();
+        ChannelEvent evt;
+        while ((evt = ch.servicePressure(allowPump, sysState.targetPressure, vented)) == CHANNEL_EVENT_PRESSURE_PENDING) {
+            // 转换期间挂起，期间到达的档位变化随到随处理
+            pressureLoopTimer.pause();
+            int32_t waitMs = (int32_t)(ch.pressureWakeAt() - (uint32_t)millis());
+            TickType_t convStart = xTaskGetTickCount();
+            eventBus.serviceUntil(SUB_PRESSURE, convStart, pdMS_TO_TICKS(waitMs > 0 ? waitMs : 1), onBusEvent);
+            pressureLoopTimer.resume();
+        }
+        pressureLoopTimer.end();
+        const ChannelStatus& st = ch.getStatus();
+        
+        uint32_t lateMs;
+        if (ch.pumpController().lease().takeExpiry(lateMs)) {
+            safePrint("[安全] 通道%u 泵输出 %lu ms 未刷新，已由租约定时器清零\n",
+                     (unsigned)slot, (unsigned long)lateMs);
+        }
+        
+        if (evt == CHANNEL_EVENT_PRESSURE_ERROR) {
+            eventBus.publish(BusEvent::alarmRaised(ALARM_PRESSURE_SENSOR, (uint8_t)slot, NAN));
+            safePrint("[错误] 通道%u 压力读取失败\n", (unsigned)slot);
+        } else if (allowPump && millis() - lastPrintTime[slot] > 5000) {
+            // 定期打印压力状态
+            safePrint("[压力] 通道%u 当前: %.1f mmHg, 目标: %.1f mmHg, 档位: %d\n",
+                     (unsigned)slot, st.currentPressure, sysState.targetPressure, gear);
+            lastPrintTime[slot] = millis();
         }
         
-        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(PRESSURE_SAMPLE_PERIOD_MS));
+        slot = (slot + 1) % channels.size();
+        
+        eventBus.serviceUntil(SUB_PRESSURE, xLastWakeTime, xSlot, onBusEvent);
+    }
+}
+
+/**
+ * @brief 打印本次疗程的磨损指纹和趋势，新置维护标志时记录故障日志并报警（压力任务）
+ */
+void reportWear(size_t channel, const WearReport& report) {
+    const WearFingerprint& fp = report.fingerprint;
+    char holds[96] = "";
+    size_t len = 0;
+    for (uint8_t g = 0; g < PRESSURE_NUM_GEARS && len < sizeof(holds); g++) {
+        if (fp.holdDuty[g] > 0) {
+            len += snprintf(holds + len, sizeof(holds) - len, " %u档%.2f%%", g + 1, fp.holdDuty[g] / 100.0f);
+        }
+    }
+    safePrint("[磨损] 通道%u 疗程#%u 抽气: %.1fs (档位%u), 维持泵速:%s, 泄漏率: %.4f/s\n",
+             (unsigned)channel, fp.session, fp.pullDownDs / 10.0f, fp.pullDownGear,
+             len > 0 ? holds : " -", fp.leakRate);
+    if (!report.baselineReady) {
+        safePrint("[磨损] 通道%u 基准学习中\n", (unsigned)channel);
+    }
+    const struct { const char* name; const WearMetricTrend& t; } rows[] = {
+        { "泵", report.pump }, { "抽气", report.pullDown }, { "密封", report.seal },
+    };
+    for (const auto& r : rows) {
+        if (r.t.points == 0) {
+            continue;
+        }
+        char eta[32];
+        if (isnan(r.t.sessionsToLimit)) {
+            snprintf(eta, sizeof(eta), "未上升");
+        } else {
+            snprintf(eta, sizeof(eta), "约 %.0f 次疗程后超限", r.t.sessionsToLimit);
+        }
+        safePrint("[磨损] 通道%u %s: %.2f x 基准, 每次 %+.3f, %s (%u 次拟合)\n",
+                 (unsigned)channel, r.name, r.t.level, r.t.slope, eta, r.t.points);
+    }
+    if (report.newFlags & WEAR_FLAG_PUMP) {
+        faultLog.record(FAULT_MAINT_PUMP, (uint8_t)channel, report.pump.level);
+    }
+    if (report.newFlags & WEAR_FLAG_SEAL) {
+        faultLog.record(FAULT_MAINT_SEAL, (uint8_t)channel, report.seal.level);
+    }
+    if (report.newFlags) {
+        eventBus.publish(BusEvent::alarmRaised(ALARM_MAINTENANCE, (uint8_t)channel, NAN));
+    }
+    if (report.flags) {
+        safePrint("[维护] 通道%u 需要维护:%s%s\n", (unsigned)channel,
+                 (report.flags & WEAR_FLAG_PUMP) ? " 泵" : "", (report.flags & WEAR_FLAG_SEAL) ? " 密封" : "");
     }
 }
 
 /**
  * @brief 用户界面任务（按键处理）
+ * 
+ * 按键空闲时阻塞等待按键边沿中断（或状态打印周期到），不轮询；
+ * 有按键按下或正在消抖时按 UI_ACTIVE_POLL_MS 扫描，用于消抖和长按计时。
+ * 档位变化发布到总线（压力任务更新目标、安全监控任务播放提示音）。
+ * 主机 RPC 请求（见 HostLink.h）也在本任务中执行：参数与命令和按键操作同一个拥有者，
+ * 档位只有本任务写。串口收到数据时由接收事件唤醒。
  */
 void taskUserInterface(void* parameter) {
+    eventBus.attach(SUB_UI, xTaskGetCurrentTaskHandle());
+    rpcServer.setExtension(rpcUpdate);
+    if (!btnUp->attachEdgeInterrupt(onButtonEdge) || !btnDown->attachEdgeInterrupt(onButtonEdge)) {
+        safePrint("[错误] 按键中断登记失败，按键只在状态打印周期扫描\n");
+    }
+    uint32_t lastStatusTime = millis();
+    uint32_t nextLinkAt = millis();
+    
     while (1) {
         // 更新按键状态
         btnStop->update();
         btnUp->update();
         btnDown->update();
         
+        SystemMode mode = stateMachine.mode();
+        
         // STOP按键 - 急停（低电平触发）
-        if (btnStop->isPressed()) {
-            if (!sysState.emergencyStop) {
-                sysState.emergencyStop = true;
-                sysState.systemEnabled = false;
-                heatingCtrl->emergencyStop();
-                pumpCtrl->stop();
-                buzzer->warning();
-                safePrint("[系统] 急停触发！\n");
+        // 按住期间每个扫描周期重发，直到状态机进入锁存；松开不会恢复运行
+        if (btnStop->isPressed() && mode != MODE_ESTOP_LATCHED) {
+            postSystemEvent(EVT_ESTOP);
+        }
+        
+        // 边沿标志每个周期都要读取清除，避免锁存期间的按键在复位后生效
+        bool upPressed = btnUp->wasPressed();
+        bool downPressed = btnDown->wasPressed();
+        
+        // UP+DOWN同时长按 - 解除急停锁存（每次长按只投递一次）
+        static bool resetSent = false;
+        if (btnUp->isLongPressed(BUTTON_RESET_HOLD_MS) && btnDown->isLongPressed(BUTTON_RESET_HOLD_MS)) {
+            if (!resetSent && mode == MODE_ESTOP_LATCHED) {
+                postSystemEvent(EVT_RESET);
             }
-        } else {
-            // STOP按键松开，可以恢复运行
-            if (sysState.emergencyStop && !sysState.overTemp) {
-                sysState.emergencyStop = false;
-                sysState.systemEnabled = true;
-                heatingCtrl->enable();
-                pumpCtrl->start();
-                buzzer->beep();
-                safePrint("[系统] 急停解除，系统恢复运行\n");
+            resetSent = true;
+        } else if (!btnUp->isPressed() && !btnDown->isPressed()) {
+            resetSent = false;
+        }
+        
+        // DOWN长按 - 结束疗程（泄压）
+        static bool stopSent = false;
+        if (btnDown->isLongPressed(BUTTON_SESSION_STOP_MS) && !btnUp->isPressed()) {
+            if (!stopSent && (mode == MODE_WARMUP || mode == MODE_RUN || mode == MODE_HOLD)) {
+                postSystemEvent(EVT_STOP);
+                safePrint("[系统] 结束疗程，泄压中\n");
             }
+            stopSent = true;
+        } else if (!btnDown->isPressed()) {
+            stopSent = false;
         }
         
-        // UP按键 - 增加负压档位
-        if (btnUp->wasPressed()) {
+        if (mode == MODE_ESTOP_LATCHED) {
+            // 锁存期间忽略UP/DOWN单击
+        } else if (upPressed && mode == MODE_IDLE) {
+            // UP按键 - 待机时开始疗程
+            postSystemEvent(EVT_START);
+        } else if (upPressed && mode == MODE_HOLD) {
+            // UP按键 - 暂停时恢复抽气
+            postSystemEvent(EVT_RESUME);
+        } else if (upPressed) {
+            // UP按键 - 增加负压档位
             if (sysState.pressureGear < PRESSURE_NUM_GEARS) {
                 sysState.pressureGear++;
-                buzzer->beep();
+                eventBus.publish(BusEvent::gearChanged(sysState.pressureGear, false));
                 safePrint("[设置] 档位增加: %d/10 (%.0f%%)\n", 
                          sysState.pressureGear, 
                          (float)sysState.pressureGear * 10.0f);
             } else {
-                buzzer->warning();  // 已达最大档位
+                eventBus.publish(BusEvent::gearChanged(sysState.pressureGear, true));
                 safePrint("[设置] 已达最大档位: %d/10\n", sysState.pressureGear);
             }
         }
         
-        // DOWN按键 - 减少负压档位
-        if (btnDown->wasPressed()) {
+        if (mode != MODE_ESTOP_LATCHED && downPressed) {
+            // DOWN按键 - 减少负压档位
             if (sysState.pressureGear > 1) {
                 sysState.pressureGear--;
-                buzzer->beep();
+                eventBus.publish(BusEvent::gearChanged(sysState.pressureGear, false));
                 safePrint("[设置] 档位减少: %d/10 (%.0f%%)\n", 
                          sysState.pressureGear,
                          (float)sysState.pressureGear * 10.0f);
+            } else if (mode == MODE_RUN) {
+                postSystemEvent(EVT_PAUSE);  // 最小档位再按：暂停抽气
             } else {
-                buzzer->warning();  // 已达最小档位
+                eventBus.publish(BusEvent::gearChanged(sysState.pressureGear, true));
                 safePrint("[设置] 已达最小档位: %d/10\n", sysState.pressureGear);
             }
         }
         
         // 定期打印系统状态
-        static uint32_t lastStatusTime = 0;
-        if (millis() - lastStatusTime > 10000) {
+        uint32_t now = millis();
+        if (now - lastStatusTime >= UI_STATUS_PERIOD_MS) {
             safePrint("\n=== 系统状态 ===\n");
-            safePrint("温度: %.1f°C (目标: %.1f°C)\n", sysState.currentTemp, sysState.targetTemp);
-            safePrint("负压: %.1f mmHg (目标: %.1f mmHg)\n", sysState.currentPressure, sysState.targetPressure);
+            for (size_t i = 0; i < NUM_CHANNELS; i++) {
+                ChannelReading r = readChannel(i, now);
+                safePrint("通道%u 温度: %.1f°C (目标: %.1f°C)%s%s\n", (unsigned)i,
+                         r.temp.value, sysState.targetTemp, r.overTemp ? " [过温]" : "",
+                         r.tempOk ? "" : " [无效]");
+                safePrint("通道%u 负压: %.1f mmHg (目标: %.1f mmHg)%s\n", (unsigned)i,
+                         r.pressure.value, sysState.targetPressure, r.pressureOk ? "" : " [无效]");
+            }
             safePrint("档位: %d/10 (%.0f%%)\n", sysState.pressureGear, (float)sysState.pressureGear * 10.0f);
-            safePrint("状态: %s\n", sysState.systemEnabled ? "运行中" : "已停止");
-            safePrint("急停: %s\n", sysState.emergencyStop ? "是" : "否");
+            safePrint("模式: %s (%lu s)\n", SystemStateMachine::modeName(stateMachine.mode()),
+                     (unsigned long)((now - stateMachine.modeSince()) / 1000));
+            if (!selfTestPassed) {
+                safePrint("上电自检: 严重故障（见故障日志），重启前不能开始疗程\n");
+            }
+            if (firmwareUpdate.state() != UPDATE_STATE_IDLE || firmwareUpdate.lastResult() != UPDATE_RESULT_NONE) {
+                safePrint("固件升级: %s, 上次结果 %s, 运行分区 %s\n",
+                         FirmwareUpdate::stateName(firmwareUpdate.state()),
+                         FirmwareUpdate::resultName(firmwareUpdate.lastResult()), firmwareUpdate.runningLabel());
+            }
+            if (boardDerating.isDerating()) {
+                safePrint("板温降额: 加热上限 %.0f%%, 泵速上限 %u%% (板温 %.1f°C, 芯片 %.1f°C)\n",
+                         boardDerating.heaterLimit() / 2.55f, boardDerating.pumpLimit(),
+                         boardDerating.boardTemperature(), boardDerating.mcuTemperature());
+            }
+            for (size_t i = 0; i < NUM_CHANNELS; i++) {
+                uint8_t wear = channels[i].wearHistory().flags();
+                if (wear) {
+                    safePrint("通道%u 需要维护:%s%s\n", (unsigned)i,
+                             (wear & WEAR_FLAG_PUMP) ? " 泵" : "", (wear & WEAR_FLAG_SEAL) ? " 密封" : "");
+                }
+            }
+            for (uint8_t t = 0; t < BUS_TOPIC_COUNT; t++) {
+                const BusTopicStats& bs = eventBus.stats((BusTopic)t);
+                if (bs.delivered > 0 || bs.dropped > 0) {
+                    safePrint("事件 %s: %lu 次, 平均延迟 %lu µs, 最大 %lu µs, 超预算 %lu, 丢弃 %lu\n",
+                             EventBus::topicName((BusTopic)t), (unsigned long)bs.delivered,
+                             (unsigned long)(bs.delivered > 0 ? bs.totalLatencyUs / bs.delivered : 0),
+                             (unsigned long)bs.maxLatencyUs, (unsigned long)bs.overBudget,
+                             (unsigned long)bs.dropped);
+                }
+            }
+            HostLink::Stats ls = hostLink.counters();
+            if (ls.rxFrames > 0 || ls.rxErrors > 0 || ls.txFrames > 0) {
+                const RpcServer::Stats& rs = rpcServer.counters();
+                safePrint("主机链路: 请求 %lu (重发 %lu, 出错 %lu), 坏帧 %lu, 发送 %lu 帧, 丢弃 %lu 帧\n",
+                         (unsigned long)rs.requests, (unsigned long)rs.duplicates, (unsigned long)rs.errors,
+                         (unsigned long)ls.rxErrors, (unsigned long)ls.txFrames, (unsigned long)ls.txDropped);
+            }
             safePrint("================\n\n");
-            lastStatusTime = millis();
+            lastStatusTime = now;
+        }
+        
+        // 主机请求：每批最多 LINK_RPC_PER_WAKE 个，两批之间至少间隔 LINK_RPC_INTERVAL_MS，
+        // 主机连续发送时不会占满CPU（见 ResponseTime.h）；剩余请求留在串口接收缓冲中
+        if ((int32_t)(millis() - nextLinkAt) >= 0
+                && hostLink.serviceRequests(rpcServer, LINK_RPC_PER_WAKE) > 0) {
+            nextLinkAt = millis() + LINK_RPC_INTERVAL_MS;
         }
         
-        vTaskDelay(pdMS_TO_TICKS(50)); // 按键扫描周期
+        // 升级完成：完成应答发出后重启到新固件
+        if (firmwareUpdate.rebootDue(millis())) {
+            safePrint("[升级] 重启到新固件\n");
+            Serial.flush();
+            ESP.restart();
+        }
+        
+        // 按键空闲：等中断、主机数据或下次状态打印；否则按扫描周期继续消抖/长按计时
+        bool idle = btnStop->isIdle() && btnUp->isIdle() && btnDown->isIdle();
+        uint32_t untilStatus = UI_STATUS_PERIOD_MS - (millis() - lastStatusTime);
+        if (untilStatus > UI_STATUS_PERIOD_MS) {
+            untilStatus = 0;
+        }
+        uint32_t timeout = idle ? untilStatus : UI_ACTIVE_POLL_MS;
+        if (hostLink.hasPendingInput()) {
+            int32_t untilLink = (int32_t)(nextLinkAt - millis());
+            uint32_t linkWait = untilLink > 0 ? (uint32_t)untilLink : 0;
+            timeout = linkWait < timeout ? linkWait : timeout;
+        }
+        if (firmwareUpdate.state() == UPDATE_STATE_REBOOTING && timeout > UPDATE_REBOOT_DELAY_MS) {
+            timeout = UPDATE_REBOOT_DELAY_MS;
+        }
+        eventBus.wait(SUB_UI, pdMS_TO_TICKS(timeout));
+    }
+}
+
+/**
+ * @brief 遥测任务：按主机设定的周期发送二进制遥测帧（见 LinkProtocol.h）
+ * 
+ * 周期为0（上电默认）时不发送，等主机设定周期时的通知。样本取自各通道的 SampleHub（无锁），
+ * 执行器输出和降额上限是单字节读取。发送缓冲不足时丢帧不等待（序号照常递增，主机据此统计丢帧），
+ * 与界面任务处理 RPC 互不阻塞，只共用串口锁写整帧。
+ */
+void taskTelemetry(void* parameter) {
+    static_assert(NUM_CHANNELS <= TELEMETRY_MAX_CHANNELS, "telemetry record holds at most 4 channels");
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    uint8_t seq = 0;
+    
+    while (1) {
+        uint16_t period = telemetryPeriodMs;
+        if (period == 0) {
+            xTaskNotifyWait(0, UINT32_MAX, NULL, portMAX_DELAY);
+            xLastWakeTime = xTaskGetTickCount();
+            continue;
+        }
+        
+        uint32_t now = millis();
+        TelemetryRecord rec;
+        rec.uptimeMs = now;
+        rec.mode = (uint8_t)stateMachine.mode();
+        rec.gear = sysState.pressureGear;
+        rec.flags = (selfTestPassed ? TELEMETRY_FLAG_SELF_TEST_OK : 0)
+                    | (boardDerating.isDerating() ? TELEMETRY_FLAG_DERATING : 0);
+        rec.boardTempCenti = telemetryCenti(boardDerating.boardTemperature());
+        rec.heaterLimit = boardDerating.heaterLimit();
+        rec.pumpLimit = boardDerating.pumpLimit();
+        rec.channelCount = NUM_CHANNELS;
+        for (size_t i = 0; i < NUM_CHANNELS; i++) {
+            ChannelReading r = readChannel(i, now);
+            TelemetryChannel& tc = rec.channels[i];
+            tc.padTempCenti = telemetryCenti(r.tempOk ? r.temp.value : NAN);
+            tc.pressureCenti = telemetryCenti(r.pressureOk ? r.pressure.value : NAN);
+            tc.heaterDuty = channels[i].heating().getOutput();
+            tc.pumpPercent = channels[i].pumpController().getSpeed();
+            tc.flags = (r.tempOk ? TELEMETRY_CH_TEMP_OK : 0) | (r.pressureOk ? TELEMETRY_CH_PRESSURE_OK : 0)
+                       | (r.overTemp ? TELEMETRY_CH_OVER_TEMP : 0)
+                       | (channels[i].wearHistory().flags() ? TELEMETRY_CH_MAINTENANCE : 0);
+        }
+        uint8_t payload[TELEMETRY_HEADER_LEN + TELEMETRY_CHANNEL_LEN * TELEMETRY_MAX_CHANNELS];
+        hostLink.send(LINK_FRAME_TELEMETRY, seq++, payload, telemetryEncode(rec, payload));
+        
+        // 周期改变（或关闭）时提前醒来
+        TickType_t deadline = xLastWakeTime + pdMS_TO_TICKS(period);
+        TickType_t tick = xTaskGetTickCount();
+        if ((int32_t)(deadline - tick) > 0
+                && xTaskNotifyWait(0, UINT32_MAX, NULL, deadline - tick) == pdTRUE) {
+            xLastWakeTime = xTaskGetTickCount();
+        } else {
+            xLastWakeTime = deadline;
+        }
+    }
+}
+
+static uint32_t lastSensorWarn = 0;     // 传感器异常提示音限频（安全监控任务内使用）
+
+/**
+ * @brief 总线事件 -> 提示音（安全监控任务是蜂鸣器的唯一使用者）
+ */
+static void annunciate(const BusEvent& ev) {
+    switch (ev.topic) {
+        case BUS_MODE_CHANGED:
+            if (ev.mode.to == MODE_ESTOP_LATCHED) {
+                buzzer->warning();
+            } else if (ev.mode.to == MODE_FAULT) {
+                buzzer->error();
+            } else if (ev.mode.cause == EVT_RESET || ev.mode.to == MODE_RUN) {
+                buzzer->beep();
+            }
+            break;
+        case BUS_GEAR_CHANGED:
+            if (ev.gear.atLimit) {
+                buzzer->warning();  // 已达最大/最小档位
+            } else {
+                buzzer->beep();
+            }
+            break;
+        case BUS_ALARM:
+            if (ev.alarm.kind == ALARM_OVER_TEMP) {
+                buzzer->error();
+            } else if (ev.alarm.kind == ALARM_BOARD_TEMP) {
+                buzzer->error();
+            } else if (ev.alarm.kind == ALARM_MAINTENANCE) {
+                buzzer->warning();
+            } else if (millis() - lastSensorWarn > 5000) {
+                buzzer->warning();
+                lastSensorWarn = millis();
+            }
+            break;
+        default:
+            break;
     }
 }
 
 /**
  * @brief 安全监控任务
+ * 
+ * 所有判断基于带时间戳的样本：采集失败或样本过期（采集任务卡住）都视为传感器故障，
+ * 由状态机进入故障模式关断执行器，不会沿用最后一次的读数。
+ * 周期检查之间随到随处理总线事件（模式转移、档位、报警的提示音）。
  */
 void taskSafetyMonitor(void* parameter) {
+    eventBus.attach(SUB_SAFETY, xTaskGetCurrentTaskHandle());
     TickType_t xLastWakeTime = xTaskGetTickCount();
     
     while (1) {
-        // 检查过温状态
-        if (sysState.overTemp) {
-            // 持续报警
-            buzzer->error();
-            safePrint("[报警] 系统过温！当前温度: %.1f°C\n", sysState.currentTemp);
-            vTaskDelay(pdMS_TO_TICKS(1000));
+        uint32_t now = millis();
+        ChannelReading readings[NUM_CHANNELS];
+        for (size_t i = 0; i < NUM_CHANNELS; i++) {
+            readings[i] = readChannel(i, now);
+        }
+        
+        // 检查各通道过温状态（首次过温由报警事件立即响铃，此处持续报警）
+        static uint32_t lastOverTempAlarm = 0;
+        for (size_t i = 0; i < NUM_CHANNELS; i++) {
+            if (readings[i].overTemp && now - lastOverTempAlarm >= 1000) {
+                buzzer->error();
+                safePrint("[报警] 通道%u 过温！当前温度: %.1f°C\n", (unsigned)i, readings[i].temp.value);
+                lastOverTempAlarm = now;
+            }
+        }
+        
+        // 板温降额：芯片内部温度 + 各通道冷端温度中的最高值
+        float boardTemp = NAN;
+        for (size_t i = 0; i < NUM_CHANNELS; i++) {
+            float cj = channels[i].samples().readValue(TOPIC_BOARD_TEMP, now, SampleHub::maxAge(TOPIC_BOARD_TEMP));
+            if (!isnan(cj) && !(cj <= boardTemp)) {
+                boardTemp = cj;
+            }
+        }
+        bool wasDerating = boardDerating.isDerating();
+        if (boardDerating.update(temperatureRead(), boardTemp)) {
+            if (boardDerating.isOverLimit()) {
+                faultLog.record(FAULT_BOARD_OVER_TEMP, 0xFF, boardDerating.boardTemperature());
+                eventBus.publish(BusEvent::alarmRaised(ALARM_BOARD_TEMP, 0xFF, boardDerating.boardTemperature()));
+                safePrint("[报警] 板温过高！板温 %.1f°C, 芯片 %.1f°C，加热和泵已关断\n",
+                         boardDerating.boardTemperature(), boardDerating.mcuTemperature());
+            } else {
+                safePrint("[安全] 板温已回落：板温 %.1f°C, 芯片 %.1f°C\n",
+                         boardDerating.boardTemperature(), boardDerating.mcuTemperature());
+            }
+        }
+        if (boardDerating.isDerating() != wasDerating) {
+            safePrint("[降额] %s：板温 %.1f°C, 芯片 %.1f°C, 加热上限 %.0f%%, 泵速上限 %u%%\n",
+                     boardDerating.isDerating() ? "开始" : "结束",
+                     boardDerating.boardTemperature(), boardDerating.mcuTemperature(),
+                     boardDerating.heaterLimit() / 2.55f, boardDerating.pumpLimit());
         }
         
         // 检查急停状态
-        if (sysState.emergencyStop && !sysState.overTemp) {
+        SystemMode mode = stateMachine.mode();
+        if (mode == MODE_ESTOP_LATCHED && !channels.anyOverTemp()) {
             // 急停状态下短促报警
             static uint32_t lastBeep = 0;
             if (millis() - lastBeep > 2000) {
@@ -455,21 +1196,171 @@ void taskSafetyMonitor(void* parameter) {
             }
         }
         
-        // 检查传感器异常
-        if (isnan(sysState.currentTemp) || isnan(sysState.currentPressure)) {
-            static uint32_t lastWarn = 0;
-            if (millis() - lastWarn > 5000) {
-                buzzer->warning();
-                safePrint("[警告] 传感器读取异常\n");
-                lastWarn = millis();
+        // 检查传感器异常（区分采集失败和数据过期）
+        for (size_t i = 0; i < NUM_CHANNELS; i++) {
+            const ChannelReading& r = readings[i];
+            if (!r.tempOk || !r.pressureOk) {
+                if (millis() - lastSensorWarn > 5000) {
+                    buzzer->warning();
+                    if (r.temp.isStale(now, SampleHub::maxAge(TOPIC_PAD_TEMP))) {
+                        safePrint("[警告] 通道%u 温度数据过期 (%lu ms)\n", (unsigned)i,
+                                 (unsigned long)r.temp.age(now));
+                    } else if (r.pressure.isStale(now, SampleHub::maxAge(TOPIC_PRESSURE))) {
+                        safePrint("[警告] 通道%u 压力数据过期 (%lu ms)\n", (unsigned)i,
+                                 (unsigned long)r.pressure.age(now));
+                    } else {
+                        safePrint("[警告] 通道%u 传感器读取异常\n", (unsigned)i);
+                    }
+                    lastSensorWarn = millis();
+                }
+            }
+        }
+        
+        // 条件 -> 状态机事件（条件持续成立时每个周期重发，丢失一次无影响）
+        bool sensorsOk = selfTestPassed;
+        bool allOverTemp = true;
+        bool tempReached = true;
+        bool vented = true;
+        for (size_t i = 0; i < NUM_CHANNELS; i++) {
+            const ChannelReading& r = readings[i];
+            sensorsOk = sensorsOk && r.tempOk && r.pressureOk;
+            allOverTemp = allOverTemp && r.overTemp;
+            if (!r.overTemp && !(r.tempOk && r.temp.value >= sysState.targetTemp - WARMUP_TEMP_MARGIN)) {
+                tempReached = false;
+            }
+            if (!(r.pressureOk && r.pressure.value <= VENT_PRESSURE_BAND)) {
+                vented = false;
             }
         }
         
+        bool boardOverTemp = boardDerating.isOverLimit();
+        if (mode == MODE_FAULT) {
+            if (sensorsOk && !allOverTemp && !boardOverTemp) {
+                postSystemEvent(EVT_FAULT_CLEARED);
+            }
+        } else if (mode != MODE_ESTOP_LATCHED && mode != MODE_BOOT && (!sensorsOk || allOverTemp || boardOverTemp)) {
+            postSystemEvent(EVT_FAULT);
+        } else if (mode == MODE_WARMUP && tempReached) {
+            postSystemEvent(EVT_TEMP_REACHED);
+        } else if (mode == MODE_VENTING && vented) {
+            postSystemEvent(EVT_VENTED);
+        }
+        
         // TODO: 添加更多安全检查
-        // - 压力传感器断线检测
         // - 加热片短路检测
         // - 泵电流异常检测
         
-        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(500));
+        eventBus.serviceUntil(SUB_SAFETY, xLastWakeTime, pdMS_TO_TICKS(SAFETY_MONITOR_PERIOD_MS), annunciate);
+    }
+}
+
+#if HOT_PATH_BENCH
+/**
+ * @brief 打印可恢复采集的帧大小和一次挂起/恢复的开销（见 Resumable.h）
+ *
+ * 开销用只含一个挂起点的函数测：每轮一次挂起返回 + 一次恢复完成，不含传感器I2C事务。
+ */
+void benchResumable() {
+    struct Probe {
+        ResumeFrame frame;
+        volatile bool ready;
+        ResumeState resume() {
+            RESUMABLE_BEGIN(frame);
+            RESUMABLE_AWAIT(frame, ready);
+            RESUMABLE_END(frame);
+        }
+    };
+    static Probe probe;
+    const uint32_t rounds = 10000;
+    uint32_t pending = 0;
+    uint32_t start = micros();
+    for (uint32_t i = 0; i < rounds; i++) {
+        probe.ready = false;
+        pending += probe.resume() == RESUME_PENDING;
+        probe.ready = true;
+        pending += probe.resume() == RESUME_PENDING;
+    }
+    uint32_t elapsed = micros() - start;
+    safePrint("[基准] 可恢复采集: 帧 %u 字节/传感器 (ResumeFrame %u + 结果 %u), "
+              "挂起+恢复 %lu ns/次 (%lu 轮, 挂起 %lu 次)\n",
+             (unsigned)(sizeof(ResumeFrame) + sizeof(float)), (unsigned)sizeof(ResumeFrame),
+             (unsigned)sizeof(float), (unsigned long)((uint64_t)elapsed * 1000 / rounds),
+             (unsigned long)rounds, (unsigned long)pending);
+}
+
+/**
+ * @brief 基准任务：交替"不写 / 连续写NVS"，每个阶段结束时打印控制回路统计
+ *        和按实测值重算的响应时间（见 ResponseTime.h）
+ * 
+ * 写入内容每次都变，NVS写满一页时会触发擦除，覆盖最长的缓存关闭窗口。
+ * 统计在调度器挂起时取出，控制任务不会在取出途中更新。
+ */
+void taskFlashBench(void* parameter) {
+    Preferences prefs;
+    prefs.begin("hotbench", false);
+    static uint8_t payload[HOT_PATH_BENCH_WRITE_BYTES];
+    bool writing = false;
+    uint32_t phaseStart = millis();
+    uint32_t writes = 0;
+    uint32_t worstWriteUs = 0;
+    static RtaTask measured[RTA_TASK_COUNT];
+    for (size_t i = 0; i < RTA_TASK_COUNT; i++) {
+        measured[i] = RTA_FIRMWARE_TASKS[i];
+    }
+    benchResumable();
+    
+    while (1) {
+        if (millis() - phaseStart >= HOT_PATH_BENCH_PHASE_MS) {
+            vTaskSuspendAll();
+            LoopTimer::Stats t = tempLoopTimer.snapshot();
+            LoopTimer::Stats p = pressureLoopTimer.snapshot();
+            xTaskResumeAll();
+            
+            safePrint("[基准] %s: 写入 %lu 次, 单次最长 %lu µs\n",
+                     writing ? "连续写闪存" : "不写闪存",
+                     (unsigned long)writes, (unsigned long)worstWriteUs);
+            safePrint("[基准]   温度回路 %lu 次, 最坏 %lu µs, 平均 %lu µs, 周期抖动 %lu µs\n",
+                     (unsigned long)t.samples, (unsigned long)t.worstUs,
+                     (unsigned long)t.meanUs, (unsigned long)t.jitterUs);
+            safePrint("[基准]   压力回路 %lu 次, 最坏 %lu µs, 平均 %lu µs, 周期抖动 %lu µs（不含转换等待）\n",
+                     (unsigned long)p.samples, (unsigned long)p.worstUs,
+                     (unsigned long)p.meanUs, (unsigned long)p.jitterUs);
+            
+            // 实测值超过预算时替换后重算响应时间：回路执行时间取不写闪存阶段（写闪存阶段含缓存关闭的停顿），
+            // NVS写入取连续写阶段的单次最长（含扇区擦除）
+            if (!writing) {
+                if (t.worstUs > measured[RTA_TEMPERATURE].wcetUs) {
+                    measured[RTA_TEMPERATURE].wcetUs = t.worstUs;
+                }
+                if (p.worstUs > measured[RTA_PRESSURE].wcetUs) {
+                    measured[RTA_PRESSURE].wcetUs = p.worstUs;
+                }
+            } else if (worstWriteUs > RTA_FLASH_ERASE_US + RTA_NVS_WRITE_US) {
+                measured[RTA_NVS].wcetUs = worstWriteUs + (RTA_NVS_BURST_WRITES - 1) * RTA_NVS_WRITE_US;
+                measured[RTA_NVS].holdUs[RTA_LOCK_FAULT_LOG] = worstWriteUs;
+            }
+            if (rtaReport(measured, [](const char* line) { safePrint("%s\n", line); }) > 0) {
+                safePrint("[基准] 按实测值有硬实时任务可能错过截止期，需调整 config.h 的周期、优先级或预算\n");
+            }
+            
+            writing = !writing;
+            writes = 0;
+            worstWriteUs = 0;
+            phaseStart = millis();
+        }
+        
+        if (writing) {
+            memcpy(payload, &writes, sizeof(writes));
+            uint32_t start = micros();
+            prefs.putBytes("blob", payload, sizeof(payload));
+            uint32_t elapsed = micros() - start;
+            if (elapsed > worstWriteUs) {
+                worstWriteUs = elapsed;
+            }
+            writes++;
+        }
+        
+        vTaskDelay(1);  // 让出CPU给空闲任务（任务看门狗）
     }
 }
+#endif
@@ -0,0 +1,28 @@
+/**
+ * @file TestCheck.h
+ * @brief 单元测试的检查与汇总（输出格式与 host 中的基准程序一致）
+ */
+
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <stdio.h>
+
+static int gFailures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %s %s\n", ok ? "✓" : "✗", what);
+    if (!ok) {
+        gFailures++;
+    }
+}
+
+/**
+ * @brief 打印结论，返回进程退出码（ctest 据此判断）
+ */
+static int testSummary() {
+    printf("%s\n", gFailures == 0 ? "全部检查通过" : "有检查失败");
+    return gFailures == 0 ? 0 : 1;
+}
+
+#endif // TEST_CHECK_H
@@ -0,0 +1,47 @@
+/**
+ * @file FreeRTOS.h
+ * @brief 单元测试用的 FreeRTOS 替身：单线程、节拍由测试推进（见 TestKernel.h）
+ *
+ * 只实现固件和 sim/SimArduino.cpp 用到的接口。任务创建后不运行，延时、带超时的等待
+ * 直接把节拍推进相应时间（期间到期的软件定时器依次回调），所以被测代码在测试线程中
+ * 顺序执行、结果可重复。任务间的并发、优先级和阻塞由主机仿真（../sim）检验。
+ * 配置与主机仿真相同（sim/FreeRTOSConfig.h）。
+ */
+
+#ifndef TEST_FREERTOS_H
+#define TEST_FREERTOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "FreeRTOSConfig.h"
+
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+#define portMAX_DELAY           ((TickType_t)0xFFFFFFFFu)
+#define portTICK_PERIOD_MS      ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+
+#define portYIELD_FROM_ISR(x)   ((void)(x))
+#define taskENTER_CRITICAL()    do { } while (0)
+#define taskEXIT_CRITICAL()     do { } while (0)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void* pvPortMalloc(size_t size);
+void vPortFree(void* p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_FREERTOS_H
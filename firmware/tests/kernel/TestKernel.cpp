@@ -0,0 +1,369 @@
+/**
+ * @file TestKernel.cpp
+ * @brief FreeRTOS 替身的实现（单线程，节拍由 testKernelAdvance 及各种等待推进）
+ */
+
+#include "TestKernel.h"
+#include "queue.h"
+#include "semphr.h"
+#include "timers.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+struct TestTask {
+    std::string name;
+    UBaseType_t priority;
+    uint32_t notifyValue;
+    bool notifyPending;
+};
+
+struct TestTimer {
+    std::string name;
+    TickType_t period;
+    bool autoReload;
+    void* id;
+    TimerCallbackFunction_t callback;
+    bool active;
+    TickType_t expiry;
+};
+
+struct TestQueue {
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    std::deque<std::vector<uint8_t>> items;
+    bool mutex;
+    TaskHandle_t holder;
+};
+
+static TickType_t tickCount = 0;
+static TestTask testThread = {"test", 1, 0, false};     // 测试代码本身所在的“任务”
+static std::vector<TestTask*> tasks;
+static std::vector<TestTimer*> timers;
+
+/**
+ * @brief 无限期等待在单线程下永远不会结束：报告后退出，测试失败
+ */
+static void deadlock(const char* what) {
+    fprintf(stderr, "TestKernel: %s 无限期等待，单线程测试中不会被唤醒\n", what);
+    exit(2);
+}
+
+/**
+ * @brief 最早到期的活动定时器，没有返回NULL
+ */
+static TestTimer* nextTimer() {
+    TestTimer* next = NULL;
+    for (TestTimer* t : timers) {
+        if (t->active && (next == NULL || (int32_t)(t->expiry - next->expiry) < 0)) {
+            next = t;
+        }
+    }
+    return next;
+}
+
+/**
+ * @brief 推进到 deadline，或 done() 为真（每次定时器回调后检查）
+ */
+template <typename Done>
+static void advanceUntil(TickType_t deadline, Done done) {
+    while (!done()) {
+        TestTimer* t = nextTimer();
+        if (t == NULL || (int32_t)(t->expiry - deadline) > 0) {
+            break;
+        }
+        tickCount = t->expiry;
+        if (t->autoReload) {
+            t->expiry += t->period;
+        } else {
+            t->active = false;
+        }
+        t->callback(t);
+    }
+    if (!done() && (int32_t)(deadline - tickCount) > 0) {
+        tickCount = deadline;
+    }
+}
+
+void testKernelAdvance(TickType_t ticks) {
+    advanceUntil(tickCount + ticks, [] { return false; });
+}
+
+TaskHandle_t testKernelTask(const char* name) {
+    for (TestTask* t : tasks) {
+        if (t->name == name) {
+            return t;
+        }
+    }
+    return NULL;
+}
+
+UBaseType_t testKernelTaskPriority(TaskHandle_t task) {
+    return task->priority;
+}
+
+// ---------------------------------------------------------------- 内存 ----
+
+void* pvPortMalloc(size_t size) {
+    return malloc(size);
+}
+
+void vPortFree(void* p) {
+    free(p);
+}
+
+// ---------------------------------------------------------------- 任务 ----
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth, void* parameters,
+                       UBaseType_t priority, TaskHandle_t* created) {
+    TestTask* t = new TestTask{name, priority, 0, false};
+    tasks.push_back(t);
+    if (created != NULL) {
+        *created = t;
+    }
+    return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return &testThread;
+}
+
+char* pcTaskGetName(TaskHandle_t task) {
+    return const_cast<char*>((task != NULL ? task : &testThread)->name.c_str());
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    return 0;
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return tickCount;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    testKernelAdvance(ticks);
+}
+
+BaseType_t xTaskDelayUntil(TickType_t* previousWake, TickType_t increment) {
+    TickType_t wake = *previousWake + increment;
+    *previousWake = wake;
+    if ((int32_t)(wake - tickCount) <= 0) {
+        return pdFALSE;
+    }
+    testKernelAdvance(wake - tickCount);
+    return pdTRUE;
+}
+
+BaseType_t xTaskCatchUpTicks(TickType_t ticks) {
+    testKernelAdvance(ticks);
+    return pdFALSE;
+}
+
+void vTaskSuspendAll(void) {
+}
+
+BaseType_t xTaskResumeAll(void) {
+    return pdFALSE;
+}
+
+BaseType_t xTaskGetSchedulerState(void) {
+    return taskSCHEDULER_RUNNING;
+}
+
+void vTaskStartScheduler(void) {
+    deadlock("vTaskStartScheduler");
+}
+
+// ---------------------------------------------------------------- 通知 ----
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) {
+    switch (action) {
+        case eNoAction:
+            break;
+        case eSetBits:
+            task->notifyValue |= value;
+            break;
+        case eIncrement:
+            task->notifyValue++;
+            break;
+        case eSetValueWithOverwrite:
+            task->notifyValue = value;
+            break;
+        case eSetValueWithoutOverwrite:
+            if (task->notifyPending) {
+                return pdFAIL;
+            }
+            task->notifyValue = value;
+            break;
+    }
+    task->notifyPending = true;
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t* woken) {
+    if (woken != NULL) {
+        *woken = pdFALSE;
+    }
+    return xTaskNotify(task, value, action);
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t* value, TickType_t timeout) {
+    TestTask* self = &testThread;
+    if (!self->notifyPending) {
+        self->notifyValue &= ~clearOnEntry;
+        if (timeout == portMAX_DELAY) {
+            // 定时器回调仍可能发通知：推进到下一个定时器为止
+            while (!self->notifyPending && nextTimer() != NULL) {
+                advanceUntil(nextTimer()->expiry, [self] { return self->notifyPending; });
+            }
+            if (!self->notifyPending) {
+                deadlock("xTaskNotifyWait");
+            }
+        } else {
+            advanceUntil(tickCount + timeout, [self] { return self->notifyPending; });
+        }
+    }
+    if (value != NULL) {
+        *value = self->notifyValue;
+    }
+    if (!self->notifyPending) {
+        return pdFALSE;
+    }
+    self->notifyPending = false;
+    self->notifyValue &= ~clearOnExit;
+    return pdTRUE;
+}
+
+// ---------------------------------------------------------------- 队列 ----
+
+/**
+ * @brief 等待条件成立或超时（期间定时器照常回调）
+ */
+template <typename Ready>
+static bool waitFor(const char* what, TickType_t timeout, Ready ready) {
+    if (ready()) {
+        return true;
+    }
+    if (timeout == portMAX_DELAY) {
+        while (!ready() && nextTimer() != NULL) {
+            advanceUntil(nextTimer()->expiry, ready);
+        }
+        if (!ready()) {
+            deadlock(what);
+        }
+        return true;
+    }
+    advanceUntil(tickCount + timeout, ready);
+    return ready();
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    return new TestQueue{length, itemSize, {}, false, NULL};
+}
+
+static BaseType_t queueSend(QueueHandle_t queue, const void* item, TickType_t timeout, bool front) {
+    if (!waitFor("xQueueSend", timeout, [queue] { return queue->items.size() < queue->length; })) {
+        return pdFAIL;
+    }
+    const uint8_t* p = (const uint8_t*)item;
+    std::vector<uint8_t> copy(p, p + queue->itemSize);
+    if (front) {
+        queue->items.push_front(std::move(copy));
+    } else {
+        queue->items.push_back(std::move(copy));
+    }
+    return pdPASS;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t timeout) {
+    return queueSend(queue, item, timeout, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item, TickType_t timeout) {
+    return queueSend(queue, item, timeout, true);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t timeout) {
+    if (!waitFor("xQueueReceive", timeout, [queue] { return !queue->items.empty(); })) {
+        return pdFAIL;
+    }
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    return (UBaseType_t)queue->items.size();
+}
+
+void vQueueAddToRegistry(QueueHandle_t queue, const char* name) {
+}
+
+// -------------------------------------------------------------- 互斥锁 ----
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    return new TestQueue{1, 0, {}, true, NULL};
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t timeout) {
+    if (!waitFor("xSemaphoreTake", timeout, [mutex] { return mutex->holder == NULL; })) {
+        return pdFAIL;
+    }
+    mutex->holder = xTaskGetCurrentTaskHandle();
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+    if (mutex->holder != xTaskGetCurrentTaskHandle()) {
+        return pdFAIL;
+    }
+    mutex->holder = NULL;
+    return pdPASS;
+}
+
+TaskHandle_t xSemaphoreGetMutexHolder(SemaphoreHandle_t mutex) {
+    return mutex->holder;
+}
+
+// -------------------------------------------------------------- 定时器 ----
+
+TimerHandle_t xTimerCreate(const char* name, TickType_t period, BaseType_t autoReload, void* id,
+                           TimerCallbackFunction_t callback) {
+    if (period == 0) {
+        return NULL;
+    }
+    TestTimer* t = new TestTimer{name, period, autoReload != pdFALSE, id, callback, false, 0};
+    timers.push_back(t);
+    return t;
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t wait) {
+    timer->active = true;
+    timer->expiry = tickCount + timer->period;
+    return pdPASS;
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t wait) {
+    timer->active = false;
+    return pdPASS;
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t wait) {
+    if (period == 0) {
+        return pdFAIL;
+    }
+    timer->period = period;
+    return xTimerStart(timer, wait);
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer) {
+    return timer->active ? pdTRUE : pdFALSE;
+}
+
+void* pvTimerGetTimerID(TimerHandle_t timer) {
+    return timer->id;
+}
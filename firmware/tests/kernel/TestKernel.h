@@ -0,0 +1,27 @@
+/**
+ * @file TestKernel.h
+ * @brief 单元测试控制 FreeRTOS 替身的接口
+ */
+
+#ifndef TEST_KERNEL_H
+#define TEST_KERNEL_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/**
+ * @brief 推进节拍，期间到期的软件定时器按到期先后回调
+ */
+void testKernelAdvance(TickType_t ticks);
+
+/**
+ * @brief 按名字查找 xTaskCreate 登记的任务，没有返回NULL
+ */
+TaskHandle_t testKernelTask(const char* name);
+
+/**
+ * @brief 登记的任务的优先级
+ */
+UBaseType_t testKernelTaskPriority(TaskHandle_t task);
+
+#endif // TEST_KERNEL_H
@@ -0,0 +1,29 @@
+/**
+ * @file queue.h
+ * @brief 单元测试用的队列接口（见 FreeRTOS.h）：满/空时推进超时时间后失败
+ */
+
+#ifndef TEST_QUEUE_H
+#define TEST_QUEUE_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+typedef struct TestQueue* QueueHandle_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t timeout);
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item, TickType_t timeout);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t timeout);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+void vQueueAddToRegistry(QueueHandle_t queue, const char* name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_QUEUE_H
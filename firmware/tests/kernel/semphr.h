@@ -0,0 +1,26 @@
+/**
+ * @file semphr.h
+ * @brief 单元测试用的互斥锁（见 FreeRTOS.h）：单线程下被占用即超时失败
+ */
+
+#ifndef TEST_SEMPHR_H
+#define TEST_SEMPHR_H
+
+#include "queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t timeout);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex);
+TaskHandle_t xSemaphoreGetMutexHolder(SemaphoreHandle_t mutex);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_SEMPHR_H
@@ -0,0 +1,61 @@
+/**
+ * @file task.h
+ * @brief 单元测试用的任务与任务通知接口（见 FreeRTOS.h）
+ */
+
+#ifndef TEST_TASK_H
+#define TEST_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef struct TestTask* TaskHandle_t;
+
+typedef enum {
+    eNoAction = 0,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+    eSetValueWithoutOverwrite
+} eNotifyAction;
+
+#define taskSCHEDULER_SUSPENDED     0
+#define taskSCHEDULER_NOT_STARTED   1
+#define taskSCHEDULER_RUNNING       2
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 只登记任务（名字、优先级），不运行任务函数
+ */
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth, void* parameters,
+                       UBaseType_t priority, TaskHandle_t* created);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+char* pcTaskGetName(TaskHandle_t task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+TickType_t xTaskGetTickCount(void);
+void vTaskDelay(TickType_t ticks);
+BaseType_t xTaskDelayUntil(TickType_t* previousWake, TickType_t increment);
+BaseType_t xTaskCatchUpTicks(TickType_t ticks);
+
+void vTaskSuspendAll(void);
+BaseType_t xTaskResumeAll(void);
+BaseType_t xTaskGetSchedulerState(void);
+void vTaskStartScheduler(void);
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action);
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t* woken);
+/**
+ * @brief 有未取的通知立即返回；否则推进超时时间后返回 pdFALSE（portMAX_DELAY 时测试失败退出）
+ */
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t* value, TickType_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define vTaskDelayUntil(previousWake, increment)    ((void)xTaskDelayUntil((previousWake), (increment)))
+
+#endif // TEST_TASK_H
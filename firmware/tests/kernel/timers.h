@@ -0,0 +1,31 @@
+/**
+ * @file timers.h
+ * @brief 单元测试用的软件定时器（见 FreeRTOS.h）：节拍推进到到期时刻时在测试线程中回调
+ */
+
+#ifndef TEST_TIMERS_H
+#define TEST_TIMERS_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+typedef struct TestTimer* TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t timer);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+TimerHandle_t xTimerCreate(const char* name, TickType_t period, BaseType_t autoReload, void* id,
+                           TimerCallbackFunction_t callback);
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t wait);
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t wait);
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t wait);
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer);
+void* pvTimerGetTimerID(TimerHandle_t timer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TEST_TIMERS_H
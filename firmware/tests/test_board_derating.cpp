@@ -0,0 +1,189 @@
+/**
+ * @file test_board_derating.cpp
+ * @brief 板温降额：BoardDerating::update() 的折线、硬限值回差和读不到温度时的处理
+ *
+ * 每个温度先连续送入 60 个周期（一阶低通 DERATE_FILTER_ALPHA 收敛到 1e-5 以内）再检查：
+ * 1. 折线：板温 START..FULL、芯片温度 START..FULL 之间加热/泵上限线性降到 DERATE_HEATER_MIN / DERATE_PUMP_MIN，
+ *    两个温度取降额较多的一个；一次尖峰经低通后不触发硬限值
+ * 2. 硬限值：达到 *_LIMIT 时上限为0、update() 返回 true；降到 LIMIT - DERATE_RECOVER_MARGIN 之前保持，
+ *    两个温度都降到回差以下才解除，置位和解除各只报告一次
+ * 3. NAN：读不到的温度不参与（只按另一个判断），都读不到时不降额；恢复读数后滤波从新读数重新开始
+ */
+
+#include <math.h>
+#include "TestCheck.h"
+#include "SimHost.h"
+#include "config.h"
+#include "BoardDerating.h"
+
+/**
+ * @brief 连续送入同一组温度直到滤波收敛
+ * @return 期间 update() 返回 true 的次数
+ */
+static int settle(BoardDerating& d, float mcu, float board, int periods = 60) {
+    int changes = 0;
+    for (int i = 0; i < periods; i++) {
+        if (d.update(mcu, board)) {
+            changes++;
+        }
+    }
+    return changes;
+}
+
+/**
+ * @brief 按降额程度计算的期望上限（与实现的取整一致）
+ */
+static uint8_t expectedHeater(float level) {
+    return (uint8_t)(255.0f * (1.0f - level * (1.0f - DERATE_HEATER_MIN)) + 0.5f);
+}
+
+static uint8_t expectedPump(float level) {
+    return (uint8_t)(100.0f * (1.0f - level * (1.0f - DERATE_PUMP_MIN)) + 0.5f);
+}
+
+static bool capsAt(const BoardDerating& d, float level) {
+    return d.heaterLimit() == expectedHeater(level) && d.pumpLimit() == expectedPump(level)
+           && fabsf(d.level() - level) < 1e-3f;
+}
+
+static void testCurve() {
+    printf("降额折线:\n");
+    const float mcuCool = DERATE_MCU_START - 10.0f;
+    const float boardCool = DERATE_BOARD_START - 10.0f;
+    {
+        BoardDerating d;
+        check(d.heaterLimit() == 255 && d.pumpLimit() == 100 && !d.isDerating(), "初始不降额");
+        settle(d, mcuCool, DERATE_BOARD_START);
+        check(capsAt(d, 0.0f) && !d.isDerating(), "板温等于 START：不降额");
+    }
+    const struct {
+        float fraction;
+        const char* what;
+    } points[] = {
+        {0.25f, "板温 START..FULL 的 1/4：上限按折线"},
+        {0.5f,  "板温 START..FULL 的 1/2：上限按折线"},
+        {0.75f, "板温 START..FULL 的 3/4：上限按折线"},
+    };
+    for (const auto& p : points) {
+        BoardDerating d;
+        settle(d, mcuCool, DERATE_BOARD_START + p.fraction * (DERATE_BOARD_FULL - DERATE_BOARD_START));
+        check(capsAt(d, p.fraction) && d.isDerating(), p.what);
+    }
+    {
+        BoardDerating d;
+        settle(d, mcuCool, DERATE_BOARD_FULL);
+        uint8_t heaterFull = d.heaterLimit();
+        uint8_t pumpFull = d.pumpLimit();
+        check(heaterFull == expectedHeater(1.0f) && pumpFull == (uint8_t)(100.0f * DERATE_PUMP_MIN + 0.5f),
+              "板温 FULL：降到 DERATE_HEATER_MIN / DERATE_PUMP_MIN");
+        settle(d, mcuCool, (DERATE_BOARD_FULL + DERATE_BOARD_LIMIT) / 2.0f);
+        check(d.heaterLimit() == heaterFull && d.pumpLimit() == pumpFull && !d.isOverLimit(),
+              "FULL..LIMIT 之间保持最低上限，不报警");
+    }
+    {
+        BoardDerating d;
+        settle(d, DERATE_MCU_START + 0.5f * (DERATE_MCU_FULL - DERATE_MCU_START), boardCool);
+        check(capsAt(d, 0.5f), "芯片温度 START..FULL 的 1/2：上限按折线");
+    }
+    {
+        // 板温 1/4、芯片 3/4：取降额较多的芯片
+        BoardDerating d;
+        settle(d, DERATE_MCU_START + 0.75f * (DERATE_MCU_FULL - DERATE_MCU_START),
+               DERATE_BOARD_START + 0.25f * (DERATE_BOARD_FULL - DERATE_BOARD_START));
+        check(capsAt(d, 0.75f), "两个温度都在降额区：取降额较多的一个");
+    }
+    {
+        BoardDerating d;
+        settle(d, mcuCool, boardCool);
+        bool changed = d.update(mcuCool, DERATE_BOARD_LIMIT + 20.0f);
+        check(!changed && !d.isOverLimit() && d.boardTemperature() < DERATE_BOARD_LIMIT,
+              "单个周期的板温尖峰经低通后不触发硬限值");
+    }
+}
+
+static void testHysteresis() {
+    printf("硬限值与回差（DERATE_RECOVER_MARGIN %.1f°C）:\n", DERATE_RECOVER_MARGIN);
+    const float mcuCool = DERATE_MCU_START - 10.0f;
+    const float boardCool = DERATE_BOARD_START - 10.0f;
+    {
+        BoardDerating d;
+        settle(d, mcuCool, DERATE_BOARD_FULL);
+        int raised = settle(d, mcuCool, DERATE_BOARD_LIMIT + 1.0f);
+        check(raised == 1 && d.isOverLimit() && d.isDerating(), "板温达到硬限值：报警（只报告一次）");
+        check(d.heaterLimit() == 0 && d.pumpLimit() == 0, "报警时加热和泵上限为0");
+
+        // 回落到 LIMIT - MARGIN 之上：保持
+        int changes = settle(d, mcuCool, DERATE_BOARD_LIMIT - DERATE_RECOVER_MARGIN + 0.5f);
+        check(changes == 0 && d.isOverLimit() && d.heaterLimit() == 0, "回落但未低于回差：保持报警");
+
+        // 低于回差：解除，上限回到折线
+        float recovered = DERATE_BOARD_LIMIT - DERATE_RECOVER_MARGIN - 0.5f;
+        int cleared = settle(d, mcuCool, recovered);
+        float level = (recovered - DERATE_BOARD_START) / (DERATE_BOARD_FULL - DERATE_BOARD_START);
+        check(cleared == 1 && !d.isOverLimit() && capsAt(d, fminf(level, 1.0f)),
+              "低于 LIMIT - MARGIN：解除（只报告一次），上限回到折线");
+    }
+    {
+        BoardDerating d;
+        int raised = settle(d, DERATE_MCU_LIMIT + 1.0f, boardCool);
+        check(raised == 1 && d.isOverLimit(), "芯片温度达到硬限值：报警");
+        settle(d, DERATE_MCU_LIMIT - DERATE_RECOVER_MARGIN + 0.5f, boardCool);
+        check(d.isOverLimit(), "芯片温度未低于回差：保持");
+        settle(d, DERATE_MCU_LIMIT - DERATE_RECOVER_MARGIN - 0.5f, boardCool);
+        check(!d.isOverLimit(), "芯片温度低于回差：解除");
+    }
+    {
+        // 板温触发时芯片温度在回差带内：板温回落后仍保持，直到两个都低于回差
+        BoardDerating d;
+        const float mcuBand = DERATE_MCU_LIMIT - DERATE_RECOVER_MARGIN + 0.5f;
+        settle(d, mcuBand, DERATE_BOARD_LIMIT + 1.0f);
+        settle(d, mcuBand, boardCool);
+        check(d.isOverLimit(), "板温已回落、芯片温度在回差带内：保持");
+        settle(d, mcuCool, boardCool);
+        check(!d.isOverLimit() && capsAt(d, 0.0f), "两个温度都低于回差：解除并不再降额");
+    }
+}
+
+static void testMissingReadings() {
+    printf("读不到温度:\n");
+    const float boardHalf = DERATE_BOARD_START + 0.5f * (DERATE_BOARD_FULL - DERATE_BOARD_START);
+    const float mcuHalf = DERATE_MCU_START + 0.5f * (DERATE_MCU_FULL - DERATE_MCU_START);
+    {
+        BoardDerating d;
+        settle(d, NAN, boardHalf);
+        check(capsAt(d, 0.5f) && isnan(d.mcuTemperature()), "芯片温度读不到：只按板温");
+    }
+    {
+        BoardDerating d;
+        settle(d, mcuHalf, NAN);
+        check(capsAt(d, 0.5f) && isnan(d.boardTemperature()), "板温读不到（MAX6675 无冷端）：只按芯片温度");
+    }
+    {
+        BoardDerating d;
+        settle(d, NAN, NAN);
+        check(capsAt(d, 0.0f) && !d.isDerating(), "都读不到：不降额");
+    }
+    {
+        BoardDerating d;
+        settle(d, NAN, DERATE_BOARD_LIMIT + 1.0f);
+        check(d.isOverLimit(), "芯片温度读不到时板温仍能触发硬限值");
+        int cleared = settle(d, NAN, DERATE_BOARD_LIMIT - DERATE_RECOVER_MARGIN - 0.5f);
+        check(cleared == 1 && !d.isOverLimit(), "读不到的温度不阻止解除");
+    }
+    {
+        BoardDerating d;
+        settle(d, NAN, boardHalf);
+        d.update(NAN, NAN);
+        check(isnan(d.boardTemperature()) && capsAt(d, 0.0f), "板温变为读不到：不沿用旧的滤波值");
+        d.update(NAN, DERATE_BOARD_START - 10.0f);
+        check(d.boardTemperature() == DERATE_BOARD_START - 10.0f, "恢复读数后滤波从新读数开始");
+    }
+}
+
+int main() {
+    simSerialQuiet = true;
+    testCurve();
+    testHysteresis();
+    testMissingReadings();
+    return testSummary();
+}
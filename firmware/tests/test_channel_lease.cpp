@@ -0,0 +1,239 @@
+/**
+ * @file test_channel_lease.cpp
+ * @brief 传感器读取出错时的输出租约：ControlChannel + 真实传感器驱动 + LeaseMonitor
+ *
+ * 热电偶（MAX31855 时序）由引脚钩子移出帧，压力传感器（CPS610，0x7F）为仿真I2C器件，
+ * 租约监视定时器在替身内核中按节拍回调。驱动在连续出错达到上限前返回上次读数（isFresh() 为false）：
+ * 1. 热电偶开路：出错的读数不刷新加热输出，最后一次新读数后 HEATER_LEASE_MS 由租约清零，
+ *    早于驱动返回NAN；读数恢复后输出恢复
+ * 2. 只错一次：下一次新读数在租约时限内续约，输出不清零
+ * 3. 压力传感器无应答：同样不刷新泵速，最后一次新读数后 PUMP_LEASE_MS 清零
+ * 4. 读数沿用期间停止抽气/加热照常执行
+ * 5. 两次读取间隔短于热电偶转换时间：驱动返回缓存的读数（isFresh() 为false），同样不续约
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <math.h>
+#include "TestCheck.h"
+#include "TestKernel.h"
+#include "SimHost.h"
+#include "config.h"
+#include "TemperatureSensor.h"
+#include "PressureSensor.h"
+#include "ControlChannel.h"
+#include "OutputLease.h"
+
+typedef ControlChannel<PressureSensor, TemperatureSensor> Channel;
+
+static const ChannelPins kPins = {
+    HEATING_PAD_PIN, PWM_CHANNEL_HEAT, PUMP_PWM_PIN, PWM_CHANNEL_PUMP,
+    THERMO_CLK_PIN, THERMO_CS_PIN, THERMO_MISO_PIN,
+    PRESSURE_SDA_PIN, PRESSURE_SCL_PIN, PRESSURE_I2C_ADDR
+};
+
+// ============ 热电偶（MAX31855，热端 = 冷端 = 30°C） ============
+
+static bool thermoOpen = false;
+static bool thermoSelected = false;
+static uint8_t thermoBit = 0;
+static uint32_t thermoFrame = 0;
+
+static void onPinWrite(uint8_t pin, uint8_t level) {
+    if (pin == THERMO_CS_PIN) {
+        thermoSelected = (level == LOW);
+        thermoBit = 0;
+        // 热端 30°C（D31~D18，0.25°C）、冷端 30°C（D15~D4，0.0625°C）；开路置 D16 和 D0
+        thermoFrame = ((uint32_t)(30 * 4) << 18) | ((uint32_t)(30 * 16) << 4);
+        if (thermoOpen) {
+            thermoFrame |= 0x00010001;
+        }
+    } else if (pin == THERMO_CLK_PIN && level == LOW && thermoSelected && thermoBit < 32) {
+        thermoBit++;
+    }
+}
+
+static int onPinRead(uint8_t pin) {
+    if (pin != THERMO_MISO_PIN || !thermoSelected) {
+        return -1;
+    }
+    return thermoBit < 32 ? (int)((thermoFrame >> (31 - thermoBit)) & 1) : LOW;
+}
+
+// ============ 压力传感器（CPS610：写 0x30 启动转换，立即完成） ============
+
+class PressureDevice : public SimI2CDevice {
+public:
+    uint32_t raw = 0x400000;        // 半量程 = 0 kPa
+
+    void writeRegisters(uint8_t reg, const uint8_t* data, size_t len) override {
+        if (reg == 0x30 && len > 0) {
+            command = data[0] & ~0x08;
+        }
+    }
+
+    uint8_t readRegister(uint8_t reg) override {
+        switch (reg) {
+            case 0x30: return command;
+            case 0x06: return (uint8_t)(raw >> 16);
+            case 0x07: return (uint8_t)(raw >> 8);
+            case 0x08: return (uint8_t)raw;
+        }
+        return 0;
+    }
+
+private:
+    uint8_t command = 0;
+};
+
+static PressureDevice pressureDevice;
+static const float TARGET_VACUUM = 7.5f;     // 目标负压 (mmHg)，读数为0时泵速非零
+
+/**
+ * @brief 完成一次压力采样（转换期间推进节拍到 pressureWakeAt()）
+ */
+static ChannelEvent samplePressure(Channel& ch, bool allowPump) {
+    ChannelEvent e;
+    while ((e = ch.servicePressure(allowPump, TARGET_VACUUM)) == CHANNEL_EVENT_PRESSURE_PENDING) {
+        int32_t wait = (int32_t)(ch.pressureWakeAt() - millis());
+        testKernelAdvance(wait > 0 ? (TickType_t)wait : 1);
+    }
+    return e;
+}
+
+static void testHeaterLease(Channel& ch) {
+    printf("热电偶开路（租约 %u ms，采样周期 %u ms）:\n", HEATER_LEASE_MS, TEMP_SAMPLE_PERIOD_MS);
+    OutputLease& lease = ch.heating().lease();
+    uint32_t expiries = lease.getExpiryCount();
+
+    ChannelEvent e = ch.serviceTemperature(true);
+    check(e == CHANNEL_EVENT_NONE && ch.temperature().isFresh() && simLedcDuty(PWM_CHANNEL_HEAT) > 0,
+          "新读数：PID 输出非零");
+    uint32_t lastFresh = millis();
+
+    // 前两次出错：驱动返回上次读数，不刷新输出
+    thermoOpen = true;
+    testKernelAdvance(TEMP_SAMPLE_PERIOD_MS);
+    e = ch.serviceTemperature(true);
+    check(e == CHANNEL_EVENT_NONE && !ch.temperature().isFresh(), "第一次出错：沿用上次读数，isFresh() 为false");
+    testKernelAdvance(TEMP_SAMPLE_PERIOD_MS);
+    ch.serviceTemperature(true);
+    check(lease.getExpiryCount() == expiries && simLedcDuty(PWM_CHANNEL_HEAT) > 0, "租约时限内输出保持");
+
+    testKernelAdvance(lastFresh + HEATER_LEASE_MS + OUTPUT_LEASE_CHECK_MS - millis());
+    check(lease.getExpiryCount() == expiries + 1 && simLedcDuty(PWM_CHANNEL_HEAT) == 0,
+          "沿用的读数不续约：最后一次新读数后 HEATER_LEASE_MS 清零");
+    uint32_t lateMs = 0;
+    check(lease.takeExpiry(lateMs) && lateMs <= HEATER_LEASE_MS + OUTPUT_LEASE_CHECK_MS, "到期时距最后一次刷新不超过时限 + 检查周期");
+
+    testKernelAdvance(lastFresh + 3 * TEMP_SAMPLE_PERIOD_MS - millis());
+    e = ch.serviceTemperature(true);
+    check(e == CHANNEL_EVENT_TEMP_ERROR, "第三次出错：读数为NAN，报告温度错误");
+
+    thermoOpen = false;
+    testKernelAdvance(TEMP_SAMPLE_PERIOD_MS);
+    e = ch.serviceTemperature(true);
+    check(e == CHANNEL_EVENT_NONE && simLedcDuty(PWM_CHANNEL_HEAT) > 0, "读数恢复后输出恢复");
+
+    // 只错一次
+    expiries = lease.getExpiryCount();
+    thermoOpen = true;
+    testKernelAdvance(TEMP_SAMPLE_PERIOD_MS);
+    ch.serviceTemperature(true);
+    thermoOpen = false;
+    testKernelAdvance(TEMP_SAMPLE_PERIOD_MS);
+    ch.serviceTemperature(true);
+    testKernelAdvance(TEMP_SAMPLE_PERIOD_MS);
+    check(lease.getExpiryCount() == expiries && simLedcDuty(PWM_CHANNEL_HEAT) > 0,
+          "只错一次：下一次新读数在时限内续约，输出不清零");
+
+    // 沿用读数期间停止加热
+    thermoOpen = true;
+    testKernelAdvance(TEMP_SAMPLE_PERIOD_MS);
+    ch.serviceTemperature(false);
+    check(!ch.heating().isEnabled() && simLedcDuty(PWM_CHANNEL_HEAT) == 0, "沿用读数期间停止加热照常执行");
+    thermoOpen = false;
+    testKernelAdvance(TEMP_SAMPLE_PERIOD_MS);
+    ch.serviceTemperature(false);
+}
+
+static void testConversionInterval(Channel& ch) {
+    printf("读取间隔短于转换时间（%u ms）:\n", MAX31855Chip::CONVERSION_TIME_MS);
+    OutputLease& lease = ch.heating().lease();
+    uint32_t expiries = lease.getExpiryCount();
+
+    testKernelAdvance(TEMP_SAMPLE_PERIOD_MS);
+    ch.serviceTemperature(true);
+    uint32_t lastFresh = millis();
+    check(ch.temperature().isFresh() && simLedcDuty(PWM_CHANNEL_HEAT) > 0, "新读数：PID 输出非零");
+
+    // 转换结束前 10 ms 再读：若缓存读数续约，租约要到 lastFresh + CONVERSION_TIME_MS - 10 + HEATER_LEASE_MS
+    // 才到期，晚于下面检查的时刻
+    testKernelAdvance(MAX31855Chip::CONVERSION_TIME_MS - 10);
+    ChannelEvent e = ch.serviceTemperature(true);
+    check(e == CHANNEL_EVENT_NONE && !ch.temperature().isFresh(), "转换间隔内：返回缓存的读数，isFresh() 为false");
+
+    testKernelAdvance(lastFresh + HEATER_LEASE_MS + OUTPUT_LEASE_CHECK_MS - millis());
+    check(lease.getExpiryCount() == expiries + 1 && simLedcDuty(PWM_CHANNEL_HEAT) == 0,
+          "缓存的读数不续约：最后一次新读数后 HEATER_LEASE_MS 清零");
+    uint32_t lateMs = 0;
+    lease.takeExpiry(lateMs);
+
+    testKernelAdvance(TEMP_SAMPLE_PERIOD_MS);
+    e = ch.serviceTemperature(true);
+    check(e == CHANNEL_EVENT_NONE && ch.temperature().isFresh() && simLedcDuty(PWM_CHANNEL_HEAT) > 0,
+          "转换完成后的新读数恢复输出");
+}
+
+static void testPumpLease(Channel& ch) {
+    printf("压力传感器无应答（租约 %u ms，采样周期 %u ms）:\n", PUMP_LEASE_MS, PRESSURE_SAMPLE_PERIOD_MS);
+    OutputLease& lease = ch.pumpController().lease();
+    uint32_t expiries = lease.getExpiryCount();
+
+    ChannelEvent e = samplePressure(ch, true);
+    check(e == CHANNEL_EVENT_NONE && ch.pressure().isFresh() && simLedcDuty(PWM_CHANNEL_PUMP) > 0,
+          "新读数：泵运行");
+    uint32_t lastFresh = millis();
+
+    Wire.attach(0x7F, NULL);
+    testKernelAdvance(PRESSURE_SAMPLE_PERIOD_MS);
+    e = samplePressure(ch, true);
+    check(e == CHANNEL_EVENT_NONE && !ch.pressure().isFresh(), "第一次出错：沿用上次读数，isFresh() 为false");
+    testKernelAdvance(PRESSURE_SAMPLE_PERIOD_MS);
+    samplePressure(ch, true);
+    check(lease.getExpiryCount() == expiries && simLedcDuty(PWM_CHANNEL_PUMP) > 0, "租约时限内输出保持");
+
+    testKernelAdvance(lastFresh + PUMP_LEASE_MS + OUTPUT_LEASE_CHECK_MS - millis());
+    check(lease.getExpiryCount() == expiries + 1 && simLedcDuty(PWM_CHANNEL_PUMP) == 0,
+          "沿用的读数不刷新泵速：最后一次新读数后 PUMP_LEASE_MS 清零");
+
+    Wire.attach(0x7F, &pressureDevice);
+    testKernelAdvance(PRESSURE_SAMPLE_PERIOD_MS);
+    e = samplePressure(ch, true);
+    check(e == CHANNEL_EVENT_NONE && simLedcDuty(PWM_CHANNEL_PUMP) > 0, "读数恢复后泵输出恢复");
+
+    Wire.attach(0x7F, NULL);
+    testKernelAdvance(PRESSURE_SAMPLE_PERIOD_MS);
+    samplePressure(ch, false);
+    check(!ch.pumpController().isRunning() && simLedcDuty(PWM_CHANNEL_PUMP) == 0, "沿用读数期间停止抽气照常执行");
+    Wire.attach(0x7F, &pressureDevice);
+}
+
+int main() {
+    simSerialQuiet = true;
+    testKernelAdvance(1);
+    simSetPinHooks(onPinWrite, onPinRead);
+    Wire.attach(0x7F, &pressureDevice);
+
+    Channel ch(0, kPins);
+    check(ch.begin(), "通道初始化：两个传感器就绪");
+    LeaseMonitor monitor;
+    monitor.add(ch.heating().lease());
+    monitor.add(ch.pumpController().lease());
+    check(monitor.begin(), "租约监视定时器启动");
+
+    testHeaterLease(ch);
+    testConversionInterval(ch);
+    testPumpLease(ch);
+    return testSummary();
+}
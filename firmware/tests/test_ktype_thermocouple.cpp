@@ -0,0 +1,147 @@
+/**
+ * @file test_ktype_thermocouple.cpp
+ * @brief K型热电偶线性化：对照 NIST ITS-90 参考表的精度，以及查表/多项式的耗时
+ *
+ * 1. 正向多项式与 NIST 参考表（-10~100°C 的若干点，mV 保留3位）一致到表的舍入；反向多项式在 NIST 公布的
+ *    误差范围（0~500°C：-0.05~+0.04°C）内
+ * 2. 端到端：按 MAX31855 的规则由真实热端/冷端温度生成原始计数
+ *    （T_reported = T_cj + (E(T_hot) - E(T_cj)) / 41.276µV，量化到 0.25°C / 0.0625°C），
+ *    linearize() 还原出的温度误差不超过热端量化（0.125°C）加多项式误差
+ * 3. 工作范围内定点查表与浮点多项式的最大偏差 < 0.003°C（KTypeThermocouple.h 的承诺）
+ * 4. 每次调用耗时（主机，仅供对比；目标板 ESP32-C3 无FPU，差距更大）
+ */
+
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "TestCheck.h"
+#include "KTypeThermocouple.h"
+
+/**
+ * @brief NIST ITS-90 K型参考表（参考端 0°C），摘自 NIST Monograph 175
+ */
+struct NistPoint {
+    float celsius;
+    float millivolts;
+};
+
+static const NistPoint NIST_K[] = {
+    {-10.0f, -0.392f},
+    {  0.0f,  0.000f},
+    { 10.0f,  0.397f},
+    { 20.0f,  0.798f},
+    { 25.0f,  1.000f},
+    { 30.0f,  1.203f},
+    { 40.0f,  1.612f},
+    { 50.0f,  2.023f},
+    { 60.0f,  2.436f},
+    { 70.0f,  2.851f},
+    { 80.0f,  3.267f},
+    {100.0f,  4.096f},
+};
+
+static float nistMillivolts(float celsius) {
+    for (const NistPoint& p : NIST_K) {
+        if (p.celsius == celsius) {
+            return p.millivolts;
+        }
+    }
+    return NAN;
+}
+
+static void testPolynomials() {
+    printf("NIST 多项式:\n");
+    float forward = 0.0f;
+    float inverse = 0.0f;
+    for (const NistPoint& p : NIST_K) {
+        forward = fmaxf(forward, fabsf(KTypeThermocouple::voltageFromTemperature(p.celsius) - p.millivolts));
+        inverse = fmaxf(inverse, fabsf(KTypeThermocouple::temperatureFromVoltage(p.millivolts) - p.celsius));
+    }
+    printf("  正向最大偏差 %.4f mV，反向最大偏差 %.3f °C\n", forward, inverse);
+    check(forward <= 0.0006f, "正向多项式与参考表一致（表保留到 0.001 mV）");
+    // 反向多项式误差 0.05°C + 参考表舍入 0.0005mV（约 0.013°C）
+    check(inverse <= 0.065f, "反向多项式在 NIST 公布的误差范围内");
+}
+
+static void testChipEndToEnd() {
+    printf("MAX31855 原始计数 -> 温度:\n");
+    const float hotPoints[] = {25.0f, 30.0f, 40.0f, 50.0f, 60.0f, 70.0f, 80.0f};
+    const float coldPoints[] = {0.0f, 10.0f, 20.0f, 25.0f, 30.0f, 40.0f};
+    float linearized = 0.0f;
+    float linear = 0.0f;
+    for (float hot : hotPoints) {
+        for (float cold : coldPoints) {
+            float mv = nistMillivolts(hot) - nistMillivolts(cold);
+            float reported = cold + mv * 1000.0f / 41.276f;
+            int16_t hotCounts = (int16_t)lroundf(reported * 4.0f);
+            int16_t coldCounts = (int16_t)lroundf(cold * 16.0f);
+            linearized = fmaxf(linearized, fabsf(KTypeThermocouple::linearize(hotCounts, coldCounts) - hot));
+            linear = fmaxf(linear, fabsf(hotCounts * 0.25f - hot));
+        }
+    }
+    printf("  热端 25~80°C、冷端 0~40°C：线性化最大误差 %.3f °C，芯片线性读数最大误差 %.3f °C\n",
+           linearized, linear);
+    check(linearized <= 0.2f, "线性化误差不超过量化 0.125°C + 多项式误差");
+    check(linearized < linear, "线性化比芯片的线性读数更准");
+}
+
+static void testTableAgainstPolynomial() {
+    printf("定点查表 vs 浮点多项式:\n");
+    float maxDiff = 0.0f;
+    int samples = 0;
+    // 工作范围：热端 0~83°C，冷端 0~80°C
+    for (int cold = 0; cold < 80 * 16; cold += 3) {
+        for (int hot = 0; hot <= 83 * 4; hot++) {
+            float a = KTypeThermocouple::linearize((int16_t)hot, (int16_t)cold);
+            float b = KTypeThermocouple::linearizeFull((int16_t)hot, (int16_t)cold);
+            maxDiff = fmaxf(maxDiff, fabsf(a - b));
+            samples++;
+        }
+    }
+    printf("  %d 组计数，最大偏差 %.4f °C\n", samples, maxDiff);
+    check(maxDiff < 0.003f, "工作范围内查表与多项式偏差 < 0.003°C");
+
+    // 超出表范围时回退到多项式（热端超出时冷端仍查表）
+    check(KTypeThermocouple::linearize(800, -80) == KTypeThermocouple::linearizeFull(800, -80),
+          "冷端为负时整体回退到多项式");
+    check(fabsf(KTypeThermocouple::linearize(1600, 400) - KTypeThermocouple::linearizeFull(1600, 400)) < 0.003f,
+          "热端超出反向表（400°C）时反查回退到多项式");
+}
+
+static void benchmark() {
+    printf("耗时（主机）:\n");
+    std::vector<std::pair<int16_t, int16_t>> inputs;
+    for (int cold = 0; cold <= 45 * 16; cold += 3) {
+        for (int hot = 20 * 4; hot <= 60 * 4; hot++) {
+            inputs.push_back({(int16_t)hot, (int16_t)cold});
+        }
+    }
+    const int rounds = 50;
+    volatile float sink = 0.0f;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (const auto& p : inputs) {
+            sink = sink + KTypeThermocouple::linearize(p.first, p.second);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (const auto& p : inputs) {
+            sink = sink + KTypeThermocouple::linearizeFull(p.first, p.second);
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    double calls = (double)rounds * inputs.size();
+    printf("  查表 %.1f ns/次，多项式 %.1f ns/次（%zu 组 x %d 轮）\n",
+           std::chrono::duration<double, std::nano>(t1 - t0).count() / calls,
+           std::chrono::duration<double, std::nano>(t2 - t1).count() / calls,
+           inputs.size(), rounds);
+}
+
+int main() {
+    testPolynomials();
+    testChipEndToEnd();
+    testTableAgainstPolynomial();
+    benchmark();
+    return testSummary();
+}
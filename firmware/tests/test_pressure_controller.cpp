@@ -0,0 +1,209 @@
+/**
+ * @file test_pressure_controller.cpp
+ * @brief 负压控制：RateEstimator 斜率估计与 PressureController 的气体定律前馈
+ *
+ * 1. RateEstimator：样本不足返回NAN；直线的斜率精确；热电偶 0.25°C 量化下斜率噪声小于直接差分；
+ *    millis() 回绕不影响结果
+ * 2. PressureController：前馈量等于 (P/T)·k·dT/dt / 泵增益，温度或变化率为NAN时不前馈；
+ *    输出上限与抗饱和
+ * 3. 闭环：测试内的腔体模型（泵抽气、泄漏、腔内气温跟随加热片），加热片温度按
+ *    37→45→37°C 阶跃过渡，同一控制器有/无前馈时比较负压偏离目标的最大值与均方根。
+ *    时间由节拍替身推进，PI 的 dt 与固件一致来自 millis()
+ */
+
+#include <math.h>
+#include "TestCheck.h"
+#include "TestKernel.h"
+#include "SimHost.h"
+#include "config.h"
+#include "PressureController.h"
+#include "RateEstimator.h"
+
+static void testRateEstimator() {
+    printf("RateEstimator:\n");
+    RateEstimator<8> rate;
+    for (uint32_t i = 0; i < 7; i++) {
+        rate.add(i * 500, 30.0f + i * 0.1f);
+    }
+    check(isnan(rate.slope()), "不足 8 个样本时返回NAN");
+    rate.add(3500, 30.7f);
+    check(fabsf(rate.slope() - 0.2f) < 1e-4f, "0.1°C / 500ms 的直线：0.2 °C/s");
+
+    // millis() 在窗口中间回绕
+    rate.reset();
+    check(isnan(rate.slope()), "reset() 后重新积累样本");
+    uint32_t start = 0xFFFFFFFFu - 1999;
+    for (uint32_t i = 0; i < 8; i++) {
+        rate.add(start + i * 500, 40.0f - i * 0.25f);
+    }
+    check(fabsf(rate.slope() + 0.5f) < 1e-4f, "时间戳回绕时斜率不变（-0.5 °C/s）");
+
+    // 0.05 °C/s 的升温按 0.25°C 量化：拟合斜率 vs 相邻样本差分
+    rate.reset();
+    float fitError = 0.0f;
+    float diffError = 0.0f;
+    float last = NAN;
+    for (uint32_t i = 0; i < 400; i++) {
+        float t = i * 0.5f;
+        float quantized = roundf((37.0f + 0.05f * t) * 4.0f) / 4.0f;
+        rate.add(i * 500, quantized);
+        float s = rate.slope();
+        if (!isnan(s)) {
+            fitError = fmaxf(fitError, fabsf(s - 0.05f));
+        }
+        if (!isnan(last)) {
+            diffError = fmaxf(diffError, fabsf((quantized - last) / 0.5f - 0.05f));
+        }
+        last = quantized;
+    }
+    printf("  0.25°C 量化、0.05 °C/s：拟合斜率最大误差 %.3f °C/s，直接差分 %.3f °C/s\n", fitError, diffError);
+    check(fitError <= 0.06f, "拟合斜率误差 <= 0.06 °C/s");
+    check(fitError * 5.0f < diffError, "拟合斜率噪声不到直接差分的 1/5");
+}
+
+static void testFeedForward() {
+    printf("PressureController 前馈:\n");
+    PressureController ctrl;
+    testKernelAdvance(PRESSURE_SAMPLE_PERIOD_MS);
+
+    // 40°C、负压15mmHg、升温 1 °C/s
+    uint8_t out = ctrl.update(15.0f, 15.0f, 40.0f, 1.0f);
+    float expected = (PRESSURE_ATM_MMHG - 15.0f) / (40.0f + 273.15f) * PRESSURE_FF_COUPLING / PRESSURE_PUMP_GAIN;
+    printf("  前馈 %.2f %%（期望 %.2f %%），输出 %u %%\n", ctrl.getFeedForward(), expected, out);
+#if PRESSURE_THERMAL_FF
+    check(fabsf(ctrl.getFeedForward() - expected) < 1e-3f, "前馈 = (P/T)·k·dT/dt / 泵增益");
+    check(out == (uint8_t)(expected + 0.5f), "误差为0时输出即前馈");
+#else
+    check(ctrl.getFeedForward() == 0.0f, "PRESSURE_THERMAL_FF=0：不前馈");
+#endif
+
+    testKernelAdvance(PRESSURE_SAMPLE_PERIOD_MS);
+    ctrl.update(15.0f, 15.0f, 40.0f, NAN);
+    check(ctrl.getFeedForward() == 0.0f, "变化率为NAN（样本不足或过期）时不前馈");
+    testKernelAdvance(PRESSURE_SAMPLE_PERIOD_MS);
+    ctrl.update(15.0f, 15.0f, NAN, 1.0f);
+    check(ctrl.getFeedForward() == 0.0f, "温度为NAN时不前馈");
+    testKernelAdvance(PRESSURE_SAMPLE_PERIOD_MS);
+    ctrl.update(15.0f, 15.0f, 40.0f, -1.0f);
+    check(ctrl.getFeedForward() < 0.0f, "降温时前馈为负（减小泵速）");
+}
+
+static void testLimits() {
+    printf("PressureController 限幅与抗饱和:\n");
+    PressureController ctrl;
+    ctrl.setOutputLimit(40);
+    uint8_t out = 0;
+    // 腔体漏气，长时间达不到目标
+    for (int i = 0; i < 100; i++) {
+        testKernelAdvance(PRESSURE_SAMPLE_PERIOD_MS);
+        out = ctrl.update(15.0f, 2.0f, NAN, NAN);
+    }
+    check(out == 40, "输出不超过 setOutputLimit()");
+
+    // 达到目标后：积分没有在饱和期间累积，输出立即回落
+    testKernelAdvance(PRESSURE_SAMPLE_PERIOD_MS);
+    out = ctrl.update(15.0f, 16.0f, NAN, NAN);
+    printf("  饱和 10 s 后越过目标 1 mmHg：输出 %u %%\n", out);
+    check(out < 40, "饱和期间不积分，越过目标时输出立即回落");
+
+    ctrl.reset();
+    testKernelAdvance(PRESSURE_SAMPLE_PERIOD_MS);
+    check(ctrl.update(0.0f, 10.0f, NAN, NAN) == 0, "负误差时输出不低于 0");
+}
+
+/**
+ * @brief 腔体模型：泵抽气 PRESSURE_PUMP_GAIN·u，泄漏与负压成正比，
+ *        腔内气温一阶跟随加热片与皮肤的加权平均，按气体定律改变负压
+ */
+struct Chamber {
+    double pad = 37.0;          // 加热片温度 (°C)
+    double air = 0.0;           // 腔内气温 (°C)
+    double vacuum = 15.0;       // 负压 (mmHg)
+    double padTarget = 37.0;
+
+    Chamber() {
+        air = mixTarget();
+    }
+
+    double mixTarget() const {
+        return 0.75 * pad + 0.25 * 34.0;
+    }
+
+    void step(double dt, uint8_t pump) {
+        pad += dt * (padTarget - pad) / 20.0;
+        double dAir = (mixTarget() - air) / 3.0;
+        air += dt * dAir;
+        vacuum += dt * (PRESSURE_PUMP_GAIN * pump - 0.1 * vacuum
+                        - (PRESSURE_ATM_MMHG - vacuum) / (air + 273.15) * dAir);
+    }
+};
+
+struct Deviation {
+    double max;
+    double rms;
+};
+
+/**
+ * @brief 闭环运行：温度 500ms 采样（0.25°C 量化）进 RateEstimator，压力 100ms 更新
+ */
+static Deviation runClosedLoop(bool feedForward) {
+    const double target = 15.0;
+    const uint32_t stepMs = 10;
+    Chamber chamber;
+    PressureController ctrl;
+    RateEstimator<TEMP_RATE_WINDOW> rate;
+    uint8_t pump = 0;
+    double maxDev = 0.0;
+    double sum = 0.0;
+    long samples = 0;
+
+    // 先在 37°C 稳定 60 s，之后 45°C、再回 37°C 各 120 s；统计两次过渡的前 60 s
+    for (uint32_t t = 0; t < 300000; t += stepMs) {
+        if (t == 60000) {
+            chamber.padTarget = 45.0;
+        } else if (t == 180000) {
+            chamber.padTarget = 37.0;
+        }
+        uint32_t now = millis();
+        if (t % 500 == 0) {
+            rate.add(now, roundf((float)chamber.pad * 4.0f) / 4.0f);
+        }
+        if (t % PRESSURE_SAMPLE_PERIOD_MS == 0) {
+            float padTemp = roundf((float)chamber.pad * 4.0f) / 4.0f;
+            pump = ctrl.update((float)target, (float)chamber.vacuum, padTemp, feedForward ? rate.slope() : NAN);
+        }
+        bool window = (t >= 60000 && t < 120000) || (t >= 180000 && t < 240000);
+        if (window) {
+            double d = fabs(chamber.vacuum - target);
+            maxDev = fmax(maxDev, d);
+            sum += d * d;
+            samples++;
+        }
+        chamber.step(stepMs / 1000.0, pump);
+        testKernelAdvance(stepMs);
+    }
+    return Deviation{maxDev, sqrt(sum / samples)};
+}
+
+static void testClosedLoop() {
+    printf("闭环（加热片 37→45→37°C 过渡，目标 15 mmHg）:\n");
+    Deviation without = runClosedLoop(false);
+    Deviation with = runClosedLoop(true);
+    printf("  无前馈：最大偏离 %.2f mmHg，RMS %.3f mmHg\n", without.max, without.rms);
+    printf("  有前馈：最大偏离 %.2f mmHg，RMS %.3f mmHg\n", with.max, with.rms);
+    check(without.max > 0.3, "模型中加热过渡确实扰动负压（无前馈时偏离 > 0.3 mmHg）");
+#if PRESSURE_THERMAL_FF
+    check(with.max < without.max * 0.6, "前馈使最大偏离减小 40% 以上");
+    check(with.rms < without.rms * 0.6, "前馈使 RMS 偏离减小 40% 以上");
+#endif
+}
+
+int main() {
+    simSerialQuiet = true;
+    testKernelAdvance(1);       // millis() == 0 在 PressureController 中表示"未更新过"
+    testRateEstimator();
+    testFeedForward();
+    testLimits();
+    testClosedLoop();
+    return testSummary();
+}
@@ -0,0 +1,202 @@
+/**
+ * @file test_pressure_drift.cpp
+ * @brief 压力零点温漂学习：PressureDriftCompensator 的样本窗口，ControlChannel 的学习条件
+ *
+ * 1. 样本窗口：攒满 PRESSURE_DRIFT_AVG_SAMPLES 个样本才用平均值学习一次；极差超过 PRESSURE_DRIFT_SPREAD_BAND
+ *    （腔体仍在回气）、平均值超出 PRESSURE_DRIFT_LEARN_BAND（泄压门限内的残余负压）或板温读不到时丢弃
+ * 2. ControlChannel：读数平稳且接近0，但没有泄压完成回到待机（保持中的密封腔体）时不学习；
+ *    泄压完成回到待机 PRESSURE_DRIFT_SETTLE_MS 后才学习，结果写入NVS，重启后加载
+ *
+ * 热电偶（MAX31855，冷端 = 板温 40°C）由引脚钩子移出帧，压力传感器（CPS610，0x7F）为仿真I2C器件。
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <math.h>
+#include "TestCheck.h"
+#include "TestKernel.h"
+#include "SimHost.h"
+#include "config.h"
+#include "TemperatureSensor.h"
+#include "PressureSensor.h"
+#include "ControlChannel.h"
+#include "PressureDriftCompensator.h"
+
+typedef ControlChannel<PressureSensor, TemperatureSensor> Channel;
+
+static const ChannelPins kPins = {
+    HEATING_PAD_PIN, PWM_CHANNEL_HEAT, PUMP_PWM_PIN, PWM_CHANNEL_PUMP,
+    THERMO_CLK_PIN, THERMO_CS_PIN, THERMO_MISO_PIN,
+    PRESSURE_SDA_PIN, PRESSURE_SCL_PIN, PRESSURE_I2C_ADDR
+};
+
+static const float BOARD_TEMP = 40.0f;
+
+// ============ 热电偶（MAX31855，热端 30°C，冷端 40°C） ============
+
+static bool thermoSelected = false;
+static uint8_t thermoBit = 0;
+static const uint32_t thermoFrame = ((uint32_t)(30 * 4) << 18) | ((uint32_t)(BOARD_TEMP * 16) << 4);
+
+static void onPinWrite(uint8_t pin, uint8_t level) {
+    if (pin == THERMO_CS_PIN) {
+        thermoSelected = (level == LOW);
+        thermoBit = 0;
+    } else if (pin == THERMO_CLK_PIN && level == LOW && thermoSelected && thermoBit < 32) {
+        thermoBit++;
+    }
+}
+
+static int onPinRead(uint8_t pin) {
+    if (pin != THERMO_MISO_PIN || !thermoSelected) {
+        return -1;
+    }
+    return thermoBit < 32 ? (int)((thermoFrame >> (31 - thermoBit)) & 1) : LOW;
+}
+
+// ============ 压力传感器（CPS610：写 0x30 启动转换，立即完成） ============
+
+class PressureDevice : public SimI2CDevice {
+public:
+    float kPa = 0.0f;           // 表压 (kPa)
+
+    void writeRegisters(uint8_t reg, const uint8_t* data, size_t len) override {
+        if (reg == 0x30 && len > 0) {
+            command = data[0] & ~0x08;
+        }
+    }
+
+    uint8_t readRegister(uint8_t reg) override {
+        // P(kPa) = 7.5 * raw/2^23 - 3.75
+        uint32_t raw = (uint32_t)lroundf((kPa + 3.75f) / 7.5f * 8388608.0f);
+        switch (reg) {
+            case 0x30: return command;
+            case 0x06: return (uint8_t)(raw >> 16);
+            case 0x07: return (uint8_t)(raw >> 8);
+            case 0x08: return (uint8_t)raw;
+        }
+        return 0;
+    }
+
+private:
+    uint8_t command = 0;
+};
+
+static PressureDevice pressureDevice;
+
+/**
+ * @brief 按采样周期运行通道：温度采样发布板温，压力采样（不抽气）
+ */
+static void runChannel(Channel& ch, uint32_t ms, bool vented) {
+    uint32_t end = millis() + ms;
+    while ((int32_t)(end - millis()) > 0) {
+        testKernelAdvance(PRESSURE_SAMPLE_PERIOD_MS);
+        ch.serviceTemperature(false);
+        ChannelEvent e;
+        while ((e = ch.servicePressure(false, 0.0f, vented)) == CHANNEL_EVENT_PRESSURE_PENDING) {
+            int32_t wait = (int32_t)(ch.pressureWakeAt() - millis());
+            testKernelAdvance(wait > 0 ? (TickType_t)wait : 1);
+        }
+    }
+}
+
+static uint8_t boardKnot() {
+    return (uint8_t)((BOARD_TEMP - PRESSURE_DRIFT_TEMP_MIN) / PRESSURE_DRIFT_TEMP_STEP + 0.5f);
+}
+
+static void testWindow() {
+    printf("样本窗口（%u 个样本，极差 < %.2f kPa，平均值 < %.2f kPa）:\n", PRESSURE_DRIFT_AVG_SAMPLES,
+           PRESSURE_DRIFT_SPREAD_BAND, PRESSURE_DRIFT_LEARN_BAND);
+    const uint8_t knot = boardKnot();
+    {
+        PressureDriftCompensator d;
+        int learned = 0;
+        for (int i = 0; i < PRESSURE_DRIFT_AVG_SAMPLES - 1; i++) {
+            learned += d.observe(0.06f, BOARD_TEMP);
+        }
+        check(learned == 0 && d.getSampleCount(knot) == 0 && d.offsetAt(BOARD_TEMP) == 0.0f,
+              "窗口未满：不学习，曲线不变");
+        learned += d.observe(0.06f, BOARD_TEMP);
+        check(learned == 1 && d.getSampleCount(knot) == 1, "窗口满：学习一次");
+    }
+    {
+        PressureDriftCompensator d;
+        for (int i = 0; i < PRESSURE_DRIFT_AVG_SAMPLES; i++) {
+            d.observe(i % 2 ? 0.07f : 0.05f, BOARD_TEMP);
+        }
+        check(fabsf(d.offsetAt(BOARD_TEMP) - 0.06f) < 1e-4f, "首次学习的偏移为窗口平均值，不是单个读数");
+    }
+    {
+        PressureDriftCompensator d;
+        bool learned = false;
+        for (int i = 0; i < PRESSURE_DRIFT_AVG_SAMPLES; i++) {
+            // 回气：读数从 -0.10 线性回到 0
+            learned = d.observe(-0.10f + 0.10f * i / PRESSURE_DRIFT_AVG_SAMPLES, BOARD_TEMP) || learned;
+        }
+        check(!learned && d.getSampleCount(knot) == 0, "极差超限（仍在回气）：丢弃");
+    }
+    {
+        PressureDriftCompensator d;
+        bool learned = false;
+        const float residual = -0.9f / KPA_TO_MMHG;     // 0.9 mmHg 残余负压，已在泄压门限内
+        for (int i = 0; i < PRESSURE_DRIFT_AVG_SAMPLES; i++) {
+            learned = d.observe(residual, BOARD_TEMP) || learned;
+        }
+        check(!learned && d.getSampleCount(knot) == 0, "平稳的 0.9 mmHg 残余负压超出学习门限：丢弃");
+    }
+    {
+        PressureDriftCompensator d;
+        int learned = 0;
+        for (int i = 0; i < PRESSURE_DRIFT_AVG_SAMPLES; i++) {
+            learned += d.observe(0.05f, i == PRESSURE_DRIFT_AVG_SAMPLES / 2 ? NAN : BOARD_TEMP);
+        }
+        check(learned == 0, "窗口中板温读不到：丢弃，重新攒");
+        d.observe(0.05f, BOARD_TEMP);
+        d.discardWindow();
+        for (int i = 0; i < PRESSURE_DRIFT_AVG_SAMPLES - 1; i++) {
+            learned += d.observe(0.05f, BOARD_TEMP);
+        }
+        check(learned == 0, "discardWindow() 后重新攒满一个窗口");
+    }
+}
+
+static void testChannel() {
+    printf("ControlChannel 学习条件（泄压完成后 %u ms）:\n", PRESSURE_DRIFT_SETTLE_MS);
+    const uint8_t knot = boardKnot();
+    Channel ch(0, kPins);
+    ch.begin();
+    ch.driftCompensator().clear();
+
+    // 保持中的密封腔体：泵已停，读数平稳且接近0（0.5 mmHg 残余负压）
+    pressureDevice.kPa = -0.5f / KPA_TO_MMHG;
+    runChannel(ch, PRESSURE_DRIFT_SETTLE_MS + 5000, false);
+    check(ch.driftCompensator().getSampleCount(knot) == 0, "未泄压回到待机：平稳的残余负压不学习");
+
+    // 泄压完成回到待机：零点偏移 +0.05 kPa，等待期间不学习
+    pressureDevice.kPa = 0.05f;
+    runChannel(ch, PRESSURE_DRIFT_SETTLE_MS - PRESSURE_SAMPLE_PERIOD_MS, true);
+    check(ch.driftCompensator().getSampleCount(knot) == 0, "泄压完成后 PRESSURE_DRIFT_SETTLE_MS 内不学习");
+    runChannel(ch, 5000, true);
+    uint16_t learned = ch.driftCompensator().getSampleCount(knot);
+    check(learned > 0 && fabsf(ch.driftCompensator().offsetAt(BOARD_TEMP) - 0.05f) < 0.005f,
+          "泄压完成回到待机：学习零点偏移");
+    check(fabsf(ch.getStatus().currentPressure) < 0.05f, "补偿后负压读数接近0");
+
+    // 5 分钟后写入NVS，重新加载
+    runChannel(ch, PRESSURE_DRIFT_SAVE_INTERVAL_MS, true);
+    PressureDriftCompensator reloaded;
+    reloaded.begin(0);
+    check(reloaded.getSampleCount(knot) > 0 && fabsf(reloaded.offsetAt(BOARD_TEMP) - 0.05f) < 0.005f,
+          "学习结果写入NVS，重启后加载");
+}
+
+int main() {
+    simSerialQuiet = true;
+    testKernelAdvance(1);
+    simSetPinHooks(onPinWrite, onPinRead);
+    Wire.attach(0x7F, &pressureDevice);
+
+    testWindow();
+    testChannel();
+    return testSummary();
+}
@@ -0,0 +1,208 @@
+/**
+ * @file test_pressure_sensors.cpp
+ * @brief 压力传感器驱动的寄存器级测试：CPS610DSD003DH01、XGZP6897D、自动识别
+ *
+ * 仿真I2C器件只实现寄存器（0x30 命令/SCO、0x06~0x08 压力、0x09~0x0A 温度、0xA6 P_CONFIG），
+ * 数据寄存器的内容由测试直接给出原始码，检查驱动的换算、配置写入和出错处理：
+ * 1. CPS610：P(kPa) = 7.5 * raw/2^23 - 3.75；异步接口轮询SCO直到转换完成
+ * 2. XGZP6897D：P(Pa) = raw/K（K=2048，24位有符号）；温度 = raw16/256；
+ *    begin() 对 0xA6 读-改-写只改 OSR 位；周期模式命令字
+ * 3. AutoPressureSensor 按地址识别型号
+ * 4. 器件消失后前两次返回上次的值（isFresh() 为false），第三次返回NAN
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <math.h>
+#include "SimHost.h"
+#include "TestCheck.h"
+#include "PressureSensor.h"
+
+/**
+ * @brief 两种传感器共用的寄存器模型：写 0x30 启动转换，SCO 位在 busyReads 次读取后清零
+ */
+class RegisterSensor : public SimI2CDevice {
+public:
+    uint32_t rawPressure = 0;       // 0x06~0x08（24位）
+    uint16_t rawTemperature = 0;    // 0x09~0x0A
+    uint8_t command = 0;
+    uint8_t config = 0x24;          // 0xA6 P_CONFIG：出厂值，OSR（位 2:0）= 100
+    int busyReads = 0;              // 启动转换后SCO保持为1的读取次数
+    int conversionBusyReads = 0;
+    int conversions = 0;
+    int configWrites = 0;
+
+    void writeRegisters(uint8_t reg, const uint8_t* data, size_t len) override {
+        if (len == 0) {
+            return;
+        }
+        if (reg == 0x30) {
+            command = data[0];
+            if (command & 0x08) {
+                conversions++;
+                busyReads = conversionBusyReads;
+            }
+        } else if (reg == 0xA6) {
+            config = data[0];
+            configWrites++;
+        }
+    }
+
+    uint8_t readRegister(uint8_t reg) override {
+        switch (reg) {
+            case 0x30:
+                if (busyReads > 0) {
+                    busyReads--;
+                    return command;
+                }
+                return command & ~0x08;
+            case 0x06: return (uint8_t)(rawPressure >> 16);
+            case 0x07: return (uint8_t)(rawPressure >> 8);
+            case 0x08: return (uint8_t)rawPressure;
+            case 0x09: return (uint8_t)(rawTemperature >> 8);
+            case 0x0A: return (uint8_t)rawTemperature;
+            case 0xA6: return config;
+        }
+        return 0;
+    }
+};
+
+static bool near(float a, float b, float tolerance) {
+    return fabsf(a - b) <= tolerance;
+}
+
+static void testCps610() {
+    printf("CPS610DSD003DH01 (0x7F):\n");
+    RegisterSensor dev;
+    Wire.attach(0x7F, &dev);
+
+    CPS610Sensor sensor(PRESSURE_SDA_PIN, PRESSURE_SCL_PIN);
+    dev.rawPressure = 0x400000;     // 半量程 = 0 kPa
+    check(sensor.begin(), "begin() 成功");
+
+    struct {
+        uint32_t raw;
+        float kpa;
+        const char* what;
+    } cases[] = {
+        {0x000000, -3.75f,   "原始码 0x000000 -> -3.75 kPa"},
+        {0x400000,  0.0f,    "原始码 0x400000 -> 0 kPa"},
+        {0x355555, -0.625f,  "原始码 0x355555 -> -0.625 kPa"},
+        {0x2AAAAB, -1.25f,   "原始码 0x2AAAAB -> -1.25 kPa"},
+        {0x6AAAAB,  2.5f,    "原始码 0x6AAAAB -> 2.5 kPa"},
+    };
+    for (const auto& c : cases) {
+        dev.rawPressure = c.raw;
+        check(near(sensor.readPressure(), c.kpa, 1e-5f), c.what);
+    }
+    check(dev.command == 0x0A, "单次采集命令字 0x0A（SCO + 组合转换）");
+
+    // 异步接口：SCO 保持两次读取后清零
+    dev.rawPressure = 0x2AAAAB;
+    dev.conversionBusyReads = 2;
+    bool started = sensor.startMeasurement();
+    bool busy1 = !sensor.isConversionDone();
+    bool busy2 = !sensor.isConversionDone();
+    bool done = sensor.isConversionDone();
+    check(started && busy1 && busy2 && done, "异步采集：SCO 为1时未完成，清零后完成");
+    check(near(sensor.readResult(), -1.25f, 1e-5f), "异步采集读出 -1.25 kPa");
+
+    Wire.attach(0x7F, NULL);
+}
+
+static void testXgzp() {
+    printf("XGZP6897D (0x6D):\n");
+    RegisterSensor dev;
+    Wire.attach(0x6D, &dev);
+
+    XGZP6897DSensor sensor(PRESSURE_SDA_PIN, PRESSURE_SCL_PIN);
+    dev.rawTemperature = (uint16_t)(int16_t)(31.5f * 256);
+    check(sensor.begin(), "begin() 成功");
+    check(dev.config == 0x20, "begin(): 0xA6 读-改-写，0x24 -> 0x20（OSR 1024X，其他位不变）");
+    check(dev.command == 0x0A, "单次模式触发命令字 0x0A");
+
+    // K = 2048：P(Pa) = raw / 2048，raw 为24位有符号数
+    struct {
+        uint32_t raw;
+        float kpa;
+        const char* what;
+    } cases[] = {
+        {0x000800,  0.001f,    "原始码 0x000800 (2048) -> 1 Pa"},
+        {0xFFF800, -0.001f,    "原始码 0xFFF800 (-2048) -> -1 Pa"},
+        {0xC18400, -1.9995f,   "原始码 0xC18400 -> -1999.5 Pa"},
+        {0xA24000, -3.0f,      "原始码 0xA24000 (-6144000) -> -3000 Pa"},
+        {0x7FFFFF,  4.0959995f, "原始码 0x7FFFFF -> 正满量程 4095.9995 Pa"},
+        {0x800000, -4.096f,    "原始码 0x800000 -> 负满量程 -4096 Pa"},
+    };
+    for (const auto& c : cases) {
+        dev.rawPressure = c.raw;
+        check(near(sensor.readPressure(), c.kpa, 1e-6f), c.what);
+    }
+    check(sensor.getLastSensorTemperature() == 31.5f, "温度 raw16/256 = 31.5 °C");
+
+    int writes = dev.configWrites;
+    check(sensor.setOversampling(XGZP_OSR_8192X) && dev.config == 0x23, "OSR 8192X: 0xA6 = 0x23");
+    check(sensor.setOversampling(XGZP_OSR_256X) && dev.config == 0x24, "OSR 256X: 0xA6 = 0x24");
+    check(dev.configWrites == writes + 2, "每次设置过采样写一次 0xA6");
+
+    check(sensor.setMode(XGZP_MODE_PERIODIC, 4) && dev.command == 0x4B, "周期模式（周期码4）命令字 0x4B");
+    int conversions = dev.conversions;
+    dev.rawPressure = 0xFC1800;     // -256000 -> -125 Pa
+    check(near(sensor.readPressure(), -0.125f, 1e-6f), "周期模式直接读数据寄存器");
+    check(dev.conversions == conversions, "周期模式读取不再触发转换");
+
+    check(sensor.setMode(XGZP_MODE_SINGLE_SHOT) && dev.command == 0x02, "回到单次模式写 0x02（不启动）");
+    dev.rawPressure = 0xA24000;
+    check(near(sensor.readPressure(), -3.0f, 1e-6f) && dev.conversions == conversions + 1,
+          "单次模式每次读取触发一次转换");
+
+    // 器件消失：前两次返回上次的值，第三次返回NAN
+    Wire.attach(0x6D, NULL);
+    float r1 = sensor.readPressure();
+    float r2 = sensor.readPressure();
+    float r3 = sensor.readPressure();
+    check(near(r1, -3.0f, 1e-6f) && near(r2, -3.0f, 1e-6f), "读取失败前两次返回上次的值");
+    check(!sensor.isFresh(), "沿用上次的值时 isFresh() 为false");
+    check(isnan(r3) && !sensor.isValid(), "连续三次失败返回NAN，isValid() 为false");
+}
+
+static void testAutoDetect() {
+    printf("AutoPressureSensor:\n");
+    RegisterSensor cps;
+    RegisterSensor xgzp;
+
+    {
+        Wire.attach(0x7F, NULL);
+        Wire.attach(0x6D, &xgzp);
+        AutoPressureSensor sensor(PRESSURE_SDA_PIN, PRESSURE_SCL_PIN);
+        check(sensor.begin() && sensor.getModel() == AutoPressureSensor::MODEL_XGZP6897D, "只有 0x6D 时识别为 XGZP6897D");
+    }
+    {
+        Wire.attach(0x7F, &cps);
+        Wire.attach(0x6D, NULL);
+        cps.rawPressure = 0x2AAAAB;
+        AutoPressureSensor sensor(PRESSURE_SDA_PIN, PRESSURE_SCL_PIN);
+        bool ok = sensor.begin() && sensor.getModel() == AutoPressureSensor::MODEL_CPS610DSD003DH01;
+        check(ok && near(sensor.readPressure(), -1.25f, 1e-5f), "只有 0x7F 时识别为 CPS610，按 CPS610 换算");
+    }
+    {
+        Wire.attach(0x7F, &cps);
+        Wire.attach(0x6D, &xgzp);
+        AutoPressureSensor sensor(PRESSURE_SDA_PIN, PRESSURE_SCL_PIN, 0x6D);
+        check(sensor.begin() && sensor.getModel() == AutoPressureSensor::MODEL_XGZP6897D, "指定地址 0x6D 时不探测 0x7F");
+    }
+    {
+        Wire.attach(0x7F, NULL);
+        Wire.attach(0x6D, NULL);
+        AutoPressureSensor sensor(PRESSURE_SDA_PIN, PRESSURE_SCL_PIN);
+        check(!sensor.begin() && !sensor.isValid(), "两个地址都没有器件时 begin() 失败");
+    }
+}
+
+int main() {
+    simSerialQuiet = true;
+    testCps610();
+    testXgzp();
+    testAutoDetect();
+    return testSummary();
+}
@@ -0,0 +1,144 @@
+/**
+ * @file test_self_test.cpp
+ * @brief 上电自检：runSelfTest() 在仿真的被控对象上，正常硬件和每种注入故障
+ *
+ * 被控对象用主机仿真的模型（sim/SimPlant.cpp：两节点加热片热模型、腔体负压、热电偶SPI、
+ * 压力传感器 SimI2CDevice），由替身内核的软件定时器每 SIM_PLANT_PERIOD_MS 推进；
+ * 自检循环的 vTaskDelay() 推进节拍。与 sim/scenarios/post_*.scn 相同的故障，单线程、结果可重复：
+ * 1. 每种情况检查四项检查的结论和故障码、runSelfTest() 的结论（是否有严重故障）、写入故障日志的条数
+ * 2. 总用时和每项检查得出结论的时间不超过 POST_BUDGET_MS（预算用完时不再等压力转换）；正常硬件提前结束
+ * 3. 自检结束后执行器关闭
+ */
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include "TestCheck.h"
+#include "TestKernel.h"
+#include "SimHost.h"
+#include "SimPlant.h"
+#include "config.h"
+#include <freertos/timers.h>
+#include "TemperatureSensor.h"
+#include "PressureSensor.h"
+#include "ControlChannel.h"
+#include "EmergencyStop.h"
+#include "FaultLog.h"
+#include "SelfTest.h"
+
+typedef ControlChannel<PressureSensor, TemperatureSensor> Channel;
+
+static const ChannelPins kPins[1] = {
+    { HEATING_PAD_PIN, PWM_CHANNEL_HEAT, PUMP_PWM_PIN, PWM_CHANNEL_PUMP,
+      THERMO_CLK_PIN, THERMO_CS_PIN, THERMO_MISO_PIN,
+      PRESSURE_SDA_PIN, PRESSURE_SCL_PIN, PRESSURE_I2C_ADDR }
+};
+
+/**
+ * @brief 一项检查的期望结论（失败时还要对上故障码）
+ */
+struct Expect {
+    PostResult result;
+    FaultCode fault;
+};
+
+static const Expect PASS = { POST_PASS, FAULT_NONE };
+static const Expect SKIP = { POST_SKIPPED, FAULT_NONE };
+
+static Expect fail(FaultCode fault) {
+    return { POST_FAIL, fault };
+}
+
+struct Case {
+    const char* fault;              // simFaultFromName() 的名字，NULL = 正常硬件
+    Expect checks[POST_CHECK_COUNT];
+    bool passed;                    // runSelfTest() 的结论：无严重故障
+    uint8_t logged;                 // 写入故障日志的条数
+};
+
+static void stepPlant(TimerHandle_t) {
+    simPlantStep(millis());
+}
+
+static SimScenario scenario(const char* fault) {
+    SimScenario s = {};
+    s.ambient = 22.0f;
+    s.padResistance = 1.0f;
+    s.boardResistance = 1.0f;
+    s.leakRate = 0.05f;
+    if (fault) {
+        s.faults[0] = simFaultFromName(fault);
+    }
+    return s;
+}
+
+static void runCase(const Case& c, FaultLog& log, EmergencyStop& estop) {
+    const char* name = c.fault ? c.fault : "正常硬件";
+    printf("%s:\n", name);
+    srand(1);
+    simPlantBegin(scenario(c.fault));
+    simPlantStep(millis());
+
+    ChannelBank<1, Channel> bank(kPins);
+    bank.beginAll();
+    log.clear();
+    ChannelSelfTest tests[1];
+
+    uint32_t start = millis();
+    bool passed = runSelfTest(bank, log, estop, tests);
+    uint32_t elapsed = millis() - start;
+
+    bool match = true;
+    bool inBudget = elapsed <= POST_BUDGET_MS;
+    for (uint8_t k = 0; k < POST_CHECK_COUNT; k++) {
+        const PostOutcome& o = tests[0].outcome((PostCheck)k);
+        const Expect& e = c.checks[k];
+        bool ok = o.result == e.result && (o.result != POST_FAIL || o.fault == e.fault);
+        printf("  %s %s: %s (%.2f, %lu ms)%s%s\n", ok ? " " : "!", postCheckName((PostCheck)k),
+               postResultName(o.result), o.value, (unsigned long)o.elapsedMs,
+               o.result == POST_FAIL ? " " : "", o.result == POST_FAIL ? FaultLog::codeName(o.fault) : "");
+        match = match && ok;
+        inBudget = inBudget && o.elapsedMs <= POST_BUDGET_MS;
+    }
+
+    char what[96];
+    snprintf(what, sizeof(what), "%s：四项检查的结论和故障码", name);
+    check(match, what);
+    snprintf(what, sizeof(what), "%s：%s，故障日志 %u 条", name, c.passed ? "无严重故障" : "严重故障",
+             (unsigned)c.logged);
+    check(passed == c.passed && log.countThisBoot() == c.logged, what);
+    snprintf(what, sizeof(what), "%s：用时 %lu ms，不超过 POST_BUDGET_MS", name, (unsigned long)elapsed);
+    check(inBudget, what);
+    if (!c.fault) {
+        check(elapsed < POST_BUDGET_MS, "正常硬件：全部检查有结论即提前结束");
+    }
+    check(simLedcDuty(PWM_CHANNEL_HEAT) == 0 && simLedcDuty(PWM_CHANNEL_PUMP) == 0, "自检结束后加热和泵关闭");
+}
+
+int main() {
+    simSerialQuiet = true;
+    testKernelAdvance(1);
+
+    TimerHandle_t plant = xTimerCreate("Plant", pdMS_TO_TICKS(SIM_PLANT_PERIOD_MS), pdTRUE, NULL, stepPlant);
+    check(plant != NULL && xTimerStart(plant, 0) == pdPASS, "被控对象定时器启动");
+
+    FaultLog log;
+    log.begin();
+    EmergencyStop estop(BUTTON_STOP_PIN);
+
+    // 检查顺序：温度传感器、压力传感器、加热脉冲、抽气脉冲（PostCheck）
+    const Case cases[] = {
+        { NULL,              { PASS, PASS, PASS, PASS }, true, 0 },
+        { "heater_open",     { PASS, PASS, fail(FAULT_POST_HEATER_NO_RISE), PASS }, false, 1 },
+        { "heater_stuck",    { PASS, PASS, fail(FAULT_POST_HEATER_STUCK_ON), PASS }, false, 1 },
+        { "thermo_open",     { fail(FAULT_POST_TEMP_SENSOR), PASS, SKIP, PASS }, false, 1 },
+        { "thermo_detached", { PASS, PASS, fail(FAULT_POST_HEATER_NO_RISE), PASS }, false, 1 },
+        { "pump_dead",       { PASS, PASS, PASS, fail(FAULT_POST_PUMP_NO_VACUUM) }, true, 1 },
+        { "pressure_absent", { PASS, fail(FAULT_POST_PRESSURE_SENSOR), PASS, SKIP }, false, 1 },
+        { "pressure_noisy",  { PASS, fail(FAULT_POST_PRESSURE_RANGE), PASS, SKIP }, false, 1 },
+        { "chamber_open",    { PASS, PASS, PASS, fail(FAULT_POST_PUMP_NO_VACUUM) }, true, 1 },
+    };
+    for (const Case& c : cases) {
+        runCase(c, log, estop);
+    }
+    return testSummary();
+}
@@ -0,0 +1,287 @@
+/**
+ * @file test_state_machine.cpp
+ * @brief 系统状态机：穷举事件序列，对照独立写出的合法转移清单
+ *
+ * 状态机的全部状态就是当前模式（转移记录不影响后续行为），所以从 Boot 出发对
+ * 每个可达模式尝试全部事件 × 全部守卫输入组合，直到没有新模式，即覆盖任意长度的事件序列。
+ * 每一步实际发生的转移必须在下面的 LEGAL 清单中，且满足清单要求的输入条件；
+ * 清单按 SystemStateMachine.h 的状态图手写，不从转移表生成，表被改出非法转移时测试失败。
+ * 另外：
+ * - 清单中的每条转移都必须可达（表漏掉转移时同样失败）
+ * - 先在故意改坏的表上运行同一检查，确认检查本身能发现非法转移
+ * - 长度 ≤ 3 的全部事件序列在真实对象上逐步检查 dispatch() 返回值与转移记录
+ */
+
+#include <functional>
+#include <set>
+#include <vector>
+#include "TestCheck.h"
+#include "SystemStateMachine.h"
+
+/**
+ * @brief 合法转移的输入条件
+ */
+enum Requirement {
+    REQ_NONE,
+    REQ_STOP_RELEASED,      // STOP 已松开
+    REQ_SENSORS_OK          // 传感器有效、未全部过温、板温未超限
+};
+
+struct LegalTransition {
+    SystemMode from;
+    SystemEvent event;
+    SystemMode to;
+    Requirement requirement;
+};
+
+static const LegalTransition LEGAL[] = {
+    {MODE_BOOT,    EVT_BOOT_OK,       MODE_IDLE,    REQ_NONE},
+    {MODE_BOOT,    EVT_BOOT_FAIL,     MODE_FAULT,   REQ_NONE},
+    {MODE_IDLE,    EVT_START,         MODE_WARMUP,  REQ_SENSORS_OK},
+    {MODE_WARMUP,  EVT_TEMP_REACHED,  MODE_RUN,     REQ_NONE},
+    {MODE_WARMUP,  EVT_STOP,          MODE_VENTING, REQ_NONE},
+    {MODE_RUN,     EVT_PAUSE,         MODE_HOLD,    REQ_NONE},
+    {MODE_RUN,     EVT_STOP,          MODE_VENTING, REQ_NONE},
+    {MODE_HOLD,    EVT_RESUME,        MODE_RUN,     REQ_NONE},
+    {MODE_HOLD,    EVT_STOP,          MODE_VENTING, REQ_NONE},
+    {MODE_VENTING, EVT_VENTED,        MODE_IDLE,    REQ_NONE},
+    {MODE_FAULT,   EVT_FAULT_CLEARED, MODE_IDLE,    REQ_SENSORS_OK},
+    {MODE_ESTOP_LATCHED, EVT_RESET,   MODE_IDLE,    REQ_STOP_RELEASED},
+};
+
+static const uint8_t INPUT_COMBINATIONS = 16;
+
+static SystemInputs inputsFrom(uint8_t bits) {
+    return SystemInputs{(bits & 1) != 0, (bits & 2) != 0, (bits & 4) != 0, (bits & 8) != 0};
+}
+
+static bool requirementMet(Requirement r, const SystemInputs& in) {
+    switch (r) {
+        case REQ_NONE:          return true;
+        case REQ_STOP_RELEASED: return !in.stopPressed;
+        case REQ_SENSORS_OK:    return in.sensorsOk && !in.allOverTemp && !in.boardOverTemp;
+    }
+    return false;
+}
+
+/**
+ * @brief 一次转移是否合法；legalIndex 返回匹配的清单项（急停/故障为 -1）
+ */
+static bool isLegal(SystemMode from, SystemEvent event, SystemMode to, const SystemInputs& in, int& legalIndex) {
+    legalIndex = -1;
+    if (to == from) {
+        return true;
+    }
+    // 急停：任意模式进入锁存；故障：锁存以外任意模式进入故障
+    if (event == EVT_ESTOP) {
+        return to == MODE_ESTOP_LATCHED;
+    }
+    if (event == EVT_FAULT) {
+        return to == MODE_FAULT && from != MODE_ESTOP_LATCHED;
+    }
+    for (size_t i = 0; i < sizeof(LEGAL) / sizeof(LEGAL[0]); i++) {
+        const LegalTransition& t = LEGAL[i];
+        if (t.from == from && t.event == event && t.to == to) {
+            legalIndex = (int)i;
+            return requirementMet(t.requirement, in);
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 本应发生却被忽略的转移（急停、故障、清单项在条件满足时必须发生）
+ */
+static bool wronglyIgnored(SystemMode from, SystemEvent event, const SystemInputs& in) {
+    if (event == EVT_ESTOP) {
+        return from != MODE_ESTOP_LATCHED;
+    }
+    if (event == EVT_FAULT) {
+        return from != MODE_ESTOP_LATCHED && from != MODE_FAULT;
+    }
+    for (const LegalTransition& t : LEGAL) {
+        if (t.from == from && t.event == event && requirementMet(t.requirement, in)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+typedef std::function<SystemMode(SystemMode, SystemEvent, const SystemInputs&)> StepFunction;
+
+struct ExploreResult {
+    std::set<SystemMode> reached;
+    std::vector<bool> legalCovered;
+    int illegal;
+    int ignored;
+};
+
+/**
+ * @brief 从 Boot 出发广度优先穷举可达模式，检查每一步
+ */
+static ExploreResult explore(StepFunction step, bool verbose) {
+    ExploreResult r;
+    r.legalCovered.assign(sizeof(LEGAL) / sizeof(LEGAL[0]), false);
+    r.illegal = 0;
+    r.ignored = 0;
+    std::vector<SystemMode> frontier = {MODE_BOOT};
+    r.reached.insert(MODE_BOOT);
+    while (!frontier.empty()) {
+        SystemMode from = frontier.back();
+        frontier.pop_back();
+        for (uint8_t e = 0; e < EVT_COUNT; e++) {
+            SystemEvent event = (SystemEvent)e;
+            for (uint8_t bits = 0; bits < INPUT_COMBINATIONS; bits++) {
+                SystemInputs in = inputsFrom(bits);
+                SystemMode to = step(from, event, in);
+                int index;
+                if (!isLegal(from, event, to, in, index)) {
+                    if (verbose && r.illegal < 5) {
+                        printf("    非法转移 %s --%s--> %s (输入 0x%X)\n", SystemStateMachine::modeName(from),
+                               SystemStateMachine::eventName(event), SystemStateMachine::modeName(to), bits);
+                    }
+                    r.illegal++;
+                } else if (to == from && wronglyIgnored(from, event, in)) {
+                    if (verbose && r.ignored < 5) {
+                        printf("    被忽略 %s --%s--> (输入 0x%X)\n", SystemStateMachine::modeName(from),
+                               SystemStateMachine::eventName(event), bits);
+                    }
+                    r.ignored++;
+                }
+                if (index >= 0) {
+                    r.legalCovered[index] = true;
+                }
+                if (r.reached.insert(to).second) {
+                    frontier.push_back(to);
+                }
+            }
+        }
+    }
+    return r;
+}
+
+/**
+ * @brief 用真实状态机执行一步：新对象沿固定事件序列从 Boot 走到 from，再派发
+ */
+static SystemMode realStep(SystemMode from, SystemEvent event, const SystemInputs& in) {
+    static const SystemInputs OK = inputsFrom(0x2);     // 传感器有效、STOP 未按下
+    static const struct { SystemMode mode; std::vector<SystemEvent> path; } paths[] = {
+        {MODE_BOOT,          {}},
+        {MODE_IDLE,          {EVT_BOOT_OK}},
+        {MODE_WARMUP,        {EVT_BOOT_OK, EVT_START}},
+        {MODE_RUN,           {EVT_BOOT_OK, EVT_START, EVT_TEMP_REACHED}},
+        {MODE_HOLD,          {EVT_BOOT_OK, EVT_START, EVT_TEMP_REACHED, EVT_PAUSE}},
+        {MODE_VENTING,       {EVT_BOOT_OK, EVT_START, EVT_STOP}},
+        {MODE_FAULT,         {EVT_BOOT_FAIL}},
+        {MODE_ESTOP_LATCHED, {EVT_ESTOP}},
+    };
+    SystemStateMachine m;
+    for (const auto& p : paths) {
+        if (p.mode == from) {
+            for (SystemEvent e : p.path) {
+                m.dispatch(e, OK, 0);
+            }
+        }
+    }
+    if (m.mode() != from) {
+        return MODE_COUNT;      // 到不了 from：记为非法
+    }
+    m.dispatch(event, in, 0);
+    return m.mode();
+}
+
+static void testBrokenTableIsDetected() {
+    printf("检查自身（改坏的表）:\n");
+    // 待机直接进入运行（跳过预热和传感器守卫）
+    ExploreResult skip = explore([](SystemMode from, SystemEvent event, const SystemInputs& in) {
+        if (from == MODE_IDLE && event == EVT_START) {
+            return MODE_RUN;
+        }
+        return realStep(from, event, in);
+    }, false);
+    check(skip.illegal > 0, "Idle --START--> Run 被判为非法");
+
+    // 急停锁存在 STOP 仍按下时被复位
+    ExploreResult reset = explore([](SystemMode from, SystemEvent event, const SystemInputs& in) {
+        if (from == MODE_ESTOP_LATCHED && event == EVT_RESET) {
+            return MODE_IDLE;
+        }
+        return realStep(from, event, in);
+    }, false);
+    check(reset.illegal > 0, "STOP 按下时 RESET 离开锁存被判为非法");
+
+    // 暂停状态忽略急停
+    ExploreResult estop = explore([](SystemMode from, SystemEvent event, const SystemInputs& in) {
+        if (from == MODE_HOLD && event == EVT_ESTOP) {
+            return MODE_HOLD;
+        }
+        return realStep(from, event, in);
+    }, false);
+    check(estop.ignored > 0, "Hold 忽略 ESTOP 被发现");
+}
+
+static void testReachableTransitions() {
+    printf("穷举可达转移:\n");
+    ExploreResult r = explore(realStep, true);
+    printf("  可达模式 %zu 个，每个模式 %u 个事件 x %u 种输入\n", r.reached.size(), (unsigned)EVT_COUNT,
+           (unsigned)INPUT_COMBINATIONS);
+    check(r.illegal == 0, "没有非法转移（含守卫条件）");
+    check(r.ignored == 0, "条件满足的合法转移、急停、故障都没有被忽略");
+    check(r.reached.size() == MODE_COUNT, "全部模式可达");
+    bool covered = true;
+    for (size_t i = 0; i < r.legalCovered.size(); i++) {
+        if (!r.legalCovered[i]) {
+            printf("    未覆盖 %s --%s--> %s\n", SystemStateMachine::modeName(LEGAL[i].from),
+                   SystemStateMachine::eventName(LEGAL[i].event), SystemStateMachine::modeName(LEGAL[i].to));
+            covered = false;
+        }
+    }
+    check(covered, "清单中的每条转移都可达");
+}
+
+static long sequences = 0;
+static long recordErrors = 0;
+
+/**
+ * @brief 在真实对象上穷举长度 ≤ depth 的事件序列，检查返回值与转移记录
+ */
+static void walk(const SystemStateMachine& m, int depth) {
+    if (depth == 0) {
+        return;
+    }
+    for (uint8_t e = 0; e < EVT_COUNT; e++) {
+        for (uint8_t bits = 0; bits < INPUT_COMBINATIONS; bits++) {
+            SystemStateMachine n = m;
+            SystemMode from = n.mode();
+            uint32_t count = n.transitionCount();
+            uint32_t now = (uint32_t)sequences;
+            bool moved = n.dispatch((SystemEvent)e, inputsFrom(bits), now);
+            SystemMode to = n.mode();
+            sequences++;
+            bool ok = moved ? (to != from && n.transitionCount() == count + 1 && n.history(0).from == from
+                               && n.history(0).to == to && n.history(0).event == e
+                               && n.history(0).timestamp == now && n.modeSince() == now)
+                            : (to == from && n.transitionCount() == count);
+            if (!ok) {
+                recordErrors++;
+            }
+            walk(n, depth - 1);
+        }
+    }
+}
+
+static void testSequences() {
+    printf("长度 <= 3 的事件序列:\n");
+    SystemStateMachine m;
+    walk(m, 3);
+    printf("  %ld 步\n", sequences);
+    check(recordErrors == 0, "dispatch() 返回值、转移计数和转移记录与模式变化一致");
+    check(!m.heatingAllowed() && !m.pumpAllowed(), "上电时执行器不许可");
+}
+
+int main() {
+    testBrokenTableIsDetected();
+    testReachableTransitions();
+    testSequences();
+    return testSummary();
+}
@@ -0,0 +1,203 @@
+/**
+ * @file test_thermal_identifier.cpp
+ * @brief 加热片热导辨识与维持功率前馈
+ *
+ * 热模型为两节点（加热丝 1 s + 加热片 60 s，加热片对环境热阻 R），稳态热导 G = 4.25/R (PWM/°C)：
+ * 1. 全功率升温时按 ControlChannel 的方式取样（0.25°C 量化、RateEstimator 变化率），
+ *    不同环境温度和热阻下辨识出的 G 与模型稳态热导相差 < 15%（一阶模型不含加热丝节点，
+ *    本模型上约 ±11%，剩余部分由PID积分补偿）
+ * 2. 样本不足、升温范围不足、辨识期间输出改变时辨识失败，沿用学习值
+ * 3. learnSteadyState() 按 WARMUP_LEARN_GAIN 修正学习值并保存到NVS；温差过小或结果不合理时不学习
+ * 4. 10°C 环境：只靠PID积分（限幅 INTEGRAL_MAX）到不了目标，加上辨识出的维持功率前馈后稳定在目标
+ */
+
+#include <math.h>
+#include "TestCheck.h"
+#include "TestKernel.h"
+#include "SimHost.h"
+#include "config.h"
+#include "HeatingController.h"
+#include "RateEstimator.h"
+#include "ThermalIdentifier.h"
+
+/**
+ * @brief 两节点加热片
+ */
+struct Pad {
+    double ambient;
+    double resistance;      // 加热片对环境的热阻（相对值）
+    double wire;
+    double skin;
+
+    Pad(double ta, double r) : ambient(ta), resistance(r), wire(ta), skin(ta) {}
+
+    void step(double dt, uint8_t output) {
+        double duty = output / 255.0;
+        wire += dt * (60.0 * duty - (wire - skin) / 0.25);
+        skin += dt * ((wire - skin) / 0.25 - (skin - ambient) / resistance) / 60.0;
+    }
+
+    float reading() const {
+        return roundf((float)skin * 4.0f) / 4.0f;
+    }
+
+    double conductance() const {
+        return 255.0 / 60.0 / resistance;
+    }
+};
+
+/**
+ * @brief 全功率升温 duration_ms，每个温度周期把样本交给辨识
+ * @param changeAt_ms 此时刻起输出改为 254（0 表示不改）
+ */
+static bool identify(ThermalIdentifier& id, Pad& pad, uint32_t duration_ms, uint32_t changeAt_ms = 0) {
+    RateEstimator<TEMP_RATE_WINDOW> rate;
+    id.start(millis());
+    for (uint32_t t = 0; t < duration_ms; t += 10) {
+        uint8_t output = (changeAt_ms != 0 && t >= changeAt_ms) ? 254 : 255;
+        if (t % TEMP_SAMPLE_PERIOD_MS == 0) {
+            float temp = pad.reading();
+            rate.add(millis(), temp);
+            id.addSample(temp, rate.slope(), (float)pad.ambient, output, millis());
+        }
+        pad.step(0.01, output);
+        testKernelAdvance(10);
+    }
+    return id.finish();
+}
+
+static void testIdentification() {
+    printf("全功率阶段辨识:\n");
+    const struct {
+        double ambient;
+        double resistance;
+    } cases[] = {
+        {22.0, 1.0},
+        {10.0, 1.0},
+        {30.0, 1.0},
+        {22.0, 0.8},
+        {22.0, 1.2},
+        {15.0, 0.9},
+    };
+    float worst = 0.0f;
+    bool allIdentified = true;
+    for (const auto& c : cases) {
+        ThermalIdentifier id;
+        Pad pad(c.ambient, c.resistance);
+        // 预热全功率阶段约 15~20 s
+        bool ok = identify(id, pad, 18000);
+        float error = (float)(id.getConductance() / pad.conductance() - 1.0);
+        printf("  环境 %.0f°C、R %.1f：G %.2f（模型 %.2f，%+.1f%%）%s\n", c.ambient, c.resistance,
+               id.getConductance(), pad.conductance(), error * 100.0f, ok ? "" : " 失败");
+        allIdentified = allIdentified && ok;
+        worst = fmaxf(worst, fabsf(error));
+    }
+    check(allIdentified, "各环境温度与热阻下辨识成功");
+    check(worst < 0.15f, "辨识出的热导与模型稳态热导相差 < 15%");
+}
+
+static void testRejection() {
+    printf("辨识失败时沿用学习值:\n");
+    {
+        ThermalIdentifier id;
+        Pad pad(22.0, 1.0);
+        check(!identify(id, pad, THERMAL_ID_SKIP_MS + 2000) && id.getConductance() == THERMAL_G_DEFAULT,
+              "样本不足");
+    }
+    {
+        // 升温很慢（热阻小、已接近稳态）：温差范围不足 THERMAL_ID_MIN_SPAN
+        ThermalIdentifier id;
+        Pad pad(22.0, 0.05);
+        check(!identify(id, pad, 18000) && id.getConductance() == THERMAL_G_DEFAULT, "升温范围不足");
+    }
+    {
+        ThermalIdentifier id;
+        Pad pad(22.0, 1.0);
+        check(!identify(id, pad, 18000, 10000) && id.getConductance() == THERMAL_G_DEFAULT,
+              "辨识期间输出改变");
+        check(!id.isIdentifying(), "输出改变后停止辨识");
+    }
+    {
+        ThermalIdentifier id;
+        id.start(millis());
+        id.addSample(30.0f, NAN, 22.0f, 255, millis() + THERMAL_ID_SKIP_MS);
+        id.addSample(30.0f, 1.0f, NAN, 255, millis() + THERMAL_ID_SKIP_MS);
+        check(!id.finish(), "变化率或环境温度为NAN的样本被忽略");
+    }
+}
+
+static void testLearning() {
+    printf("稳态学习与NVS:\n");
+    ThermalIdentifier id;
+    id.begin(1);
+    float before = id.getLearnedConductance();
+    check(before == THERMAL_G_DEFAULT, "NVS 无记录时为初值");
+
+    // 40°C / 环境 20°C 稳态输出 110 -> G = 5.5
+    id.learnSteadyState(110.0f, 40.0f, 20.0f);
+    float expected = before + WARMUP_LEARN_GAIN * (5.5f - before);
+    check(fabsf(id.getLearnedConductance() - expected) < 1e-4f, "学习值按 WARMUP_LEARN_GAIN 向稳态热导修正");
+
+    id.learnSteadyState(110.0f, 40.0f, 40.0f - THERMAL_LEARN_MIN_DELTA + 0.5f);
+    check(fabsf(id.getLearnedConductance() - expected) < 1e-4f, "目标与环境温差过小时不学习");
+    id.learnSteadyState(255.0f, 40.0f, 34.0f);
+    check(fabsf(id.getLearnedConductance() - expected) < 1e-4f, "热导超出合理范围时不学习");
+
+    ThermalIdentifier reloaded;
+    reloaded.begin(1);
+    check(fabsf(reloaded.getLearnedConductance() - expected) < 1e-4f && reloaded.getConductance() == reloaded.getLearnedConductance(),
+          "学习值保存到NVS，begin() 读回并作为本次热导");
+    ThermalIdentifier other;
+    other.begin(2);
+    check(other.getLearnedConductance() == THERMAL_G_DEFAULT, "按通道分别保存");
+
+    check(reloaded.holdingOutput(40.0f, 45.0f) == 0.0f, "环境高于目标时维持功率为0");
+    check(reloaded.holdingOutput(40.0f, -100.0f) == 255.0f, "维持功率不超过 255");
+}
+
+/**
+ * @brief 全功率辨识后交给PID，返回最后 60 s 的平均温度
+ */
+static float holdAfterWarmUp(bool feedForward, double ambient) {
+    Pad pad(ambient, 1.0);
+    ThermalIdentifier id;
+    identify(id, pad, 18000);
+    HeatingController heater(HEATING_PAD_PIN, 0);
+    heater.begin();
+    heater.enable();
+    heater.setFeedForward(feedForward ? id.holdingOutput(TEMP_TARGET_DEFAULT, (float)ambient) : 0.0f);
+    double sum = 0.0;
+    int samples = 0;
+    for (uint32_t t = 0; t < 600000; t += 10) {
+        if (t % TEMP_SAMPLE_PERIOD_MS == 0) {
+            heater.update(pad.reading());
+            if (t >= 540000) {
+                sum += pad.skin;
+                samples++;
+            }
+        }
+        pad.step(0.01, heater.getOutput());
+        testKernelAdvance(10);
+    }
+    heater.disable();
+    return (float)(sum / samples);
+}
+
+static void testColdAmbient() {
+    printf("10°C 环境保持 %.0f°C:\n", TEMP_TARGET_DEFAULT);
+    float without = holdAfterWarmUp(false, 10.0);
+    float with = holdAfterWarmUp(true, 10.0);
+    printf("  10 分钟后：无前馈 %.2f °C，有前馈 %.2f °C\n", without, with);
+    check(without < TEMP_TARGET_DEFAULT - 1.0f, "只靠积分（限幅）到不了目标");
+    check(fabsf(with - TEMP_TARGET_DEFAULT) < TEMP_HYSTERESIS, "维持功率前馈后稳定在目标 ±回差内");
+}
+
+int main() {
+    simSerialQuiet = true;
+    testKernelAdvance(1);
+    testIdentification();
+    testRejection();
+    testLearning();
+    testColdAmbient();
+    return testSummary();
+}
@@ -0,0 +1,79 @@
+/**
+ * @file test_thermocouple_chip.cpp
+ * @brief 热电偶前端芯片帧解码：MAX31855 / MAX6675 的固定帧
+ *
+ * 帧按数据手册的位定义手工拼出，检查温度、冷端、故障分类，以及 MISO 悬空
+ * （全0/全1）和保留位非0时按总线错误处理。
+ */
+
+#include <math.h>
+#include "TestCheck.h"
+#include "ThermocoupleChip.h"
+
+/**
+ * @brief MAX31855 帧：热端 0.25°C/LSB（D31-D18），冷端 0.0625°C/LSB（D15-D4）
+ */
+static uint32_t max31855Frame(float hot, float cold) {
+    uint32_t h = (uint32_t)(int32_t)lroundf(hot * 4.0f) & 0x3FFF;
+    uint32_t c = (uint32_t)(int32_t)lroundf(cold * 16.0f) & 0x0FFF;
+    return (h << 18) | (c << 4);
+}
+
+static bool isBus(const ThermoReading& r) {
+    return r.fault == THERMO_FAULT_BUS && isnan(r.hotJunction);
+}
+
+static void testMax31855() {
+    printf("MAX31855:\n");
+
+    ThermoReading r = MAX31855Chip::decode(max31855Frame(40.0f, 25.0f));
+    check(r.fault == THERMO_FAULT_NONE && r.linearHotJunction == 40.0f && r.coldJunction == 25.0f,
+          "40°C / 冷端 25°C：线性热端 40.00，冷端 25.0000");
+    check(fabsf(r.hotJunction - 40.0f) < 0.5f, "NIST 线性化后热端在 40±0.5°C 内");
+
+    r = MAX31855Chip::decode(max31855Frame(-10.0f, -1.5f));
+    check(r.fault == THERMO_FAULT_NONE && r.linearHotJunction == -10.0f && r.coldJunction == -1.5f,
+          "负温度：热端 -10.00、冷端 -1.5000（符号扩展）");
+
+    r = MAX31855Chip::decode(max31855Frame(1023.75f, 0.0625f));
+    check(r.linearHotJunction == 1023.75f && r.coldJunction == 0.0625f, "热端 1023.75、冷端 1 LSB");
+
+    r = MAX31855Chip::decode(max31855Frame(25.0f, 24.0f) | 0x00010001);
+    check(r.fault == THERMO_FAULT_OPEN && isnan(r.hotJunction) && r.coldJunction == 24.0f,
+          "D16+OC：开路，冷端仍有效");
+    r = MAX31855Chip::decode(max31855Frame(25.0f, 24.0f) | 0x00010002);
+    check(r.fault == THERMO_FAULT_SHORT_GND, "D16+SCG：对地短路");
+    r = MAX31855Chip::decode(max31855Frame(25.0f, 24.0f) | 0x00010004);
+    check(r.fault == THERMO_FAULT_SHORT_VCC, "D16+SCV：对VCC短路");
+
+    check(isBus(MAX31855Chip::decode(0x00000000)), "0x00000000（MISO 拉低）：总线错误");
+    check(isBus(MAX31855Chip::decode(0xFFFFFFFF)), "0xFFFFFFFF（MISO 悬空）：总线错误");
+    check(isBus(MAX31855Chip::decode(max31855Frame(40.0f, 25.0f) | 0x00020000)), "保留位 D17 非0：总线错误");
+    check(isBus(MAX31855Chip::decode(max31855Frame(40.0f, 25.0f) | 0x00000008)), "保留位 D3 非0：总线错误");
+}
+
+static void testMax6675() {
+    printf("MAX6675:\n");
+
+    ThermoReading r = MAX6675Chip::decode(160 << 3);
+    check(r.fault == THERMO_FAULT_NONE && r.hotJunction == 40.0f && r.linearHotJunction == 40.0f,
+          "0x0500：40.00°C");
+    check(isnan(r.coldJunction), "无冷端输出");
+    check(MAX6675Chip::decode(0x0008).hotJunction == 0.25f, "0x0008：最小非零读数 0.25°C");
+    check(MAX6675Chip::decode(0x7FF8).hotJunction == 1023.75f, "0x7FF8：满量程 1023.75°C");
+
+    r = MAX6675Chip::decode((160 << 3) | 0x0004);
+    check(r.fault == THERMO_FAULT_OPEN && isnan(r.hotJunction), "D2：开路");
+
+    check(isBus(MAX6675Chip::decode(0x0000)), "0x0000（MISO 拉低）：总线错误，不当作 0°C");
+    check(isBus(MAX6675Chip::decode(0xFFFF)), "0xFFFF（MISO 悬空）：总线错误");
+    check(isBus(MAX6675Chip::decode(0x8000 | (160 << 3))), "D15 非0：总线错误");
+    check(isBus(MAX6675Chip::decode(0x0002 | (160 << 3))), "D1（器件ID）非0：总线错误");
+    check(MAX6675Chip::decode(0x0001 | (160 << 3)).hotJunction == 40.0f, "D0（三态位）不影响读数");
+}
+
+int main() {
+    testMax31855();
+    testMax6675();
+    return testSummary();
+}
@@ -0,0 +1,171 @@
+/**
+ * @file test_warmup.cpp
+ * @brief 最短时间预热：WarmUpController + HeatingController 在两节点热模型上的多次预热
+ *
+ * 测试按 ControlChannel::serviceTemperature() 的顺序每 500ms 调用一次（0.25°C 量化的读数、
+ * RateEstimator 变化率、维持功率前馈、全功率/滑行/PID），热模型为快的加热丝节点 +
+ * 60 s 时间常数的加热片节点，环境 22°C、目标 40°C：
+ * 1. 同一模型上只用PID预热作为对照（用时、超调）
+ * 2. 连续 8 次预热：τ 从初值收敛到一个窄带内（切换温度按 0.25°C 量化，τ 在一个LSB对应的
+ *    范围内来回修正），第5次起峰值在目标 ±回差内；用时不长于只用PID，超调不到只用PID的一半
+ * 3. τ 保存到NVS，新对象 begin() 后读回
+ * 4. 已接近目标时重新加热（升温不足 WARMUP_MIN_RISE）不修改 τ
+ */
+
+#include <math.h>
+#include <vector>
+#include "TestCheck.h"
+#include "TestKernel.h"
+#include "SimHost.h"
+#include "config.h"
+#include "HeatingController.h"
+#include "RateEstimator.h"
+#include "WarmUpController.h"
+
+static const float AMBIENT = 22.0f;
+static const float TARGET = TEMP_TARGET_DEFAULT;
+
+/**
+ * @brief 两节点加热片：加热丝（1 s）通过 0.25 °C/(PWM比例) 热阻驱动加热片（60 s）
+ */
+struct Pad {
+    double wire = AMBIENT;
+    double skin = AMBIENT;
+
+    void step(double dt, uint8_t output) {
+        double duty = output / 255.0;
+        wire += dt * (60.0 * duty - (wire - skin) / 0.25);
+        skin += dt * ((wire - skin) / 0.25 - (skin - AMBIENT) / 1.0) / 60.0;
+    }
+
+    float reading() const {
+        return roundf((float)skin * 4.0f) / 4.0f;
+    }
+};
+
+struct Session {
+    float timeToSetpoint;       // 首次到达 目标-回差 (s)
+    float overshoot;            // 峰值 - 目标 (°C)
+    WarmUpReport report;
+    bool reported;
+};
+
+/**
+ * @brief 从环境温度开始加热 duration_ms，按 ControlChannel 的顺序驱动两个控制器
+ */
+static Session runSession(WarmUpController& warmup, HeatingController& heater, bool warmUp,
+                          float startTemp = AMBIENT, uint32_t duration_ms = 400000) {
+    Pad pad;
+    pad.wire = pad.skin = startTemp;
+    RateEstimator<TEMP_RATE_WINDOW> rate;
+    Session s = {NAN, -INFINITY, {}, false};
+    uint32_t start = millis();
+
+    for (uint32_t t = 0; t < duration_ms; t += 10) {
+        if (t % TEMP_SAMPLE_PERIOD_MS == 0) {
+            float temp = pad.reading();
+            uint32_t now = millis();
+            rate.add(now, temp);
+            if (!heater.isEnabled()) {
+                heater.enable();
+                if (warmUp) {
+                    warmup.start(temp, now);
+                }
+            }
+            WarmUpAction action = warmup.update(temp, rate.slope(), TARGET, AMBIENT, heater.getOutput(), now);
+            float hold = warmup.getHoldingOutput(TARGET, AMBIENT);
+            heater.setFeedForward(hold);
+            if (action == WARMUP_FULL_POWER) {
+                heater.driveOpenLoop(temp, 255);
+            } else if (action == WARMUP_COAST) {
+                heater.driveOpenLoop(temp, (uint8_t)(hold + 0.5f));
+            } else {
+                heater.update(temp);
+            }
+            if (warmup.takeReport(s.report)) {
+                s.reported = true;
+            }
+        }
+        if (isnan(s.timeToSetpoint) && pad.skin >= TARGET - TEMP_HYSTERESIS) {
+            s.timeToSetpoint = (millis() - start) / 1000.0f;
+        }
+        s.overshoot = fmaxf(s.overshoot, (float)pad.skin - TARGET);
+        pad.step(0.01, heater.getOutput());
+        testKernelAdvance(10);
+    }
+    warmup.cancel();
+    heater.disable();
+    return s;
+}
+
+static void testPidOnlyBaseline(Session& baseline) {
+    printf("对照：只用PID:\n");
+    WarmUpController warmup;
+    HeatingController heater(HEATING_PAD_PIN, 0);
+    heater.begin();
+    baseline = runSession(warmup, heater, false);
+    printf("  到达 %.1f s，超调 %+.2f °C\n", baseline.timeToSetpoint, baseline.overshoot);
+    check(!isnan(baseline.timeToSetpoint), "只用PID也能到达目标");
+}
+
+static void testLearning(const Session& baseline) {
+    printf("连续预热（τ 初值 %.1f s）:\n", WARMUP_LAG_DEFAULT_S);
+    WarmUpController warmup;
+    HeatingController heater(HEATING_PAD_PIN, 0);
+    heater.begin();
+    warmup.begin(0);
+
+    std::vector<Session> sessions;
+    std::vector<float> lags;
+    for (int i = 0; i < 8; i++) {
+        sessions.push_back(runSession(warmup, heater, true));
+        lags.push_back(warmup.getLagSeconds());
+        const Session& s = sessions.back();
+        printf("  第%d次：到达 %.1f s，超调 %+.2f °C，切换 %.2f °C，τ %.2f s，维持输出 %.1f\n", i + 1,
+               s.timeToSetpoint, s.overshoot, s.report.switchTemp, s.report.lagSeconds, s.report.holdingOutput);
+    }
+
+    bool allReported = true;
+    for (const Session& s : sessions) {
+        allReported = allReported && s.reported && !isnan(s.timeToSetpoint);
+    }
+    check(allReported, "每次预热都到达目标并给出报告");
+    float lagMin = lags[4];
+    float lagMax = lags[4];
+    for (int i = 5; i < 8; i++) {
+        lagMin = fminf(lagMin, lags[i]);
+        lagMax = fmaxf(lagMax, lags[i]);
+    }
+    check(lagMax - lagMin < 0.5f, "τ 收敛（最后四次在 0.5 s 范围内）");
+    check(fabsf(lags[7] - WARMUP_LAG_DEFAULT_S) > 1.0f, "τ 按本模型学习，离开初值");
+
+    bool settled = true;
+    for (int i = 4; i < 8; i++) {
+        settled = settled && fabsf(sessions[i].overshoot) <= TEMP_HYSTERESIS;
+    }
+    check(settled, "第5次起峰值在目标 ±回差内");
+    const Session& last = sessions.back();
+    check(last.timeToSetpoint <= baseline.timeToSetpoint, "学习后到达时间不长于只用PID");
+    check(last.overshoot < baseline.overshoot * 0.5f, "学习后超调不到只用PID的一半");
+    check(fabsf(last.report.holdingOutput - warmup.getHoldingOutput(TARGET, AMBIENT)) < 5.0f,
+          "观察窗口的平均输出与热模型给出的维持功率一致（±5）");
+
+    // NVS 中的 τ
+    WarmUpController reloaded;
+    reloaded.begin(0);
+    check(reloaded.getLagSeconds() == warmup.getLagSeconds(), "τ 保存到NVS，begin() 读回");
+
+    // 已在目标附近重新加热：不是一次真正的全功率升温，不参与学习
+    float lag = warmup.getLagSeconds();
+    Session reheat = runSession(warmup, heater, true, TARGET - 1.0f, 200000);
+    check(reheat.reported && warmup.getLagSeconds() == lag, "升温不足 WARMUP_MIN_RISE 时 τ 不变");
+}
+
+int main() {
+    simSerialQuiet = true;
+    testKernelAdvance(1);
+    Session baseline;
+    testPidOnlyBaseline(baseline);
+    testLearning(baseline);
+    return testSummary();
+}
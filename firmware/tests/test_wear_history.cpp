@@ -0,0 +1,170 @@
+/**
+ * @file test_wear_history.cpp
+ * @brief 泵/密封磨损趋势：合成的老化历史
+ *
+ * 按稳态关系（泵增益·泵速 = 泄漏率·负压）由泵增益 G 和泄漏率 k 生成每次疗程的指纹，
+ * 维持泵速、抽气用时、泄漏率各加 4~6% 的测量噪声，每 4 次有 1 次没测到泄漏率。
+ * 每种历史用 8 个随机种子各跑 40 次疗程：
+ * 1. 健康（G、k 不变）和只有一次异常疗程（泄漏率、泵速都 ×3）的历史从不置标志
+ * 2. 泵老化（第 9 次起 G 每次 ×0.98）：真实越限在第 24 次，泵标志在第 18~30 次之间，不置密封标志
+ * 3. 密封老化（第 9 次起 k 每次 ×1.04）：真实越限在第 21 次，密封标志在第 16~26 次之间，
+ *    泵比值扣除了漏气变化，不置泵标志
+ * 4. 标志保存到NVS，rebaseline() 清除
+ */
+
+#include <math.h>
+#include <random>
+#include "TestCheck.h"
+#include "SimHost.h"
+#include "WearHistory.h"
+
+static const float GEAR5_VACUUM = 7.5f;     // 第5档目标负压 (mmHg)
+static const float HEALTHY_LEAK = 0.05f;    // 新件泄漏率 (1/s)
+
+static std::mt19937 rng;
+
+static float noisy(float value, float relative) {
+    std::normal_distribution<float> d(0.0f, relative);
+    return value * (1.0f + d(rng));
+}
+
+/**
+ * @brief 由泵增益（相对新件）和泄漏率生成一次第5档疗程的指纹
+ */
+static WearFingerprint fingerprint(int session, float gain, float leak, bool outlier) {
+    WearFingerprint fp = {};
+    float duty = leak * GEAR5_VACUUM / (PRESSURE_PUMP_GAIN * gain);    // %
+    fp.holdDuty[4] = (uint16_t)lroundf(noisy(duty, 0.04f) * 100.0f);
+    // 抽到目标的 90%：一阶过程 dV/dt = 增益·泵速 - k·V，泵速 100%
+    float pullDown = -logf(1.0f - WEAR_PULLDOWN_FRACTION * GEAR5_VACUUM * leak
+                                  / (PRESSURE_PUMP_GAIN * gain * 100.0f)) / leak;
+    fp.pullDownDs = (uint16_t)lroundf(noisy(pullDown + 0.8f, 0.05f) * 10.0f);
+    fp.pullDownGear = 5;
+    fp.leakRate = noisy(leak, 0.06f);
+    if (outlier) {
+        fp.leakRate *= 3.0f;
+        fp.holdDuty[4] *= 3;
+    }
+    if (session % 4 == 3) {
+        fp.leakRate = NAN;      // 本次没有泄压观察
+    }
+    return fp;
+}
+
+typedef float (*Profile)(int session);
+
+struct FlagSessions {
+    int pump;       // 首次置泵标志的疗程（1起），-1 = 未置
+    int seal;
+};
+
+static FlagSessions run(Profile gain, Profile leak, int outlier, unsigned seed) {
+    rng.seed(seed);
+    WearHistory history;
+    FlagSessions first = {-1, -1};
+    for (int s = 0; s < 40; s++) {
+        WearReport r;
+        history.add(fingerprint(s, gain(s), leak(s), s == outlier), r);
+        if ((r.newFlags & WEAR_FLAG_PUMP) && first.pump < 0) {
+            first.pump = s + 1;
+        }
+        if ((r.newFlags & WEAR_FLAG_SEAL) && first.seal < 0) {
+            first.seal = s + 1;
+        }
+    }
+    return first;
+}
+
+static float constantGain(int) {
+    return 1.0f;
+}
+
+static float constantLeak(int) {
+    return HEALTHY_LEAK;
+}
+
+static float agingGain(int s) {
+    return s < 8 ? 1.0f : powf(0.98f, (float)(s - 8));
+}
+
+static float agingLeak(int s) {
+    return s < 8 ? HEALTHY_LEAK : HEALTHY_LEAK * powf(1.04f, (float)(s - 8));
+}
+
+static const unsigned SEEDS = 8;
+
+static void testNoFalseFlags() {
+    printf("健康 / 单次异常疗程:\n");
+    bool healthy = true;
+    bool outlier = true;
+    for (unsigned seed = 1; seed <= SEEDS; seed++) {
+        FlagSessions h = run(constantGain, constantLeak, -1, seed);
+        FlagSessions o = run(constantGain, constantLeak, 20, seed);
+        healthy = healthy && h.pump < 0 && h.seal < 0;
+        outlier = outlier && o.pump < 0 && o.seal < 0;
+    }
+    check(healthy, "健康历史 40 次疗程不置标志（8 个种子）");
+    check(outlier, "第 21 次疗程泄漏率和泵速 ×3：不置标志（8 个种子）");
+}
+
+static void testAging() {
+    // 真实越限：泵 1/0.98^n >= 1.35 -> n = 14.9，第 9+15 = 24 次；密封 1.04^n >= 1.6 -> n = 12.0，第 21 次
+    printf("老化（%u 个种子）:\n", SEEDS);
+    bool pumpInWindow = true;
+    bool pumpOnly = true;
+    bool sealInWindow = true;
+    bool sealOnly = true;
+    printf("  泵老化，泵标志：");
+    for (unsigned seed = 1; seed <= SEEDS; seed++) {
+        FlagSessions f = run(agingGain, constantLeak, -1, seed);
+        printf(" %d", f.pump);
+        pumpInWindow = pumpInWindow && f.pump >= 18 && f.pump <= 30;
+        pumpOnly = pumpOnly && f.seal < 0;
+    }
+    printf("\n  密封老化，密封标志：");
+    for (unsigned seed = 1; seed <= SEEDS; seed++) {
+        FlagSessions f = run(constantGain, agingLeak, -1, seed);
+        printf(" %d", f.seal);
+        sealInWindow = sealInWindow && f.seal >= 16 && f.seal <= 26;
+        sealOnly = sealOnly && f.pump < 0;
+    }
+    printf("\n");
+    check(pumpInWindow, "泵老化：泵标志在第 18~30 次疗程之间（真实越限第 24 次）");
+    check(pumpOnly, "泵老化：不置密封标志");
+    check(sealInWindow, "密封老化：密封标志在第 16~26 次疗程之间（真实越限第 21 次）");
+    check(sealOnly, "密封老化：泵比值扣除漏气变化，不置泵标志");
+}
+
+static void testPersistence() {
+    printf("NVS 与 rebaseline():\n");
+    rng.seed(1);
+    WearHistory history;
+    history.begin(1);
+    for (int s = 0; s < 40; s++) {
+        WearReport r;
+        history.add(fingerprint(s, constantGain(s), agingLeak(s), false), r);
+    }
+    check(history.flags() & WEAR_FLAG_SEAL, "密封老化后置标志");
+
+    WearHistory reloaded;
+    reloaded.begin(1);
+    check(reloaded.flags() == history.flags() && reloaded.count() == history.count()
+          && reloaded.sessionCount() == 40, "标志、指纹和疗程数保存到NVS");
+    check(reloaded.get(0).session == history.get(0).session, "最新指纹一致");
+
+    reloaded.rebaseline();
+    WearHistory cleared;
+    cleared.begin(1);
+    check(cleared.flags() == 0 && cleared.count() == 0, "rebaseline() 清除标志和指纹（NVS 中同样清除）");
+    WearReport r;
+    cleared.add(fingerprint(0, 1.0f, HEALTHY_LEAK * 2.0f, false), r);
+    check(!r.baselineReady && r.flags == 0, "更换部件后重新学习基准");
+}
+
+int main() {
+    simSerialQuiet = true;
+    testNoFalseFlags();
+    testAging();
+    testPersistence();
+    return testSummary();
+}